@@ -466,6 +466,9 @@ public:
     template <typename ElementType>
     void Step(ell::api::TimeTickType timestamp = 0.0);
 
+    template <typename ElementType>
+    std::vector<ElementType> ComputeBatch(const std::vector<ElementType>& inputs);
+
     template <typename ElementType>
     void UnregisterCallbacks();
 
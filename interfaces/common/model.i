@@ -29,6 +29,8 @@ WRAP_CALLABLES_AS_COMPILED_MAP_CALLBACKS(FloatCallbackBase, FloatCallbackBase, f
 %template(UnregisterCallbacksFloat) ELL_API::CompiledMap::UnregisterCallbacks<float>;
 %template(StepDouble) ELL_API::CompiledMap::Step<double>;
 %template(StepFloat) ELL_API::CompiledMap::Step<float>;
+%template(ComputeBatchDouble) ELL_API::CompiledMap::ComputeBatch<double>;
+%template(ComputeBatchFloat) ELL_API::CompiledMap::ComputeBatch<float>;
 
 %template(SetSinkCallbackDouble) ELL_API::Map::SetSinkCallback<double>;
 %template(SetSinkCallbackFloat) ELL_API::Map::SetSinkCallback<float>;
@@ -122,6 +122,30 @@ def CompiledMap_Compute(self, inputData: 'Vector', dtype: 'numpy.dtype') -> "std
 
 CompiledMap.Compute = CompiledMap_Compute
 
+# CompiledMap.ComputeBatch, parameterized on numpy.dtype
+def CompiledMap_ComputeBatch(self, inputData: 'numpy.ndarray', dtype: 'numpy.dtype') -> "numpy.ndarray":
+    """
+    CompiledMap_ComputeBatch(CompiledMap self, numpy.ndarray inputData, numpy.dtype dtype) -> numpy.ndarray
+
+    Parameters
+    ----------
+    inputData: numpy.ndarray with one sample per row
+    dtype: numpy.dtype
+
+    """
+    count = len(inputData)
+    inputs = np.ascontiguousarray(inputData).astype(dtype).ravel()
+    if dtype is np.float:
+        results = self.ComputeBatchDouble(DoubleVector(inputs))
+    elif dtype is np.float32:
+        results = self.ComputeBatchFloat(FloatVector(inputs))
+    else:
+        raise TypeError("Invalid type, expected numpy.float or numpy.float32")
+
+    return np.asarray(results).reshape(count, -1)
+
+CompiledMap.ComputeBatch = CompiledMap_ComputeBatch
+
 # Map.Compute, parameterized on numpy.dtype
 def Map_Compute(self, inputData: 'Vector<ElementType>', dtype: 'numpy.dtype') -> "std::vector< ElementType,std::allocator< ElementType > >":
     """
@@ -164,10 +164,12 @@ del BinaryWeightsScale_mean
 class ConvolutionMethod:
     columnwise = ConvolutionMethod_columnwise
     diagonal = ConvolutionMethod_diagonal
+    winograd = ConvolutionMethod_winograd
 
 # Remove flat defines so callers only see the class above
 del ConvolutionMethod_columnwise
 del ConvolutionMethod_diagonal
+del ConvolutionMethod_winograd
 
 # Python friendly class for LayerType
 class LayerType:
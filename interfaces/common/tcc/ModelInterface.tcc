@@ -62,6 +62,12 @@ void CompiledMap::Step(ell::api::TimeTickType timestamp)
     _map->Compute<ElementType>(input);
 }
 
+template <typename ElementType>
+std::vector<ElementType> CompiledMap::ComputeBatch(const std::vector<ElementType>& inputs)
+{
+    return _map->ComputeBatch<ElementType, ElementType>(inputs);
+}
+
 template <typename ElementType>
 void CompiledMap::RegisterCallbacks(
     ell::api::CallbackBase<ElementType>& inputCallback,
@@ -58,6 +58,16 @@ namespace common
     /// <returns> The dataset. </returns>
     data::AutoSupervisedDataset GetDataset(std::istream& stream);
 
+    /// <summary>
+    /// Gets an AutoSupervisedDataset dataset from a file, which is either a text file or a binary dataset file. A
+    /// binary dataset file is memory-mapped and copied without parsing.
+    /// </summary>
+    ///
+    /// <param name="filename"> The name of the file to load data from. </param>
+    ///
+    /// <returns> The dataset. </returns>
+    data::AutoSupervisedDataset GetDataset(const std::string& filename);
+
     /// <summary> Gets a dataset from data load arguments. </summary>
     ///
     /// <param name="stream"> Input stream to load data from. </param>
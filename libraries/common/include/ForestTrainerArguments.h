@@ -12,6 +12,7 @@
 #include "CommandLineParser.h"
 
 // trainers
+#include "BinnedForestTrainer.h"
 #include "HistogramForestTrainer.h"
 #include "SortingForestTrainer.h"
 
@@ -19,9 +20,10 @@ namespace ell
 {
 namespace common
 {
-    struct ForestTrainerArguments : public trainers::SortingForestTrainerParameters, public trainers::HistogramForestTrainerParameters
+    struct ForestTrainerArguments : public trainers::SortingForestTrainerParameters, public trainers::HistogramForestTrainerParameters, public trainers::BinnedForestTrainerParameters
     {
         bool sortingTrainer;
+        bool binnedTrainer;
     };
 
     /// <summary> Parsed version of sorting tree trainer parameters. </summary>
@@ -41,6 +41,13 @@ namespace common
         bool parallelize = true;
         bool useThreadPool = true;
         int maxThreads = 4;
+        std::string mathFunctionAccuracy = "precise"; // accuracy of the inline exp, log, tanh and sigmoid: fast or precise
+        bool useHalfPrecisionWeights = false;
+        bool planMemory = false;
+        bool reentrant = false;
+        bool emitPredictBatch = false;
+        int predictBatchSize = 16;
+        std::string forestEvaluation = "refine"; // how forests are compiled: refine, branching or quickScorer
         bool debug = false;
 
         // target machine options
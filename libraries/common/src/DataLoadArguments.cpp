@@ -8,6 +8,7 @@
 
 #include "DataLoadArguments.h"
 #include "DataLoaders.h"
+#include "MappedDataset.h"
 
 // utilities
 #include "Files.h"
@@ -59,6 +60,13 @@ namespace common
                 return parseErrorMessages;
             }
 
+            // a binary dataset file records the dimension in its header
+            if (data::IsMappedDatasetFile(inputDataFilename))
+            {
+                parsedDataDimension = data::MappedDataset(inputDataFilename).NumFeatures();
+                return parseErrorMessages;
+            }
+
             auto stream = utilities::OpenIfstream(inputDataFilename);
             auto exampleIterator = GetAutoSupervisedExampleIterator(stream);
             while (exampleIterator.IsValid())
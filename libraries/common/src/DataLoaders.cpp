@@ -19,6 +19,7 @@
 #include "AutoDataVector.h"
 #include "WeightLabel.h"
 #include "GeneralizedSparseParsingIterator.h"
+#include "MappedDataset.h"
 
 // stl
 #include <memory>
@@ -44,6 +45,18 @@ namespace common
         return data::MakeDataset(GetExampleIterator<data::SequentialLineIterator, data::LabelParser, data::AutoDataVectorParser<data::GeneralizedSparseParsingIterator>>(stream));
     }
 
+    data::AutoSupervisedDataset GetDataset(const std::string& filename)
+    {
+        if (data::IsMappedDatasetFile(filename))
+        {
+            data::MappedDataset mappedDataset(filename);
+            return data::MakeDataset(mappedDataset.GetExampleIterator<data::AutoSupervisedExample>());
+        }
+
+        auto stream = utilities::OpenIfstream(filename);
+        return GetDataset(stream);
+    }
+
     data::AutoSupervisedMultiClassDataset GetMultiClassDataset(std::istream& stream)
     {
         return data::MakeDataset(GetExampleIterator<data::SequentialLineIterator, data::ClassIndexParser, data::AutoDataVectorParser<data::GeneralizedSparseParsingIterator>>(stream));
@@ -32,6 +32,12 @@ namespace common
                          "The number of boosting rounds to perform",
                          "10");
 
+        parser.AddOption(numThreads,
+                         "numThreads",
+                         "nt",
+                         "The number of threads that search for splits (0 means the number of hardware threads)",
+                         1);
+
         parser.AddOption(randomSeed,
                          "randomSeed",
                          "rs",
@@ -55,6 +61,18 @@ namespace common
                          "st",
                          "Use the sorting trainer instead of the histogram trainer",
                          false);
+
+        parser.AddOption(binnedTrainer,
+                         "binnedTrainer",
+                         "bt",
+                         "Use the binned trainer instead of the histogram trainer",
+                         false);
+
+        parser.AddOption(maxBinsPerFeature,
+                         "maxBinsPerFeature",
+                         "mbpf",
+                         "The maximum number of bins per input element, for the binned trainer (at most 256)",
+                         256);
     }
 }
 }
@@ -40,10 +40,12 @@
 #include "MultiplexerNode.h"
 #include "NeuralNetworkPredictorNode.h"
 #include "ProtoNNPredictorNode.h"
+#include "QuantizedMatrixMultiplyNode.h"
 #include "ReceptiveFieldMatrixNode.h"
 #include "ReorderDataNode.h"
 #include "SinkNode.h"
 #include "SourceNode.h"
+#include "SparseLinearPredictorNode.h"
 #include "UnaryOperationNode.h"
 
 // predictors
@@ -153,6 +155,9 @@ namespace common
         context.GetTypeFactory().AddType<model::Node, nodes::LinearPredictorNode<float>>();
         context.GetTypeFactory().AddType<model::Node, nodes::LinearPredictorNode<double>>();
 
+        context.GetTypeFactory().AddType<model::Node, nodes::SparseLinearPredictorNode<float>>();
+        context.GetTypeFactory().AddType<model::Node, nodes::SparseLinearPredictorNode<double>>();
+
         context.GetTypeFactory().AddType<model::Node, nodes::LinearFilterBankNode<float>>();
         context.GetTypeFactory().AddType<model::Node, nodes::LinearFilterBankNode<double>>();
 
@@ -184,6 +189,11 @@ namespace common
 
         context.GetTypeFactory().AddType<model::Node, nodes::ProtoNNPredictorNode>();
 
+        context.GetTypeFactory().AddType<model::Node, nodes::QuantizedMatrixMultiplyNode<float>>();
+        context.GetTypeFactory().AddType<model::Node, nodes::QuantizedMatrixMultiplyNode<double>>();
+        context.GetTypeFactory().AddType<model::Node, nodes::DequantizeNode<float>>();
+        context.GetTypeFactory().AddType<model::Node, nodes::DequantizeNode<double>>();
+
         context.GetTypeFactory().AddType<model::Node, nodes::ReceptiveFieldMatrixNode<float>>();
         context.GetTypeFactory().AddType<model::Node, nodes::ReceptiveFieldMatrixNode<double>>();
 
@@ -19,6 +19,7 @@
 #include "CommandLineParser.h"
 
 // trainers
+#include "BinnedForestTrainer.h"
 #include "HistogramForestTrainer.h"
 #include "LogitBooster.h"
 #include "SortingForestTrainer.h"
@@ -130,6 +131,10 @@ namespace common
                 {
                     return trainers::MakeSortingForestTrainer(functions::SquaredLoss(), trainers::LogitBooster(), trainerArguments);
                 }
+                else if (trainerArguments.binnedTrainer)
+                {
+                    return trainers::MakeBinnedForestTrainer(functions::SquaredLoss(), trainers::LogitBooster(), trainerArguments);
+                }
                 else
                 {
                     return trainers::MakeHistogramForestTrainer(functions::SquaredLoss(), trainers::LogitBooster(), trainers::ExhaustiveThresholdFinder(), trainerArguments);
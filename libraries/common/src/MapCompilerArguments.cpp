@@ -54,7 +54,7 @@ namespace common
             fuseLinearOperations,
             "fuseLinearOps",
             "",
-            "Fuse sequences of linear operations with constant coefficients into a single operation",
+            "Fuse sequences of linear operations with constant coefficients into a single operation, and fold neural network scaling and bias layers into the preceding layer's weights",
             true);
 
         parser.AddOption(
@@ -92,6 +92,57 @@ namespace common
             "Maximum num of parallel threads",
             4);
 
+        parser.AddOption(
+            mathFunctionAccuracy,
+            "mathAccuracy",
+            "ma",
+            "Accuracy of the inline approximations of exp, log, tanh and sigmoid",
+            { { "fast" }, { "precise" } },
+            "precise");
+
+        parser.AddOption(
+            useHalfPrecisionWeights,
+            "halfPrecisionWeights",
+            "fp16",
+            "Store the constant weights of matrix multiplies (e.g., in convolutional, fully-connected and recurrent layers) as 16-bit floats, and widen them to float as they are used",
+            false);
+
+        parser.AddOption(
+            planMemory,
+            "planMemory",
+            "pm",
+            "Share memory between intermediate values whose lifetimes don't overlap",
+            false);
+
+        parser.AddOption(
+            reentrant,
+            "reentrant",
+            "re",
+            "Keep intermediate values in a workspace passed to the predict function, so it can be called from multiple threads (turns off parallelize)",
+            false);
+
+        parser.AddOption(
+            emitPredictBatch,
+            "predictBatch",
+            "pb",
+            "Also emit a predict function that processes a batch of samples",
+            false);
+
+        parser.AddOption(
+            predictBatchSize,
+            "predictBatchSize",
+            "pbs",
+            "The number of samples the batched predict function computes together",
+            16);
+
+        parser.AddOption(
+            forestEvaluation,
+            "forestEvaluation",
+            "fe",
+            "How to compile decision forests: refine them into a graph of nodes, walk each tree, or use QuickScorer bitvectors (for trees with at most 64 leaves)",
+            { { "refine" }, { "branching" }, { "quickScorer" } },
+            "refine");
+
         parser.AddOption(
             debug,
             "debug",
@@ -179,9 +230,29 @@ namespace common
         settings.compilerSettings.useBlas = useBlas;
         settings.fuseLinearFunctionNodes = fuseLinearOperations;
         settings.compilerSettings.allowVectorInstructions = enableVectorization;
-        settings.compilerSettings.parallelize = parallelize;
+        settings.compilerSettings.parallelize = parallelize && !reentrant; // tasks go through module globals, so reentrant maps compute on the calling thread
+        settings.compilerSettings.useThreadPool = useThreadPool;
+        settings.compilerSettings.maxThreads = maxThreads;
         settings.compilerSettings.vectorWidth = vectorWidth;
+        settings.compilerSettings.mathFunctionAccuracy = mathFunctionAccuracy == "fast" ? emitters::MathFunctionAccuracy::fast : emitters::MathFunctionAccuracy::precise;
+        settings.compilerSettings.useHalfPrecisionWeights = useHalfPrecisionWeights;
         settings.profile = profile;
+        settings.planMemory = planMemory;
+        settings.reentrant = reentrant;
+        settings.emitPredictBatch = emitPredictBatch;
+        settings.predictBatchSize = predictBatchSize;
+        if (forestEvaluation == "branching")
+        {
+            settings.forestEvaluation = model::ForestEvaluation::branching;
+        }
+        else if (forestEvaluation == "quickScorer")
+        {
+            settings.forestEvaluation = model::ForestEvaluation::quickScorer;
+        }
+        else
+        {
+            settings.forestEvaluation = model::ForestEvaluation::refine;
+        }
 
         if (target != "")
         {
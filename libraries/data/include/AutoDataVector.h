@@ -127,6 +127,14 @@ namespace data
         template <IterationPolicy policy, typename TransformationType>
         void AddTransformedTo(math::RowVectorReference<double> vector, TransformationType transformation) const;
 
+        /// <summary> Calls a function on each element of this data vector, in index order. </summary>
+        ///
+        /// <typeparam name="policy"> The iteration policy. </typeparam>
+        /// <typeparam name="FunctionType"> A functor that takes an IndexValue. </typeparam>
+        /// <param name="function"> The function, which is called by reference and may keep state. </param>
+        template <IterationPolicy policy, typename FunctionType>
+        void ForEachElement(FunctionType&& function) const;
+
         /// <summary> Copies the contents of this DataVector into a double array of size PrefixLength(). </summary>
         ///
         /// <returns> The array. </returns>
@@ -31,6 +31,9 @@ namespace data
     template <typename ExampleType>
     class Dataset;
 
+    // forward declaration of MappedDataset, which is also a source of AnyDatasets
+    class MappedDataset;
+
     /// <summary> Polymorphic interface for datasets, enables dynamic_cast operations. </summary>
     struct DatasetBase
     {
@@ -0,0 +1,273 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     MappedDataset.h (data)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "Dataset.h"
+#include "Example.h"
+#include "ExampleIterator.h"
+#include "IndexValue.h"
+#include "WeightLabel.h"
+
+// utilities
+#include "MemoryMappedFile.h"
+
+// stl
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace ell
+{
+namespace data
+{
+    /// <summary> A read-only forward index-value iterator over the nonzero elements of a row of a MappedDataset. </summary>
+    class MappedDataVectorIterator : public IIndexValueIterator
+    {
+    public:
+        /// <summary> Constructs an instance of MappedDataVectorIterator. </summary>
+        ///
+        /// <param name="values"> Pointer to the stored values of the row. </param>
+        /// <param name="indices"> Pointer to the indices of the stored values, or nullptr if the row is dense. </param>
+        /// <param name="size"> The number of stored values. </param>
+        MappedDataVectorIterator(const double* values, const uint32_t* indices, size_t size);
+
+        /// <summary> Returns True if the iterator is currently pointing to a valid iterate. </summary>
+        ///
+        /// <returns> True if the iterator is currently pointing to a valid iterate. </returns>
+        bool IsValid() const { return _current < _size; }
+
+        /// <summary> Proceeds to the Next iterate </summary>
+        void Next();
+
+        /// <summary> Returns The current index-value pair </summary>
+        ///
+        /// <returns> The current index-value pair </returns>
+        IndexValue Get() const { return IndexValue{ _indices == nullptr ? _current : _indices[_current], _values[_current] }; }
+
+    private:
+        void SkipZeros();
+
+        const double* _values;
+        const uint32_t* _indices;
+        size_t _size;
+        size_t _current = 0;
+    };
+
+    /// <summary>
+    /// A lightweight view of an example in a MappedDataset. The view points into the mapped file, so it is only valid
+    /// while the dataset exists.
+    /// </summary>
+    class MappedExample
+    {
+    public:
+        /// <summary> Constructs an instance of MappedExample. </summary>
+        ///
+        /// <param name="values"> Pointer to the stored values of the row. </param>
+        /// <param name="indices"> Pointer to the indices of the stored values, or nullptr if the row is dense. </param>
+        /// <param name="size"> The number of stored values. </param>
+        /// <param name="metadata"> The weight and label of the example. </param>
+        MappedExample(const double* values, const uint32_t* indices, size_t size, WeightLabel metadata);
+
+        /// <summary> Gets the weight and label of the example. </summary>
+        ///
+        /// <returns> The weight and label. </returns>
+        const WeightLabel& GetMetadata() const { return _metadata; }
+
+        /// <summary> Checks if the row is stored sparsely, as index-value pairs. </summary>
+        ///
+        /// <returns> True if the row is stored sparsely. </returns>
+        bool IsSparse() const { return _indices != nullptr; }
+
+        /// <summary> Returns the size of the data vector, excluding the final suffix of zeros. </summary>
+        ///
+        /// <returns> The size of the data vector. </returns>
+        size_t PrefixLength() const;
+
+        /// <summary> Gets an iterator over the nonzero elements of the data vector. </summary>
+        ///
+        /// <returns> The iterator. </returns>
+        MappedDataVectorIterator GetIterator() const { return MappedDataVectorIterator(_values, _indices, _size); }
+
+        /// <summary> Copies the example into an example that owns its data vector. </summary>
+        ///
+        /// <typeparam name="ExampleType"> The example type, whose metadata must be constructible from a WeightLabel. </typeparam>
+        ///
+        /// <returns> The example. </returns>
+        template <typename ExampleType>
+        ExampleType CopyAs() const;
+
+    private:
+        const double* _values;
+        const uint32_t* _indices;
+        size_t _size;
+        WeightLabel _metadata;
+    };
+
+    /// <summary>
+    /// A read-only dataset backed by a memory-mapped binary dataset file (see doc/BinaryDatasetFormat.md). Opening
+    /// the dataset maps the file and reads its header, without reading or parsing the examples, and the pages of the
+    /// file are shared with other processes that map it.
+    /// </summary>
+    class MappedDataset : public DatasetBase
+    {
+    public:
+        /// <summary> Iterator class that copies the examples it visits into a given example type. </summary>
+        template <typename IteratorExampleType>
+        class MappedDatasetExampleIterator : public IExampleIterator<IteratorExampleType>
+        {
+        public:
+            /// <summary> Constructs an instance of MappedDatasetExampleIterator. </summary>
+            ///
+            /// <param name="dataset"> The dataset. </param>
+            /// <param name="begin"> Zero-based index of the first example to iterate over. </param>
+            /// <param name="end"> One past the index of the last example to iterate over. </param>
+            MappedDatasetExampleIterator(const MappedDataset& dataset, size_t begin, size_t end);
+
+            /// <summary> Returns true if the iterator is currently pointing to a valid iterate. </summary>
+            ///
+            /// <returns> true if the iterator is currently pointing to a valid iterate. </returns>
+            bool IsValid() const override { return _current < _end; }
+
+            /// <summary> Proceeds to the Next iterate. </summary>
+            void Next() override { ++_current; }
+
+            /// <summary> Gets the current example pointer to by the iterator. </summary>
+            ///
+            /// <returns> The example. </returns>
+            IteratorExampleType Get() const override { return _dataset.GetExample(_current).template CopyAs<IteratorExampleType>(); }
+
+        private:
+            const MappedDataset& _dataset;
+            size_t _current;
+            size_t _end;
+        };
+
+        /// <summary> Maps a binary dataset file into memory. </summary>
+        ///
+        /// <param name="filepath"> The path of the binary dataset file. </param>
+        MappedDataset(const std::string& filepath);
+
+        /// <summary> Returns the number of examples in the data set. </summary>
+        ///
+        /// <returns> The number of examples. </returns>
+        size_t NumExamples() const { return _numExamples; }
+
+        /// <summary> Returns the maximal size of any example. </summary>
+        ///
+        /// <returns> The maximal size of any example. </returns>
+        size_t NumFeatures() const { return _numFeatures; }
+
+        /// <summary> Returns a view of an example. </summary>
+        ///
+        /// <param name="index"> Zero-based index of the row. </param>
+        ///
+        /// <returns> A view of the specified example. </returns>
+        MappedExample GetExample(size_t index) const;
+
+        /// <summary> Returns a view of an example. </summary>
+        ///
+        /// <param name="index"> Zero-based index of the row. </param>
+        ///
+        /// <returns> A view of the specified example. </returns>
+        MappedExample operator[](size_t index) const { return GetExample(index); }
+
+        /// <summary> Returns an iterator that traverses the examples, copying each one into a given example type. </summary>
+        ///
+        /// <param name="fromIndex"> Zero-based index of the first example to iterate over. </param>
+        /// <param name="size"> The number of examples to iterate over, a value of zero means all
+        /// the way to the end. </param>
+        ///
+        /// <returns> The iterator. </returns>
+        template <typename IteratorExampleType = AutoSupervisedExample>
+        ExampleIterator<IteratorExampleType> GetExampleIterator(size_t fromIndex = 0, size_t size = 0) const;
+
+        /// <summary> Returns an AnyDataset that represents an interval of examples from this dataset. </summary>
+        ///
+        /// <param name="fromIndex"> Zero-based index of the first example in the AnyDataset. </param>
+        /// <param name="size"> The number of examples to include, a value of zero means all
+        /// the way to the end. </param>
+        ///
+        /// <returns> The dataset. </returns>
+        AnyDataset GetAnyDataset(size_t fromIndex = 0, size_t size = 0) const { return AnyDataset(this, fromIndex, size); }
+
+    private:
+        size_t CorrectRangeSize(size_t fromIndex, size_t size) const;
+        template <typename ValueType>
+        const ValueType* GetColumn(uint64_t offset, size_t size) const;
+
+        utilities::MemoryMappedFile _file;
+        size_t _numExamples = 0;
+        size_t _numFeatures = 0;
+        const double* _labels = nullptr;
+        const double* _weights = nullptr;
+        const uint64_t* _rowOffsets = nullptr;
+        const uint64_t* _rowSizes = nullptr;
+        const uint8_t* _rowFlags = nullptr;
+    };
+
+    /// <summary>
+    /// Writes examples to a stream in the binary dataset format that MappedDataset reads. Each row is stored densely or
+    /// sparsely, whichever is smaller. The rows are written as they are added, and the per-example columns and the
+    /// header are written by Finish().
+    /// </summary>
+    class MappedDatasetWriter
+    {
+    public:
+        /// <summary> Constructs an instance of MappedDatasetWriter. </summary>
+        ///
+        /// <param name="stream"> A seekable stream, opened in binary mode. </param>
+        MappedDatasetWriter(std::ostream& stream);
+
+        /// <summary> Writes an example. </summary>
+        ///
+        /// <param name="example"> The example. </param>
+        void AddExample(const AutoSupervisedExample& example);
+
+        /// <summary> Writes the per-example columns and the header. No examples may be added afterwards. </summary>
+        void Finish();
+
+    private:
+        template <typename ValueType>
+        void Write(const ValueType* data, size_t size);
+        void WritePadding();
+
+        std::ostream& _stream;
+        std::streamoff _start;
+        uint64_t _position;
+        uint64_t _numFeatures = 0;
+
+        std::vector<double> _labels;
+        std::vector<double> _weights;
+        std::vector<uint64_t> _rowOffsets;
+        std::vector<uint64_t> _rowSizes;
+        std::vector<uint8_t> _rowFlags;
+
+        // the current row
+        std::vector<uint32_t> _indices;
+        std::vector<double> _values;
+    };
+
+    /// <summary> Writes all the examples from an example iterator to a stream in the binary dataset format. </summary>
+    ///
+    /// <param name="exampleIterator"> The example iterator. </param>
+    /// <param name="stream"> A seekable stream, opened in binary mode. </param>
+    void WriteMappedDataset(AutoSupervisedExampleIterator exampleIterator, std::ostream& stream);
+
+    /// <summary> Checks if a file starts like a binary dataset file. </summary>
+    ///
+    /// <param name="filepath"> The path of the file. </param>
+    ///
+    /// <returns> True if the file is a binary dataset file. </returns>
+    bool IsMappedDatasetFile(const std::string& filepath);
+}
+}
+
+#include "../tcc/MappedDataset.tcc"
@@ -0,0 +1,281 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     MappedDataset.cpp (data)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "MappedDataset.h"
+
+// utilities
+#include "Exception.h"
+
+// stl
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <limits>
+
+namespace ell
+{
+namespace data
+{
+    namespace
+    {
+        const char c_magic[8] = { 'E', 'L', 'L', 'D', 'A', 'T', 'A', '\0' };
+        const uint64_t c_version = 1;
+        const uint8_t c_sparseRowFlag = 1;
+
+        // the header at the start of a binary dataset file; all offsets are in bytes from the start of the file
+        struct Header
+        {
+            char magic[8];
+            uint64_t version;
+            uint64_t numExamples;
+            uint64_t numFeatures;
+            uint64_t labelsOffset;
+            uint64_t weightsOffset;
+            uint64_t rowOffsetsOffset;
+            uint64_t rowSizesOffset;
+            uint64_t rowFlagsOffset;
+        };
+
+        uint64_t GetPadding(uint64_t position)
+        {
+            return (8 - position % 8) % 8;
+        }
+    }
+
+    //
+    // MappedDataVectorIterator
+    //
+
+    MappedDataVectorIterator::MappedDataVectorIterator(const double* values, const uint32_t* indices, size_t size)
+        : _values(values), _indices(indices), _size(size)
+    {
+        SkipZeros();
+    }
+
+    void MappedDataVectorIterator::Next()
+    {
+        ++_current;
+        SkipZeros();
+    }
+
+    void MappedDataVectorIterator::SkipZeros()
+    {
+        while (_current < _size && _values[_current] == 0)
+        {
+            ++_current;
+        }
+    }
+
+    //
+    // MappedExample
+    //
+
+    MappedExample::MappedExample(const double* values, const uint32_t* indices, size_t size, WeightLabel metadata)
+        : _values(values), _indices(indices), _size(size), _metadata(metadata)
+    {
+    }
+
+    size_t MappedExample::PrefixLength() const
+    {
+        if (_size == 0)
+        {
+            return 0;
+        }
+        return _indices == nullptr ? _size : _indices[_size - 1] + 1;
+    }
+
+    //
+    // MappedDataset
+    //
+
+    MappedDataset::MappedDataset(const std::string& filepath)
+        : _file(filepath)
+    {
+        Header header;
+        if (_file.Size() < sizeof(header))
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::badData, filepath + " is too small to be a binary dataset file");
+        }
+        std::memcpy(&header, _file.GetData(), sizeof(header));
+
+        if (std::memcmp(header.magic, c_magic, sizeof(c_magic)) != 0)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::badData, filepath + " is not a binary dataset file");
+        }
+        if (header.version != c_version)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::versionMismatch, "unsupported binary dataset file version");
+        }
+
+        _numExamples = header.numExamples;
+        _numFeatures = header.numFeatures;
+        _labels = GetColumn<double>(header.labelsOffset, _numExamples);
+        _weights = GetColumn<double>(header.weightsOffset, _numExamples);
+        _rowOffsets = GetColumn<uint64_t>(header.rowOffsetsOffset, _numExamples);
+        _rowSizes = GetColumn<uint64_t>(header.rowSizesOffset, _numExamples);
+        _rowFlags = GetColumn<uint8_t>(header.rowFlagsOffset, _numExamples);
+    }
+
+    MappedExample MappedDataset::GetExample(size_t index) const
+    {
+        if (index >= _numExamples)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::indexOutOfRange);
+        }
+
+        auto size = _rowSizes[index];
+        bool isSparse = (_rowFlags[index] & c_sparseRowFlag) != 0;
+        auto values = GetColumn<double>(_rowOffsets[index], size);
+        auto indices = isSparse ? GetColumn<uint32_t>(_rowOffsets[index] + size * sizeof(double), size) : nullptr;
+        return MappedExample(values, indices, size, WeightLabel{ _weights[index], _labels[index] });
+    }
+
+    size_t MappedDataset::CorrectRangeSize(size_t fromIndex, size_t size) const
+    {
+        if (size == 0 || fromIndex + size > _numExamples)
+        {
+            return _numExamples - fromIndex;
+        }
+        return size;
+    }
+
+    template <typename ValueType>
+    const ValueType* MappedDataset::GetColumn(uint64_t offset, size_t size) const
+    {
+        // checks the offset and size separately, so that corrupt values can't overflow the sum
+        auto fileSize = _file.Size();
+        if (offset % alignof(ValueType) != 0 || offset > fileSize || size > (fileSize - offset) / sizeof(ValueType))
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::badData, "binary dataset file is truncated or corrupt");
+        }
+        return reinterpret_cast<const ValueType*>(_file.GetData() + offset);
+    }
+
+    //
+    // MappedDatasetWriter
+    //
+
+    MappedDatasetWriter::MappedDatasetWriter(std::ostream& stream)
+        : _stream(stream), _start(stream.tellp()), _position(0)
+    {
+        // reserve space for the header, which is written by Finish()
+        Header header = {};
+        Write(&header, 1);
+    }
+
+    void MappedDatasetWriter::AddExample(const AutoSupervisedExample& example)
+    {
+        _indices.clear();
+        _values.clear();
+        example.GetDataVector().ForEachElement<IterationPolicy::skipZeros>([this](IndexValue indexValue) {
+            if (indexValue.index > std::numeric_limits<uint32_t>::max())
+            {
+                throw utilities::InputException(utilities::InputExceptionErrors::indexOutOfRange, "binary dataset files only support feature indices that fit in 32 bits");
+            }
+            _indices.push_back(static_cast<uint32_t>(indexValue.index));
+            _values.push_back(indexValue.value);
+        });
+
+        // a sparse row stores 12 bytes per nonzero, and a dense row stores 8 bytes per element up to the last nonzero
+        uint64_t prefixLength = _indices.empty() ? 0 : _indices.back() + 1;
+        bool isSparse = 3 * _values.size() < 2 * prefixLength;
+
+        _labels.push_back(example.GetMetadata().label);
+        _weights.push_back(example.GetMetadata().weight);
+        _rowOffsets.push_back(_position);
+        _rowFlags.push_back(isSparse ? c_sparseRowFlag : 0);
+        if (isSparse)
+        {
+            _rowSizes.push_back(_values.size());
+            Write(_values.data(), _values.size());
+            Write(_indices.data(), _indices.size());
+        }
+        else
+        {
+            std::vector<double> denseValues(prefixLength);
+            for (size_t i = 0; i < _indices.size(); ++i)
+            {
+                denseValues[_indices[i]] = _values[i];
+            }
+            _rowSizes.push_back(prefixLength);
+            Write(denseValues.data(), denseValues.size());
+        }
+        WritePadding();
+
+        _numFeatures = std::max(_numFeatures, prefixLength);
+    }
+
+    void MappedDatasetWriter::Finish()
+    {
+        Header header = {};
+        std::memcpy(header.magic, c_magic, sizeof(c_magic));
+        header.version = c_version;
+        header.numExamples = _labels.size();
+        header.numFeatures = _numFeatures;
+
+        header.labelsOffset = _position;
+        Write(_labels.data(), _labels.size());
+        header.weightsOffset = _position;
+        Write(_weights.data(), _weights.size());
+        header.rowOffsetsOffset = _position;
+        Write(_rowOffsets.data(), _rowOffsets.size());
+        header.rowSizesOffset = _position;
+        Write(_rowSizes.data(), _rowSizes.size());
+        header.rowFlagsOffset = _position;
+        Write(_rowFlags.data(), _rowFlags.size());
+        WritePadding();
+
+        auto end = _stream.tellp();
+        _stream.seekp(_start);
+        _stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        _stream.seekp(end);
+        _stream.flush();
+
+        if (!_stream)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "error writing binary dataset file");
+        }
+    }
+
+    template <typename ValueType>
+    void MappedDatasetWriter::Write(const ValueType* data, size_t size)
+    {
+        _stream.write(reinterpret_cast<const char*>(data), size * sizeof(ValueType));
+        _position += size * sizeof(ValueType);
+    }
+
+    void MappedDatasetWriter::WritePadding()
+    {
+        const char zeros[8] = {};
+        Write(zeros, GetPadding(_position));
+    }
+
+    //
+    // Free functions
+    //
+
+    void WriteMappedDataset(AutoSupervisedExampleIterator exampleIterator, std::ostream& stream)
+    {
+        MappedDatasetWriter writer(stream);
+        while (exampleIterator.IsValid())
+        {
+            writer.AddExample(exampleIterator.Get());
+            exampleIterator.Next();
+        }
+        writer.Finish();
+    }
+
+    bool IsMappedDatasetFile(const std::string& filepath)
+    {
+        std::ifstream stream(filepath, std::ios::binary);
+        char magic[sizeof(c_magic)] = {};
+        stream.read(magic, sizeof(magic));
+        return stream && std::memcmp(magic, c_magic, sizeof(c_magic)) == 0;
+    }
+}
+}
@@ -102,6 +102,13 @@ namespace data
         _pInternal->AddTransformedTo<policy>(vector, transformation);
     }
 
+    template <typename DefaultDataVectorType>
+    template <IterationPolicy policy, typename FunctionType>
+    void AutoDataVectorBase<DefaultDataVectorType>::ForEachElement(FunctionType&& function) const
+    {
+        _pInternal->ForEachElement<policy>(std::forward<FunctionType>(function));
+    }
+
     template <typename DefaultDataVectorType>
     template <typename ReturnType, typename... ArgTypes>
     ReturnType AutoDataVectorBase<DefaultDataVectorType>::CopyAs(ArgTypes... args) const
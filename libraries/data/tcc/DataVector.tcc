@@ -62,6 +62,20 @@ namespace data
         });
     }
 
+    template <IterationPolicy policy, typename FunctionType>
+    void IDataVector::ForEachElement(FunctionType&& function) const
+    {
+        InvokeWithThis<void>([&function](const auto* pThis)
+        {
+            auto indexValueIterator = pThis->template GetIterator<policy>();
+            while (indexValueIterator.IsValid())
+            {
+                function(indexValueIterator.Get());
+                indexValueIterator.Next();
+            }
+        });
+    }
+
     template <typename ReturnType>
     ReturnType IDataVector::CopyAs() const
     {
@@ -6,6 +6,8 @@
 //
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
+#include "MappedDataset.h"
+
 // utilities
 #include "Exception.h"
 #include "Logger.h"
@@ -32,7 +34,8 @@ namespace data
         // all Dataset types for which GetAnyDataset() is called must be listed below, in the variadic template argument.
         using Invoker = utilities::AbstractInvoker<DatasetBase,
             Dataset<data::AutoSupervisedExample>,
-            Dataset<data::DenseSupervisedExample>>;
+            Dataset<data::DenseSupervisedExample>,
+            MappedDataset>;
 
         return Invoker::Invoke<ExampleIterator<ExampleType>>(getExampleIterator, _pDataset);
     }
@@ -0,0 +1,37 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     MappedDataset.tcc (data)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// stl
+#include <memory>
+
+namespace ell
+{
+namespace data
+{
+    template <typename ExampleType>
+    ExampleType MappedExample::CopyAs() const
+    {
+        using DataType = typename ExampleType::DataVectorType;
+        using MetadataType = typename ExampleType::MetadataType;
+        return ExampleType(std::make_shared<DataType>(GetIterator()), MetadataType(_metadata));
+    }
+
+    template <typename IteratorExampleType>
+    MappedDataset::MappedDatasetExampleIterator<IteratorExampleType>::MappedDatasetExampleIterator(const MappedDataset& dataset, size_t begin, size_t end)
+        : _dataset(dataset), _current(begin), _end(end)
+    {
+    }
+
+    template <typename IteratorExampleType>
+    ExampleIterator<IteratorExampleType> MappedDataset::GetExampleIterator(size_t fromIndex, size_t size) const
+    {
+        size = CorrectRangeSize(fromIndex, size);
+        return ExampleIterator<IteratorExampleType>(std::make_unique<MappedDatasetExampleIterator<IteratorExampleType>>(*this, fromIndex, fromIndex + size));
+    }
+}
+}
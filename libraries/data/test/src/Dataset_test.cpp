@@ -8,12 +8,21 @@
 
 #include "Dataset_test.h"
 #include "Dataset.h"
+#include "MappedDataset.h"
 
 // testing
 #include "testing.h"
 
+// utilities
+#include "Exception.h"
+
 // stl
+#include <cstdio>
+#include <fstream>
+#include <iterator>
 #include <sstream>
+#include <string>
+#include <vector>
 
 namespace ell
 {
@@ -66,4 +75,54 @@ void DatasetCastingTests()
     DatasetCastingTestDispatch<data::AutoSupervisedExample>();
     DatasetCastingTestDispatch<data::DenseSupervisedExample>();
 }
+
+void MappedDatasetTest()
+{
+    data::AutoSupervisedDataset dataset;
+    dataset.AddExample(data::AutoSupervisedExample({ 1, 2, 0, 3, 4 }, data::WeightLabel{ 1, 1 }));
+    dataset.AddExample(data::AutoSupervisedExample({ 0, 0, 0, 0, 0, 0, 0, 5, 0, 0, 0, 0, 6 }, data::WeightLabel{ 2, -1 }));
+    dataset.AddExample(data::AutoSupervisedExample(data::AutoDataVector(std::vector<double>{}), data::WeightLabel{ 0.5, 1 }));
+    dataset.AddExample(data::AutoSupervisedExample({ 0.25, 0, -0.5 }, data::WeightLabel{ 1, -1 }));
+
+    const std::string filename = "MappedDatasetTest.bin";
+    {
+        std::ofstream stream(filename, std::ios::binary);
+        data::WriteMappedDataset(dataset.GetExampleIterator(), stream);
+    }
+
+    {
+        data::MappedDataset mappedDataset(filename);
+        data::AutoSupervisedDataset copiedDataset(mappedDataset.GetAnyDataset());
+
+        std::stringstream originalStream, copiedStream;
+        dataset.Print(originalStream);
+        copiedDataset.Print(copiedStream);
+
+        testing::ProcessTest("MappedDataset::IsMappedDatasetFile", data::IsMappedDatasetFile(filename));
+        testing::ProcessTest("MappedDataset::NumExamples", mappedDataset.NumExamples() == dataset.NumExamples() && mappedDataset.NumFeatures() == dataset.NumFeatures());
+        testing::ProcessTest("MappedDataset row storage", !mappedDataset[0].IsSparse() && mappedDataset[1].IsSparse() && mappedDataset[1].PrefixLength() == 13);
+        testing::ProcessTest("MappedDataset::GetAnyDataset", originalStream.str() == copiedStream.str());
+    }
+
+    // a truncated file is rejected when it's opened
+    {
+        std::ifstream input(filename, std::ios::binary);
+        std::string contents((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+        std::ofstream output(filename, std::ios::binary);
+        output.write(contents.data(), contents.size() - 8);
+    }
+
+    bool threw = false;
+    try
+    {
+        data::MappedDataset mappedDataset(filename);
+    }
+    catch (const utilities::InputException&)
+    {
+        threw = true;
+    }
+    testing::ProcessTest("MappedDataset rejects truncated files", threw);
+
+    std::remove(filename.c_str());
+}
 }
\ No newline at end of file
@@ -27,6 +27,7 @@ int main()
     IteratorTests();
     ExampleCopyAsTests();
     DatasetCastingTests();
+    MappedDatasetTest();
     DataVectorParseTest();
     AutoDataVectorParseTest();
     SingleFileParseTest();
@@ -19,23 +19,32 @@ namespace ell
 {
 namespace dsp
 {
-    /// <summary> Perform an in-place discrete ("fast") fourier transform (FFT) of a complex-valued input signal. </summary>
+    /// <summary>
+    /// Perform an in-place discrete ("fast") fourier transform (FFT) of a complex-valued input signal. Signals of any
+    /// length are supported, using a mixed-radix transform. It's fastest for lengths whose prime factors are all small.
+    /// </summary>
     ///
-    /// <param name="signal"> The signal vector to process. Must be a power of 2 in length. </param>
+    /// <param name="signal"> The signal vector to process. </param>
     /// <param name="inverse"> A flag indicating if the inverse FFT should be computed instead. </param>
     template <typename ValueType>
     void FFT(std::vector<std::complex<ValueType>>& signal, bool inverse = false);
 
-    /// <summary> Perform an in-place discrete ("fast") fourier transform (FFT) of a real-valued input signal. </summary>
+    /// <summary>
+    /// Perform an in-place discrete ("fast") fourier transform (FFT) of a real-valued input signal, replacing it with the
+    /// magnitude of its spectrum. Signals of even length are transformed with a complex FFT of half the length.
+    /// </summary>
     ///
-    /// <param name="signal"> The signal vector to process. Must be a power of 2 in length. </param>
+    /// <param name="signal"> The signal vector to process. </param>
     /// <param name="inverse"> A flag indicating if the inverse FFT should be computed instead. </param>
     template <typename ValueType>
     void FFT(math::RowVector<ValueType>& signal, bool inverse = false);
 
-    /// <summary> Perform an in-place discrete ("fast") fourier transform (FFT) of a real-valued input signal. </summary>
+    /// <summary>
+    /// Perform an in-place discrete ("fast") fourier transform (FFT) of a real-valued input signal, replacing it with the
+    /// magnitude of its spectrum. Signals of even length are transformed with a complex FFT of half the length.
+    /// </summary>
     ///
-    /// <param name="signal"> The signal vector to process. Must be a power of 2 in length. </param>
+    /// <param name="signal"> The signal vector to process. </param>
     /// <param name="inverse"> A flag indicating if the inverse FFT should be computed instead. </param>
     template <typename ValueType>
     void FFT(std::vector<ValueType>& signal, bool inverse = false);
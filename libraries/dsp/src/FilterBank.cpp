@@ -160,7 +160,7 @@ namespace dsp
                 sum += static_cast<ValueType>(frequencyMagnitudes[k] * filter[k]);
             }
 
-            result[filterIndex] = sum;
+            result[filterIndex - _beginFilter] = sum;
         }
         return result;
     }
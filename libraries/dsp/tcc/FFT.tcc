@@ -12,120 +12,177 @@ namespace dsp
 {
     namespace detail
     {
-        template <typename Iterator>
-        void Deinterleave(Iterator begin, Iterator end, Iterator scratch)
+        // Returns w^k = e^(2*pi*i*k/size), for k in [0, size)
+        template <typename ValueType>
+        std::vector<std::complex<ValueType>> GetTwiddleFactors(size_t size)
         {
-            const auto size = end - begin;
-            const auto halfN = size / 2;
-            for (int index = 0; index < halfN; ++index)
+            const ValueType pi = math::Constants<ValueType>::pi;
+            std::vector<std::complex<ValueType>> result(size);
+            for (size_t k = 0; k < size; ++k)
             {
-                scratch[index] = begin[2 * index + 1];
-                begin[index] = begin[2 * index];
+                result[k] = std::exp(std::complex<ValueType>(0, 2 * pi * k / size));
             }
-            for (int index = 0; index < halfN; ++index)
+            return result;
+        }
+
+        // Returns the smallest prime factor of `size`, which is the radix used for the first step of an FFT of that size
+        inline size_t GetRadix(size_t size)
+        {
+            for (size_t factor = 2; factor * factor <= size; ++factor)
             {
-                begin[index + halfN] = scratch[index];
+                if (size % factor == 0)
+                {
+                    return factor;
+                }
             }
+            return size;
         }
 
-        template <typename Iterator>
-        void FFT(Iterator begin, Iterator end, Iterator scratch, bool inverse)
+        // Mixed-radix decimation-in-time FFT. `twiddles` holds the twiddle factors of a transform `stride` times as
+        // long as this one, so the sub-transforms share the top-level table. `scratch` must be as long as the signal.
+        template <typename Iterator, typename TwiddleIterator>
+        void FFT(Iterator begin, Iterator end, Iterator scratch, TwiddleIterator twiddles, size_t stride)
         {
-            assert(!inverse);
-            using ValueType = typename Iterator::value_type::value_type;
-            const ValueType pi = math::Constants<ValueType>::pi;
-
-            auto halfN = (end - begin) / 2;
-            if (halfN < 1)
+            using ComplexType = typename Iterator::value_type;
+            const size_t size = end - begin;
+            if (size < 2)
             {
                 return; // done
             }
 
-            Deinterleave(begin, end, scratch);
-            auto evens = begin;
-            auto odds = begin + halfN;
-
-            if (halfN > 1)
+            const auto radix = GetRadix(size);
+            const auto subSize = size / radix;
+            if (subSize > 1)
             {
-                FFT(evens, evens + halfN, scratch, inverse);
-                FFT(odds, odds + halfN, scratch, inverse);
+                // Deinterleave into `radix` subsequences of every radix-th sample, and transform each of them
+                for (size_t r = 0; r < radix; ++r)
+                {
+                    for (size_t index = 0; index < subSize; ++index)
+                    {
+                        scratch[r * subSize + index] = begin[index * radix + r];
+                    }
+                }
+                std::copy(scratch, scratch + size, begin);
+                for (size_t r = 0; r < radix; ++r)
+                {
+                    FFT(begin + r * subSize, begin + (r + 1) * subSize, scratch, twiddles, stride * radix);
+                }
             }
 
-            for (int k = 0; k < halfN; k++)
+            if (radix == 2)
             {
-                // w = e^(2*pi*k/N)
-                std::complex<ValueType> w = std::exp(std::complex<ValueType>(0, pi * k / halfN));
-                auto e = evens[k];
-                auto o = odds[k];
-                auto wo = w * o;
-                evens[k] = e + wo; // even
-                odds[k] = e - wo; // odd
+                auto evens = begin;
+                auto odds = begin + subSize;
+                for (size_t k = 0; k < subSize; ++k)
+                {
+                    auto e = evens[k];
+                    auto wo = twiddles[k * stride] * odds[k];
+                    evens[k] = e + wo; // even
+                    odds[k] = e - wo; // odd
+                }
+            }
+            else
+            {
+                // Output k + subSize*q is the sum over r of w^(r*(k + subSize*q)) times output k of subsequence r
+                for (size_t k = 0; k < subSize; ++k)
+                {
+                    for (size_t q = 0; q < radix; ++q)
+                    {
+                        ComplexType sum = 0;
+                        for (size_t r = 0; r < radix; ++r)
+                        {
+                            sum += twiddles[((r * (k + subSize * q)) % size) * stride] * begin[r * subSize + k];
+                        }
+                        scratch[q] = sum;
+                    }
+                    for (size_t q = 0; q < radix; ++q)
+                    {
+                        begin[k + subSize * q] = scratch[q];
+                    }
+                }
             }
         }
 
-        template <typename Iterator, typename ComplexIterator>
-        void FFTReal(Iterator begin, Iterator end, Iterator scratch, ComplexIterator outputBegin, ComplexIterator outputEnd, bool inverse)
+        template <typename Iterator>
+        void FFT(Iterator begin, Iterator end, Iterator scratch)
         {
-            assert(!inverse);
-            using ValueType = typename Iterator::value_type;
-            const ValueType pi = math::Constants<ValueType>::pi;
+            using ValueType = typename Iterator::value_type::value_type;
+            auto twiddles = GetTwiddleFactors<ValueType>(end - begin);
+            FFT(begin, end, scratch, twiddles.begin(), 1);
+        }
 
-            auto halfN = (end - begin) / 2;
-            if (halfN < 1)
+        // Computes the full spectrum of a real-valued signal. A signal of even length N is packed into a complex signal
+        // of length N/2 (even samples in the real part, odd ones in the imaginary part), which is transformed and then
+        // split into the spectra of the even and odd samples, and combined.
+        template <typename Iterator>
+        std::vector<std::complex<typename Iterator::value_type>> RealFFT(Iterator begin, Iterator end)
+        {
+            using ValueType = typename Iterator::value_type;
+            using ComplexType = std::complex<ValueType>;
+            const size_t size = end - begin;
+            std::vector<ComplexType> result(size);
+            if (size % 2 != 0)
             {
-                return; // done
+                for (size_t index = 0; index < size; ++index)
+                {
+                    result[index] = begin[index];
+                }
+                std::vector<ComplexType> scratch(size);
+                FFT(result.begin(), result.end(), scratch.begin());
+                return result;
             }
 
-            Deinterleave(begin, end, scratch);
-
-            auto evens = begin;
-            auto odds = begin + halfN;
-            auto complexEvens = outputBegin;
-            auto complexOdds = outputBegin + halfN;
-
-            if (halfN > 1)
+            const auto halfN = size / 2;
+            for (size_t index = 0; index < halfN; ++index)
             {
-                FFTReal(evens, evens + halfN, scratch, complexEvens, complexEvens + halfN, inverse);
-                FFTReal(odds, odds + halfN, scratch, complexOdds, complexOdds + halfN, inverse);
+                result[index] = { begin[2 * index], begin[2 * index + 1] };
             }
-            else
+
+            // The transform of length N/2 uses every other twiddle factor of length N
+            auto twiddles = GetTwiddleFactors<ValueType>(size);
+            std::vector<ComplexType> scratch(halfN);
+            FFT(result.begin(), result.begin() + halfN, scratch.begin(), twiddles.begin(), 2);
+
+            // Z = E + iO, where E and O are the spectra of the even and odd samples. Since those are real,
+            // E[k] = (Z[k] + conj(Z[N/2-k])) / 2 and O[k] = (Z[k] - conj(Z[N/2-k])) / 2i. Then X[k] = E[k] + w^k O[k],
+            // and X[N/2-k] = conj(E[k] - w^k O[k]).
+            const ComplexType minusHalfI(0, -0.5);
+            auto z0 = result[0];
+            result[0] = z0.real() + z0.imag();
+            result[halfN] = z0.real() - z0.imag();
+            for (size_t k = 1; k <= halfN / 2; ++k)
             {
-                // Base case: copy from real to complex
-                for (int index = 0; index < halfN; ++index)
-                {
-                    complexEvens[index] = evens[index];
-                    complexOdds[index] = odds[index];
-                }
+                auto a = result[k];
+                auto b = std::conj(result[halfN - k]);
+                auto e = (a + b) * static_cast<ValueType>(0.5);
+                auto wo = twiddles[k] * (a - b) * minusHalfI;
+                result[k] = e + wo;
+                result[halfN - k] = std::conj(e - wo);
             }
 
-            for (int k = 0; k < halfN; k++)
+            // The spectrum of a real signal is conjugate-symmetric
+            for (size_t k = 1; k < halfN; ++k)
             {
-                // w = e^(2*pi*k/N)
-                std::complex<ValueType> w = std::exp(std::complex<ValueType>(0, pi * k / halfN));
-                auto e = complexEvens[k];
-                auto o = complexOdds[k];
-                auto wo = w * o;
-                complexEvens[k] = e + wo; // even
-                complexOdds[k] = e - wo; // odd
+                result[size - k] = std::conj(result[k]);
             }
+            return result;
         }
     }
 
     template <typename ValueType>
     void FFT(std::vector<std::complex<ValueType>>& input, bool inverse)
     {
-        std::vector<std::complex<ValueType>> scratch(input.size() / 2);
-        detail::FFT(std::begin(input), std::end(input), std::begin(scratch), inverse);
+        assert(!inverse);
+        std::vector<std::complex<ValueType>> scratch(input.size());
+        detail::FFT(std::begin(input), std::end(input), std::begin(scratch));
     }
 
     template <typename ValueType>
     void FFT(std::vector<ValueType>& input, bool inverse)
     {
-        auto size = input.size();
-        std::vector<ValueType> scratch(size / 2);
-        std::vector<std::complex<ValueType>> output(size);
-        detail::FFTReal(std::begin(input), std::end(input), std::begin(scratch), std::begin(output), std::end(output), inverse);
-        for (size_t index = 0; index < size; ++index)
+        assert(!inverse);
+        auto output = detail::RealFFT(std::begin(input), std::end(input));
+        for (size_t index = 0; index < input.size(); ++index)
         {
             input[index] = std::abs(output[index]);
         }
@@ -134,12 +191,11 @@ namespace dsp
     template <typename ValueType>
     void FFT(math::RowVector<ValueType>& input, bool inverse)
     {
+        assert(!inverse);
         using std::begin;
-        auto size = input.Size();
-        math::RowVector<ValueType> scratch(size / 2);
-        std::vector<std::complex<ValueType>> output(size);
-        detail::FFTReal(begin(input), end(input), begin(scratch), begin(output), end(output), inverse);
-        for (size_t index = 0; index < size; ++index)
+        using std::end;
+        auto output = detail::RealFFT(begin(input), end(input));
+        for (size_t index = 0; index < input.Size(); ++index)
         {
             input[index] = std::abs(output[index]);
         }
@@ -81,6 +81,30 @@ void TestFFT(size_t N)
         auto x2 = complexSignal[index];
         testing::ProcessTest("Testing real-valued FFT of random signal", testing::IsEqual(x1, std::abs(x2), epsilon));
     }
+
+    //
+    // Test agreement with a direct DFT, random signal
+    //
+    std::vector<std::complex<ValueType>> dft(N);
+    for (size_t index = 0; index < N; ++index)
+    {
+        complexSignal[index] = { uniform(randomEngine), uniform(randomEngine) };
+    }
+    const double pi = math::Constants<double>::pi;
+    for (size_t k = 0; k < N; ++k)
+    {
+        std::complex<double> sum = 0;
+        for (size_t index = 0; index < N; ++index)
+        {
+            sum += std::complex<double>(complexSignal[index]) * std::exp(std::complex<double>(0, 2 * pi * ((k * index) % N) / N));
+        }
+        dft[k] = std::complex<ValueType>(sum);
+    }
+    FFT(complexSignal);
+    for (size_t index = 0; index < N; ++index)
+    {
+        testing::ProcessTest("Testing FFT against DFT of random signal", testing::IsEqual(std::abs(complexSignal[index] - dft[index]), static_cast<ValueType>(0), static_cast<ValueType>(1e-4)));
+    }
 }
 
 //
@@ -33,6 +33,9 @@ int main()
     // FFT
     TestFFT<float>(16);
     TestFFT<double>(16);
+    TestFFT<float>(12); // mixed radix
+    TestFFT<double>(15); // odd length: no real-valued packing
+    TestFFT<double>(14); // packed into an FFT of prime length
 
     // Filters
     TestIIRFilter<float>();
@@ -32,6 +32,19 @@ namespace emitters
 {
     class IRModuleEmitter;
 
+    /// <summary> Options for splitting a loop into parallel tasks with `IRFunctionEmitter::ParallelFor`. </summary>
+    struct ParallelForOptions
+    {
+        /// <summary> The number of tasks to split the loop into. If 0, the `maxThreads` compiler setting is used. </summary>
+        int numTasks = 0;
+
+        /// <summary> The amount of work done by one iteration of the loop, e.g. the number of elements it writes. </summary>
+        int iterationSize = 1;
+
+        /// <summary> The least amount of work (iterations times `iterationSize`) worth giving to a task. </summary>
+        int minimumTaskSize = 4000;
+    };
+
     /// <summary> Used to emit code into an existing LLVM IR Function </summary>
     class IRFunctionEmitter
     {
@@ -968,6 +981,32 @@ namespace emitters
         /// <returns> A task array object representing the running tasks. </param>
         IRTaskArray StartTasks(llvm::Function* taskFunction, const std::vector<std::vector<llvm::Value*>>& arguments);
 
+        /// <summary> Type alias for parallel-for body lambda. </summary>
+        using ParallelForBodyFunction = std::function<void(IRFunctionEmitter& function, llvm::Value* beginValue, llvm::Value* endValue, const std::vector<llvm::Value*>& capturedValues)>;
+
+        /// <summary>
+        /// Emits a loop whose iterations are split into contiguous ranges, each run as a task, if the `parallelize`
+        /// compiler setting is on and the loop does enough work (see `ParallelForOptions`). Otherwise the body is
+        /// emitted once, into this function, over the whole range.
+        /// </summary>
+        ///
+        /// <param name="count"> The number of iterations of the loop. </param>
+        /// <param name="options"> How to split the loop into tasks. </param>
+        /// <param name="capturedValues"> The values the body uses, such as the node's port variables. Values local to
+        ///  this function are passed to the task function as arguments; globals and constants are passed through. </param>
+        /// <param name="body"> A function that emits the loop over the iterations from `beginValue` up to (but not
+        ///  including) `endValue`. It may be called with a task function rather than this one, so it must use the
+        ///  function and `capturedValues` it is given instead of the originals. </param>
+        void ParallelFor(int count, const ParallelForOptions& options, const std::vector<llvm::Value*>& capturedValues, ParallelForBodyFunction body);
+
+        /// <summary> Gets the number of tasks `ParallelFor` splits a loop into. </summary>
+        ///
+        /// <param name="count"> The number of iterations of the loop. </param>
+        /// <param name="options"> How to split the loop into tasks. </param>
+        ///
+        /// <returns> The number of tasks, or 1 if the loop runs on the calling thread. </returns>
+        int GetParallelForTaskCount(int count, const ParallelForOptions& options);
+
         //
         // Standard C library function calls
         //
@@ -1215,7 +1254,7 @@ namespace emitters
         /// <typeparam name="ValueType"> The datatype to use (must be `float` or `double`) </typeparam>
         /// <param name="m"> The number of rows in the matrix A and the output vector y </param>
         /// <param name="n"> The number of columns in the matrix A and the vector x </param>
-        /// <param name="A"> The matrix to multiply with a vector </param>
+        /// <param name="A"> The matrix to multiply with a vector. If `ValueType` is `float`, it may be stored in half precision (see IRHalfPrecision.h). </param>
         /// <param name="lda"> The stride of the matrix -- the number of elements between rows </param>
         /// <param name="x"> The input vector x </param>
         /// <param name="incx"> The increment between values of x </param>
@@ -1230,7 +1269,7 @@ namespace emitters
         /// <param name="m"> The number of rows in the matrix A and the output vector y </param>
         /// <param name="n"> The number of columns in the matrix A and the vector x </param>
         /// <param name="alpha"> The scalar to multiply with the A*x product </param>
-        /// <param name="A"> The matrix to multiply with a vector </param>
+        /// <param name="A"> The matrix to multiply with a vector. If `ValueType` is `float`, it may be stored in half precision (see IRHalfPrecision.h). </param>
         /// <param name="lda"> The stride of the matrix -- the number of elements between rows </param>
         /// <param name="x"> The input vector x </param>
         /// <param name="incx"> The increment between values of x </param>
@@ -1246,7 +1285,7 @@ namespace emitters
         /// <param name="m"> The number of rows in the matrix A and the output matrix  C </param>
         /// <param name="n"> The number of columns in the matrix B and the output matrix C </param>
         /// <param name="k"> The number of rows in the matrix A and columns in matrix B </param>
-        /// <param name="A"> The matrix to multiply on the left </param>
+        /// <param name="A"> The matrix to multiply on the left. If `ValueType` is `float`, it may be stored in half precision (see IRHalfPrecision.h). </param>
         /// <param name="lda"> The stride of the matrix A -- the number of elements between rows </param>
         /// <param name="B"> The matrix to multiply on the right </param>
         /// <param name="ldb"> The stride of the matrix B -- the number of elements between rows </param>
@@ -1263,7 +1302,7 @@ namespace emitters
         /// <param name="m"> The number of rows in the matrix A and the output matrix  C </param>
         /// <param name="n"> The number of columns in the matrix B and the output matrix C </param>
         /// <param name="k"> The number of rows in the matrix A and columns in matrix B </param>
-        /// <param name="A"> The matrix to multiply on the left </param>
+        /// <param name="A"> The matrix to multiply on the left. If `ValueType` is `float`, it may be stored in half precision (see IRHalfPrecision.h). </param>
         /// <param name="lda"> The stride of the matrix A -- the number of elements between rows </param>
         /// <param name="B"> The matrix to multiply on the right </param>
         /// <param name="ldb"> The stride of the matrix B -- the number of elements between rows </param>
@@ -1272,6 +1311,19 @@ namespace emitters
         template <typename ValueType>
         void CallGEMM(bool transposeA, bool transposeB, int m, int n, int k, llvm::Value* A, int lda, llvm::Value* B, int ldb, llvm::Value* C, int ldc);
 
+        /// <summary> Call the 8-bit integer matrix-matrix multiply routine that computes the matrix product C = A*B', accumulating in 32-bit integers </summary>
+        ///
+        /// <param name="m"> The number of rows in the matrix A and the output matrix C </param>
+        /// <param name="n"> The number of rows in the matrix B and columns in the output matrix C </param>
+        /// <param name="k"> The number of columns in the matrices A and B </param>
+        /// <param name="A"> The matrix of signed bytes to multiply on the left </param>
+        /// <param name="lda"> The stride of the matrix A -- the number of elements between rows </param>
+        /// <param name="B"> The matrix of signed bytes whose transpose is multiplied on the right </param>
+        /// <param name="ldb"> The stride of the matrix B -- the number of elements between rows </param>
+        /// <param name="C"> The result matrix of 32-bit integers </param>
+        /// <param name="ldc"> The stride of the matrix C -- the number of elements between rows </param>
+        void CallInt8GEMM(int m, int n, int k, llvm::Value* A, int lda, llvm::Value* B, int ldb, llvm::Value* C, int ldc);
+
         /// <summary> Utility function for getting number of threads used by OpenBLAS (if present) </summary>
         llvm::Value* GetNumOpenBLASThreads();
 
@@ -1400,6 +1452,11 @@ namespace emitters
         /// <summary> Tags the predict function to be included in the SWIG interface. </summary>
         void IncludeInPredictInterface();
 
+        /// <summary> Tags the batched predict function to be included in the SWIG interface. </summary>
+        ///
+        /// <param name="namespacePrefix"> The namespace prefix of the module's runtime functions. </param>
+        void IncludeInPredictBatchInterface(const std::string& namespacePrefix);
+
         /// <summary> Tags a profiling function to be included in the SWIG interface. </summary>
         void IncludeInSwigInterface();
 
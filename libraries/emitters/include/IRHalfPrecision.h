@@ -0,0 +1,69 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     IRHalfPrecision.h (emitters)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "IRFunctionEmitter.h"
+#include "LLVMInclude.h"
+
+// stl
+#include <cstdint>
+#include <vector>
+
+namespace ell
+{
+namespace emitters
+{
+    //
+    // Half-precision (IEEE 754 binary16) values.
+    //
+    // Half-precision values are stored as 16-bit integers holding their bit pattern, so they can be put in constant
+    // arrays and loaded (as scalars or vectors) on targets without native half-precision support. They are only used
+    // for storage: they're widened to float as they are loaded, and all arithmetic is done in float.
+    //
+
+    /// <summary> Converts a float to half precision, rounding to the nearest representable value (ties to even) </summary>
+    ///
+    /// <param name="value"> The value to convert </param>
+    ///
+    /// <returns> The bit pattern of the half-precision value </returns>
+    int16_t FloatToHalf(float value);
+
+    /// <summary> Converts a vector of floats to half precision </summary>
+    ///
+    /// <param name="values"> The values to convert </param>
+    ///
+    /// <returns> The bit patterns of the half-precision values </returns>
+    std::vector<int16_t> FloatToHalf(const std::vector<float>& values);
+
+    /// <summary> Converts a half-precision value to float. The conversion is exact. </summary>
+    ///
+    /// <param name="value"> The bit pattern of the half-precision value </param>
+    ///
+    /// <returns> The value as a float </returns>
+    float HalfToFloat(int16_t value);
+
+    /// <summary> Indicates if a pointer points to half-precision values (that is, to 16-bit integers) </summary>
+    ///
+    /// <param name="pointer"> The pointer </param>
+    ///
+    /// <returns> `true` if the pointer points to half-precision values </returns>
+    bool IsHalfPrecisionPointer(llvm::Value* pointer);
+
+    /// <summary>
+    /// Emit the conversion of a half-precision value (a 16-bit integer), or of a vector of them, to float. The conversion
+    /// is done with integer operations and `select`, so it doesn't need target support for half precision and vectorizes.
+    /// </summary>
+    ///
+    /// <param name="function"> The function being emitted </param>
+    /// <param name="value"> The bit pattern of the half-precision value, or a vector of them </param>
+    ///
+    /// <returns> The value as a float, or a vector of floats with the same number of elements </returns>
+    llvm::Value* EmitHalfToFloat(IRFunctionEmitter& function, llvm::Value* value);
+}
+}
@@ -0,0 +1,95 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     IRMathFunctions.h (emitters)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "IRFunctionEmitter.h"
+#include "LLVMInclude.h"
+#include "ModuleEmitter.h"
+
+namespace ell
+{
+namespace emitters
+{
+    //
+    // Inline approximations of transcendental functions.
+    //
+    // These emit straight-line code (range reduction followed by a polynomial, with special cases handled by
+    // `select`) instead of calls to the C runtime, so loops that use them can be vectorized. The argument may be a
+    // float or double scalar, or a vector of floats or doubles, in which case the function is applied to each element.
+    //
+
+    /// <summary> Emit an inline approximation of `exp(x)` </summary>
+    ///
+    /// <param name="function"> The function being emitted </param>
+    /// <param name="x"> The argument </param>
+    /// <param name="accuracy"> The accuracy of the approximation </param>
+    ///
+    /// <returns> The value of `exp(x)`, with the same type as `x` </returns>
+    llvm::Value* EmitExp(IRFunctionEmitter& function, llvm::Value* x, MathFunctionAccuracy accuracy);
+
+    /// <summary> Emit an inline approximation of `exp(x)`, using the accuracy in the module's compiler parameters </summary>
+    ///
+    /// <param name="function"> The function being emitted </param>
+    /// <param name="x"> The argument </param>
+    ///
+    /// <returns> The value of `exp(x)`, with the same type as `x` </returns>
+    llvm::Value* EmitExp(IRFunctionEmitter& function, llvm::Value* x);
+
+    /// <summary> Emit an inline approximation of the natural logarithm `log(x)` </summary>
+    ///
+    /// <param name="function"> The function being emitted </param>
+    /// <param name="x"> The argument </param>
+    /// <param name="accuracy"> The accuracy of the approximation </param>
+    ///
+    /// <returns> The value of `log(x)`, with the same type as `x` </returns>
+    llvm::Value* EmitLog(IRFunctionEmitter& function, llvm::Value* x, MathFunctionAccuracy accuracy);
+
+    /// <summary> Emit an inline approximation of `log(x)`, using the accuracy in the module's compiler parameters </summary>
+    ///
+    /// <param name="function"> The function being emitted </param>
+    /// <param name="x"> The argument </param>
+    ///
+    /// <returns> The value of `log(x)`, with the same type as `x` </returns>
+    llvm::Value* EmitLog(IRFunctionEmitter& function, llvm::Value* x);
+
+    /// <summary> Emit an inline approximation of `tanh(x)` </summary>
+    ///
+    /// <param name="function"> The function being emitted </param>
+    /// <param name="x"> The argument </param>
+    /// <param name="accuracy"> The accuracy of the approximation </param>
+    ///
+    /// <returns> The value of `tanh(x)`, with the same type as `x` </returns>
+    llvm::Value* EmitTanh(IRFunctionEmitter& function, llvm::Value* x, MathFunctionAccuracy accuracy);
+
+    /// <summary> Emit an inline approximation of `tanh(x)`, using the accuracy in the module's compiler parameters </summary>
+    ///
+    /// <param name="function"> The function being emitted </param>
+    /// <param name="x"> The argument </param>
+    ///
+    /// <returns> The value of `tanh(x)`, with the same type as `x` </returns>
+    llvm::Value* EmitTanh(IRFunctionEmitter& function, llvm::Value* x);
+
+    /// <summary> Emit an inline approximation of the logistic sigmoid function `1 / (1 + exp(-x))` </summary>
+    ///
+    /// <param name="function"> The function being emitted </param>
+    /// <param name="x"> The argument </param>
+    /// <param name="accuracy"> The accuracy of the approximation </param>
+    ///
+    /// <returns> The value of `sigmoid(x)`, with the same type as `x` </returns>
+    llvm::Value* EmitSigmoid(IRFunctionEmitter& function, llvm::Value* x, MathFunctionAccuracy accuracy);
+
+    /// <summary> Emit an inline approximation of `sigmoid(x)`, using the accuracy in the module's compiler parameters </summary>
+    ///
+    /// <param name="function"> The function being emitted </param>
+    /// <param name="x"> The argument </param>
+    ///
+    /// <returns> The value of `sigmoid(x)`, with the same type as `x` </returns>
+    llvm::Value* EmitSigmoid(IRFunctionEmitter& function, llvm::Value* x);
+}
+}
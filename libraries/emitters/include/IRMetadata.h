@@ -40,6 +40,12 @@ namespace emitters
     /// <summary> Indicates the Predict function that should be wrapped by SWIG. </summary>
     static const std::string c_predictFunctionTagName = "ell.fn.predict";
 
+    /// <summary> Indicates the batched Predict function that should be wrapped by SWIG. </summary>
+    /// <remarks>
+    /// Set the value to the module's namespace prefix.
+    /// </remarks>
+    static const std::string c_predictBatchFunctionTagName = "ell.fn.predictBatch";
+
     /// <summary> Indicates a function that should be wrapped by SWIG. </summary>
     static const std::string c_swigFunctionTagName = "ell.fn.swig";
 
@@ -55,6 +61,12 @@ namespace emitters
     /// </remarks>
     static const std::string c_stepTimeFunctionTagName = "ell.fn.stepTime";
 
+    /// <summary> Indicates the function that returns the size of the workspace a reentrant predict function needs. </summary>
+    /// <remarks>
+    /// Set the value to the module's namespace prefix. The header writer emits helpers to allocate and free a workspace.
+    /// </remarks>
+    static const std::string c_workspaceSizeFunctionTagName = "ell.fn.workspaceSize";
+
     /// <summary> Gets tag to Indicate the names of a struct's fields. </summary>
     /// <remarks>
     /// Returns a module-level tag, with the type name encoded in the name and field names as the value.
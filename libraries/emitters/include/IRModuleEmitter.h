@@ -681,6 +681,10 @@ namespace emitters
         template <typename T>
         llvm::Value* EmitRef(VectorElementVariable<T>& var);
 
+        /// Emit IR for a view into a region of a global vector.
+        template <typename T>
+        llvm::Value* EmitRef(VectorSliceVariable<T>& var);
+
         IRFunctionEmitter Function(const std::string& name, VariableType returnType, bool isPublic = false);
         IRFunctionEmitter Function(const std::string& name, VariableType returnType, const VariableTypeList& arguments, bool isPublic = false);
         IRFunctionEmitter Function(const std::string& name, VariableType returnType, const NamedVariableTypeList& arguments, bool isPublic = false);
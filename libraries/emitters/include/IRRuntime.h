@@ -126,6 +126,31 @@ namespace emitters
         template <typename ValueType>
         llvm::Function* GetGEMMFunction(bool useBlas);
 
+        /// <summary>
+        /// Get the native 8-bit integer matrix multiply function, which computes C = A B' for a row-major m x k matrix A
+        /// and n x k matrix B of signed bytes, accumulating into the row-major m x n matrix C of 32-bit integers. Its
+        /// arguments are (m, n, k, A, lda, B, ldb, C, ldc).
+        /// </summary>
+        ///
+        /// <returns> An LLVM function pointer to the function. </returns>
+        llvm::Function* GetInt8GEMMFunction();
+
+        /// <summary>
+        /// Get the native float gemv function for a matrix A stored in half precision (see IRHalfPrecision.h). It takes the
+        /// same arguments as `cblas_sgemv`, except that A is a pointer to 16-bit integers.
+        /// </summary>
+        ///
+        /// <returns> An LLVM function pointer to the function. </returns>
+        llvm::Function* GetHalfPrecisionGEMVFunction();
+
+        /// <summary>
+        /// Get the native float gemm function for a matrix A stored in half precision (see IRHalfPrecision.h). It takes the
+        /// same arguments as `cblas_sgemm`, except that A is a pointer to 16-bit integers.
+        /// </summary>
+        ///
+        /// <returns> An LLVM function pointer to the function. </returns>
+        llvm::Function* GetHalfPrecisionGEMMFunction();
+
         // Special OpenBLAS utility functions
         
         /// <summary> Get the OpenBLAS function for getting the number of threads </summary>
@@ -52,6 +52,26 @@ namespace emitters
     /// <returns> The sum of the elements in the given vector </returns>
     template <typename ValueType>
     llvm::Value* HorizontalVectorSum(IRFunctionEmitter& function, llvm::Value* vectorValue);
+
+    /// <summary> Load a vector from a pointer that is only aligned to its element type </summary>
+    ///
+    /// <typeparam name="ValueType"> The type of the vector elements </typeparam>
+    /// <param name="function"> The function being emitted </param>
+    /// <param name="pointer"> Pointer to the first element to load </param>
+    /// <param name="vectorType"> The LLVM type of the vector to load </param>
+    ///
+    /// <returns> The loaded vector </returns>
+    template <typename ValueType>
+    llvm::Value* LoadVector(IRFunctionEmitter& function, llvm::Value* pointer, llvm::VectorType* vectorType);
+
+    /// <summary> Store a vector to a pointer that is only aligned to its element type </summary>
+    ///
+    /// <typeparam name="ValueType"> The type of the vector elements </typeparam>
+    /// <param name="function"> The function being emitted </param>
+    /// <param name="pointer"> Pointer to the first element to store </param>
+    /// <param name="value"> The vector to store </param>
+    template <typename ValueType>
+    void StoreVector(IRFunctionEmitter& function, llvm::Value* pointer, llvm::Value* value);
 }
 }
 
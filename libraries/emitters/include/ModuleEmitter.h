@@ -37,7 +37,16 @@ namespace emitters
         openBLAS,
         atlas
     };
-    
+
+    /// <summary> Accuracy of the inline approximations emitted for exp, log, tanh and sigmoid. </summary>
+    enum class MathFunctionAccuracy
+    {
+        /// <summary> Shorter polynomials, with a relative error of about 1e-5 (float) or 1e-8 (double). </summary>
+        fast = 0,
+        /// <summary> Accurate to within a few units in the last place. </summary>
+        precise
+    };
+
     /// <summary> Standard compiler switches. </summary>
     struct CompilerParameters
     {
@@ -52,6 +61,8 @@ namespace emitters
         bool parallelize = false;
         bool useThreadPool = true;
         int maxThreads = 4;
+        MathFunctionAccuracy mathFunctionAccuracy = MathFunctionAccuracy::precise;
+        bool useHalfPrecisionWeights = false;
         bool debug = false;
 
         TargetDevice targetDevice;
@@ -15,6 +15,25 @@ namespace ell
 {
 namespace emitters
 {
+    /// <summary> Cache- and register-blocking sizes for the native (non-BLAS) matrix multiply. Zero means "use the target's default". </summary>
+    struct GemmTileSizes
+    {
+        /// <summary> The number of rows of the left-hand matrix packed into each cache-resident block. </summary>
+        int m = 0;
+
+        /// <summary> The number of columns of the right-hand matrix packed into each cache-resident block. </summary>
+        int n = 0;
+
+        /// <summary> The depth (the shared dimension) of the packed blocks. </summary>
+        int k = 0;
+
+        /// <summary> The number of output rows computed at once by the register-blocked inner kernel. </summary>
+        int kernelRows = 0;
+
+        /// <summary> The number of output columns computed at once by the inner kernel, in units of the vector width. </summary>
+        int kernelColumnVectors = 0;
+    };
+
     /// <summary> Properties of a target device. </summary>
     struct TargetDevice
     {
@@ -25,6 +44,7 @@ namespace emitters
         std::string cpu = "";
         std::string features = "";
         size_t numBits = 0;
+        GemmTileSizes gemmTileSizes;
 
         /// <summary> Indicates if the target device is a Windows system </summary>
         bool IsWindows() const;
@@ -34,6 +54,9 @@ namespace emitters
         
         /// <summary> Indicates if the target device is a macOS system </summary>
         bool IsMacOS() const;
+
+        /// <summary> Gets the tile sizes for the native matrix multiply, using the defaults for the target's architecture for any that aren't set </summary>
+        GemmTileSizes GetGemmTileSizes() const;
     };
 }
 }
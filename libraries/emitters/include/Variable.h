@@ -188,6 +188,9 @@ namespace emitters
         /// <summary> Add a reference to vector element </summary>
         Variable* AddVectorElementVariable(VariableType type, Variable& src, int offset);
 
+        /// <summary> Add a view of a contiguous region of a vector </summary>
+        Variable* AddVectorSliceVariable(VariableType type, Variable& src, int offset, int size);
+
     private:
         std::vector<std::shared_ptr<Variable>> _variables;
     };
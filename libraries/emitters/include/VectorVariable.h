@@ -76,6 +76,28 @@ namespace emitters
     private:
         std::vector<ElementType> _data;
     };
+
+    /// <summary>
+    /// A vector variable that is a view of a contiguous region of another (larger) vector variable. Used to
+    /// place several logical vectors in a single block of memory.
+    /// </summary>
+    template <typename T>
+    class VectorSliceVariable : public VectorVariable<T>
+    {
+    public:
+        /// <summary> Create a new view into the source vector </summary>
+        VectorSliceVariable(Variable& src, int offset, size_t size);
+
+        /// <summary> The source vector this is a view into </summary>
+        Variable& Src() const { return _src; }
+
+        /// <summary> Offset of the first element of the view into the source vector, in elements of the view's type </summary>
+        int Offset() const { return _offset; }
+
+    private:
+        Variable& _src;
+        int _offset;
+    };
 }
 }
 
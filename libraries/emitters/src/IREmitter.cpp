@@ -197,6 +197,11 @@ namespace emitters
         return llvm::ConstantDataArray::get(_llvmContext, value);
     }
 
+    llvm::Constant* IREmitter::Literal(const std::vector<int16_t>& value)
+    {
+        return llvm::ConstantDataArray::get(_llvmContext, reinterpret_cast<const std::vector<uint16_t>&>(value));
+    }
+
     llvm::Constant* IREmitter::Literal(const std::vector<float>& value)
     {
         return llvm::ConstantDataArray::get(_llvmContext, value);
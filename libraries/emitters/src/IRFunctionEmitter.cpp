@@ -11,6 +11,7 @@
 #include "IRAsyncTask.h"
 #include "IRBlockRegion.h"
 #include "IREmitter.h"
+#include "IRHalfPrecision.h"
 #include "IRMetadata.h"
 #include "IRModuleEmitter.h"
 #include "IRThreadPool.h"
@@ -19,7 +20,9 @@
 #include "Logger.h"
 
 // stl
+#include <algorithm>
 #include <iostream>
+#include <type_traits>
 
 // llvm
 #include "llvm/IR/Verifier.h"
@@ -953,6 +956,92 @@ namespace emitters
         }
     }
 
+    //
+    // Parallel loops
+    //
+    int IRFunctionEmitter::GetParallelForTaskCount(int count, const ParallelForOptions& options)
+    {
+        auto& compilerSettings = GetModule().GetCompilerParameters();
+        if (!compilerSettings.parallelize || count <= 1)
+        {
+            return 1;
+        }
+
+        const int64_t desiredTasks = options.numTasks > 0 ? options.numTasks : compilerSettings.maxThreads;
+        const int64_t totalWork = static_cast<int64_t>(count) * std::max(options.iterationSize, 1);
+        const int64_t tasksForWork = totalWork / std::max(options.minimumTaskSize, 1);
+        const auto numTasks = std::min({ desiredTasks, tasksForWork, static_cast<int64_t>(count) });
+        if (numTasks <= 1)
+        {
+            return 1;
+        }
+
+        // Give every task the same number of iterations (except the last), without making any empty tasks
+        const auto taskSize = (count - 1) / numTasks + 1;
+        return static_cast<int>((count - 1) / taskSize + 1);
+    }
+
+    void IRFunctionEmitter::ParallelFor(int count, const ParallelForOptions& options, const std::vector<llvm::Value*>& capturedValues, ParallelForBodyFunction body)
+    {
+        const auto numTasks = GetParallelForTaskCount(count, options);
+        if (numTasks <= 1)
+        {
+            body(*this, Literal<int>(0), Literal<int>(count), capturedValues);
+            return;
+        }
+
+        // Globals and constants can be used from the task function directly, so only the other values become
+        // arguments. (This also keeps global arrays from decaying into pointers to the whole array.)
+        std::vector<llvm::Value*> taskArgValues;
+        for (auto value : capturedValues)
+        {
+            if (!llvm::isa<llvm::Constant>(value))
+            {
+                taskArgValues.push_back(value);
+            }
+        }
+
+        auto& module = GetModule();
+        auto int32Type = module.GetIREmitter().Type(VariableType::Int32);
+        auto argTypes = GetLLVMTypes(taskArgValues);
+        argTypes.insert(argTypes.end(), 2, int32Type); // begin, end
+
+        std::string taskFunctionName;
+        int taskFunctionIndex = 0;
+        do
+        {
+            taskFunctionName = _name + "_parallelFor" + std::to_string(taskFunctionIndex++);
+        } while (module.HasFunction(taskFunctionName));
+
+        auto& taskFunction = module.BeginFunction(taskFunctionName, llvm::Type::getVoidTy(module.GetLLVMContext()), argTypes);
+        {
+            auto arguments = taskFunction.Arguments().begin();
+            std::vector<llvm::Value*> taskCapturedValues;
+            for (auto value : capturedValues)
+            {
+                taskCapturedValues.push_back(llvm::isa<llvm::Constant>(value) ? value : &(*arguments++));
+            }
+            auto beginValue = &(*arguments++);
+            auto endValue = &(*arguments++);
+            body(taskFunction, beginValue, endValue, taskCapturedValues);
+            taskFunction.Return();
+        }
+        auto pTaskFunction = taskFunction.GetFunction();
+        module.EndFunction();
+
+        const auto taskSize = (count - 1) / numTasks + 1;
+        std::vector<std::vector<llvm::Value*>> taskArgs;
+        for (int taskIndex = 0; taskIndex < numTasks; ++taskIndex)
+        {
+            auto args = taskArgValues;
+            args.push_back(Literal<int>(taskIndex * taskSize));
+            args.push_back(Literal<int>(std::min((taskIndex + 1) * taskSize, count)));
+            taskArgs.push_back(args);
+        }
+        auto tasks = StartTasks(pTaskFunction, taskArgs);
+        tasks.WaitAll(*this);
+    }
+
     void IRFunctionEmitter::Optimize()
     {
         IRFunctionOptimizer optimizer(GetLLVMModule());
@@ -1090,8 +1179,20 @@ namespace emitters
     template <typename ValueType>
     void IRFunctionEmitter::CallGEMV(int m, int n, ValueType alpha, llvm::Value* A, int lda, llvm::Value* x, int incx, ValueType beta, llvm::Value* y, int incy)
     {
-        auto useBlas = CanUseBlas();
-        llvm::Function* gemv = GetModule().GetRuntime().GetGEMVFunction<ValueType>(useBlas);
+        llvm::Function* gemv = nullptr;
+        if (IsHalfPrecisionPointer(A))
+        {
+            // There are no half-precision BLAS routines, so this always uses the native one
+            if (!std::is_same<ValueType, float>::value)
+            {
+                throw EmitterException(EmitterError::valueTypeNotSupported, "A half-precision matrix can only be used in a float GEMV");
+            }
+            gemv = GetModule().GetRuntime().GetHalfPrecisionGEMVFunction();
+        }
+        else
+        {
+            gemv = GetModule().GetRuntime().GetGEMVFunction<ValueType>(CanUseBlas());
+        }
         if (gemv == nullptr)
         {
             throw EmitterException(EmitterError::functionNotFound, "Couldn't find GEMV function");
@@ -1123,16 +1224,23 @@ namespace emitters
     template <typename ValueType>
     void IRFunctionEmitter::CallGEMM(bool transposeA, bool transposeB, int m, int n, int k, llvm::Value* A, int lda, llvm::Value* B, int ldb, llvm::Value* C, int ldc)
     {
-        auto useBlas = CanUseBlas();
-        llvm::Function* gemm = GetModule().GetRuntime().GetGEMMFunction<ValueType>(useBlas);
-        if (gemm == nullptr)
+        llvm::Function* gemm = nullptr;
+        if (IsHalfPrecisionPointer(A))
         {
-            throw EmitterException(EmitterError::functionNotFound, "Couldn't find GEMM function");
+            // There are no half-precision BLAS routines, so this always uses the native one
+            if (!std::is_same<ValueType, float>::value)
+            {
+                throw EmitterException(EmitterError::valueTypeNotSupported, "A half-precision matrix can only be used in a float GEMM");
+            }
+            gemm = GetModule().GetRuntime().GetHalfPrecisionGEMMFunction();
         }
-
-        if (!useBlas && (transposeA || transposeB))
+        else
         {
-            throw utilities::LogicException(utilities::LogicExceptionErrors::notImplemented, "Transposed matrix multiply not currently implemented in non-blas codepath");
+            gemm = GetModule().GetRuntime().GetGEMMFunction<ValueType>(CanUseBlas());
+        }
+        if (gemm == nullptr)
+        {
+            throw EmitterException(EmitterError::functionNotFound, "Couldn't find GEMM function");
         }
 
         const auto CblasRowMajor = 101;
@@ -1158,6 +1266,28 @@ namespace emitters
         Call(gemm, args);
     }
 
+    void IRFunctionEmitter::CallInt8GEMM(int m, int n, int k, llvm::Value* A, int lda, llvm::Value* B, int ldb, llvm::Value* C, int ldc)
+    {
+        llvm::Function* gemm = GetModule().GetRuntime().GetInt8GEMMFunction();
+        if (gemm == nullptr)
+        {
+            throw EmitterException(EmitterError::functionNotFound, "Couldn't find int8 GEMM function");
+        }
+
+        emitters::IRValueList args{
+            Literal(m),
+            Literal(n),
+            Literal(k),
+            A,
+            Literal(lda), // lda
+            B,
+            Literal(ldb), // ldb
+            C, // C (output)
+            Literal(ldc) // ldc
+        };
+        Call(gemm, args);
+    }
+
     llvm::Value* IRFunctionEmitter::GetNumOpenBLASThreads()
     {
         auto getNumThreadsFunction = GetModule().GetRuntime().GetOpenBLASGetNumThreadsFunction();
@@ -1358,6 +1488,12 @@ namespace emitters
         InsertMetadata(c_predictFunctionTagName);
     }
 
+    void IRFunctionEmitter::IncludeInPredictBatchInterface(const std::string& namespacePrefix)
+    {
+        _pFunction->setLinkage(llvm::GlobalValue::LinkageTypes::ExternalLinkage);
+        InsertMetadata(c_predictBatchFunctionTagName, namespacePrefix);
+    }
+
     void IRFunctionEmitter::IncludeInSwigInterface()
     {
         _pFunction->setLinkage(llvm::GlobalValue::LinkageTypes::ExternalLinkage);
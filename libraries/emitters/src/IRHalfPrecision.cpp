@@ -0,0 +1,186 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     IRHalfPrecision.cpp (emitters)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "IRHalfPrecision.h"
+#include "EmitterException.h"
+
+// llvm
+#include <llvm/IR/Constants.h>
+#include <llvm/IR/DerivedTypes.h>
+
+// stl
+#include <cmath>
+#include <cstring>
+
+namespace ell
+{
+namespace emitters
+{
+    namespace
+    {
+        // A half-precision value shifted left by this much lines its exponent and mantissa up with a float's
+        const int c_mantissaShift = 23 - 10;
+
+        // Bits of a half-precision value
+        const uint32_t c_halfSignMask = 0x8000;
+        const uint32_t c_halfMagnitudeMask = 0x7fff;
+
+        // Bits of a float
+        const uint32_t c_floatMagnitudeMask = 0x7fffffff;
+        const uint32_t c_floatInfinity = 0x7f800000;
+        const uint32_t c_floatImplicitOne = 0x00800000;
+
+        // The exponent bits of a half-precision value, after shifting
+        const uint32_t c_shiftedExponentMask = 0x7c00 << c_mantissaShift;
+
+        // The difference between the exponent biases (127 - 15), in the position of a float's exponent
+        const uint32_t c_exponentBiasAdjustment = (127 - 15) << 23;
+
+        // The smallest normal half-precision value (2^-14), as a float
+        const uint32_t c_minNormalHalf = (127 - 14) << 23;
+
+        // The smallest float that rounds to half-precision infinity (65520)
+        const uint32_t c_halfOverflow = 0x477ff000;
+
+        float BitsToFloat(uint32_t bits)
+        {
+            float result;
+            std::memcpy(&result, &bits, sizeof(result));
+            return result;
+        }
+
+        uint32_t FloatToBits(float value)
+        {
+            uint32_t result;
+            std::memcpy(&result, &value, sizeof(result));
+            return result;
+        }
+
+        llvm::Value* IntConstant(llvm::Type* type, uint32_t value)
+        {
+            return llvm::ConstantInt::get(type, value);
+        }
+
+        // Returns a type with the same number of elements as `type` (which may be a scalar), and the given element type
+        llvm::Type* GetTypeWithElementType(llvm::Type* type, llvm::Type* elementType)
+        {
+            if (type->isVectorTy())
+            {
+                return llvm::VectorType::get(elementType, llvm::cast<llvm::VectorType>(type)->getNumElements());
+            }
+            return elementType;
+        }
+    }
+
+    int16_t FloatToHalf(float value)
+    {
+        auto bits = FloatToBits(value);
+        const auto sign = (bits >> 16) & c_halfSignMask;
+        bits &= c_floatMagnitudeMask;
+
+        uint32_t result;
+        if (bits > c_floatInfinity) // NaN: keep it a (quiet) NaN
+        {
+            result = 0x7e00;
+        }
+        else if (bits >= c_halfOverflow)
+        {
+            result = c_shiftedExponentMask >> c_mantissaShift; // infinity
+        }
+        else if (bits < c_minNormalHalf)
+        {
+            // Subnormal (or zero): in units of the smallest subnormal, 2^-24. Scaling by a power of 2 is exact, and
+            // nearbyint rounds ties to even.
+            result = static_cast<uint32_t>(std::nearbyint(BitsToFloat(bits) * 16777216.0f));
+        }
+        else
+        {
+            // Rebias the exponent and round the mantissa to nearest, ties to even. A carry out of the mantissa
+            // correctly bumps the exponent.
+            result = (bits - c_exponentBiasAdjustment) >> c_mantissaShift;
+            const auto remainder = bits & ((1u << c_mantissaShift) - 1);
+            const auto half = 1u << (c_mantissaShift - 1);
+            if (remainder > half || (remainder == half && (result & 1) != 0))
+            {
+                ++result;
+            }
+        }
+        return static_cast<int16_t>(static_cast<uint16_t>(sign | result));
+    }
+
+    std::vector<int16_t> FloatToHalf(const std::vector<float>& values)
+    {
+        std::vector<int16_t> result;
+        result.reserve(values.size());
+        for (auto value : values)
+        {
+            result.push_back(FloatToHalf(value));
+        }
+        return result;
+    }
+
+    float HalfToFloat(int16_t value)
+    {
+        // The same steps as EmitHalfToFloat
+        const uint32_t halfBits = static_cast<uint16_t>(value);
+        auto bits = (halfBits & c_halfMagnitudeMask) << c_mantissaShift;
+        const auto exponent = bits & c_shiftedExponentMask;
+        bits += c_exponentBiasAdjustment;
+        if (exponent == c_shiftedExponentMask) // infinity or NaN
+        {
+            bits += c_exponentBiasAdjustment;
+        }
+        else if (exponent == 0) // zero or subnormal
+        {
+            bits = FloatToBits(BitsToFloat(bits + c_floatImplicitOne) - BitsToFloat(c_minNormalHalf));
+        }
+        return BitsToFloat(bits | ((halfBits & c_halfSignMask) << 16));
+    }
+
+    bool IsHalfPrecisionPointer(llvm::Value* pointer)
+    {
+        auto type = pointer->getType();
+        return type->isPointerTy() && type->getPointerElementType()->isIntegerTy(16);
+    }
+
+    llvm::Value* EmitHalfToFloat(IRFunctionEmitter& function, llvm::Value* value)
+    {
+        if (!value->getType()->getScalarType()->isIntegerTy(16))
+        {
+            throw EmitterException(EmitterError::valueTypeNotSupported, "Half-precision values must be stored as 16-bit integers");
+        }
+
+        const auto plus = TypedOperator::add;
+        const auto bitwiseAnd = TypedOperator::logicalAnd;
+        const auto shiftLeft = TypedOperator::shiftLeft;
+
+        auto& irBuilder = function.GetEmitter().GetIRBuilder();
+        auto& context = value->getContext();
+        auto intType = GetTypeWithElementType(value->getType(), llvm::Type::getInt32Ty(context));
+        auto floatType = GetTypeWithElementType(value->getType(), llvm::Type::getFloatTy(context));
+
+        // Move the exponent and mantissa into place and rebias the exponent. This is right for normal values.
+        auto halfBits = irBuilder.CreateZExt(value, intType);
+        auto bits = function.Operator(shiftLeft, function.Operator(bitwiseAnd, halfBits, IntConstant(intType, c_halfMagnitudeMask)), IntConstant(intType, c_mantissaShift));
+        auto exponent = function.Operator(bitwiseAnd, bits, IntConstant(intType, c_shiftedExponentMask));
+        bits = function.Operator(plus, bits, IntConstant(intType, c_exponentBiasAdjustment));
+
+        // Infinity and NaN need the float's exponent to be all ones as well
+        auto infinityBits = function.Operator(plus, bits, IntConstant(intType, c_exponentBiasAdjustment));
+        bits = function.Select(function.Comparison(TypedComparison::equals, exponent, IntConstant(intType, c_shiftedExponentMask)), infinityBits, bits);
+
+        // Zero and subnormal values: make a normal float with the mantissa's bits, and subtract its implicit leading one
+        auto withImplicitOne = function.BitCast(function.Operator(plus, bits, IntConstant(intType, c_floatImplicitOne)), floatType);
+        auto subnormal = function.Operator(TypedOperator::subtractFloat, withImplicitOne, llvm::ConstantFP::get(floatType, BitsToFloat(c_minNormalHalf)));
+        bits = function.Select(function.Comparison(TypedComparison::equals, exponent, IntConstant(intType, 0)), function.BitCast(subnormal, intType), bits);
+
+        auto sign = function.Operator(shiftLeft, function.Operator(bitwiseAnd, halfBits, IntConstant(intType, c_halfSignMask)), IntConstant(intType, 16));
+        return function.BitCast(function.Operator(TypedOperator::logicalOr, bits, sign), floatType);
+    }
+}
+}
@@ -95,6 +95,24 @@ namespace
         }
     }
 
+    void WriteWorkspaceHelpers(std::ostream& os, const std::string& prefix)
+    {
+        os << "// Allocates and initializes a workspace for the reentrant predict function. Release it with " << prefix << "_FreeWorkspace.\n";
+        os << "static inline int8_t* " << prefix << "_AllocateWorkspace()\n";
+        os << "{\n";
+        os << "    int8_t* workspace = (int8_t*)malloc((size_t)" << prefix << "_GetWorkspaceSize());\n";
+        os << "    if (workspace != NULL)\n";
+        os << "    {\n";
+        os << "        " << prefix << "_InitializeWorkspace(workspace);\n";
+        os << "    }\n";
+        os << "    return workspace;\n";
+        os << "}\n\n";
+        os << "static inline void " << prefix << "_FreeWorkspace(int8_t* workspace)\n";
+        os << "{\n";
+        os << "    free(workspace);\n";
+        os << "}\n\n";
+    }
+
     void WriteStructDefinition(std::ostream& os, llvm::StructType* t, const std::vector<std::string>& fieldNames)
     {
         if (t->hasName()) // && !t->isLiteral() ?
@@ -210,7 +228,13 @@ namespace
         std::string moduleName = pModule->getName();
         os << "//\n// ELL header for module " << moduleName << "\n//\n\n";
 
-        os << "#include <stdint.h>\n\n";
+        os << "#include <stdint.h>\n";
+        auto workspaceFunctions = GetFunctionsWithTag(moduleEmitter, c_workspaceSizeFunctionTagName);
+        if (!workspaceFunctions.empty())
+        {
+            os << "#include <stdlib.h>\n";
+        }
+        os << "\n";
 
         {
             DeclareExternC externC(os);
@@ -259,6 +283,14 @@ namespace
                 WriteFunctionDeclaration(os, moduleEmitter, *(tv.function));
                 os << "\n\n";
             }
+
+            for (auto& workspaceFunction : workspaceFunctions)
+            {
+                if (!workspaceFunction.values.empty())
+                {
+                    WriteWorkspaceHelpers(os, workspaceFunction.values[0]);
+                }
+            }
         }
     }
 
@@ -0,0 +1,304 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     IRMathFunctions.cpp (emitters)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "IRMathFunctions.h"
+#include "EmitterException.h"
+#include "IRModuleEmitter.h"
+
+// llvm
+#include <llvm/IR/Constants.h>
+#include <llvm/IR/DerivedTypes.h>
+#include <llvm/IR/Intrinsics.h>
+
+// stl
+#include <cmath>
+#include <limits>
+#include <vector>
+
+namespace ell
+{
+namespace emitters
+{
+    namespace
+    {
+        // Constants describing the floating-point format of the argument
+        struct FloatFormat
+        {
+            int mantissaBits;
+            int exponentBias;
+
+            // exp(x) underflows to zero below expMin (the log of the smallest denormal value), and overflows to infinity above expMax
+            double expMin;
+            double expMax;
+
+            // Below this magnitude, tanh is evaluated with its Taylor series instead of via exp, to avoid cancellation
+            double tanhSeriesThreshold;
+        };
+
+        const FloatFormat floatFormat = { 23, 127, -103.9, 88.7228, 0.25 };
+        const FloatFormat doubleFormat = { 52, 1023, -745.1, 709.782, 0.1 };
+
+        // ln(2), split into a high part with trailing zero bits (so n * ln2Hi is exact) and a low-order correction
+        const double ln2Hi = 0.693359375;
+        const double ln2Lo = -2.12194440e-4;
+        const double ln2HiDouble = 6.93145751953125e-1;
+        const double ln2LoDouble = 1.42860682030941723212e-6;
+        const double log2e = 1.4426950408889634;
+        const double sqrt2 = 1.4142135623730951;
+
+        bool IsFloat(llvm::Value* x)
+        {
+            auto scalarType = x->getType()->getScalarType();
+            if (scalarType->isFloatTy())
+            {
+                return true;
+            }
+            if (scalarType->isDoubleTy())
+            {
+                return false;
+            }
+            throw EmitterException(EmitterError::valueTypeNotSupported, "Math functions are only implemented for float and double values");
+        }
+
+        const FloatFormat& GetFloatFormat(llvm::Value* x)
+        {
+            return IsFloat(x) ? floatFormat : doubleFormat;
+        }
+
+        // Returns the integer type with the same size (and number of vector elements) as the given floating-point type
+        llvm::Type* GetIntegerType(llvm::Type* type)
+        {
+            if (type->isVectorTy())
+            {
+                return llvm::VectorType::getInteger(llvm::cast<llvm::VectorType>(type));
+            }
+            return llvm::Type::getIntNTy(type->getContext(), type->getPrimitiveSizeInBits());
+        }
+
+        // Constants of a vector type are splatted to all the elements
+        llvm::Value* FloatConstant(llvm::Type* type, double value)
+        {
+            return llvm::ConstantFP::get(type, value);
+        }
+
+        llvm::Value* IntConstant(llvm::Type* type, int64_t value)
+        {
+            return llvm::ConstantInt::get(type, static_cast<uint64_t>(value), true);
+        }
+
+        // Evaluates the polynomial with the given coefficients (lowest order first) using Horner's rule
+        llvm::Value* EmitPolynomial(IRFunctionEmitter& function, llvm::Value* x, const std::vector<double>& coefficients)
+        {
+            auto type = x->getType();
+            llvm::Value* result = FloatConstant(type, coefficients.back());
+            for (auto it = coefficients.rbegin() + 1; it != coefficients.rend(); ++it)
+            {
+                result = function.Operator(TypedOperator::multiplyFloat, result, x);
+                result = function.Operator(TypedOperator::addFloat, result, FloatConstant(type, *it));
+            }
+            return result;
+        }
+
+        // Taylor coefficients of exp(r), for |r| <= ln(2)/2
+        std::vector<double> GetExpCoefficients(int degree)
+        {
+            std::vector<double> coefficients(degree + 1);
+            double term = 1.0;
+            for (int k = 0; k <= degree; ++k)
+            {
+                coefficients[k] = term;
+                term /= (k + 1);
+            }
+            return coefficients;
+        }
+
+        int GetExpDegree(bool isFloat, MathFunctionAccuracy accuracy)
+        {
+            if (isFloat)
+            {
+                return accuracy == MathFunctionAccuracy::fast ? 5 : 7;
+            }
+            return accuracy == MathFunctionAccuracy::fast ? 7 : 12;
+        }
+
+        // Coefficients of atanh(s) / s = 1 + s^2/3 + s^4/5 + ..., as a polynomial in s^2
+        std::vector<double> GetLogCoefficients(bool isFloat, MathFunctionAccuracy accuracy)
+        {
+            int numTerms = isFloat ? (accuracy == MathFunctionAccuracy::fast ? 3 : 4) : (accuracy == MathFunctionAccuracy::fast ? 5 : 10);
+            std::vector<double> coefficients(numTerms);
+            for (int k = 0; k < numTerms; ++k)
+            {
+                coefficients[k] = 1.0 / (2 * k + 1);
+            }
+            return coefficients;
+        }
+
+        // Taylor coefficients of tanh(x) / x, as a polynomial in x^2
+        std::vector<double> GetTanhCoefficients(bool isFloat, MathFunctionAccuracy accuracy)
+        {
+            const std::vector<double> coefficients = { 1.0, -1.0 / 3.0, 2.0 / 15.0, -17.0 / 315.0, 62.0 / 2835.0, -1382.0 / 155925.0, 21844.0 / 6081075.0 };
+            size_t numTerms = isFloat ? (accuracy == MathFunctionAccuracy::fast ? 4 : 5) : (accuracy == MathFunctionAccuracy::fast ? 5 : 7);
+            return { coefficients.begin(), coefficients.begin() + numTerms };
+        }
+
+        // Returns 2^n for an integer-valued n in the normal exponent range
+        llvm::Value* EmitPowerOfTwo(IRFunctionEmitter& function, llvm::Value* n, llvm::Type* type, const FloatFormat& format)
+        {
+            auto intType = n->getType();
+            auto biased = function.Operator(TypedOperator::add, n, IntConstant(intType, format.exponentBias));
+            auto bits = function.Operator(TypedOperator::shiftLeft, biased, IntConstant(intType, format.mantissaBits));
+            return function.BitCast(bits, type);
+        }
+
+        llvm::Value* EmitMathFunctionCall(IRFunctionEmitter& function, llvm::Intrinsic::ID id, llvm::Value* x)
+        {
+            auto intrinsic = function.GetModule().GetIntrinsic(id, { x->getType() });
+            return function.Call(intrinsic, { x });
+        }
+
+        MathFunctionAccuracy GetAccuracy(IRFunctionEmitter& function)
+        {
+            return function.GetModule().GetCompilerParameters().mathFunctionAccuracy;
+        }
+    }
+
+    llvm::Value* EmitExp(IRFunctionEmitter& function, llvm::Value* x, MathFunctionAccuracy accuracy)
+    {
+        // exp(x) = 2^n * exp(r), where n = round(x / ln(2)) and r = x - n * ln(2) is in [-ln(2)/2, ln(2)/2]
+        const bool isFloat = IsFloat(x);
+        const auto& format = GetFloatFormat(x);
+        auto type = x->getType();
+        auto intType = GetIntegerType(type);
+        auto& irBuilder = function.GetEmitter().GetIRBuilder();
+
+        // Clamp x to the range where the result is finite and nonzero (this also replaces NaN with a finite value,
+        // so the integer conversion below is well-defined)
+        auto minValue = FloatConstant(type, format.expMin);
+        auto maxValue = FloatConstant(type, format.expMax);
+        auto clamped = function.Select(function.Comparison(TypedComparison::greaterThanFloat, x, minValue), x, minValue);
+        clamped = function.Select(function.Comparison(TypedComparison::lessThanFloat, clamped, maxValue), clamped, maxValue);
+
+        auto scaled = function.Operator(TypedOperator::multiplyFloat, clamped, FloatConstant(type, log2e));
+        auto n = EmitMathFunctionCall(function, llvm::Intrinsic::floor, function.Operator(TypedOperator::addFloat, scaled, FloatConstant(type, 0.5)));
+        auto r = function.Operator(TypedOperator::subtractFloat, clamped, function.Operator(TypedOperator::multiplyFloat, n, FloatConstant(type, isFloat ? ln2Hi : ln2HiDouble)));
+        r = function.Operator(TypedOperator::subtractFloat, r, function.Operator(TypedOperator::multiplyFloat, n, FloatConstant(type, isFloat ? ln2Lo : ln2LoDouble)));
+        auto expR = EmitPolynomial(function, r, GetExpCoefficients(GetExpDegree(isFloat, accuracy)));
+
+        // Scale by 2^n in two steps, so that results in the denormal range (where n is below the smallest normal exponent) are correct
+        auto intN = irBuilder.CreateFPToSI(n, intType);
+        auto n1 = function.Operator(TypedOperator::arithmeticShiftRight, intN, IntConstant(intType, 1));
+        auto n2 = function.Operator(TypedOperator::subtract, intN, n1);
+        auto result = function.Operator(TypedOperator::multiplyFloat, expR, EmitPowerOfTwo(function, n1, type, format));
+        result = function.Operator(TypedOperator::multiplyFloat, result, EmitPowerOfTwo(function, n2, type, format));
+
+        // Special cases
+        result = function.Select(function.Comparison(TypedComparison::lessThanFloat, x, minValue), FloatConstant(type, 0.0), result);
+        result = function.Select(function.Comparison(TypedComparison::greaterThanFloat, x, maxValue), FloatConstant(type, std::numeric_limits<double>::infinity()), result);
+        result = function.Select(function.Comparison(TypedComparison::equalsFloat, x, x), result, x); // NaN
+        return result;
+    }
+
+    llvm::Value* EmitExp(IRFunctionEmitter& function, llvm::Value* x)
+    {
+        return EmitExp(function, x, GetAccuracy(function));
+    }
+
+    llvm::Value* EmitLog(IRFunctionEmitter& function, llvm::Value* x, MathFunctionAccuracy accuracy)
+    {
+        // log(x) = e * ln(2) + log(m), where x = 2^e * m and m is in [sqrt(2)/2, sqrt(2)]. Then
+        // log(m) = 2 * atanh(s), where s = (m - 1) / (m + 1) is in [-0.172, 0.172]
+        const bool isFloat = IsFloat(x);
+        const auto& format = GetFloatFormat(x);
+        auto type = x->getType();
+        auto intType = GetIntegerType(type);
+        auto& irBuilder = function.GetEmitter().GetIRBuilder();
+
+        // Scale denormal values up into the normal range, so the exponent bits are meaningful
+        auto isDenormal = function.Comparison(TypedComparison::lessThanFloat, x, FloatConstant(type, isFloat ? std::numeric_limits<float>::min() : std::numeric_limits<double>::min()));
+        auto normalized = function.Select(isDenormal, function.Operator(TypedOperator::multiplyFloat, x, FloatConstant(type, std::ldexp(1.0, format.mantissaBits))), x);
+
+        auto bits = function.BitCast(normalized, intType);
+        auto e = function.Operator(TypedOperator::subtract, function.Operator(TypedOperator::logicalShiftRight, bits, IntConstant(intType, format.mantissaBits)), IntConstant(intType, format.exponentBias));
+        e = function.Select(isDenormal, function.Operator(TypedOperator::subtract, e, IntConstant(intType, format.mantissaBits)), e);
+
+        // Replace the exponent with zero, to get the mantissa in [1, 2)
+        auto mantissaMask = IntConstant(intType, (int64_t(1) << format.mantissaBits) - 1);
+        auto mantissaBits = function.Operator(TypedOperator::logicalOr, function.Operator(TypedOperator::logicalAnd, bits, mantissaMask), IntConstant(intType, int64_t(format.exponentBias) << format.mantissaBits));
+        auto m = function.BitCast(mantissaBits, type);
+        auto isLarge = function.Comparison(TypedComparison::greaterThanFloat, m, FloatConstant(type, sqrt2));
+        m = function.Select(isLarge, function.Operator(TypedOperator::multiplyFloat, m, FloatConstant(type, 0.5)), m);
+        e = function.Select(isLarge, function.Operator(TypedOperator::add, e, IntConstant(intType, 1)), e);
+
+        auto f = function.Operator(TypedOperator::subtractFloat, m, FloatConstant(type, 1.0));
+        auto s = function.Operator(TypedOperator::divideFloat, f, function.Operator(TypedOperator::addFloat, f, FloatConstant(type, 2.0)));
+        auto s2 = function.Operator(TypedOperator::multiplyFloat, s, s);
+        auto atanhS = function.Operator(TypedOperator::multiplyFloat, s, EmitPolynomial(function, s2, GetLogCoefficients(isFloat, accuracy)));
+        auto logM = function.Operator(TypedOperator::multiplyFloat, atanhS, FloatConstant(type, 2.0));
+
+        auto floatE = irBuilder.CreateSIToFP(e, type);
+        auto result = function.Operator(TypedOperator::addFloat, function.Operator(TypedOperator::multiplyFloat, floatE, FloatConstant(type, isFloat ? ln2Lo : ln2LoDouble)), logM);
+        result = function.Operator(TypedOperator::addFloat, function.Operator(TypedOperator::multiplyFloat, floatE, FloatConstant(type, isFloat ? ln2Hi : ln2HiDouble)), result);
+
+        // Special cases
+        auto infinity = FloatConstant(type, std::numeric_limits<double>::infinity());
+        auto zero = FloatConstant(type, 0.0);
+        result = function.Select(function.Comparison(TypedComparison::equalsFloat, x, infinity), infinity, result);
+        result = function.Select(function.Comparison(TypedComparison::equalsFloat, x, zero), FloatConstant(type, -std::numeric_limits<double>::infinity()), result);
+        result = function.Select(function.Comparison(TypedComparison::lessThanFloat, x, zero), FloatConstant(type, std::numeric_limits<double>::quiet_NaN()), result);
+        result = function.Select(function.Comparison(TypedComparison::equalsFloat, x, x), result, x); // NaN
+        return result;
+    }
+
+    llvm::Value* EmitLog(IRFunctionEmitter& function, llvm::Value* x)
+    {
+        return EmitLog(function, x, GetAccuracy(function));
+    }
+
+    llvm::Value* EmitTanh(IRFunctionEmitter& function, llvm::Value* x, MathFunctionAccuracy accuracy)
+    {
+        // For large |x|, tanh(|x|) = (1 - exp(-2|x|)) / (1 + exp(-2|x|)). For small |x| that loses precision to cancellation,
+        // so a Taylor series is used instead. Both are computed, and the appropriate one selected, to keep the code branch-free.
+        const bool isFloat = IsFloat(x);
+        const auto& format = GetFloatFormat(x);
+        auto type = x->getType();
+        auto one = FloatConstant(type, 1.0);
+
+        auto absX = EmitMathFunctionCall(function, llvm::Intrinsic::fabs, x);
+        auto expValue = EmitExp(function, function.Operator(TypedOperator::multiplyFloat, absX, FloatConstant(type, -2.0)), accuracy);
+        auto tanhAbsX = function.Operator(TypedOperator::divideFloat, function.Operator(TypedOperator::subtractFloat, one, expValue), function.Operator(TypedOperator::addFloat, one, expValue));
+        auto negTanhAbsX = function.Operator(TypedOperator::subtractFloat, FloatConstant(type, 0.0), tanhAbsX);
+        auto largeResult = function.Select(function.Comparison(TypedComparison::lessThanFloat, x, FloatConstant(type, 0.0)), negTanhAbsX, tanhAbsX);
+
+        auto x2 = function.Operator(TypedOperator::multiplyFloat, x, x);
+        auto smallResult = function.Operator(TypedOperator::multiplyFloat, x, EmitPolynomial(function, x2, GetTanhCoefficients(isFloat, accuracy)));
+
+        return function.Select(function.Comparison(TypedComparison::lessThanFloat, absX, FloatConstant(type, format.tanhSeriesThreshold)), smallResult, largeResult);
+    }
+
+    llvm::Value* EmitTanh(IRFunctionEmitter& function, llvm::Value* x)
+    {
+        return EmitTanh(function, x, GetAccuracy(function));
+    }
+
+    llvm::Value* EmitSigmoid(IRFunctionEmitter& function, llvm::Value* x, MathFunctionAccuracy accuracy)
+    {
+        // sigmoid(x) = 1 / (1 + exp(-x)). This is well-behaved for all x: exp(-x) overflows to infinity for very negative x,
+        // giving a result of 0, and underflows to 0 for very positive x, giving 1.
+        auto type = x->getType();
+        auto one = FloatConstant(type, 1.0);
+        auto negX = function.Operator(TypedOperator::subtractFloat, FloatConstant(type, 0.0), x);
+        auto expValue = EmitExp(function, negX, accuracy);
+        return function.Operator(TypedOperator::divideFloat, one, function.Operator(TypedOperator::addFloat, one, expValue));
+    }
+
+    llvm::Value* EmitSigmoid(IRFunctionEmitter& function, llvm::Value* x)
+    {
+        return EmitSigmoid(function, x, GetAccuracy(function));
+    }
+}
+}
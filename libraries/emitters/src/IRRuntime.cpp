@@ -8,15 +8,21 @@
 
 #include "IRRuntime.h"
 #include "IRFunctionEmitter.h"
+#include "IRHalfPrecision.h"
 #include "IRMetadata.h"
 #include "IRModuleEmitter.h"
+#include "IRVectorUtilities.h"
 
 // utilities
 #include "Unused.h"
 
 // stl
+#include <algorithm>
+#include <functional>
 #include <iostream>
+#include <string>
 #include <time.h>
+#include <vector>
 
 namespace ell
 {
@@ -27,14 +33,296 @@ namespace emitters
         //
         // Native implementations of matrix operation functions (as opposed to calling out to BLAS)
         //
+
+        // Constants from cblas.h
+        const int c_cblasRowMajor = 101;
+        const int c_cblasNoTrans = 111;
+
+        // The number of rows of A that share each load of x in the native GEMV
+        const int c_gemvRowBlockSize = 4;
+
+        // The width of the vectors used by the native matrix functions
+        int GetRuntimeVectorSize(IRModuleEmitter& module)
+        {
+            const auto& parameters = module.GetCompilerParameters();
+            return parameters.allowVectorInstructions ? std::max(1, parameters.vectorWidth) : 1;
+        }
+
+        // Per-node compiler settings can change the vector size and tiling partway through a module, so each
+        // variant of the native routines gets a name of its own
+        std::string GetNativeGEMVFunctionName(IRModuleEmitter& module, const std::string& baseName)
+        {
+            return baseName + "_v" + std::to_string(GetRuntimeVectorSize(module));
+        }
+
+        std::string GetNativeGEMMFunctionName(IRModuleEmitter& module, const std::string& baseName)
+        {
+            const auto tileSizes = module.GetCompilerParameters().targetDevice.GetGemmTileSizes();
+            return baseName + "_v" + std::to_string(GetRuntimeVectorSize(module)) + "_" + std::to_string(tileSizes.m) + "x" + std::to_string(tileSizes.n) + "x" + std::to_string(tileSizes.k) + "_" + std::to_string(tileSizes.kernelRows) + "x" + std::to_string(tileSizes.kernelColumnVectors);
+        }
+
+        int RoundUp(int value, int multiple)
+        {
+            return ((value + multiple - 1) / multiple) * multiple;
+        }
+
+        llvm::Value* Min(IRFunctionEmitter& function, llvm::Value* a, llvm::Value* b)
+        {
+            return function.Select(function.Comparison(TypedComparison::lessThan, a, b), a, b);
+        }
+
+        llvm::Value* Splat(IRFunctionEmitter& function, llvm::Value* scalar, int vectorSize)
+        {
+            return function.GetEmitter().GetIRBuilder().CreateVectorSplat(vectorSize, scalar);
+        }
+
+        // Loads an element of a matrix, widening it to float if the matrix is stored in half precision
+        llvm::Value* LoadMatrixElement(IRFunctionEmitter& function, llvm::Value* matrix, llvm::Value* index)
+        {
+            auto value = function.ValueAt(matrix, index);
+            return IsHalfPrecisionPointer(matrix) ? EmitHalfToFloat(function, value) : value;
+        }
+
+        // Loads a vector of contiguous elements of a matrix, widening them to float if the matrix is stored in half precision
         template <typename ValueType>
-        llvm::Function* EmitGEMVFunction(IRModuleEmitter& module, const std::string& functionName, const VariableTypeList& argTypes)
+        llvm::Value* LoadMatrixVector(IRFunctionEmitter& function, llvm::Value* matrix, llvm::Value* index, llvm::VectorType* vectorType)
+        {
+            auto pointer = function.PointerOffset(matrix, index);
+            if (IsHalfPrecisionPointer(matrix))
+            {
+                auto halfVectorType = function.GetEmitter().VectorType(VariableType::Short, vectorType->getNumElements());
+                return EmitHalfToFloat(function, LoadVector<int16_t>(function, pointer, halfVectorType));
+            }
+            return LoadVector<ValueType>(function, pointer, vectorType);
+        }
+
+        // X <- beta * X. If beta is zero X is overwritten, so that garbage (e.g., NaN) in uninitialized outputs doesn't leak through.
+        template <typename ValueType>
+        void EmitScaleMatrix(IRFunctionEmitter& function, llvm::Value* beta, llvm::Value* X, llvm::Value* rows, llvm::Value* columns, llvm::Value* rowStride, llvm::Value* columnStride)
+        {
+            const auto plus = emitters::TypedOperator::add;
+            const auto times = emitters::TypedOperator::multiply;
+            const auto timesFloat = emitters::TypedOperator::multiplyFloat;
+
+            auto zero = function.Literal<ValueType>(0);
+            auto isZero = function.Comparison(TypedComparison::equalsFloat, beta, zero);
+            auto ifNotOne = function.If(TypedComparison::notEqualsFloat, beta, function.Literal<ValueType>(1));
+            {
+                auto iLoop = function.ForLoop();
+                iLoop.Begin(rows);
+                {
+                    auto i = iLoop.LoadIterationVariable();
+                    auto jLoop = function.ForLoop();
+                    jLoop.Begin(columns);
+                    {
+                        auto j = jLoop.LoadIterationVariable();
+                        auto index = function.Operator(plus, function.Operator(times, i, rowStride), function.Operator(times, j, columnStride));
+                        auto scaled = function.Operator(timesFloat, beta, function.ValueAt(X, index));
+                        function.SetValueAt(X, index, function.Select(isZero, zero, scaled));
+                    }
+                    jLoop.End();
+                }
+                iLoop.End();
+            }
+            ifNotOne.End();
+        }
+
+        // y <- y + alpha * A x, for a block of `numRows` rows of the (row-major) matrix A.
+        // If `useVectors` is set, x must be contiguous.
+        template <typename ValueType>
+        void EmitGEMVRowBlock(IRFunctionEmitter& function, int numRows, bool useVectors, int vectorSize, llvm::Value* firstRow, llvm::Value* columns, llvm::Value* alpha, llvm::Value* A, llvm::Value* lda, llvm::Value* x, llvm::Value* incx, llvm::Value* y, llvm::Value* incy)
+        {
+            const auto plus = emitters::TypedOperator::add;
+            const auto minus = emitters::TypedOperator::subtract;
+            const auto times = emitters::TypedOperator::multiply;
+            const auto moduloSigned = emitters::TypedOperator::moduloSigned;
+            const auto plusFloat = emitters::TypedOperator::addFloat;
+            const auto timesFloat = emitters::TypedOperator::multiplyFloat;
+
+            std::vector<llvm::Value*> rowOffsets;
+            std::vector<llvm::AllocaInst*> sums;
+            for (int r = 0; r < numRows; ++r)
+            {
+                rowOffsets.push_back(function.Operator(times, function.Operator(plus, firstRow, function.Literal(r)), lda));
+                sums.push_back(function.Variable(emitters::GetVariableType<ValueType>(), "sum"));
+                function.StoreZero(sums.back());
+            }
+
+            llvm::Value* tailStart = function.Literal(0);
+            if (useVectors)
+            {
+                // Each vector of x is loaded once and used for all the rows in the block
+                auto& emitter = function.GetEmitter();
+                auto vectorType = emitter.VectorType(emitters::GetVariableType<ValueType>(), vectorSize);
+                std::vector<llvm::AllocaInst*> vectorSums;
+                for (int r = 0; r < numRows; ++r)
+                {
+                    vectorSums.push_back(function.Variable(vectorType, "vectorSum"));
+                    function.Store(vectorSums.back(), emitters::FillVector<ValueType>(function, vectorType, 0));
+                }
+
+                tailStart = function.Operator(minus, columns, function.Operator(moduloSigned, columns, function.Literal(vectorSize)));
+                auto jLoop = function.ForLoop();
+                jLoop.Begin(function.Literal(0), tailStart, function.Literal(vectorSize));
+                {
+                    auto j = jLoop.LoadIterationVariable();
+                    auto xVector = LoadVector<ValueType>(function, function.PointerOffset(x, j), vectorType);
+                    for (int r = 0; r < numRows; ++r)
+                    {
+                        auto aVector = LoadMatrixVector<ValueType>(function, A, function.Operator(plus, rowOffsets[r], j), vectorType);
+                        function.OperationAndUpdate(vectorSums[r], plusFloat, function.Operator(timesFloat, aVector, xVector));
+                    }
+                }
+                jLoop.End();
+
+                for (int r = 0; r < numRows; ++r)
+                {
+                    function.Store(sums[r], emitters::HorizontalVectorSum<ValueType>(function, function.Load(vectorSums[r])));
+                }
+            }
+
+            // Remaining (or, without vectors, all) columns
+            auto jLoop = function.ForLoop();
+            jLoop.Begin(tailStart, columns, function.Literal(1));
+            {
+                auto j = jLoop.LoadIterationVariable();
+                auto xValue = function.ValueAt(x, function.Operator(times, j, incx));
+                for (int r = 0; r < numRows; ++r)
+                {
+                    auto aValue = LoadMatrixElement(function, A, function.Operator(plus, rowOffsets[r], j));
+                    function.OperationAndUpdate(sums[r], plusFloat, function.Operator(timesFloat, aValue, xValue));
+                }
+            }
+            jLoop.End();
+
+            for (int r = 0; r < numRows; ++r)
+            {
+                auto yIndex = function.Operator(times, function.Operator(plus, firstRow, function.Literal(r)), incy);
+                auto update = function.Operator(timesFloat, alpha, function.Load(sums[r]));
+                function.SetValueAt(y, yIndex, function.Operator(plusFloat, function.ValueAt(y, yIndex), update));
+            }
+        }
+
+        // y <- y + alpha * A' x, for the contribution of a block of `numRows` rows of the (row-major) matrix A.
+        // If `useVectors` is set, y must be contiguous.
+        template <typename ValueType>
+        void EmitTransposedGEMVRowBlock(IRFunctionEmitter& function, int numRows, bool useVectors, int vectorSize, llvm::Value* firstRow, llvm::Value* columns, llvm::Value* alpha, llvm::Value* A, llvm::Value* lda, llvm::Value* x, llvm::Value* incx, llvm::Value* y, llvm::Value* incy)
         {
             const auto plus = emitters::TypedOperator::add;
+            const auto minus = emitters::TypedOperator::subtract;
             const auto times = emitters::TypedOperator::multiply;
+            const auto moduloSigned = emitters::TypedOperator::moduloSigned;
             const auto plusFloat = emitters::TypedOperator::addFloat;
             const auto timesFloat = emitters::TypedOperator::multiplyFloat;
 
+            std::vector<llvm::Value*> rowOffsets;
+            std::vector<llvm::Value*> scales; // alpha * x[row]
+            for (int r = 0; r < numRows; ++r)
+            {
+                auto row = function.Operator(plus, firstRow, function.Literal(r));
+                rowOffsets.push_back(function.Operator(times, row, lda));
+                scales.push_back(function.Operator(timesFloat, alpha, function.ValueAt(x, function.Operator(times, row, incx))));
+            }
+
+            llvm::Value* tailStart = function.Literal(0);
+            if (useVectors)
+            {
+                // Each vector of y is loaded and stored once for all the rows in the block
+                auto vectorType = function.GetEmitter().VectorType(emitters::GetVariableType<ValueType>(), vectorSize);
+                std::vector<llvm::Value*> scaleVectors;
+                for (int r = 0; r < numRows; ++r)
+                {
+                    scaleVectors.push_back(Splat(function, scales[r], vectorSize));
+                }
+
+                tailStart = function.Operator(minus, columns, function.Operator(moduloSigned, columns, function.Literal(vectorSize)));
+                auto jLoop = function.ForLoop();
+                jLoop.Begin(function.Literal(0), tailStart, function.Literal(vectorSize));
+                {
+                    auto j = jLoop.LoadIterationVariable();
+                    auto yPointer = function.PointerOffset(y, j);
+                    auto yVector = LoadVector<ValueType>(function, yPointer, vectorType);
+                    for (int r = 0; r < numRows; ++r)
+                    {
+                        auto aVector = LoadMatrixVector<ValueType>(function, A, function.Operator(plus, rowOffsets[r], j), vectorType);
+                        yVector = function.Operator(plusFloat, yVector, function.Operator(timesFloat, scaleVectors[r], aVector));
+                    }
+                    StoreVector<ValueType>(function, yPointer, yVector);
+                }
+                jLoop.End();
+            }
+
+            // Remaining (or, without vectors, all) columns
+            auto jLoop = function.ForLoop();
+            jLoop.Begin(tailStart, columns, function.Literal(1));
+            {
+                auto j = jLoop.LoadIterationVariable();
+                auto yIndex = function.Operator(times, j, incy);
+                auto yValue = function.ValueAt(y, yIndex);
+                for (int r = 0; r < numRows; ++r)
+                {
+                    auto aValue = LoadMatrixElement(function, A, function.Operator(plus, rowOffsets[r], j));
+                    yValue = function.Operator(plusFloat, yValue, function.Operator(timesFloat, scales[r], aValue));
+                }
+                function.SetValueAt(y, yIndex, yValue);
+            }
+            jLoop.End();
+        }
+
+        // Calls `emit(operand)` with `columnMajorOperand` if `isColumnMajor` is true, and with `rowMajorOperand` otherwise. If
+        // the operands have different types (e.g., if one is stored in half precision) they can't be selected between, so
+        // the code is emitted once for each.
+        void EmitWithSelectedOperand(IRFunctionEmitter& function, llvm::Value* isColumnMajor, llvm::Value* columnMajorOperand, llvm::Value* rowMajorOperand, std::function<void(llvm::Value*)> emit)
+        {
+            if (columnMajorOperand->getType() == rowMajorOperand->getType())
+            {
+                emit(function.Select(isColumnMajor, columnMajorOperand, rowMajorOperand));
+                return;
+            }
+
+            auto ifColumnMajor = function.If();
+            ifColumnMajor.If(isColumnMajor);
+            {
+                emit(columnMajorOperand);
+            }
+            ifColumnMajor.Else();
+            {
+                emit(rowMajorOperand);
+            }
+            ifColumnMajor.End();
+        }
+
+        // Calls `emitBlock(firstRow, numRows)` for each block of `blockSize` rows, and then for each of the leftover rows
+        void EmitRowBlocks(IRFunctionEmitter& function, llvm::Value* rows, int blockSize, std::function<void(llvm::Value*, int)> emitBlock)
+        {
+            const auto minus = emitters::TypedOperator::subtract;
+            const auto moduloSigned = emitters::TypedOperator::moduloSigned;
+
+            auto fullBlockRows = function.Operator(minus, rows, function.Operator(moduloSigned, rows, function.Literal(blockSize)));
+            auto blockLoop = function.ForLoop();
+            blockLoop.Begin(function.Literal(0), fullBlockRows, function.Literal(blockSize));
+            {
+                emitBlock(blockLoop.LoadIterationVariable(), blockSize);
+            }
+            blockLoop.End();
+
+            auto tailLoop = function.ForLoop();
+            tailLoop.Begin(fullBlockRows, rows, function.Literal(1));
+            {
+                emitBlock(tailLoop.LoadIterationVariable(), 1);
+            }
+            tailLoop.End();
+        }
+
+        // y <- alpha * op(A) x + beta * y
+        //
+        // Rows of A are processed in blocks that share loads of x (or loads and stores of y, if A is transposed), and
+        // contiguous vectors are processed `vectorWidth` elements at a time.
+        template <typename ValueType>
+        llvm::Function* EmitGEMVFunction(IRModuleEmitter& module, const std::string& functionName, const VariableTypeList& argTypes)
+        {
+            const int vectorSize = GetRuntimeVectorSize(module);
+
             auto function = module.BeginFunction(functionName, VariableType::Int32, argTypes);
             auto arguments = function.Arguments().begin();
             auto order = &(*arguments++);
@@ -49,45 +337,88 @@ namespace emitters
             auto beta = &(*arguments++);
             auto y = &(*arguments++);
             auto incy = &(*arguments++);
-            UNUSED(order, transpose, alpha, beta);
 
-            llvm::Value* accum = function.Variable(emitters::GetVariableType<ValueType>(), "accum");
+            // A column-major matrix is the transpose of a row-major one, so everything is done in terms of
+            // a row-major `rows` x `columns` matrix that is either used as-is or transposed
+            auto isColumnMajor = function.Comparison(TypedComparison::notEquals, order, function.Literal(c_cblasRowMajor));
+            auto isTransposed = function.Comparison(TypedComparison::notEquals, transpose, function.Literal(c_cblasNoTrans));
+            auto useTranspose = function.Comparison(TypedComparison::notEquals, isColumnMajor, isTransposed);
+            auto rows = function.Select(isColumnMajor, n, m);
+            auto columns = function.Select(isColumnMajor, m, n);
 
-            auto iLoop = function.ForLoop();
-            iLoop.Begin(m);
+            EmitScaleMatrix<ValueType>(function, beta, y, function.Select(useTranspose, columns, rows), function.Literal(1), incy, function.Literal(0));
+
+            auto emitGEMV = [&](bool transposed, bool useVectors) {
+                EmitRowBlocks(function, rows, c_gemvRowBlockSize, [&](llvm::Value* firstRow, int numRows) {
+                    if (transposed)
+                    {
+                        EmitTransposedGEMVRowBlock<ValueType>(function, numRows, useVectors, vectorSize, firstRow, columns, alpha, A, lda, x, incx, y, incy);
+                    }
+                    else
+                    {
+                        EmitGEMVRowBlock<ValueType>(function, numRows, useVectors, vectorSize, firstRow, columns, alpha, A, lda, x, incx, y, incy);
+                    }
+                });
+            };
+
+            auto ifTransposed = function.If();
+            ifTransposed.If(useTranspose);
             {
-                auto i = iLoop.LoadIterationVariable();
-                function.StoreZero(accum);
-                auto jLoop = function.ForLoop();
-                jLoop.Begin(n);
+                auto ifContiguous = function.If(TypedComparison::equals, incy, function.Literal(1));
                 {
-                    auto j = jLoop.LoadIterationVariable();
-                    auto aIndex = function.Operator(plus, function.Operator(times, i, lda), j);
-                    auto xIndex = function.Operator(times, j, incx);
-                    auto aVal = function.ValueAt(A, aIndex);
-                    auto xVal = function.ValueAt(x, xIndex);
-                    auto aTimesX = function.Operator(timesFloat, aVal, xVal);
-                    function.OperationAndUpdate(accum, plusFloat, aTimesX);
+                    emitGEMV(true, vectorSize > 1);
                 }
-                jLoop.End();
-
-                auto yIndex = function.Operator(times, i, incy);
-                function.SetValueAt(y, yIndex, function.Load(accum));
+                ifContiguous.Else();
+                {
+                    emitGEMV(true, false);
+                }
+                ifContiguous.End();
+            }
+            ifTransposed.Else();
+            {
+                auto ifContiguous = function.If(TypedComparison::equals, incx, function.Literal(1));
+                {
+                    emitGEMV(false, vectorSize > 1);
+                }
+                ifContiguous.Else();
+                {
+                    emitGEMV(false, false);
+                }
+                ifContiguous.End();
             }
-            iLoop.End();
+            ifTransposed.End();
+
             function.Return(function.Literal<int>(0));
             module.EndFunction();
             return function.GetFunction();
         }
 
+        // C <- alpha * op(A) op(B) + beta * C
+        //
+        // Cache-blocked in the style of GotoBLAS: a `k` x `n` block of B and an `m` x `k` block of A (with the tile sizes
+        // taken from the target device) are packed into contiguous, zero-padded panels on the stack, and each `kernelRows` x
+        // (`kernelColumnVectors` * vectorWidth) tile of C is then computed by a register-blocked kernel that holds the tile
+        // in vector accumulators. Transposed and column-major operands are handled by the packing, so the kernel only
+        // ever sees one layout.
         template <typename ValueType>
         llvm::Function* EmitGEMMFunction(IRModuleEmitter& module, const std::string& functionName, const VariableTypeList& argTypes)
         {
             const auto plus = emitters::TypedOperator::add;
+            const auto minus = emitters::TypedOperator::subtract;
             const auto times = emitters::TypedOperator::multiply;
+            const auto divideSigned = emitters::TypedOperator::divideSigned;
             const auto plusFloat = emitters::TypedOperator::addFloat;
             const auto timesFloat = emitters::TypedOperator::multiplyFloat;
 
+            const auto tileSizes = module.GetCompilerParameters().targetDevice.GetGemmTileSizes();
+            const int vectorSize = GetRuntimeVectorSize(module);
+            const int kernelRows = tileSizes.kernelRows;
+            const int kernelVectors = tileSizes.kernelColumnVectors;
+            const int kernelColumns = kernelVectors * vectorSize;
+            const int blockRows = RoundUp(tileSizes.m, kernelRows);
+            const int blockColumns = RoundUp(tileSizes.n, kernelColumns);
+            const int blockDepth = tileSizes.k;
+
             auto function = module.BeginFunction(functionName, VariableType::Int32, argTypes);
             auto arguments = function.Arguments().begin();
             auto order = &(*arguments++);
@@ -104,69 +435,347 @@ namespace emitters
             auto beta = &(*arguments++);
             auto C = &(*arguments++);
             auto ldc = &(*arguments++);
-            UNUSED(order, transposeA, transposeB, alpha, beta);
-
-            // C = A x B, A: mxk, B: kxn, C: mxn
-            // A': kxm, B': nxk
-
-            // Loop orders:
-            // A*B:   i, k, j
-            // A'*B:  k, i, j
-            // A*B':  i, j, k
-            // A'*B': k, j, i (?)
 
-            // Clear output
-            auto count = function.Operator(times, ldc, m);
-            function.MemorySet<ValueType>(C, function.Literal<int>(0), function.Literal<uint8_t>(0), count);
+            auto& emitter = function.GetEmitter();
+            auto valueType = emitter.Type(emitters::GetVariableType<ValueType>());
+            auto vectorType = emitter.VectorType(emitters::GetVariableType<ValueType>(), vectorSize);
+
+            // A column-major C = op(A) op(B) is the row-major C' = op(B)' op(A)', where the transposes come from
+            // reading the column-major operands as row-major ones, so swap the operands and do everything row-major
+            auto isColumnMajor = function.Comparison(TypedComparison::notEquals, order, function.Literal(c_cblasRowMajor));
+            auto rows = function.Select(isColumnMajor, n, m);
+            auto columns = function.Select(isColumnMajor, m, n);
+            auto leftStride = function.Select(isColumnMajor, ldb, lda);
+            auto rightStride = function.Select(isColumnMajor, lda, ldb);
+            auto isLeftTransposed = function.Comparison(TypedComparison::notEquals, function.Select(isColumnMajor, transposeB, transposeA), function.Literal(c_cblasNoTrans));
+            auto isRightTransposed = function.Comparison(TypedComparison::notEquals, function.Select(isColumnMajor, transposeA, transposeB), function.Literal(c_cblasNoTrans));
+
+            // left(i, p) = left[i * leftRowStride + p * leftColumnStride], and likewise for right(p, j)
+            auto one = function.Literal(1);
+            auto leftRowStride = function.Select(isLeftTransposed, one, leftStride);
+            auto leftColumnStride = function.Select(isLeftTransposed, leftStride, one);
+            auto rightRowStride = function.Select(isRightTransposed, one, rightStride);
+            auto rightColumnStride = function.Select(isRightTransposed, rightStride, one);
+
+            EmitScaleMatrix<ValueType>(function, beta, C, rows, columns, ldc, one);
+
+            // Packed panels: the left block is stored as `kernelRows`-row panels with the rows of each column adjacent, and
+            // the right block as `kernelColumns`-column panels with the columns of each row adjacent. The right panels
+            // are allocated as vectors so the kernel's loads of them are aligned.
+            auto packedLeft = function.Variable(emitters::GetVariableType<ValueType>(), blockRows * blockDepth);
+            auto packedRightVectors = function.Variable(vectorType, (blockColumns / vectorSize) * blockDepth);
+            auto packedRight = function.CastPointer(packedRightVectors, valueType->getPointerTo());
+            auto edgeTileVectors = function.Variable(vectorType, kernelRows * kernelVectors);
+            auto edgeTile = function.CastPointer(edgeTileVectors, valueType->getPointerTo());
+            std::vector<llvm::AllocaInst*> accumulators;
+            for (int index = 0; index < kernelRows * kernelVectors; ++index)
+            {
+                accumulators.push_back(function.Variable(vectorType, "accumulator"));
+            }
 
-            // TODO: deal with transposes
+            auto zero = function.Literal<ValueType>(0);
+            auto zeroVector = emitters::FillVector<ValueType>(function, vectorType, 0);
+            auto alphaVector = Splat(function, alpha, vectorSize);
 
-            // Accumulate partial values into output
-            auto iLoop = function.ForLoop();
-            iLoop.Begin(m);
+            auto jcLoop = function.ForLoop();
+            jcLoop.Begin(function.Literal(0), columns, function.Literal(blockColumns));
             {
-                auto iIndex = iLoop.LoadIterationVariable();
+                auto jc = jcLoop.LoadIterationVariable();
+                auto numBlockColumns = Min(function, function.Literal(blockColumns), function.Operator(minus, columns, jc));
+                auto numRightPanels = function.Operator(divideSigned, function.Operator(plus, numBlockColumns, function.Literal(kernelColumns - 1)), function.Literal(kernelColumns));
 
-                auto kLoop = function.ForLoop();
-                kLoop.Begin(k);
+                auto pcLoop = function.ForLoop();
+                pcLoop.Begin(function.Literal(0), k, function.Literal(blockDepth));
                 {
-                    auto kIndex = kLoop.LoadIterationVariable();
-
-                    auto jLoop = function.ForLoop();
-                    jLoop.Begin(n);
+                    auto pc = pcLoop.LoadIterationVariable();
+                    auto depth = Min(function, function.Literal(blockDepth), function.Operator(minus, k, pc));
+
+                    // Pack right(pc:pc+depth, jc:jc+numBlockColumns)
+                    EmitWithSelectedOperand(function, isColumnMajor, A, B, [&](llvm::Value* right) {
+                        auto panelLoop = function.ForLoop();
+                        panelLoop.Begin(numRightPanels);
+                        {
+                            auto panel = panelLoop.LoadIterationVariable();
+                            auto pLoop = function.ForLoop();
+                            pLoop.Begin(depth);
+                            {
+                                auto p = pLoop.LoadIterationVariable();
+                                auto sourceRowOffset = function.Operator(times, function.Operator(plus, pc, p), rightRowStride);
+                                auto destOffset = function.Operator(times, function.Operator(plus, function.Operator(times, panel, function.Literal(blockDepth)), p), function.Literal(kernelColumns));
+                                auto cLoop = function.ForLoop();
+                                cLoop.Begin(kernelColumns);
+                                {
+                                    auto c = cLoop.LoadIterationVariable();
+                                    auto column = function.Operator(plus, function.Operator(times, panel, function.Literal(kernelColumns)), c);
+                                    auto destIndex = function.Operator(plus, destOffset, c);
+                                    auto ifInside = function.If(TypedComparison::lessThan, column, numBlockColumns);
+                                    {
+                                        auto sourceIndex = function.Operator(plus, sourceRowOffset, function.Operator(times, function.Operator(plus, jc, column), rightColumnStride));
+                                        function.SetValueAt(packedRight, destIndex, LoadMatrixElement(function, right, sourceIndex));
+                                    }
+                                    ifInside.Else();
+                                    {
+                                        function.SetValueAt(packedRight, destIndex, zero);
+                                    }
+                                    ifInside.End();
+                                }
+                                cLoop.End();
+                            }
+                            pLoop.End();
+                        }
+                        panelLoop.End();
+                    });
+
+                    auto icLoop = function.ForLoop();
+                    icLoop.Begin(function.Literal(0), rows, function.Literal(blockRows));
                     {
-                        auto jIndex = jLoop.LoadIterationVariable();
-
-                        llvm::Value* aIndex = nullptr;
-                        llvm::Value* bIndex = nullptr;
-                        aIndex = function.Operator(plus, function.Operator(times, iIndex, lda), kIndex);
-                        bIndex = function.Operator(plus, function.Operator(times, kIndex, ldb), jIndex);
-                        // if (transposeA)
-                        //     aIndex = function.Operator(plus, function.Operator(times, kIndex, function.Literal(lda)), iIndex);
-                        // else
-                        //     aIndex = function.Operator(plus, function.Operator(times, iIndex, function.Literal(lda)), kIndex);
-
-                        // if (transposeB)
-                        //     bIndex = function.Operator(plus, function.Operator(times, jIndex, function.Literal(ldb)), kIndex);
-                        // else
-                        //     bIndex = function.Operator(plus, function.Operator(times, kIndex, function.Literal(ldb)), jIndex);
-
-                        auto aValue = function.ValueAt(A, aIndex);
-                        auto bValue = function.ValueAt(B, bIndex);
-                        auto value = function.Operator(timesFloat, aValue, bValue);
-                        // store output in C[m,n]
-                        auto cIndex = function.Operator(plus, function.Operator(times, iIndex, ldc), jIndex);
-                        auto oldVal = function.ValueAt(C, cIndex);
-                        auto sum = function.Operator(plusFloat, oldVal, value);
-                        function.SetValueAt(C, cIndex, sum);
+                        auto ic = icLoop.LoadIterationVariable();
+                        auto numBlockRows = Min(function, function.Literal(blockRows), function.Operator(minus, rows, ic));
+                        auto numLeftPanels = function.Operator(divideSigned, function.Operator(plus, numBlockRows, function.Literal(kernelRows - 1)), function.Literal(kernelRows));
+
+                        // Pack left(ic:ic+numBlockRows, pc:pc+depth)
+                        EmitWithSelectedOperand(function, isColumnMajor, B, A, [&](llvm::Value* left) {
+                            auto panelLoop = function.ForLoop();
+                            panelLoop.Begin(numLeftPanels);
+                            {
+                                auto panel = panelLoop.LoadIterationVariable();
+                                auto pLoop = function.ForLoop();
+                                pLoop.Begin(depth);
+                                {
+                                    auto p = pLoop.LoadIterationVariable();
+                                    auto sourceColumnOffset = function.Operator(times, function.Operator(plus, pc, p), leftColumnStride);
+                                    auto destOffset = function.Operator(times, function.Operator(plus, function.Operator(times, panel, function.Literal(blockDepth)), p), function.Literal(kernelRows));
+                                    auto rLoop = function.ForLoop();
+                                    rLoop.Begin(kernelRows);
+                                    {
+                                        auto r = rLoop.LoadIterationVariable();
+                                        auto row = function.Operator(plus, function.Operator(times, panel, function.Literal(kernelRows)), r);
+                                        auto destIndex = function.Operator(plus, destOffset, r);
+                                        auto ifInside = function.If(TypedComparison::lessThan, row, numBlockRows);
+                                        {
+                                            auto sourceIndex = function.Operator(plus, function.Operator(times, function.Operator(plus, ic, row), leftRowStride), sourceColumnOffset);
+                                            function.SetValueAt(packedLeft, destIndex, LoadMatrixElement(function, left, sourceIndex));
+                                        }
+                                        ifInside.Else();
+                                        {
+                                            function.SetValueAt(packedLeft, destIndex, zero);
+                                        }
+                                        ifInside.End();
+                                    }
+                                    rLoop.End();
+                                }
+                                pLoop.End();
+                            }
+                            panelLoop.End();
+                        });
+
+                        // Multiply the packed blocks, one kernel-sized tile of C at a time
+                        auto rightPanelLoop = function.ForLoop();
+                        rightPanelLoop.Begin(numRightPanels);
+                        {
+                            auto rightPanel = rightPanelLoop.LoadIterationVariable();
+                            auto rightPanelOffset = function.Operator(times, rightPanel, function.Literal(blockDepth * kernelVectors));
+                            auto firstColumn = function.Operator(plus, jc, function.Operator(times, rightPanel, function.Literal(kernelColumns)));
+                            auto numTileColumns = function.Operator(minus, numBlockColumns, function.Operator(times, rightPanel, function.Literal(kernelColumns)));
+
+                            auto leftPanelLoop = function.ForLoop();
+                            leftPanelLoop.Begin(numLeftPanels);
+                            {
+                                auto leftPanel = leftPanelLoop.LoadIterationVariable();
+                                auto leftPanelOffset = function.Operator(times, leftPanel, function.Literal(blockDepth * kernelRows));
+                                auto firstRow = function.Operator(plus, ic, function.Operator(times, leftPanel, function.Literal(kernelRows)));
+                                auto numTileRows = function.Operator(minus, numBlockRows, function.Operator(times, leftPanel, function.Literal(kernelRows)));
+
+                                for (auto accumulator : accumulators)
+                                {
+                                    function.Store(accumulator, zeroVector);
+                                }
+
+                                auto pLoop = function.ForLoop();
+                                pLoop.Begin(depth);
+                                {
+                                    auto p = pLoop.LoadIterationVariable();
+                                    auto rightOffset = function.Operator(plus, rightPanelOffset, function.Operator(times, p, function.Literal(kernelVectors)));
+                                    auto leftOffset = function.Operator(plus, leftPanelOffset, function.Operator(times, p, function.Literal(kernelRows)));
+                                    std::vector<llvm::Value*> rightVectors;
+                                    for (int v = 0; v < kernelVectors; ++v)
+                                    {
+                                        rightVectors.push_back(function.ValueAt(packedRightVectors, function.Operator(plus, rightOffset, function.Literal(v))));
+                                    }
+                                    for (int r = 0; r < kernelRows; ++r)
+                                    {
+                                        auto leftVector = Splat(function, function.ValueAt(packedLeft, function.Operator(plus, leftOffset, function.Literal(r))), vectorSize);
+                                        for (int v = 0; v < kernelVectors; ++v)
+                                        {
+                                            function.OperationAndUpdate(accumulators[r * kernelVectors + v], plusFloat, function.Operator(timesFloat, leftVector, rightVectors[v]));
+                                        }
+                                    }
+                                }
+                                pLoop.End();
+
+                                // Add the tile into C, with vector loads and stores unless it hangs off the edge of C
+                                auto isFullTile = function.LogicalAnd(function.Comparison(TypedComparison::greaterThanOrEquals, numTileRows, function.Literal(kernelRows)),
+                                                                      function.Comparison(TypedComparison::greaterThanOrEquals, numTileColumns, function.Literal(kernelColumns)));
+                                auto ifFullTile = function.If();
+                                ifFullTile.If(isFullTile);
+                                {
+                                    for (int r = 0; r < kernelRows; ++r)
+                                    {
+                                        auto rowOffset = function.Operator(plus, function.Operator(times, function.Operator(plus, firstRow, function.Literal(r)), ldc), firstColumn);
+                                        for (int v = 0; v < kernelVectors; ++v)
+                                        {
+                                            auto cPointer = function.PointerOffset(C, function.Operator(plus, rowOffset, function.Literal(v * vectorSize)));
+                                            auto update = function.Operator(timesFloat, alphaVector, function.Load(accumulators[r * kernelVectors + v]));
+                                            StoreVector<ValueType>(function, cPointer, function.Operator(plusFloat, LoadVector<ValueType>(function, cPointer, vectorType), update));
+                                        }
+                                    }
+                                }
+                                ifFullTile.Else();
+                                {
+                                    for (int index = 0; index < kernelRows * kernelVectors; ++index)
+                                    {
+                                        function.SetValueAt(edgeTileVectors, function.Literal(index), function.Load(accumulators[index]));
+                                    }
+
+                                    auto rLoop = function.ForLoop();
+                                    rLoop.Begin(Min(function, numTileRows, function.Literal(kernelRows)));
+                                    {
+                                        auto r = rLoop.LoadIterationVariable();
+                                        auto rowOffset = function.Operator(plus, function.Operator(times, function.Operator(plus, firstRow, r), ldc), firstColumn);
+                                        auto cLoop = function.ForLoop();
+                                        cLoop.Begin(Min(function, numTileColumns, function.Literal(kernelColumns)));
+                                        {
+                                            auto c = cLoop.LoadIterationVariable();
+                                            auto cIndex = function.Operator(plus, rowOffset, c);
+                                            auto tileValue = function.ValueAt(edgeTile, function.Operator(plus, function.Operator(times, r, function.Literal(kernelColumns)), c));
+                                            auto update = function.Operator(timesFloat, alpha, tileValue);
+                                            function.SetValueAt(C, cIndex, function.Operator(plusFloat, function.ValueAt(C, cIndex), update));
+                                        }
+                                        cLoop.End();
+                                    }
+                                    rLoop.End();
+                                }
+                                ifFullTile.End();
+                            }
+                            leftPanelLoop.End();
+                        }
+                        rightPanelLoop.End();
                     }
-                    jLoop.End();
+                    icLoop.End();
                 }
-                kLoop.End();
+                pcLoop.End();
             }
-            iLoop.End();
+            jcLoop.End();
+
             function.Return(function.Literal<int>(0));
+            module.EndFunction();
+            return function.GetFunction();
+        }
+
+        // C <- A B', for 8-bit integer matrices A (m x k) and B (n x k), with 32-bit integer accumulation
+        //
+        // Both operands are read along their rows, so each entry of C is the dot product of two contiguous runs of bytes.
+        // The bytes are sign-extended to 32-bit lanes (as wide as the float lanes the other native routines use), and the
+        // rows of A are processed in blocks that share each load of B.
+        llvm::Function* EmitInt8GEMMFunction(IRModuleEmitter& module, const std::string& functionName, const VariableTypeList& argTypes)
+        {
+            const auto plus = emitters::TypedOperator::add;
+            const auto minus = emitters::TypedOperator::subtract;
+            const auto times = emitters::TypedOperator::multiply;
+            const auto moduloSigned = emitters::TypedOperator::moduloSigned;
+
+            const int vectorSize = GetRuntimeVectorSize(module);
+
+            auto function = module.BeginFunction(functionName, VariableType::Int32, argTypes);
+            auto arguments = function.Arguments().begin();
+            auto m = &(*arguments++);
+            auto n = &(*arguments++);
+            auto k = &(*arguments++);
+            auto A = &(*arguments++);
+            auto lda = &(*arguments++);
+            auto B = &(*arguments++);
+            auto ldb = &(*arguments++);
+            auto C = &(*arguments++);
+            auto ldc = &(*arguments++);
+
+            auto& emitter = function.GetEmitter();
+            auto& irBuilder = emitter.GetIRBuilder();
+            auto intType = emitter.Type(VariableType::Int32);
+            auto byteVectorType = emitter.VectorType(VariableType::Byte, vectorSize);
+            auto intVectorType = emitter.VectorType(VariableType::Int32, vectorSize);
+            auto tailStart = vectorSize > 1 ? function.Operator(minus, k, function.Operator(moduloSigned, k, function.Literal(vectorSize))) : function.Literal(0);
+
+            EmitRowBlocks(function, m, c_gemvRowBlockSize, [&](llvm::Value* firstRow, int numRows) {
+                std::vector<llvm::Value*> rowOffsets;
+                std::vector<llvm::AllocaInst*> sums;
+                std::vector<llvm::AllocaInst*> vectorSums;
+                for (int r = 0; r < numRows; ++r)
+                {
+                    rowOffsets.push_back(function.Operator(times, function.Operator(plus, firstRow, function.Literal(r)), lda));
+                    sums.push_back(function.Variable(VariableType::Int32, "sum"));
+                    vectorSums.push_back(function.Variable(intVectorType, "vectorSum"));
+                }
+
+                auto jLoop = function.ForLoop();
+                jLoop.Begin(n);
+                {
+                    auto j = jLoop.LoadIterationVariable();
+                    auto bOffset = function.Operator(times, j, ldb);
+                    for (int r = 0; r < numRows; ++r)
+                    {
+                        function.StoreZero(sums[r]);
+                    }
+
+                    if (vectorSize > 1)
+                    {
+                        for (int r = 0; r < numRows; ++r)
+                        {
+                            function.Store(vectorSums[r], emitters::FillVector<int>(function, intVectorType, 0));
+                        }
+
+                        auto pLoop = function.ForLoop();
+                        pLoop.Begin(function.Literal(0), tailStart, function.Literal(vectorSize));
+                        {
+                            auto p = pLoop.LoadIterationVariable();
+                            auto bVector = irBuilder.CreateSExt(LoadVector<uint8_t>(function, function.PointerOffset(B, function.Operator(plus, bOffset, p)), byteVectorType), intVectorType);
+                            for (int r = 0; r < numRows; ++r)
+                            {
+                                auto aVector = irBuilder.CreateSExt(LoadVector<uint8_t>(function, function.PointerOffset(A, function.Operator(plus, rowOffsets[r], p)), byteVectorType), intVectorType);
+                                function.OperationAndUpdate(vectorSums[r], plus, function.Operator(times, aVector, bVector));
+                            }
+                        }
+                        pLoop.End();
+
+                        for (int r = 0; r < numRows; ++r)
+                        {
+                            function.Store(sums[r], emitters::HorizontalVectorSum<int>(function, function.Load(vectorSums[r])));
+                        }
+                    }
+
+                    // Remaining (or, without vectors, all) columns
+                    auto pLoop = function.ForLoop();
+                    pLoop.Begin(tailStart, k, function.Literal(1));
+                    {
+                        auto p = pLoop.LoadIterationVariable();
+                        auto bValue = irBuilder.CreateSExt(function.ValueAt(B, function.Operator(plus, bOffset, p)), intType);
+                        for (int r = 0; r < numRows; ++r)
+                        {
+                            auto aValue = irBuilder.CreateSExt(function.ValueAt(A, function.Operator(plus, rowOffsets[r], p)), intType);
+                            function.OperationAndUpdate(sums[r], plus, function.Operator(times, aValue, bValue));
+                        }
+                    }
+                    pLoop.End();
+
+                    for (int r = 0; r < numRows; ++r)
+                    {
+                        auto cIndex = function.Operator(plus, function.Operator(times, function.Operator(plus, firstRow, function.Literal(r)), ldc), j);
+                        function.SetValueAt(C, cIndex, function.Load(sums[r]));
+                    }
+                }
+                jLoop.End();
+            });
 
+            function.Return(function.Literal<int>(0));
             module.EndFunction();
             return function.GetFunction();
         }
@@ -523,12 +1132,13 @@ namespace emitters
         }
         else
         {
-            auto pFunction = pModule->getFunction("noblas_sgemv");
+            auto functionName = GetNativeGEMVFunctionName(_module, "noblas_sgemv");
+            auto pFunction = pModule->getFunction(functionName);
             if (pFunction != nullptr)
             {
                 return pFunction;
             }
-            return EmitGEMVFunction<float>(_module, "noblas_sgemv", argTypes);
+            return EmitGEMVFunction<float>(_module, functionName, argTypes);
         }
     }
 
@@ -558,12 +1168,13 @@ namespace emitters
         }
         else
         {
-            auto pFunction = pModule->getFunction("noblas_dgemv");
+            auto functionName = GetNativeGEMVFunctionName(_module, "noblas_dgemv");
+            auto pFunction = pModule->getFunction(functionName);
             if (pFunction != nullptr)
             {
                 return pFunction;
             }
-            return EmitGEMVFunction<double>(_module, "noblas_dgemv", argTypes);
+            return EmitGEMVFunction<double>(_module, functionName, argTypes);
         }
     }
 
@@ -595,12 +1206,13 @@ namespace emitters
         }
         else
         {
-            auto pFunction = pModule->getFunction("noblas_sgemm");
+            auto functionName = GetNativeGEMMFunctionName(_module, "noblas_sgemm");
+            auto pFunction = pModule->getFunction(functionName);
             if (pFunction != nullptr)
             {
                 return pFunction;
             }
-            return EmitGEMMFunction<float>(_module, "noblas_sgemm", argTypes);
+            return EmitGEMMFunction<float>(_module, functionName, argTypes);
         }
     }
 
@@ -632,12 +1244,13 @@ namespace emitters
         }
         else
         {
-            auto pFunction = pModule->getFunction("noblas_dgemm");
+            auto functionName = GetNativeGEMMFunctionName(_module, "noblas_dgemm");
+            auto pFunction = pModule->getFunction(functionName);
             if (pFunction != nullptr)
             {
                 return pFunction;
             }
-            return EmitGEMMFunction<double>(_module, "noblas_dgemm", argTypes);
+            return EmitGEMMFunction<double>(_module, functionName, argTypes);
         }
     }
 
@@ -665,6 +1278,83 @@ namespace emitters
         return GetDGEMMFunction(useBlas);
     }
 
+    llvm::Function* IRRuntime::GetInt8GEMMFunction()
+    {
+        VariableTypeList argTypes = {
+            VariableType::Int32, // m
+            VariableType::Int32, // n
+            VariableType::Int32, // k
+            VariableType::BytePointer, // A
+            VariableType::Int32, // lda
+            VariableType::BytePointer, // B
+            VariableType::Int32, // ldb
+            VariableType::Int32Pointer, // C
+            VariableType::Int32 // ldc
+        };
+
+        auto functionName = GetNativeGEMVFunctionName(_module, "noblas_i8gemm_nt");
+        auto pFunction = _module.GetLLVMModule()->getFunction(functionName);
+        if (pFunction != nullptr)
+        {
+            return pFunction;
+        }
+        return EmitInt8GEMMFunction(_module, functionName, argTypes);
+    }
+
+    llvm::Function* IRRuntime::GetHalfPrecisionGEMVFunction()
+    {
+        VariableTypeList argTypes = {
+            VariableType::Int32, // order
+            VariableType::Int32, // transpose
+            VariableType::Int32, // m
+            VariableType::Int32, // n
+            VariableType::Float, // alpha
+            VariableType::ShortPointer, // A (half precision)
+            VariableType::Int32, // lda
+            VariableType::FloatPointer, // x
+            VariableType::Int32, // incx
+            VariableType::Float, // beta
+            VariableType::FloatPointer, // y
+            VariableType::Int32 // incy
+        };
+
+        auto functionName = GetNativeGEMVFunctionName(_module, "noblas_hsgemv");
+        auto pFunction = _module.GetLLVMModule()->getFunction(functionName);
+        if (pFunction != nullptr)
+        {
+            return pFunction;
+        }
+        return EmitGEMVFunction<float>(_module, functionName, argTypes);
+    }
+
+    llvm::Function* IRRuntime::GetHalfPrecisionGEMMFunction()
+    {
+        VariableTypeList argTypes = {
+            VariableType::Int32, // order
+            VariableType::Int32, // transposeA
+            VariableType::Int32, // transposeB
+            VariableType::Int32, // m
+            VariableType::Int32, // n
+            VariableType::Int32, // k
+            VariableType::Float, // alpha
+            VariableType::ShortPointer, // A (half precision)
+            VariableType::Int32, // lda
+            VariableType::FloatPointer, // B
+            VariableType::Int32, // ldb
+            VariableType::Float, // beta
+            VariableType::FloatPointer, // C
+            VariableType::Int32 // ldc
+        };
+
+        auto functionName = GetNativeGEMMFunctionName(_module, "noblas_hsgemm");
+        auto pFunction = _module.GetLLVMModule()->getFunction(functionName);
+        if (pFunction != nullptr)
+        {
+            return pFunction;
+        }
+        return EmitGEMMFunction<float>(_module, functionName, argTypes);
+    }
+
     llvm::Function* IRRuntime::GetOpenBLASGetNumThreadsFunction()
     {
         // int openblas_get_num_threads();
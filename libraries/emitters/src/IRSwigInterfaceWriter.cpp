@@ -160,6 +160,80 @@ namespace emitters
             llvm::Function* _function;
         };
 
+        // Writes SWIG interfaces for the batched predict function
+        class PredictBatchInterfaceWriter
+        {
+        public:
+            PredictBatchInterfaceWriter(IRModuleEmitter& moduleEmitter, const FunctionTagValues& predictBatchFunction)
+                : _function(predictBatchFunction.function)
+            {
+                _moduleName = predictBatchFunction.values.empty() ? std::string(moduleEmitter.GetLLVMModule()->getName()) : predictBatchFunction.values[0];
+                InitPredictBatchFunctionInfo();
+            }
+
+            // Only the (count, inputs, outputs) form is wrapped: a reentrant batch function also needs a workspace
+            bool IsWrappable() const { return _function->arg_size() == 3; }
+
+            void WriteHeaderCode(std::ostream& os) const
+            {
+                // (Note: newlines are part of the syntax for #include)
+                std::string predictBatchFunctionCode(
+                    #include "SwigPredictBatchFunction.in"
+                );
+
+                ReplaceDelimiter(predictBatchFunctionCode, "FUNCTION", _functionName);
+                ReplaceDelimiter(predictBatchFunctionCode, "MODULE", _moduleName);
+                ReplaceDelimiter(predictBatchFunctionCode, "INPUT_TYPE", _inputType);
+                ReplaceDelimiter(predictBatchFunctionCode, "OUTPUT_TYPE", _outputType);
+
+                os << predictBatchFunctionCode << "\n";
+            }
+
+            void WriteSwigCode(std::ostream& os) const
+            {
+                DeclareIfDefGuard guard(os, "SWIGPYTHON", DeclareIfDefGuard::Type::Positive);
+
+                std::string predictBatchPythonCode(
+                    #include "SwigRawPredictBatchPython.in"
+                );
+
+                ReplaceDelimiter(predictBatchPythonCode, "PREDICT_BATCH_FUNCTION", _functionName);
+                ReplaceDelimiter(predictBatchPythonCode, "OUTPUT_VECTOR_TYPE", AsVectorType(_outputType));
+
+                os << "%pythoncode %{\n"
+                   << predictBatchPythonCode
+                   << "\n%}\n";
+            }
+
+        private:
+            void InitPredictBatchFunctionInfo()
+            {
+                _functionName = _function->getName();
+
+                // (count, inputs, outputs[, workspace])
+                auto it = _function->args().begin();
+                ++it;
+                {
+                    std::ostringstream os;
+                    WriteLLVMType(os, (*it).getType()->getPointerElementType());
+                    _inputType = os.str();
+                }
+
+                {
+                    std::ostringstream os;
+                    WriteLLVMType(os, (*(++it)).getType()->getPointerElementType());
+                    _outputType = os.str();
+                }
+            }
+
+            std::string _functionName;
+            std::string _moduleName;
+            std::string _inputType;
+            std::string _outputType;
+
+            llvm::Function* _function;
+        };
+
         struct CallbackSignature
         {
             CallbackSignature(llvm::Function& f)
@@ -399,6 +473,15 @@ namespace emitters
             {
                 PredictInterfaceWriter writer(moduleEmitter, *(predicts[0].function));
                 writer.WriteSwigCode(os);
+
+                for (const auto& p : GetFunctionsWithTag(moduleEmitter, c_predictBatchFunctionTagName))
+                {
+                    PredictBatchInterfaceWriter batchWriter(moduleEmitter, p);
+                    if (batchWriter.IsWrappable())
+                    {
+                        batchWriter.WriteSwigCode(os);
+                    }
+                }
             }
 
             os << "%include \"" << headerName << "\"\n";
@@ -438,6 +521,15 @@ namespace emitters
             writer.WriteHeaderCode(os);
         }
 
+        for (const auto& p : GetFunctionsWithTag(moduleEmitter, c_predictBatchFunctionTagName))
+        {
+            PredictBatchInterfaceWriter writer(moduleEmitter, p);
+            if (writer.IsWrappable())
+            {
+                writer.WriteHeaderCode(os);
+            }
+        }
+
         // Callbacks
         if (!callbacks.empty())
         {
@@ -33,5 +33,49 @@ namespace emitters
         llvm::Triple tripleObj(triple.empty() ? llvm::sys::getDefaultTargetTriple() : triple);
         return tripleObj.getOS() == llvm::Triple::MacOSX || tripleObj.getOS() == llvm::Triple::Darwin;
     }
+
+    GemmTileSizes TargetDevice::GetGemmTileSizes() const
+    {
+        llvm::Triple tripleObj(triple.empty() ? llvm::sys::getDefaultTargetTriple() : triple);
+
+        // The packed blocks live on the stack, so they're sized to fit in the L2 cache of the
+        // target (and well within the default stack size of its threads)
+        GemmTileSizes defaults;
+        if (cpu == "cortex-m0")
+        {
+            // No cache and no vector unit
+            defaults = { 16, 16, 32, 2, 1 };
+        }
+        else
+        {
+            switch (tripleObj.getArch())
+            {
+            case llvm::Triple::arm:
+            case llvm::Triple::armeb:
+            case llvm::Triple::thumb:
+            case llvm::Triple::thumbeb:
+                // 16 128-bit NEON registers
+                defaults = { 32, 64, 64, 4, 2 };
+                break;
+            case llvm::Triple::aarch64:
+            case llvm::Triple::aarch64_be:
+                // 32 128-bit vector registers leave room for a taller kernel
+                defaults = { 64, 128, 128, 8, 2 };
+                break;
+            default:
+                // 16 SSE / AVX registers
+                defaults = { 64, 128, 128, 4, 2 };
+                break;
+            }
+        }
+
+        auto result = gemmTileSizes;
+        result.m = result.m > 0 ? result.m : defaults.m;
+        result.n = result.n > 0 ? result.n : defaults.n;
+        result.k = result.k > 0 ? result.k : defaults.k;
+        result.kernelRows = result.kernelRows > 0 ? result.kernelRows : defaults.kernelRows;
+        result.kernelColumnVectors = result.kernelColumnVectors > 0 ? result.kernelColumnVectors : defaults.kernelColumnVectors;
+        return result;
+    }
 }
 }
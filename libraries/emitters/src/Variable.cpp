@@ -132,5 +132,24 @@ namespace emitters
                 throw EmitterException(EmitterError::valueTypeNotSupported);
         }
     }
+
+    Variable* VariableAllocator::AddVectorSliceVariable(VariableType type, Variable& src, int offset, int size)
+    {
+        switch (type)
+        {
+            case VariableType::Double:
+                return AddVariable<VectorSliceVariable<double>>(src, offset, size);
+            case VariableType::Float:
+                return AddVariable<VectorSliceVariable<float>>(src, offset, size);
+            case VariableType::Int32:
+                return AddVariable<VectorSliceVariable<int>>(src, offset, size);
+            case VariableType::Int64:
+                return AddVariable<VectorSliceVariable<int64_t>>(src, offset, size);
+            case VariableType::Byte:
+                return AddVariable<VectorSliceVariable<uint8_t>>(src, offset, size);
+            default:
+                throw EmitterException(EmitterError::valueTypeNotSupported);
+        }
+    }
 }
 }
@@ -106,7 +106,11 @@ namespace emitters
                 break;
 
             case VariableScope::global:
-                if (var.HasInitValue())
+                if (var.IsVectorRef())
+                {
+                    pVal = EmitRef<T>(static_cast<VectorSliceVariable<T>&>(var));
+                }
+                else if (var.HasInitValue())
                 {
                     pVal = EmitGlobalVector<T>(static_cast<InitializedVectorVariable<T>&>(var));
                 }
@@ -117,6 +121,15 @@ namespace emitters
                 _globals.Add(var.EmittedName(), pVal);
                 break;
 
+            case VariableScope::input:
+                // Views into a function argument are recomputed in the function that uses them
+                if (!var.IsVectorRef())
+                {
+                    throw EmitterException(EmitterError::variableScopeNotSupported);
+                }
+                pVal = EmitRef<T>(static_cast<VectorSliceVariable<T>&>(var));
+                break;
+
             default:
                 throw EmitterException(EmitterError::variableScopeNotSupported);
         }
@@ -190,5 +203,22 @@ namespace emitters
         llvm::Value* pSrcVar = EnsureEmitted(var.Src());
         return currentFunction.PtrOffsetA(pSrcVar, currentFunction.Literal(var.Offset()), var.EmittedName());
     }
+
+    template <typename T>
+    llvm::Value* IRModuleEmitter::EmitRef(VectorSliceVariable<T>& var)
+    {
+        llvm::Value* pSrc = EnsureEmitted(var.Src());
+        if (auto pSrcVar = llvm::dyn_cast<llvm::GlobalVariable>(pSrc))
+        {
+            // Use a constant expression rather than an instruction, so the view can be used from any function in the module
+            llvm::Constant* indices[2]{ _emitter.Literal(0), _emitter.Literal(var.Offset()) };
+            return llvm::ConstantExpr::getInBoundsGetElementPtr(pSrcVar->getValueType(), pSrcVar, indices);
+        }
+
+        // The source is a pointer (e.g., a workspace passed in as an untyped argument), and the offset is in units of T
+        auto& currentFunction = GetCurrentFunction();
+        auto pTypedSrc = currentFunction.CastPointer(pSrc, GetPointerType(GetVariableType<T>()));
+        return currentFunction.PointerOffset(pTypedSrc, var.Offset());
+    }
 }
 }
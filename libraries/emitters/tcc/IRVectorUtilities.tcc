@@ -71,5 +71,22 @@ namespace emitters
         auto half2 = emitter.GetIRBuilder().CreateExtractElement(vectorValue, static_cast<uint64_t>(1));
         return function.Operator(emitters::GetAddForValueType<ValueType>(), half1, half2);
     }
+
+    // Port and scratch memory is only aligned to its element type, so vector loads and stores of it must
+    // not assume the (larger) natural alignment of the vector type
+    template <typename ValueType>
+    llvm::Value* LoadVector(IRFunctionEmitter& function, llvm::Value* pointer, llvm::VectorType* vectorType)
+    {
+        auto load = function.GetEmitter().GetIRBuilder().CreateLoad(function.CastPointer(pointer, vectorType->getPointerTo()));
+        load->setAlignment(sizeof(ValueType));
+        return load;
+    }
+
+    template <typename ValueType>
+    void StoreVector(IRFunctionEmitter& function, llvm::Value* pointer, llvm::Value* value)
+    {
+        auto store = function.GetEmitter().GetIRBuilder().CreateStore(value, function.CastPointer(pointer, value->getType()->getPointerTo()));
+        store->setAlignment(sizeof(ValueType));
+    }
 }
 }
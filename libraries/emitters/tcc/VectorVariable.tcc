@@ -50,5 +50,14 @@ namespace emitters
     {
         _data = VariableValueType<T>::ToVariableVector(data);
     }
+
+    //
+    // VectorSliceVariable
+    //
+    template <typename T>
+    VectorSliceVariable<T>::VectorSliceVariable(Variable& src, int offset, size_t size)
+        : VectorVariable<T>(src.Scope(), size, Variable::VariableFlags::isMutable | Variable::VariableFlags::isVectorRef), _src(src), _offset(offset)
+    {
+    }
 }
 }
@@ -7,5 +7,11 @@
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 #pragma once
 
+// emitters
+#include "ModuleEmitter.h"
+
 void TestIRAddFunction();
 void TestIRFunction();
+void TestNativeGEMV(bool vectorize);
+void TestNativeGEMM(bool vectorize);
+void TestMathFunctions(ell::emitters::MathFunctionAccuracy accuracy);
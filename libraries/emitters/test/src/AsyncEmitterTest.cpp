@@ -235,3 +235,58 @@ void TestParallelTasks(bool parallel, bool useThreadPool)
     }
 
 }
+
+//
+// TestParallelFor
+//
+void TestParallelFor(bool parallel)
+{
+    CompilerParameters compilerParameters;
+    compilerParameters.optimize = false;
+    compilerParameters.targetDevice.deviceName = "host";
+    compilerParameters.parallelize = parallel;
+    compilerParameters.useThreadPool = false;
+    compilerParameters.maxThreads = 4;
+    IRModuleEmitter module("ParallelForTest", compilerParameters);
+
+    // Fills an array with a function of the index, then sums it
+    const int arraySize = 1001;
+    ParallelForOptions options;
+    options.minimumTaskSize = 100;
+    const auto numTasks = parallel ? 4 : 1;
+
+    auto& context = module.GetLLVMContext();
+    llvm::Type* int32Type = llvm::Type::getInt32Ty(context);
+    std::string functionName = "TestParallelFor";
+    auto function = module.BeginFunction(functionName, int32Type);
+    {
+        testing::ProcessTest("Testing ParallelFor task count", testing::IsEqual(function.GetParallelForTaskCount(arraySize, options), numTasks));
+        auto data = function.Variable(int32Type, arraySize);
+        auto offset = function.Variable(VariableType::Int32, "offset");
+        function.Store(offset, function.Literal<int>(7));
+        function.ParallelFor(arraySize, options, { data, function.Load(offset) }, [](IRFunctionEmitter& function, llvm::Value* begin, llvm::Value* end, const std::vector<llvm::Value*>& capturedValues) {
+            auto data = capturedValues[0];
+            auto offset = capturedValues[1];
+            function.For(begin, end, [data, offset](IRFunctionEmitter& function, llvm::Value* i) {
+                function.SetValueAt(data, i, function.Operator(emitters::GetAddForValueType<int>(), i, offset));
+            });
+        });
+
+        auto sum = function.Variable(VariableType::Int32, "sum");
+        function.StoreZero(sum);
+        function.For(arraySize, [data, sum](IRFunctionEmitter& function, llvm::Value* i) {
+            function.OperationAndUpdate(sum, emitters::GetAddForValueType<int>(), function.ValueAt(data, i));
+        });
+        function.Return(function.Load(sum));
+    }
+    module.EndFunction();
+
+    IRExecutionEngine executionEngine(std::move(module));
+    auto compiledFunction = (IntFunction)executionEngine.ResolveFunctionAddress(functionName);
+    int expected = 0;
+    for (int index = 0; index < arraySize; ++index)
+    {
+        expected += index + 7;
+    }
+    testing::ProcessTest(std::string("Testing ParallelFor in ") + (parallel ? "parallel" : "serial") + " mode", testing::IsEqual(compiledFunction(), expected));
+}
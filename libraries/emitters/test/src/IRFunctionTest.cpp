@@ -16,17 +16,28 @@
 #include "IREmitter.h"
 #include "IRExecutionEngine.h"
 #include "IRFunctionEmitter.h"
+#include "IRMathFunctions.h"
 #include "IRModuleEmitter.h"
+#include "IRVectorUtilities.h"
 #include "Variable.h"
 
 // testing
 #include "testing.h"
 
+// utilities
+#include "TypeName.h"
+
 // stl
+#include <algorithm>
+#include <cmath>
+#include <functional>
 #include <iostream>
 #include <memory>
 #include <ostream>
+#include <random>
 #include <string>
+#include <type_traits>
+#include <vector>
 
 using namespace ell;
 using namespace ell::emitters;
@@ -54,6 +65,173 @@ public:
 using UnaryScalarDoubleFunction = double (*)(double);
 using BinaryScalarDoubleFunction = double (*)(double, double);
 
+template <typename ValueType>
+using GEMVFunction = int (*)(int, int, int, int, ValueType, const ValueType*, int, const ValueType*, int, ValueType, ValueType*, int);
+
+template <typename ValueType>
+using GEMMFunction = int (*)(int, int, int, int, int, int, ValueType, const ValueType*, int, const ValueType*, int, ValueType, ValueType*, int);
+
+template <typename ValueType>
+using ArrayFunction = void (*)(const ValueType*, ValueType*);
+
+using MathFunctionEmitter = std::function<llvm::Value*(IRFunctionEmitter&, llvm::Value*, MathFunctionAccuracy)>;
+
+const int CblasRowMajor = 101;
+const int CblasColMajor = 102;
+const int CblasNoTrans = 111;
+const int CblasTrans = 112;
+
+template <typename ValueType>
+std::vector<ValueType> GetRandomValues(size_t size, std::default_random_engine& engine)
+{
+    std::uniform_real_distribution<ValueType> distribution(-1, 1);
+    std::vector<ValueType> result(size);
+    for (auto& value : result)
+    {
+        value = distribution(engine);
+    }
+    return result;
+}
+
+CompilerParameters GetNativeBlasCompilerParameters(bool vectorize)
+{
+    CompilerParameters compilerParameters;
+    compilerParameters.allowVectorInstructions = vectorize;
+    compilerParameters.vectorWidth = 4;
+
+    // Small tiles, so that the test matrices span several blocks and have partial tiles on the edges
+    compilerParameters.targetDevice.gemmTileSizes = { 8, 8, 5, 2, 2 };
+    return compilerParameters;
+}
+
+// Reference implementation of cblas gemv
+template <typename ValueType>
+void ReferenceGEMV(int order, int transpose, int m, int n, ValueType alpha, const ValueType* A, int lda, const ValueType* x, int incx, ValueType beta, ValueType* y, int incy)
+{
+    auto isTransposed = (transpose == CblasTrans) != (order == CblasColMajor);
+    auto rows = order == CblasRowMajor ? m : n;
+    auto columns = order == CblasRowMajor ? n : m;
+    auto outputSize = isTransposed ? columns : rows;
+    auto inputSize = isTransposed ? rows : columns;
+    for (int i = 0; i < outputSize; ++i)
+    {
+        double sum = 0;
+        for (int j = 0; j < inputSize; ++j)
+        {
+            auto aValue = isTransposed ? A[j * lda + i] : A[i * lda + j];
+            sum += aValue * x[j * incx];
+        }
+        y[i * incy] = static_cast<ValueType>(alpha * sum + (beta == 0 ? 0 : beta * y[i * incy]));
+    }
+}
+
+// Reference implementation of cblas gemm
+template <typename ValueType>
+void ReferenceGEMM(int order, int transposeA, int transposeB, int m, int n, int k, ValueType alpha, const ValueType* A, int lda, const ValueType* B, int ldb, ValueType beta, ValueType* C, int ldc)
+{
+    auto index = [order](int row, int column, int stride, bool transposed) {
+        return (order == CblasRowMajor) != transposed ? row * stride + column : column * stride + row;
+    };
+
+    for (int i = 0; i < m; ++i)
+    {
+        for (int j = 0; j < n; ++j)
+        {
+            double sum = 0;
+            for (int p = 0; p < k; ++p)
+            {
+                sum += A[index(i, p, lda, transposeA == CblasTrans)] * B[index(p, j, ldb, transposeB == CblasTrans)];
+            }
+            auto& cValue = C[index(i, j, ldc, false)];
+            cValue = static_cast<ValueType>(alpha * sum + (beta == 0 ? 0 : beta * cValue));
+        }
+    }
+}
+
+template <typename ValueType>
+void TestNativeGEMV(bool vectorize)
+{
+    IRModuleEmitter module("NativeGEMV", GetNativeBlasCompilerParameters(vectorize));
+    auto gemv = module.GetRuntime().GetGEMVFunction<ValueType>(false);
+    std::string functionName = gemv->getName();
+
+    IRExecutionEngine executionEngine(std::move(module));
+    auto compiledFunction = reinterpret_cast<GEMVFunction<ValueType>>(executionEngine.ResolveFunctionAddress(functionName));
+
+    std::default_random_engine engine(1234);
+    bool ok = true;
+    const int m = 11;
+    const int n = 13;
+    for (auto order : { CblasRowMajor, CblasColMajor })
+    {
+        for (auto transpose : { CblasNoTrans, CblasTrans })
+        {
+            for (auto increment : { 1, 2 })
+            {
+                for (auto beta : { ValueType{ 0 }, ValueType{ 1 }, ValueType{ 0.5 } })
+                {
+                    const ValueType alpha = 1.5;
+                    const int lda = (order == CblasRowMajor ? n : m) + 3;
+                    auto A = GetRandomValues<ValueType>(lda * std::max(m, n), engine);
+                    auto x = GetRandomValues<ValueType>(std::max(m, n) * increment, engine);
+                    auto expected = GetRandomValues<ValueType>(std::max(m, n) * increment, engine);
+                    auto actual = expected;
+                    ReferenceGEMV(order, transpose, m, n, alpha, A.data(), lda, x.data(), increment, beta, expected.data(), increment);
+                    compiledFunction(order, transpose, m, n, alpha, A.data(), lda, x.data(), increment, beta, actual.data(), increment);
+                    ok = ok && testing::IsEqual(expected, actual, static_cast<ValueType>(1e-5));
+                }
+            }
+        }
+    }
+    testing::ProcessTest(std::string("Testing native ") + (vectorize ? "vectorized " : "") + "GEMV<" + utilities::TypeName<ValueType>::GetName() + ">", ok);
+}
+
+template <typename ValueType>
+void TestNativeGEMM(bool vectorize)
+{
+    IRModuleEmitter module("NativeGEMM", GetNativeBlasCompilerParameters(vectorize));
+    auto gemm = module.GetRuntime().GetGEMMFunction<ValueType>(false);
+    std::string functionName = gemm->getName();
+
+    IRExecutionEngine executionEngine(std::move(module));
+    auto compiledFunction = reinterpret_cast<GEMMFunction<ValueType>>(executionEngine.ResolveFunctionAddress(functionName));
+
+    std::default_random_engine engine(1234);
+    bool ok = true;
+    const std::vector<std::vector<int>> sizes = { { 1, 1, 1 }, { 4, 8, 5 }, { 13, 17, 11 }, { 20, 3, 16 }, { 7, 33, 1 } };
+    for (const auto& size : sizes)
+    {
+        const int m = size[0];
+        const int n = size[1];
+        const int k = size[2];
+        for (auto order : { CblasRowMajor, CblasColMajor })
+        {
+            for (auto transposeA : { CblasNoTrans, CblasTrans })
+            {
+                for (auto transposeB : { CblasNoTrans, CblasTrans })
+                {
+                    for (auto beta : { ValueType{ 0 }, ValueType{ 0.5 } })
+                    {
+                        const ValueType alpha = 1.5;
+                        const int padding = 2;
+                        const int lda = ((order == CblasRowMajor) != (transposeA == CblasTrans) ? k : m) + padding;
+                        const int ldb = ((order == CblasRowMajor) != (transposeB == CblasTrans) ? n : k) + padding;
+                        const int ldc = (order == CblasRowMajor ? n : m) + padding;
+                        auto A = GetRandomValues<ValueType>(lda * std::max(m, k), engine);
+                        auto B = GetRandomValues<ValueType>(ldb * std::max(k, n), engine);
+                        auto expected = GetRandomValues<ValueType>(ldc * std::max(m, n), engine);
+                        auto actual = expected;
+                        ReferenceGEMM(order, transposeA, transposeB, m, n, k, alpha, A.data(), lda, B.data(), ldb, beta, expected.data(), ldc);
+                        compiledFunction(order, transposeA, transposeB, m, n, k, alpha, A.data(), lda, B.data(), ldb, beta, actual.data(), ldc);
+                        ok = ok && testing::IsEqual(expected, actual, static_cast<ValueType>(1e-5));
+                    }
+                }
+            }
+        }
+    }
+    testing::ProcessTest(std::string("Testing native ") + (vectorize ? "vectorized " : "") + "GEMM<" + utilities::TypeName<ValueType>::GetName() + ">", ok);
+}
+
 //
 // Tests
 //
@@ -130,3 +308,113 @@ void TestIRFunction()
     testing::ProcessTest("Testing compilable function", testing::IsEqual(computedResult, compiledResult));
 }
 
+template <typename ValueType>
+bool IsRelativelyEqual(const std::vector<ValueType>& expected, const std::vector<ValueType>& actual, double tolerance)
+{
+    for (size_t index = 0; index < expected.size(); ++index)
+    {
+        if (std::abs(expected[index] - actual[index]) > tolerance * std::max(std::abs(expected[index]), ValueType{ 1 }))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Emits a function that applies a math function to an array, either one element at a time or with explicit vector code
+template <typename ValueType>
+void EmitArrayFunction(IRModuleEmitter& module, const std::string& name, const MathFunctionEmitter& emitFunction, MathFunctionAccuracy accuracy, size_t size, size_t vectorSize)
+{
+    auto valueType = GetVariableType<ValueType>();
+    auto pointerType = GetPointerType(valueType);
+    auto& function = module.BeginFunction(name, VariableType::Void, { pointerType, pointerType });
+    auto arguments = function.Arguments().begin();
+    auto input = &(*arguments++);
+    auto output = &(*arguments++);
+    auto vectorType = function.GetEmitter().VectorType(valueType, vectorSize);
+    auto loop = function.ForLoop();
+    loop.Begin(0, static_cast<int>(size), static_cast<int>(vectorSize));
+    {
+        auto i = loop.LoadIterationVariable();
+        if (vectorSize == 1)
+        {
+            function.SetValueAt(output, i, emitFunction(function, function.ValueAt(input, i), accuracy));
+        }
+        else
+        {
+            auto x = LoadVector<ValueType>(function, function.PointerOffset(input, i), vectorType);
+            StoreVector<ValueType>(function, function.PointerOffset(output, i), emitFunction(function, x, accuracy));
+        }
+    }
+    loop.End();
+    function.Return();
+    module.EndFunction();
+}
+
+template <typename ValueType>
+void TestMathFunction(const std::string& name, const MathFunctionEmitter& emitFunction, const std::function<ValueType(ValueType)>& referenceFunction, ValueType minValue, ValueType maxValue, MathFunctionAccuracy accuracy)
+{
+    const size_t size = 256;
+    std::default_random_engine engine(1234);
+    std::uniform_real_distribution<ValueType> distribution(minValue, maxValue);
+    std::vector<ValueType> input(size);
+    for (auto& value : input)
+    {
+        value = distribution(engine);
+    }
+    input[0] = minValue;
+    input[1] = maxValue;
+
+    std::vector<ValueType> expected(size);
+    std::transform(input.begin(), input.end(), expected.begin(), referenceFunction);
+
+    IRModuleEmitter module("MathFunctions", CompilerParameters{});
+    EmitArrayFunction<ValueType>(module, "ScalarFunction", emitFunction, accuracy, size, 1);
+    EmitArrayFunction<ValueType>(module, "VectorFunction", emitFunction, accuracy, size, 4);
+    IRExecutionEngine executionEngine(std::move(module));
+    auto scalarFunction = reinterpret_cast<ArrayFunction<ValueType>>(executionEngine.ResolveFunctionAddress("ScalarFunction"));
+    auto vectorFunction = reinterpret_cast<ArrayFunction<ValueType>>(executionEngine.ResolveFunctionAddress("VectorFunction"));
+
+    std::vector<ValueType> scalarOutput(size);
+    std::vector<ValueType> vectorOutput(size);
+    scalarFunction(input.data(), scalarOutput.data());
+    vectorFunction(input.data(), vectorOutput.data());
+
+    const bool isFloat = std::is_same<ValueType, float>::value;
+    const double tolerance = accuracy == MathFunctionAccuracy::fast ? (isFloat ? 2e-5 : 1e-7) : (isFloat ? 1e-6 : 1e-14);
+    auto description = std::string(accuracy == MathFunctionAccuracy::fast ? "fast " : "precise ") + name + "<" + utilities::TypeName<ValueType>::GetName() + ">";
+    testing::ProcessTest("Testing inline " + description, IsRelativelyEqual(expected, scalarOutput, tolerance));
+    testing::ProcessTest("Testing inline vector " + description, IsRelativelyEqual(expected, vectorOutput, tolerance));
+}
+
+template <typename ValueType>
+void TestMathFunctions(MathFunctionAccuracy accuracy)
+{
+    auto emitExp = [](IRFunctionEmitter& function, llvm::Value* x, MathFunctionAccuracy functionAccuracy) { return EmitExp(function, x, functionAccuracy); };
+    auto emitLog = [](IRFunctionEmitter& function, llvm::Value* x, MathFunctionAccuracy functionAccuracy) { return EmitLog(function, x, functionAccuracy); };
+    auto emitTanh = [](IRFunctionEmitter& function, llvm::Value* x, MathFunctionAccuracy functionAccuracy) { return EmitTanh(function, x, functionAccuracy); };
+    auto emitSigmoid = [](IRFunctionEmitter& function, llvm::Value* x, MathFunctionAccuracy functionAccuracy) { return EmitSigmoid(function, x, functionAccuracy); };
+
+    TestMathFunction<ValueType>("exp", emitExp, [](ValueType x) { return std::exp(x); }, -80, 80, accuracy);
+    TestMathFunction<ValueType>("log", emitLog, [](ValueType x) { return std::log(x); }, static_cast<ValueType>(1e-30), 1000, accuracy);
+    TestMathFunction<ValueType>("tanh", emitTanh, [](ValueType x) { return std::tanh(x); }, -5, 5, accuracy);
+    TestMathFunction<ValueType>("sigmoid", emitSigmoid, [](ValueType x) { return 1 / (1 + std::exp(-x)); }, -20, 20, accuracy);
+}
+
+void TestMathFunctions(MathFunctionAccuracy accuracy)
+{
+    TestMathFunctions<float>(accuracy);
+    TestMathFunctions<double>(accuracy);
+}
+
+void TestNativeGEMV(bool vectorize)
+{
+    TestNativeGEMV<float>(vectorize);
+    TestNativeGEMV<double>(vectorize);
+}
+
+void TestNativeGEMM(bool vectorize)
+{
+    TestNativeGEMM<float>(vectorize);
+    TestNativeGEMM<double>(vectorize);
+}
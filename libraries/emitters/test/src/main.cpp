@@ -47,6 +47,12 @@ void TestIR()
     // From IRFunctionTest.h
     TestIRAddFunction();
     TestIRFunction();
+    TestNativeGEMV(false);
+    TestNativeGEMV(true);
+    TestNativeGEMM(false);
+    TestNativeGEMM(true);
+    TestMathFunctions(emitters::MathFunctionAccuracy::fast);
+    TestMathFunctions(emitters::MathFunctionAccuracy::precise);
 }
 
 void TestAsyncEmitter()
@@ -57,6 +63,9 @@ void TestAsyncEmitter()
     TestParallelTasks(false, false); // deferred mode (no threads)
     TestParallelTasks(true, false);  // async mode (always spin up a new thread)
     // TestParallelTasks(true, true);   // threadpool mode -- threadpool sometimes crashes or hangs when run in the JIT
+
+    TestParallelFor(false);
+    TestParallelFor(true);
 }
 
 void TestPosixEmitter()
@@ -44,6 +44,46 @@ namespace model
         /// <summary> Indicates if this node is able to compile itself to code. </summary>
         bool IsCompilable(const MapCompiler* compiler) const override { return true; }
 
+        /// <summary>
+        /// Indicates if the memory for an output port may be shared with other ports whose lifetimes don't overlap it.
+        /// The default implementation returns `false`. Nodes should only return `true` if the compiled code writes every
+        /// element of the port on each call and never reads the port's previous contents (e.g., as recurrent state, or to
+        /// rely on padding values set when the memory was initialized).
+        /// </summary>
+        ///
+        /// <param name="port"> One of the node's output ports. </param>
+        /// <returns> `true` if the compiler may assign planned memory to the port. </returns>
+        virtual bool CanReuseOutputMemory(const OutputPortBase& port) const;
+
+        /// <summary>
+        /// Gets the input port whose memory the node can overwrite when computing the given output port. The compiled code
+        /// must produce correct results when the input and output share the same memory. The default implementation returns `nullptr`.
+        /// </summary>
+        ///
+        /// <param name="port"> One of the node's output ports. </param>
+        /// <returns> The input port that may be computed in place, or `nullptr` if the node can't compute the output in place. </returns>
+        virtual const InputPortBase* GetInPlaceInputPort(const OutputPortBase& port) const;
+
+        /// <summary>
+        /// Indicates if the node can be compiled into the batched predict function. The default implementation returns
+        /// `true` if the node was compiled into a function of its own, which the default `CompileBatch` calls once per sample.
+        /// </summary>
+        ///
+        /// <param name="compiler"> The compiler that compiled the predict function. </param>
+        /// <returns> `true` if `CompileBatch` can be called. </returns>
+        virtual bool CanCompileBatch(IRMapCompiler& compiler);
+
+        /// <summary>
+        /// Emits code that computes the node's outputs for a tile of samples. The values of the ports for the samples of the
+        /// tile are stored one after another (see `IRMapCompiler::EnsureBatchPortEmitted`). Nodes override this to compute
+        /// all the samples at once, e.g. with one matrix multiply instead of one per sample.
+        /// </summary>
+        ///
+        /// <param name="compiler"> The compiler that compiled the predict function. </param>
+        /// <param name="function"> The batched predict function. </param>
+        /// <param name="batchSize"> The number of samples in the tile. </param>
+        virtual void CompileBatch(IRMapCompiler& compiler, emitters::IRFunctionEmitter& function, int batchSize);
+
     protected:
         CompilableNode(const std::vector<InputPortBase*>& inputs, const std::vector<OutputPortBase*>& outputs)
             : Node(inputs, outputs) {}
@@ -15,6 +15,9 @@
 #include "IRModuleEmitter.h"
 #include "ModuleEmitter.h"
 
+// data
+#include "DataVector.h"
+
 // model
 #include "Map.h"
 #include "IRModelProfiler.h"
@@ -29,10 +32,18 @@
 #include "TypeName.h"
 
 // stl
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
 #include <functional>
 #include <memory>
+#include <mutex>
 #include <ostream>
 #include <string>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
 #include <vector>
 
 namespace ell
@@ -92,6 +103,50 @@ namespace model
         /// <returns> The name of this type. </returns>
         std::string GetRuntimeTypeName() const override { return GetTypeName(); }
 
+        using Map::Compute;
+
+        /// <summary> Computes the map's output for one sample, without copying the input or output. </summary>
+        ///
+        /// <typeparam name="InputType"> The map's input type (must match the type of the input port). </typeparam>
+        /// <typeparam name="OutputType"> The map's output type (must match the type of the output port). </typeparam>
+        /// <param name="input"> The input, which must hold the map's input size elements. </param>
+        /// <param name="output"> The buffer to write the output to, which must hold the map's output size elements. </param>
+        /// <remarks>
+        /// Each thread that calls `Compute` gets its own workspace (and its own cached output for `Map::Compute`), so if
+        /// the map was compiled with `reentrant`, one map can be shared by several threads. Nodes that keep state from
+        /// one call to the next (such as delays and accumulators) keep it in the workspace, so each thread has its own.
+        /// Otherwise the generated code keeps its intermediate values and node state in globals, and calls must not overlap.
+        /// </remarks>
+        template <typename InputType, typename OutputType>
+        void Compute(const InputType* input, OutputType* output) const;
+
+        /// <summary> Computes the map's output for a batch of samples. </summary>
+        ///
+        /// <typeparam name="InputType"> The map's input type (must match the type of the input port). </typeparam>
+        /// <typeparam name="OutputType"> The map's output type (must match the type of the output port). </typeparam>
+        /// <param name="inputs"> The input samples, stored one after another. The size must be a multiple of the map's input size. </param>
+        ///
+        /// <returns> The output for each sample, stored one after another. </returns>
+        /// <remarks>
+        /// Uses the batched predict function if the map was compiled with `emitPredictBatch`, and otherwise calls
+        /// the predict function once per sample.
+        /// </remarks>
+        template <typename InputType, typename OutputType = InputType>
+        std::vector<OutputType> ComputeBatch(const std::vector<InputType>& inputs) const;
+
+        /// <summary> Computes the map's output for one sparse sample, for maps whose input is (index, value) pairs. </summary>
+        ///
+        /// <typeparam name="InputType"> The map's input type (must match the type of the input port). </typeparam>
+        /// <typeparam name="OutputType"> The map's output type (must match the type of the output port). </typeparam>
+        /// <typeparam name="DataVectorType"> The type of the data vector. </typeparam>
+        /// <param name="input"> The sample. Its nonzero entries become the (index, value) pairs of the map's input, and
+        ///  the rest of the input is padded with pairs whose index is -1. </param>
+        /// <param name="output"> The buffer to write the output to, which must hold the map's output size elements. </param>
+        /// <remarks> This is the input format of `SparseLinearPredictorNode`. Throws if an index of the sample can't be
+        ///  represented exactly by InputType (e.g., indices above 2^24 for float). </remarks>
+        template <typename InputType, typename OutputType, typename DataVectorType>
+        void ComputeSparse(const DataVectorType& input, OutputType* output) const;
+
         /// <summary> Can this compiled map be used? </summary>
         ///
         /// <returns> true if active, false if not. </returns>
@@ -159,7 +214,7 @@ namespace model
         /// <summary> Reset the performance counters for all the node types to zero. </summary>
         void ResetNodeTypeProfilingInfo();
 
-        /// <summary> Force jitting to finish so you can time execution without jit cost. </summary>
+        /// <summary> Force jitting to finish so you can time execution without jit cost. This is safe to call from several threads. </summary>
         void FinishJitting() const;
 
     protected:
@@ -181,28 +236,55 @@ namespace model
     private:
         friend class IRMapCompiler;
     
-        IRCompiledMap(Map map, const std::string& functionName, std::unique_ptr<emitters::IRModuleEmitter> module);
+        IRCompiledMap(Map map, const std::string& functionName, std::unique_ptr<emitters::IRModuleEmitter> module, bool isReentrant = false, size_t workspaceSize = 0, const std::string& predictBatchFunctionName = "");
+
+        // The state each thread keeps for a map: the workspace passed to a reentrant predict function, and the
+        // output computed by the last call to SetNodeInput (which the ComputeXXXOutput functions return).
+        // Only one of the entries in the tuple is active, depending on the output type of the map.
+        struct ThreadState
+        {
+            std::vector<uint8_t> workspace;
+            std::tuple<utilities::ConformingVector<bool>, utilities::ConformingVector<int>, utilities::ConformingVector<int64_t>, utilities::ConformingVector<float>, utilities::ConformingVector<double>> cachedOutput;
+        };
 
         void EnsureExecutionEngine() const;
         void EnsureValidMap(); // fixes up model if necessary and checks inputs/outputs are compilable
-        template <typename InputType, typename OutputType>
-        void SetComputeFunction();
-        void SetComputeFunction() const;
+        ThreadState& GetThreadState() const;
         template <typename InputType>
-        void SetComputeFunctionForInputType() const;
-
-        template <typename InputType>
-        using ComputeFunction = std::function<void(const InputType*)>;
+        void ComputeCachedOutput(const InputType* input) const;
+        template <typename InputType, typename OutputType>
+        void ComputeCachedOutputForTypes(const InputType* input) const;
+        template <typename OutputType>
+        const utilities::ConformingVector<OutputType>& GetCachedOutput() const;
 
         std::string _moduleName = "ELL";
         std::unique_ptr<emitters::IRModuleEmitter> _module;
 
         mutable std::unique_ptr<emitters::IRExecutionEngine> _executionEngine;
 
-        // Only one of the entries in each of these tuples is active, depending on the input and output types of the map
-        mutable bool _computeFunctionDefined;
-        mutable std::tuple<ComputeFunction<bool>, ComputeFunction<int>, ComputeFunction<int64_t>, ComputeFunction<float>, ComputeFunction<double>> _computeInputFunction;
-        mutable std::tuple<utilities::ConformingVector<bool>, utilities::ConformingVector<int>, utilities::ConformingVector<int64_t>, utilities::ConformingVector<float>, utilities::ConformingVector<double>> _cachedOutput;
+        // The addresses of the jitted functions, resolved once by FinishJitting
+        mutable std::mutex _jitMutex;
+        mutable std::atomic<bool> _isJitted;
+        mutable uint64_t _predictFunctionAddress = 0;
+        mutable uint64_t _predictBatchFunctionAddress = 0;
+        mutable uint64_t _initializeWorkspaceFunctionAddress = 0;
+
+        // Set if the predict function was compiled to be reentrant, and takes a workspace
+        bool _isReentrant = false;
+        size_t _workspaceSize = 0;
+
+        // The name of the batched predict function (empty if there isn't one)
+        std::string _predictBatchFunctionName;
+
+        // The states of the threads using a map. The map owns the table, so every state is freed with the map, and each
+        // thread also removes its own state from the tables of the maps still alive when it exits, so a later thread that
+        // gets the same ID starts from a fresh state.
+        struct ThreadStateTable
+        {
+            std::mutex mutex;
+            std::unordered_map<std::thread::id, std::unique_ptr<ThreadState>> states;
+        };
+        std::shared_ptr<ThreadStateTable> _threadStates;
     };
 }
 }
@@ -29,6 +29,7 @@
 
 // stl
 #include <string>
+#include <unordered_map>
 
 namespace ell
 {
@@ -94,6 +95,58 @@ namespace model
         template <typename ValueType>
         llvm::Value* EnsurePortEmitted(const OutputPortBase& port, ValueType initialValue);
 
+        /// <summary>
+        /// Ensure that a zero-initialized buffer that belongs to a node has been declared in IR. Nodes use these buffers
+        /// for scratch memory and for state they keep from one call of the predict function to the next, instead of
+        /// emitting module globals of their own. Each node gets its own buffer for each name. In reentrant mode the
+        /// buffer is part of the workspace, so every caller has its own copy.
+        /// </summary>
+        ///
+        /// <param name="node"> The node the buffer belongs to. </param>
+        /// <param name="name"> The name of the buffer, which distinguishes the buffers of a node. </param>
+        /// <param name="type"> The type of the buffer's elements. </param>
+        /// <param name="size"> The number of elements in the buffer. </param>
+        /// <returns> A pointer to the first element of the buffer. </returns>
+        llvm::Value* EnsureNodeBufferEmitted(const Node& node, const std::string& name, emitters::VariableType type, size_t size);
+
+        /// <summary>
+        /// Ensure that the values of an output port for the tile of samples the batched predict function is computing have
+        /// been declared in IR. The values for each sample come `GetBatchPortStride` elements after the previous sample's.
+        /// </summary>
+        ///
+        /// <param name="port"> The port to ensure is emitted. </param>
+        /// <param name="function"> The batched predict function. </param>
+        /// <returns> A pointer to the port's first element for the first sample of the tile. </returns>
+        llvm::Value* EnsureBatchPortEmitted(const OutputPortBase& port, emitters::IRFunctionEmitter& function);
+
+        /// <summary> Gets the values of an input port for the tile of samples the batched predict function is computing. </summary>
+        ///
+        /// <param name="port"> The port to get, which must have a single range of elements. </param>
+        /// <param name="function"> The batched predict function. </param>
+        /// <returns> A pointer to the port's first element for the first sample of the tile. </returns>
+        llvm::Value* EnsureBatchPortEmitted(const InputPortBase& port, emitters::IRFunctionEmitter& function);
+
+        /// <summary> Gets the number of elements between the values of a port for one sample of a tile and the next. </summary>
+        ///
+        /// <param name="port"> The port, which must already have been emitted in the batched predict function. </param>
+        /// <returns> The stride between samples, which is zero if the port has the same value for every sample. </returns>
+        int GetBatchPortStride(const OutputPortBase& port) const;
+
+        /// <summary> Gets the number of elements between the values of a port for one sample of a tile and the next. </summary>
+        ///
+        /// <param name="port"> The port, which must already have been emitted in the batched predict function. </param>
+        /// <returns> The stride between samples, which is zero if the port has the same value for every sample. </returns>
+        int GetBatchPortStride(const InputPortBase& port) const;
+
+        /// <summary>
+        /// Indicates if an input port has the same value for every sample of a batch, because it's computed by nodes without
+        /// inputs (e.g., constants).
+        /// </summary>
+        ///
+        /// <param name="port"> The port to check. </param>
+        /// <returns> `true` if the port has the same value for every sample. </returns>
+        bool IsBatchInvariant(const InputPortBase& port) const;
+
         /// <summary> Ensure that variable for the given port element has been declared in IR </summary>
         ///
         /// <param name="port"> The port elements to ensure are emitted. </param>
@@ -148,6 +201,12 @@ namespace model
         /// <returns> Reference to the underlying llvm context. </returns>
         llvm::LLVMContext& GetLLVMContext();
 
+        /// <summary> Gets the name of the batched predict function emitted when `emitPredictBatch` is set. </summary>
+        ///
+        /// <param name="predictFunctionName"> The name of the (single-sample) predict function. </param>
+        /// <returns> The name of the batched predict function. </returns>
+        static std::string GetPredictBatchFunctionName(const std::string& predictFunctionName) { return predictFunctionName + "_batch"; }
+
         /// <summary> Gets the namespace string used to prefix emitted map-specific runtime functions. </summary>
         ///
         /// <returns> The namespace prefix for the emitted module. </returns>
@@ -162,6 +221,7 @@ namespace model
         void PopScope() override;
         emitters::ModuleEmitter* GetModuleEmitter() override { return &_moduleEmitter; }
         void EnsureValidMap(Map& map);
+        void RefineMap(Map& map, const TransformContext& context);
         virtual std::string GetPredictFunctionName() const;
         virtual void EmitModelAPIFunctions(const Map& map);
         emitters::Variable* GetPortVariable(const InputPortBase& port);
@@ -185,8 +245,31 @@ namespace model
         void EmitGetOutputShapeFunction(const Map& map);
         void EmitShapeConditionals(emitters::IRFunctionEmitter& fn, std::vector<ell::math::TensorShape> shapes);
 
+        void EmitPredictBatchFunction(const Map& map);
+        bool CanCompileBatch(const Map& map);
+        void EmitPredictBatchTile(const Map& map, emitters::IRFunctionEmitter& function, int batchSize, llvm::Value* pInputs, llvm::Value* pOutputs);
+        template <typename ValueType>
+        void EmitCopyBatchOutput(emitters::IRFunctionEmitter& function, const PortElementsBase& output, llvm::Value* pOutputs);
+
+        void EmitGetWorkspaceSizeFunction();
+        void EmitInitializeWorkspaceFunction();
+        template <typename ValueType>
+        void EmitFillWorkspace(emitters::IRFunctionEmitter& function, llvm::Value* pWorkspace, const WorkspaceInitializer& initializer);
+
         // stack of node regions
         std::vector<NodeMap<emitters::IRBlockRegion*>> _nodeRegions;
+
+        // compiler parameters to restore after compiling a node with its own settings
+        std::vector<emitters::CompilerParameters> _savedCompilerParameters;
+
+        // the values of the ports for the tile of samples the batched predict function is computing
+        struct BatchPort
+        {
+            llvm::Value* pointer;
+            int stride;
+        };
+        std::unordered_map<const OutputPortBase*, BatchPort> _batchPorts;
+        int _batchSize = 0;
     };
 }
 }
@@ -17,12 +17,15 @@
 // model
 #include "CompilableNodeUtilities.h"
 #include "Map.h"
+#include "MemoryPlanner.h"
 #include "Model.h"
 #include "Node.h"
 #include "OutputPort.h"
 #include "PortElements.h"
 
 // stl
+#include <map>
+#include <memory>
 #include <stack>
 #include <string>
 #include <unordered_map>
@@ -31,13 +34,33 @@ namespace ell
 {
 namespace model
 {
+    /// <summary> How forest predictor nodes are compiled. </summary>
+    enum class ForestEvaluation
+    {
+        /// <summary> Refine the forest into a graph of threshold, multiplexer and sum nodes, which evaluates every split. </summary>
+        refine = 0,
+        /// <summary> Walk each tree from its root, through tables of the split features, thresholds and children. </summary>
+        branching,
+        /// <summary>
+        /// Evaluate every split without branching, and find the leaf each tree exits at by masking out the leaves under the
+        /// first child of every split that takes its second child (QuickScorer). Used for forests whose trees have at most
+        /// 64 leaves, when the edge indicator vector isn't used; falls back to `branching` otherwise.
+        /// </summary>
+        quickScorer
+    };
+
     struct MapCompilerParameters
     {
         std::string moduleName = "ELL";
         std::string mapFunctionName = "predict";
         bool inlineNodes = false;
-        bool fuseLinearFunctionNodes = false;
+        bool fuseLinearFunctionNodes = false; // also folds neural network batch normalization, scaling, bias, and activation layers into the preceding convolutional or fully-connected layer
         bool profile = false;
+        bool planMemory = false;
+        bool reentrant = false; // intermediate values and node buffers (scratch and state) live in a workspace passed to the predict function (implies planMemory and inlineNodes, and turns off compilerSettings.parallelize, since tasks go through module globals); maps that profile or have clock or source nodes can't be reentrant
+        bool emitPredictBatch = false; // also emit <mapFunctionName>_batch, which runs the map on several samples
+        int predictBatchSize = 16; // the number of samples <mapFunctionName>_batch computes together, e.g. as the columns of one matrix multiply
+        ForestEvaluation forestEvaluation = ForestEvaluation::refine; // branching and quickScorer are opt-in
         emitters::CompilerParameters compilerSettings;
         std::string sourceFunctionName;
         std::string sinkFunctionName;
@@ -60,6 +83,11 @@ namespace model
         /// <returns> The MapCompilerParameters struct used by the map compiler to control code generation. </returns>
         const MapCompilerParameters& GetMapCompilerParameters() const { return _parameters; }
 
+        /// <summary> Gets the memory plan for the intermediate ports of the compiled map. </summary>
+        ///
+        /// <returns> The memory planner, or `nullptr` if memory planning isn't enabled. </returns>
+        const MemoryPlanner* GetMemoryPlanner() const { return _memoryPlanner.get(); }
+
         //
         // Routines for Node implementers
         //
@@ -114,6 +142,28 @@ namespace model
         /// </summary>
         emitters::NamedVariableTypeList AllocateNodeFunctionArguments(Map& map, emitters::ModuleEmitter& emitter);
 
+        /// <summary> A region of the workspace that must be filled with a (nonzero) value before it's first used. </summary>
+        struct WorkspaceInitializer
+        {
+            emitters::VariableType type;
+            size_t offset; // in elements of `type`, from the beginning of the workspace
+            size_t size;
+            double value;
+        };
+
+        /// <summary> Gets the regions of the workspace that must be initialized to nonzero values (only used in reentrant mode). </summary>
+        const std::vector<WorkspaceInitializer>& GetWorkspaceInitializers() const { return _workspaceInitializers; }
+
+        /// <summary> Gets the size of the workspace, in bytes: the planned ports followed by the node buffers (only used in reentrant mode). </summary>
+        size_t GetWorkspaceSize() const { return _workspaceSize; }
+
+        /// <summary>
+        /// Create a variable for a zero-initialized buffer that belongs to a node. Calling this again with the same node and
+        /// name returns the same variable. In reentrant mode the buffer is a region of the workspace, and otherwise it's a
+        /// module global of its own.
+        /// </summary>
+        emitters::Variable* AllocateNodeBuffer(const Node& node, const std::string& name, emitters::VariableType type, size_t size);
+
         //
         // These methods may be implemented by specific compilers
         //
@@ -137,11 +187,27 @@ namespace model
         void CompileNodes(Model& model);
         emitters::Variable* AllocateNodeFunctionArgument(emitters::ModuleEmitter& emitter, const OutputPortBase* pPort, ArgType argType);
         emitters::Variable* AllocateNodeFunctionArgument(emitters::ModuleEmitter& emitter, const PortElementBase& element, ArgType argType);
+        void PlanMemory(const Map& map);
+        emitters::Variable* AllocatePlannedPortVariable(const OutputPortBase& port);
+        emitters::Variable* AllocateWorkspaceArgument(emitters::ModuleEmitter& module);
+        size_t GetWorkspaceOffset(const OutputPortBase& port) const;
 
         MapCompilerParameters _parameters;
         // map from ports to runtime variables, for all ports in the model
         // stored as a stack, with the top of the stack being the innermost scope
         std::vector<std::unordered_map<const Port*, emitters::Variable*>> _portToVarMaps; // Do we need separate elementToVarMaps?
+
+        // the memory plan for intermediate ports, and the global buffer (one per port type) the planned ports live in
+        std::unique_ptr<MemoryPlanner> _memoryPlanner;
+        std::map<Port::PortType, emitters::Variable*> _plannedBuffers;
+
+        // in reentrant mode, the planned buffers are laid out in the workspace argument instead, followed by the node buffers
+        emitters::Variable* _workspaceVariable = nullptr;
+        std::vector<WorkspaceInitializer> _workspaceInitializers;
+        size_t _workspaceSize = 0;
+
+        // the buffers nodes have asked for, by node and name
+        std::map<std::pair<const Node*, std::string>, emitters::Variable*> _nodeBuffers;
     };
 }
 }
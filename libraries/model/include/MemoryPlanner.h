@@ -0,0 +1,125 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     MemoryPlanner.h (model)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "Map.h"
+#include "Model.h"
+#include "Node.h"
+#include "OutputPort.h"
+#include "Port.h"
+
+// stl
+#include <cstddef>
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+namespace ell
+{
+namespace model
+{
+    /// <summary> The location of an output port's data inside one of the memory planner's buffers. </summary>
+    struct PortMemoryAssignment
+    {
+        /// <summary> The type of the buffer the port lives in (there is one buffer per port type). </summary>
+        Port::PortType type = Port::PortType::none;
+
+        /// <summary> The offset (in elements) of the port's data from the beginning of the buffer. </summary>
+        size_t offset = 0;
+
+        /// <summary> The number of elements reserved for the port. </summary>
+        size_t size = 0;
+    };
+
+    /// <summary>
+    /// Plans the memory for the intermediate output ports of a map. The lifetime of each port is computed over the order
+    /// `Model::Visit` uses to compile the nodes, and ports whose lifetimes don't overlap are packed into a single buffer
+    /// per port type. Nodes that can compute their output in place are given the same memory as the input they overwrite.
+    ///
+    /// Only ports for which `CompilableNode::CanReuseOutputMemory` returns `true` share memory. If `includeUnsharedPorts`
+    /// is set, the other ports get memory of their own in the plan, so that every intermediate value of the map lives in
+    /// the planned buffers. Ports that are bound to the map's inputs or outputs are never planned.
+    /// </summary>
+    class MemoryPlanner
+    {
+    public:
+        /// <summary> Plans memory for the ports in a map. </summary>
+        ///
+        /// <param name="map"> The (refined) map to plan memory for. </param>
+        /// <param name="includeUnsharedPorts"> If `true`, also plan (unshared) memory for ports that can't share memory. </param>
+        /// <param name="alignment"> The alignment, in bytes, of each port's data within its buffer. </param>
+        MemoryPlanner(const Map& map, bool includeUnsharedPorts = false, size_t alignment = 64);
+
+        /// <summary> Indicates if the planner assigned memory to an output port. </summary>
+        ///
+        /// <param name="port"> The output port. </param>
+        /// <returns> `true` if the port has planned memory. </returns>
+        bool HasAssignment(const OutputPortBase& port) const;
+
+        /// <summary> Gets the memory assigned to an output port. </summary>
+        ///
+        /// <param name="port"> The output port. </param>
+        /// <returns> The location of the port's data. </returns>
+        const PortMemoryAssignment& GetAssignment(const OutputPortBase& port) const;
+
+        /// <summary> Gets the size of the buffer that holds the planned ports of a given type. </summary>
+        ///
+        /// <param name="type"> The port type. </param>
+        /// <returns> The size of the buffer, in elements (zero if no ports of that type were planned). </returns>
+        size_t GetBufferSize(Port::PortType type) const;
+
+        /// <summary>
+        /// Gets the offset of the buffer for a given port type when all the buffers are laid out, one after another,
+        /// in a single block of `GetPlannedMemorySize()` bytes. Each buffer starts at a multiple of the alignment.
+        /// </summary>
+        ///
+        /// <param name="type"> The port type. </param>
+        /// <returns> The offset of the buffer, in bytes. </returns>
+        size_t GetBufferOffset(Port::PortType type) const;
+
+        /// <summary> Gets the size, in bytes, of one element of a port of the given type. </summary>
+        ///
+        /// <param name="type"> The port type. </param>
+        /// <returns> The size of an element, or zero if ports of that type can't be planned. </returns>
+        static size_t GetElementSize(Port::PortType type);
+
+        /// <summary> Gets the number of output ports that were assigned planned memory. </summary>
+        size_t NumPlannedPorts() const { return _assignments.size(); }
+
+        /// <summary> Gets the number of output ports that share their input's memory. </summary>
+        size_t NumInPlacePorts() const { return _numInPlacePorts; }
+
+        /// <summary> Gets the total size, in bytes, of the planned buffers. This is the peak memory used by the planned ports. </summary>
+        size_t GetPlannedMemorySize() const;
+
+        /// <summary> Gets the size, in bytes, the planned ports would use if each was given its own memory. </summary>
+        size_t GetUnplannedMemorySize() const { return _unplannedMemorySize; }
+
+    private:
+        struct Buffer
+        {
+            Port::PortType type;
+            size_t size; // in elements, rounded up to the alignment
+            int firstUse;
+            int lastUse;
+            size_t offset;
+        };
+
+        void Plan(const Map& map, bool includeUnsharedPorts, size_t alignment);
+        void PackBuffers();
+
+        std::unordered_map<const OutputPortBase*, PortMemoryAssignment> _assignments;
+        std::unordered_map<const OutputPortBase*, size_t> _portBuffers;
+        std::vector<Buffer> _buffers;
+        std::map<Port::PortType, size_t> _bufferSizes;
+        size_t _numInPlacePorts = 0;
+        size_t _unplannedMemorySize = 0;
+    };
+}
+}
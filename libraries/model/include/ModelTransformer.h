@@ -284,10 +284,15 @@ namespace model
         // Collect nodes that are't compilable
         std::vector<const Node*> FindUncompilableNodes(const Model& model, const TransformContext& context) const;
 
+        void CopyNode(const Node& node);
+        void PropagateNodeMetadata(Node& newNode) const;
+
         Model _model;
         TransformContext _context;
         PortOutputsMap _elementsMap;
         bool _isModelCompilable;
+        const Node* _currentNode = nullptr; // the node being copied or refined
+
     };
 }
 }
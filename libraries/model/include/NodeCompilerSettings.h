@@ -0,0 +1,97 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     NodeCompilerSettings.h (model)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+// emitters
+#include "ModuleEmitter.h"
+#include "TargetDevice.h"
+
+// utilities
+#include "PropertyBag.h"
+
+// stl
+#include <string>
+
+namespace ell
+{
+namespace model
+{
+    class Map;
+    class Node;
+
+    /// <summary>
+    /// Code generation settings that override the map compiler's parameters for a single node (and for the nodes it
+    /// refines into). Zero or empty fields leave the corresponding compiler parameter alone.
+    /// </summary>
+    struct NodeCompilerSettings
+    {
+        /// <summary> The convolution method to use ("columnwise", "diagonal" or "winograd"), for convolutional layer nodes. </summary>
+        std::string convolutionMethod;
+
+        /// <summary> The vector width to use. A width of 1 turns off vector instructions. </summary>
+        int vectorWidth = 0;
+
+        /// <summary> The number of threads to use. A count of 1 turns off parallelization. </summary>
+        int maxThreads = 0;
+
+        /// <summary> The tile sizes of the native (non-BLAS) matrix multiply. </summary>
+        emitters::GemmTileSizes gemmTileSizes;
+
+        /// <summary>
+        /// The scale used to quantize the input of a convolutional or fully-connected layer node to 8-bit integers (an input
+        /// value `x` becomes `round(x / scale)`), or 0 to leave the layer in floating point. Set by calibrating the map
+        /// on representative data.
+        /// </summary>
+        double inputQuantizationScale = 0;
+
+        /// <summary> Indicates if none of the settings are set. </summary>
+        bool IsEmpty() const;
+
+        /// <summary> Overrides the compiler parameters with the settings that are set. </summary>
+        ///
+        /// <param name="parameters"> The compiler parameters to modify. </param>
+        void Apply(emitters::CompilerParameters& parameters) const;
+    };
+
+    /// <summary>
+    /// Gets the key used to find a node's settings in a map's metadata. The key is built from the node's type and the
+    /// sizes of its ports, so it survives copying and refining the map, and nodes with identical shapes share settings.
+    /// </summary>
+    ///
+    /// <param name="node"> The node. </param>
+    /// <returns> The key for the node's settings. </returns>
+    std::string GetNodeCompilerSettingsKey(const Node& node);
+
+    /// <summary> Indicates if a node has compiler settings in its metadata. </summary>
+    bool HasNodeCompilerSettings(const Node& node);
+
+    /// <summary> Gets the compiler settings stored in a node's metadata. </summary>
+    NodeCompilerSettings GetNodeCompilerSettings(const Node& node);
+
+    /// <summary> Stores compiler settings in a node's metadata. </summary>
+    void SetNodeCompilerSettings(Node& node, const NodeCompilerSettings& settings);
+
+    /// <summary> Indicates if a map's metadata holds compiler settings for nodes with the given key. </summary>
+    bool HasNodeCompilerSettings(const Map& map, const std::string& nodeKey);
+
+    /// <summary> Gets the compiler settings a map's metadata holds for nodes with the given key. </summary>
+    NodeCompilerSettings GetNodeCompilerSettings(const Map& map, const std::string& nodeKey);
+
+    /// <summary> Stores compiler settings for nodes with the given key in a map's metadata, where they persist when the map is saved. </summary>
+    void SetNodeCompilerSettings(Map& map, const std::string& nodeKey, const NodeCompilerSettings& settings);
+
+    /// <summary>
+    /// Copies the compiler settings from the map's metadata into the metadata of the map's nodes whose keys match. Input
+    /// quantization scales are calibrated for individual nodes rather than for node shapes, so a node keeps its own.
+    /// </summary>
+    ///
+    /// <param name="map"> The map. </param>
+    void ApplyNodeCompilerSettings(Map& map);
+}
+}
@@ -41,7 +41,9 @@ namespace model
         emitters::IRModuleEmitter& moduleEmitter = irCompiler->GetModule();
         auto& enclosingFunction = moduleEmitter.GetCurrentFunction();
 
-        if (ShouldCompileInline() || compiler.GetMapCompilerParameters().inlineNodes)
+        // In reentrant mode, nodes are compiled into the predict function, where their buffers in the workspace can be reached
+        const auto& parameters = compiler.GetMapCompilerParameters();
+        if (ShouldCompileInline() || parameters.inlineNodes || parameters.reentrant)
         {
             Log() << "Inlining node " << DiagnosticString(*this) << " into function " << enclosingFunction.GetFunctionName() << EOL;
 
@@ -101,6 +103,60 @@ namespace model
         throw utilities::LogicException(utilities::LogicExceptionErrors::notImplemented);
     }
 
+    bool CompilableNode::CanReuseOutputMemory(const OutputPortBase& port) const
+    {
+        return false;
+    }
+
+    const InputPortBase* CompilableNode::GetInPlaceInputPort(const OutputPortBase& port) const
+    {
+        return nullptr;
+    }
+
+    bool CompilableNode::CanCompileBatch(IRMapCompiler& compiler)
+    {
+        return !compiler.GetMapCompilerParameters().inlineNodes && !ShouldCompileInline() && compiler.GetModule().HasFunction(GetCompiledFunctionName());
+    }
+
+    void CompilableNode::CompileBatch(IRMapCompiler& compiler, emitters::IRFunctionEmitter& function, int batchSize)
+    {
+        // Call the node's function once per sample, in order, so nodes that keep state see the samples as they would from predict
+        auto pNodeFunction = compiler.GetModule().GetFunction(GetCompiledFunctionName());
+        if (pNodeFunction == nullptr)
+        {
+            throw emitters::EmitterException(emitters::EmitterError::functionNotFound, "No function for node " + DiagnosticString(*this));
+        }
+
+        std::vector<std::pair<llvm::Value*, int>> inputs;
+        for (auto port : GetInputPorts())
+        {
+            inputs.emplace_back(compiler.EnsureBatchPortEmitted(*port, function), compiler.GetBatchPortStride(*port));
+        }
+        std::vector<std::pair<llvm::Value*, int>> outputs;
+        for (auto port : GetOutputPorts())
+        {
+            outputs.emplace_back(compiler.EnsureBatchPortEmitted(*port, function), compiler.GetBatchPortStride(*port));
+        }
+
+        function.For(batchSize, [this, &compiler, pNodeFunction, &inputs, &outputs](emitters::IRFunctionEmitter& function, llvm::Value* sample) {
+            auto sampleOffset = [&function, sample](int stride) { return function.Operator(emitters::TypedOperator::multiply, sample, function.Literal(stride)); };
+            std::vector<llvm::Value*> args;
+            for (const auto& input : inputs)
+            {
+                args.push_back(function.PointerOffset(input.first, sampleOffset(input.second)));
+            }
+            for (const auto& arg : GetNodeFunctionStateArguments(compiler, function))
+            {
+                args.push_back(arg);
+            }
+            for (const auto& output : outputs)
+            {
+                args.push_back(function.PointerOffset(output.first, sampleOffset(output.second)));
+            }
+            function.Call(pNodeFunction, args);
+        });
+    }
+
     bool CompilableNode::ShouldCompileInline() const
     {
         // Make sure all inputs have only pure ports
@@ -24,20 +24,53 @@
 #include "llvm/Transforms/Utils/Cloning.h"
 
 // stl
+#include <algorithm>
 #include <sstream>
 
 namespace ell
 {
 namespace model
 {
+    namespace
+    {
+        // Removes the state of a thread from the tables of the maps it used (and that still exist) when the thread exits
+        template <typename ThreadStateTableType>
+        class ThreadExitCleanup
+        {
+        public:
+            ~ThreadExitCleanup()
+            {
+                const auto threadId = std::this_thread::get_id();
+                for (const auto& weakTable : _tables)
+                {
+                    if (auto table = weakTable.lock())
+                    {
+                        std::lock_guard<std::mutex> lock(table->mutex);
+                        table->states.erase(threadId);
+                    }
+                }
+            }
+
+            void Add(const std::shared_ptr<ThreadStateTableType>& table)
+            {
+                // Forget the maps that have been destroyed, so a long-lived thread doesn't collect them
+                _tables.erase(std::remove_if(_tables.begin(), _tables.end(), [](const std::weak_ptr<ThreadStateTableType>& weakTable) { return weakTable.expired(); }), _tables.end());
+                _tables.push_back(table);
+            }
+
+        private:
+            std::vector<std::weak_ptr<ThreadStateTableType>> _tables;
+        };
+    }
+
     IRCompiledMap::IRCompiledMap(IRCompiledMap&& other)
-        : CompiledMap(std::move(other), other._functionName), _moduleName(std::move(other._moduleName)), _module(std::move(other._module)), _executionEngine(std::move(other._executionEngine)), _computeFunctionDefined(false)
+        : CompiledMap(std::move(other), other._functionName), _moduleName(std::move(other._moduleName)), _module(std::move(other._module)), _executionEngine(std::move(other._executionEngine)), _isJitted(other._isJitted.load()), _predictFunctionAddress(other._predictFunctionAddress), _predictBatchFunctionAddress(other._predictBatchFunctionAddress), _initializeWorkspaceFunctionAddress(other._initializeWorkspaceFunctionAddress), _isReentrant(other._isReentrant), _workspaceSize(other._workspaceSize), _predictBatchFunctionName(std::move(other._predictBatchFunctionName)), _threadStates(std::move(other._threadStates))
     {
     }
 
     // private constructor:
-    IRCompiledMap::IRCompiledMap(Map map, const std::string& functionName, std::unique_ptr<emitters::IRModuleEmitter> module)
-        : CompiledMap(std::move(map), functionName), _module(std::move(module)), _computeFunctionDefined(false)
+    IRCompiledMap::IRCompiledMap(Map map, const std::string& functionName, std::unique_ptr<emitters::IRModuleEmitter> module, bool isReentrant, size_t workspaceSize, const std::string& predictBatchFunctionName)
+        : CompiledMap(std::move(map), functionName), _module(std::move(module)), _isJitted(false), _isReentrant(isReentrant), _workspaceSize(workspaceSize), _predictBatchFunctionName(predictBatchFunctionName), _threadStates(std::make_shared<ThreadStateTable>())
     {
         _moduleName = _module->GetModuleName();
     }
@@ -64,37 +97,49 @@ namespace model
 
     void IRCompiledMap::FinishJitting() const
     {
-        EnsureExecutionEngine();
-        SetComputeFunction();
-    }
-
-    void IRCompiledMap::SetComputeFunction() const
-    {
-        switch (GetInput(0)->GetOutputPort().GetType())
+        if (_isJitted.load(std::memory_order_acquire))
         {
-            case model::Port::PortType::boolean:
-                SetComputeFunctionForInputType<bool>();
-                break;
-
-            case model::Port::PortType::integer:
-                SetComputeFunctionForInputType<int>();
-                break;
-
-            case model::Port::PortType::bigInt:
-                SetComputeFunctionForInputType<int64_t>();
-                break;
+            return;
+        }
 
-            case model::Port::PortType::smallReal:
-                SetComputeFunctionForInputType<float>();
-                break;
+        std::lock_guard<std::mutex> lock(_jitMutex);
+        if (!_isJitted.load(std::memory_order_relaxed))
+        {
+            EnsureExecutionEngine();
+            _predictFunctionAddress = _executionEngine->ResolveFunctionAddress(_functionName);
+            if (!_predictBatchFunctionName.empty())
+            {
+                _predictBatchFunctionAddress = _executionEngine->ResolveFunctionAddress(_predictBatchFunctionName);
+            }
+            if (_isReentrant)
+            {
+                _initializeWorkspaceFunctionAddress = _executionEngine->ResolveFunctionAddress(_moduleName + "_InitializeWorkspace");
+            }
+            _isJitted.store(true, std::memory_order_release);
+        }
+    }
 
-            case model::Port::PortType::real:
-                SetComputeFunctionForInputType<double>();
-                break;
+    IRCompiledMap::ThreadState& IRCompiledMap::GetThreadState() const
+    {
+        static thread_local ThreadExitCleanup<ThreadStateTable> threadExitCleanup;
 
-            default:
-                throw utilities::InputException(utilities::InputExceptionErrors::typeMismatch);
+        // The lock only guards the lookup: each state is only ever used by its own thread, and isn't moved by a rehash
+        std::lock_guard<std::mutex> lock(_threadStates->mutex);
+        auto& threadState = _threadStates->states[std::this_thread::get_id()];
+        if (threadState == nullptr)
+        {
+            threadState = std::make_unique<ThreadState>();
+            threadExitCleanup.Add(_threadStates);
+            if (_isReentrant)
+            {
+                // Always allocate at least one byte, so the workspace pointer is valid
+                auto& workspace = threadState->workspace;
+                workspace.resize(std::max<size_t>(1, _workspaceSize));
+                auto initializeFunction = reinterpret_cast<void (*)(int8_t*)>(_initializeWorkspaceFunctionAddress);
+                initializeFunction(reinterpret_cast<int8_t*>(workspace.data()));
+            }
         }
+        return *threadState;
     }
 
     void IRCompiledMap::SetNodeInput(model::InputNode<bool>* node, const std::vector<bool>& inputValues) const
@@ -111,7 +156,7 @@ namespace model
             temp[index] = static_cast<bool>(inputValues[index]);
         }
 
-        std::get<ComputeFunction<bool>>(_computeInputFunction)((bool*)temp.data());
+        ComputeCachedOutput((bool*)temp.data());
     }
 
     void IRCompiledMap::SetNodeInput(model::InputNode<int>* node, const std::vector<int>& inputValues) const
@@ -123,7 +168,7 @@ namespace model
             throw utilities::InputException(utilities::InputExceptionErrors::typeMismatch);
         }
 
-        std::get<ComputeFunction<int>>(_computeInputFunction)(inputValues.data());
+        ComputeCachedOutput(inputValues.data());
     }
 
     void IRCompiledMap::SetNodeInput(model::InputNode<int64_t>* node, const std::vector<int64_t>& inputValues) const
@@ -135,7 +180,7 @@ namespace model
             throw utilities::InputException(utilities::InputExceptionErrors::typeMismatch);
         }
 
-        std::get<ComputeFunction<int64_t>>(_computeInputFunction)(inputValues.data());
+        ComputeCachedOutput(inputValues.data());
     }
 
     void IRCompiledMap::SetNodeInput(model::InputNode<float>* node, const std::vector<float>& inputValues) const
@@ -147,7 +192,7 @@ namespace model
             throw utilities::InputException(utilities::InputExceptionErrors::typeMismatch);
         }
 
-        std::get<ComputeFunction<float>>(_computeInputFunction)(inputValues.data());
+        ComputeCachedOutput(inputValues.data());
     }
 
     void IRCompiledMap::SetNodeInput(model::InputNode<double>* node, const std::vector<double>& inputValues) const
@@ -158,7 +203,7 @@ namespace model
             throw utilities::InputException(utilities::InputExceptionErrors::typeMismatch);
         }
 
-        std::get<ComputeFunction<double>>(_computeInputFunction)(inputValues.data());
+        ComputeCachedOutput(inputValues.data());
     }
 
     std::vector<bool> IRCompiledMap::ComputeBoolOutput(const model::PortElementsBase& outputs) const
@@ -171,18 +216,19 @@ namespace model
         }
 
         // Terrible hack to create a std::vector<bool>
-        return std::vector<bool>((bool*)(std::get<utilities::ConformingVector<bool>>(_cachedOutput).data()), (bool*)(std::get<utilities::ConformingVector<bool>>(_cachedOutput).data() + std::get<utilities::ConformingVector<bool>>(_cachedOutput).size()));
+        const auto& cachedOutput = GetCachedOutput<bool>();
+        return std::vector<bool>((bool*)(cachedOutput.data()), (bool*)(cachedOutput.data() + cachedOutput.size()));
     }
 
     std::vector<int> IRCompiledMap::ComputeIntOutput(const model::PortElementsBase& outputs) const
     {
-        EnsureExecutionEngine();
+        FinishJitting();
         if (GetOutput(0).GetPortType() != model::Port::PortType::integer)
         {
             throw utilities::InputException(utilities::InputExceptionErrors::typeMismatch);
         }
 
-        return std::get<utilities::ConformingVector<int>>(_cachedOutput);
+        return GetCachedOutput<int>();
     }
 
     std::vector<int64_t> IRCompiledMap::ComputeInt64Output(const model::PortElementsBase& outputs) const
@@ -193,7 +239,7 @@ namespace model
             throw utilities::InputException(utilities::InputExceptionErrors::typeMismatch);
         }
 
-        return std::get<utilities::ConformingVector<int64_t>>(_cachedOutput);
+        return GetCachedOutput<int64_t>();
     }
 
     std::vector<float> IRCompiledMap::ComputeFloatOutput(const model::PortElementsBase& outputs) const
@@ -204,7 +250,7 @@ namespace model
             throw utilities::InputException(utilities::InputExceptionErrors::typeMismatch);
         }
 
-        return std::get<utilities::ConformingVector<float>>(_cachedOutput);
+        return GetCachedOutput<float>();
     }
 
     std::vector<double> IRCompiledMap::ComputeDoubleOutput(const model::PortElementsBase& outputs) const
@@ -215,7 +261,7 @@ namespace model
             throw utilities::InputException(utilities::InputExceptionErrors::typeMismatch);
         }
 
-        return std::get<utilities::ConformingVector<double>>(_cachedOutput);
+        return GetCachedOutput<double>();
     }
 
     void IRCompiledMap::WriteCode(const std::string& filePath) const
@@ -10,10 +10,13 @@
 #include "CompilableNode.h"
 #include "CompilableNodeUtilities.h"
 #include "IRModelProfiler.h"
+#include "NodeCompilerSettings.h"
+#include "InputNodeBase.h"
 #include "OutputNode.h"
 
 // emitters
 #include "EmitterException.h"
+#include "IRMetadata.h"
 #include "Variable.h"
 
 // utils
@@ -121,7 +124,7 @@ namespace model
 
         Log() << "Refining the model..." << EOL;
         model::TransformContext context{ this, [this](const model::Node& node) { return node.IsCompilable(this) ? model::NodeAction::compile : model::NodeAction::refine; } };
-        map.Refine(context);
+        RefineMap(map, context);
 
         // Renaming callbacks based on map compiler parameters
         // Note: a more elegant solution is emit variables which get assigned to
@@ -130,6 +133,10 @@ namespace model
         map.RenameCallbacks(GetMapCompilerParameters().sourceFunctionName, GetMapCompilerParameters().sinkFunctionName);
 
         // Now the model ready for compiling
+        if (GetMapCompilerParameters().profile && GetMapCompilerParameters().reentrant)
+        {
+            throw emitters::EmitterException(emitters::EmitterError::notSupported, "Profiling counters are module globals, so a profiled map can't be reentrant");
+        }
         if (GetMapCompilerParameters().profile)
         {
             Log() << "Enabling profiling in emitted IR" << EOL;
@@ -149,7 +156,29 @@ namespace model
         _profiler.EmitModelProfilerFunctions();
 
         auto module = std::make_unique<emitters::IRModuleEmitter>(std::move(_moduleEmitter));
-        return IRCompiledMap(std::move(map), GetMapCompilerParameters().mapFunctionName, std::move(module));
+        auto workspaceSize = GetMapCompilerParameters().reentrant ? GetWorkspaceSize() : 0;
+        auto predictBatchFunctionName = GetMapCompilerParameters().emitPredictBatch ? GetPredictBatchFunctionName(GetPredictFunctionName()) : std::string();
+        return IRCompiledMap(std::move(map), GetMapCompilerParameters().mapFunctionName, std::move(module), GetMapCompilerParameters().reentrant, workspaceSize, predictBatchFunctionName);
+    }
+
+    void IRMapCompiler::RefineMap(Map& map, const TransformContext& context)
+    {
+        // Refine one level at a time, so per-node compiler settings stored in the map's metadata reach the nodes
+        // they were recorded for even when those nodes only appear partway through refinement
+        const int maxRefinementIterations = 10;
+        ApplyNodeCompilerSettings(map);
+        for (int iteration = 0; iteration < maxRefinementIterations; ++iteration)
+        {
+            bool isCompilable = true;
+            map.GetModel().Visit([&context, &isCompilable](const Node& node) { isCompilable &= context.IsNodeCompilable(node); });
+            if (isCompilable)
+            {
+                break;
+            }
+
+            map.Refine(context, 1);
+            ApplyNodeCompilerSettings(map);
+        }
     }
 
     void IRMapCompiler::EmitModelAPIFunctions(const Map& map)
@@ -160,6 +189,17 @@ namespace model
         EmitShapeEnum();
         EmitGetInputShapeFunction(map);
         EmitGetOutputShapeFunction(map);
+
+        if (GetMapCompilerParameters().emitPredictBatch)
+        {
+            EmitPredictBatchFunction(map);
+        }
+
+        if (GetMapCompilerParameters().reentrant)
+        {
+            EmitGetWorkspaceSizeFunction();
+            EmitInitializeWorkspaceFunction();
+        }
     }
 
     void IRMapCompiler::EmitGetInputSizeFunction(const Map& map)
@@ -184,6 +224,238 @@ namespace model
         _moduleEmitter.EndFunction();
     }
 
+    void IRMapCompiler::EmitPredictBatchFunction(const Map& map)
+    {
+        // void <predict>_batch(int32 count, const InputType* inputs, OutputType* outputs [, int8_t* workspace])
+        // Samples are stored one after another in `inputs` and `outputs`. Whole tiles of `predictBatchSize` samples are
+        // computed together, one node at a time, so nodes like matrix multiplies can compute the tile in one call (see
+        // CompilableNode::CompileBatch). The rest of the samples are run through the predict function, as are all of
+        // them if some node can't be compiled for a tile.
+        auto pPredictFunction = _moduleEmitter.GetFunction(GetPredictFunctionName());
+        if (pPredictFunction == nullptr)
+        {
+            throw emitters::EmitterException(emitters::EmitterError::functionNotFound, "Predict function " + GetPredictFunctionName() + " not found");
+        }
+
+        auto& context = _moduleEmitter.GetLLVMContext();
+        auto voidType = llvm::Type::getVoidTy(context);
+        auto int32Type = llvm::Type::getInt32Ty(context);
+        auto predictArguments = pPredictFunction->args().begin();
+        auto inputType = (*predictArguments++).getType();
+        auto outputType = (*predictArguments++).getType();
+        const bool inputIsScalar = !inputType->isPointerTy();
+        std::vector<llvm::Type*> parameters = { int32Type, inputIsScalar ? inputType->getPointerTo() : inputType, outputType };
+        if (GetMapCompilerParameters().reentrant)
+        {
+            parameters.push_back((*predictArguments).getType());
+        }
+
+        auto function = _moduleEmitter.BeginFunction(GetPredictBatchFunctionName(GetPredictFunctionName()), voidType, parameters);
+        function.IncludeInHeader();
+        function.IncludeInPredictBatchInterface(GetNamespacePrefix());
+
+        auto arguments = function.Arguments().begin();
+        llvm::Value* pCount = &(*arguments++);
+        llvm::Value* pInputs = &(*arguments++);
+        llvm::Value* pOutputs = &(*arguments++);
+        llvm::Value* pWorkspace = GetMapCompilerParameters().reentrant ? &(*arguments) : nullptr;
+
+        auto inputSize = function.Literal(static_cast<int>(map.GetInputSize()));
+        auto outputSize = function.Literal(static_cast<int>(map.GetOutputSize()));
+        llvm::Value* pFirstSample = function.Literal(0);
+        const int batchSize = GetMapCompilerParameters().predictBatchSize;
+        if (batchSize > 1 && CanCompileBatch(map))
+        {
+            Log() << "Compiling predict_batch in tiles of " << batchSize << " samples" << EOL;
+            auto pNumTiles = function.Operator(emitters::TypedOperator::divideSigned, pCount, function.Literal(batchSize));
+            function.For(pNumTiles, [this, &map, batchSize, pInputs, pOutputs, inputSize, outputSize](emitters::IRFunctionEmitter& function, llvm::Value* tile) {
+                auto pTileStart = function.Operator(emitters::TypedOperator::multiply, tile, function.Literal(batchSize));
+                auto pTileInputs = function.PointerOffset(pInputs, function.Operator(emitters::TypedOperator::multiply, pTileStart, inputSize));
+                auto pTileOutputs = function.PointerOffset(pOutputs, function.Operator(emitters::TypedOperator::multiply, pTileStart, outputSize));
+                EmitPredictBatchTile(map, function, batchSize, pTileInputs, pTileOutputs);
+            });
+            pFirstSample = function.Operator(emitters::TypedOperator::multiply, pNumTiles, function.Literal(batchSize));
+        }
+
+        function.For(pFirstSample, pCount, [pPredictFunction, inputIsScalar, pInputs, pOutputs, pWorkspace, inputSize, outputSize](emitters::IRFunctionEmitter& function, llvm::Value* i) {
+            auto pInput = function.PointerOffset(pInputs, function.Operator(emitters::TypedOperator::multiply, i, inputSize));
+            auto pOutput = function.PointerOffset(pOutputs, function.Operator(emitters::TypedOperator::multiply, i, outputSize));
+            std::vector<llvm::Value*> callArguments = { inputIsScalar ? function.Load(pInput) : pInput, pOutput };
+            if (pWorkspace != nullptr)
+            {
+                callArguments.push_back(pWorkspace);
+            }
+            function.Call(pPredictFunction, callArguments);
+        });
+        _moduleEmitter.EndFunction();
+    }
+
+    bool IRMapCompiler::CanCompileBatch(const Map& map)
+    {
+        // The ports of a tile live in globals, so a reentrant map runs every sample through predict
+        if (GetMapCompilerParameters().reentrant || map.GetOutput(0).NumRanges() != 1)
+        {
+            return false;
+        }
+
+        const auto inputNode = map.GetInput(0);
+        bool canCompile = true;
+        map.GetModel().Visit([this, inputNode, &canCompile](const Node& node) {
+            if (!canCompile)
+            {
+                return;
+            }
+
+            if (dynamic_cast<const SourceNodeBase*>(&node) != nullptr || dynamic_cast<const SinkNodeBase*>(&node) != nullptr)
+            {
+                // Callbacks must see the samples in the same order as they would from predict
+                canCompile = false;
+            }
+            else if (dynamic_cast<const InputNodeBase*>(&node) != nullptr)
+            {
+                canCompile = &node == inputNode;
+            }
+            else if (dynamic_cast<const OutputNodeBase*>(&node) != nullptr)
+            {
+                canCompile = node.GetInputPorts()[0]->GetInputElements().NumRanges() == 1;
+            }
+            else if (node.NumInputPorts() == 0)
+            {
+                for (auto port : node.GetOutputPorts())
+                {
+                    auto pVar = GetVariableForPort(*port);
+                    canCompile &= pVar != nullptr && pVar->IsLiteral();
+                }
+            }
+            else
+            {
+                auto compilableNode = const_cast<CompilableNode*>(dynamic_cast<const CompilableNode*>(&node));
+                canCompile = compilableNode != nullptr && compilableNode->CanCompileBatch(*this);
+            }
+
+            if (!canCompile)
+            {
+                Log() << "Node " << DiagnosticString(node) << " can't be compiled for a batch, so predict_batch calls predict for each sample" << EOL;
+            }
+        });
+        return canCompile;
+    }
+
+    void IRMapCompiler::EmitPredictBatchTile(const Map& map, emitters::IRFunctionEmitter& function, int batchSize, llvm::Value* pInputs, llvm::Value* pOutputs)
+    {
+        _batchSize = batchSize;
+        _batchPorts.clear();
+        const auto inputNode = map.GetInput(0);
+        _batchPorts[&inputNode->GetOutputPort()] = { pInputs, static_cast<int>(inputNode->GetOutputPort().Size()) };
+
+        map.GetModel().Visit([this, &function, batchSize, inputNode](const Node& node) {
+            if (&node == inputNode)
+            {
+                return;
+            }
+
+            if (dynamic_cast<const OutputNodeBase*>(&node) != nullptr)
+            {
+                // An output node's value is a copy of its input
+                const auto& input = *node.GetInputPorts()[0];
+                _batchPorts[node.GetOutputPorts()[0]] = { EnsureBatchPortEmitted(input, function), GetBatchPortStride(input) };
+            }
+            else if (node.NumInputPorts() == 0)
+            {
+                // Nodes without inputs (e.g., constants) have the same literal value for every sample
+                for (auto port : node.GetOutputPorts())
+                {
+                    _batchPorts[port] = { GetModule().EnsureEmitted(*GetVariableForPort(*port)), 0 };
+                }
+            }
+            else
+            {
+                Log() << "Compiling node " << DiagnosticString(node) << " for a batch" << EOL;
+                auto compilableNode = const_cast<CompilableNode*>(dynamic_cast<const CompilableNode*>(&node));
+                compilableNode->CompileBatch(*this, function, batchSize);
+            }
+        });
+
+        auto output = map.GetOutput(0);
+        switch (output.GetPortType())
+        {
+            case Port::PortType::boolean:
+                EmitCopyBatchOutput<bool>(function, output, pOutputs);
+                break;
+            case Port::PortType::integer:
+                EmitCopyBatchOutput<int>(function, output, pOutputs);
+                break;
+            case Port::PortType::bigInt:
+                EmitCopyBatchOutput<int64_t>(function, output, pOutputs);
+                break;
+            case Port::PortType::smallReal:
+                EmitCopyBatchOutput<float>(function, output, pOutputs);
+                break;
+            case Port::PortType::real:
+                EmitCopyBatchOutput<double>(function, output, pOutputs);
+                break;
+            default:
+                throw utilities::InputException(utilities::InputExceptionErrors::typeMismatch);
+        }
+        _batchPorts.clear();
+    }
+
+    void IRMapCompiler::EmitGetWorkspaceSizeFunction()
+    {
+        auto& context = _moduleEmitter.GetLLVMContext();
+        auto int64Type = llvm::Type::getInt64Ty(context);
+
+        auto function = _moduleEmitter.BeginFunction(GetNamespacePrefix() + "_GetWorkspaceSize", int64Type);
+        function.IncludeInHeader();
+        function.InsertMetadata(emitters::c_workspaceSizeFunctionTagName, GetNamespacePrefix());
+        function.Return(function.Literal(static_cast<int64_t>(GetWorkspaceSize())));
+        _moduleEmitter.EndFunction();
+    }
+
+    void IRMapCompiler::EmitInitializeWorkspaceFunction()
+    {
+        // void <prefix>_InitializeWorkspace(int8_t* workspace)
+        // Clears the workspace, then writes the values (e.g., padding) that would have been in the initializers of globals
+        auto& context = _moduleEmitter.GetLLVMContext();
+        auto voidType = llvm::Type::getVoidTy(context);
+        auto int8PtrType = llvm::Type::getInt8PtrTy(context);
+        const std::vector<llvm::Type*> parameters = { int8PtrType };
+        auto function = _moduleEmitter.BeginFunction(GetNamespacePrefix() + "_InitializeWorkspace", voidType, parameters);
+        function.IncludeInHeader();
+
+        llvm::Value* pWorkspace = &(*function.Arguments().begin());
+        auto workspaceSize = static_cast<int>(GetWorkspaceSize());
+        if (workspaceSize > 0)
+        {
+            function.MemorySet<uint8_t>(pWorkspace, 0, function.Literal<uint8_t>(0), workspaceSize);
+        }
+
+        for (const auto& initializer : GetWorkspaceInitializers())
+        {
+            switch (initializer.type)
+            {
+                case emitters::VariableType::Byte:
+                    EmitFillWorkspace<uint8_t>(function, pWorkspace, initializer);
+                    break;
+                case emitters::VariableType::Int32:
+                    EmitFillWorkspace<int>(function, pWorkspace, initializer);
+                    break;
+                case emitters::VariableType::Int64:
+                    EmitFillWorkspace<int64_t>(function, pWorkspace, initializer);
+                    break;
+                case emitters::VariableType::Float:
+                    EmitFillWorkspace<float>(function, pWorkspace, initializer);
+                    break;
+                case emitters::VariableType::Double:
+                    EmitFillWorkspace<double>(function, pWorkspace, initializer);
+                    break;
+                default:
+                    throw emitters::EmitterException(emitters::EmitterError::variableTypeNotSupported);
+            }
+        }
+        _moduleEmitter.EndFunction();
+    }
+
     const char* TensorShapeName = "TensorShape";
 
     void IRMapCompiler::EmitShapeEnum()
@@ -364,6 +636,72 @@ namespace model
         return GetModule().EnsureEmitted(*pVar);
     }
 
+    llvm::Value* IRMapCompiler::EnsureNodeBufferEmitted(const Node& node, const std::string& name, emitters::VariableType type, size_t size)
+    {
+        auto pVar = AllocateNodeBuffer(node, name, type, size);
+        return GetModule().EnsureEmitted(*pVar);
+    }
+
+    llvm::Value* IRMapCompiler::EnsureBatchPortEmitted(const OutputPortBase& port, emitters::IRFunctionEmitter& function)
+    {
+        auto search = _batchPorts.find(&port);
+        if (search != _batchPorts.end())
+        {
+            return search->second.pointer;
+        }
+
+        // Each port computed for a tile gets a global buffer with room for every sample of the tile
+        auto pVar = GetModule().Variables().AddVectorVariable(emitters::VariableScope::global, PortTypeToVariableType(port.GetType()), static_cast<int>(_batchSize * port.Size()));
+        GetModule().AllocateVariable(*pVar);
+        auto pBuffer = function.PointerOffset(GetModule().EnsureEmitted(*pVar), 0);
+        _batchPorts[&port] = { pBuffer, static_cast<int>(port.Size()) };
+        return pBuffer;
+    }
+
+    llvm::Value* IRMapCompiler::EnsureBatchPortEmitted(const InputPortBase& port, emitters::IRFunctionEmitter& function)
+    {
+        const auto& elements = port.GetInputElements();
+        if (elements.NumRanges() != 1)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "Only ports with a single range of elements can be computed for a batch");
+        }
+
+        const auto& range = elements.GetRanges()[0];
+        if (_batchPorts.find(range.ReferencedPort()) == _batchPorts.end())
+        {
+            throw utilities::LogicException(utilities::LogicExceptionErrors::illegalState, "Port read before it was computed for the batch");
+        }
+        return function.PointerOffset(_batchPorts[range.ReferencedPort()].pointer, static_cast<int>(range.GetStartIndex()));
+    }
+
+    int IRMapCompiler::GetBatchPortStride(const OutputPortBase& port) const
+    {
+        auto search = _batchPorts.find(&port);
+        if (search == _batchPorts.end())
+        {
+            throw utilities::LogicException(utilities::LogicExceptionErrors::illegalState, "Port read before it was computed for the batch");
+        }
+        return search->second.stride;
+    }
+
+    int IRMapCompiler::GetBatchPortStride(const InputPortBase& port) const
+    {
+        return GetBatchPortStride(*port.GetInputElements().GetRanges()[0].ReferencedPort());
+    }
+
+    bool IRMapCompiler::IsBatchInvariant(const InputPortBase& port) const
+    {
+        for (const auto& range : port.GetInputElements().GetRanges())
+        {
+            const auto& node = *range.ReferencedPort()->GetNode();
+            if (node.NumInputPorts() != 0 || dynamic_cast<const InputNodeBase*>(&node) != nullptr)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
     llvm::Value* IRMapCompiler::EnsurePortElementEmitted(const PortElementBase& element)
     {
         auto pVar = GetVariableForElement(element);
@@ -405,6 +743,17 @@ namespace model
             currentFunction.AddRegion(currentFunction.GetCurrentBlock());
         }
 
+        if (HasNodeCompilerSettings(node))
+        {
+            auto settings = GetNodeCompilerSettings(node);
+            auto parameters = GetModule().GetCompilerParameters();
+            _savedCompilerParameters.push_back(parameters);
+            settings.Apply(parameters);
+            parameters.parallelize &= !GetMapCompilerParameters().reentrant;
+            Log() << "Compiling node " << DiagnosticString(node) << " with its own compiler settings" << EOL;
+            GetModule().SetCompilerParameters(parameters);
+        }
+
         _profiler.InitNode(currentFunction, node);
         _profiler.StartNode(currentFunction, node);
     }
@@ -416,6 +765,12 @@ namespace model
 
         _profiler.EndNode(currentFunction, node);
 
+        if (HasNodeCompilerSettings(node))
+        {
+            GetModule().SetCompilerParameters(_savedCompilerParameters.back());
+            _savedCompilerParameters.pop_back();
+        }
+
         auto pCurBlock = currentFunction.GetCurrentBlock();
         if (pCurBlock != currentFunction.GetCurrentRegion()->End())
         {
@@ -505,6 +860,13 @@ namespace model
     {
         Log() << "Trying to merge code regions for " << DiagnosticString(node) << EOL;
 
+        // Merging regions changes the order nodes execute in, which would invalidate the memory plan
+        if (GetMemoryPlanner() != nullptr)
+        {
+            Log() << "Not merging code regions, because memory planning is enabled" << EOL;
+            return false;
+        }
+
         auto pRegion = GetCurrentNodeBlocks().Get(node);
         if (pRegion == nullptr)
         {
@@ -558,7 +920,7 @@ namespace model
     emitters::IRBlockRegion* IRMapCompiler::GetMergeableNodeRegion(const PortElementBase& element)
     {
         const Node* pNode = nullptr;
-        if (HasSingleDescendant(element))
+        if (GetMemoryPlanner() == nullptr && HasSingleDescendant(element))
         {
             emitters::Variable* pVar = GetVariableForElement(element);
             if (pVar != nullptr && !pVar->IsLiteral())
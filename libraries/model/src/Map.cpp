@@ -53,6 +53,7 @@ namespace model
     }
 
     Map::Map(const Map& other)
+        : _metadata(other._metadata)
     {
         TransformContext context;
         ModelTransformer transformer;
@@ -187,6 +188,7 @@ namespace model
         swap(a._outputElements, b._outputElements);
         swap(a._outputNames, b._outputNames);
         swap(a._outputElementsMap, b._outputElementsMap);
+        swap(a._metadata, b._metadata);
     }
 
     std::vector<const Node*> Map::GetAllOutputNodes() const
@@ -13,15 +13,48 @@
 
 #include "Logger.h"
 
+// stl
+#include <algorithm>
+
 namespace ell
 {
 namespace model
 {
     using namespace logging;
 
+    namespace
+    {
+        // node buffers in the workspace start at the same alignment as the planned buffers
+        const size_t c_nodeBufferAlignment = 64;
+
+        size_t GetVariableTypeSize(emitters::VariableType type)
+        {
+            switch (type)
+            {
+                case emitters::VariableType::Byte:
+                    return sizeof(uint8_t);
+                case emitters::VariableType::Int32:
+                    return sizeof(int32_t);
+                case emitters::VariableType::Int64:
+                    return sizeof(int64_t);
+                case emitters::VariableType::Float:
+                    return sizeof(float);
+                case emitters::VariableType::Double:
+                    return sizeof(double);
+                default:
+                    throw emitters::EmitterException(emitters::EmitterError::variableTypeNotSupported);
+            }
+        }
+    }
+
     MapCompiler::MapCompiler(const MapCompilerParameters& settings)
         : _parameters(settings)
     {
+        if (_parameters.reentrant)
+        {
+            // Tasks are handed to threads through module globals, so a reentrant map computes everything on the calling thread
+            _parameters.compilerSettings.parallelize = false;
+        }
         PushScope();
     }
 
@@ -29,6 +62,11 @@ namespace model
     {
         auto pModuleEmitter = GetModuleEmitter();
 
+        if (_parameters.planMemory || _parameters.reentrant)
+        {
+            PlanMemory(map);
+        }
+
         emitters::NamedVariableTypeList mainFunctionArguments = AllocateNodeFunctionArguments(map, *pModuleEmitter);
         pModuleEmitter->BeginMapPredictFunction(functionName, mainFunctionArguments);
 
@@ -70,6 +108,11 @@ namespace model
         auto pModuleEmitter = GetModuleEmitter();
         assert(port.Size() != 0);
 
+        if (_memoryPlanner != nullptr && _memoryPlanner->HasAssignment(port))
+        {
+            return AllocatePlannedPortVariable(port);
+        }
+
         emitters::VariableType varType = PortTypeToVariableType(port.GetType());
         emitters::Variable* pVar = nullptr;
         bool isScalar = port.Size() == 1;
@@ -87,6 +130,88 @@ namespace model
         return pVar;
     }
 
+    void MapCompiler::PlanMemory(const Map& map)
+    {
+        Log() << "Planning memory for intermediate ports" << EOL;
+        _memoryPlanner = std::make_unique<MemoryPlanner>(map, _parameters.reentrant);
+        _plannedBuffers.clear();
+        _workspaceVariable = nullptr;
+        _workspaceInitializers.clear();
+        _workspaceSize = _memoryPlanner->GetPlannedMemorySize();
+        _nodeBuffers.clear();
+        Log() << "Planned memory for " << _memoryPlanner->NumPlannedPorts() << " ports (" << _memoryPlanner->NumInPlacePorts() << " computed in place): "
+              << _memoryPlanner->GetPlannedMemorySize() << " bytes instead of " << _memoryPlanner->GetUnplannedMemorySize() << " bytes" << EOL;
+    }
+
+    emitters::Variable* MapCompiler::AllocatePlannedPortVariable(const OutputPortBase& port)
+    {
+        auto pModuleEmitter = GetModuleEmitter();
+        const auto& assignment = _memoryPlanner->GetAssignment(port);
+        emitters::VariableType varType = PortTypeToVariableType(assignment.type);
+
+        if (_workspaceVariable != nullptr)
+        {
+            auto pVar = pModuleEmitter->Variables().AddVectorSliceVariable(varType, *_workspaceVariable, static_cast<int>(GetWorkspaceOffset(port)), static_cast<int>(assignment.size));
+            pModuleEmitter->AllocateVariable(*pVar);
+            SetVariableForPort(port, pVar);
+            return pVar;
+        }
+
+        // All the planned ports of a given type are slices of a single global buffer
+        auto& pBufferVar = _plannedBuffers[assignment.type];
+        if (pBufferVar == nullptr)
+        {
+            pBufferVar = pModuleEmitter->Variables().AddVectorVariable(emitters::VariableScope::global, varType, _memoryPlanner->GetBufferSize(assignment.type));
+            pModuleEmitter->AllocateVariable(*pBufferVar);
+        }
+
+        emitters::Variable* pVar = pModuleEmitter->Variables().AddVectorSliceVariable(varType, *pBufferVar, static_cast<int>(assignment.offset), static_cast<int>(assignment.size));
+        pModuleEmitter->AllocateVariable(*pVar);
+        SetVariableForPort(port, pVar);
+        return pVar;
+    }
+
+    size_t MapCompiler::GetWorkspaceOffset(const OutputPortBase& port) const
+    {
+        const auto& assignment = _memoryPlanner->GetAssignment(port);
+        return _memoryPlanner->GetBufferOffset(assignment.type) / MemoryPlanner::GetElementSize(assignment.type) + assignment.offset;
+    }
+
+    emitters::Variable* MapCompiler::AllocateWorkspaceArgument(emitters::ModuleEmitter& module)
+    {
+        auto workspaceSize = std::max<size_t>(1, _memoryPlanner->GetPlannedMemorySize());
+        _workspaceVariable = module.Variables().AddVectorVariable(emitters::VariableScope::input, emitters::VariableType::Byte, static_cast<int>(workspaceSize));
+        module.AllocateVariable(*_workspaceVariable);
+        return _workspaceVariable;
+    }
+
+    emitters::Variable* MapCompiler::AllocateNodeBuffer(const Node& node, const std::string& name, emitters::VariableType type, size_t size)
+    {
+        auto& pVar = _nodeBuffers[{ &node, name }];
+        if (pVar != nullptr)
+        {
+            return pVar;
+        }
+
+        auto pModuleEmitter = GetModuleEmitter();
+        if (_workspaceVariable != nullptr)
+        {
+            // Each buffer gets its own region after the planned ports, so (like a global) it keeps its contents from one call to the next
+            auto elementSize = GetVariableTypeSize(type);
+            auto offset = (_workspaceSize + c_nodeBufferAlignment - 1) / c_nodeBufferAlignment * c_nodeBufferAlignment;
+            _workspaceSize = offset + size * elementSize;
+            pVar = pModuleEmitter->Variables().AddVectorSliceVariable(type, *_workspaceVariable, static_cast<int>(offset / elementSize), static_cast<int>(size));
+        }
+        else
+        {
+            auto pBufferVar = pModuleEmitter->Variables().AddVectorVariable(emitters::VariableScope::global, type, static_cast<int>(size));
+            pModuleEmitter->AllocateVariable(*pBufferVar);
+            pVar = pModuleEmitter->Variables().AddVectorSliceVariable(type, *pBufferVar, 0, static_cast<int>(size));
+        }
+        pModuleEmitter->AllocateVariable(*pVar);
+        return pVar;
+    }
+
     emitters::Variable* MapCompiler::GetOrAllocatePortVariable(const OutputPortBase& port)
     {
         emitters::Variable* pVar = GetVariableForPort(port);
@@ -131,6 +256,13 @@ namespace model
             auto argVar = AllocateNodeFunctionArgument(module, outputElements.GetRanges()[0].ReferencedPort(), ArgType::output);
             functionArguments.push_back({ argVar->EmittedName(), GetPointerType(argVar->Type()) });
         }
+
+        // The workspace for intermediate values, if the function is reentrant
+        if (_parameters.reentrant)
+        {
+            auto workspaceVar = AllocateWorkspaceArgument(module);
+            functionArguments.push_back({ workspaceVar->EmittedName(), emitters::VariableType::BytePointer });
+        }
         return functionArguments;
     }
 
@@ -0,0 +1,290 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     MemoryPlanner.cpp (model)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "MemoryPlanner.h"
+#include "CompilableNode.h"
+#include "InputNodeBase.h"
+#include "InputPort.h"
+
+// utilities
+#include "Exception.h"
+
+// stl
+#include <algorithm>
+#include <cstdint>
+#include <unordered_set>
+
+namespace ell
+{
+namespace model
+{
+    namespace
+    {
+        bool IsPlannableType(Port::PortType type)
+        {
+            return MemoryPlanner::GetElementSize(type) != 0;
+        }
+
+        // Returns the port that is entirely consumed by the given input, or `nullptr` if the input reads
+        // anything other than exactly one whole port
+        const OutputPortBase* GetWholeInputPort(const InputPortBase& input)
+        {
+            const auto& elements = input.GetInputElements();
+            if (elements.NumRanges() != 1 || !elements.GetRanges()[0].IsFullPortRange())
+            {
+                return nullptr;
+            }
+            return elements.GetRanges()[0].ReferencedPort();
+        }
+
+        bool NodeReadsPort(const InputPortBase& input, const OutputPortBase& port)
+        {
+            for (const auto& range : input.GetInputElements().GetRanges())
+            {
+                if (range.ReferencedPort() == &port)
+                {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        bool LifetimesOverlap(int firstUse1, int lastUse1, int firstUse2, int lastUse2)
+        {
+            return firstUse1 <= lastUse2 && firstUse2 <= lastUse1;
+        }
+    }
+
+    MemoryPlanner::MemoryPlanner(const Map& map, bool includeUnsharedPorts, size_t alignment)
+    {
+        Plan(map, includeUnsharedPorts, alignment);
+        PackBuffers();
+    }
+
+    size_t MemoryPlanner::GetElementSize(Port::PortType type)
+    {
+        switch (type)
+        {
+            case Port::PortType::smallReal:
+                return sizeof(float);
+            case Port::PortType::real:
+                return sizeof(double);
+            case Port::PortType::integer:
+                return sizeof(int);
+            case Port::PortType::bigInt:
+                return sizeof(int64_t);
+            case Port::PortType::boolean:
+                return sizeof(bool);
+            default:
+                return 0;
+        }
+    }
+
+    bool MemoryPlanner::HasAssignment(const OutputPortBase& port) const
+    {
+        return _assignments.find(&port) != _assignments.end();
+    }
+
+    const PortMemoryAssignment& MemoryPlanner::GetAssignment(const OutputPortBase& port) const
+    {
+        auto iter = _assignments.find(&port);
+        if (iter == _assignments.end())
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "Port " + port.GetName() + " has no planned memory");
+        }
+        return iter->second;
+    }
+
+    size_t MemoryPlanner::GetBufferSize(Port::PortType type) const
+    {
+        auto iter = _bufferSizes.find(type);
+        return iter == _bufferSizes.end() ? 0 : iter->second;
+    }
+
+    size_t MemoryPlanner::GetBufferOffset(Port::PortType type) const
+    {
+        size_t result = 0;
+        for (const auto& bufferSize : _bufferSizes)
+        {
+            if (bufferSize.first == type)
+            {
+                break;
+            }
+            result += bufferSize.second * GetElementSize(bufferSize.first);
+        }
+        return result;
+    }
+
+    size_t MemoryPlanner::GetPlannedMemorySize() const
+    {
+        size_t result = 0;
+        for (const auto& bufferSize : _bufferSizes)
+        {
+            result += bufferSize.second * GetElementSize(bufferSize.first);
+        }
+        return result;
+    }
+
+    void MemoryPlanner::Plan(const Map& map, bool includeUnsharedPorts, size_t alignment)
+    {
+        // Ports that are bound to the arguments of the compiled function get their memory from the caller
+        std::unordered_set<const OutputPortBase*> argumentPorts;
+        for (size_t index = 0; index < map.NumInputPorts(); ++index)
+        {
+            argumentPorts.insert(&(map.GetInput(index)->GetOutputPort()));
+        }
+        for (const auto& outputElements : map.GetOutputs())
+        {
+            for (const auto& range : outputElements.GetRanges())
+            {
+                argumentPorts.insert(range.ReferencedPort());
+            }
+        }
+
+        // Number the nodes in the order they'll be compiled, and find the last node that reads each port
+        std::vector<const Node*> nodes;
+        std::unordered_map<const OutputPortBase*, int> lastUses;
+        map.GetModel().Visit([&nodes, &lastUses](const Node& node) {
+            const auto nodeIndex = static_cast<int>(nodes.size());
+            nodes.push_back(&node);
+            for (auto input : node.GetInputPorts())
+            {
+                for (const auto& range : input->GetInputElements().GetRanges())
+                {
+                    lastUses[range.ReferencedPort()] = nodeIndex;
+                }
+            }
+        });
+
+        const auto numNodes = static_cast<int>(nodes.size());
+        std::unordered_map<const OutputPortBase*, size_t> portBuffers;
+        for (int nodeIndex = 0; nodeIndex < numNodes; ++nodeIndex)
+        {
+            auto compilableNode = dynamic_cast<const CompilableNode*>(nodes[nodeIndex]);
+            if (compilableNode == nullptr)
+            {
+                continue;
+            }
+
+            for (auto port : compilableNode->GetOutputPorts())
+            {
+                const auto type = port->GetType();
+                if (port->Size() <= 1 || !IsPlannableType(type) || argumentPorts.find(port) != argumentPorts.end())
+                {
+                    continue;
+                }
+
+                const size_t alignmentElements = std::max<size_t>(1, alignment / GetElementSize(type));
+                const size_t bufferSize = ((port->Size() + alignmentElements - 1) / alignmentElements) * alignmentElements;
+                if (!compilableNode->CanReuseOutputMemory(*port))
+                {
+                    if (includeUnsharedPorts)
+                    {
+                        // The port may hold state between calls, so it's live for the whole computation
+                        portBuffers[port] = _buffers.size();
+                        _buffers.push_back({ type, bufferSize, 0, numNodes, 0 });
+                        _unplannedMemorySize += port->Size() * GetElementSize(type);
+                    }
+                    continue;
+                }
+
+                auto lastUseIter = lastUses.find(port);
+                const int lastUse = lastUseIter == lastUses.end() ? nodeIndex : lastUseIter->second;
+                _unplannedMemorySize += port->Size() * GetElementSize(type);
+
+                // If the node can overwrite its input, and that input dies here, reuse the input's buffer
+                auto inPlaceInput = compilableNode->GetInPlaceInputPort(*port);
+                auto inPlaceSource = inPlaceInput == nullptr ? nullptr : GetWholeInputPort(*inPlaceInput);
+                if (inPlaceSource != nullptr && inPlaceSource->Size() == port->Size() && inPlaceSource->GetType() == type)
+                {
+                    auto sourceBufferIter = portBuffers.find(inPlaceSource);
+                    bool isOnlyReader = true;
+                    for (auto input : compilableNode->GetInputPorts())
+                    {
+                        if (input != inPlaceInput && NodeReadsPort(*input, *inPlaceSource))
+                        {
+                            isOnlyReader = false;
+                        }
+                    }
+
+                    if (sourceBufferIter != portBuffers.end() && isOnlyReader && _buffers[sourceBufferIter->second].lastUse == nodeIndex)
+                    {
+                        const auto sourceBufferIndex = sourceBufferIter->second;
+                        _buffers[sourceBufferIndex].lastUse = lastUse;
+                        portBuffers[port] = sourceBufferIndex;
+                        ++_numInPlacePorts;
+                        continue;
+                    }
+                }
+
+                portBuffers[port] = _buffers.size();
+                _buffers.push_back({ type, bufferSize, nodeIndex, lastUse, 0 });
+            }
+        }
+
+        for (const auto& portBuffer : portBuffers)
+        {
+            PortMemoryAssignment assignment;
+            assignment.type = portBuffer.first->GetType();
+            assignment.size = portBuffer.first->Size();
+            _assignments[portBuffer.first] = assignment;
+        }
+
+        // Offsets are filled in once the buffers are packed, so keep the port-to-buffer association around until then
+        _portBuffers = std::move(portBuffers);
+    }
+
+    void MemoryPlanner::PackBuffers()
+    {
+        // Greedy-by-size: place the largest buffers first, each at the lowest offset that doesn't collide with
+        // an already-placed buffer whose lifetime overlaps it
+        std::vector<size_t> order(_buffers.size());
+        for (size_t index = 0; index < order.size(); ++index)
+        {
+            order[index] = index;
+        }
+        std::stable_sort(order.begin(), order.end(), [this](size_t a, size_t b) { return _buffers[a].size > _buffers[b].size; });
+
+        std::vector<size_t> placed;
+        for (auto bufferIndex : order)
+        {
+            auto& buffer = _buffers[bufferIndex];
+
+            std::vector<const Buffer*> conflicts;
+            for (auto placedIndex : placed)
+            {
+                const auto& other = _buffers[placedIndex];
+                if (other.type == buffer.type && LifetimesOverlap(buffer.firstUse, buffer.lastUse, other.firstUse, other.lastUse))
+                {
+                    conflicts.push_back(&other);
+                }
+            }
+            std::sort(conflicts.begin(), conflicts.end(), [](const Buffer* a, const Buffer* b) { return a->offset < b->offset; });
+
+            size_t offset = 0;
+            for (auto other : conflicts)
+            {
+                if (offset + buffer.size <= other->offset)
+                {
+                    break;
+                }
+                offset = std::max(offset, other->offset + other->size);
+            }
+
+            buffer.offset = offset;
+            _bufferSizes[buffer.type] = std::max(_bufferSizes[buffer.type], offset + buffer.size);
+            placed.push_back(bufferIndex);
+        }
+
+        for (const auto& portBuffer : _portBuffers)
+        {
+            _assignments[portBuffer.first].offset = _buffers[portBuffer.second].offset;
+        }
+    }
+}
+}
@@ -9,6 +9,7 @@
 #include "ModelTransformer.h"
 #include "InputNode.h"
 #include "Node.h"
+#include "NodeCompilerSettings.h"
 
 // utilities
 #include "Exception.h"
@@ -144,12 +145,28 @@ namespace model
     //
     // ModelTransformer implementation
     //
+    void ModelTransformer::CopyNode(const Node& node)
+    {
+        _currentNode = &node;
+        node.InvokeCopy(*this);
+    }
+
+    void ModelTransformer::PropagateNodeMetadata(Node& newNode) const
+    {
+        // Nodes created while copying or refining a node inherit the compiler settings it was given
+        if (_currentNode != nullptr && HasNodeCompilerSettings(*_currentNode) && !HasNodeCompilerSettings(newNode))
+        {
+            SetNodeCompilerSettings(newNode, GetNodeCompilerSettings(*_currentNode));
+        }
+    }
+
     Model ModelTransformer::CopyModel(const Model& oldModel, const TransformContext& context)
     {
         _context = context;
         _model = Model();
         _elementsMap.Clear();
-        oldModel.Visit([this](const Node& node) { node.InvokeCopy(*this); });
+        oldModel.Visit([this](const Node& node) { CopyNode(node); });
+        _currentNode = nullptr;
         _context = TransformContext();
 
         return std::move(_model);
@@ -160,7 +177,8 @@ namespace model
         _context = context;
         _model = Model();
         _elementsMap.Clear();
-        oldModel.VisitSubset(outputNode, [this](const Node& node) { node.InvokeCopy(*this); });
+        oldModel.VisitSubset(outputNode, [this](const Node& node) { CopyNode(node); });
+        _currentNode = nullptr;
         _context = TransformContext();
 
         return std::move(_model);
@@ -171,7 +189,8 @@ namespace model
         _context = context;
         _model = Model();
         _elementsMap.Clear();
-        oldModel.VisitSubset(outputNodes, [this](const Node& node) { node.InvokeCopy(*this); });
+        oldModel.VisitSubset(outputNodes, [this](const Node& node) { CopyNode(node); });
+        _currentNode = nullptr;
         _context = TransformContext();
 
         return std::move(_model);
@@ -205,6 +224,7 @@ namespace model
             bool didRefineAny = false;
             currentModel.Visit([this, &context, &didRefineAny](const Node& node) {
                 bool didRefineNode = false;
+                _currentNode = &node;
                 auto action = context.GetNodeAction(node);
                 // If the node action is "refine" or the default, try to refine the node, otherwise leave it alone
                 if (action == NodeAction::refine || action == NodeAction::abstain)
@@ -234,6 +254,7 @@ namespace model
         }
 
         // clear out the context
+        _currentNode = nullptr;
         _context = TransformContext();
         return std::move(_model);
     }
@@ -243,7 +264,11 @@ namespace model
         _context = context;
         _model = Model();
         _elementsMap.Clear();
-        model.Visit([this, transformFunction](const Node& node) { transformFunction(node, *this); });
+        model.Visit([this, transformFunction](const Node& node) {
+            _currentNode = &node;
+            transformFunction(node, *this);
+        });
+        _currentNode = nullptr;
         _context = TransformContext(); // reset context
         return std::move(_model);
     }
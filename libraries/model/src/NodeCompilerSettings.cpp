@@ -0,0 +1,201 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     NodeCompilerSettings.cpp (model)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "NodeCompilerSettings.h"
+#include "InputPort.h"
+#include "Map.h"
+#include "Node.h"
+#include "OutputPort.h"
+
+// utilities
+#include "Exception.h"
+
+// stl
+#include <vector>
+
+namespace ell
+{
+namespace model
+{
+    namespace
+    {
+        const std::string c_nodeSettingsPrefix = "compilerSettings.";
+
+        std::string GetMapSettingsPrefix(const std::string& nodeKey)
+        {
+            return "compilerSettings[" + nodeKey + "].";
+        }
+
+        bool HasSettings(const utilities::PropertyBag& metadata, const std::string& prefix)
+        {
+            return metadata.HasEntry(prefix + "convolutionMethod") || metadata.HasEntry(prefix + "vectorWidth") || metadata.HasEntry(prefix + "maxThreads") || metadata.HasEntry(prefix + "gemmTileSizes") || metadata.HasEntry(prefix + "inputQuantizationScale");
+        }
+
+        NodeCompilerSettings GetSettings(const utilities::PropertyBag& metadata, const std::string& prefix)
+        {
+            NodeCompilerSettings settings;
+            if (metadata.HasEntry(prefix + "convolutionMethod"))
+            {
+                settings.convolutionMethod = metadata.GetEntry<std::string>(prefix + "convolutionMethod");
+            }
+            if (metadata.HasEntry(prefix + "vectorWidth"))
+            {
+                settings.vectorWidth = metadata.GetEntry<int>(prefix + "vectorWidth");
+            }
+            if (metadata.HasEntry(prefix + "maxThreads"))
+            {
+                settings.maxThreads = metadata.GetEntry<int>(prefix + "maxThreads");
+            }
+            if (metadata.HasEntry(prefix + "gemmTileSizes"))
+            {
+                const auto& tiles = metadata.GetEntry<std::vector<int>>(prefix + "gemmTileSizes");
+                if (tiles.size() != 5)
+                {
+                    throw utilities::InputException(utilities::InputExceptionErrors::sizeMismatch, "GEMM tile sizes must have 5 entries");
+                }
+                settings.gemmTileSizes = { tiles[0], tiles[1], tiles[2], tiles[3], tiles[4] };
+            }
+            if (metadata.HasEntry(prefix + "inputQuantizationScale"))
+            {
+                settings.inputQuantizationScale = metadata.GetEntry<double>(prefix + "inputQuantizationScale");
+            }
+            return settings;
+        }
+
+        void SetSettings(utilities::PropertyBag& metadata, const std::string& prefix, const NodeCompilerSettings& settings)
+        {
+            metadata.RemoveEntry(prefix + "convolutionMethod");
+            metadata.RemoveEntry(prefix + "vectorWidth");
+            metadata.RemoveEntry(prefix + "maxThreads");
+            metadata.RemoveEntry(prefix + "gemmTileSizes");
+            metadata.RemoveEntry(prefix + "inputQuantizationScale");
+
+            if (!settings.convolutionMethod.empty())
+            {
+                metadata.SetEntry(prefix + "convolutionMethod", settings.convolutionMethod);
+            }
+            if (settings.vectorWidth > 0)
+            {
+                metadata.SetEntry(prefix + "vectorWidth", settings.vectorWidth);
+            }
+            if (settings.maxThreads > 0)
+            {
+                metadata.SetEntry(prefix + "maxThreads", settings.maxThreads);
+            }
+            const auto& tiles = settings.gemmTileSizes;
+            if (tiles.m > 0 || tiles.n > 0 || tiles.k > 0 || tiles.kernelRows > 0 || tiles.kernelColumnVectors > 0)
+            {
+                metadata.SetEntry(prefix + "gemmTileSizes", std::vector<int>{ tiles.m, tiles.n, tiles.k, tiles.kernelRows, tiles.kernelColumnVectors });
+            }
+            if (settings.inputQuantizationScale > 0)
+            {
+                metadata.SetEntry(prefix + "inputQuantizationScale", settings.inputQuantizationScale);
+            }
+        }
+    }
+
+    //
+    // NodeCompilerSettings
+    //
+    bool NodeCompilerSettings::IsEmpty() const
+    {
+        return convolutionMethod.empty() && vectorWidth <= 0 && maxThreads <= 0 && gemmTileSizes.m <= 0 && gemmTileSizes.n <= 0 && gemmTileSizes.k <= 0 && gemmTileSizes.kernelRows <= 0 && gemmTileSizes.kernelColumnVectors <= 0 && inputQuantizationScale <= 0;
+    }
+
+    void NodeCompilerSettings::Apply(emitters::CompilerParameters& parameters) const
+    {
+        if (vectorWidth > 0)
+        {
+            parameters.vectorWidth = vectorWidth;
+            parameters.allowVectorInstructions = vectorWidth > 1;
+        }
+        if (maxThreads > 0)
+        {
+            parameters.maxThreads = maxThreads;
+            parameters.parallelize = maxThreads > 1;
+        }
+
+        auto& tiles = parameters.targetDevice.gemmTileSizes;
+        tiles.m = gemmTileSizes.m > 0 ? gemmTileSizes.m : tiles.m;
+        tiles.n = gemmTileSizes.n > 0 ? gemmTileSizes.n : tiles.n;
+        tiles.k = gemmTileSizes.k > 0 ? gemmTileSizes.k : tiles.k;
+        tiles.kernelRows = gemmTileSizes.kernelRows > 0 ? gemmTileSizes.kernelRows : tiles.kernelRows;
+        tiles.kernelColumnVectors = gemmTileSizes.kernelColumnVectors > 0 ? gemmTileSizes.kernelColumnVectors : tiles.kernelColumnVectors;
+    }
+
+    //
+    // Functions
+    //
+    std::string GetNodeCompilerSettingsKey(const Node& node)
+    {
+        std::string key = node.GetRuntimeTypeName() + "(";
+        for (auto input : node.GetInputPorts())
+        {
+            key += (input == node.GetInputPorts().front() ? "" : ",") + std::to_string(input->Size());
+        }
+        key += ")->(";
+        for (auto output : node.GetOutputPorts())
+        {
+            key += (output == node.GetOutputPorts().front() ? "" : ",") + std::to_string(output->Size());
+        }
+        return key + ")";
+    }
+
+    bool HasNodeCompilerSettings(const Node& node)
+    {
+        return HasSettings(node.GetMetadata(), c_nodeSettingsPrefix);
+    }
+
+    NodeCompilerSettings GetNodeCompilerSettings(const Node& node)
+    {
+        return GetSettings(node.GetMetadata(), c_nodeSettingsPrefix);
+    }
+
+    void SetNodeCompilerSettings(Node& node, const NodeCompilerSettings& settings)
+    {
+        SetSettings(node.GetMetadata(), c_nodeSettingsPrefix, settings);
+    }
+
+    bool HasNodeCompilerSettings(const Map& map, const std::string& nodeKey)
+    {
+        return HasSettings(map.GetMetadata(), GetMapSettingsPrefix(nodeKey));
+    }
+
+    NodeCompilerSettings GetNodeCompilerSettings(const Map& map, const std::string& nodeKey)
+    {
+        return GetSettings(map.GetMetadata(), GetMapSettingsPrefix(nodeKey));
+    }
+
+    void SetNodeCompilerSettings(Map& map, const std::string& nodeKey, const NodeCompilerSettings& settings)
+    {
+        SetSettings(map.GetMetadata(), GetMapSettingsPrefix(nodeKey), settings);
+    }
+
+    void ApplyNodeCompilerSettings(Map& map)
+    {
+        std::vector<Node::NodeId> nodeIds;
+        map.GetModel().Visit([&map, &nodeIds](const Node& node) {
+            if (HasNodeCompilerSettings(map, GetNodeCompilerSettingsKey(node)))
+            {
+                nodeIds.push_back(node.GetId());
+            }
+        });
+
+        for (const auto& id : nodeIds)
+        {
+            auto node = map.GetModel().GetNode(id);
+            auto settings = GetNodeCompilerSettings(map, GetNodeCompilerSettingsKey(*node));
+            if (settings.inputQuantizationScale <= 0)
+            {
+                settings.inputQuantizationScale = GetNodeCompilerSettings(*node).inputQuantizationScale;
+            }
+            SetNodeCompilerSettings(*node, settings);
+        }
+    }
+}
+}
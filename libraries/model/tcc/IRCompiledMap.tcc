@@ -10,133 +10,168 @@ namespace ell
 {
 namespace model
 {
-    template <typename InputType>
-    void IRCompiledMap::SetComputeFunctionForInputType() const
+    template <typename InputType, typename OutputType>
+    void IRCompiledMap::Compute(const InputType* input, OutputType* output) const
     {
-        if (!_computeFunctionDefined)
+        FinishJitting();
+        if (GetInput(0)->GetOutputPort().GetType() != Port::GetPortType<InputType>() || GetOutput(0).GetPortType() != Port::GetPortType<OutputType>())
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::typeMismatch);
+        }
+
+        if (GetInput(0)->Size() == 1)
         {
-            _computeFunctionDefined = true;
-            auto outputSize = GetOutput(0).Size();
-            auto functionPointer = _executionEngine->ResolveFunctionAddress(_functionName);
-            ComputeFunction<InputType> computeFunction;
-            switch (GetOutput(0).GetPortType()) // Switch on output type
+            // scalar input
+            if (_isReentrant)
             {
-            case model::Port::PortType::boolean:
+                auto fn = reinterpret_cast<void (*)(const InputType, OutputType*, int8_t*)>(_predictFunctionAddress);
+                fn(*input, output, reinterpret_cast<int8_t*>(GetThreadState().workspace.data()));
+            }
+            else
             {
-                std::get<utilities::ConformingVector<bool>>(_cachedOutput).resize(outputSize);
-                if (GetInput(0)->Size() == 1)
-                {
-                    // scalar input
-                    auto fn = reinterpret_cast<void(*)(const InputType, bool*)>(functionPointer);
-                    computeFunction = [this, fn](const InputType* input) {
-                        fn(*input, (bool*)std::get<utilities::ConformingVector<bool>>(_cachedOutput).data());
-                    };
-                }
-                else
-                {
-                    // vector input
-                    auto fn = reinterpret_cast<void(*)(const InputType*, bool*)>(functionPointer);
-                    computeFunction = [this, fn](const InputType* input) {
-                        fn(input, (bool*)std::get<utilities::ConformingVector<bool>>(_cachedOutput).data());
-                    };
-                }
+                auto fn = reinterpret_cast<void (*)(const InputType, OutputType*)>(_predictFunctionAddress);
+                fn(*input, output);
             }
-            break;
-
-            case model::Port::PortType::integer:
+        }
+        else
+        {
+            // vector input
+            if (_isReentrant)
+            {
+                auto fn = reinterpret_cast<void (*)(const InputType*, OutputType*, int8_t*)>(_predictFunctionAddress);
+                fn(input, output, reinterpret_cast<int8_t*>(GetThreadState().workspace.data()));
+            }
+            else
             {
-                std::get<utilities::ConformingVector<int>>(_cachedOutput).resize(outputSize);
-                if (GetInput(0)->Size() == 1)
-                {
-                    // scalar input
-                    auto fn = reinterpret_cast<void(*)(const InputType, int*)>(functionPointer);
-                    computeFunction = [this, fn](const InputType* input) {
-                        fn(*input, std::get<utilities::ConformingVector<int>>(_cachedOutput).data());
-                    };
-                }
-                else
-                {
-                    // vector input
-                    auto fn = reinterpret_cast<void(*)(const InputType*, int*)>(functionPointer);
-                    computeFunction = [this, fn](const InputType* input) {
-                        fn(input, std::get<utilities::ConformingVector<int>>(_cachedOutput).data());
-                    };
-                }
+                auto fn = reinterpret_cast<void (*)(const InputType*, OutputType*)>(_predictFunctionAddress);
+                fn(input, output);
             }
-            break;
+        }
+    }
 
-            case model::Port::PortType::bigInt:
+    template <typename InputType, typename OutputType, typename DataVectorType>
+    void IRCompiledMap::ComputeSparse(const DataVectorType& input, OutputType* output) const
+    {
+        const auto inputSize = GetInput(0)->Size();
+        std::vector<InputType> pairs(inputSize, 0);
+        size_t pairIndex = 0;
+        auto iterator = data::GetIterator<DataVectorType, data::IterationPolicy::skipZeros>(input);
+        while (iterator.IsValid())
+        {
+            if (2 * pairIndex + 1 >= inputSize)
             {
-                std::get<utilities::ConformingVector<int64_t>>(_cachedOutput).resize(outputSize);
-                if (GetInput(0)->Size() == 1)
-                {
-                    // scalar input
-                    auto fn = reinterpret_cast<void(*)(const InputType, int64_t*)>(functionPointer);
-                    computeFunction = [this, fn](const InputType* input) {
-                        fn(*input, std::get<utilities::ConformingVector<int64_t>>(_cachedOutput).data());
-                    };
-                }
-                else
-                {
-                    // vector input
-                    auto fn = reinterpret_cast<void(*)(const InputType*, int64_t*)>(functionPointer);
-                    computeFunction = [this, fn](const InputType* input) {
-                        fn(input, std::get<utilities::ConformingVector<int64_t>>(_cachedOutput).data());
-                    };
-                }
+                throw utilities::InputException(utilities::InputExceptionErrors::sizeMismatch, "Sample has more nonzero entries than the map's input holds");
             }
-            break;
+            auto entry = iterator.Get();
 
-            case model::Port::PortType::smallReal:
+            // Indices are stored as InputType, so an index it can't represent exactly would read a neighboring weight
+            if (static_cast<size_t>(static_cast<InputType>(entry.index)) != entry.index)
             {
-                std::get<utilities::ConformingVector<float>>(_cachedOutput).resize(outputSize);
-                if (GetInput(0)->Size() == 1)
-                {
-                    // scalar input
-                    auto fn = reinterpret_cast<void(*)(const InputType, float*)>(functionPointer);
-                    computeFunction = [this, fn](const InputType* input) {
-                        fn(*input, std::get<utilities::ConformingVector<float>>(_cachedOutput).data());
-                    };
-                }
-                else
-                {
-                    // vector input
-                    auto fn = reinterpret_cast<void(*)(const InputType*, float*)>(functionPointer);
-                    computeFunction = [this, fn](const InputType* input) {
-                        fn(input, std::get<utilities::ConformingVector<float>>(_cachedOutput).data());
-                    };
-                }
+                throw utilities::InputException(utilities::InputExceptionErrors::indexOutOfRange, "Sample has an index that the map's input type can't represent exactly");
             }
-            break;
+            pairs[2 * pairIndex] = static_cast<InputType>(entry.index);
+            pairs[2 * pairIndex + 1] = static_cast<InputType>(entry.value);
+            ++pairIndex;
+            iterator.Next();
+        }
+        for (; 2 * pairIndex + 1 < inputSize; ++pairIndex)
+        {
+            pairs[2 * pairIndex] = static_cast<InputType>(-1);
+        }
+        Compute(pairs.data(), output);
+    }
 
-            case model::Port::PortType::real:
+    template <typename InputType, typename OutputType>
+    std::vector<OutputType> IRCompiledMap::ComputeBatch(const std::vector<InputType>& inputs) const
+    {
+        static_assert(!std::is_same<InputType, bool>::value && !std::is_same<OutputType, bool>::value, "ComputeBatch doesn't support boolean inputs or outputs");
+
+        FinishJitting();
+        if (GetInput(0)->GetOutputPort().GetType() != Port::GetPortType<InputType>() || GetOutput(0).GetPortType() != Port::GetPortType<OutputType>())
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::typeMismatch);
+        }
+
+        const auto inputSize = GetInput(0)->Size();
+        const auto outputSize = GetOutput(0).Size();
+        if (inputs.size() % inputSize != 0)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::sizeMismatch, "Batch size must be a multiple of the map's input size");
+        }
+
+        const auto count = inputs.size() / inputSize;
+        std::vector<OutputType> outputs(count * outputSize);
+        if (count == 0)
+        {
+            return outputs;
+        }
+
+        if (_predictBatchFunctionAddress != 0)
+        {
+            if (_isReentrant)
+            {
+                auto fn = reinterpret_cast<void (*)(int, const InputType*, OutputType*, int8_t*)>(_predictBatchFunctionAddress);
+                fn(static_cast<int>(count), inputs.data(), outputs.data(), reinterpret_cast<int8_t*>(GetThreadState().workspace.data()));
+            }
+            else
+            {
+                auto fn = reinterpret_cast<void (*)(int, const InputType*, OutputType*)>(_predictBatchFunctionAddress);
+                fn(static_cast<int>(count), inputs.data(), outputs.data());
+            }
+        }
+        else
+        {
+            for (size_t index = 0; index < count; ++index)
             {
-                std::get<utilities::ConformingVector<double>>(_cachedOutput).resize(outputSize);
-                if (GetInput(0)->Size() == 1)
-                {
-                    // scalar input
-                    auto fn = reinterpret_cast<void(*)(const InputType, double*)>(functionPointer);
-                    computeFunction = [this, fn](const InputType* input) {
-                        fn(*input, std::get<utilities::ConformingVector<double>>(_cachedOutput).data());
-                    };
-                }
-                else
-                {
-                    // vector input
-                    auto fn = reinterpret_cast<void(*)(const InputType*, double*)>(functionPointer);
-                    computeFunction = [this, fn](const InputType* input) {
-                        fn(input, std::get<utilities::ConformingVector<double>>(_cachedOutput).data());
-                    };
-                }
+                Compute(inputs.data() + index * inputSize, outputs.data() + index * outputSize);
             }
-            break;
+        }
+        return outputs;
+    }
+
+    template <typename InputType, typename OutputType>
+    void IRCompiledMap::ComputeCachedOutputForTypes(const InputType* input) const
+    {
+        // ConformingVector<bool> holds one-byte BoolProxy values, so its data can be written as bools
+        auto& cachedOutput = std::get<utilities::ConformingVector<OutputType>>(GetThreadState().cachedOutput);
+        cachedOutput.resize(GetOutput(0).Size());
+        Compute(input, reinterpret_cast<OutputType*>(cachedOutput.data()));
+    }
+
+    template <typename InputType>
+    void IRCompiledMap::ComputeCachedOutput(const InputType* input) const
+    {
+        switch (GetOutput(0).GetPortType()) // Switch on output type
+        {
+            case model::Port::PortType::boolean:
+                ComputeCachedOutputForTypes<InputType, bool>(input);
+                break;
+
+            case model::Port::PortType::integer:
+                ComputeCachedOutputForTypes<InputType, int>(input);
+                break;
+
+            case model::Port::PortType::bigInt:
+                ComputeCachedOutputForTypes<InputType, int64_t>(input);
+                break;
+
+            case model::Port::PortType::smallReal:
+                ComputeCachedOutputForTypes<InputType, float>(input);
+                break;
+
+            case model::Port::PortType::real:
+                ComputeCachedOutputForTypes<InputType, double>(input);
+                break;
 
             default:
                 throw utilities::InputException(utilities::InputExceptionErrors::typeMismatch);
-            }
-
-            std::get<ComputeFunction<InputType>>(_computeInputFunction) = computeFunction;
         }
     }
+
+    template <typename OutputType>
+    const utilities::ConformingVector<OutputType>& IRCompiledMap::GetCachedOutput() const
+    {
+        return std::get<utilities::ConformingVector<OutputType>>(GetThreadState().cachedOutput);
+    }
 }
 }
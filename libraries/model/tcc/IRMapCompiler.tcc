@@ -21,5 +21,33 @@ namespace model
         auto pVar = GetOrAllocatePortVariable(port, initialValue);
         return GetModule().EnsureEmitted(*pVar);
     }
+
+    template <typename ValueType>
+    void IRMapCompiler::EmitFillWorkspace(emitters::IRFunctionEmitter& function, llvm::Value* pWorkspace, const WorkspaceInitializer& initializer)
+    {
+        auto pData = function.CastPointer(pWorkspace, emitters::GetPointerType(emitters::GetVariableType<ValueType>()));
+        auto value = function.Literal(static_cast<ValueType>(initializer.value));
+        auto forLoop = function.ForLoop();
+        forLoop.Begin(static_cast<int>(initializer.offset), static_cast<int>(initializer.offset + initializer.size), 1);
+        {
+            auto i = forLoop.LoadIterationVariable();
+            function.SetValueAt(pData, i, value);
+        }
+        forLoop.End();
+    }
+
+    template <typename ValueType>
+    void IRMapCompiler::EmitCopyBatchOutput(emitters::IRFunctionEmitter& function, const PortElementsBase& output, llvm::Value* pOutputs)
+    {
+        const auto& range = output.GetRanges()[0];
+        auto pSource = function.PointerOffset(EnsureBatchPortEmitted(*range.ReferencedPort(), function), static_cast<int>(range.GetStartIndex()));
+        auto sourceStride = function.Literal(GetBatchPortStride(*range.ReferencedPort()));
+        auto outputSize = function.Literal(static_cast<int>(output.Size()));
+        function.For(_batchSize, [pSource, sourceStride, pOutputs, outputSize](emitters::IRFunctionEmitter& function, llvm::Value* sample) {
+            auto sourceOffset = function.Operator(emitters::TypedOperator::multiply, sample, sourceStride);
+            auto outputOffset = function.Operator(emitters::TypedOperator::multiply, sample, outputSize);
+            function.MemoryCopy<ValueType>(pSource, sourceOffset, pOutputs, outputOffset, outputSize);
+        });
+    }
 }
 }
@@ -16,6 +16,17 @@ namespace model
         auto pModuleEmitter = GetModuleEmitter();
         assert(port.Size() != 0);
 
+        if (_memoryPlanner != nullptr && _memoryPlanner->HasAssignment(port))
+        {
+            if (_workspaceVariable != nullptr && initialValue != 0)
+            {
+                // Unlike a global, the workspace can't be initialized statically
+                WorkspaceInitializer initializer = { PortTypeToVariableType(port.GetType()), GetWorkspaceOffset(port), port.Size(), static_cast<double>(initialValue) };
+                _workspaceInitializers.push_back(initializer);
+            }
+            return AllocatePlannedPortVariable(port);
+        }
+
         emitters::VariableType varType = PortTypeToVariableType(port.GetType());
         emitters::Variable* pVar = nullptr;
         const bool isScalar = port.Size() == 1;
@@ -53,7 +64,7 @@ namespace model
         emitters::Variable* pVar = GetVariableForPort(port);
         if (pVar == nullptr)
         {
-            pVar = AllocatePortVariable(port);
+            pVar = AllocatePortVariable(port, initialValue);
         }
         assert(pVar != nullptr);
         return pVar;
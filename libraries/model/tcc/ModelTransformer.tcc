@@ -72,6 +72,7 @@ namespace model
     NodeType* ModelTransformer::AddNode(Args&&... args)
     {
         auto newNode = _model.AddNode<NodeType>(std::forward<Args>(args)...);
+        PropagateNodeMetadata(*newNode);
         _isModelCompilable &= _context.IsNodeCompilable(*newNode);
         return newNode;
     }
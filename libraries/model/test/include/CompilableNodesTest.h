@@ -8,6 +8,9 @@
 
 #pragma once
 
+// model
+#include <MapCompiler.h>
+
 // predictors
 #include <Layer.h>
 
@@ -21,8 +24,11 @@ void TestCompilableAccumulatorNode();
 void TestCompilableConstantNode();
 void TestCompilableDotProductNode();
 void TestCompilableDelayNode();
+void TestCompilableBufferNode();
 void TestCompilableDTWDistanceNode();
+void TestCompilableForestPredictorNode(ell::model::ForestEvaluation evaluation);
 void TestCompilableMulticlassDTW();
+void TestCompilableSparseLinearPredictorNode();
 void TestCompilableScalarSumNode();
 void TestCompilableSumNode();
 void TestCompilableUnaryOperationNode();
@@ -30,6 +36,15 @@ void TestCompilableUnaryOperation_square_Node();
 void TestL2NormSquaredNodeCompiled();
 void TestMatrixVectorProductNodeCompile();
 void TestCompilableBinaryOperationNode();
+void TestCompilableMemoryPlanner();
+void TestCompilableReentrantMap();
+void TestCompilablePredictBatch();
+void TestCompilablePredictBatchMatrixProducts();
+void TestCompilableConcurrentCompute();
+void TestCompilableConcurrentParallelCompute();
+void TestCompilableReentrantParallelFor();
+void TestCompilableSequentialThreadState();
+void TestCompilableReentrantNodeState();
 void TestCompilableScalarBinaryPredicateNode();
 void TestCompilableBinaryPredicateNode();
 void TestCompilableMultiplexerNode();
@@ -45,7 +60,7 @@ void TestCompilableDotProductNode2(int dimension);
 void TestFloatNode();
 void TestMultipleOutputNodes();
 void TestCompilableClockNode();
-void TestCompilableFFTNode();
+void TestCompilableFFTNode(size_t N);
 
 //
 // mathy nodes
@@ -66,7 +81,8 @@ void TestNeuralNetworkPredictorNode6();
 enum class ConvolutionType
 {
     GEMM,
-    Diagonal
+    Diagonal,
+    Winograd
 };
 
 void TestInputLayerNode(size_t outputPadding = 0);
@@ -79,12 +95,19 @@ void TestBiasLayerNode(size_t inputPadding = 0, size_t outputPadding = 0);
 void TestBinaryConvolutionalLayerNode(size_t imageRows, size_t imageColumns, size_t numChannels, size_t numFilters, size_t inputPadding = 1, size_t outputPadding = 0, ell::predictors::neural::PaddingScheme = ell::predictors::neural::PaddingScheme::zeros, bool scaleByFilterMeans = true);
 void TestConvolutionalLayerNode(ConvolutionType convolutionType, size_t inputPadding = 1, size_t outputPadding = 0);
 void TestConvolutionalLayerNode2(ConvolutionType convolutionType, size_t inputPadding = 1, size_t outputPadding = 0);
+void TestStackedWinogradConvolutionalLayerNodes();
+void TestGroupedConvolutionalLayerNode(size_t numChannels, size_t numFilters, size_t numGroups, size_t stride = 1);
 void TestFullyConnectedLayerNode(size_t inputPadding = 0, size_t outputPadding = 0);
+void TestQuantizedLayerNodes();
+void TestHalfPrecisionWeights();
 void TestMaxPoolingLayerNode(size_t inRows, size_t inCols, size_t numChannels, size_t outRows, size_t outCols, size_t poolingSize, size_t poolingStride, size_t inputPadding = 0, size_t outputPadding = 0);
 void TestMeanPoolingLayerNode(size_t inRows, size_t inCols, size_t numChannels, size_t outRows, size_t outCols, size_t poolingSize, size_t poolingStride, size_t inputPadding = 0, size_t outputPadding = 0);
+void TestParallelPoolingLayerNode(size_t inRows, size_t inCols, size_t numChannels, size_t outRows, size_t outCols, size_t poolingSize, size_t poolingStride, size_t inputPadding = 0, size_t outputPadding = 0);
 void TestScalingLayerNode(size_t inputPadding = 0, size_t outputPadding = 0);
 void TestSoftmaxLayerNode(size_t inputPadding = 0, size_t outputPadding = 0);
 void TestFusedLinearLayerNodes(size_t rows, size_t columns, size_t channels);
+void TestFusedConvolutionalLayerNodes(size_t rows, size_t columns, size_t channels, size_t numFilters);
+void TestFusedConvolutionalPoolingLayerNodes(size_t rows, size_t columns, size_t channels, size_t numFilters);
 void TestRecurrentNode();
 void TestGRUNode();
 void TestLSTMNode();
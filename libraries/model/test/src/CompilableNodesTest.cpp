@@ -13,6 +13,9 @@
 // common
 #include "LoadModel.h" // for RegisterNodeTypes
 
+// data
+#include "SparseDataVector.h"
+
 // math
 #include "MathConstants.h"
 #include "Tensor.h"
@@ -27,6 +30,7 @@
 #include "IRMapCompiler.h"
 #include "InputNode.h"
 #include "Model.h"
+#include "NodeCompilerSettings.h"
 #include "OutputNode.h"
 #include "PortMemoryLayout.h"
 
@@ -37,15 +41,21 @@
 #include "BiasLayerNode.h"
 #include "BinaryOperationNode.h"
 #include "BinaryPredicateNode.h"
+#include "BroadcastFunctionNode.h"
+#include "BufferNode.h"
 #include "ClockNode.h"
+#include "CompiledActivationFunctions.h"
 #include "ConstantNode.h"
 #include "DTWDistanceNode.h"
 #include "DelayNode.h"
+#include "DiagonalConvolutionNode.h"
 #include "DotProductNode.h"
 #include "ExtremalValueNode.h"
 #include "FFTNode.h"
+#include "ForestPredictorNode.h"
 #include "FullyConnectedLayerNode.h"
 #include "GRULayerNode.h"
+#include "GroupedConvolutionNode.h"
 #include "IRNode.h"
 #include "L2NormSquaredNode.h"
 #include "LSTMLayerNode.h"
@@ -55,15 +65,18 @@
 #include "MultiplexerNode.h"
 #include "NeuralNetworkPredictorNode.h"
 #include "PoolingLayerNode.h"
+#include "QuantizedMatrixMultiplyNode.h"
 #include "ReceptiveFieldMatrixNode.h"
 #include "RecurrentLayerNode.h"
 #include "ReorderDataNode.h"
 #include "SinkNode.h"
 #include "SoftmaxLayerNode.h"
 #include "SourceNode.h"
+#include "SparseLinearPredictorNode.h"
 #include "SumNode.h"
 #include "TypeCastNode.h"
 #include "UnaryOperationNode.h"
+#include "WinogradConvolutionNode.h"
 
 // predictors
 #include "NeuralNetworkPredictor.h"
@@ -97,8 +110,11 @@
 #include <algorithm>
 #include <iostream>
 #include <ostream>
+#include <random>
 #include <sstream>
 #include <string>
+#include <thread>
+#include <vector>
 
 using namespace ell;
 using namespace ell::predictors;
@@ -320,6 +336,41 @@ void TestCompilableDelayNode()
     VerifyCompiledOutput(map, compiledMap, signal, "DelayNode");
 }
 
+void TestCompilableBufferNode()
+{
+    // The input size doesn't divide the window size, so the head wraps around at different places
+    const int inputSize = 3;
+    const int windowSize = 8;
+    std::vector<std::vector<float>> signal = { { 1, 2, 3 }, { 4, 5, 6 }, { 7, 8, 9 }, { 3, 4, 5 }, { 2, 3, 2 }, { 1, 5, 3 }, { 1, 2, 3 }, { 4, 5, 6 }, { 7, 8, 9 }, { 7, 4, 2 }, { 5, 2, 1 } };
+
+    // The window is a map output, so it's copied to the output
+    {
+        model::Model model;
+        auto inputNode = model.AddNode<model::InputNode<float>>(inputSize);
+        auto bufferNode = model.AddNode<nodes::BufferNode<float>>(inputNode->output, windowSize);
+        auto map = model::Map(model, { { "input", inputNode } }, { { "output", bufferNode->output } });
+        model::IRMapCompiler compiler;
+        auto compiledMap = compiler.Compile(map);
+
+        testing::ProcessTest("Testing BufferNode window is copied to a map output", !bufferNode->IsWindowReadInPlace());
+        VerifyCompiledOutput(map, compiledMap, signal, "BufferNode");
+    }
+
+    // The FFT reads the window in place, from the circular buffer
+    {
+        model::Model model;
+        auto inputNode = model.AddNode<model::InputNode<float>>(inputSize);
+        auto bufferNode = model.AddNode<nodes::BufferNode<float>>(inputNode->output, windowSize);
+        auto fftNode = model.AddNode<nodes::FFTNode<float>>(bufferNode->output);
+        auto map = model::Map(model, { { "input", inputNode } }, { { "output", fftNode->output } });
+        model::IRMapCompiler compiler;
+        auto compiledMap = compiler.Compile(map);
+
+        testing::ProcessTest("Testing BufferNode window is read in place", bufferNode->IsWindowReadInPlace());
+        VerifyCompiledOutput(map, compiledMap, signal, "BufferNode read in place");
+    }
+}
+
 void TestCompilableDTWDistanceNode()
 {
     model::Model model;
@@ -335,6 +386,142 @@ void TestCompilableDTWDistanceNode()
     VerifyCompiledOutput(map, compiledMap, signal, "DTWDistanceNode");
 }
 
+void TestCompilableForestPredictorNode(model::ForestEvaluation evaluation)
+{
+    using SplitAction = predictors::SimpleForestPredictor::SplitAction;
+    using SplitRule = predictors::SingleElementThresholdPredictor;
+    using EdgePredictorVector = std::vector<predictors::ConstantPredictor>;
+
+    // Two trees of different depths
+    predictors::SimpleForestPredictor forest;
+    auto root = forest.Split(SplitAction{ forest.GetNewRootId(), SplitRule{ 0, 0.3 }, EdgePredictorVector{ -1.0, 1.0 } });
+    auto child1 = forest.Split(SplitAction{ forest.GetChildId(root, 0), SplitRule{ 1, 0.6 }, EdgePredictorVector{ -2.0, 2.0 } });
+    forest.Split(SplitAction{ forest.GetChildId(child1, 0), SplitRule{ 1, 0.4 }, EdgePredictorVector{ -2.1, 2.1 } });
+    forest.Split(SplitAction{ forest.GetChildId(child1, 1), SplitRule{ 1, 0.7 }, EdgePredictorVector{ -2.2, 2.2 } });
+    forest.Split(SplitAction{ forest.GetChildId(root, 1), SplitRule{ 2, 0.9 }, EdgePredictorVector{ -4.0, 4.0 } });
+    auto root2 = forest.Split(SplitAction{ forest.GetNewRootId(), SplitRule{ 0, 0.2 }, EdgePredictorVector{ -3.0, 3.0 } });
+    forest.Split(SplitAction{ forest.GetChildId(root2, 1), SplitRule{ 1, 0.22 }, EdgePredictorVector{ -3.2, 3.2 } });
+    forest.AddToBias(0.5);
+
+    std::vector<std::vector<double>> signal = { { 0.2, 0.5, 0.0 }, { 0.1, 0.1, 0.1 }, { 0.25, 0.65, 0.3 }, { 0.25, 0.8, 0.95 }, { 0.9, 0.3, 0.95 }, { 0.5, 0.5, 0.5 }, { 0.3, 0.6, 0.9 } };
+    model::MapCompilerParameters settings;
+    settings.forestEvaluation = evaluation;
+    const std::string name = evaluation == model::ForestEvaluation::quickScorer ? "ForestPredictorNode (QuickScorer)" : "ForestPredictorNode";
+
+    model::Model model;
+    auto inputNode = model.AddNode<model::InputNode<double>>(3);
+    auto forestNode = model.AddNode<nodes::SimpleForestPredictorNode>(inputNode->output, forest);
+    {
+        auto map = model::Map(model, { { "input", inputNode } }, { { "output", forestNode->output } });
+        model::IRMapCompiler compiler(settings);
+        auto compiledMap = compiler.Compile(map);
+        VerifyCompiledOutput(map, compiledMap, signal, name);
+    }
+    {
+        auto map = model::Map(model, { { "input", inputNode } }, { { "output", forestNode->treeOutputs } });
+        model::IRMapCompiler compiler(settings);
+        auto compiledMap = compiler.Compile(map);
+        VerifyCompiledOutput(map, compiledMap, signal, name + " tree outputs");
+    }
+    {
+        auto map = model::Map(model, { { "input", inputNode } }, { { "output", forestNode->edgeIndicatorVector } });
+        model::IRMapCompiler compiler(settings);
+        auto compiledMap = compiler.Compile(map);
+        bool ok = true;
+        for (const auto& input : signal)
+        {
+            map.SetInputValue(0, input);
+            compiledMap.SetInputValue(0, input);
+            ok = ok && testing::IsEqual(map.ComputeOutput<bool>(0), compiledMap.ComputeOutput<bool>(0));
+        }
+        testing::ProcessTest("Testing " + name + " edge indicator vector", ok);
+    }
+}
+
+void TestCompilableSparseLinearPredictorNode()
+{
+    // A hashed-feature-sized predictor, with a few nonzero features per sample
+    const size_t numWeights = 1 << 20;
+    const size_t maxNonZeros = 16;
+    auto engine = utilities::GetRandomEngine("123");
+    std::uniform_real_distribution<double> valueDistribution(-1, 1);
+    std::uniform_int_distribution<size_t> indexDistribution(0, numWeights / maxNonZeros - 1);
+
+    math::ColumnVector<double> weights(numWeights);
+    weights.Generate([&]() { return valueDistribution(engine); });
+    predictors::LinearPredictor<double> predictor(weights, 0.25);
+
+    model::Model model;
+    auto inputNode = model.AddNode<model::InputNode<double>>(2 * maxNonZeros);
+    auto predictorNode = model.AddNode<nodes::SparseLinearPredictorNode<double>>(inputNode->output, predictor);
+    auto map = model::Map(model, { { "input", inputNode } }, { { "output", predictorNode->output } });
+    model::IRMapCompiler compiler;
+    auto compiledMap = compiler.Compile(map);
+
+    // Pairs with padding and out-of-range indices
+    std::vector<std::vector<double>> signal;
+    for (size_t sampleIndex = 0; sampleIndex < 4; ++sampleIndex)
+    {
+        std::vector<double> pairs(2 * maxNonZeros, -1);
+        for (size_t pairIndex = 0; pairIndex < maxNonZeros - sampleIndex; ++pairIndex)
+        {
+            pairs[2 * pairIndex] = static_cast<double>(indexDistribution(engine));
+            pairs[2 * pairIndex + 1] = valueDistribution(engine);
+        }
+        pairs[0] = static_cast<double>(numWeights + sampleIndex);
+        signal.push_back(pairs);
+    }
+    VerifyCompiledOutput(map, compiledMap, signal, "SparseLinearPredictorNode");
+
+    // Sparse data vectors, compared with the dense dot product
+    bool ok = true;
+    for (size_t numNonZeros : { size_t(0), size_t(1), size_t(7), maxNonZeros })
+    {
+        data::SparseDoubleDataVector sample;
+        auto expected = predictor.GetBias();
+        for (size_t entryIndex = 0; entryIndex < numNonZeros; ++entryIndex)
+        {
+            // Keep the indices increasing
+            auto index = entryIndex * (numWeights / maxNonZeros) + indexDistribution(engine);
+            auto value = valueDistribution(engine);
+            sample.AppendElement(index, value);
+            expected += weights[index] * value;
+        }
+        double output = 0;
+        compiledMap.ComputeSparse<double>(sample, &output);
+        ok = ok && testing::IsEqual(output, expected, 1e-10);
+    }
+    testing::ProcessTest("Testing SparseLinearPredictorNode with sparse data vectors", ok);
+
+    // Indices above 2^24, which a double holds exactly and a float doesn't
+    const size_t largeIndex = (size_t(1) << 24) + 1;
+    data::SparseDoubleDataVector largeIndexSample;
+    largeIndexSample.AppendElement(3, 0.5);
+    largeIndexSample.AppendElement(largeIndex, 1.0);
+    double doubleOutput = 0;
+    compiledMap.ComputeSparse<double>(largeIndexSample, &doubleOutput);
+
+    math::ColumnVector<float> floatWeights(64);
+    floatWeights.Fill(1);
+    model::Model floatModel;
+    auto floatInputNode = floatModel.AddNode<model::InputNode<float>>(2 * maxNonZeros);
+    auto floatPredictorNode = floatModel.AddNode<nodes::SparseLinearPredictorNode<float>>(floatInputNode->output, predictors::LinearPredictor<float>(floatWeights, 0));
+    auto floatMap = model::Map(floatModel, { { "input", floatInputNode } }, { { "output", floatPredictorNode->output } });
+    model::IRMapCompiler floatCompiler;
+    auto floatCompiledMap = floatCompiler.Compile(floatMap);
+    bool threw = false;
+    try
+    {
+        float floatOutput = 0;
+        floatCompiledMap.ComputeSparse<float>(largeIndexSample, &floatOutput);
+    }
+    catch (const utilities::InputException&)
+    {
+        threw = true;
+    }
+    testing::ProcessTest("Testing SparseLinearPredictorNode with indices above 2^24", testing::IsEqual(doubleOutput, predictor.GetBias() + 0.5 * weights[3], 1e-10) && threw);
+}
+
 class LabeledPrototype
 {
 public:
@@ -518,6 +705,447 @@ void TestCompilableBinaryOperationNode()
     VerifyCompiledOutput(map, compiledMap, signal, "BinaryOperationNode");
 }
 
+void TestCompilableMemoryPlanner()
+{
+    // input -> exp -> add(constant) -> sqrt -> multiply(exp) -> output
+    model::Model model;
+    auto inputNode = model.AddNode<model::InputNode<double>>(8);
+    auto constantNode = model.AddNode<nodes::ConstantNode<double>>(std::vector<double>{ 1, 2, 3, 4, 5, 6, 7, 8 });
+    auto expNode = model.AddNode<nodes::UnaryOperationNode<double>>(inputNode->output, emitters::UnaryOperationType::exp);
+    auto addNode = model.AddNode<nodes::BinaryOperationNode<double>>(expNode->output, constantNode->output, emitters::BinaryOperationType::add);
+    auto sqrtNode = model.AddNode<nodes::UnaryOperationNode<double>>(addNode->output, emitters::UnaryOperationType::sqrt);
+    auto multiplyNode = model.AddNode<nodes::BinaryOperationNode<double>>(sqrtNode->output, expNode->output, emitters::BinaryOperationType::coordinatewiseMultiply);
+    auto map = model::Map(model, { { "input", inputNode } }, { { "output", multiplyNode->output } });
+
+    model::MapCompilerParameters settings;
+    settings.planMemory = true;
+    model::IRMapCompiler compiler(settings);
+    auto compiledMap = compiler.Compile(map);
+
+    // The exp output is live until the final multiply, so the add can't overwrite it, but the sqrt can overwrite the add's output
+    auto memoryPlanner = compiler.GetMemoryPlanner();
+    testing::ProcessTest("Testing MemoryPlanner planned ports", memoryPlanner != nullptr && memoryPlanner->NumPlannedPorts() == 3 && memoryPlanner->NumInPlacePorts() == 1);
+    testing::ProcessTest("Testing MemoryPlanner memory size", memoryPlanner != nullptr && memoryPlanner->GetPlannedMemorySize() == 2 * 8 * sizeof(double) && memoryPlanner->GetUnplannedMemorySize() == 3 * 8 * sizeof(double));
+
+    // compare output
+    std::vector<std::vector<double>> signal = { { 1, 2, 3, 4, 5, 6, 7, 8 }, { 0, 0, 0, 0, 0, 0, 0, 0 }, { -1, 2, -3, 4, -5, 6, -7, 8 }, { 0.5, 0.25, 0.125, 1, 2, 3, 4, 5 } };
+    VerifyCompiledOutput(map, compiledMap, signal, "MemoryPlanner");
+}
+
+void TestCompilableReentrantMap()
+{
+    // input -> reorder (with padding) -> sqrt -> add(constant) -> output
+    model::Model model;
+    auto inputNode = model.AddNode<model::InputNode<double>>(6);
+    model::PortMemoryLayout inputLayout({ 2, 3 });
+    model::PortMemoryLayout paddedLayout({ 2, 3 }, { 4, 5 }, { 1, 1 });
+    auto reorderNode = model.AddNode<nodes::ReorderDataNode<double>>(inputNode->output, inputLayout, paddedLayout, 1.0);
+    auto sqrtNode = model.AddNode<nodes::UnaryOperationNode<double>>(reorderNode->output, emitters::UnaryOperationType::sqrt);
+    auto constantNode = model.AddNode<nodes::ConstantNode<double>>(std::vector<double>(20, 0.5));
+    auto addNode = model.AddNode<nodes::BinaryOperationNode<double>>(sqrtNode->output, constantNode->output, emitters::BinaryOperationType::add);
+    auto map = model::Map(model, { { "input", inputNode } }, { { "output", addNode->output } });
+
+    model::MapCompilerParameters settings;
+    settings.moduleName = "TestReentrant";
+    settings.reentrant = true;
+    model::IRMapCompiler compiler(settings);
+    auto compiledMap = compiler.Compile(map);
+
+    // The padded reorder output can't be shared, but it still lives in the workspace
+    auto memoryPlanner = compiler.GetMemoryPlanner();
+    testing::ProcessTest("Testing reentrant map workspace", memoryPlanner != nullptr && memoryPlanner->HasAssignment(reorderNode->output) && memoryPlanner->GetPlannedMemorySize() >= 2 * 20 * sizeof(double));
+
+    auto header = compiledMap.GetCodeHeaderString();
+    bool hasWorkspaceFunctions = header.find("TestReentrant_GetWorkspaceSize") != std::string::npos && header.find("TestReentrant_AllocateWorkspace") != std::string::npos && header.find("TestReentrant_FreeWorkspace") != std::string::npos;
+    testing::ProcessTest("Testing reentrant map header", hasWorkspaceFunctions);
+
+    // compare output
+    std::vector<std::vector<double>> signal = { { 1, 2, 3, 4, 5, 6 }, { 0, 0, 0, 0, 0, 0 }, { 9, 16, 25, 36, 49, 64 } };
+    VerifyCompiledOutput(map, compiledMap, signal, "ReentrantMap");
+}
+
+void TestCompilablePredictBatch()
+{
+    // input -> exp -> add(constant) -> sqrt -> output
+    model::Model model;
+    auto inputNode = model.AddNode<model::InputNode<double>>(4);
+    auto constantNode = model.AddNode<nodes::ConstantNode<double>>(std::vector<double>{ 1, 2, 3, 4 });
+    auto expNode = model.AddNode<nodes::UnaryOperationNode<double>>(inputNode->output, emitters::UnaryOperationType::exp);
+    auto addNode = model.AddNode<nodes::BinaryOperationNode<double>>(expNode->output, constantNode->output, emitters::BinaryOperationType::add);
+    auto sqrtNode = model.AddNode<nodes::UnaryOperationNode<double>>(addNode->output, emitters::UnaryOperationType::sqrt);
+    auto map = model::Map(model, { { "input", inputNode } }, { { "output", sqrtNode->output } });
+
+    std::vector<std::vector<double>> signal = { { 1, 2, 3, 4 }, { 0, 0, 0, 0 }, { -1, 2, -3, 4 }, { 0.5, 0.25, 0.125, 1 } };
+    std::vector<double> batchInput;
+    std::vector<double> expectedOutput;
+    for (const auto& sample : signal)
+    {
+        batchInput.insert(batchInput.end(), sample.begin(), sample.end());
+        auto output = map.Compute<double>(sample);
+        expectedOutput.insert(expectedOutput.end(), output.begin(), output.end());
+    }
+
+    for (auto reentrant : { false, true })
+    {
+        model::MapCompilerParameters settings;
+        settings.moduleName = "TestPredictBatch";
+        settings.emitPredictBatch = true;
+        settings.reentrant = reentrant;
+        model::IRMapCompiler compiler(settings);
+        auto compiledMap = compiler.Compile(map);
+
+        auto header = compiledMap.GetCodeHeaderString();
+        testing::ProcessTest("Testing predict_batch declared in header", header.find(settings.mapFunctionName + "_batch") != std::string::npos);
+
+        auto batchOutput = compiledMap.ComputeBatch<double>(batchInput);
+        testing::ProcessTest(std::string("Testing compiled predict_batch") + (reentrant ? " (reentrant)" : ""), testing::IsEqual(batchOutput, expectedOutput));
+    }
+
+    // Without a batched predict function, ComputeBatch falls back to calling predict once per sample
+    model::IRMapCompiler compiler;
+    auto compiledMap = compiler.Compile(map);
+    testing::ProcessTest("Testing ComputeBatch without predict_batch", testing::IsEqual(compiledMap.ComputeBatch<double>(batchInput), expectedOutput));
+}
+
+void TestCompilablePredictBatchMatrixProducts()
+{
+    // input (3 x 4 matrix) -> matrix-matrix multiply (constant 2 x 3) -> tanh -> matrix-vector multiply (constant 5 x 8) -> add(constant) -> output
+    const int m = 2, n = 4, k = 3;
+    const int numOutputs = 5;
+    auto makeValues = [](int size, double scale) {
+        std::vector<double> values(size);
+        for (int index = 0; index < size; ++index)
+        {
+            values[index] = scale * std::sin(1.0 + 0.7 * index);
+        }
+        return values;
+    };
+
+    model::Model model;
+    auto inputNode = model.AddNode<model::InputNode<double>>(k * n);
+    auto matrixNode = model.AddNode<nodes::ConstantNode<double>>(makeValues(m * k, 1.0));
+    auto matrixProductNode = model.AddNode<nodes::MatrixMatrixMultiplyNode<double>>(matrixNode->output, m, n, k, k, inputNode->output, n, n);
+    auto tanhNode = model.AddNode<nodes::UnaryOperationNode<double>>(matrixProductNode->output, emitters::UnaryOperationType::tanh);
+    auto weightsNode = model.AddNode<nodes::ConstantNode<double>>(makeValues(numOutputs * m * n, 0.5));
+    auto vectorProductNode = model.AddNode<nodes::MatrixVectorMultiplyNode<double>>(weightsNode->output, numOutputs, m * n, m * n, tanhNode->output);
+    auto biasNode = model.AddNode<nodes::ConstantNode<double>>(makeValues(numOutputs, 0.25));
+    auto addNode = model.AddNode<nodes::BinaryOperationNode<double>>(vectorProductNode->output, biasNode->output, emitters::BinaryOperationType::add);
+    auto map = model::Map(model, { { "input", inputNode } }, { { "output", addNode->output } });
+
+    // 19 samples: whole tiles of 4 or 16, plus a remainder that runs through predict
+    const int numSamples = 19;
+    std::vector<std::vector<double>> signal;
+    std::vector<double> batchInput;
+    for (int sample = 0; sample < numSamples; ++sample)
+    {
+        auto values = makeValues(k * n, 1.0 + sample);
+        signal.push_back(values);
+        batchInput.insert(batchInput.end(), values.begin(), values.end());
+    }
+
+    for (auto batchSize : { 4, 16 })
+    {
+        model::MapCompilerParameters settings;
+        settings.moduleName = "TestPredictBatchMatrixProducts";
+        settings.emitPredictBatch = true;
+        settings.predictBatchSize = batchSize;
+        model::IRMapCompiler compiler(settings);
+        auto compiledMap = compiler.Compile(map);
+
+        std::vector<double> expectedOutput;
+        for (const auto& sample : signal)
+        {
+            auto output = compiledMap.Compute<double>(sample);
+            expectedOutput.insert(expectedOutput.end(), output.begin(), output.end());
+        }
+
+        auto batchOutput = compiledMap.ComputeBatch<double>(batchInput);
+        testing::ProcessTest("Testing predict_batch with matrix products, in tiles of " + std::to_string(batchSize), testing::IsEqual(batchOutput, expectedOutput, 1e-10));
+    }
+}
+
+void TestCompilableConcurrentCompute()
+{
+    // input -> exp -> add(constant) -> sqrt -> multiply(exp) -> output
+    model::Model model;
+    auto inputNode = model.AddNode<model::InputNode<double>>(8);
+    auto constantNode = model.AddNode<nodes::ConstantNode<double>>(std::vector<double>{ 1, 2, 3, 4, 5, 6, 7, 8 });
+    auto expNode = model.AddNode<nodes::UnaryOperationNode<double>>(inputNode->output, emitters::UnaryOperationType::exp);
+    auto addNode = model.AddNode<nodes::BinaryOperationNode<double>>(expNode->output, constantNode->output, emitters::BinaryOperationType::add);
+    auto sqrtNode = model.AddNode<nodes::UnaryOperationNode<double>>(addNode->output, emitters::UnaryOperationType::sqrt);
+    auto multiplyNode = model.AddNode<nodes::BinaryOperationNode<double>>(sqrtNode->output, expNode->output, emitters::BinaryOperationType::coordinatewiseMultiply);
+    auto map = model::Map(model, { { "input", inputNode } }, { { "output", multiplyNode->output } });
+
+    model::MapCompilerParameters settings;
+    settings.reentrant = true;
+    model::IRMapCompiler compiler(settings);
+    auto compiledMap = compiler.Compile(map);
+
+    // Each thread runs its own inputs through the shared compiled map, alternating between the zero-copy
+    // and the vector versions of Compute
+    const int numThreads = 8;
+    const int numIterations = 200;
+    std::vector<std::vector<double>> inputs;
+    std::vector<std::vector<double>> expectedOutputs;
+    for (int threadIndex = 0; threadIndex < numThreads; ++threadIndex)
+    {
+        std::vector<double> input(8);
+        for (size_t index = 0; index < input.size(); ++index)
+        {
+            input[index] = 0.25 * threadIndex - 0.125 * index;
+        }
+        inputs.push_back(input);
+        expectedOutputs.push_back(map.Compute<double>(input));
+    }
+
+    std::vector<int> numFailures(numThreads, 0);
+    std::vector<std::thread> threads;
+    for (int threadIndex = 0; threadIndex < numThreads; ++threadIndex)
+    {
+        threads.emplace_back([&, threadIndex]() {
+            const auto& input = inputs[threadIndex];
+            const auto& expectedOutput = expectedOutputs[threadIndex];
+            std::vector<double> output(expectedOutput.size());
+            for (int iteration = 0; iteration < numIterations; ++iteration)
+            {
+                if (iteration % 2 == 0)
+                {
+                    compiledMap.Compute(input.data(), output.data());
+                }
+                else
+                {
+                    output = compiledMap.Compute<double>(input);
+                }
+
+                if (!testing::IsEqual(output, expectedOutput))
+                {
+                    ++numFailures[threadIndex];
+                }
+            }
+        });
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    testing::ProcessTest("Testing concurrent calls to IRCompiledMap::Compute", std::all_of(numFailures.begin(), numFailures.end(), [](int failures) { return failures == 0; }));
+}
+
+void TestCompilableConcurrentParallelCompute()
+{
+    // input -> exp -> add(constant) -> multiply(input) -> output, with enough elements that the nodes would be split into tasks
+    const int size = 32768;
+    std::vector<double> constantValues(size);
+    for (int index = 0; index < size; ++index)
+    {
+        constantValues[index] = 0.001 * index;
+    }
+
+    model::Model model;
+    auto inputNode = model.AddNode<model::InputNode<double>>(size);
+    auto constantNode = model.AddNode<nodes::ConstantNode<double>>(constantValues);
+    auto expNode = model.AddNode<nodes::UnaryOperationNode<double>>(inputNode->output, emitters::UnaryOperationType::exp);
+    auto addNode = model.AddNode<nodes::BinaryOperationNode<double>>(expNode->output, constantNode->output, emitters::BinaryOperationType::add);
+    auto multiplyNode = model.AddNode<nodes::BinaryOperationNode<double>>(addNode->output, inputNode->output, emitters::BinaryOperationType::coordinatewiseMultiply);
+    auto map = model::Map(model, { { "input", inputNode } }, { { "output", multiplyNode->output } });
+
+    // Reentrant maps don't use the thread pool, whose task storage is shared by every caller
+    model::MapCompilerParameters settings;
+    settings.reentrant = true;
+    settings.compilerSettings.parallelize = true;
+    settings.compilerSettings.useThreadPool = true;
+    settings.compilerSettings.maxThreads = 4;
+    model::IRMapCompiler compiler(settings);
+    auto compiledMap = compiler.Compile(map);
+
+    const int numThreads = 8;
+    const int numIterations = 50;
+    std::vector<std::vector<double>> inputs;
+    std::vector<std::vector<double>> expectedOutputs;
+    for (int threadIndex = 0; threadIndex < numThreads; ++threadIndex)
+    {
+        std::vector<double> input(size);
+        for (int index = 0; index < size; ++index)
+        {
+            input[index] = 0.25 * threadIndex - 0.0001 * index;
+        }
+        inputs.push_back(input);
+        expectedOutputs.push_back(compiledMap.Compute<double>(input));
+    }
+
+    std::vector<int> numFailures(numThreads, 0);
+    std::vector<std::thread> threads;
+    for (int threadIndex = 0; threadIndex < numThreads; ++threadIndex)
+    {
+        threads.emplace_back([&, threadIndex]() {
+            std::vector<double> output(size);
+            for (int iteration = 0; iteration < numIterations; ++iteration)
+            {
+                compiledMap.Compute(inputs[threadIndex].data(), output.data());
+                if (!testing::IsEqual(output, expectedOutputs[threadIndex]))
+                {
+                    ++numFailures[threadIndex];
+                }
+            }
+        });
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    testing::ProcessTest("Testing concurrent calls to a reentrant map compiled with parallelize", std::all_of(numFailures.begin(), numFailures.end(), [](int failures) { return failures == 0; }));
+}
+
+void TestCompilableReentrantParallelFor()
+{
+    // input -> add(constant) -> output, large enough that the add is split into ParallelFor tasks
+    const int size = 32768;
+    model::Model model;
+    auto inputNode = model.AddNode<model::InputNode<float>>(size);
+    auto constantNode = model.AddNode<nodes::ConstantNode<float>>(std::vector<float>(size, 1.5f));
+    auto addNode = model.AddNode<nodes::BinaryOperationNode<float>>(inputNode->output, constantNode->output, emitters::BinaryOperationType::add);
+    auto map = model::Map(model, { { "input", inputNode } }, { { "output", addNode->output } });
+
+    for (auto reentrant : { false, true })
+    {
+        model::MapCompilerParameters settings;
+        settings.moduleName = "TestReentrantParallelFor";
+        settings.reentrant = reentrant;
+        settings.compilerSettings.parallelize = true;
+        settings.compilerSettings.maxThreads = 4;
+        model::IRMapCompiler compiler(settings);
+        auto compiledMap = compiler.Compile(map);
+
+        std::stringstream buffer;
+        compiledMap.WriteCode(buffer, emitters::ModuleOutputFormat::ir);
+        auto hasTasks = buffer.str().find("_parallelFor") != std::string::npos;
+        testing::ProcessTest(std::string("Testing ParallelFor ") + (reentrant ? "runs serially in a reentrant map" : "starts tasks"), hasTasks != reentrant);
+
+        std::vector<float> input(size);
+        for (int index = 0; index < size; ++index)
+        {
+            input[index] = 0.5f * index;
+        }
+        VerifyCompiledOutput(map, compiledMap, std::vector<std::vector<float>>{ input }, std::string("ParallelFor") + (reentrant ? " (reentrant)" : ""));
+    }
+}
+
+void TestCompilableSequentialThreadState()
+{
+    // input -> accumulator -> output
+    model::Model model;
+    auto inputNode = model.AddNode<model::InputNode<double>>(4);
+    auto accumNode = model.AddNode<nodes::AccumulatorNode<double>>(inputNode->output);
+    auto map = model::Map(model, { { "input", inputNode } }, { { "output", accumNode->output } });
+
+    model::MapCompilerParameters settings;
+    settings.reentrant = true;
+    model::IRMapCompiler compiler(settings);
+    auto compiledMap = compiler.Compile(map);
+
+    // Each thread starts after the previous one has exited (so it may get the same thread ID), and must start from
+    // the initial state rather than from the sum the previous thread left behind
+    const std::vector<double> input = { 1, 2, 3, 4 };
+    const int numThreads = 8;
+    const int numIterations = 5;
+    std::vector<int> numFailures(numThreads, 0);
+    for (int threadIndex = 0; threadIndex < numThreads; ++threadIndex)
+    {
+        std::thread thread([&, threadIndex]() {
+            std::vector<double> output(input.size());
+            for (int iteration = 1; iteration <= numIterations; ++iteration)
+            {
+                compiledMap.Compute(input.data(), output.data());
+                std::vector<double> expectedOutput;
+                for (auto value : input)
+                {
+                    expectedOutput.push_back(iteration * value);
+                }
+                if (!testing::IsEqual(output, expectedOutput))
+                {
+                    ++numFailures[threadIndex];
+                }
+            }
+        });
+        thread.join();
+    }
+
+    testing::ProcessTest("Testing that each new thread starts from the initial state", std::all_of(numFailures.begin(), numFailures.end(), [](int failures) { return failures == 0; }));
+}
+
+void TestCompilableReentrantNodeState()
+{
+    // input -> accumulator -> delay -> output
+    model::Model model;
+    auto inputNode = model.AddNode<model::InputNode<double>>(4);
+    auto accumNode = model.AddNode<nodes::AccumulatorNode<double>>(inputNode->output);
+    auto delayNode = model.AddNode<nodes::DelayNode<double>>(accumNode->output, 3);
+    auto map = model::Map(model, { { "input", inputNode } }, { { "output", delayNode->output } });
+
+    const int numThreads = 8;
+    const int numIterations = 50;
+    std::vector<std::vector<double>> inputs;
+    std::vector<std::vector<double>> expectedOutputs;
+    for (int iteration = 0; iteration < numIterations; ++iteration)
+    {
+        std::vector<double> input(4);
+        for (size_t index = 0; index < input.size(); ++index)
+        {
+            input[index] = 0.5 * iteration - 0.25 * index;
+        }
+        inputs.push_back(input);
+        expectedOutputs.push_back(map.Compute<double>(input));
+    }
+
+    model::MapCompilerParameters settings;
+    settings.reentrant = true;
+    model::IRMapCompiler compiler(settings);
+    auto compiledMap = compiler.Compile(map);
+
+    // Every thread runs the same sequence through the shared map, so if the accumulator and delay line were shared,
+    // the threads would see each other's samples
+    std::vector<int> numFailures(numThreads, 0);
+    std::vector<std::thread> threads;
+    for (int threadIndex = 0; threadIndex < numThreads; ++threadIndex)
+    {
+        threads.emplace_back([&, threadIndex]() {
+            std::vector<double> output(4);
+            for (int iteration = 0; iteration < numIterations; ++iteration)
+            {
+                compiledMap.Compute(inputs[iteration].data(), output.data());
+                if (!testing::IsEqual(output, expectedOutputs[iteration]))
+                {
+                    ++numFailures[threadIndex];
+                }
+            }
+        });
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    testing::ProcessTest("Testing per-thread node state in a reentrant map", std::all_of(numFailures.begin(), numFailures.end(), [](int failures) { return failures == 0; }));
+
+    // Profiling counters are globals, so a reentrant map can't be profiled
+    model::MapCompilerParameters profileSettings;
+    profileSettings.reentrant = true;
+    profileSettings.profile = true;
+    model::IRMapCompiler profileCompiler(profileSettings);
+    bool threw = false;
+    try
+    {
+        profileCompiler.Compile(map);
+    }
+    catch (const emitters::EmitterException&)
+    {
+        threw = true;
+    }
+    testing::ProcessTest("Testing that a profiled map can't be reentrant", threw);
+}
+
 // Problem: memory corruption for BinaryPredicateNode (probably because of bool foolishness)
 void TestCompilableScalarBinaryPredicateNode()
 {
@@ -1089,10 +1717,9 @@ void TestCompilableClockNode()
     testing::ProcessTest("Testing lag notification count", testing::IsEqual(lagNotificationCallbackCount, 2));
 }
 
-void TestCompilableFFTNode()
+void TestCompilableFFTNode(size_t N)
 {
     using ValueType = float;
-    const int N = 8;
     model::Model model;
     auto inputNode = model.AddNode<model::InputNode<ValueType>>(N);
     auto fftNode = model.AddNode<nodes::FFTNode<ValueType>>(inputNode->output);
@@ -1101,7 +1728,7 @@ void TestCompilableFFTNode()
     std::vector<ValueType> input2(N, 0); // impulse
     input2[0] = 1.0;
     std::vector<ValueType> input3(N, 0);
-    for(int index = 0; index < N; ++index)
+    for(size_t index = 0; index < N; ++index)
     {
         input3[index] = std::sin(2 * math::Constants<ValueType>::pi * index / N);
     }
@@ -1114,8 +1741,8 @@ void TestCompilableFFTNode()
     // PrintIR(compiledMap);
     // compiledMap.WriteCode("FFTNode.ll", emitters::ModuleOutputFormat::ir);
 
-    // compare output
-    VerifyCompiledOutput(map, compiledMap, signal, "FFTNode");
+    // compare output (the error grows with the size of the outputs, which is up to N)
+    VerifyCompiledOutput(map, compiledMap, signal, "FFTNode_" + std::to_string(N), 1e-5 * N);
 }
 
 class BinaryFunctionIRNode : public nodes::IRNode
@@ -2115,6 +2742,19 @@ void TestBinaryConvolutionalLayerNode(size_t imageRows, size_t imageColumns, siz
     VerifyArchiveAndUnarchivingMap<ElementType>(map, computeNode, inputWithPadding, output);
 }
 
+ConvolutionMethod GetConvolutionMethod(ConvolutionType convolutionType)
+{
+    switch (convolutionType)
+    {
+        case ConvolutionType::Diagonal:
+            return ConvolutionMethod::diagonal;
+        case ConvolutionType::Winograd:
+            return ConvolutionMethod::winograd;
+        default:
+            return ConvolutionMethod::columnwise;
+    }
+}
+
 void TestConvolutionalLayerNode(ConvolutionType convolutionType, size_t inputPaddingSize, size_t outputPaddingSize)
 {
     using ElementType = double;
@@ -2134,7 +2774,7 @@ void TestConvolutionalLayerNode(ConvolutionType convolutionType, size_t inputPad
     Shape outputShape = { 1 + 2 * outputPaddingSize, 2 + 2 * outputPaddingSize, 2 };
 
     LayerParameters parameters{ inputWithPadding, ZeroPadding(inputPaddingSize), outputShape, ZeroPadding(outputPaddingSize) };
-    auto convolutionMethod = (convolutionType == ConvolutionType::Diagonal) ? ConvolutionMethod::diagonal : ConvolutionMethod::columnwise;
+    auto convolutionMethod = GetConvolutionMethod(convolutionType);
     ConvolutionalParameters convolutionalParams{ 3, 1, convolutionMethod, 2 }; // 2 == batch size
     TensorType weights(convolutionalParams.receptiveField * outputShape.NumChannels(), convolutionalParams.receptiveField, input.NumChannels());
     // clang-format off
@@ -2186,6 +2826,18 @@ void TestConvolutionalLayerNode(ConvolutionType convolutionType, size_t inputPad
 
     // Test archiving / unarchiving produces same result
     VerifyArchiveAndUnarchivingMap<ElementType>(map, computeNode, inputWithPadding, output);
+
+    // Test that compiler settings stored in the map's metadata override the layer's convolution method
+    model::NodeCompilerSettings compilerSettings;
+    compilerSettings.convolutionMethod = (convolutionType == ConvolutionType::Diagonal) ? "columnwise" : "diagonal";
+    compilerSettings.vectorWidth = 8;
+    model::SetNodeCompilerSettings(map, model::GetNodeCompilerSettingsKey(*computeNode), compilerSettings);
+    VerifyLayerMap<ElementType>(map, computeNode, inputWithPadding, output);
+
+    model::IRMapCompiler compiler;
+    auto compiledMap = compiler.Compile(map);
+    auto numDiagonalNodes = compiledMap.GetModel().GetNodesByType<nodes::DiagonalConvolutionNode<ElementType>>().size();
+    testing::ProcessTest("Testing ConvolutionalLayerNode compiler settings", (numDiagonalNodes > 0) == (compilerSettings.convolutionMethod == "diagonal"));
 }
 
 void TestConvolutionalLayerNode2(ConvolutionType convolutionType, size_t inputPaddingSize, size_t outputPaddingSize)
@@ -2222,7 +2874,7 @@ void TestConvolutionalLayerNode2(ConvolutionType convolutionType, size_t inputPa
     Shape outputShape = { numRows + 2 * outputPaddingSize, numCols + 2 * outputPaddingSize, numFilters };
 
     LayerParameters parameters{ inputWithPadding, ZeroPadding(inputPaddingSize), outputShape, ZeroPadding(outputPaddingSize) };
-    auto convolutionMethod = (convolutionType == ConvolutionType::Diagonal) ? ConvolutionMethod::diagonal : ConvolutionMethod::columnwise;
+    auto convolutionMethod = GetConvolutionMethod(convolutionType);
     ConvolutionalParameters convolutionalParams{ 3, 1, convolutionMethod, 2 }; // 2 == batch size
     TensorType weights(convolutionalParams.receptiveField * numFilters, convolutionalParams.receptiveField, input.NumChannels());
     weights.Fill(1.0);
@@ -2255,6 +2907,382 @@ void TestConvolutionalLayerNode2(ConvolutionType convolutionType, size_t inputPa
 
     // Test archiving / unarchiving produces same result
     VerifyArchiveAndUnarchivingMap<ElementType>(map, computeNode, inputWithPadding, output);
+
+    if (convolutionType == ConvolutionType::Winograd)
+    {
+        // Winograd convolution rounds differently from the other methods, so compare against the columnwise method with a tolerance
+        ConvolutionalLayer<ElementType> columnwiseLayer(parameters, { 3, 1, ConvolutionMethod::columnwise, 2 }, weights);
+        columnwiseLayer.Compute();
+        auto expected = columnwiseLayer.GetOutput().ToArray();
+
+        model::IRMapCompiler compiler;
+        auto compiledMap = compiler.Compile(map);
+        compiledMap.SetInputValue(0, inputWithPadding.ToArray());
+        auto compiledResult = compiledMap.ComputeOutput<ElementType>(0);
+        auto numWinogradNodes = compiledMap.GetModel().GetNodesByType<nodes::WinogradConvolutionNode<ElementType>>().size();
+        testing::ProcessTest("Testing compiled Winograd ConvolutionalLayerNode against columnwise method", numWinogradNodes > 0 && testing::IsEqual(compiledResult, expected, 1e-10));
+    }
+}
+
+void TestStackedWinogradConvolutionalLayerNodes()
+{
+    using ElementType = double;
+    using LayerParameters = typename Layer<ElementType>::LayerParameters;
+    using TensorType = typename Layer<ElementType>::TensorType;
+    using TensorReferenceType = typename Layer<ElementType>::TensorReferenceType;
+    using Shape = typename Layer<ElementType>::Shape;
+
+    // Two layers with different shapes (and odd sizes, so both need a zero-extended copy of their input)
+    const size_t numRows = 7;
+    const size_t numCols = 5;
+    const size_t numChannels = 3;
+    const size_t numFilters1 = 4;
+    const size_t numFilters2 = 6;
+    const size_t receptiveField = 3;
+
+    auto rng = utilities::GetRandomEngine("123");
+    auto rand = [&rng]() { return (double)rng() / (double)(rng.max() - rng.min()); };
+    auto fillRandom = [&rand](TensorReferenceType tensor) {
+        for (size_t rowIndex = 0; rowIndex < tensor.NumRows(); ++rowIndex)
+        {
+            for (size_t colIndex = 0; colIndex < tensor.NumColumns(); ++colIndex)
+            {
+                for (size_t channelIndex = 0; channelIndex < tensor.NumChannels(); ++channelIndex)
+                {
+                    tensor(rowIndex, colIndex, channelIndex) = rand() - 0.5;
+                }
+            }
+        }
+    };
+
+    TensorType inputWithPadding(numRows + 2, numCols + 2, numChannels);
+    inputWithPadding.Fill(0);
+    fillRandom(inputWithPadding.GetSubTensor(1, 1, 0, numRows, numCols, numChannels));
+    TensorType weights1(receptiveField * numFilters1, receptiveField, numChannels);
+    fillRandom(weights1);
+    TensorType weights2(receptiveField * numFilters2, receptiveField, numFilters1);
+    fillRandom(weights2);
+
+    Shape hiddenShape = { numRows + 2, numCols + 2, numFilters1 };
+    Shape outputShape = { numRows, numCols, numFilters2 };
+    auto winogradMethod = GetConvolutionMethod(ConvolutionType::Winograd);
+
+    ConvolutionalLayer<ElementType> layer1({ inputWithPadding, ZeroPadding(1), hiddenShape, ZeroPadding(1) }, { receptiveField, 1, winogradMethod, 2 }, weights1);
+    ConvolutionalLayer<ElementType> layer2({ layer1.GetOutput(), ZeroPadding(1), outputShape, NoPadding() }, { receptiveField, 1, winogradMethod, 2 }, weights2);
+
+    // Winograd convolution rounds differently from the other methods, so compare against the columnwise method with a tolerance
+    ConvolutionalLayer<ElementType> columnwiseLayer1({ inputWithPadding, ZeroPadding(1), hiddenShape, ZeroPadding(1) }, { receptiveField, 1, ConvolutionMethod::columnwise, 2 }, weights1);
+    columnwiseLayer1.Compute();
+    ConvolutionalLayer<ElementType> columnwiseLayer2({ columnwiseLayer1.GetOutput(), ZeroPadding(1), outputShape, NoPadding() }, { receptiveField, 1, ConvolutionMethod::columnwise, 2 }, weights2);
+    columnwiseLayer2.Compute();
+    auto expected = columnwiseLayer2.GetOutput().ToArray();
+
+    model::Model model;
+    auto inputNode = model.AddNode<model::InputNode<double>>(inputWithPadding.Size());
+    auto convNode1 = model.AddNode<nodes::ConvolutionalLayerNode<double>>(inputNode->output, layer1);
+    auto convNode2 = model.AddNode<nodes::ConvolutionalLayerNode<double>>(convNode1->output, layer2);
+    auto map = model::Map(model, { { "input", inputNode } }, { { "output", convNode2->output } });
+
+    // Each layer must get its own scratch buffers, whether the nodes are compiled into functions of their own or inline
+    for (bool reentrant : { false, true })
+    {
+        model::MapCompilerParameters settings;
+        settings.reentrant = reentrant;
+        model::IRMapCompiler compiler(settings);
+        auto compiledMap = compiler.Compile(map);
+        compiledMap.SetInputValue(0, inputWithPadding.ToArray());
+        auto compiledResult = compiledMap.ComputeOutput<ElementType>(0);
+        auto numWinogradNodes = compiledMap.GetModel().GetNodesByType<nodes::WinogradConvolutionNode<ElementType>>().size();
+        testing::ProcessTest(std::string("Testing compiled stacked Winograd ConvolutionalLayerNodes") + (reentrant ? " (reentrant)" : ""), numWinogradNodes == 2 && testing::IsEqual(compiledResult, expected, 1e-10));
+    }
+}
+
+void TestGroupedConvolutionalLayerNode(size_t numChannels, size_t numFilters, size_t numGroups, size_t stride)
+{
+    using ElementType = float;
+    using LayerParameters = typename Layer<ElementType>::LayerParameters;
+    using TensorType = typename Layer<ElementType>::TensorType;
+    using TensorReferenceType = typename Layer<ElementType>::TensorReferenceType;
+    using Shape = typename Layer<ElementType>::Shape;
+
+    const size_t numRows = 9;
+    const size_t numCols = 7;
+    const size_t inputPaddingSize = 1;
+    const size_t receptiveField = 3;
+
+    auto rng = utilities::GetRandomEngine("123");
+    auto rand = [&rng]() { return static_cast<ElementType>((double)rng() / (double)(rng.max() - rng.min()) - 0.5); };
+
+    TensorType inputWithPadding(numRows + 2 * inputPaddingSize, numCols + 2 * inputPaddingSize, numChannels);
+    inputWithPadding.Fill(0);
+    TensorReferenceType input = inputWithPadding.GetSubTensor(inputPaddingSize, inputPaddingSize, 0, numRows, numCols, numChannels);
+    for (size_t rowIndex = 0; rowIndex < numRows; ++rowIndex)
+    {
+        for (size_t colIndex = 0; colIndex < numCols; ++colIndex)
+        {
+            for (size_t channelIndex = 0; channelIndex < numChannels; ++channelIndex)
+            {
+                input(rowIndex, colIndex, channelIndex) = rand();
+            }
+        }
+    }
+
+    // Each filter only has weights for the channels in its group
+    TensorType weights(receptiveField * numFilters, receptiveField, numChannels / numGroups);
+    for (size_t rowIndex = 0; rowIndex < weights.NumRows(); ++rowIndex)
+    {
+        for (size_t colIndex = 0; colIndex < weights.NumColumns(); ++colIndex)
+        {
+            for (size_t channelIndex = 0; channelIndex < weights.NumChannels(); ++channelIndex)
+            {
+                weights(rowIndex, colIndex, channelIndex) = rand();
+            }
+        }
+    }
+
+    const size_t outputRows = (numRows + 2 * inputPaddingSize - receptiveField) / stride + 1;
+    const size_t outputCols = (numCols + 2 * inputPaddingSize - receptiveField) / stride + 1;
+    Shape outputShape = { outputRows, outputCols, numFilters };
+    LayerParameters parameters{ inputWithPadding, ZeroPadding(inputPaddingSize), outputShape, NoPadding() };
+    ConvolutionalParameters convolutionalParams{ receptiveField, stride, ConvolutionMethod::columnwise, 1 };
+    ConvolutionalLayer<ElementType> layer(parameters, convolutionalParams, weights);
+    layer.Compute();
+    auto output = layer.GetOutput();
+
+    model::Model model;
+    auto inputNode = model.AddNode<model::InputNode<ElementType>>(inputWithPadding.Size());
+    auto computeNode = model.AddNode<nodes::ConvolutionalLayerNode<ElementType>>(inputNode->output, layer);
+    auto map = model::Map(model, { { "input", inputNode } }, { { "output", computeNode->output } });
+
+    VerifyLayerMap<ElementType>(map, computeNode, inputWithPadding, output);
+
+    // The compiled node is vectorized along the filters, with scalar code for the leftover filters
+    model::MapCompilerParameters settings;
+    settings.compilerSettings.allowVectorInstructions = true;
+    settings.compilerSettings.vectorWidth = 4;
+    model::IRMapCompiler compiler(settings);
+    auto compiledMap = compiler.Compile(map);
+    auto numGroupedNodes = compiledMap.GetModel().GetNodesByType<nodes::GroupedConvolutionNode<ElementType>>().size();
+    testing::ProcessTest("Testing ConvolutionalLayerNode refines into GroupedConvolutionNode", numGroupedNodes == 1);
+
+    std::vector<std::vector<ElementType>> signal = { inputWithPadding.ToArray() };
+    VerifyCompiledOutput(map, compiledMap, signal, "vectorized " + computeNode->GetRuntimeTypeName() + " with " + std::to_string(numGroups) + " groups");
+}
+
+namespace
+{
+    // Compiles a map whose layer node has been given an input quantization scale, and checks it against the (integer)
+    // reference computation of the refined map and, to within the quantization error, against the floating-point layer
+    template <typename ElementType>
+    void VerifyQuantizedLayerMap(model::Map& map, model::Node* layerNode, const std::vector<ElementType>& input, const std::vector<ElementType>& expectedOutput, const std::string& name)
+    {
+        double inputMagnitude = 0;
+        double outputMagnitude = 0;
+        std::for_each(input.begin(), input.end(), [&inputMagnitude](ElementType x) { inputMagnitude = std::max(inputMagnitude, std::abs(static_cast<double>(x))); });
+        std::for_each(expectedOutput.begin(), expectedOutput.end(), [&outputMagnitude](ElementType x) { outputMagnitude = std::max(outputMagnitude, std::abs(static_cast<double>(x))); });
+
+        model::NodeCompilerSettings settings;
+        settings.inputQuantizationScale = inputMagnitude / 127;
+        model::SetNodeCompilerSettings(*layerNode, settings);
+
+        model::MapCompilerParameters parameters;
+        parameters.compilerSettings.allowVectorInstructions = true;
+        parameters.compilerSettings.vectorWidth = 4;
+        model::IRMapCompiler compiler(parameters);
+        auto compiledMap = compiler.Compile(map);
+        auto numQuantizedNodes = compiledMap.GetModel().GetNodesByType<nodes::QuantizedMatrixMultiplyNode<ElementType>>().size();
+        testing::ProcessTest("Testing quantized " + name + " refines into QuantizedMatrixMultiplyNode", numQuantizedNodes == 1);
+
+        model::Map refinedMap = map;
+        model::TransformContext context;
+        refinedMap.Refine(context);
+        std::vector<std::vector<ElementType>> signal = { input };
+        VerifyCompiledOutput(refinedMap, compiledMap, signal, "quantized " + name, 1e-4);
+
+        compiledMap.SetInputValue(0, input);
+        auto compiledOutput = compiledMap.ComputeOutput<ElementType>(0);
+        double maxError = 0;
+        for (size_t index = 0; index < expectedOutput.size(); ++index)
+        {
+            maxError = std::max(maxError, std::abs(static_cast<double>(compiledOutput[index] - expectedOutput[index])));
+        }
+        testing::ProcessTest("Testing quantized " + name + " accuracy", maxError <= 0.02 * outputMagnitude);
+    }
+}
+
+void TestQuantizedLayerNodes()
+{
+    using ElementType = float;
+    using LayerParameters = typename Layer<ElementType>::LayerParameters;
+    using TensorType = typename Layer<ElementType>::TensorType;
+    using MatrixType = typename Layer<ElementType>::MatrixType;
+    using Shape = typename Layer<ElementType>::Shape;
+
+    auto rng = utilities::GetRandomEngine("123");
+    auto rand = [&rng]() { return static_cast<ElementType>((double)rng() / (double)(rng.max() - rng.min()) - 0.5); };
+
+    // Convolutional layer
+    {
+        const size_t numRows = 9;
+        const size_t numCols = 7;
+        const size_t numChannels = 5;
+        const size_t numFilters = 6;
+        const size_t receptiveField = 3;
+
+        TensorType inputWithPadding(numRows + 2, numCols + 2, numChannels);
+        inputWithPadding.Fill(0);
+        auto input = inputWithPadding.GetSubTensor(1, 1, 0, numRows, numCols, numChannels);
+        input.Generate(rand);
+        TensorType weights(receptiveField * numFilters, receptiveField, numChannels);
+        weights.Generate(rand);
+
+        LayerParameters parameters{ inputWithPadding, ZeroPadding(1), Shape{ numRows, numCols, numFilters }, NoPadding() };
+        ConvolutionalParameters convolutionalParams{ receptiveField, 1, ConvolutionMethod::diagonal, 1 };
+        ConvolutionalLayer<ElementType> layer(parameters, convolutionalParams, weights);
+        layer.Compute();
+        auto output = layer.GetOutput();
+
+        model::Model model;
+        auto inputNode = model.AddNode<model::InputNode<ElementType>>(inputWithPadding.Size());
+        auto computeNode = model.AddNode<nodes::ConvolutionalLayerNode<ElementType>>(inputNode->output, layer);
+        auto map = model::Map(model, { { "input", inputNode } }, { { "output", computeNode->output } });
+        auto mapLayerNode = map.GetModel().GetNodesByType<nodes::ConvolutionalLayerNode<ElementType>>().front();
+        VerifyQuantizedLayerMap<ElementType>(map, mapLayerNode, inputWithPadding.ToArray(), output.ToArray(), "ConvolutionalLayerNode");
+    }
+
+    // Fully-connected layer
+    {
+        TensorType input(4, 3, 5);
+        input.Generate(rand);
+        MatrixType weights(7, input.Size());
+        weights.Generate(rand);
+
+        LayerParameters parameters{ input, NoPadding(), Shape{ 7, 1, 1 }, NoPadding() };
+        FullyConnectedLayer<ElementType> layer(parameters, weights);
+        layer.Compute();
+        auto output = layer.GetOutput();
+
+        model::Model model;
+        auto inputNode = model.AddNode<model::InputNode<ElementType>>(input.Size());
+        auto computeNode = model.AddNode<nodes::FullyConnectedLayerNode<ElementType>>(inputNode->output, layer);
+        auto map = model::Map(model, { { "input", inputNode } }, { { "output", computeNode->output } });
+        auto mapLayerNode = map.GetModel().GetNodesByType<nodes::FullyConnectedLayerNode<ElementType>>().front();
+        VerifyQuantizedLayerMap<ElementType>(map, mapLayerNode, input.ToArray(), output.ToArray(), "FullyConnectedLayerNode");
+    }
+}
+
+namespace
+{
+    bool HasHalfPrecisionWeights(model::IRCompiledMap& compiledMap)
+    {
+        for (const auto& global : compiledMap.GetModule().GetLLVMModule()->globals())
+        {
+            if (global.getName().startswith("halfWeights_"))
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Compiles a map with its weights stored in half precision, and checks it against the map's (float) reference computation
+    template <typename ElementType>
+    void VerifyHalfPrecisionWeightsMap(const model::Map& map, const std::vector<std::vector<ElementType>>& signal, const std::string& name)
+    {
+        model::MapCompilerParameters parameters;
+        parameters.compilerSettings.useHalfPrecisionWeights = true;
+        parameters.compilerSettings.allowVectorInstructions = true;
+        parameters.compilerSettings.vectorWidth = 4;
+        model::IRMapCompiler compiler(parameters);
+        auto compiledMap = compiler.Compile(map);
+        testing::ProcessTest("Testing " + name + " stores its weights in half precision", HasHalfPrecisionWeights(compiledMap));
+
+        // Half precision has an 11-bit mantissa, so each weight has a relative error of at most 2^-11
+        VerifyCompiledOutput(map, compiledMap, signal, "half-precision weights " + name, 1e-2);
+    }
+}
+
+void TestHalfPrecisionWeights()
+{
+    using ElementType = float;
+    using LayerParameters = typename Layer<ElementType>::LayerParameters;
+    using TensorType = typename Layer<ElementType>::TensorType;
+    using VectorType = typename Layer<ElementType>::VectorType;
+    using MatrixType = typename Layer<ElementType>::MatrixType;
+    using Shape = typename Layer<ElementType>::Shape;
+
+    auto rng = utilities::GetRandomEngine("123");
+    auto rand = [&rng]() { return static_cast<ElementType>((double)rng() / (double)(rng.max() - rng.min()) - 0.5); };
+
+    // Convolutional layer (which multiplies by its weights with GEMM)
+    {
+        const size_t numRows = 9;
+        const size_t numCols = 7;
+        const size_t numChannels = 5;
+        const size_t numFilters = 6;
+        const size_t receptiveField = 3;
+
+        TensorType inputWithPadding(numRows + 2, numCols + 2, numChannels);
+        inputWithPadding.Fill(0);
+        auto input = inputWithPadding.GetSubTensor(1, 1, 0, numRows, numCols, numChannels);
+        input.Generate(rand);
+        TensorType weights(receptiveField * numFilters, receptiveField, numChannels);
+        weights.Generate(rand);
+
+        LayerParameters parameters{ inputWithPadding, ZeroPadding(1), Shape{ numRows, numCols, numFilters }, NoPadding() };
+        ConvolutionalParameters convolutionalParams{ receptiveField, 1, ConvolutionMethod::columnwise, 1 };
+        ConvolutionalLayer<ElementType> layer(parameters, convolutionalParams, weights);
+
+        model::Model model;
+        auto inputNode = model.AddNode<model::InputNode<ElementType>>(inputWithPadding.Size());
+        auto computeNode = model.AddNode<nodes::ConvolutionalLayerNode<ElementType>>(inputNode->output, layer);
+        auto map = model::Map(model, { { "input", inputNode } }, { { "output", computeNode->output } });
+        VerifyHalfPrecisionWeightsMap<ElementType>(map, { inputWithPadding.ToArray() }, "ConvolutionalLayerNode");
+    }
+
+    // Fully-connected layer (GEMV)
+    {
+        TensorType input(4, 3, 5);
+        input.Generate(rand);
+        MatrixType weights(7, input.Size());
+        weights.Generate(rand);
+
+        LayerParameters parameters{ input, NoPadding(), Shape{ 7, 1, 1 }, NoPadding() };
+        FullyConnectedLayer<ElementType> layer(parameters, weights);
+
+        model::Model model;
+        auto inputNode = model.AddNode<model::InputNode<ElementType>>(input.Size());
+        auto computeNode = model.AddNode<nodes::FullyConnectedLayerNode<ElementType>>(inputNode->output, layer);
+        auto map = model::Map(model, { { "input", inputNode } }, { { "output", computeNode->output } });
+        VerifyHalfPrecisionWeightsMap<ElementType>(map, { input.ToArray() }, "FullyConnectedLayerNode");
+    }
+
+    // LSTM layer (GEMV with stacked gate weights), over several time steps
+    {
+        const size_t inputSize = 4;
+        const size_t hiddenSize = 3;
+        std::vector<MatrixType> gateWeights;
+        std::vector<VectorType> gateBiases;
+        for (int gate = 0; gate < 4; ++gate)
+        {
+            gateWeights.emplace_back(hiddenSize, inputSize + hiddenSize);
+            gateWeights.back().Generate(rand);
+            gateBiases.emplace_back(hiddenSize);
+            gateBiases.back().Generate(rand);
+        }
+
+        TensorType input(1, 1, inputSize);
+        input.Generate(rand);
+        LayerParameters parameters{ input, NoPadding(), Shape{ 1, 1, hiddenSize }, NoPadding() };
+        LSTMParameters<ElementType> lstmParams{ gateWeights[0], gateWeights[1], gateWeights[2], gateWeights[3], gateBiases[0], gateBiases[1], gateBiases[2], gateBiases[3] };
+        LSTMLayer<ElementType, TanhActivation, SigmoidActivation> layer(parameters, lstmParams);
+
+        model::Model model;
+        auto inputNode = model.AddNode<model::InputNode<ElementType>>(input.Size());
+        auto computeNode = model.AddNode<nodes::LSTMLayerNode<ElementType, TanhActivation, SigmoidActivation>>(inputNode->output, layer);
+        auto map = model::Map(model, { { "input", inputNode } }, { { "output", computeNode->output } });
+        VerifyHalfPrecisionWeightsMap<ElementType>(map, { input.ToArray(), { 0.5f, -1.0f, 2.0f, 0.25f }, { -3.0f, 0.1f, 0.0f, 1.5f } }, "LSTMLayerNode");
+    }
 }
 
 void TestFullyConnectedLayerNode(size_t inputPaddingSize, size_t outputPaddingSize)
@@ -2362,6 +3390,49 @@ void TestMeanPoolingLayerNode(size_t inRows, size_t inCols, size_t numChannels,
     TestPoolingLayerNode<float, ell::predictors::neural::MeanPoolingFunction>(inRows, inCols, numChannels, outRows, outCols, poolingSize, poolingStride, inputPaddingSize, outputPaddingSize, 1e-5);
 }
 
+template <typename ElementType, template <typename> class PoolingFunction>
+void TestParallelPoolingLayerNode(size_t inRows, size_t inCols, size_t numChannels, size_t outRows, size_t outCols, size_t poolingSize, size_t poolingStride, size_t inputPaddingSize, size_t outputPaddingSize)
+{
+    using LayerParameters = typename Layer<ElementType>::LayerParameters;
+    using TensorType = typename Layer<ElementType>::TensorType;
+    using TensorReferenceType = typename Layer<ElementType>::TensorReferenceType;
+    using Shape = typename Layer<ElementType>::Shape;
+
+    // Build a model
+    TensorType inputWithPadding(inRows + 2 * inputPaddingSize, inCols + 2 * inputPaddingSize, numChannels);
+    TensorReferenceType input = inputWithPadding.GetSubTensor(inputPaddingSize, inputPaddingSize, 0, inRows, inCols, numChannels);
+    FillTensor(input);
+
+    Shape outputShape = { outRows + 2 * outputPaddingSize, outCols + 2 * outputPaddingSize, numChannels };
+    LayerParameters layerParameters{ inputWithPadding, ZeroPadding(inputPaddingSize), outputShape, ZeroPadding(outputPaddingSize) };
+    PoolingParameters poolingParameters{ poolingSize, poolingStride };
+    PoolingLayer<ElementType, PoolingFunction> layer(layerParameters, poolingParameters);
+
+    model::Model model;
+    auto inputNode = model.AddNode<model::InputNode<ElementType>>(inputWithPadding.Size());
+    auto computeNode = model.AddNode<nodes::PoolingLayerNode<ElementType, PoolingFunction>>(inputNode->output, layer);
+    auto map = model::Map(model, { { "input", inputNode } }, { { "output", computeNode->output } });
+
+    // Split the rows across tasks, and compute the channels 4 at a time (leaving some left over for the scalar loop)
+    model::MapCompilerParameters settings;
+    settings.compilerSettings.parallelize = true;
+    settings.compilerSettings.maxThreads = 3;
+    settings.compilerSettings.allowVectorInstructions = true;
+    settings.compilerSettings.vectorWidth = 4;
+    model::IRMapCompiler compiler(settings);
+    auto compiledMap = compiler.Compile(map);
+
+    std::vector<std::vector<ElementType>> signal = { inputWithPadding.ToArray() };
+    VerifyCompiledOutput(map, compiledMap, signal, "Parallel " + computeNode->GetRuntimeTypeName());
+}
+
+void TestParallelPoolingLayerNode(size_t inRows, size_t inCols, size_t numChannels, size_t outRows, size_t outCols, size_t poolingSize, size_t poolingStride, size_t inputPaddingSize, size_t outputPaddingSize)
+{
+    TestParallelPoolingLayerNode<float, predictors::neural::MaxPoolingFunction>(inRows, inCols, numChannels, outRows, outCols, poolingSize, poolingStride, inputPaddingSize, outputPaddingSize);
+    TestParallelPoolingLayerNode<float, predictors::neural::MeanPoolingFunction>(inRows, inCols, numChannels, outRows, outCols, poolingSize, poolingStride, inputPaddingSize, outputPaddingSize);
+    TestParallelPoolingLayerNode<double, predictors::neural::MaxPoolingFunction>(inRows, inCols, numChannels, outRows, outCols, poolingSize, poolingStride, inputPaddingSize, outputPaddingSize);
+}
+
 void TestScalingLayerNode(size_t inputPaddingSize, size_t outputPaddingSize)
 {
     using ElementType = double;
@@ -2494,6 +3565,176 @@ void TestFusedLinearLayerNodes(size_t rows, size_t columns, size_t channels)
     VerifyCompiledOutput(map, compiledMap, signal, "Fused linear layers");
 }
 
+void TestFusedConvolutionalLayerNodes(size_t rows, size_t columns, size_t channels, size_t numFilters)
+{
+    // Create a neural net model with the following layers:
+    // input -> convolutional -> batch normalization -> scaling -> bias -> ReLU -> fully connected -> bias -> sigmoid
+    using ElementType = double;
+    using InputParameters = typename InputLayer<ElementType>::InputParameters;
+    using LayerParameters = typename Layer<ElementType>::LayerParameters;
+    using TensorType = typename Layer<ElementType>::TensorType;
+    using MatrixType = typename Layer<ElementType>::MatrixType;
+    using Shape = typename Layer<ElementType>::Shape;
+    using VectorType = typename Layer<ElementType>::VectorType;
+
+    typename NeuralNetworkPredictor<ElementType>::InputLayerReference inputLayer;
+    typename NeuralNetworkPredictor<ElementType>::Layers layers;
+    const Shape dataShape = { rows, columns, channels };
+    const Shape convOutputShape = { rows, columns, numFilters };
+
+    // Input layer
+    InputParameters inputParams{ dataShape, NoPadding(), { rows + 2, columns + 2, channels }, ZeroPadding(1), 1.0 };
+    inputLayer = std::make_unique<InputLayer<ElementType>>(inputParams);
+
+    // Convolutional layer
+    LayerParameters layerParameters{ inputLayer->GetOutput(), ZeroPadding(1), convOutputShape, NoPadding() };
+    ConvolutionalParameters convolutionalParams{ 3, 1, ConvolutionMethod::columnwise, 1 };
+    TensorType convWeights(numFilters * 3, 3, channels);
+    FillRandomTensor(convWeights);
+    layers.push_back(std::unique_ptr<Layer<ElementType>>(new ConvolutionalLayer<ElementType>(layerParameters, convolutionalParams, convWeights)));
+
+    // Batch normalization layer
+    layerParameters = { layers.back()->GetOutput(), NoPadding(), convOutputShape, NoPadding() };
+    VectorType mean(numFilters);
+    VectorType variance(numFilters);
+    FillRandomVector(mean);
+    FillRandomVector(variance, 0.125, 1.0);
+    layers.push_back(std::unique_ptr<Layer<ElementType>>(new BatchNormalizationLayer<ElementType>(layerParameters, mean, variance, 1.0e-6f, EpsilonSummand::SqrtVariance)));
+
+    // Scaling layer
+    layerParameters = { layers.back()->GetOutput(), NoPadding(), convOutputShape, NoPadding() };
+    VectorType scales(numFilters);
+    FillRandomVector(scales);
+    layers.push_back(std::unique_ptr<Layer<ElementType>>(new ScalingLayer<ElementType>(layerParameters, scales)));
+
+    // Bias layer
+    layerParameters = { layers.back()->GetOutput(), NoPadding(), convOutputShape, NoPadding() };
+    VectorType bias1(numFilters);
+    FillRandomVector(bias1);
+    layers.push_back(std::unique_ptr<Layer<ElementType>>(new BiasLayer<ElementType>(layerParameters, bias1)));
+
+    // ReLU activation layer
+    layerParameters = { layers.back()->GetOutput(), NoPadding(), convOutputShape, NoPadding() };
+    layers.push_back(std::unique_ptr<Layer<ElementType>>(new ActivationLayer<ElementType, ReLUActivation>(layerParameters)));
+
+    // Fully connected layer
+    const size_t numOutputs = 5;
+    const Shape fullyConnectedOutputShape = { 1, 1, numOutputs };
+    layerParameters = { layers.back()->GetOutput(), NoPadding(), fullyConnectedOutputShape, NoPadding() };
+    MatrixType fullyConnectedWeights(numOutputs, rows * columns * numFilters);
+    Uniform<ElementType> rand(-1, 1);
+    fullyConnectedWeights.Generate(rand);
+    auto fullyConnectedWeightsReference = fullyConnectedWeights.GetConstReference();
+    layers.push_back(std::unique_ptr<Layer<ElementType>>(new FullyConnectedLayer<ElementType>(layerParameters, fullyConnectedWeightsReference)));
+
+    // Bias layer
+    layerParameters = { layers.back()->GetOutput(), NoPadding(), fullyConnectedOutputShape, NoPadding() };
+    VectorType bias2(numOutputs);
+    FillRandomVector(bias2);
+    layers.push_back(std::unique_ptr<Layer<ElementType>>(new BiasLayer<ElementType>(layerParameters, bias2)));
+
+    // Sigmoid activation layer
+    layerParameters = { layers.back()->GetOutput(), NoPadding(), fullyConnectedOutputShape, NoPadding() };
+    layers.push_back(std::unique_ptr<Layer<ElementType>>(new ActivationLayer<ElementType, SigmoidActivation>(layerParameters)));
+
+    NeuralNetworkPredictor<ElementType> neuralNetwork(std::move(inputLayer), std::move(layers));
+    std::vector<ElementType> input(rows * columns * channels);
+    FillRandomVector(input);
+
+    // Create model
+    model::Model model;
+    auto inputNode = model.AddNode<model::InputNode<double>>(GetShapeSize(neuralNetwork.GetInputShape()));
+    auto predictorNode = model.AddNode<nodes::NeuralNetworkPredictorNode<double>>(inputNode->output, neuralNetwork);
+    auto map = model::Map(model, { { "input", inputNode } }, { { "output", predictorNode->output } });
+
+    model::MapCompilerParameters settings;
+    settings.compilerSettings.optimize = true;
+    settings.fuseLinearFunctionNodes = true;
+    model::IRMapCompiler compiler(settings);
+    auto compiledMap = compiler.Compile(map);
+
+    // The scaling is folded into the weights, leaving one fused bias and activation pass per layer
+    const auto& compiledModel = compiledMap.GetModel();
+    auto numReLUEpilogues = compiledModel.GetNodesByType<nodes::BroadcastBinaryFunctionNode<ElementType, nodes::BroadcastBiasActivationFunction<ElementType, nodes::ReLUActivationFunction<ElementType>>>>().size();
+    auto numSigmoidEpilogues = compiledModel.GetNodesByType<nodes::BroadcastBinaryFunctionNode<ElementType, nodes::BroadcastBiasActivationFunction<ElementType, nodes::SigmoidActivationFunction<ElementType>>>>().size();
+    auto numLinearNodes = compiledModel.GetNodesByType<nodes::BroadcastLinearFunctionNode<ElementType>>().size();
+    testing::ProcessTest("Testing fused convolutional and fully-connected layer epilogues", numReLUEpilogues == 1 && numSigmoidEpilogues == 1 && numLinearNodes == 0);
+
+    // compare output
+    std::vector<std::vector<double>> signal = { input };
+    VerifyCompiledOutput(map, compiledMap, signal, "Fused convolutional layers");
+}
+
+void TestFusedConvolutionalPoolingLayerNodes(size_t rows, size_t columns, size_t channels, size_t numFilters)
+{
+    // Create a neural net model with the following layers:
+    // input -> convolutional -> bias -> leaky ReLU -> max pooling
+    using ElementType = double;
+    using InputParameters = typename InputLayer<ElementType>::InputParameters;
+    using LayerParameters = typename Layer<ElementType>::LayerParameters;
+    using TensorType = typename Layer<ElementType>::TensorType;
+    using Shape = typename Layer<ElementType>::Shape;
+    using VectorType = typename Layer<ElementType>::VectorType;
+
+    typename NeuralNetworkPredictor<ElementType>::InputLayerReference inputLayer;
+    typename NeuralNetworkPredictor<ElementType>::Layers layers;
+    const Shape dataShape = { rows, columns, channels };
+    const Shape convOutputShape = { rows, columns, numFilters };
+    const Shape poolingOutputShape = { rows / 2, columns / 2, numFilters };
+
+    // Input layer
+    InputParameters inputParams{ dataShape, NoPadding(), { rows + 2, columns + 2, channels }, ZeroPadding(1), 1.0 };
+    inputLayer = std::make_unique<InputLayer<ElementType>>(inputParams);
+
+    // Convolutional layer
+    LayerParameters layerParameters{ inputLayer->GetOutput(), ZeroPadding(1), convOutputShape, NoPadding() };
+    ConvolutionalParameters convolutionalParams{ 3, 1, ConvolutionMethod::columnwise, 1 };
+    TensorType convWeights(numFilters * 3, 3, channels);
+    FillRandomTensor(convWeights);
+    layers.push_back(std::unique_ptr<Layer<ElementType>>(new ConvolutionalLayer<ElementType>(layerParameters, convolutionalParams, convWeights)));
+
+    // Bias layer
+    layerParameters = { layers.back()->GetOutput(), NoPadding(), convOutputShape, NoPadding() };
+    VectorType bias(numFilters);
+    FillRandomVector(bias);
+    layers.push_back(std::unique_ptr<Layer<ElementType>>(new BiasLayer<ElementType>(layerParameters, bias)));
+
+    // Leaky ReLU activation layer
+    layerParameters = { layers.back()->GetOutput(), NoPadding(), convOutputShape, NoPadding() };
+    layers.push_back(std::unique_ptr<Layer<ElementType>>(new ActivationLayer<ElementType, LeakyReLUActivation>(layerParameters)));
+
+    // Max pooling layer
+    layerParameters = { layers.back()->GetOutput(), NoPadding(), poolingOutputShape, NoPadding() };
+    PoolingParameters poolingParameters{ 2, 2 };
+    layers.push_back(std::unique_ptr<Layer<ElementType>>(new PoolingLayer<ElementType, MaxPoolingFunction>(layerParameters, poolingParameters)));
+
+    NeuralNetworkPredictor<ElementType> neuralNetwork(std::move(inputLayer), std::move(layers));
+    std::vector<ElementType> input(rows * columns * channels);
+    FillRandomVector(input);
+
+    // Create model
+    model::Model model;
+    auto inputNode = model.AddNode<model::InputNode<double>>(GetShapeSize(neuralNetwork.GetInputShape()));
+    auto predictorNode = model.AddNode<nodes::NeuralNetworkPredictorNode<double>>(inputNode->output, neuralNetwork);
+    auto map = model::Map(model, { { "input", inputNode } }, { { "output", predictorNode->output } });
+
+    model::MapCompilerParameters settings;
+    settings.compilerSettings.optimize = true;
+    settings.fuseLinearFunctionNodes = true;
+    model::IRMapCompiler compiler(settings);
+    auto compiledMap = compiler.Compile(map);
+
+    // The pooling reads the convolution's output directly, and the epilogue only runs over the pooled output
+    const auto& compiledModel = compiledMap.GetModel();
+    auto epilogueNodes = compiledModel.GetNodesByType<nodes::BroadcastBinaryFunctionNode<ElementType, nodes::BroadcastBiasActivationFunction<ElementType, nodes::LeakyReLUActivationFunction<ElementType>>>>();
+    auto numPoolingNodes = compiledModel.GetNodesByType<nodes::PoolingLayerNode<ElementType, MaxPoolingFunction>>().size();
+    testing::ProcessTest("Testing fused convolutional and pooling layers", numPoolingNodes == 1 && epilogueNodes.size() == 1 && epilogueNodes[0]->output.Size() == GetShapeSize(poolingOutputShape));
+
+    // compare output
+    std::vector<std::vector<double>> signal = { input };
+    VerifyCompiledOutput(map, compiledMap, signal, "Fused convolutional and pooling layers");
+}
+
 //
 // Recurrent layer nodes (Recurrent, GRU, LSTM)
 //
@@ -2727,7 +3968,7 @@ void TestLSTMNode()
     model::IRMapCompiler compiler(settings);
     auto compiledMap = compiler.Compile(map);
 
-    // compare computed vs. compiled output
-    std::vector<std::vector<ElementType>> signal = { input.ToArray() };
+    // compare computed vs. compiled output over several time steps, so the hidden and cell state are carried forward
+    std::vector<std::vector<ElementType>> signal = { input.ToArray(), { 0.5, -1.0, 2.0, 0.25 }, { -3.0, 0.1, 0.0, 1.5 } };
     VerifyCompiledOutput(map, compiledMap, signal, computeNode->GetRuntimeTypeName());
 }
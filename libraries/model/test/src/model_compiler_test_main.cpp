@@ -65,12 +65,25 @@ void TestIRCompiler()
     TestCompilableConstantNode();
     TestCompilableDotProductNode();
     TestCompilableDelayNode();
+    TestCompilableBufferNode();
     TestCompilableDTWDistanceNode();
+    TestCompilableForestPredictorNode(model::ForestEvaluation::branching);
+    TestCompilableForestPredictorNode(model::ForestEvaluation::quickScorer);
     TestCompilableMulticlassDTW();
+    TestCompilableSparseLinearPredictorNode();
     TestCompilableScalarSumNode();
     TestCompilableSumNode();
     TestCompilableUnaryOperationNode();
     TestCompilableBinaryOperationNode();
+    TestCompilableMemoryPlanner();
+    TestCompilableReentrantMap();
+    TestCompilablePredictBatch();
+    TestCompilablePredictBatchMatrixProducts();
+    TestCompilableConcurrentCompute();
+    TestCompilableConcurrentParallelCompute();
+    TestCompilableReentrantParallelFor();
+    TestCompilableSequentialThreadState();
+    TestCompilableReentrantNodeState();
     TestCompilableScalarBinaryPredicateNode();
     TestCompilableBinaryPredicateNode();
     TestCompilableMultiplexerNode();
@@ -87,7 +100,11 @@ void TestIRCompiler()
     TestCompilableSourceNode();
     TestCompilableSinkNode();
     TestCompilableClockNode();
-    TestCompilableFFTNode();
+    TestCompilableFFTNode(8);
+    TestCompilableFFTNode(12); // mixed radix
+    TestCompilableFFTNode(14); // packed into an FFT of prime length
+    TestCompilableFFTNode(15); // odd length
+    TestCompilableFFTNode(256);
 
     TestPerformanceCounters();
     TestCompilableDotProductNode2<float>(3); // uses IR
@@ -106,6 +123,8 @@ void TestIRCompiler()
     // TestNeuralNetworkPredictorNode6();
 
     TestFusedLinearLayerNodes(4, 6, 8);
+    TestFusedConvolutionalLayerNodes(4, 6, 3, 8);
+    TestFusedConvolutionalPoolingLayerNodes(6, 8, 3, 8);
 
     // TestInputLayerNode(0);
     TestInputLayerNode(1);
@@ -152,6 +171,9 @@ void TestIRCompiler()
     TestMeanPoolingLayerNode(8, 8, 16, 6, 6, 3, 1, 0, 0);
     TestMeanPoolingLayerNode(8, 8, 16, 6, 6, 3, 1, 0, 1);
     TestMeanPoolingLayerNode(8, 8, 16, 6, 6, 3, 1, 0, 2);
+
+    TestParallelPoolingLayerNode(10, 10, 6, 5, 5, 3, 2, 1, 0); // 6 channels: one vector of 4, plus 2 scalar
+    TestParallelPoolingLayerNode(8, 8, 16, 6, 6, 3, 1, 0, 1);
     // TestMeanPoolingLayerNode(8, 8, 16, 6, 6, 3, 1, 1, 0);
 
     // TestMeanPoolingLayerNode(8, 8, 16, 2, 1, 2, 1, 0, 0);
@@ -179,11 +201,22 @@ void TestIRCompiler()
 
     TestConvolutionalLayerNode(ConvolutionType::Diagonal); // Input padding must be set correctly (to floor(filterWidth/2))
 
+    TestConvolutionalLayerNode(ConvolutionType::Winograd);
+    TestConvolutionalLayerNode2(ConvolutionType::Winograd, 1, 0);
+    TestStackedWinogradConvolutionalLayerNodes();
+
+    TestGroupedConvolutionalLayerNode(10, 10, 10); // depthwise
+    TestGroupedConvolutionalLayerNode(8, 8, 8, 2); // depthwise, strided
+    TestGroupedConvolutionalLayerNode(6, 12, 3); // 2 input channels and 4 filters per group
+
     TestFullyConnectedLayerNode();
     // TestFullyConnectedLayerNode(0, 1); // Fully-connected layer nodes can't have padding (yet)
     // TestFullyConnectedLayerNode(0, 2); // Fully-connected layer nodes can't have padding (yet)
     // TestFullyConnectedLayerNode(1, 1); // Fully-connected layer nodes can't have padding (yet)
 
+    TestQuantizedLayerNodes();
+    TestHalfPrecisionWeights();
+
     TestProtoNNPredictorMap();
     TestMultiSourceSinkMap();
 
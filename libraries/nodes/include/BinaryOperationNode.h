@@ -79,6 +79,8 @@ namespace nodes
         void WriteToArchive(utilities::Archiver& archiver) const override;
         void ReadFromArchive(utilities::Unarchiver& archiver) override;
         bool HasState() const override { return true; } // stored state: operation
+        bool CanReuseOutputMemory(const model::OutputPortBase& port) const override { return true; }
+        const model::InputPortBase* GetInPlaceInputPort(const model::OutputPortBase& port) const override { return &_input1; }
 
     private:
         void CompileLoop(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function);
@@ -9,8 +9,8 @@
 #pragma once
 
 // emitters
-#include "IRAsyncTask.h"
 #include "IREmitter.h"
+#include "IRFunctionEmitter.h"
 #include "IRVectorUtilities.h"
 #include "LLVMUtilities.h"
 
@@ -31,6 +31,7 @@
 #include "TypeName.h"
 
 // stl
+#include <algorithm>
 #include <cassert>
 #include <functional>
 #include <numeric>
@@ -255,6 +256,8 @@ namespace nodes
         size_t NumPrimaryInputDimensions() const { return _inputLayout.NumDimensions(); }
 
         bool HasState() const override { return true; } // stored state: function, broadcast dimension, and padding value
+        bool CanReuseOutputMemory(const model::OutputPortBase& port) const override;
+        const model::InputPortBase* GetInPlaceInputPort(const model::OutputPortBase& port) const override;
 
         virtual const model::InputPort<ValueType>& GetPrimaryInput() const = 0;
         virtual const model::InputPort<ValueType>* GetSecondaryInput(int index) const = 0;
@@ -268,7 +271,6 @@ namespace nodes
         // Helpers for generating nested loops to visit all input/output values
         void ComputeDimensionLoop(size_t dimension, std::vector<ValueType>& output, size_t prevInputDimensionOffset, size_t prevOutputDimensionOffset, std::vector<ValueType>& secondaryValues) const;
         void EmitComputeDimensionLoop(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function, size_t dimension, llvm::Value* begin, llvm::Value* end, llvm::Value* primaryInput, const std::vector<llvm::Value*>& secondaryInputs, llvm::Value* output, llvm::Value* prevInputDimensionOffset, llvm::Value* prevOutputDimensionOffset, std::vector<llvm::Value*>& secondaryValues) const;
-        emitters::IRFunctionEmitter GetTaskFunction(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function, const emitters::LLVMTypeList& portTypes) const;
 
         void WriteToArchive(utilities::Archiver& archiver) const override;
         void ReadFromArchive(utilities::Unarchiver& archiver) override;
@@ -416,7 +418,6 @@ namespace nodes
         using BroadcastFunctionNode<ValueType, FunctionType>::GetBroadcastDimension;
         using BroadcastFunctionNode<ValueType, FunctionType>::NumPrimaryInputDimensions;
         using BroadcastFunctionNode<ValueType, FunctionType>::GetFunction;
-        using BroadcastFunctionNode<ValueType, FunctionType>::NumElements;
 
         void Copy(model::ModelTransformer& transformer) const override;
         void WriteToArchive(utilities::Archiver& archiver) const override;
@@ -31,7 +31,32 @@ namespace ell
 {
 namespace nodes
 {
-    /// <summary> A node that buffers the input and allows access to the buffer. </summary>
+    /// <summary>
+    /// Interface for nodes that can read the window of a `BufferNode` directly from the buffer's storage, rather than
+    /// from a copy of it in the buffer's output. See `EnsureBufferWindowEmitted`.
+    /// </summary>
+    class BufferWindowReader
+    {
+    public:
+        virtual ~BufferWindowReader() = default;
+
+        /// <summary>
+        /// Gets the input port that may read a buffer's window. The node must read this port with
+        /// `EnsureBufferWindowEmitted`, and must not read the buffer's output through any other port.
+        /// </summary>
+        ///
+        /// <returns> The input port. </returns>
+        virtual const model::InputPortBase& GetWindowInput() const = 0;
+    };
+
+    /// <summary>
+    /// A node that buffers the input and allows access to the buffer.
+    ///
+    /// When compiled, the samples are kept in a circular buffer with a head index, so each step only writes the new
+    /// samples. The buffer is stored twice, back to back, so the window is always contiguous: it starts at the head.
+    /// If every node that reads the output is a `BufferWindowReader` that reads the whole window, those nodes read it
+    /// in place. Otherwise, the window is copied to the output every step.
+    /// </summary>
     template <typename ValueType>
     class BufferNode : public model::CompilableNode
     {
@@ -68,6 +93,19 @@ namespace nodes
         /// <returns> The window size </returns>
         size_t GetWindowSize() const { return _windowSize; }
 
+        /// <summary> Indicates if the nodes that read the output read the window in place, from the circular buffer. </summary>
+        ///
+        /// <returns> `true` if the window is read in place, `false` if it's copied to the output. </returns>
+        bool IsWindowReadInPlace() const;
+
+        /// <summary> Emits a pointer to the start of the current window in the circular buffer. </summary>
+        ///
+        /// <param name="compiler"> The compiler the circular buffer belongs to. </param>
+        /// <param name="function"> The function being emitted. </param>
+        ///
+        /// <returns> A pointer to the oldest sample in the window. </returns>
+        llvm::Value* EmitWindowPointer(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function) const;
+
     protected:
         void Compute() const override;
         void Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function) override;
@@ -75,6 +113,10 @@ namespace nodes
         void WriteToArchive(utilities::Archiver& archiver) const override;
         void ReadFromArchive(utilities::Unarchiver& archiver) override;
 
+    private:
+        llvm::Value* GetRingBuffer(model::IRMapCompiler& compiler) const;
+        llvm::Value* GetRingBufferHead(model::IRMapCompiler& compiler) const;
+
         // Inputs
         model::InputPort<ValueType> _input;
 
@@ -85,6 +127,28 @@ namespace nodes
         mutable std::vector<ValueType> _samples;
         size_t _windowSize;
     };
+
+    /// <summary> Indicates if a node's input reads the window of a `BufferNode` in place. </summary>
+    ///
+    /// <param name="input"> The input port. </param>
+    ///
+    /// <returns> `true` if the input is the full output of a `BufferNode` whose window is read in place. </returns>
+    template <typename ValueType>
+    bool IsBufferWindowReadInPlace(const model::InputPort<ValueType>& input);
+
+    /// <summary>
+    /// Gets a pointer to the values of an input port that may be the output of a `BufferNode`. If the buffer's window
+    /// is read in place, this is a pointer into the buffer's circular buffer, and the node reading it must be compiled
+    /// inline (see `IsBufferWindowReadInPlace`). Otherwise, it's the same as `IRMapCompiler::EnsurePortEmitted`.
+    /// </summary>
+    ///
+    /// <param name="compiler"> The compiler. </param>
+    /// <param name="function"> The function being emitted. </param>
+    /// <param name="input"> The input port. </param>
+    ///
+    /// <returns> A pointer to the input's values. </returns>
+    template <typename ValueType>
+    llvm::Value* EnsureBufferWindowEmitted(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function, const model::InputPort<ValueType>& input);
 }
 }
 
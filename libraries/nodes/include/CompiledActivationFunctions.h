@@ -261,7 +261,63 @@ namespace nodes
         /// <returns> The name of this type. </returns>
         std::string GetRuntimeTypeName() const { return GetTypeName(); }
     };
-    
+
+    /// <summary> A bias followed by an activation function, f(x + b). Used as the epilogue of a layer whose scaling has been folded into its weights. </summary>
+    template <typename ValueType, typename ActivationFunctionType>
+    class BroadcastBiasActivationFunction : public BroadcastBinaryFunction<ValueType>
+    {
+    public:
+        BroadcastBiasActivationFunction() = default;
+
+        /// <summary> Constructor </summary>
+        ///
+        /// <param name="activation"> The activation function to apply after adding the bias. </param>
+        BroadcastBiasActivationFunction(ActivationFunctionType activation)
+            : _activation(activation) {}
+
+        /// <summary> Computes the activation of the biased value (on the host machine) </summary>
+        ///
+        /// <param name="x"> The value </param>
+        /// <param name="bias"> The bias to add to the value </param>
+        ///
+        /// <returns> The value of the function f(x + bias) </returns>
+        ValueType Compute(ValueType x, ValueType bias) const override;
+        using BroadcastBinaryFunction<ValueType>::Compute;
+
+        /// <summary> Emits IR to compute the activation of the biased value </summary>
+        ///
+        /// <param name="function"> The function being compiled. </param>
+        /// <param name="x"> The value </param>
+        /// <param name="bias"> The bias to add to the value </param>
+        ///
+        /// <returns> The value of the function f(x + bias) </returns>
+        llvm::Value* Compile(emitters::IRFunctionEmitter& function, llvm::Value* x, llvm::Value* bias) const override;
+        using BroadcastBinaryFunction<ValueType>::Compile;
+
+        /// <summary> Indicates if the function can operate on vector types </summary>
+        ///
+        /// <returns> true if the function can operate on vector types </returns>
+        bool CanUseVectorTypes() const { return false; }
+
+        /// <summary> Gets the activation function applied after the bias. </summary>
+        ///
+        /// <returns> The activation function. </returns>
+        const ActivationFunctionType& GetActivationFunction() const { return _activation; }
+
+        /// <summary> Gets the name of this type (for serialization). </summary>
+        ///
+        /// <returns> The name of this type. </returns>
+        static std::string GetTypeName() { return utilities::GetCompositeTypeName<ValueType, ActivationFunctionType>("BroadcastBiasActivationFunction"); }
+
+        /// <summary> Gets the name of this type (for serialization). </summary>
+        ///
+        /// <returns> The name of this type. </returns>
+        std::string GetRuntimeTypeName() const { return GetTypeName(); }
+
+    private:
+        ActivationFunctionType _activation;
+    };
+
     //
     // Helper functions
     //
@@ -18,6 +18,7 @@
 #include "OutputPort.h"
 
 // emitters
+#include "IRHalfPrecision.h"
 #include "VectorVariable.h"
 
 // predictors
@@ -30,6 +31,7 @@
 
 // stl
 #include <memory>
+#include <type_traits>
 #include <vector>
 
 namespace ell
@@ -103,6 +105,21 @@ namespace nodes
     ///
     /// <returns> The node added to the model. </returns>
     ConstantNode<double>* AddNodeToModelTransformer(const model::PortElements<double>& input, const predictors::ConstantPredictor& predictor, model::ModelTransformer& transformer);
+
+    /// <summary>
+    /// Emits the input of a compiled node that holds the matrix A passed to `CallGEMV` or `CallGEMM`. If the compiler
+    /// parameters ask for half-precision weights and the input is the whole output of a `ConstantNode<float>`, the
+    /// matrix is emitted as a constant array of half-precision values, which the matrix functions widen to float as
+    /// they read them. Otherwise, this is the same as `IRMapCompiler::EnsurePortEmitted`.
+    /// </summary>
+    ///
+    /// <param name="compiler"> The compiler. </param>
+    /// <param name="function"> The function being emitted. </param>
+    /// <param name="weights"> The input port holding the matrix. </param>
+    ///
+    /// <returns> A pointer to the matrix. </returns>
+    template <typename ValueType>
+    llvm::Value* EnsureWeightsEmitted(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function, const model::InputPort<ValueType>& weights);
 }
 }
 
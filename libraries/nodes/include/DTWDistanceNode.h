@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include "BufferNode.h"
 #include "SumNode.h"
 
 // model
@@ -34,7 +35,7 @@ namespace nodes
 {
     /// <summary> A node that computes the dynamic time-warping distance between its inputs </summary>
     template <typename ValueType>
-    class DTWDistanceNode : public model::CompilableNode
+    class DTWDistanceNode : public model::CompilableNode, public BufferWindowReader
     {
     public:
         /// @name Input and Output Ports
@@ -75,11 +76,17 @@ namespace nodes
         /// <summary></summary>
         std::vector<std::vector<ValueType>> GetPrototype() const { return _prototype; }
 
+        /// <summary> Gets the input port that may read a buffer's window. </summary>
+        ///
+        /// <returns> The input port. </returns>
+        const model::InputPortBase& GetWindowInput() const override { return _input; }
+
     protected:
         void Reset() const;
         void Compute() const override;
         void Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function) override;
         bool HasState() const override { return true; }
+        bool ShouldCompileInline() const override { return IsBufferWindowReadInPlace(_input) || CompilableNode::ShouldCompileInline(); }
         void WriteToArchive(utilities::Archiver& archiver) const override;
         void ReadFromArchive(utilities::Unarchiver& archiver) override;
 
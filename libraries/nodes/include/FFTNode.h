@@ -8,6 +8,8 @@
 
 #pragma once
 
+#include "BufferNode.h"
+
 // model
 #include "CompilableNode.h"
 #include "IRMapCompiler.h"
@@ -31,9 +33,31 @@ namespace ell
 {
 namespace nodes
 {
-    /// <summary> A node that performs a real-valued discrete ("fast") fourier transform (FFT) on its input </summary>
+    /// <summary>
+    /// Interface for nodes that can read the output of an `FFTNode` from its complex spectrum, computing the magnitudes
+    /// of only the frequencies they use. See `FFTNode::GetSpectrum`.
+    /// </summary>
+    class FFTSpectrumReader
+    {
+    public:
+        virtual ~FFTSpectrumReader() = default;
+
+        /// <summary>
+        /// Gets the input port that may read an FFT's output. If the FFT's spectrum is read in place, the node must read
+        /// the magnitudes from the spectrum instead of this port, and must not read the FFT's output any other way.
+        /// </summary>
+        ///
+        /// <returns> The input port. </returns>
+        virtual const model::InputPortBase& GetSpectrumInput() const = 0;
+    };
+
+    /// <summary>
+    /// A node that performs a real-valued discrete ("fast") fourier transform (FFT) on its input, and outputs the
+    /// magnitude of the first half of the spectrum. When compiled, an input of even length N is packed into a complex
+    /// signal of length N/2 and transformed with a mixed-radix FFT, using twiddle factors stored as module constants.
+    /// </summary>
     template <typename ValueType>
-    class FFTNode : public model::CompilableNode
+    class FFTNode : public model::CompilableNode, public BufferWindowReader
     {
     public:
         /// @name Input and Output Ports
@@ -63,16 +87,41 @@ namespace nodes
         /// <summary> Makes a copy of this node in the model being constructed by the transformer </summary>
         void Copy(model::ModelTransformer& transformer) const override;
 
+        /// <summary> Gets the input port that may read a buffer's window. </summary>
+        ///
+        /// <returns> The input port. </returns>
+        const model::InputPortBase& GetWindowInput() const override { return _input; }
+
+        /// <summary>
+        /// Indicates if the nodes that read the output read the complex spectrum instead, so the magnitudes aren't
+        /// computed and stored by this node.
+        /// </summary>
+        ///
+        /// <returns> `true` if the spectrum is read in place, `false` if the magnitudes are written to the output. </returns>
+        bool IsSpectrumReadInPlace() const;
+
+        /// <summary>
+        /// Gets the array the compiled node writes the complex spectrum to, if it's read in place. It holds the same
+        /// number of values as the output, as pairs of (real, imaginary) values. It's one of the node's buffers, so in
+        /// reentrant mode it's part of the workspace.
+        /// </summary>
+        ///
+        /// <param name="compiler"> The compiler being used. </param>
+        /// <param name="function"> The function being emitted. </param>
+        ///
+        /// <returns> A pointer to the spectrum array. </returns>
+        llvm::Value* GetSpectrum(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function) const;
+
     protected:
         void Compute() const override;
         void Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function) override;
         void WriteToArchive(utilities::Archiver& archiver) const override;
         void ReadFromArchive(utilities::Unarchiver& archiver) override;
         bool HasState() const override { return false; }
+        bool ShouldCompileInline() const override { return IsBufferWindowReadInPlace(_input) || IsSpectrumReadInPlace() || CompilableNode::ShouldCompileInline(); }
 
     private:
         // FFT function implemenations
-        llvm::Function* GetRealFFTFunction(emitters::IRModuleEmitter& moduleEmitter, size_t length);
         llvm::Function* GetFFTFunction(emitters::IRModuleEmitter& moduleEmitter, size_t length);
         llvm::Function* GetFFTFunction(emitters::IRModuleEmitter& moduleEmitter);
 
@@ -86,5 +135,13 @@ namespace nodes
         // Output
         model::OutputPort<ValueType> _output;
     };
+
+    /// <summary> Gets the `FFTNode` whose spectrum a node's input reads in place, if any. </summary>
+    ///
+    /// <param name="input"> The input port. </param>
+    ///
+    /// <returns> The FFT node, if the input is its full output and its spectrum is read in place, else `nullptr`. </returns>
+    template <typename ValueType>
+    const FFTNode<ValueType>* GetInPlaceSpectrumFFTNode(const model::InputPort<ValueType>& input);
 }
 }
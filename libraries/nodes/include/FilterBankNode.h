@@ -8,6 +8,9 @@
 
 #pragma once
 
+#include "BufferNode.h"
+#include "FFTNode.h"
+
 // model
 #include "CompilableNode.h"
 #include "IRMapCompiler.h"
@@ -38,7 +41,7 @@ namespace nodes
     /// Base class for nodes that perform elementwise multiply between a set of filters and the input frequency response
     /// </summary>
     template <typename ValueType>
-    class FilterBankNode : public model::CompilableNode
+    class FilterBankNode : public model::CompilableNode, public BufferWindowReader, public FFTSpectrumReader
     {
     public:
         /// @name Input and Output Ports
@@ -47,6 +50,16 @@ namespace nodes
         const model::OutputPort<ValueType>& output = _output;
         /// @}
 
+        /// <summary> Gets the input port that may read a buffer's window. </summary>
+        ///
+        /// <returns> The input port. </returns>
+        const model::InputPortBase& GetWindowInput() const override { return _input; }
+
+        /// <summary> Gets the input port that may read an FFT's output. </summary>
+        ///
+        /// <returns> The input port. </returns>
+        const model::InputPortBase& GetSpectrumInput() const override { return _input; }
+
     protected:
         FilterBankNode(const dsp::TriangleFilterBank& filters);
         FilterBankNode(const model::PortElements<ValueType>& input, const dsp::TriangleFilterBank& filters);
@@ -55,6 +68,7 @@ namespace nodes
         void WriteToArchive(utilities::Archiver& archiver) const override;
         void ReadFromArchive(utilities::Unarchiver& archiver) override;
         bool HasState() const override { return true; } // Stored state: filters
+        bool ShouldCompileInline() const override { return IsBufferWindowReadInPlace(_input) || CompilableNode::ShouldCompileInline(); }
 
         // Inputs
         model::InputPort<ValueType> _input;
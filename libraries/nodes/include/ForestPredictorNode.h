@@ -9,10 +9,16 @@
 #pragma once
 
 // model
+#include "CompilableNode.h"
+#include "IRMapCompiler.h"
+#include "MapCompiler.h"
 #include "Model.h"
 #include "ModelTransformer.h"
 #include "Node.h"
 
+// emitters
+#include "IRFunctionEmitter.h"
+
 // predictors
 #include "ConstantNode.h"
 #include "ForestPredictor.h"
@@ -25,12 +31,37 @@ namespace ell
 {
 namespace nodes
 {
-    /// <summary> Implements a forest node, which wraps the forest predictor. </summary>
+    namespace detail
+    {
+        /// <summary>
+        /// Emits the evaluation of a forest of single-element threshold splits and constant edge predictors, without
+        /// refining it into a graph of nodes. See `model::ForestEvaluation`.
+        /// </summary>
+        ///
+        /// <param name="compiler"> The map compiler. </param>
+        /// <param name="function"> The function being emitted. </param>
+        /// <param name="forest"> The forest. </param>
+        /// <param name="stateId"> An identifier for the forest's tables in the module. </param>
+        /// <param name="input"> The input port. </param>
+        /// <param name="output"> The output port: the sum of the trees, plus the forest's bias. </param>
+        /// <param name="treeOutputs"> The output port for the individual trees. </param>
+        /// <param name="edgeIndicatorVector"> The output port that indicates the edges on the path to each tree's leaf. </param>
+        void CompileForest(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function, const predictors::SimpleForestPredictor& forest, const std::string& stateId, const model::InputPort<double>& input, const model::OutputPort<double>& output, const model::OutputPort<double>& treeOutputs, const model::OutputPort<bool>& edgeIndicatorVector);
+
+        // Other kinds of forests are refined instead of compiled
+        template <typename ForestType>
+        void CompileForest(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function, const ForestType& forest, const std::string& stateId, const model::InputPort<double>& input, const model::OutputPort<double>& output, const model::OutputPort<double>& treeOutputs, const model::OutputPort<bool>& edgeIndicatorVector);
+    }
+
+    /// <summary>
+    /// Implements a forest node, which wraps the forest predictor. The compiler either refines the node into a graph of
+    /// nodes, or (for simple forests) compiles it directly, according to `model::MapCompilerParameters::forestEvaluation`.
+    /// </summary>
     ///
     /// <typeparam name="SplitRuleType"> The split rule type. </typeparam>
     /// <typeparam name="EdgePredictorType"> The edge predictor type. </typeparam>
     template <typename SplitRuleType, typename EdgePredictorType>
-    class ForestPredictorNode : public model::Node
+    class ForestPredictorNode : public model::CompilableNode
     {
     public:
         /// @name Input and Output Ports
@@ -72,8 +103,15 @@ namespace nodes
         /// <summary> Refines this node in the model being constructed by the transformer </summary>
         bool Refine(model::ModelTransformer& transformer) const override;
 
+        /// <summary>
+        /// Indicates if this node compiles itself to code, instead of being refined. Only simple forests do, when the
+        /// compiler isn't asked to refine them.
+        /// </summary>
+        bool IsCompilable(const model::MapCompiler* compiler) const override;
+
     protected:
         void Compute() const override;
+        void Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function) override;
         void WriteToArchive(utilities::Archiver& archiver) const override;
         void ReadFromArchive(utilities::Unarchiver& archiver) override;
 
@@ -78,18 +78,14 @@ namespace nodes
     public:
         /// @name Input and Output Ports
         /// @{
-        static constexpr const char* updateWeightsPortName = "updateWeights";
-        static constexpr const char* resetWeightsPortName = "resetWeights";
+        static constexpr const char* gateWeightsPortName = "gateWeights";
         static constexpr const char* hiddenWeightsPortName = "hiddenWeights";
-        static constexpr const char* updateBiasPortName = "updateBias";
-        static constexpr const char* resetBiasPortName = "resetBias";
+        static constexpr const char* gateBiasPortName = "gateBias";
         static constexpr const char* hiddenBiasPortName = "hiddenBias";
         const model::InputPort<ValueType>& input = _input;
-        const model::InputPort<ValueType>& updateWeights = _updateWeights;
-        const model::InputPort<ValueType>& resetWeights = _resetWeights;
+        const model::InputPort<ValueType>& gateWeights = _gateWeights;
         const model::InputPort<ValueType>& hiddenWeights = _hiddenWeights;
-        const model::InputPort<ValueType>& updateBias = _updateBias;
-        const model::InputPort<ValueType>& resetBias = _resetBias;
+        const model::InputPort<ValueType>& gateBias = _gateBias;
         const model::InputPort<ValueType>& hiddenBias = _hiddenBias;
         const model::OutputPort<ValueType>& output = _output;
         /// @}
@@ -100,20 +96,16 @@ namespace nodes
         /// <summary> Constructor. </summary>
         ///
         /// <param name="input"> The ports to get input data from. </param>
-        /// <param name="updateWeights"> The update weights. </param>
-        /// <param name="resetWeights"> The reset weights. </param>
+        /// <param name="gateWeights"> The update and reset weights, stacked into one (2 * hiddenSize) x (inputSize + hiddenSize) row-major matrix. </param>
         /// <param name="hiddenWeights"> The hidden weights. </param>
-        /// <param name="updateBias"> The update bias. </param>
-        /// <param name="resetBias"> The reset bias. </param>
+        /// <param name="gateBias"> The update and reset biases, stacked into one vector of size 2 * hiddenSize. </param>
         /// <param name="hiddenBias"> The hidden bias. </param>
         /// <param name="inputMemoryLayout"> The layout of the input data. </param>
         /// <param name="outputMemoryLayout"> The layout of the output data. </param>
         GRUNode(const model::PortElements<ValueType>& input,
-                       const model::PortElements<ValueType>& updateWeights,
-                       const model::PortElements<ValueType>& resetWeights,
+                       const model::PortElements<ValueType>& gateWeights,
                        const model::PortElements<ValueType>& hiddenWeights,
-                       const model::PortElements<ValueType>& updateBias,
-                       const model::PortElements<ValueType>& resetBias,
+                       const model::PortElements<ValueType>& gateBias,
                        const model::PortElements<ValueType>& hiddenBias,
                        const model::PortMemoryLayout& inputMemoryLayout,
                        const model::PortMemoryLayout& outputMemoryLayout);
@@ -157,11 +149,9 @@ namespace nodes
     private:
         // Input
         model::InputPort<ValueType> _input;
-        model::InputPort<ValueType> _updateWeights;
-        model::InputPort<ValueType> _resetWeights;
+        model::InputPort<ValueType> _gateWeights;
         model::InputPort<ValueType> _hiddenWeights;
-        model::InputPort<ValueType> _updateBias;
-        model::InputPort<ValueType> _resetBias;
+        model::InputPort<ValueType> _gateBias;
         model::InputPort<ValueType> _hiddenBias;
 
         // Output
@@ -169,11 +159,6 @@ namespace nodes
 
         model::PortMemoryLayout _inputMemoryLayout;
         model::PortMemoryLayout _outputMemoryLayout;
-
-        void ApplySoftmax(emitters::IRFunctionEmitter& function, llvm::Value* data, size_t dataLength);
-
-        template <typename ActivationType>
-        void ApplyActivation(emitters::IRFunctionEmitter& function, ActivationType& activationFunction, llvm::Value* data, size_t dataLength);
     };
 }
 }
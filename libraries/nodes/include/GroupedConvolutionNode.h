@@ -0,0 +1,124 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     GroupedConvolutionNode.h (nodes)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+// model
+#include "IRMapCompiler.h"
+#include "ModelTransformer.h"
+#include "PortElements.h"
+#include "PortMemoryLayout.h"
+
+// predictors
+#include "ConvolutionalLayer.h"
+
+// stl
+#include <string>
+#include <type_traits>
+
+namespace ell
+{
+namespace nodes
+{
+    /// <summary>
+    /// A ConvolutionalLayerNode whose filters only see a group of the input channels (for instance, a depthwise
+    /// convolution) refines itself into a GroupedConvolutionNode, which slides the filters directly over the input
+    /// instead of reshaping it into columns. The compiled code is vectorized along the filters.
+    /// </summary>
+    template <typename ValueType>
+    class GroupedConvolutionNode : public model::CompilableNode
+    {
+    public:
+        /// @name Input and Output Ports
+        /// @{
+        static constexpr const char* filterWeightsPortName = "filterWeights";
+        const model::InputPort<ValueType>& input = _input;
+        const model::InputPort<ValueType>& filterWeights = _filterWeights;
+        const model::OutputPort<ValueType>& output = _output;
+        /// @}
+
+        /// <summary> Default constructor. </summary>
+        GroupedConvolutionNode();
+
+        /// <summary> Constructor. </summary>
+        ///
+        /// <param name="input"> The ports to get input data from. </param>
+        /// <param name="inputMemoryLayout"> The layout of the input data. </param>
+        /// <param name="filterWeights"> The filters, as reordered by `predictors::neural::GetGroupedConvolutionFilters`. </param>
+        /// <param name="outputMemoryLayout"> The layout of the output data. </param>
+        /// <param name="convolutionalParameters"> The convolutional parameters. </param>
+        /// <param name="numGroups"> The number of groups the input channels and filters are split into. </param>
+        GroupedConvolutionNode(const model::PortElements<ValueType>& input,
+                               const model::PortMemoryLayout& inputMemoryLayout,
+                               const model::PortElements<ValueType>& filterWeights,
+                               const model::PortMemoryLayout& outputMemoryLayout,
+                               const predictors::neural::ConvolutionalParameters& convolutionalParameters,
+                               size_t numGroups);
+
+        /// <summary> Gets information about the input memory layout </summary>
+        const model::PortMemoryLayout& GetInputMemoryLayout() const { return _inputMemoryLayout; }
+
+        /// <summary> Gets information about the output memory layout </summary>
+        const model::PortMemoryLayout& GetOutputMemoryLayout() const { return _outputMemoryLayout; }
+
+        /// <summary> Get the parameters used to control convolution. </summary>
+        ///
+        /// <returns> A ConvolutionalParameters struct. </returns>
+        const predictors::neural::ConvolutionalParameters& GetConvolutionalParameters() const { return _convolutionalParameters; }
+
+        /// <summary> Gets the number of groups the input channels and filters are split into. </summary>
+        ///
+        /// <returns> The number of groups. </returns>
+        size_t NumGroups() const { return _numGroups; }
+
+        /// <summary> Gets the name of this type (for serialization). </summary>
+        ///
+        /// <returns> The name of this type. </returns>
+        static std::string GetTypeName() { return utilities::GetCompositeTypeName<ValueType>("GroupedConvolutionNode"); }
+
+        /// <summary> Gets the name of this type (for serialization). </summary>
+        ///
+        /// <returns> The name of this type. </returns>
+        std::string GetRuntimeTypeName() const override { return GetTypeName(); }
+
+        /// <summary> Makes a copy of this node into the model being constructed by the transformer </summary>
+        ///
+        /// <param name="transformer"> The `ModelTransformer` object currently creating a new model </param>
+        void Copy(model::ModelTransformer& transformer) const override;
+
+    protected:
+        void Compute() const override;
+        void Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function) override;
+        bool CanReuseOutputMemory(const model::OutputPortBase& port) const override;
+        void WriteToArchive(utilities::Archiver& archiver) const override
+        {
+            throw utilities::LogicException(utilities::LogicExceptionErrors::notImplemented);
+        }
+
+        void ReadFromArchive(utilities::Unarchiver& archiver) override
+        {
+            throw utilities::LogicException(utilities::LogicExceptionErrors::notImplemented);
+        }
+        bool HasState() const override { return true; } // stored state: convolutional parameters, number of groups and memory layout
+
+    private:
+        // Input
+        model::InputPort<ValueType> _input;
+        model::InputPort<ValueType> _filterWeights;
+
+        // Output
+        model::OutputPort<ValueType> _output;
+
+        model::PortMemoryLayout _inputMemoryLayout;
+        model::PortMemoryLayout _outputMemoryLayout;
+
+        predictors::neural::ConvolutionalParameters _convolutionalParameters;
+        size_t _numGroups;
+    };
+}
+}
@@ -76,23 +76,11 @@ namespace nodes
     public:
         /// @name Input and Output Ports
         /// @{
-        static constexpr const char* inputWeightsPortName = "inputWeights";
-        static constexpr const char* forgetMeWeightsPortName = "forgetMeWeights";
-        static constexpr const char* candidateWeightsPortName = "candidateWeights";
-        static constexpr const char* outputWeightsPortName = "outputWeights";
-        static constexpr const char* inputBiasPortName = "inputBias";
-        static constexpr const char* forgetMeBiasPortName = "forgetMeBias";
-        static constexpr const char* candidateBiasPortName = "candidateBias";
-        static constexpr const char* outputBiasPortName = "outputBias";
+        static constexpr const char* weightsPortName = "weights";
+        static constexpr const char* biasPortName = "bias";
         const model::InputPort<ValueType>& input = _input;
-        const model::InputPort<ValueType>& inputWeights = _inputWeights;
-        const model::InputPort<ValueType>& forgetMeWeights = _forgetMeWeights;
-        const model::InputPort<ValueType>& candidateWeights = _candidateWeights;
-        const model::InputPort<ValueType>& outputWeights = _outputWeights;
-        const model::InputPort<ValueType>& inputBias = _inputBias;
-        const model::InputPort<ValueType>& forgetMeBias = _forgetMeBias;
-        const model::InputPort<ValueType>& candidateBias = _candidateBias;
-        const model::InputPort<ValueType>& outputBias = _outputBias;
+        const model::InputPort<ValueType>& weights = _weights;
+        const model::InputPort<ValueType>& bias = _bias;
         const model::OutputPort<ValueType>& output = _output;
         /// @}
 
@@ -102,25 +90,13 @@ namespace nodes
         /// <summary> Constructor. </summary>
         ///
         /// <param name="input"> The ports to get input data from. </param>
-        /// <param name="inputWeights"> The weights to be applied to the input layer. </param>
-        /// <param name="forgetMeWeights"> The weights to be applied to the forgotten layer. </param>
-        /// <param name="candidateWeights"> The weights to be applied to the candidate layer. </param>
-        /// <param name="outputWeights"> The weights to be applied to the output layer. </param>
-        /// <param name="inputBias"> The bias to be applied to the input nodes. </param>
-        /// <param name="forgetMeBias"> The bias to be applied to the forgotten layer nodes. </param>
-        /// <param name="candidateBias"> The bias to be applied to the candidate nodes. </param>
-        /// <param name="outputBias"> The bias to be applied to the output nodes. </param>
+        /// <param name="weights"> The weights of the input, forget, candidate, and output gates, stacked into one (4 * hiddenSize) x (inputSize + hiddenSize) row-major matrix. </param>
+        /// <param name="bias"> The biases of the input, forget, candidate, and output gates, stacked into one vector of size 4 * hiddenSize. </param>
         /// <param name="inputMemoryLayout"> The layout of the input data. </param>
         /// <param name="outputMemoryLayout"> The layout of the output data. </param>
         LSTMNode(const model::PortElements<ValueType>& input,
-                        const model::PortElements<ValueType>& inputWeights,
-                        const model::PortElements<ValueType>& forgetMeWeights,
-                        const model::PortElements<ValueType>& candidateWeights,
-                        const model::PortElements<ValueType>& outputWeights,
-                        const model::PortElements<ValueType>& inputBias,
-                        const model::PortElements<ValueType>& forgetMeBias,
-                        const model::PortElements<ValueType>& candidateBias,
-                        const model::PortElements<ValueType>& outputBias,
+                        const model::PortElements<ValueType>& weights,
+                        const model::PortElements<ValueType>& bias,
                         const model::PortMemoryLayout& inputMemoryLayout,
                         const model::PortMemoryLayout& outputMemoryLayout);
 
@@ -160,28 +136,15 @@ namespace nodes
         // Input
         model::InputPort<ValueType> _input;
 
-        // Weights
-        model::InputPort<ValueType> _inputWeights;
-        model::InputPort<ValueType> _forgetMeWeights;
-        model::InputPort<ValueType> _candidateWeights;
-        model::InputPort<ValueType> _outputWeights;
-
-        // Biases
-        model::InputPort<ValueType> _inputBias;
-        model::InputPort<ValueType> _forgetMeBias;
-        model::InputPort<ValueType> _candidateBias;
-        model::InputPort<ValueType> _outputBias;
+        // Stacked gate weights and biases
+        model::InputPort<ValueType> _weights;
+        model::InputPort<ValueType> _bias;
 
         // Output
         model::OutputPort<ValueType> _output;
 
         model::PortMemoryLayout _inputMemoryLayout;
         model::PortMemoryLayout _outputMemoryLayout;
-
-        void ApplySoftmax(emitters::IRFunctionEmitter& function, llvm::Value* data, size_t dataLength);
-
-        template <typename ActivationType>
-        void ApplyActivation(emitters::IRFunctionEmitter& function, ActivationType& activationFunction, llvm::Value* data, size_t dataLength);
     };
 }
 }
@@ -70,14 +70,23 @@ namespace nodes
         /// <summary> Makes a copy of this node in the model being constructed by the transformer </summary>
         void Copy(model::ModelTransformer& transformer) const override;
 
+        /// <summary> Indicates if the node can be compiled into the batched predict function. </summary>
+        bool CanCompileBatch(model::IRMapCompiler& compiler) override;
+
+        /// <summary> Emits code that multiplies a constant matrix with the vectors of a tile of samples in one matrix-matrix multiply. </summary>
+        void CompileBatch(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function, int batchSize) override;
+
     protected:
         void Compute() const override;
         void Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function) override;
         void WriteToArchive(utilities::Archiver& archiver) const override;
         void ReadFromArchive(utilities::Unarchiver& archiver) override;
         bool HasState() const override { return true; } // stored state: m, n, lda, incx
+        bool CanReuseOutputMemory(const model::OutputPortBase& port) const override { return true; }
 
     private:
+        bool CanCompileBatchAsMatrixMultiply(const model::IRMapCompiler& compiler) const;
+
         // Inputs
         model::InputPort<ValueType> _inputMatrix;
         model::InputPort<ValueType> _inputVector;
@@ -123,6 +123,10 @@ protected:
 private:
     NeuralNetworkLayerNodeBase<ValueType>* AddLayerNode(model::ModelTransformer& transformer, Layer& layer, const model::PortElements<ValueType>& layerInputs, const NetworkCompileOptions& options, NetworkCompileState& state) const;
 
+    // Folds the batch normalization, scaling, and bias layers following a convolutional or fully-connected layer into its weights,
+    // and adds the remaining bias and any activation as a single epilogue node. Returns the number of layers replaced (zero if none).
+    size_t TryAddFusedLayerNodes(model::ModelTransformer& transformer, size_t layerIndex, const model::PortElements<ValueType>& layerInputs, model::PortElements<ValueType>& layerOutputs) const;
+
     // Input
     model::InputPort<ValueType> _input;
 
@@ -76,6 +76,22 @@ namespace nodes
                                            const model::Shape& inputIncrement,
                                            PoolingFunctionT& poolingFunction);
 
+        llvm::Value* GetPoolingWindowVectorValue(emitters::IRFunctionEmitter& function,
+                                                 int windowRowStart,
+                                                 int windowRowEnd,
+                                                 int windowColumnStart,
+                                                 int windowColumnEnd,
+                                                 llvm::Value* inputRow,
+                                                 llvm::Value* inputColumn,
+                                                 llvm::Value* inputChannel,
+                                                 llvm::Value* inputBuffer,
+                                                 const model::Shape& inputIncrement,
+                                                 llvm::VectorType* vectorType);
+
+        // Emits the code to compute the output rows in [beginRow, endRow), `vectorSize` channels at a time
+        void EmitOutputRows(emitters::IRFunctionEmitter& function, llvm::Value* pInput, llvm::Value* pOutput, llvm::Value* beginRow, llvm::Value* endRow, int vectorSize);
+        emitters::IRFunctionEmitter GetTaskFunction(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function, int vectorSize);
+
         void Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function) override;
         using BaseType::HasState;
         using BaseType::GetLayer;
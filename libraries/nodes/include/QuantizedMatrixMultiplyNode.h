@@ -0,0 +1,199 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     QuantizedMatrixMultiplyNode.h (nodes)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+// emitters
+#include "IRFunctionEmitter.h"
+
+// model
+#include "CompilableNode.h"
+#include "IRMapCompiler.h"
+#include "InputPort.h"
+#include "MapCompiler.h"
+#include "ModelTransformer.h"
+#include "Node.h"
+#include "OutputPort.h"
+#include "PortElements.h"
+
+// utilities
+#include "Exception.h"
+#include "IArchivable.h"
+#include "TypeName.h"
+
+// stl
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace ell
+{
+namespace nodes
+{
+    /// <summary> Quantizes a value to a signed byte, as `round(value / scale)` saturated to [-127, 127]. </summary>
+    ///
+    /// <param name="value"> The value to quantize. </param>
+    /// <param name="scale"> The value represented by a quantized value of 1. </param>
+    ///
+    /// <returns> The quantized value. </returns>
+    template <typename ValueType>
+    int8_t QuantizeValue(ValueType value, double scale);
+
+    /// <summary>
+    /// Quantizes each row of a row-major matrix to signed bytes, using a scale for each row chosen so that the entry with
+    /// the largest magnitude maps to 127.
+    /// </summary>
+    ///
+    /// <param name="matrix"> The values of the matrix, in row-major order. </param>
+    /// <param name="rows"> The number of rows in the matrix. </param>
+    /// <param name="columns"> The number of columns in the matrix. </param>
+    /// <param name="rowScales"> [out] The scale used for each row. </param>
+    ///
+    /// <returns> The quantized matrix, in row-major order. </returns>
+    template <typename ValueType>
+    std::vector<int8_t> QuantizeMatrixRows(const std::vector<ValueType>& matrix, size_t rows, size_t columns, std::vector<double>& rowScales);
+
+    /// <summary>
+    /// Adds nodes to the model being constructed by the transformer that multiply a constant matrix by a matrix input
+    /// using 8-bit integer arithmetic: the constant matrix is quantized row by row, the input is quantized with the given
+    /// scale as it's read, and the 32-bit integer products are scaled back to `ValueType`.
+    /// </summary>
+    ///
+    /// <param name="transformer"> The transformer. </param>
+    /// <param name="weights"> The values of the constant m x k matrix on the left, in row-major order. </param>
+    /// <param name="m"> The number of rows in the constant matrix. </param>
+    /// <param name="k"> The number of columns in the constant matrix. </param>
+    /// <param name="input"> The k x n row-major matrix on the right. </param>
+    /// <param name="n"> The number of columns in the input matrix. </param>
+    /// <param name="inputScale"> The scale used to quantize the input. </param>
+    ///
+    /// <returns> The port holding the m x n row-major product. </returns>
+    template <typename ValueType>
+    const model::OutputPort<ValueType>& AddQuantizedMatrixMultiply(model::ModelTransformer& transformer, const std::vector<ValueType>& weights, size_t m, size_t k, const model::PortElements<ValueType>& input, size_t n, double inputScale);
+
+    /// <summary>
+    /// A node that multiplies a constant matrix of signed bytes by a quantized input matrix, accumulating the products in
+    /// 32-bit integers. The input is quantized with a fixed scale (see `QuantizeValue`) as it's read.
+    /// </summary>
+    template <typename ValueType>
+    class QuantizedMatrixMultiplyNode : public model::CompilableNode
+    {
+    public:
+        /// @name Input and Output Ports
+        /// @{
+        const model::InputPort<ValueType>& input = _input;
+        const model::OutputPort<int>& output = _output;
+        /// @}
+
+        /// <summary> Default Constructor </summary>
+        QuantizedMatrixMultiplyNode();
+
+        /// <summary> Constructor. </summary>
+        ///
+        /// <param name="input"> The right-hand input of the matrix multiplication, a row-major matrix of size k x n. </param>
+        /// <param name="m"> The number of rows in the weights matrix and the output. </param>
+        /// <param name="n"> The number of columns in the input matrix and the output. </param>
+        /// <param name="k"> The number of columns in the weights matrix and rows in the input matrix. </param>
+        /// <param name="weights"> The quantized left-hand side of the matrix multiplication, a row-major matrix of size m x k. </param>
+        /// <param name="inputScale"> The scale used to quantize the input. </param>
+        QuantizedMatrixMultiplyNode(const model::PortElements<ValueType>& input, size_t m, size_t n, size_t k, const std::vector<int8_t>& weights, double inputScale);
+
+        /// <summary> Gets the quantized weights matrix. </summary>
+        ///
+        /// <returns> The weights, in row-major order. </returns>
+        const std::vector<int8_t>& GetWeights() const { return _weights; }
+
+        /// <summary> Gets the scale used to quantize the input. </summary>
+        ///
+        /// <returns> The input scale. </returns>
+        double GetInputScale() const { return _inputScale; }
+
+        /// <summary> Gets the name of this type (for serialization). </summary>
+        ///
+        /// <returns> The name of this type. </returns>
+        static std::string GetTypeName() { return utilities::GetCompositeTypeName<ValueType>("QuantizedMatrixMultiplyNode"); }
+
+        /// <summary> Gets the name of this type (for serialization). </summary>
+        ///
+        /// <returns> The name of this type. </returns>
+        std::string GetRuntimeTypeName() const override { return GetTypeName(); }
+
+        /// <summary> Makes a copy of this node in the model being constructed by the transformer </summary>
+        void Copy(model::ModelTransformer& transformer) const override;
+
+    protected:
+        void Compute() const override;
+        void Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function) override;
+        void WriteToArchive(utilities::Archiver& archiver) const override;
+        void ReadFromArchive(utilities::Unarchiver& archiver) override;
+        bool HasState() const override { return true; } // stored state: m, n, k, weights, inputScale
+
+    private:
+        // Input
+        model::InputPort<ValueType> _input;
+
+        // Output
+        model::OutputPort<int> _output;
+
+        // Weights are MxK, input is KxN, output is MxN
+        size_t _m, _n, _k;
+        std::vector<int8_t> _weights;
+        double _inputScale;
+    };
+
+    /// <summary> A node that converts a matrix of quantized products back to `ValueType`, by multiplying each row by its own scale. </summary>
+    template <typename ValueType>
+    class DequantizeNode : public model::CompilableNode
+    {
+    public:
+        /// @name Input and Output Ports
+        /// @{
+        const model::InputPort<int>& input = _input;
+        const model::OutputPort<ValueType>& output = _output;
+        /// @}
+
+        /// <summary> Default Constructor </summary>
+        DequantizeNode();
+
+        /// <summary> Constructor. </summary>
+        ///
+        /// <param name="input"> The quantized values, a row-major matrix with one row per scale. </param>
+        /// <param name="rowScales"> The value represented by a quantized value of 1, for each row. </param>
+        DequantizeNode(const model::PortElements<int>& input, const std::vector<ValueType>& rowScales);
+
+        /// <summary> Gets the name of this type (for serialization). </summary>
+        ///
+        /// <returns> The name of this type. </returns>
+        static std::string GetTypeName() { return utilities::GetCompositeTypeName<ValueType>("DequantizeNode"); }
+
+        /// <summary> Gets the name of this type (for serialization). </summary>
+        ///
+        /// <returns> The name of this type. </returns>
+        std::string GetRuntimeTypeName() const override { return GetTypeName(); }
+
+        /// <summary> Makes a copy of this node in the model being constructed by the transformer </summary>
+        void Copy(model::ModelTransformer& transformer) const override;
+
+    protected:
+        void Compute() const override;
+        void Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function) override;
+        void WriteToArchive(utilities::Archiver& archiver) const override;
+        void ReadFromArchive(utilities::Unarchiver& archiver) override;
+        bool HasState() const override { return true; } // stored state: rowScales
+
+    private:
+        // Input
+        model::InputPort<int> _input;
+
+        // Output
+        model::OutputPort<ValueType> _output;
+
+        std::vector<ValueType> _rowScales;
+    };
+}
+}
@@ -88,6 +88,7 @@ namespace nodes
         void ReadFromArchive(utilities::Unarchiver& archiver) override;
 
         bool HasState() const override { return true; } // stored state: input layout, output shape, conv params
+        bool CanReuseOutputMemory(const model::OutputPortBase& port) const override { return true; }
 
     private:
         // Input
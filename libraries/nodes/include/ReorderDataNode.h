@@ -88,6 +88,7 @@ namespace nodes
         void WriteToArchive(utilities::Archiver& archiver) const override;
         void ReadFromArchive(utilities::Unarchiver& archiver) override;
         bool HasState() const override { return true; } // stored state: inputShape, outputShape, paddingValue
+        bool CanReuseOutputMemory(const model::OutputPortBase& port) const override;
     
     private:
         // Input
@@ -81,11 +81,13 @@ namespace nodes
                                       llvm::Value* prevOutputDimensionOffset,
                                       FunctionType& f) const;
 
-        // in-place version
+        // in-place version, over the entries [begin, end) of the given dimension
         template <typename FunctionType>
         void EmitComputeDimensionLoop(model::IRMapCompiler& compiler,
                                       emitters::IRFunctionEmitter& function,
                                       size_t dimension,
+                                      llvm::Value* begin,
+                                      llvm::Value* end,
                                       const model::PortMemoryLayout& inputLayout,
                                       llvm::Value* pInput,
                                       llvm::Value* prevInputDimensionOffset,
@@ -0,0 +1,111 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     SparseLinearPredictorNode.h (nodes)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+// model
+#include "CompilableNode.h"
+#include "IRMapCompiler.h"
+#include "InputPort.h"
+#include "MapCompiler.h"
+#include "ModelTransformer.h"
+#include "Node.h"
+#include "OutputPort.h"
+#include "PortElements.h"
+
+// predictors
+#include "LinearPredictor.h"
+
+// utilities
+#include "TypeName.h"
+
+// stl
+#include <string>
+
+namespace ell
+{
+namespace nodes
+{
+    /// <summary>
+    /// A node that applies a linear predictor to a sparse input, given as (index, value) pairs. The input holds up to
+    /// `maxNonZeros` pairs, stored as `index0, value0, index1, value1, ...`, with the index stored as a value of the
+    /// element type. Pairs whose index is outside the predictor's weights (e.g., -1) are ignored, so unused pairs at the
+    /// end of the input are padding. Only the weights of the pairs are read, so the cost doesn't depend on the
+    /// predictor's size. A float can only hold indices up to 2^24 exactly, so the node throws if the predictor has more
+    /// weights than the element type can index, and larger predictors need a double input.
+    /// `IRCompiledMap::ComputeSparse` fills in the input from a sparse data vector.
+    /// </summary>
+    template <typename ElementType>
+    class SparseLinearPredictorNode : public model::CompilableNode
+    {
+    public:
+        /// @name Input and Output Ports
+        /// @{
+        const model::InputPort<ElementType>& input = _input;
+        const model::OutputPort<ElementType>& output = _output;
+        /// @}
+
+        using LinearPredictorType = typename predictors::LinearPredictor<ElementType>;
+
+        /// <summary> Default Constructor </summary>
+        SparseLinearPredictorNode();
+
+        /// <summary> Constructor </summary>
+        ///
+        /// <param name="input"> The (index, value) pairs. Its size must be even. </param>
+        /// <param name="predictor"> The linear predictor. </param>
+        SparseLinearPredictorNode(const model::PortElements<ElementType>& input, const LinearPredictorType& predictor);
+
+        /// <summary> Gets the maximum number of (index, value) pairs in the input. </summary>
+        ///
+        /// <returns> The number of pairs the input holds. </returns>
+        size_t GetMaxNonZeros() const { return _input.Size() / 2; }
+
+        /// <summary> Gets the linear predictor. </summary>
+        ///
+        /// <returns> The linear predictor. </returns>
+        const LinearPredictorType& GetPredictor() const { return _predictor; }
+
+        /// <summary> Gets the name of this type (for serialization). </summary>
+        ///
+        /// <returns> The name of this type. </returns>
+        static std::string GetTypeName() { return utilities::GetCompositeTypeName<ElementType>("SparseLinearPredictorNode"); }
+
+        /// <summary> Gets the name of this type (for serialization). </summary>
+        ///
+        /// <returns> The name of this type. </returns>
+        std::string GetRuntimeTypeName() const override { return GetTypeName(); }
+
+        /// <summary> Makes a copy of this node in the model being constructed by the transformer </summary>
+        ///
+        /// <param name="transformer"> The `ModelTransformer` currently copying the model </param>
+        void Copy(model::ModelTransformer& transformer) const override;
+
+    protected:
+        void Compute() const override;
+        void Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function) override;
+        void WriteToArchive(utilities::Archiver& archiver) const override;
+        void ReadFromArchive(utilities::Unarchiver& archiver) override;
+
+    private:
+        void CheckInputSize() const;
+        void CheckPredictorSize() const;
+
+        // Input
+        model::InputPort<ElementType> _input;
+
+        // Output
+        model::OutputPort<ElementType> _output;
+
+        // Linear predictor
+        LinearPredictorType _predictor;
+    };
+}
+}
+
+#include "../tcc/SparseLinearPredictorNode.tcc"
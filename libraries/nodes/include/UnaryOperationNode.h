@@ -20,6 +20,7 @@
 
 // emitters
 #include "EmitterTypes.h"
+#include "IRMathFunctions.h"
 
 // utilities
 #include "TypeName.h"
@@ -77,9 +78,12 @@ namespace nodes
         void WriteToArchive(utilities::Archiver& archiver) const override;
         void ReadFromArchive(utilities::Unarchiver& archiver) override;
         bool HasState() const override { return true; } // stored state: operation
+        bool CanReuseOutputMemory(const model::OutputPortBase& port) const override { return true; }
+        const model::InputPortBase* GetInPlaceInputPort(const model::OutputPortBase& port) const override { return &_input; }
 
     private:
         llvm::Function* GetOperator(emitters::IRFunctionEmitter& function) const;
+        llvm::Value* EmitOperation(emitters::IRFunctionEmitter& function, llvm::Value* x) const;
         void CompileLoop(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function);
         void CompileExpanded(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function);
 
@@ -81,6 +81,12 @@ namespace nodes
 
     void ClockNode::Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function)
     {
+        if (compiler.GetMapCompilerParameters().reentrant)
+        {
+            // The last interval time is also read by the exported GetTicksUntilNextInterval functions, so it has to be a global
+            throw emitters::EmitterException(emitters::EmitterError::notSupported, "A map with a ClockNode can't be compiled as reentrant");
+        }
+
         auto now = compiler.EnsurePortEmitted(input);
 
         // Constants
@@ -18,6 +18,7 @@
 
 // emitters
 #include "IRLocalValue.h"
+#include "IRMathFunctions.h"
 
 namespace ell
 {
@@ -119,25 +120,8 @@ namespace nodes
     template <typename ValueType>
     llvm::Value* SigmoidActivationFunction<ValueType>::Compile(emitters::IRFunctionEmitter& function, llvm::Value* xValue) const
     {
-        auto x = function.LocalScalar(xValue);
-        auto zero = function.LocalScalar<ValueType>(0.0);
-        auto one = function.LocalScalar<ValueType>(1.0);
-
-        llvm::Value* result = function.Variable(emitters::GetVariableType<ValueType>(), "result");
-        auto ifEmitter = function.If();
-        ifEmitter.If(x > zero);
-        {
-            auto sigmoid = one / (Exp(-x) + one);
-            function.Store(result, sigmoid);
-        }
-        ifEmitter.Else();
-        {
-            auto expInput = Exp(x);
-            auto sigmoid = expInput / (expInput + one);
-            function.Store(result, sigmoid);
-        }
-        ifEmitter.End();
-        return function.Load(result);
+        // Branch-free and call-free, so loops applying the activation can be vectorized
+        return emitters::EmitSigmoid(function, xValue);
     }
 
     //
@@ -152,14 +136,7 @@ namespace nodes
     template <typename ValueType>
     llvm::Value* TanhActivationFunction<ValueType>::Compile(emitters::IRFunctionEmitter& function, llvm::Value* xValue) const
     {
-        auto x = function.LocalScalar(xValue);
-        auto one = function.LocalScalar<ValueType>(1.0);
-        auto two = function.LocalScalar<ValueType>(2.0);
-        // tanh = (exp(x) - exp(-x)) / (exp(x) + exp(-x))
-        //      = 2*sigmoid(2*x) - 1
-        auto sigmoidFunction = SigmoidActivationFunction<ValueType>();
-        auto sig2x = function.LocalScalar(sigmoidFunction.Compile(function, two * x));
-        return (two * sig2x) - one;
+        return emitters::EmitTanh(function, xValue);
     }
 
     //
@@ -179,18 +156,23 @@ namespace nodes
         auto zero = function.LocalScalar<ValueType>(0.0);
 
         // ((x[i] > 0) ? x[i] : a[i] * x[i])
-        llvm::Value* result = function.Variable(emitters::GetVariableType<ValueType>(), "result");
-        auto ifEmitter = function.If();
-        ifEmitter.If(x > zero);
-        {
-            function.Store(result, x);
-        }
-        ifEmitter.Else();
-        {
-            function.Store(result, x * a);
-        }
-        ifEmitter.End();
-        return function.Load(result);
+        return function.Select(x > zero, x, x * a);
+    }
+
+    //
+    // Bias followed by an activation function
+    //
+    template <typename ValueType, typename ActivationFunctionType>
+    ValueType BroadcastBiasActivationFunction<ValueType, ActivationFunctionType>::Compute(ValueType x, ValueType bias) const
+    {
+        return _activation.Compute(x + bias);
+    }
+
+    template <typename ValueType, typename ActivationFunctionType>
+    llvm::Value* BroadcastBiasActivationFunction<ValueType, ActivationFunctionType>::Compile(emitters::IRFunctionEmitter& function, llvm::Value* x, llvm::Value* bias) const
+    {
+        auto biasedValue = function.Operator(emitters::GetAddForValueType<ValueType>(), x, bias);
+        return _activation.Compile(function, biasedValue);
     }
 
     // Explicit instantiation
@@ -204,6 +186,12 @@ namespace nodes
     template class TanhActivationFunction<double>;
     template class ParametricReLUActivationFunction<float>;
     template class ParametricReLUActivationFunction<double>;
+    template class BroadcastBiasActivationFunction<float, ReLUActivationFunction<float>>;
+    template class BroadcastBiasActivationFunction<double, ReLUActivationFunction<double>>;
+    template class BroadcastBiasActivationFunction<float, LeakyReLUActivationFunction<float>>;
+    template class BroadcastBiasActivationFunction<double, LeakyReLUActivationFunction<double>>;
+    template class BroadcastBiasActivationFunction<float, SigmoidActivationFunction<float>>;
+    template class BroadcastBiasActivationFunction<double, SigmoidActivationFunction<double>>;
 
     template ReLUActivationFunction<float> GetNodeActivationFunction(const predictors::neural::ReLUActivation<float>& f);
     template ReLUActivationFunction<double> GetNodeActivationFunction(const predictors::neural::ReLUActivation<double>& f);
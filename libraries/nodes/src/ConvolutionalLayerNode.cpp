@@ -9,9 +9,15 @@
 #include "ConvolutionalLayerNode.h"
 #include "ConstantNode.h"
 #include "DiagonalConvolutionNode.h"
+#include "GroupedConvolutionNode.h"
 #include "MatrixMatrixMultiplyNode.h"
+#include "QuantizedMatrixMultiplyNode.h"
 #include "ReceptiveFieldMatrixNode.h"
 #include "ReorderDataNode.h"
+#include "WinogradConvolutionNode.h"
+
+// model
+#include "NodeCompilerSettings.h"
 
 using namespace ell::math;
 using namespace ell::math::Blas;
@@ -51,7 +57,46 @@ namespace nodes
         const auto padding = inputPaddingParams.paddingSize;
         auto newInput = transformer.TransformPortElements(this->input.GetPortElements());
 
-        bool useDiagonalConvolution = (convParams.method == predictors::neural::ConvolutionMethod::diagonal) && (stride == 1) && (filterWidth % 2 == 1);
+        const auto numGroups = this->GetLayer().NumGroups();
+        if (numGroups > 1)
+        {
+            // Grouped (e.g., depthwise) convolutions slide the filters directly over the input, instead of expanding it into columns
+            auto filterValues = predictors::neural::GetGroupedConvolutionFilters<ValueType>(this->GetLayer().GetWeights());
+            auto filtersNode = transformer.AddNode<ConstantNode<ValueType>>(filterValues);
+            auto convNode = transformer.AddNode<GroupedConvolutionNode<ValueType>>(newInput, inputLayout, filtersNode->output, outputLayout, convParams, numGroups);
+            transformer.MapNodeOutput(this->output, convNode->output);
+            return true;
+        }
+
+        // The method chosen by the layer can be overridden by compiler settings attached to the node (e.g., by the
+        // autotuner). Quantized layers always use the GEMM method.
+        auto method = convParams.method;
+        const auto compilerSettings = model::GetNodeCompilerSettings(*this);
+        const auto methodOverride = compilerSettings.convolutionMethod;
+        if (methodOverride == "columnwise" || compilerSettings.inputQuantizationScale > 0)
+        {
+            method = predictors::neural::ConvolutionMethod::columnwise;
+        }
+        else if (methodOverride == "diagonal")
+        {
+            method = predictors::neural::ConvolutionMethod::diagonal;
+        }
+        else if (methodOverride == "winograd")
+        {
+            method = predictors::neural::ConvolutionMethod::winograd;
+        }
+
+        if (method == predictors::neural::ConvolutionMethod::winograd && stride == 1 && filterWidth == 3)
+        {
+            // The filters are transformed here, so the compiled code only transforms the input and output tiles
+            auto filterValues = predictors::neural::GetWinogradConvolutionFilters<ValueType>(this->GetLayer().GetWeights());
+            auto filtersNode = transformer.AddNode<ConstantNode<ValueType>>(filterValues);
+            auto convNode = transformer.AddNode<WinogradConvolutionNode<ValueType>>(newInput, inputLayout, filtersNode->output, outputLayout, convParams);
+            transformer.MapNodeOutput(this->output, convNode->output);
+            return true;
+        }
+
+        bool useDiagonalConvolution = (method == predictors::neural::ConvolutionMethod::diagonal) && (stride == 1) && (filterWidth % 2 == 1);
         if (!useDiagonalConvolution)
         {
             // Needs (channel, row, column) order and no data padding
@@ -72,7 +117,17 @@ namespace nodes
             // `dataOrder` is the order the we're going to generate the receptive field matrix from
             std::array<int, 3> dataOrder = useNewMethod ? drcOrder : rcdOrder;
             auto weightsValues = weights.ToArray();
-            auto weightsNode = transformer.AddNode<ConstantNode<ValueType>>(weightsValues);
+
+            // Multiplies the weights by the receptive field matrix, in 8-bit integers if the node has an input quantization scale
+            auto multiplyWeights = [&](const model::OutputPort<ValueType>& receptiveFieldMatrix) -> const model::OutputPort<ValueType>& {
+                if (compilerSettings.inputQuantizationScale > 0)
+                {
+                    return AddQuantizedMatrixMultiply<ValueType>(transformer, weightsValues, m, k, receptiveFieldMatrix, n, compilerSettings.inputQuantizationScale);
+                }
+                auto weightsNode = transformer.AddNode<ConstantNode<ValueType>>(weightsValues);
+                auto matrixMultNode = transformer.AddNode<MatrixMatrixMultiplyNode<ValueType>>(weightsNode->output, m, n, k, lda, false, receptiveFieldMatrix, ldb, false, ldc);
+                return matrixMultNode->output;
+            };
 
             assert(outputDataPadding == 0 && "Convolutional node output padding not supported yet");
 
@@ -83,12 +138,12 @@ namespace nodes
             if (dataOrder == rcdOrder) // don't reorder input -- use old method
             {
                 auto receptiveFieldMatrixNode = transformer.AddNode<ReceptiveFieldMatrixNode<ValueType>>(newInput, inputLayout, convParams.receptiveField, convParams.stride, inputPaddingParams.paddingSize, dataOrder, outputImageWidth, outputImageHeight);
-                auto matrixMultNode = transformer.AddNode<MatrixMatrixMultiplyNode<ValueType>>(weightsNode->output, m, n, k, lda, false, receptiveFieldMatrixNode->output, ldb, false, ldc);
+                const auto& productOutput = multiplyWeights(receptiveFieldMatrixNode->output);
 
                 // Output of matrix multiply is in (f x h x w) order, need to transpose to (h x w x f)
                 model::PortMemoryLayout outputShape({ numFilters, outputImageHeight, outputImageWidth });
                 model::PortMemoryLayout transposedOutputShape({ outputImageHeight, outputImageWidth, numFilters }, { outputDataPadding, outputDataPadding, 0 });
-                auto reorderOutputNode = transformer.AddNode<ReorderDataNode<ValueType>>(matrixMultNode->output, outputShape, transposedOutputShape, std::vector<int>{ 1, 2, 0 });
+                auto reorderOutputNode = transformer.AddNode<ReorderDataNode<ValueType>>(productOutput, outputShape, transposedOutputShape, std::vector<int>{ 1, 2, 0 });
                 transformer.MapNodeOutput(this->output, reorderOutputNode->output);
             }
             else // reorder input to be channels x rows x columns (then we can use the 'new' receptive field matrix generation)
@@ -101,12 +156,12 @@ namespace nodes
                 auto reorderInputNode = transformer.AddNode<ReorderDataNode<ValueType>>(newInput, inputShape, transposedInputShape, std::vector<int>{ 2, 0, 1 });
 
                 auto receptiveFieldMatrixNode = transformer.AddNode<ReceptiveFieldMatrixNode<ValueType>>(reorderInputNode->output, inputLayout, convParams.receptiveField, convParams.stride, inputPaddingParams.paddingSize, dataOrder, outputImageWidth, outputImageHeight);
-                auto matrixMultNode = transformer.AddNode<MatrixMatrixMultiplyNode<ValueType>>(weightsNode->output, m, n, k, lda, false, receptiveFieldMatrixNode->output, ldb, false, ldc);
+                const auto& productOutput = multiplyWeights(receptiveFieldMatrixNode->output);
 
                 // Output of matrix multiply is in (f x h x w) order, need to transpose to (h x w x f)
                 model::PortMemoryLayout outputShape({ numFilters, outputImageHeight, outputImageWidth });
                 model::PortMemoryLayout transposedOutputShape({ outputImageHeight, outputImageWidth, numFilters }, { outputDataPadding, outputDataPadding, 0 });
-                auto reorderOutputNode = transformer.AddNode<ReorderDataNode<ValueType>>(matrixMultNode->output, outputShape, transposedOutputShape, std::vector<int>{1, 2, 0});
+                auto reorderOutputNode = transformer.AddNode<ReorderDataNode<ValueType>>(productOutput, outputShape, transposedOutputShape, std::vector<int>{1, 2, 0});
                 transformer.MapNodeOutput(this->output, reorderOutputNode->output);
             }
         }
@@ -181,8 +181,7 @@ namespace nodes
         const size_t stackedInputStride = stackedInputWidth * inputDepth;
         if (stackSize != 1)
         {
-            llvm::GlobalVariable* stackedInput = function.GetModule().GlobalArray(emitters::GetVariableType<ValueType>(), "stackedInput", stackedInputSize);
-            pStackedInput = function.PointerOffset(stackedInput, 0); // convert "global variable" to a pointer
+            pStackedInput = compiler.EnsureNodeBufferEmitted(*this, "stackedInput", emitters::GetVariableType<ValueType>(), stackedInputSize);
 
             // Fill in input memory
             // First, the top p rows of zeros (padding):
@@ -221,8 +220,7 @@ namespace nodes
         // TODO: this is really paddedHeight * filterWidth * batchSize * stackSize - padding * filterWidth * batchSize
         //              == (inputHeight + padding) * filterWidth * batchSize * (stackSize + padding);
         const size_t scratchMemSize = paddedHeight * filterWidth * batchSize * stackSize;
-        llvm::GlobalVariable* scratch = function.GetModule().GlobalArray(emitters::GetVariableType<ValueType>(), "scratch", scratchMemSize);
-        auto scratchPtr = function.PointerOffset(scratch, 0); // Convert LLVM array to pointer
+        auto scratchPtr = compiler.EnsureNodeBufferEmitted(*this, "scratch", emitters::GetVariableType<ValueType>(), scratchMemSize);
 
         const int outputStride = paddedWidth * numFilters;
         const size_t numConvolutions = (inputWidth - 1) / stackSize + 1;
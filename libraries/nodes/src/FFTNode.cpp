@@ -16,15 +16,20 @@
 // math
 #include "MathConstants.h"
 
+// model
+#include "CompilableNodeUtilities.h"
+
 // dsp
 #include "FFT.h"
 
+// utilities
+#include "TypeName.h"
+
 // stl
 #include <cmath>
+#include <complex>
 
-#define USE_STORED_TWIDDLE_FACTORS 1
 #define USE_FIXED_SMALL_FFT 1
-#define USE_REAL_FFT 0 // The real-valued FFT is slower than the complex one. Disable it for now.
 
 namespace ell
 {
@@ -67,23 +72,6 @@ namespace nodes
             return { function, function.Load(result) };
         }
 
-        inline emitters::IRLocalValue RealComplexAdd(emitters::IRLocalScalar a_re, emitters::IRLocalValue b)
-        {
-            if (!(b.value->getType()->isStructTy() && b.value->getType()->getNumContainedTypes() == 2 && a_re.value->getType() == b.value->getType()->getContainedType(0)))
-            {
-                throw emitters::EmitterException(emitters::EmitterError::valueTypeNotSupported);
-            }
-
-            // c.re = a.re + b.re
-            // c.im = b.im
-            auto& function = a_re.function;
-            auto b_re = function.LocalScalar(function.ExtractStructField(b, 0));
-            auto b_im = function.LocalScalar(function.ExtractStructField(b, 1));
-            auto result = function.Variable(b.value->getType(), "rc_add");
-            function.FillStruct(result, { a_re + b_re, b_im });
-            return { function, function.Load(result) };
-        }
-
         inline emitters::IRLocalValue ComplexSubtract(emitters::IRLocalValue a, emitters::IRLocalValue b)
         {
             if (!(a.value->getType()->isStructTy() && a.value->getType()->getNumContainedTypes() == 2 && a.value->getType() == b.value->getType()))
@@ -103,23 +91,6 @@ namespace nodes
             return { function, function.Load(result) };
         }
 
-        inline emitters::IRLocalValue RealComplexSubtract(emitters::IRLocalScalar a_re, emitters::IRLocalValue b)
-        {
-            if (!(b.value->getType()->isStructTy() && b.value->getType()->getNumContainedTypes() == 2 && a_re.value->getType() == b.value->getType()->getContainedType(0)))
-            {
-                throw emitters::EmitterException(emitters::EmitterError::valueTypeNotSupported);
-            }
-
-            // c.re = a.re - b.re
-            // c.im = b.im
-            auto& function = a_re.function;
-            auto b_re = function.LocalScalar(function.ExtractStructField(b, 0));
-            auto b_im = function.LocalScalar(function.ExtractStructField(b, 1));
-            auto result = function.Variable(b.value->getType(), "rc_sub");
-            function.FillStruct(result, { a_re - b_re, b_im });
-            return { function, function.Load(result) };
-        }
-
         inline emitters::IRLocalValue ComplexMultiply(emitters::IRLocalValue a, emitters::IRLocalValue b)
         {
             if (!(a.value->getType()->isStructTy() && a.value->getType()->getNumContainedTypes() == 2 && a.value->getType() == b.value->getType()))
@@ -139,23 +110,6 @@ namespace nodes
             return { function, function.Load(result) };
         }
 
-        inline emitters::IRLocalValue ComplexRealMultiply(emitters::IRLocalValue a, emitters::IRLocalScalar b_re)
-        {
-            if (!(a.value->getType()->isStructTy() && a.value->getType()->getNumContainedTypes() == 2 && a.value->getType()->getContainedType(0) == b_re.value->getType()))
-            {
-                throw emitters::EmitterException(emitters::EmitterError::valueTypeNotSupported);
-            }
-
-            // c.re = a.re * b
-            // c.im = a.im * b
-            auto& function = a.function;
-            auto a_re = function.LocalScalar(function.ExtractStructField(a, 0));
-            auto a_im = function.LocalScalar(function.ExtractStructField(a, 1));
-            auto result = function.Variable(a.value->getType(), "rc_mul");
-            function.FillStruct(result, { (a_re * b_re), (a_im * b_re) });
-            return { function, function.Load(result) };
-        }
-
         inline emitters::IRLocalValue ComplexAbs(emitters::IRLocalValue a)
         {
             if (!(a.value->getType()->isStructTy() && a.value->getType()->getNumContainedTypes() == 2))
@@ -186,17 +140,35 @@ namespace nodes
         //
         // FFT stuff
         //
+
+        // Returns the smallest prime factor of `length`, which is the radix used for the first step of an FFT of that length
+        inline size_t GetRadix(size_t length)
+        {
+            for (size_t factor = 2; factor * factor <= length; ++factor)
+            {
+                if (length % factor == 0)
+                {
+                    return factor;
+                }
+            }
+            return length;
+        }
+
+        // Returns a pointer to a constant table of the twiddle factors w^k = e^(2*pi*i*k/length), for k in [0, length)
         template <typename ValueType>
-        std::vector<std::complex<ValueType>> GetTwiddleFactors(size_t size)
+        llvm::Value* GetTwiddleFactors(emitters::IRFunctionEmitter& function, size_t length)
         {
-            // size == FFT length / 2
+            auto& module = function.GetModule();
             const auto pi = math::Constants<ValueType>::pi;
-            std::vector<std::complex<ValueType>> result(size);
-            for (size_t k = 0; k < size; ++k)
+            std::vector<ValueType> twiddleFactors;
+            for (size_t k = 0; k < length; ++k)
             {
-                result[k] = std::exp(std::complex<ValueType>(0, pi * k / size));
+                auto w = std::exp(std::complex<ValueType>(0, 2 * pi * k / length));
+                twiddleFactors.push_back(w.real());
+                twiddleFactors.push_back(w.imag());
             }
-            return result;
+            auto twiddleFactorsVar = module.ConstantArray(std::string("twiddles_") + utilities::GetTypeName<ValueType>() + "_" + std::to_string(length), twiddleFactors);
+            return function.CastPointer(twiddleFactorsVar, GetComplexType<ValueType>(module)->getPointerTo());
         }
 
         template <typename ValueType>
@@ -206,17 +178,6 @@ namespace nodes
             auto complexPtrType = complexType->getPointerTo();
             return { complexPtrType, complexPtrType };
         }
-
-        template <typename ValueType>
-        std::vector<llvm::Type*> GetRealFFTFunctionArguments(emitters::IRModuleEmitter& module)
-        {
-            auto& emitter = module.GetIREmitter();
-            auto valueType = emitter.Type(emitters::GetVariableType<ValueType>());
-            auto valuePtrType = valueType->getPointerTo();
-            auto complexType = detail::GetComplexType(module, valueType);
-            auto complexPtrType = complexType->getPointerTo();
-            return { valuePtrType, valuePtrType, complexPtrType };
-        }
     }
 
     template <typename ValueType>
@@ -324,157 +285,112 @@ namespace nodes
         return function.GetFunction();
     }
 
-    // Fixed-size FFT function implementation: size is known at compile time
+    // Fixed-size FFT function implementation: size is known at compile time. The scratch buffer must be as long as
+    // the signal.
     template <typename ValueType>
     llvm::Function* FFTNode<ValueType>::GetFFTFunction(emitters::IRModuleEmitter& module, size_t length)
     {
-#if (USE_FIXED_SMALL_FFT)
-        if (length == 2)
-        {
-            return GetFFTFunction_2(module);
-        }
-#endif // USE_FIXED_SMALL_FFT
-
-        // TODO: assert(bitcount(length) == 1)  (i.e., length is a power of 2)
-        auto& context = module.GetLLVMContext();
-        auto& emitter = module.GetIREmitter();
-        auto valueType = emitter.Type(emitters::GetVariableType<ValueType>());
-        auto complexType = detail::GetComplexType(module, valueType);
-        auto complexPtrType = complexType->getPointerTo();
-        auto voidType = llvm::Type::getVoidTy(context);
-
-        const auto pi = math::Constants<ValueType>::pi;
-
         // function name: FFTC_<T>_<N>  (e.g., FFT_float_32)
         // function signature: void FFT(complex<T>*, complex<T>*)
         std::string functionName = std::string("FFTC_") + utilities::GetTypeName<ValueType>() + "_" + std::to_string(length);
-        auto argumentTypes = detail::GetFFTFunctionArguments<ValueType>(module);
-        emitters::IRFunctionEmitter function = module.BeginFunction(functionName, voidType, argumentTypes);
+        if (module.HasFunction(functionName))
         {
-            auto arguments = function.Arguments().begin();
-            auto input = function.LocalScalar(&(*arguments++));
-            auto scratch = function.LocalScalar(&(*arguments++));
-
-            auto halfN = length / 2;
-            assert(halfN >= 1);
-
-            Deinterleave(function, input, halfN, scratch);
-            auto evens = input;
-            auto odds = function.PointerOffset(evens, halfN);
-
-            if (halfN > 1) // call recursive case if necessary
-            {
-                auto fftFunction = GetFFTFunction(module, halfN);
-                function.Call(fftFunction, { evens, scratch });
-                function.Call(fftFunction, { odds, scratch });
-            }
+            return module.GetFunction(functionName);
+        }
 
-#if (USE_STORED_TWIDDLE_FACTORS)
-            auto twiddleFactors = detail::GetTwiddleFactors<ValueType>(halfN);
-            std::vector<ValueType> twiddleFactorsUnwrapped(twiddleFactors.size() * 2);
-            ValueType* dataPtr = reinterpret_cast<ValueType*>(twiddleFactors.data());
-            std::copy(dataPtr, dataPtr + twiddleFactorsUnwrapped.size(), twiddleFactorsUnwrapped.begin());
-            auto twiddleFactorsUnwrappedVar = module.ConstantArray(std::string("twiddles_") + std::to_string(halfN), twiddleFactorsUnwrapped);
-            auto twiddleFactorsVar = function.CastPointer(twiddleFactorsUnwrappedVar, complexPtrType);
-#else
-            bool twiddleFactorsVar = false;
-#endif
-
-            function.For(halfN, [pi, halfN, &evens, &odds, &twiddleFactorsVar](emitters::IRFunctionEmitter& function, llvm::Value* kVar) {
-                auto k = function.LocalScalar(kVar);
-
-#if (USE_STORED_TWIDDLE_FACTORS)
-                auto w = function.LocalScalar(function.ValueAt(twiddleFactorsVar, k));
-#else
-                // w = e^i(2*pi*k/N)
-                auto kValue = function.LocalScalar(function.CastValue<int, ValueType>(k));
-                auto w = detail::ImaginaryExp(function.LocalScalar(pi / halfN) * kValue);
-#endif
-
-                auto e = function.LocalScalar(function.ValueAt(evens, k));
-                auto o = function.LocalScalar(function.ValueAt(odds, k));
-                auto wo = detail::ComplexMultiply(w, o); // wo = w*o
-                function.SetValueAt(evens, k, detail::ComplexAdd(e, wo)); // even
-                function.SetValueAt(odds, k, detail::ComplexSubtract(e, wo)); // odd
-            });
+#if (USE_FIXED_SMALL_FFT)
+        if (length == 2)
+        {
+            return GetFFTFunction_2(module);
         }
-        module.EndFunction();
-        return function.GetFunction();
-    }
+#endif // USE_FIXED_SMALL_FFT
 
-    // Real-valued fixed-size FFT function implementation: size is known at compile time
-    template <typename ValueType>
-    llvm::Function* FFTNode<ValueType>::GetRealFFTFunction(emitters::IRModuleEmitter& module, size_t length)
-    {
-        // TODO: assert(bitcount(length) == 1)  (i.e., length is a power of 2)
         auto& context = module.GetLLVMContext();
         auto complexType = detail::GetComplexType<ValueType>(module);
-        auto complexPtrType = complexType->getPointerTo();
         auto voidType = llvm::Type::getVoidTy(context);
 
-        const auto pi = math::Constants<ValueType>::pi;
+        // Mixed radix: split the signal into `radix` interleaved subsequences, transform them, and combine them
+        const auto radix = detail::GetRadix(length);
+        const auto subLength = length / radix;
+        llvm::Function* subFFTFunction = subLength > 1 ? GetFFTFunction(module, subLength) : nullptr;
 
-        // function name: FFTR_<T>_<N>  (e.g., FFT_float_32)
-        // function signature: void FFT(T*, T*, complex<T>*)
-        std::string functionName = std::string("FFTR_") + utilities::GetTypeName<ValueType>() + "_" + std::to_string(length);
-        auto argumentTypes = detail::GetRealFFTFunctionArguments<ValueType>(module);
+        auto argumentTypes = detail::GetFFTFunctionArguments<ValueType>(module);
         emitters::IRFunctionEmitter function = module.BeginFunction(functionName, voidType, argumentTypes);
         {
             auto arguments = function.Arguments().begin();
             auto input = function.LocalScalar(&(*arguments++));
             auto scratch = function.LocalScalar(&(*arguments++));
-            auto complexInput = function.LocalScalar(&(*arguments++));
-
-            auto halfN = length / 2;
-            assert(halfN >= 1);
+            auto twiddleFactors = detail::GetTwiddleFactors<ValueType>(function, length);
 
-            Deinterleave(function, input, halfN, scratch);
-            auto evens = input;
-            auto odds = function.PointerOffset(evens, halfN);
-            auto complexEvens = complexInput;
-            auto complexOdds = function.PointerOffset(complexEvens, halfN);
-
-            if (halfN > 1) // call recursive case if necessary
+            if (radix == 2)
             {
-                auto fftFunction = GetRealFFTFunction(module, halfN);
-                function.Call(fftFunction, { evens, scratch, complexEvens });
-                function.Call(fftFunction, { odds, scratch, complexOdds });
+                auto halfN = static_cast<int>(subLength);
+                Deinterleave(function, input, halfN, scratch);
+                auto evens = input;
+                auto odds = function.PointerOffset(evens, halfN);
+                if (subFFTFunction != nullptr)
+                {
+                    function.Call(subFFTFunction, { evens, scratch });
+                    function.Call(subFFTFunction, { odds, scratch });
+                }
+
+                function.For(halfN, [&evens, &odds, twiddleFactors](emitters::IRFunctionEmitter& function, llvm::Value* kVar) {
+                    auto k = function.LocalScalar(kVar);
+                    auto w = function.LocalScalar(function.ValueAt(twiddleFactors, k));
+                    auto e = function.LocalScalar(function.ValueAt(evens, k));
+                    auto o = function.LocalScalar(function.ValueAt(odds, k));
+                    auto wo = detail::ComplexMultiply(w, o); // wo = w*o
+                    function.SetValueAt(evens, k, detail::ComplexAdd(e, wo)); // even
+                    function.SetValueAt(odds, k, detail::ComplexSubtract(e, wo)); // odd
+                });
             }
-            else // here halfN == 1
+            else
             {
-                // Base case: copy from real to complex
-                function.FillStruct(complexEvens, { function.Load(evens), function.Literal<ValueType>(0) });
-                function.FillStruct(complexOdds, { function.Load(odds), function.Literal<ValueType>(0) });
+                const int p = static_cast<int>(radix);
+                const int m = static_cast<int>(subLength);
+                const int n = static_cast<int>(length);
+                if (subFFTFunction != nullptr)
+                {
+                    // Deinterleave: subsequence r is x[r], x[r + p], x[r + 2p], ...
+                    function.For(p, [&input, &scratch, p, m](emitters::IRFunctionEmitter& function, llvm::Value* rVar) {
+                        auto r = function.LocalScalar(rVar);
+                        function.For(m, [&input, &scratch, &r, p, m](emitters::IRFunctionEmitter& function, llvm::Value* indexVar) {
+                            auto index = function.LocalScalar(indexVar);
+                            function.SetValueAt(scratch, r * function.LocalScalar(m) + index, function.ValueAt(input, index * function.LocalScalar(p) + r));
+                        });
+                    });
+                    function.For(n, [&input, &scratch](emitters::IRFunctionEmitter& function, llvm::Value* index) {
+                        function.SetValueAt(input, index, function.ValueAt(scratch, index));
+                    });
+                    for (int r = 0; r < p; ++r)
+                    {
+                        function.Call(subFFTFunction, { function.PointerOffset(input, r * m), scratch });
+                    }
+                }
+
+                // Output k + m*q is the sum over r of w^(r*(k + m*q)) times output k of subsequence r
+                auto sum = function.Variable(complexType, "sum");
+                function.For(m, [&input, &scratch, twiddleFactors, sum, p, m, n](emitters::IRFunctionEmitter& function, llvm::Value* kVar) {
+                    auto k = function.LocalScalar(kVar);
+                    function.For(p, [&input, &scratch, &k, twiddleFactors, sum, p, m, n](emitters::IRFunctionEmitter& function, llvm::Value* qVar) {
+                        auto q = function.LocalScalar(qVar);
+                        auto outputIndex = k + function.LocalScalar(m) * q;
+                        function.FillStruct(sum, { function.Literal<ValueType>(0), function.Literal<ValueType>(0) });
+                        function.For(p, [&input, &k, &outputIndex, twiddleFactors, sum, m, n](emitters::IRFunctionEmitter& function, llvm::Value* rVar) {
+                            auto r = function.LocalScalar(rVar);
+                            auto twiddleIndex = function.Operator(emitters::TypedOperator::moduloSigned, r * outputIndex, function.LocalScalar(n));
+                            auto w = function.LocalScalar(function.ValueAt(twiddleFactors, twiddleIndex));
+                            auto x = function.LocalScalar(function.ValueAt(input, r * function.LocalScalar(m) + k));
+                            function.Store(sum, detail::ComplexAdd(function.LocalScalar(function.Load(sum)), detail::ComplexMultiply(w, x)));
+                        });
+                        function.SetValueAt(scratch, q, function.Load(sum));
+                    });
+                    function.For(p, [&input, &scratch, &k, m](emitters::IRFunctionEmitter& function, llvm::Value* qVar) {
+                        auto q = function.LocalScalar(qVar);
+                        function.SetValueAt(input, k + function.LocalScalar(m) * q, function.ValueAt(scratch, q));
+                    });
+                });
             }
-
-#if (USE_STORED_TWIDDLE_FACTORS)
-            auto twiddleFactors = detail::GetTwiddleFactors<ValueType>(halfN);
-            std::vector<ValueType> twiddleFactorsUnwrapped(twiddleFactors.size() * 2);
-            ValueType* dataPtr = reinterpret_cast<ValueType*>(twiddleFactors.data());
-            std::copy(dataPtr, dataPtr + twiddleFactorsUnwrapped.size(), twiddleFactorsUnwrapped.begin());
-            auto twiddleFactorsUnwrappedVar = module.ConstantArray(std::string("twiddles_") + std::to_string(halfN), twiddleFactorsUnwrapped);
-            auto twiddleFactorsVar = function.CastPointer(twiddleFactorsUnwrappedVar, complexPtrType);
-#else
-            bool twiddleFactorsVar = false; // Just here to appease the compiler
-#endif
-
-            function.For(halfN, [pi, halfN, &evens, &odds, &complexEvens, complexOdds, &twiddleFactorsVar](emitters::IRFunctionEmitter& function, llvm::Value* kVar) {
-                auto k = function.LocalScalar(kVar);
-
-#if (USE_STORED_TWIDDLE_FACTORS)
-                auto w = function.LocalScalar(function.ValueAt(twiddleFactorsVar, k));
-#else
-                // w = e^i(2*pi*k/N)
-                auto kValue = function.LocalScalar(function.CastValue<int, ValueType>(k));
-                auto w = detail::ImaginaryExp(function.LocalScalar(pi / halfN) * kValue);
-#endif
-
-                auto e = function.LocalScalar(function.ValueAt(evens, k));
-                auto o = function.LocalScalar(function.ValueAt(odds, k));
-                auto wo = detail::ComplexRealMultiply(w, o); // wo = w*o
-                function.SetValueAt(complexEvens, k, detail::RealComplexAdd(e, wo)); // even
-                function.SetValueAt(complexOdds, k, detail::RealComplexSubtract(e, wo)); // odd
-            });
         }
         module.EndFunction();
         return function.GetFunction();
@@ -517,6 +433,39 @@ namespace nodes
         transformer.MapNodeOutput(output, newNode->output);
     }
 
+    template <typename ValueType>
+    bool FFTNode<ValueType>::IsSpectrumReadInPlace() const
+    {
+        const auto& dependents = GetDependentNodes();
+        if (dependents.empty())
+        {
+            return false;
+        }
+
+        for (auto node : dependents)
+        {
+            auto reader = dynamic_cast<const FFTSpectrumReader*>(node);
+            if (reader == nullptr)
+            {
+                return false;
+            }
+
+            const auto& elements = reader->GetSpectrumInput().GetInputElements();
+            if (!elements.IsFullPortOutput() || elements.GetRanges()[0].ReferencedPort() != &output)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    template <typename ValueType>
+    llvm::Value* FFTNode<ValueType>::GetSpectrum(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function) const
+    {
+        auto spectrum = compiler.EnsureNodeBufferEmitted(*this, "spectrum", emitters::GetVariableType<ValueType>(), 2 * output.Size());
+        return function.CastPointer(spectrum, detail::GetComplexType<ValueType>(function.GetModule())->getPointerTo());
+    }
+
     template <typename ValueType>
     void FFTNode<ValueType>::Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function)
     {
@@ -529,38 +478,90 @@ namespace nodes
         auto outputSize = output.Size();
 
         // Get port variables
-        llvm::Value* pInput = compiler.EnsurePortEmitted(input);
+        llvm::Value* pInput = EnsureBufferWindowEmitted(compiler, function, input);
         llvm::Value* pOutput = compiler.EnsurePortEmitted(output);
 
-        // Buffer for complex data
-        llvm::Value* complexBuffer = function.Variable(complexType, inputSize);
+        if (inputSize % 2 != 0)
+        {
+            // Odd length: transform the signal as a complex one
+            llvm::Value* complexBuffer = function.Variable(complexType, inputSize);
+            llvm::Value* scratch = function.Variable(complexType, inputSize);
+            llvm::Value* temp = function.Variable(complexType, "temp");
+            function.For(inputSize, [pInput, complexBuffer, temp](emitters::IRFunctionEmitter& function, llvm::Value* index) {
+                function.FillStruct(temp, { function.ValueAt(pInput, index), function.Literal<ValueType>(0) });
+                function.SetValueAt(complexBuffer, index, function.Load(temp));
+            });
 
-#if (USE_REAL_FFT)
+            if (inputSize > 1)
+            {
+                function.Call(GetFFTFunction(module, inputSize), { complexBuffer, scratch });
+            }
 
-        llvm::Value* scratch = function.Variable(valueType, inputSize / 2);
-        auto fftFunction = GetRealFFTFunction(module, inputSize);
-        function.Call(fftFunction, { pInput, scratch, complexBuffer });
+            if (IsSpectrumReadInPlace())
+            {
+                auto spectrum = GetSpectrum(compiler, function);
+                function.For(outputSize, [spectrum, complexBuffer](emitters::IRFunctionEmitter& function, llvm::Value* index) {
+                    function.SetValueAt(spectrum, index, function.ValueAt(complexBuffer, index));
+                });
+                return;
+            }
 
-#else // Complex-input FFT
+            function.For(outputSize, [pOutput, complexBuffer](emitters::IRFunctionEmitter& function, llvm::Value* index) {
+                auto complexValue = function.LocalScalar(function.ValueAt(complexBuffer, index));
+                function.SetValueAt(pOutput, index, detail::ComplexAbs(complexValue));
+            });
+            return;
+        }
 
-        llvm::Value* scratch = function.Variable(complexType, inputSize / 2);
+        // Even length N: pack the signal into a complex signal z of length N/2, with the even samples in the real part
+        // and the odd ones in the imaginary part, and transform that
+        const int halfN = static_cast<int>(inputSize / 2);
+        llvm::Value* complexBuffer = function.Variable(complexType, halfN);
+        llvm::Value* scratch = function.Variable(complexType, halfN);
         llvm::Value* temp = function.Variable(complexType, "temp");
-
-        // Convert real-valued data to complex
-        function.For(inputSize, [pInput, complexBuffer, temp](emitters::IRFunctionEmitter& function, llvm::Value* index) {
-            function.FillStruct(temp, { function.ValueAt(pInput, index), function.Literal<ValueType>(0) });
+        function.For(halfN, [pInput, complexBuffer, temp](emitters::IRFunctionEmitter& function, llvm::Value* indexVar) {
+            auto index = function.LocalScalar(indexVar);
+            auto evenIndex = index * function.LocalScalar(2);
+            auto oddIndex = evenIndex + function.LocalScalar(1);
+            function.FillStruct(temp, { function.ValueAt(pInput, evenIndex), function.ValueAt(pInput, oddIndex) });
             function.SetValueAt(complexBuffer, index, function.Load(temp));
         });
 
-        auto fftFunction = GetFFTFunction(module, inputSize);
-        function.Call(fftFunction, { complexBuffer, scratch });
-
-#endif // USE_REAL_FFT
+        if (halfN > 1)
+        {
+            function.Call(GetFFTFunction(module, halfN), { complexBuffer, scratch });
+        }
 
-        function.For(outputSize, [pOutput, complexBuffer](emitters::IRFunctionEmitter& function, llvm::Value* index) {
-            auto complexValue = function.LocalScalar(function.ValueAt(complexBuffer, index));
-            auto absValue = detail::ComplexAbs(complexValue);
-            function.SetValueAt(pOutput, index, absValue);
+        // Z = E + iO, where E and O are the spectra of the even and odd samples. Since those are real,
+        // E[k] = (Z[k] + conj(Z[N/2-k])) / 2 and O[k] = (Z[k] - conj(Z[N/2-k])) / 2i, and X[k] = E[k] + w^k O[k].
+        // If the spectrum is read in place, X is stored instead of its magnitude.
+        auto twiddleFactors = detail::GetTwiddleFactors<ValueType>(function, inputSize);
+        llvm::Value* spectrum = IsSpectrumReadInPlace() ? GetSpectrum(compiler, function) : nullptr;
+        function.For(outputSize, [pOutput, spectrum, complexBuffer, twiddleFactors, temp, halfN](emitters::IRFunctionEmitter& function, llvm::Value* kVar) {
+            auto k = function.LocalScalar(kVar);
+            auto mirrorIndex = function.LocalScalar(function.Select(k == function.LocalScalar(0), function.Literal<int>(0), function.LocalScalar(halfN) - k));
+            auto a = function.LocalScalar(function.ValueAt(complexBuffer, k));
+            auto b = function.LocalScalar(function.ValueAt(complexBuffer, mirrorIndex));
+            auto a_re = function.LocalScalar(function.ExtractStructField(a, 0));
+            auto a_im = function.LocalScalar(function.ExtractStructField(a, 1));
+            auto b_re = function.LocalScalar(function.ExtractStructField(b, 0));
+            auto b_im = function.LocalScalar(function.ExtractStructField(b, 1));
+            auto half = function.LocalScalar<ValueType>(0.5);
+
+            function.FillStruct(temp, { half * (a_re + b_re), half * (a_im - b_im) });
+            auto e = function.LocalScalar(function.Load(temp));
+            function.FillStruct(temp, { half * (a_im + b_im), half * (b_re - a_re) });
+            auto o = function.LocalScalar(function.Load(temp));
+            auto w = function.LocalScalar(function.ValueAt(twiddleFactors, k));
+            auto x = detail::ComplexAdd(e, detail::ComplexMultiply(w, o));
+            if (spectrum != nullptr)
+            {
+                function.SetValueAt(spectrum, k, x);
+            }
+            else
+            {
+                function.SetValueAt(pOutput, k, detail::ComplexAbs(x));
+            }
         });
     }
 
@@ -579,8 +580,23 @@ namespace nodes
         _output.SetSize(_input.Size() / 2);
     }
 
+    template <typename ValueType>
+    const FFTNode<ValueType>* GetInPlaceSpectrumFFTNode(const model::InputPort<ValueType>& input)
+    {
+        const auto& elements = input.GetInputElements();
+        if (!elements.IsFullPortOutput())
+        {
+            return nullptr;
+        }
+
+        auto fftNode = dynamic_cast<const FFTNode<ValueType>*>(elements.GetRanges()[0].ReferencedPort()->GetNode());
+        return fftNode != nullptr && fftNode->IsSpectrumReadInPlace() ? fftNode : nullptr;
+    }
+
     // Explicit instantiations
     template class FFTNode<float>;
     template class FFTNode<double>;
+    template const FFTNode<float>* GetInPlaceSpectrumFFTNode(const model::InputPort<float>& input);
+    template const FFTNode<double>* GetInPlaceSpectrumFFTNode(const model::InputPort<double>& input);
 } // nodes
 } // ell
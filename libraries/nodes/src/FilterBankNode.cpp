@@ -48,57 +48,72 @@ namespace nodes
         auto& module = function.GetModule();
         auto numFilters = output.Size();
 
-        // Write out global variables with bin info
+        // Compact tables of the filters' nonzero spans: filter i covers the bins starting at filterStart[i], with the
+        // weights filterWeights[filterWeightOffsets[i]] up to (but not including) filterWeights[filterWeightOffsets[i+1]]
         std::vector<int> startBins;
-        std::vector<int> centerBins;
-        std::vector<int> endBins;
+        std::vector<int> weightOffsets = { 0 };
+        std::vector<ValueType> weights;
         for (size_t filterIndex = _filters.GetBeginFilter(); filterIndex < _filters.GetEndFilter(); ++filterIndex)
         {
             auto f = _filters.GetFilter(filterIndex);
+            for (auto bin = f.GetStart(); bin < f.GetEnd(); ++bin)
+            {
+                weights.push_back(static_cast<ValueType>(f[bin]));
+            }
             startBins.push_back(f.GetStart());
-            centerBins.push_back(f.GetCenter());
-            endBins.push_back(f.GetEnd());
+            weightOffsets.push_back(static_cast<int>(weights.size()));
+        }
+        if (weights.empty())
+        {
+            weights.push_back(0); // unused, but keeps the table from being empty
+        }
+        auto startVar = module.ConstantArray("filterStart_"s + GetInternalStateIdentifier(), startBins);
+        auto offsetVar = module.ConstantArray("filterWeightOffsets_"s + GetInternalStateIdentifier(), weightOffsets);
+        auto weightsVar = module.ConstantArray("filterWeights_"s + GetInternalStateIdentifier(), weights);
+
+        // Get port variables. If the input is the output of an FFT that stores its spectrum, compute the magnitudes of
+        // just the bins the filters use from it, so the FFT doesn't have to compute (and store) all of them.
+        llvm::Value* pSpectrum = nullptr;
+        llvm::Value* pInput = nullptr;
+        if (auto fftNode = GetInPlaceSpectrumFFTNode(input))
+        {
+            pSpectrum = fftNode->GetSpectrum(compiler, function);
+        }
+        else
+        {
+            pInput = EnsureBufferWindowEmitted(compiler, function, input);
         }
-        auto beginVar = module.ConstantArray("filterStart_"s + GetInternalStateIdentifier(), startBins);
-        auto centerVar = module.ConstantArray("filterCenter_"s + GetInternalStateIdentifier(), centerBins);
-        auto endVar = module.ConstantArray("filterEnd_"s + GetInternalStateIdentifier(), endBins);
-
-        auto half = function.LocalScalar<ValueType>(0.5);
-        // Get port variables
-        llvm::Value* pInput = compiler.EnsurePortEmitted(input);
         llvm::Value* pOutput = compiler.EnsurePortEmitted(output);
 
-        function.For(numFilters, [pInput, pOutput, half, beginVar, centerVar, endVar](emitters::IRFunctionEmitter& function, llvm::Value* filterIndex) {
+        function.For(numFilters, [pInput, pSpectrum, pOutput, startVar, offsetVar, weightsVar](emitters::IRFunctionEmitter& function, llvm::Value* filterIndexValue) {
+            auto filterIndex = function.LocalScalar(filterIndexValue);
             auto sum = function.Variable(emitters::GetVariableType<ValueType>());
-            auto begin = function.LocalScalar(function.ValueAt(beginVar, filterIndex));
-            auto center = function.LocalScalar(function.ValueAt(centerVar, filterIndex));
-            auto end = function.LocalScalar(function.ValueAt(endVar, filterIndex));
+            auto start = function.LocalScalar(function.ValueAt(startVar, filterIndex));
+            auto weightsBegin = function.LocalScalar(function.ValueAt(offsetVar, filterIndex));
+            auto weightsEnd = function.LocalScalar(function.ValueAt(offsetVar, filterIndex + function.LocalScalar(1)));
             function.StoreZero(sum);
 
-            // for index in [begin, center)
-            function.For(begin, center, [pInput, half, sum, begin, center](emitters::IRFunctionEmitter& function, llvm::Value* indexValue) {
-                // sum += signal[i] * ((i-begin+0.5) / (center-begin))
-                auto index = function.LocalScalar(indexValue);
-                auto inputVal = function.LocalScalar(function.ValueAt(pInput, index));
-                auto numer = index - begin;
-                auto denom = center - begin;
-                auto val = inputVal * ((function.LocalScalar(function.CastValue<int, ValueType>(numer)) + half) / function.LocalScalar(function.CastValue<int, ValueType>(denom)));
-                function.Store(sum, function.LocalScalar(function.Load(sum)) + val);
-            });
-
-            // for index in [center, end)
-            function.For(center, end, [pInput, half, sum, center, end](emitters::IRFunctionEmitter& function, llvm::Value* indexValue) {
-                // sum += signal[i] * ((end-i-0.5) / (end-center))
-                auto index = function.LocalScalar(indexValue);
-                auto inputVal = function.LocalScalar(function.ValueAt(pInput, index));
-                auto numer = end - index;
-                auto denom = end - center;
-                auto val = inputVal * ((function.LocalScalar(function.CastValue<int, ValueType>(numer)) - half) / function.LocalScalar(function.CastValue<int, ValueType>(denom)));
-                function.Store(sum, function.LocalScalar(function.Load(sum)) + val);
+            // sum += weight[j] * signal[start + j - weightsBegin], for j in [weightsBegin, weightsEnd)
+            function.For(weightsBegin, weightsEnd, [pInput, pSpectrum, weightsVar, sum, &start, &weightsBegin](emitters::IRFunctionEmitter& function, llvm::Value* weightIndexValue) {
+                auto weightIndex = function.LocalScalar(weightIndexValue);
+                auto bin = start + (weightIndex - weightsBegin);
+                llvm::Value* magnitude = nullptr;
+                if (pSpectrum != nullptr)
+                {
+                    auto x = function.ValueAt(pSpectrum, bin);
+                    auto re = function.LocalScalar(function.ExtractStructField(x, 0));
+                    auto im = function.LocalScalar(function.ExtractStructField(x, 1));
+                    magnitude = Sqrt((re * re) + (im * im));
+                }
+                else
+                {
+                    magnitude = function.ValueAt(pInput, bin);
+                }
+                auto weight = function.LocalScalar(function.ValueAt(weightsVar, weightIndex));
+                function.Store(sum, function.LocalScalar(function.Load(sum)) + weight * function.LocalScalar(magnitude));
             });
 
             function.SetValueAt(pOutput, filterIndex, function.Load(sum));
-
         });
     }
 
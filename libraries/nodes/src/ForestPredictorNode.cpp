@@ -0,0 +1,368 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     ForestPredictorNode.cpp (nodes)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "ForestPredictorNode.h"
+
+// emitters
+#include "EmitterTypes.h"
+#include "IRLocalValue.h"
+#include "IRModuleEmitter.h"
+#include "LLVMInclude.h"
+
+// utilities
+#include "Exception.h"
+
+// stl
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <numeric>
+#include <string>
+#include <vector>
+
+namespace ell
+{
+namespace nodes
+{
+    namespace detail
+    {
+        namespace
+        {
+            using Forest = predictors::SimpleForestPredictor;
+
+            // QuickScorer keeps a bitvector of a tree's possible exit leaves in a 64-bit integer
+            const size_t c_maxQuickScorerLeaves = 64;
+
+            struct ForestPorts
+            {
+                llvm::Value* input;
+                llvm::Value* output;
+                llvm::Value* treeOutputs;
+                llvm::Value* edgeIndicatorVector; // nullptr if the edge indicator vector isn't used
+            };
+
+            void CheckSplits(const Forest& forest)
+            {
+                for (const auto& node : forest.GetInteriorNodes())
+                {
+                    if (node.GetOutgoingEdges().size() != 2)
+                    {
+                        throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "Forest splits must have exactly two children");
+                    }
+                }
+            }
+
+            // Returns the index of the tree each interior node belongs to. Children always come after their parents.
+            std::vector<int> GetNodeTrees(const Forest& forest)
+            {
+                const auto& interiorNodes = forest.GetInteriorNodes();
+                std::vector<int> nodeTrees(interiorNodes.size(), 0);
+                const auto& roots = forest.GetRootIndices();
+                for (size_t treeIndex = 0; treeIndex < roots.size(); ++treeIndex)
+                {
+                    nodeTrees[roots[treeIndex]] = static_cast<int>(treeIndex);
+                }
+                for (size_t nodeIndex = 0; nodeIndex < interiorNodes.size(); ++nodeIndex)
+                {
+                    for (const auto& edge : interiorNodes[nodeIndex].GetOutgoingEdges())
+                    {
+                        if (edge.IsTargetInterior())
+                        {
+                            nodeTrees[edge.GetTargetNodeIndex()] = nodeTrees[nodeIndex];
+                        }
+                    }
+                }
+                return nodeTrees;
+            }
+
+            // Returns the number of interior nodes on the longest path from each interior node to a leaf
+            std::vector<int> GetNodeDepths(const Forest& forest)
+            {
+                const auto& interiorNodes = forest.GetInteriorNodes();
+                std::vector<int> depths(interiorNodes.size(), 1);
+                for (auto nodeIndex = static_cast<int>(interiorNodes.size()) - 1; nodeIndex >= 0; --nodeIndex)
+                {
+                    for (const auto& edge : interiorNodes[nodeIndex].GetOutgoingEdges())
+                    {
+                        if (edge.IsTargetInterior())
+                        {
+                            depths[nodeIndex] = std::max(depths[nodeIndex], depths[edge.GetTargetNodeIndex()] + 1);
+                        }
+                    }
+                }
+                return depths;
+            }
+
+            // Returns the number of leaves under each interior node
+            std::vector<size_t> GetNodeLeafCounts(const Forest& forest)
+            {
+                const auto& interiorNodes = forest.GetInteriorNodes();
+                std::vector<size_t> leafCounts(interiorNodes.size(), 0);
+                for (auto nodeIndex = static_cast<int>(interiorNodes.size()) - 1; nodeIndex >= 0; --nodeIndex)
+                {
+                    for (const auto& edge : interiorNodes[nodeIndex].GetOutgoingEdges())
+                    {
+                        leafCounts[nodeIndex] += edge.IsTargetInterior() ? leafCounts[edge.GetTargetNodeIndex()] : 1;
+                    }
+                }
+                return leafCounts;
+            }
+
+            //
+            // Branching evaluation
+            //
+            // The interior nodes are stored in tables indexed by node, and their edges in tables indexed by
+            // `2 * node + child`. A sentinel node after the last one has a threshold no input exceeds, and edges that
+            // point back to itself and add nothing. Each tree is walked for as many steps as it is deep, parking in the
+            // sentinel node once it reaches a leaf, so a step is a table lookup, a compare, and no branches.
+            //
+            void CompileBranchingForest(emitters::IRFunctionEmitter& function, const Forest& forest, const std::string& stateId, const ForestPorts& ports)
+            {
+                auto& module = function.GetModule();
+                const auto& interiorNodes = forest.GetInteriorNodes();
+                const auto numNodes = interiorNodes.size();
+                const auto sentinel = static_cast<int>(numNodes);
+
+                std::vector<int> features(numNodes + 1, 0);
+                std::vector<double> thresholds(numNodes + 1, std::numeric_limits<double>::infinity());
+                std::vector<int> children(2 * (numNodes + 1), sentinel);
+                std::vector<double> edgeValues(2 * (numNodes + 1), 0.0);
+                std::vector<int> edgeIndices(2 * (numNodes + 1), -1);
+                for (size_t nodeIndex = 0; nodeIndex < numNodes; ++nodeIndex)
+                {
+                    const auto& node = interiorNodes[nodeIndex];
+                    features[nodeIndex] = static_cast<int>(node.GetSplitRule().GetElementIndex());
+                    thresholds[nodeIndex] = node.GetSplitRule().GetThreshold();
+                    const auto& edges = node.GetOutgoingEdges();
+                    for (size_t child = 0; child < 2; ++child)
+                    {
+                        const auto slot = 2 * nodeIndex + child;
+                        children[slot] = edges[child].IsTargetInterior() ? static_cast<int>(edges[child].GetTargetNodeIndex()) : sentinel;
+                        edgeValues[slot] = edges[child].GetPredictor().GetValue();
+                        edgeIndices[slot] = static_cast<int>(node.GetFirstEdgeIndex() + child);
+                    }
+                }
+
+                const auto nodeDepths = GetNodeDepths(forest);
+                std::vector<int> roots;
+                std::vector<int> depths;
+                for (auto root : forest.GetRootIndices())
+                {
+                    roots.push_back(static_cast<int>(root));
+                    depths.push_back(nodeDepths[root]);
+                }
+
+                auto featuresVar = module.ConstantArray("forestFeatures_" + stateId, features);
+                auto thresholdsVar = module.ConstantArray("forestThresholds_" + stateId, thresholds);
+                auto childrenVar = module.ConstantArray("forestChildren_" + stateId, children);
+                auto edgeValuesVar = module.ConstantArray("forestEdgeValues_" + stateId, edgeValues);
+                auto rootsVar = module.ConstantArray("forestRoots_" + stateId, roots);
+                auto depthsVar = module.ConstantArray("forestDepths_" + stateId, depths);
+                auto edgeIndicesVar = ports.edgeIndicatorVector != nullptr ? module.ConstantArray("forestEdgeIndices_" + stateId, edgeIndices) : nullptr;
+
+                auto forestSum = function.Variable(emitters::VariableType::Double, "forestSum");
+                function.Store(forestSum, function.Literal(forest.GetBias()));
+                function.For(roots.size(), [ports, featuresVar, thresholdsVar, childrenVar, edgeValuesVar, rootsVar, depthsVar, edgeIndicesVar, forestSum](emitters::IRFunctionEmitter& function, llvm::Value* treeIndex) {
+                    auto node = function.Variable(emitters::VariableType::Int32, "node");
+                    auto lastEdge = function.Variable(emitters::VariableType::Int32, "lastEdge");
+                    auto treeSum = function.Variable(emitters::VariableType::Double, "treeSum");
+                    function.Store(node, function.ValueAt(rootsVar, treeIndex));
+                    function.StoreZero(lastEdge);
+                    function.StoreZero(treeSum);
+
+                    function.For(function.ValueAt(depthsVar, treeIndex), [ports, featuresVar, thresholdsVar, childrenVar, edgeValuesVar, edgeIndicesVar, node, lastEdge, treeSum](emitters::IRFunctionEmitter& function, llvm::Value*) {
+                        auto nodeIndex = function.LocalScalar(function.Load(node));
+                        auto x = function.LocalScalar(function.ValueAt(ports.input, function.ValueAt(featuresVar, nodeIndex)));
+                        auto threshold = function.LocalScalar(function.ValueAt(thresholdsVar, nodeIndex));
+                        auto slot = nodeIndex * function.LocalScalar(2) + function.LocalScalar(function.CastBoolToInt(x > threshold));
+                        function.Store(treeSum, function.LocalScalar(function.Load(treeSum)) + function.LocalScalar(function.ValueAt(edgeValuesVar, slot)));
+                        function.Store(node, function.ValueAt(childrenVar, slot));
+
+                        if (edgeIndicesVar != nullptr)
+                        {
+                            // The sentinel's edges mark the last edge taken again
+                            auto edgeIndex = function.LocalScalar(function.ValueAt(edgeIndicesVar, slot));
+                            auto edge = function.Select(edgeIndex < function.LocalScalar(0), function.Load(lastEdge), edgeIndex);
+                            function.Store(lastEdge, edge);
+                            function.SetValueAt(ports.edgeIndicatorVector, edge, function.Literal(true));
+                        }
+                    });
+
+                    auto treeOutput = function.LocalScalar(function.Load(treeSum));
+                    function.SetValueAt(ports.treeOutputs, treeIndex, treeOutput);
+                    function.Store(forestSum, function.LocalScalar(function.Load(forestSum)) + treeOutput);
+                });
+                function.SetValueAt(ports.output, function.Literal<int>(0), function.Load(forestSum));
+            }
+
+            //
+            // QuickScorer evaluation
+            //
+            // A tree's leaves are numbered left to right (first child first), and each interior node gets a mask
+            // that clears the bits of the leaves under its first child. Starting from all ones, the tree's bitvector
+            // is masked by every node whose split rule takes the second child; the leaf the tree exits at is then the
+            // lowest bit left. Evaluating the splits doesn't depend on the tree's structure, so it has no branches.
+            // The nodes are sorted by feature and threshold, so the input is read in order.
+            //
+            bool CanUseQuickScorer(const Forest& forest, const ForestPorts& ports)
+            {
+                if (ports.edgeIndicatorVector != nullptr)
+                {
+                    return false;
+                }
+
+                const auto leafCounts = GetNodeLeafCounts(forest);
+                for (auto root : forest.GetRootIndices())
+                {
+                    if (leafCounts[root] > c_maxQuickScorerLeaves)
+                    {
+                        return false;
+                    }
+                }
+                return true;
+            }
+
+            void CompileQuickScorerForest(emitters::IRFunctionEmitter& function, const Forest& forest, const std::string& stateId, const ForestPorts& ports)
+            {
+                auto& module = function.GetModule();
+                const auto& interiorNodes = forest.GetInteriorNodes();
+                const auto& roots = forest.GetRootIndices();
+                const auto numTrees = roots.size();
+
+                // Number the leaves of each tree, and find the value of each (the sum of the edges on its path) and
+                // the masks of the interior nodes
+                std::vector<uint64_t> masks(interiorNodes.size(), 0);
+                std::vector<int64_t> leafOffsets;
+                std::vector<double> leafValues;
+                std::function<void(size_t, double, int64_t)> visit = [&](size_t nodeIndex, double pathValue, int64_t treeOffset) {
+                    const auto& edges = interiorNodes[nodeIndex].GetOutgoingEdges();
+                    const auto firstLeaf = static_cast<int64_t>(leafValues.size()) - treeOffset;
+                    int64_t secondChildLeaf = 0;
+                    for (size_t child = 0; child < 2; ++child)
+                    {
+                        if (child == 1)
+                        {
+                            secondChildLeaf = static_cast<int64_t>(leafValues.size()) - treeOffset;
+                        }
+                        auto value = pathValue + edges[child].GetPredictor().GetValue();
+                        if (edges[child].IsTargetInterior())
+                        {
+                            visit(edges[child].GetTargetNodeIndex(), value, treeOffset);
+                        }
+                        else
+                        {
+                            leafValues.push_back(value);
+                        }
+                    }
+
+                    uint64_t firstChildLeaves = 0;
+                    for (auto leaf = firstLeaf; leaf < secondChildLeaf; ++leaf)
+                    {
+                        firstChildLeaves |= uint64_t(1) << leaf;
+                    }
+                    masks[nodeIndex] = ~firstChildLeaves;
+                };
+                for (auto root : roots)
+                {
+                    const auto treeOffset = static_cast<int64_t>(leafValues.size());
+                    leafOffsets.push_back(treeOffset);
+                    visit(root, 0.0, treeOffset);
+                }
+
+                std::vector<size_t> order(interiorNodes.size());
+                std::iota(order.begin(), order.end(), 0);
+                std::stable_sort(order.begin(), order.end(), [&interiorNodes](size_t a, size_t b) {
+                    const auto& ruleA = interiorNodes[a].GetSplitRule();
+                    const auto& ruleB = interiorNodes[b].GetSplitRule();
+                    return ruleA.GetElementIndex() < ruleB.GetElementIndex() || (ruleA.GetElementIndex() == ruleB.GetElementIndex() && ruleA.GetThreshold() < ruleB.GetThreshold());
+                });
+
+                const auto nodeTrees = GetNodeTrees(forest);
+                std::vector<int> features;
+                std::vector<double> thresholds;
+                std::vector<int> trees;
+                std::vector<int64_t> sortedMasks;
+                for (auto nodeIndex : order)
+                {
+                    features.push_back(static_cast<int>(interiorNodes[nodeIndex].GetSplitRule().GetElementIndex()));
+                    thresholds.push_back(interiorNodes[nodeIndex].GetSplitRule().GetThreshold());
+                    trees.push_back(nodeTrees[nodeIndex]);
+                    sortedMasks.push_back(static_cast<int64_t>(masks[nodeIndex]));
+                }
+
+                auto featuresVar = module.ConstantArray("forestFeatures_" + stateId, features);
+                auto thresholdsVar = module.ConstantArray("forestThresholds_" + stateId, thresholds);
+                auto treesVar = module.ConstantArray("forestNodeTrees_" + stateId, trees);
+                auto masksVar = module.ConstantArray("forestMasks_" + stateId, sortedMasks);
+                auto leafOffsetsVar = module.ConstantArray("forestLeafOffsets_" + stateId, leafOffsets);
+                auto leafValuesVar = module.ConstantArray("forestLeafValues_" + stateId, leafValues);
+
+                auto bitvectors = function.Variable(emitters::VariableType::Int64, static_cast<int>(numTrees));
+                function.For(numTrees, [bitvectors](emitters::IRFunctionEmitter& function, llvm::Value* treeIndex) {
+                    function.SetValueAt(bitvectors, treeIndex, function.Literal<int64_t>(-1));
+                });
+
+                function.For(features.size(), [ports, featuresVar, thresholdsVar, treesVar, masksVar, bitvectors](emitters::IRFunctionEmitter& function, llvm::Value* nodeIndex) {
+                    auto x = function.LocalScalar(function.ValueAt(ports.input, function.ValueAt(featuresVar, nodeIndex)));
+                    auto threshold = function.LocalScalar(function.ValueAt(thresholdsVar, nodeIndex));
+                    auto mask = function.Select(x > threshold, function.ValueAt(masksVar, nodeIndex), function.Literal<int64_t>(-1));
+                    auto treeIndex = function.ValueAt(treesVar, nodeIndex);
+                    function.SetValueAt(bitvectors, treeIndex, function.Operator(emitters::TypedOperator::logicalAnd, function.ValueAt(bitvectors, treeIndex), mask));
+                });
+
+                auto countTrailingZeros = module.GetIntrinsic(llvm::Intrinsic::cttz, { emitters::VariableType::Int64 });
+                auto forestSum = function.Variable(emitters::VariableType::Double, "forestSum");
+                function.Store(forestSum, function.Literal(forest.GetBias()));
+                function.For(numTrees, [ports, leafOffsetsVar, leafValuesVar, bitvectors, countTrailingZeros, forestSum](emitters::IRFunctionEmitter& function, llvm::Value* treeIndex) {
+                    auto leaf = function.LocalScalar(function.Call(countTrailingZeros, { function.ValueAt(bitvectors, treeIndex), function.FalseBit() }));
+                    auto leafIndex = function.LocalScalar(function.ValueAt(leafOffsetsVar, treeIndex)) + leaf;
+                    auto treeOutput = function.LocalScalar(function.ValueAt(leafValuesVar, leafIndex));
+                    function.SetValueAt(ports.treeOutputs, treeIndex, treeOutput);
+                    function.Store(forestSum, function.LocalScalar(function.Load(forestSum)) + treeOutput);
+                });
+                function.SetValueAt(ports.output, function.Literal<int>(0), function.Load(forestSum));
+            }
+        }
+
+        void CompileForest(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function, const predictors::SimpleForestPredictor& forest, const std::string& stateId, const model::InputPort<double>& input, const model::OutputPort<double>& output, const model::OutputPort<double>& treeOutputs, const model::OutputPort<bool>& edgeIndicatorVector)
+        {
+            CheckSplits(forest);
+
+            ForestPorts ports;
+            ports.input = compiler.EnsurePortEmitted(input);
+            ports.output = compiler.EnsurePortEmitted(output);
+            ports.treeOutputs = compiler.EnsurePortEmitted(treeOutputs);
+            ports.edgeIndicatorVector = nullptr;
+            if (edgeIndicatorVector.IsReferenced())
+            {
+                ports.edgeIndicatorVector = compiler.EnsurePortEmitted(edgeIndicatorVector);
+                function.For(edgeIndicatorVector.Size(), [ports](emitters::IRFunctionEmitter& function, llvm::Value* edgeIndex) {
+                    function.SetValueAt(ports.edgeIndicatorVector, edgeIndex, function.Literal(false));
+                });
+            }
+
+            if (forest.NumTrees() == 0)
+            {
+                function.SetValueAt(ports.output, function.Literal<int>(0), function.Literal(forest.GetBias()));
+                return;
+            }
+
+            const auto evaluation = compiler.GetMapCompilerParameters().forestEvaluation;
+            if (evaluation == model::ForestEvaluation::quickScorer && CanUseQuickScorer(forest, ports))
+            {
+                CompileQuickScorerForest(function, forest, stateId, ports);
+            }
+            else
+            {
+                CompileBranchingForest(function, forest, stateId, ports);
+            }
+        }
+    }
+}
+}
@@ -10,6 +10,10 @@
 #include "BroadcastFunctionNode.h"
 #include "ConstantNode.h"
 #include "MatrixVectorMultiplyNode.h"
+#include "QuantizedMatrixMultiplyNode.h"
+
+// model
+#include "NodeCompilerSettings.h"
 
 // utilities
 #include "Exception.h"
@@ -64,6 +68,16 @@ namespace nodes
         auto n = weights.NumColumns();
         auto lda = weights.GetIncrement();
         auto weightsValues = weights.ToArray();
+
+        // A calibrated input scale in the node's compiler settings turns on 8-bit integer arithmetic
+        const auto inputQuantizationScale = model::GetNodeCompilerSettings(*this).inputQuantizationScale;
+        if (inputQuantizationScale > 0)
+        {
+            const auto& productOutput = AddQuantizedMatrixMultiply<ValueType>(transformer, weightsValues, m, n, newInput, 1, inputQuantizationScale);
+            transformer.MapNodeOutput(this->output, productOutput);
+            return true;
+        }
+
         auto weightsNode = transformer.AddNode<ConstantNode<ValueType>>(weightsValues);
         auto matrixMultiplyNode = transformer.AddNode<MatrixVectorMultiplyNode<ValueType>>(weightsNode->output, m, n, lda, newInput);
 
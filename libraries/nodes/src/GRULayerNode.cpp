@@ -18,6 +18,9 @@
 // utilities
 #include "Exception.h"
 
+// stl
+#include <vector>
+
 namespace ell
 {
 namespace nodes
@@ -43,29 +46,27 @@ namespace nodes
     {
         auto newInput = transformer.TransformPortElements(this->input.GetPortElements());
 
-        // Transform weights and bias members into constant nodes
-        const auto& updateWeights = this->_layer.GetUpdateWeights();
-        const auto& resetWeights = this->_layer.GetResetWeights();
-        const auto& hiddenWeights = this->_layer.GetHiddenWeights();
-        const auto& updateBias = this->_layer.GetUpdateBias();
-        const auto& resetBias = this->_layer.GetResetBias();
-        const auto& hiddenBias = this->_layer.GetHiddenBias();
+        // Stack the update and reset weights and biases, so the compiled node can compute both gates with one matrix-vector product.
+        // The hidden weights are applied to the input and the reset-scaled hidden state, so they can't be stacked with the others.
+        std::vector<ValueType> gateWeights = this->_layer.GetUpdateWeights().ToArray();
+        auto resetWeights = this->_layer.GetResetWeights().ToArray();
+        gateWeights.insert(gateWeights.end(), resetWeights.begin(), resetWeights.end());
+
+        std::vector<ValueType> gateBias = this->_layer.GetUpdateBias().ToArray();
+        auto resetBias = this->_layer.GetResetBias().ToArray();
+        gateBias.insert(gateBias.end(), resetBias.begin(), resetBias.end());
 
-        auto updateWeightsNode = transformer.AddNode<ConstantNode<ValueType>>(updateWeights.ToArray());
-        auto resetWeightsNode = transformer.AddNode<ConstantNode<ValueType>>(resetWeights.ToArray());
-        auto hiddenWeightsNode = transformer.AddNode<ConstantNode<ValueType>>(hiddenWeights.ToArray());
-        auto updateBiasNode = transformer.AddNode<ConstantNode<ValueType>>(updateBias.ToArray());
-        auto resetBiasNode = transformer.AddNode<ConstantNode<ValueType>>(resetBias.ToArray());
-        auto hiddenBiasNode = transformer.AddNode<ConstantNode<ValueType>>(hiddenBias.ToArray());
+        auto gateWeightsNode = transformer.AddNode<ConstantNode<ValueType>>(gateWeights);
+        auto hiddenWeightsNode = transformer.AddNode<ConstantNode<ValueType>>(this->_layer.GetHiddenWeights().ToArray());
+        auto gateBiasNode = transformer.AddNode<ConstantNode<ValueType>>(gateBias);
+        auto hiddenBiasNode = transformer.AddNode<ConstantNode<ValueType>>(this->_layer.GetHiddenBias().ToArray());
 
         auto gruNode = transformer.AddNode<GRUNode<ValueType,
                                                     ActivationFunctionType,
                                                     RecurrentActivationFunctionType>>(newInput,
-                                                                                    updateWeightsNode->output,
-                                                                                    resetWeightsNode->output,
+                                                                                    gateWeightsNode->output,
                                                                                     hiddenWeightsNode->output,
-                                                                                    updateBiasNode->output,
-                                                                                    resetBiasNode->output,
+                                                                                    gateBiasNode->output,
                                                                                     hiddenBiasNode->output,
                                                                                     this->GetInputMemoryLayout(),
                                                                                     this->GetOutputMemoryLayout());
@@ -79,44 +80,49 @@ namespace nodes
     //
     template <typename ValueType, template <typename> class ActivationFunctionType, template <typename> class RecurrentActivationFunctionType>
     GRUNode<ValueType, ActivationFunctionType, RecurrentActivationFunctionType>::GRUNode()
-        : GRUNode({}, {}, {}, {}, {}, {}, {}, {}, {})
+        : CompilableNode({ &_input, &_gateWeights, &_hiddenWeights, &_gateBias, &_hiddenBias }, { &_output }),
+          _input(this, {}, defaultInputPortName),
+          _gateWeights(this, {}, gateWeightsPortName),
+          _hiddenWeights(this, {}, hiddenWeightsPortName),
+          _gateBias(this, {}, gateBiasPortName),
+          _hiddenBias(this, {}, hiddenBiasPortName),
+          _output(this, defaultOutputPortName, 0)
     {
     }
 
     template <typename ValueType, template <typename> class ActivationFunctionType, template <typename> class RecurrentActivationFunctionType>
     GRUNode<ValueType, ActivationFunctionType, RecurrentActivationFunctionType>::GRUNode(const model::PortElements<ValueType>& input,
-                                                                                         const model::PortElements<ValueType>& updateWeights,
-                                                                                         const model::PortElements<ValueType>& resetWeights,
+                                                                                         const model::PortElements<ValueType>& gateWeights,
                                                                                          const model::PortElements<ValueType>& hiddenWeights,
-                                                                                         const model::PortElements<ValueType>& updateBias,
-                                                                                         const model::PortElements<ValueType>& resetBias,
+                                                                                         const model::PortElements<ValueType>& gateBias,
                                                                                          const model::PortElements<ValueType>& hiddenBias,
                                                                                          const model::PortMemoryLayout& inputMemoryLayout,
                                                                                          const model::PortMemoryLayout& outputMemoryLayout)
-        : CompilableNode({ &_input, &_updateWeights, &_resetWeights, &_hiddenWeights, &_updateBias, &_resetBias, &_hiddenBias },
-                         { &_output }),
+        : CompilableNode({ &_input, &_gateWeights, &_hiddenWeights, &_gateBias, &_hiddenBias }, { &_output }),
           _input(this, input, defaultInputPortName),
-          _updateWeights(this, updateWeights, updateWeightsPortName),
-          _resetWeights(this, resetWeights, resetWeightsPortName),
+          _gateWeights(this, gateWeights, gateWeightsPortName),
           _hiddenWeights(this, hiddenWeights, hiddenWeightsPortName),
-          _updateBias(this, updateBias, updateBiasPortName),
-          _resetBias(this, resetBias, resetBiasPortName),
+          _gateBias(this, gateBias, gateBiasPortName),
           _hiddenBias(this, hiddenBias, hiddenBiasPortName),
-          _output(this, defaultOutputPortName, updateBias.Size())
+          _output(this, defaultOutputPortName, hiddenBias.Size()),
+          _inputMemoryLayout(inputMemoryLayout),
+          _outputMemoryLayout(outputMemoryLayout)
     {
+        if (gateBias.Size() != 2 * hiddenBias.Size())
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::sizeMismatch, "GRUNode gate bias must hold the stacked update and reset biases");
+        }
     }
 
     template <typename ValueType, template <typename> class ActivationFunctionType, template <typename> class RecurrentActivationFunctionType>
     void GRUNode<ValueType, ActivationFunctionType, RecurrentActivationFunctionType>::Copy(model::ModelTransformer& transformer) const
     {
         auto newInput = transformer.TransformPortElements(_input.GetPortElements());
-        auto newUpdateWeights = transformer.TransformPortElements(_updateWeights.GetPortElements());
-        auto newResetWeights = transformer.TransformPortElements(_resetWeights.GetPortElements());
+        auto newGateWeights = transformer.TransformPortElements(_gateWeights.GetPortElements());
         auto newHiddenWeights = transformer.TransformPortElements(_hiddenWeights.GetPortElements());
-        auto newUpdateBias = transformer.TransformPortElements(_updateBias.GetPortElements());
-        auto newResetBias = transformer.TransformPortElements(_resetBias.GetPortElements());
+        auto newGateBias = transformer.TransformPortElements(_gateBias.GetPortElements());
         auto newHiddenBias = transformer.TransformPortElements(_hiddenBias.GetPortElements());
-        auto newNode = transformer.AddNode<GRUNode>(newInput, newUpdateWeights, newResetWeights, newHiddenWeights, newUpdateBias, newResetBias, newHiddenBias, _inputMemoryLayout, _outputMemoryLayout);
+        auto newNode = transformer.AddNode<GRUNode>(newInput, newGateWeights, newHiddenWeights, newGateBias, newHiddenBias, _inputMemoryLayout, _outputMemoryLayout);
         transformer.MapNodeOutput(output, newNode->output);
     }
 
@@ -126,64 +132,16 @@ namespace nodes
         throw utilities::LogicException(utilities::LogicExceptionErrors::notImplemented, "GRUNode does not currently compute");
     }
 
-    template <typename ValueType, template <typename> class ActivationFunctionType, template <typename> class RecurrentActivationFunctionType>
-    void GRUNode<ValueType, ActivationFunctionType, RecurrentActivationFunctionType>::ApplySoftmax(emitters::IRFunctionEmitter& function, llvm::Value* data, size_t dataLength)
-    {
-        const auto plusFloat = emitters::TypedOperator::addFloat;
-        const auto divideFloat = emitters::TypedOperator::divideFloat;
-        auto expFunc = function.GetModule().GetRuntime().GetExpFunction<ValueType>();
-
-        llvm::AllocaInst* sum = function.Variable(emitters::GetVariableType<ValueType>(), 1);
-        function.SetValueAt(sum, 0, function.Literal<ValueType>(0.0));
-
-        auto forLoop = function.ForLoop();
-        forLoop.Begin(dataLength);
-        {
-            auto i = forLoop.LoadIterationVariable();
-            llvm::Value* inputValue = function.ValueAt(data, i);
-
-            auto expInput = function.Call(expFunc, { inputValue });
-            auto addToSum = function.Operator(plusFloat, function.ValueAt(sum, 0), expInput);
-            function.SetValueAt(sum, 0, addToSum);
-            function.SetValueAt(data, i, expInput);
-        }
-        forLoop.End();
-
-        auto forLoop2 = function.ForLoop();
-        forLoop2.Begin(dataLength);
-        {
-            auto i = forLoop2.LoadIterationVariable();
-            llvm::Value* inputValue = function.ValueAt(data, i);
-            auto expDivSum = function.Operator(divideFloat, inputValue, function.ValueAt(sum, 0));
-            function.SetValueAt(data, i, expDivSum);
-        }
-        forLoop2.End();
-    }
-
-    template <typename ValueType, template <typename> class ActivationFunctionType, template <typename> class RecurrentActivationFunctionType>
-    template <typename ActivationType>
-    void GRUNode<ValueType, ActivationFunctionType, RecurrentActivationFunctionType>::ApplyActivation(emitters::IRFunctionEmitter& function, ActivationType& activationFunction, llvm::Value* data, size_t dataLength)
-    {
-        auto forLoop = function.ForLoop();
-        forLoop.Begin(dataLength);
-        {
-            auto i = forLoop.LoadIterationVariable();
-            llvm::Value* inputValue = function.ValueAt(data, i);
-            llvm::Value* x = activationFunction.Compile(function, inputValue);
-            function.SetValueAt(data, i, x);
-        }
-        forLoop.End();
-    }
-
     template <typename ValueType, template <typename> class ActivationFunctionType, template <typename> class RecurrentActivationFunctionType>
     void GRUNode<ValueType, ActivationFunctionType, RecurrentActivationFunctionType>::Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function)
     {
+        const auto plus = emitters::TypedOperator::add;
         const auto plusFloat = emitters::TypedOperator::addFloat;
         const auto minusFloat = emitters::TypedOperator::subtractFloat;
         const auto timesFloat = emitters::TypedOperator::multiplyFloat;
 
         const size_t inputSize = this->input.Size();
-        const size_t hiddenSize = this->updateBias.Size();
+        const size_t hiddenSize = this->hiddenBias.Size();
 
         ActivationFunctionType<ValueType> layerActivationFunction;
         auto activationFunction = GetNodeActivationFunction(layerActivationFunction);
@@ -192,11 +150,9 @@ namespace nodes
 
         // Get LLVM references for all node inputs
         llvm::Value* pInput = compiler.EnsurePortEmitted(this->input);
-        llvm::Value* updateWeights = compiler.EnsurePortEmitted(this->updateWeights);
-        llvm::Value* resetWeights = compiler.EnsurePortEmitted(this->resetWeights);
-        llvm::Value* hiddenWeights = compiler.EnsurePortEmitted(this->hiddenWeights);
-        llvm::Value* updateBias = compiler.EnsurePortEmitted(this->updateBias);
-        llvm::Value* resetBias = compiler.EnsurePortEmitted(this->resetBias);
+        llvm::Value* gateWeights = EnsureWeightsEmitted(compiler, function, this->gateWeights);
+        llvm::Value* hiddenWeights = EnsureWeightsEmitted(compiler, function, this->hiddenWeights);
+        llvm::Value* gateBias = compiler.EnsurePortEmitted(this->gateBias);
         llvm::Value* hiddenBias = compiler.EnsurePortEmitted(this->hiddenBias);
 
         // Get LLVM reference for node output
@@ -207,51 +163,48 @@ namespace nodes
 
         // Allocate local variables
         llvm::AllocaInst* inputPlusHidden = function.Variable(emitters::GetVariableType<ValueType>(), inputSize + hiddenSize);
-        llvm::AllocaInst* z = function.Variable(emitters::GetVariableType<ValueType>(), hiddenSize);
-        llvm::AllocaInst* r = function.Variable(emitters::GetVariableType<ValueType>(), hiddenSize);
+        llvm::AllocaInst* gates = function.Variable(emitters::GetVariableType<ValueType>(), 2 * hiddenSize);
         llvm::AllocaInst* hNew = function.Variable(emitters::GetVariableType<ValueType>(), hiddenSize);
 
         // Concatenate input and hidden state into combined [Xt, Ht-1]
         function.MemoryCopy<ValueType>(pInput, inputPlusHidden, inputSize);
         function.MemoryCopy<ValueType>(hiddenState, 0, inputPlusHidden, inputSize, hiddenSize);
 
-        // z = recurrentFunction(Wu * [Xt, Ht-1] + b_u)    (where recurrentFunction is usually sigmoid)
-        function.MemoryCopy<ValueType>(updateBias, z, hiddenSize); // Copy bias values into output so GEMM call accumulates them
-        function.CallGEMV(hiddenSize, inputSize + hiddenSize, static_cast<ValueType>(1.0), updateWeights, inputSize + hiddenSize, inputPlusHidden, 1, static_cast<ValueType>(1.0), z, 1);
-        ApplyActivation(function, recurrentActivationFunction, z, hiddenSize);
-
-        // r = recurrentFunction(Wr * [Xt, Ht-1] + b_r)    (where recurrentFunction is usually sigmoid)
-        function.MemoryCopy<ValueType>(resetBias, r, hiddenSize); // Copy bias values into output so GEMM call accumulates them
-        function.CallGEMV(hiddenSize, inputSize + hiddenSize, static_cast<ValueType>(1.0), resetWeights, inputSize + hiddenSize, inputPlusHidden, 1, static_cast<ValueType>(1.0), r, 1);
-        ApplyActivation(function, recurrentActivationFunction, r, hiddenSize);
+        // [z; r] = [Wu; Wr] * [Xt, Ht-1] + [b_u; b_r]
+        function.MemoryCopy<ValueType>(gateBias, gates, 2 * hiddenSize); // Copy bias values into output so GEMV call accumulates them
+        function.CallGEMV(2 * hiddenSize, inputSize + hiddenSize, static_cast<ValueType>(1.0), gateWeights, inputSize + hiddenSize, inputPlusHidden, 1, static_cast<ValueType>(1.0), gates, 1);
 
-        // inputPlusHidden' = [Xt, Ht-1] .* r
-        // in-place modify inputPlusHidden by scaling hidden part by r
+        // z = recurrentFunction(z), r = recurrentFunction(r)    (where recurrentFunction is usually sigmoid)
+        // inputPlusHidden' = [Xt, Ht-1 .* r]
         auto hiddenPart = function.PointerOffset(inputPlusHidden, inputSize);
-        auto scaleByRLoop = function.ForLoop();
-        scaleByRLoop.Begin(hiddenSize);
+        auto gateLoop = function.ForLoop();
+        gateLoop.Begin(hiddenSize);
         {
-            auto index = scaleByRLoop.LoadIterationVariable();
-            auto scaledValue = function.Operator(timesFloat, function.ValueAt(r, index), function.ValueAt(hiddenPart, index));
+            auto index = gateLoop.LoadIterationVariable();
+            auto zVal = recurrentActivationFunction.Compile(function, function.ValueAt(gates, index));
+            function.SetValueAt(gates, index, zVal);
+
+            auto rVal = recurrentActivationFunction.Compile(function, function.ValueAt(gates, function.Operator(plus, index, function.Literal<int>(static_cast<int>(hiddenSize)))));
+            auto scaledValue = function.Operator(timesFloat, rVal, function.ValueAt(hiddenPart, index));
             function.SetValueAt(hiddenPart, index, scaledValue);
         }
-        scaleByRLoop.End();
+        gateLoop.End();
 
-        // hNew = activationFunction(Wh * inputPlusHidden' + b_h)  (where activationFunction is usually tanh)
-        function.MemoryCopy<ValueType>(hiddenBias, hNew, hiddenSize); // Copy bias values into output so GEMM call accumulates them
+        // hNew = Wh * inputPlusHidden' + b_h
+        function.MemoryCopy<ValueType>(hiddenBias, hNew, hiddenSize); // Copy bias values into output so GEMV call accumulates them
         function.CallGEMV(hiddenSize, inputSize + hiddenSize, static_cast<ValueType>(1.0), hiddenWeights, inputSize + hiddenSize, inputPlusHidden, 1, static_cast<ValueType>(1.0), hNew, 1);
-        ApplyActivation(function, activationFunction, hNew, hiddenSize);
 
-        // hiddenState = (1-z).*hNew + z.*h
+        // hiddenState = (1-z).*activationFunction(hNew) + z.*h    (where activationFunction is usually tanh)
         auto newStateLoop = function.ForLoop();
         newStateLoop.Begin(hiddenSize);
         {
             auto index = newStateLoop.LoadIterationVariable();
-            auto zVal = function.ValueAt(z, index);
+            auto zVal = function.ValueAt(gates, index);
+            auto hNewVal = activationFunction.Compile(function, function.ValueAt(hNew, index));
             auto oneMinusZ = function.Operator(minusFloat, function.Literal<ValueType>(1.0), zVal);
-            auto scaledOldH = function.Operator(timesFloat, oneMinusZ, function.ValueAt(hNew, index));
-            auto scaledNewH = function.Operator(timesFloat, zVal, function.ValueAt(hiddenState, index));
-            auto result = function.Operator(plusFloat, scaledOldH, scaledNewH);
+            auto scaledNewH = function.Operator(timesFloat, oneMinusZ, hNewVal);
+            auto scaledOldH = function.Operator(timesFloat, zVal, function.ValueAt(hiddenState, index));
+            auto result = function.Operator(plusFloat, scaledNewH, scaledOldH);
             function.SetValueAt(hiddenState, index, result);
         }
         newStateLoop.End();
@@ -0,0 +1,289 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     GroupedConvolutionNode.cpp (nodes)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "GroupedConvolutionNode.h"
+
+// emitters
+#include "IRVectorUtilities.h"
+
+// utilities
+#include "Exception.h"
+
+// stl
+#include <vector>
+
+namespace ell
+{
+namespace nodes
+{
+    namespace
+    {
+        const auto plus = emitters::TypedOperator::add;
+        const auto times = emitters::TypedOperator::multiply;
+
+        const auto plusFloat = emitters::TypedOperator::addFloat;
+        const auto timesFloat = emitters::TypedOperator::multiplyFloat;
+
+        size_t GetGroupedConvolutionOutputSize(const model::PortMemoryLayout& outputLayout)
+        {
+            return outputLayout.GetMemorySize();
+        }
+    } // end anonymous namespace
+
+    //
+    // GroupedConvolutionNode
+    //
+
+    template <typename ValueType>
+    GroupedConvolutionNode<ValueType>::GroupedConvolutionNode()
+        : CompilableNode({ &_input }, { &_output }), _input(this, {}, defaultInputPortName), _filterWeights(this, {}, filterWeightsPortName), _output(this, defaultOutputPortName, 0), _numGroups(1)
+    {
+    }
+
+    template <typename ValueType>
+    GroupedConvolutionNode<ValueType>::GroupedConvolutionNode(const model::PortElements<ValueType>& input, const model::PortMemoryLayout& inputMemoryLayout, const model::PortElements<ValueType>& filterWeights, const model::PortMemoryLayout& outputMemoryLayout, const predictors::neural::ConvolutionalParameters& convolutionalParameters, size_t numGroups)
+        : CompilableNode({ &_input, &_filterWeights }, { &_output }), _input(this, input, defaultInputPortName), _filterWeights(this, filterWeights, filterWeightsPortName), _output(this, defaultOutputPortName, GetGroupedConvolutionOutputSize(outputMemoryLayout)), _inputMemoryLayout(inputMemoryLayout), _outputMemoryLayout(outputMemoryLayout), _convolutionalParameters(convolutionalParameters), _numGroups(numGroups)
+    {
+        const size_t numChannels = inputMemoryLayout.GetActiveSize(2);
+        const size_t numFilters = outputMemoryLayout.GetActiveSize(2);
+        if (numGroups == 0 || numChannels % numGroups != 0 || numFilters % numGroups != 0)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "The number of input channels and filters must be multiples of the number of groups");
+        }
+        if (filterWeights.Size() != convolutionalParameters.receptiveField * convolutionalParameters.receptiveField * (numChannels / numGroups) * numFilters)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::sizeMismatch, "Filter weights don't match the receptive field, number of channels per group and number of filters");
+        }
+    }
+
+    template <typename ValueType>
+    void GroupedConvolutionNode<ValueType>::Copy(model::ModelTransformer& transformer) const
+    {
+        auto newInput = transformer.TransformPortElements(_input.GetPortElements());
+        auto newFilterWeights = transformer.TransformPortElements(_filterWeights.GetPortElements());
+        auto newNode = transformer.AddNode<GroupedConvolutionNode<ValueType>>(newInput, _inputMemoryLayout, newFilterWeights, _outputMemoryLayout, _convolutionalParameters, _numGroups);
+        transformer.MapNodeOutput(this->output, newNode->output);
+    }
+
+    template <typename ValueType>
+    void GroupedConvolutionNode<ValueType>::Compute() const
+    {
+        auto&& inputLayout = this->GetInputMemoryLayout();
+        auto&& outputLayout = this->GetOutputMemoryLayout();
+        const size_t filterWidth = _convolutionalParameters.receptiveField;
+        const size_t stride = _convolutionalParameters.stride;
+        const size_t inputColumns = inputLayout.GetStride(1);
+        const size_t inputChannelStride = inputLayout.GetStride(2);
+        const size_t numFilters = outputLayout.GetActiveSize(2);
+        const size_t channelsPerGroup = inputLayout.GetActiveSize(2) / _numGroups;
+        const size_t filtersPerGroup = numFilters / _numGroups;
+
+        // The input port holds the padded input, which the convolution reads starting at (0, 0)
+        auto inputData = _input.GetValue();
+        auto weightsData = _filterWeights.GetValue();
+        std::vector<ValueType> output(outputLayout.GetMemorySize());
+        for (int row = 0; row < outputLayout.GetActiveSize(0); ++row)
+        {
+            for (int column = 0; column < outputLayout.GetActiveSize(1); ++column)
+            {
+                for (size_t filter = 0; filter < numFilters; ++filter)
+                {
+                    const size_t firstChannel = (filter / filtersPerGroup) * channelsPerGroup;
+                    ValueType sum = 0;
+                    for (size_t filterRow = 0; filterRow < filterWidth; ++filterRow)
+                    {
+                        for (size_t filterColumn = 0; filterColumn < filterWidth; ++filterColumn)
+                        {
+                            const size_t inputOffset = ((row * stride + filterRow) * inputColumns + (column * stride + filterColumn)) * inputChannelStride + firstChannel;
+                            const size_t weightsOffset = (filterRow * filterWidth + filterColumn) * channelsPerGroup * numFilters + filter;
+                            for (size_t channel = 0; channel < channelsPerGroup; ++channel)
+                            {
+                                sum += inputData[inputOffset + channel] * weightsData[weightsOffset + channel * numFilters];
+                            }
+                        }
+                    }
+                    output[outputLayout.GetEntryOffset({ row, column, static_cast<int>(filter) })] = sum;
+                }
+            }
+        }
+        _output.SetOutput(output);
+    }
+
+    template <typename ValueType>
+    bool GroupedConvolutionNode<ValueType>::CanReuseOutputMemory(const model::OutputPortBase& port) const
+    {
+        // The padding region of the output is only set when the memory is initialized
+        return _outputMemoryLayout.NumEntries() == _outputMemoryLayout.GetMemorySize();
+    }
+
+    template <typename ValueType>
+    void GroupedConvolutionNode<ValueType>::Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function)
+    {
+        // input is a (h+2p) x (w+2p) x d array, read starting at (0, 0)
+        llvm::Value* pInput = compiler.EnsurePortEmitted(this->input);
+
+        // weights are a k x k x (d/g) x f array, so consecutive filters are adjacent
+        llvm::Value* pWeights = compiler.EnsurePortEmitted(this->filterWeights);
+
+        // output is a h x w x f array, possibly with padding
+        llvm::Value* pOutput = compiler.EnsurePortEmitted(this->output, static_cast<ValueType>(0));
+
+        // Get compiler settings
+        const auto& compilerSettings = compiler.GetCompilerParameters();
+        const int vectorSize = compilerSettings.allowVectorInstructions ? compilerSettings.vectorWidth : 1;
+
+        // Model parameters
+        auto&& inputLayout = this->GetInputMemoryLayout();
+        auto&& outputLayout = this->GetOutputMemoryLayout();
+        const int filterWidth = static_cast<int>(_convolutionalParameters.receptiveField);
+        const int stride = static_cast<int>(_convolutionalParameters.stride);
+        const int numGroups = static_cast<int>(_numGroups);
+        const int inputColumns = inputLayout.GetStride(1);
+        const int inputChannelStride = inputLayout.GetStride(2);
+        const int channelsPerGroup = inputLayout.GetActiveSize(2) / numGroups;
+
+        const int outputHeight = outputLayout.GetActiveSize(0);
+        const int outputWidth = outputLayout.GetActiveSize(1);
+        const int numFilters = outputLayout.GetActiveSize(2);
+        const int filtersPerGroup = numFilters / numGroups;
+        const int outputColumnStride = outputLayout.GetStride(1);
+        const int outputChannelStride = outputLayout.GetStride(2);
+
+        // In a depthwise convolution each filter reads the input channel with the same index, so the input can be
+        // loaded as a vector too
+        const bool isDepthwise = channelsPerGroup == 1 && filtersPerGroup == 1;
+
+        auto& emitter = function.GetEmitter();
+        auto elementType = emitter.Type(emitters::GetVariableType<ValueType>());
+        auto vectorType = vectorSize > 1 ? emitter.VectorType(emitters::GetVariableType<ValueType>(), vectorSize) : nullptr;
+
+        // Emits the sum for `width` consecutive filters starting at `firstFilter`, reading input channels starting at `firstChannel`
+        auto emitFilterBlock = [&](llvm::Value* inputPixelOffset, llvm::Value* outputPixelOffset, llvm::Value* firstChannel, llvm::Value* firstFilter, int width) {
+            auto loadValues = [&](llvm::Value* pointer, llvm::Value* offset) {
+                return width == 1 ? function.ValueAt(pointer, offset) : emitters::LoadVector<ValueType>(function, function.PointerOffset(pointer, offset), vectorType);
+            };
+            auto broadcast = [&](llvm::Value* value) {
+                return width == 1 ? value : emitter.GetIRBuilder().CreateVectorSplat(width, value);
+            };
+
+            llvm::Value* accumulator = function.Variable(width == 1 ? elementType : vectorType, "accumulator");
+            function.Store(accumulator, width == 1 ? function.Literal<ValueType>(0) : emitters::FillVector<ValueType>(function, vectorType, 0));
+            auto accumulate = [&](llvm::Value* inputValue, llvm::Value* weightValue) {
+                function.Store(accumulator, function.Operator(plusFloat, function.Load(accumulator), function.Operator(timesFloat, inputValue, weightValue)));
+            };
+
+            for (int filterRow = 0; filterRow < filterWidth; ++filterRow)
+            {
+                for (int filterColumn = 0; filterColumn < filterWidth; ++filterColumn)
+                {
+                    const int tapOffset = (filterRow * inputColumns + filterColumn) * inputChannelStride;
+                    auto tapInputOffset = function.Operator(plus, inputPixelOffset, function.Literal<int>(tapOffset));
+                    const int tapWeightsOffset = (filterRow * filterWidth + filterColumn) * channelsPerGroup * numFilters;
+                    if (isDepthwise)
+                    {
+                        auto inputValue = loadValues(pInput, function.Operator(plus, tapInputOffset, firstFilter));
+                        auto weightValue = loadValues(pWeights, function.Operator(plus, function.Literal<int>(tapWeightsOffset), firstFilter));
+                        accumulate(inputValue, weightValue);
+                    }
+                    else
+                    {
+                        auto channelLoop = function.ForLoop();
+                        channelLoop.Begin(channelsPerGroup);
+                        {
+                            auto channel = channelLoop.LoadIterationVariable();
+                            auto inputValue = broadcast(function.ValueAt(pInput, function.Operator(plus, tapInputOffset, function.Operator(plus, firstChannel, channel))));
+                            auto weightsOffset = function.Operator(plus, function.Literal<int>(tapWeightsOffset), function.Operator(plus, function.Operator(times, channel, function.Literal<int>(numFilters)), firstFilter));
+                            accumulate(inputValue, loadValues(pWeights, weightsOffset));
+                        }
+                        channelLoop.End();
+                    }
+                }
+            }
+
+            auto outputOffset = function.Operator(plus, outputPixelOffset, firstFilter);
+            if (width == 1)
+            {
+                function.SetValueAt(pOutput, outputOffset, function.Load(accumulator));
+            }
+            else
+            {
+                emitters::StoreVector<ValueType>(function, function.PointerOffset(pOutput, outputOffset), function.Load(accumulator));
+            }
+        };
+
+        // Emits the sums for `count` consecutive filters, vectorized along the filters
+        auto emitFilters = [&](llvm::Value* inputPixelOffset, llvm::Value* outputPixelOffset, llvm::Value* firstChannel, llvm::Value* firstFilter, int count) {
+            const int numBlocks = vectorSize > 1 ? count / vectorSize : 0;
+            if (numBlocks > 0)
+            {
+                auto blockLoop = function.ForLoop();
+                blockLoop.Begin(numBlocks);
+                {
+                    auto block = blockLoop.LoadIterationVariable();
+                    auto blockFilter = function.Operator(plus, firstFilter, function.Operator(times, block, function.Literal<int>(vectorSize)));
+                    emitFilterBlock(inputPixelOffset, outputPixelOffset, firstChannel, blockFilter, vectorSize);
+                }
+                blockLoop.End();
+            }
+
+            const int numScalarFilters = count - numBlocks * vectorSize;
+            if (numScalarFilters > 0)
+            {
+                auto filterLoop = function.ForLoop();
+                filterLoop.Begin(numScalarFilters);
+                {
+                    auto filter = function.Operator(plus, filterLoop.LoadIterationVariable(), function.Literal<int>(numBlocks * vectorSize));
+                    emitFilterBlock(inputPixelOffset, outputPixelOffset, firstChannel, function.Operator(plus, firstFilter, filter), 1);
+                }
+                filterLoop.End();
+            }
+        };
+
+        auto rowLoop = function.ForLoop();
+        rowLoop.Begin(outputHeight);
+        {
+            auto row = rowLoop.LoadIterationVariable();
+            auto inputRowOffset = function.Operator(times, row, function.Literal<int>(stride * inputColumns * inputChannelStride));
+            auto outputRow = function.Operator(plus, row, function.Literal<int>(outputLayout.GetOffset(0)));
+
+            auto columnLoop = function.ForLoop();
+            columnLoop.Begin(outputWidth);
+            {
+                auto column = columnLoop.LoadIterationVariable();
+                auto inputPixelOffset = function.Operator(plus, inputRowOffset, function.Operator(times, column, function.Literal<int>(stride * inputChannelStride)));
+                auto outputColumn = function.Operator(plus, column, function.Literal<int>(outputLayout.GetOffset(1)));
+                auto outputPixel = function.Operator(plus, function.Operator(times, outputRow, function.Literal<int>(outputColumnStride)), outputColumn);
+                auto outputPixelOffset = function.Operator(plus, function.Operator(times, outputPixel, function.Literal<int>(outputChannelStride)), function.Literal<int>(outputLayout.GetOffset(2)));
+
+                if (isDepthwise)
+                {
+                    emitFilters(inputPixelOffset, outputPixelOffset, function.Literal<int>(0), function.Literal<int>(0), numFilters);
+                }
+                else
+                {
+                    auto groupLoop = function.ForLoop();
+                    groupLoop.Begin(numGroups);
+                    {
+                        auto group = groupLoop.LoadIterationVariable();
+                        auto firstChannel = function.Operator(times, group, function.Literal<int>(channelsPerGroup));
+                        auto firstFilter = function.Operator(times, group, function.Literal<int>(filtersPerGroup));
+                        emitFilters(inputPixelOffset, outputPixelOffset, firstChannel, firstFilter, filtersPerGroup);
+                    }
+                    groupLoop.End();
+                }
+            }
+            columnLoop.End();
+        }
+        rowLoop.End();
+    }
+
+    // Explicit specializations
+    template class GroupedConvolutionNode<float>;
+    template class GroupedConvolutionNode<double>;
+} // nodes
+} // ell
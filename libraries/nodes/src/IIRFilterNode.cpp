@@ -80,9 +80,9 @@ namespace nodes
         const auto bSize = _filter.GetFeedforwardCoefficients().size();
         const auto aSize = _filter.GetRecursiveCoefficients().size();
 
-        // Allocate global variables to accumulate the previous input and output
-        llvm::GlobalVariable* prevInput = module.GlobalArray("prevInput_"s + GetInternalStateIdentifier(), std::vector<ValueType>(bSize, 0.0));
-        llvm::GlobalVariable* prevOutput = module.GlobalArray("prevOutput_"s + GetInternalStateIdentifier(), std::vector<ValueType>(aSize, 0.0));
+        // Allocate buffers to accumulate the previous input and output
+        llvm::Value* prevInput = compiler.EnsureNodeBufferEmitted(*this, "prevInput", emitters::GetVariableType<ValueType>(), bSize);
+        llvm::Value* prevOutput = compiler.EnsureNodeBufferEmitted(*this, "prevOutput", emitters::GetVariableType<ValueType>(), aSize);
 
         // Allocate global constants for the A and B filter coefficients
         std::vector<ValueType> bCoeffValues = detail::GetFilterCoeffArray(_filter.GetFeedforwardCoefficients());
@@ -90,9 +90,9 @@ namespace nodes
         llvm::GlobalVariable* bCoeffs = module.ConstantArray("bCoeffs_"s + GetInternalStateIdentifier(), bCoeffValues);
         llvm::GlobalVariable* aCoeffs = module.ConstantArray("aCoeffs_"s + GetInternalStateIdentifier(), aCoeffValues);
 
-        // Allocate global variable for current input and output indices
-        llvm::GlobalVariable* xIndexVar = module.Global<int>("xIndex_"s + GetInternalStateIdentifier(), 0);
-        llvm::GlobalVariable* yIndexVar = module.Global<int>("yIndex_"s + GetInternalStateIdentifier(), 0);
+        // Allocate variables for current input and output indices
+        llvm::Value* xIndexVar = compiler.EnsureNodeBufferEmitted(*this, "xIndex", emitters::VariableType::Int32, 1);
+        llvm::Value* yIndexVar = compiler.EnsureNodeBufferEmitted(*this, "yIndex", emitters::VariableType::Int32, 1);
 
         // Get input
         llvm::Value* pInput = compiler.EnsurePortEmitted(input);
@@ -15,6 +15,9 @@
 // utilities
 #include "Exception.h"
 
+// stl
+#include <vector>
+
 namespace ell
 {
 namespace nodes
@@ -40,36 +43,27 @@ namespace nodes
     {
         auto newInput = transformer.TransformPortElements(this->input.GetPortElements());
 
-        // Transform weights and bias members into constant nodes
-        const auto& inputWeights = this->_layer.GetInputWeights();
-        const auto& forgetMeWeights = this->_layer.GetForgetMeWeights();
-        const auto& candidateWeights = this->_layer.GetCandidateWeights();
-        const auto& outputWeights = this->_layer.GetOutputWeights();
-        const auto& inputBias = this->_layer.GetInputBias();
-        const auto& forgetMeBias = this->_layer.GetForgetMeBias();
-        const auto& candidateBias = this->_layer.GetCandidateBias();
-        const auto& outputBias = this->_layer.GetOutputBias();
-
-        auto inputWeightsNode = transformer.AddNode<ConstantNode<ValueType>>(inputWeights.ToArray());
-        auto forgetMeWeightsNode = transformer.AddNode<ConstantNode<ValueType>>(forgetMeWeights.ToArray());
-        auto candidateWeightsNode = transformer.AddNode<ConstantNode<ValueType>>(candidateWeights.ToArray());
-        auto outputWeightsNode = transformer.AddNode<ConstantNode<ValueType>>(outputWeights.ToArray());
+        // Stack the weights and biases of the 4 gates, so the compiled node can compute all the gates with one matrix-vector product
+        std::vector<ValueType> weights;
+        std::vector<ValueType> bias;
+        for (const auto& gateWeights : { this->_layer.GetInputWeights(), this->_layer.GetForgetMeWeights(), this->_layer.GetCandidateWeights(), this->_layer.GetOutputWeights() })
+        {
+            auto gateWeightsArray = gateWeights.ToArray();
+            weights.insert(weights.end(), gateWeightsArray.begin(), gateWeightsArray.end());
+        }
+        for (const auto& gateBias : { this->_layer.GetInputBias(), this->_layer.GetForgetMeBias(), this->_layer.GetCandidateBias(), this->_layer.GetOutputBias() })
+        {
+            auto gateBiasArray = gateBias.ToArray();
+            bias.insert(bias.end(), gateBiasArray.begin(), gateBiasArray.end());
+        }
 
-        auto inputBiasNode = transformer.AddNode<ConstantNode<ValueType>>(inputBias.ToArray());
-        auto forgetMeBiasNode = transformer.AddNode<ConstantNode<ValueType>>(forgetMeBias.ToArray());
-        auto candidateBiasNode = transformer.AddNode<ConstantNode<ValueType>>(candidateBias.ToArray());
-        auto outputBiasNode = transformer.AddNode<ConstantNode<ValueType>>(outputBias.ToArray());
+        auto weightsNode = transformer.AddNode<ConstantNode<ValueType>>(weights);
+        auto biasNode = transformer.AddNode<ConstantNode<ValueType>>(bias);
 
         using ComputeNodeType = LSTMNode<ValueType, ActivationFunctionType, RecurrentActivationFunctionType>;
         auto lstmNode = transformer.AddNode<ComputeNodeType>(newInput,
-                                                             inputWeightsNode->output,
-                                                             forgetMeWeightsNode->output,
-                                                             candidateWeightsNode->output,
-                                                             outputWeightsNode->output,
-                                                             inputBiasNode->output,
-                                                             forgetMeBiasNode->output,
-                                                             candidateBiasNode->output,
-                                                             outputBiasNode->output,
+                                                             weightsNode->output,
+                                                             biasNode->output,
                                                              this->GetInputMemoryLayout(),
                                                              this->GetOutputMemoryLayout());
 
@@ -82,61 +76,41 @@ namespace nodes
     //
     template <typename ValueType, template <typename> class ActivationFunctionType, template <typename> class RecurrentActivationFunctionType>
     LSTMNode<ValueType, ActivationFunctionType, RecurrentActivationFunctionType>::LSTMNode()
-        : CompilableNode({ &_input, &_inputWeights, &_forgetMeWeights, &_candidateWeights, &_outputWeights, &_inputBias, &_forgetMeBias, &_candidateBias, &_outputBias },
-                         { &_output })
+        : CompilableNode({ &_input, &_weights, &_bias }, { &_output })
         , _input(this, {}, defaultInputPortName)
-        , _inputWeights(this, {}, inputWeightsPortName)
-        , _forgetMeWeights(this, {}, forgetMeWeightsPortName)
-        , _candidateWeights(this, {}, candidateWeightsPortName)
-        , _outputWeights(this, {}, outputWeightsPortName)
-        , _inputBias(this, {}, inputBiasPortName)
-        , _forgetMeBias(this, {}, forgetMeBiasPortName)
-        , _candidateBias(this, {}, candidateBiasPortName)
-        , _outputBias(this, {}, outputBiasPortName)
+        , _weights(this, {}, weightsPortName)
+        , _bias(this, {}, biasPortName)
         , _output(this, defaultOutputPortName, 0)
     {
     }
 
     template <typename ValueType, template <typename> class ActivationFunctionType, template <typename> class RecurrentActivationFunctionType>
     LSTMNode<ValueType, ActivationFunctionType, RecurrentActivationFunctionType>::LSTMNode(const model::PortElements<ValueType>& input,
-                                                                                           const model::PortElements<ValueType>& inputWeights,
-                                                                                           const model::PortElements<ValueType>& forgetMeWeights,
-                                                                                           const model::PortElements<ValueType>& candidateWeights,
-                                                                                           const model::PortElements<ValueType>& outputWeights,
-                                                                                           const model::PortElements<ValueType>& inputBias,
-                                                                                           const model::PortElements<ValueType>& forgetMeBias,
-                                                                                           const model::PortElements<ValueType>& candidateBias,
-                                                                                           const model::PortElements<ValueType>& outputBias,
+                                                                                           const model::PortElements<ValueType>& weights,
+                                                                                           const model::PortElements<ValueType>& bias,
                                                                                            const model::PortMemoryLayout& inputMemoryLayout,
                                                                                            const model::PortMemoryLayout& outputMemoryLayout)
-        : CompilableNode({ &_input, &_inputWeights, &_forgetMeWeights, &_candidateWeights, &_outputWeights, &_inputBias, &_forgetMeBias, &_candidateBias, &_outputBias },
-                         { &_output })
+        : CompilableNode({ &_input, &_weights, &_bias }, { &_output })
         , _input(this, input, defaultInputPortName)
-        , _inputWeights(this, inputWeights, inputWeightsPortName)
-        , _forgetMeWeights(this, forgetMeWeights, forgetMeWeightsPortName)
-        , _candidateWeights(this, candidateWeights, candidateWeightsPortName)
-        , _outputWeights(this, outputWeights, outputWeightsPortName)
-        , _inputBias(this, inputBias, inputBiasPortName)
-        , _forgetMeBias(this, forgetMeBias, forgetMeBiasPortName)
-        , _candidateBias(this, candidateBias, candidateBiasPortName)
-        , _outputBias(this, outputBias, outputBiasPortName)
-        , _output(this, defaultOutputPortName, inputBias.Size())
+        , _weights(this, weights, weightsPortName)
+        , _bias(this, bias, biasPortName)
+        , _output(this, defaultOutputPortName, bias.Size() / 4)
+        , _inputMemoryLayout(inputMemoryLayout)
+        , _outputMemoryLayout(outputMemoryLayout)
     {
+        if (bias.Size() % 4 != 0 || weights.Size() != bias.Size() * (input.Size() + bias.Size() / 4))
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::sizeMismatch, "LSTMNode weights and bias must hold the stacked values of 4 gates");
+        }
     }
 
     template <typename ValueType, template <typename> class ActivationFunctionType, template <typename> class RecurrentActivationFunctionType>
     void LSTMNode<ValueType, ActivationFunctionType, RecurrentActivationFunctionType>::Copy(model::ModelTransformer& transformer) const
     {
         auto newInput = transformer.TransformPortElements(_input.GetPortElements());
-        auto newInputWeights = transformer.TransformPortElements(_inputWeights.GetPortElements());
-        auto newForgetMeWeights = transformer.TransformPortElements(_forgetMeWeights.GetPortElements());
-        auto newCandidateWeights = transformer.TransformPortElements(_candidateWeights.GetPortElements());
-        auto newOutputWeights = transformer.TransformPortElements(_outputWeights.GetPortElements());
-        auto newInputBias = transformer.TransformPortElements(_inputBias.GetPortElements());
-        auto newForgetMeBias = transformer.TransformPortElements(_forgetMeBias.GetPortElements());
-        auto newCandidateBias = transformer.TransformPortElements(_candidateBias.GetPortElements());
-        auto newOutputBias = transformer.TransformPortElements(_outputBias.GetPortElements());
-        auto newNode = transformer.AddNode<LSTMNode>(newInput, newInputWeights, newForgetMeWeights, newCandidateWeights, newOutputWeights, newInputBias, newForgetMeBias, newCandidateBias, newOutputBias, _inputMemoryLayout, _outputMemoryLayout);
+        auto newWeights = transformer.TransformPortElements(_weights.GetPortElements());
+        auto newBias = transformer.TransformPortElements(_bias.GetPortElements());
+        auto newNode = transformer.AddNode<LSTMNode>(newInput, newWeights, newBias, _inputMemoryLayout, _outputMemoryLayout);
         transformer.MapNodeOutput(output, newNode->output);
     }
 
@@ -146,55 +120,6 @@ namespace nodes
         throw utilities::LogicException(utilities::LogicExceptionErrors::notImplemented, "LSTMNode does not currently compute");
     }
 
-    template <typename ValueType, template <typename> class ActivationFunctionType, template <typename> class RecurrentActivationFunctionType>
-    void LSTMNode<ValueType, ActivationFunctionType, RecurrentActivationFunctionType>::ApplySoftmax(emitters::IRFunctionEmitter& function, llvm::Value* data, size_t dataLength)
-    {
-        const auto plusFloat = emitters::TypedOperator::addFloat;
-        const auto divideFloat = emitters::TypedOperator::divideFloat;
-        auto expFunc = function.GetModule().GetRuntime().GetExpFunction<ValueType>();
-
-        llvm::AllocaInst* sum = function.Variable(emitters::GetVariableType<ValueType>(), 1);
-        function.SetValueAt(sum, 0, function.Literal<ValueType>(0.0));
-
-        auto forLoop = function.ForLoop();
-        forLoop.Begin(dataLength);
-        {
-            auto i = forLoop.LoadIterationVariable();
-            llvm::Value* inputValue = function.ValueAt(data, i);
-
-            auto expInput = function.Call(expFunc, { inputValue });
-            auto addToSum = function.Operator(plusFloat, function.ValueAt(sum, 0), expInput);
-            function.SetValueAt(sum, 0, addToSum);
-            function.SetValueAt(data, i, expInput);
-        }
-        forLoop.End();
-
-        auto forLoop2 = function.ForLoop();
-        forLoop2.Begin(dataLength);
-        {
-            auto i = forLoop2.LoadIterationVariable();
-            llvm::Value* inputValue = function.ValueAt(data, i);
-            auto expDivSum = function.Operator(divideFloat, inputValue, function.ValueAt(sum, 0));
-            function.SetValueAt(data, i, expDivSum);
-        }
-        forLoop2.End();
-    }
-
-    template <typename ValueType, template <typename> class ActivationFunctionType, template <typename> class RecurrentActivationFunctionType>
-    template <typename ActivationType>
-    void LSTMNode<ValueType, ActivationFunctionType, RecurrentActivationFunctionType>::ApplyActivation(emitters::IRFunctionEmitter& function, ActivationType& activationFunction, llvm::Value* data, size_t dataLength)
-    {
-        auto forLoop = function.ForLoop();
-        forLoop.Begin(dataLength);
-        {
-            auto i = forLoop.LoadIterationVariable();
-            llvm::Value* inputValue = function.ValueAt(data, i);
-            llvm::Value* x = activationFunction.Compile(function, inputValue);
-            function.SetValueAt(data, i, x);
-        }
-        forLoop.End();
-    }
-
     template <typename ValueType, template <typename> class ActivationFunctionType, template <typename> class RecurrentActivationFunctionType>
     void LSTMNode<ValueType, ActivationFunctionType, RecurrentActivationFunctionType>::Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function)
     {
@@ -202,27 +127,21 @@ namespace nodes
         const auto timesFloat = emitters::TypedOperator::multiplyFloat;
 
         const size_t inputSize = this->input.Size();
-        const size_t hiddenSize = this->inputBias.Size();
+        const size_t hiddenSize = this->output.Size();
+        const size_t numGates = 4;
 
         ActivationFunctionType<ValueType> layerActivationFunction;
         auto activationFunction = GetNodeActivationFunction(layerActivationFunction);
         RecurrentActivationFunctionType<ValueType> recurrentLayerActivationFunction;
         auto recurrentActivationFunction = GetNodeActivationFunction(recurrentLayerActivationFunction);
 
-        // Global state (in addition to output)
-        llvm::GlobalVariable* ctActual = function.GetModule().GlobalArray(emitters::GetVariableType<ValueType>(), "ctActual", hiddenSize);
+        // The cell state, kept from one call to the next (in addition to the hidden state, which is the output)
+        llvm::Value* ctActual = compiler.EnsureNodeBufferEmitted(*this, "cellState", emitters::GetVariableType<ValueType>(), hiddenSize);
 
         // Get LLVM references for all node inputs
         llvm::Value* input = compiler.EnsurePortEmitted(this->input);
-        llvm::Value* inputWeights = compiler.EnsurePortEmitted(this->inputWeights);
-        llvm::Value* forgetMeWeights = compiler.EnsurePortEmitted(this->forgetMeWeights);
-        llvm::Value* candidateWeights = compiler.EnsurePortEmitted(this->candidateWeights);
-        llvm::Value* outputWeights = compiler.EnsurePortEmitted(this->outputWeights);
-
-        llvm::Value* inputBias = compiler.EnsurePortEmitted(this->inputBias);
-        llvm::Value* forgetMeBias = compiler.EnsurePortEmitted(this->forgetMeBias);
-        llvm::Value* candidateBias = compiler.EnsurePortEmitted(this->candidateBias);
-        llvm::Value* outputBias = compiler.EnsurePortEmitted(this->outputBias);
+        llvm::Value* weights = EnsureWeightsEmitted(compiler, function, this->weights);
+        llvm::Value* bias = compiler.EnsurePortEmitted(this->bias);
 
         // Get LLVM reference for node output
         llvm::Value* output = compiler.EnsurePortEmitted(this->output);
@@ -232,67 +151,43 @@ namespace nodes
 
         // Allocate local variables
         llvm::AllocaInst* inputPlusHidden = function.Variable(emitters::GetVariableType<ValueType>(), inputSize + hiddenSize);
-        llvm::AllocaInst* ft = function.Variable(emitters::GetVariableType<ValueType>(), hiddenSize);
-        llvm::AllocaInst* it = function.Variable(emitters::GetVariableType<ValueType>(), hiddenSize);
-        llvm::AllocaInst* ctNew = function.Variable(emitters::GetVariableType<ValueType>(), hiddenSize);
-        llvm::AllocaInst* ot = function.Variable(emitters::GetVariableType<ValueType>(), hiddenSize);
+        llvm::AllocaInst* gates = function.Variable(emitters::GetVariableType<ValueType>(), numGates * hiddenSize);
 
         // Concatenate input and hidden state into combined [Xt, Ht-1]
         function.MemoryCopy<ValueType>(input, inputPlusHidden, inputSize);
         function.MemoryCopy<ValueType>(hiddenState, 0, inputPlusHidden, inputSize, hiddenSize);
 
-        // ft = recurrentFunction(Wf * [Xt, Ht-1] + Bf)    (where recurrentFunction is usually sigmoid)
-        function.MemoryCopy<ValueType>(forgetMeBias, ft, hiddenSize); // Copy bias values into output so GEMM call accumulates them
-        function.CallGEMV(hiddenSize, inputSize + hiddenSize, static_cast<ValueType>(1.0), forgetMeWeights, inputSize + hiddenSize, inputPlusHidden, 1, static_cast<ValueType>(1.0), ft, 1);
-        ApplyActivation(function, recurrentActivationFunction, ft, hiddenSize);
-
-        // it = recurrentFunction(Wi * [Xt, Ht-1] + Bi)    (where recurrentFunction is usually sigmoid)
-        function.MemoryCopy<ValueType>(inputBias, it, hiddenSize); // Copy bias values into output so GEMM call accumulates them
-        function.CallGEMV(hiddenSize, inputSize + hiddenSize, static_cast<ValueType>(1.0), inputWeights, inputSize + hiddenSize, inputPlusHidden, 1, static_cast<ValueType>(1.0), it, 1);
-        ApplyActivation(function, recurrentActivationFunction, it, hiddenSize);
-
-        // Ct~ = activationFunction(Wc * [Xt, Ht-1] + Bc)  (where activationFunction is usually tanh)
-        function.MemoryCopy<ValueType>(candidateBias, ctNew, hiddenSize); // Copy bias values into output so GEMM call accumulates them
-        function.CallGEMV(hiddenSize, inputSize + hiddenSize, static_cast<ValueType>(1.0), candidateWeights, inputSize + hiddenSize, inputPlusHidden, 1, static_cast<ValueType>(1.0), ctNew, 1);
-        ApplyActivation(function, activationFunction, ctNew, hiddenSize);
+        // [it; ft; Ct~; ot] = [Wi; Wf; Wc; Wo] * [Xt, Ht-1] + [Bi; Bf; Bc; Bo]
+        function.MemoryCopy<ValueType>(bias, gates, numGates * hiddenSize); // Copy bias values into output so GEMV call accumulates them
+        function.CallGEMV(numGates * hiddenSize, inputSize + hiddenSize, static_cast<ValueType>(1.0), weights, inputSize + hiddenSize, inputPlusHidden, 1, static_cast<ValueType>(1.0), gates, 1);
 
-        // Ct = ft * Ct-1 + it * Ct~
-        auto ctActualLoop = function.ForLoop();
-        ctActualLoop.Begin(hiddenSize);
+        // Apply the gate activations and update the state in one pass
+        auto gateLoop = function.ForLoop();
+        gateLoop.Begin(hiddenSize);
         {
-            auto index = ctActualLoop.LoadIterationVariable();
-            auto ctActualVal = function.ValueAt(ctActual, index);
-            auto ftVal = function.ValueAt(ft, index);
-            auto itVal = function.ValueAt(it, index);
-            auto ctNewVal = function.ValueAt(ctNew, index);
-
-            auto ftCt = function.Operator(timesFloat, ftVal, ctActualVal);
+            auto index = gateLoop.LoadIterationVariable();
+            auto gateValue = [&](size_t gate) { return function.ValueAt(gates, function.Operator(emitters::TypedOperator::add, index, function.Literal<int>(static_cast<int>(gate * hiddenSize)))); };
+
+            // it = recurrentFunction(Wi * [Xt, Ht-1] + Bi)    (where recurrentFunction is usually sigmoid)
+            auto itVal = recurrentActivationFunction.Compile(function, gateValue(0));
+            // ft = recurrentFunction(Wf * [Xt, Ht-1] + Bf)
+            auto ftVal = recurrentActivationFunction.Compile(function, gateValue(1));
+            // Ct~ = activationFunction(Wc * [Xt, Ht-1] + Bc)  (where activationFunction is usually tanh)
+            auto ctNewVal = activationFunction.Compile(function, gateValue(2));
+            // ot = recurrentFunction(Wo * [Xt, Ht-1] + Bo)
+            auto otVal = recurrentActivationFunction.Compile(function, gateValue(3));
+
+            // Ct = ft * Ct-1 + it * Ct~
+            auto ftCt = function.Operator(timesFloat, ftVal, function.ValueAt(ctActual, index));
             auto itctNew = function.Operator(timesFloat, itVal, ctNewVal);
+            auto ctVal = function.Operator(plusFloat, ftCt, itctNew);
+            function.SetValueAt(ctActual, index, ctVal);
 
-            auto result = function.Operator(plusFloat, ftCt, itctNew);
-            function.SetValueAt(ctActual, index, result);
-        }
-        ctActualLoop.End();
-
-        // ot = recurrentFunction(Wo * [Xt, Ht-1] + Bo)
-        function.MemoryCopy<ValueType>(outputBias, ot, hiddenSize); // Copy bias values into output so GEMM call accumulates them
-        function.CallGEMV(hiddenSize, inputSize + hiddenSize, static_cast<ValueType>(1.0), outputWeights, inputSize + hiddenSize, inputPlusHidden, 1, static_cast<ValueType>(1.0), ot, 1);
-        ApplyActivation(function, recurrentActivationFunction, ot, hiddenSize);
-
-        // compute the hidden layer and copy into state vector
-        // ht = ot * activationFunction(Ct)  (where activationFunction is usually tanh)
-        ApplyActivation(function, activationFunction, ctActual, hiddenSize);
-
-        auto outputLoop = function.ForLoop();
-        outputLoop.Begin(hiddenSize);
-        {
-            auto index = outputLoop.LoadIterationVariable();
-            auto otVal = function.ValueAt(ot, index);
-            auto ctVal = function.ValueAt(ctActual, index);
-            auto result = function.Operator(timesFloat, ctVal, otVal);
+            // ht = ot * activationFunction(Ct)
+            auto result = function.Operator(timesFloat, otVal, activationFunction.Compile(function, ctVal));
             function.SetValueAt(hiddenState, index, result);
         }
-        outputLoop.End();
+        gateLoop.End();
         // output <- hiddenState (no-op, since output and hidden state are aliases)
     }
 
@@ -7,15 +7,26 @@
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
 #include "MatrixMatrixMultiplyNode.h"
+#include "ConstantNode.h"
 
 // math
 #include "Matrix.h"
 #include "MatrixOperations.h"
 
+// stl
+#include <algorithm>
+
 namespace ell
 {
 namespace nodes
 {
+    namespace
+    {
+        // The most elements the batched input and output matrices of a node may have. Larger products (e.g., the
+        // convolutions of big images) gain little from a wider GEMM, so they're computed one sample at a time.
+        const size_t c_maxBatchMatrixSize = 1 << 22;
+    }
+
     template <typename ValueType>
     MatrixMatrixMultiplyNode<ValueType>::MatrixMatrixMultiplyNode()
         : CompilableNode({ &_input1, &_input2 }, { &_output }), _input1(this, {}, defaultInput1PortName), _input2(this, {}, defaultInput2PortName), _output(this, defaultOutputPortName, 0), _m(0), _n(0), _k(0), _lda(0), _ldb(0), _ldc(0), _transpose1(false), _transpose2(false)
@@ -85,13 +96,79 @@ namespace nodes
     template<typename ValueType>
     void MatrixMatrixMultiplyNode<ValueType>::Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function)
     {  
-        llvm::Value* pInput1 = compiler.EnsurePortEmitted(input1);
+        llvm::Value* pInput1 = EnsureWeightsEmitted(compiler, function, input1);
         llvm::Value* pInput2 = compiler.EnsurePortEmitted(input2);
         llvm::Value* pOutput = compiler.EnsurePortEmitted(output);
 
         function.CallGEMM<ValueType>(_transpose1, _transpose2, (int)_m, (int)_n, (int)_k, pInput1, (int)_lda, pInput2, (int)_ldb, pOutput, (int)_ldc);
     }
 
+    template <typename ValueType>
+    bool MatrixMatrixMultiplyNode<ValueType>::CanCompileBatch(model::IRMapCompiler& compiler)
+    {
+        return CanCompileBatchAsMatrixMultiply(compiler) || CompilableNode::CanCompileBatch(compiler);
+    }
+
+    template <typename ValueType>
+    void MatrixMatrixMultiplyNode<ValueType>::CompileBatch(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function, int batchSize)
+    {
+        if (!CanCompileBatchAsMatrixMultiply(compiler))
+        {
+            CompilableNode::CompileBatch(compiler, function, batchSize);
+            return;
+        }
+
+        // Copy the k x n right-hand matrix of each sample into the columns [sample * n, (sample + 1) * n) of one k x (batchSize * n)
+        // matrix, multiply it in one GEMM, and copy the columns of the product back out to each sample's m x n output
+        const int m = static_cast<int>(_m);
+        const int n = static_cast<int>(_n);
+        const int k = static_cast<int>(_k);
+        const int batchColumns = batchSize * n;
+        llvm::Value* pInput1 = EnsureWeightsEmitted(compiler, function, input1);
+        llvm::Value* pInputs2 = compiler.EnsureBatchPortEmitted(input2, function);
+        llvm::Value* pOutputs = compiler.EnsureBatchPortEmitted(output, function);
+        auto pBatchInput2 = compiler.EnsureNodeBufferEmitted(*this, "batchInput2", emitters::GetVariableType<ValueType>(), _k * batchColumns);
+        auto pBatchOutput = compiler.EnsureNodeBufferEmitted(*this, "batchOutput", emitters::GetVariableType<ValueType>(), _m * batchColumns);
+
+        auto input2Stride = function.Literal(compiler.GetBatchPortStride(input2));
+        auto outputStride = function.Literal(compiler.GetBatchPortStride(output));
+        const int ldb = static_cast<int>(_ldb);
+        const int ldc = static_cast<int>(_ldc);
+        auto copyColumns = [n, batchColumns](emitters::IRFunctionEmitter& function, int numRows, llvm::Value* pSampleMatrix, int sampleStride, llvm::Value* pBatchMatrix, llvm::Value* sample, bool toBatch) {
+            auto batchColumn = function.Operator(emitters::TypedOperator::multiply, sample, function.Literal(n));
+            function.For(numRows, [=](emitters::IRFunctionEmitter& function, llvm::Value* row) {
+                auto sampleOffset = function.Operator(emitters::TypedOperator::multiply, row, function.Literal(sampleStride));
+                auto batchOffset = function.Operator(emitters::TypedOperator::add, function.Operator(emitters::TypedOperator::multiply, row, function.Literal(batchColumns)), batchColumn);
+                if (toBatch)
+                {
+                    function.MemoryCopy<ValueType>(pSampleMatrix, sampleOffset, pBatchMatrix, batchOffset, function.Literal(n));
+                }
+                else
+                {
+                    function.MemoryCopy<ValueType>(pBatchMatrix, batchOffset, pSampleMatrix, sampleOffset, function.Literal(n));
+                }
+            });
+        };
+
+        function.For(batchSize, [=](emitters::IRFunctionEmitter& function, llvm::Value* sample) {
+            auto pInput2 = function.PointerOffset(pInputs2, function.Operator(emitters::TypedOperator::multiply, sample, input2Stride));
+            copyColumns(function, k, pInput2, ldb, pBatchInput2, sample, true);
+        });
+        function.CallGEMM<ValueType>(_transpose1, false, m, batchColumns, k, pInput1, (int)_lda, pBatchInput2, batchColumns, pBatchOutput, batchColumns);
+        function.For(batchSize, [=](emitters::IRFunctionEmitter& function, llvm::Value* sample) {
+            auto pOutput = function.PointerOffset(pOutputs, function.Operator(emitters::TypedOperator::multiply, sample, outputStride));
+            copyColumns(function, m, pOutput, ldc, pBatchOutput, sample, false);
+        });
+    }
+
+    template <typename ValueType>
+    bool MatrixMatrixMultiplyNode<ValueType>::CanCompileBatchAsMatrixMultiply(const model::IRMapCompiler& compiler) const
+    {
+        const auto batchSize = static_cast<size_t>(compiler.GetMapCompilerParameters().predictBatchSize);
+        const auto batchMatrixSize = std::max(_k, _m) * _n * batchSize;
+        return !_transpose2 && batchMatrixSize <= c_maxBatchMatrixSize && input1.GetPortElements().IsFullPortOutput() && compiler.IsBatchInvariant(input1) && input2.GetPortElements().NumRanges() == 1 && !compiler.IsBatchInvariant(input2);
+    }
+
     template<typename ValueType>
     void MatrixMatrixMultiplyNode<ValueType>::WriteToArchive(utilities::Archiver& archiver) const
     {
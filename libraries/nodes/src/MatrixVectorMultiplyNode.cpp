@@ -7,6 +7,7 @@
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
 #include "MatrixVectorMultiplyNode.h"
+#include "ConstantNode.h"
 
 // math
 #include "Matrix.h"
@@ -67,13 +68,53 @@ namespace nodes
     template <typename ValueType>
     void MatrixVectorMultiplyNode<ValueType>::Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function)
     {
-        llvm::Value* pInputMatrix = compiler.EnsurePortEmitted(inputMatrix);
+        llvm::Value* pInputMatrix = EnsureWeightsEmitted(compiler, function, inputMatrix);
         llvm::Value* pInputVector = compiler.EnsurePortEmitted(inputVector);
         llvm::Value* pOutput = compiler.EnsurePortEmitted(output);
 
         function.CallGEMV<ValueType>((int)_m, (int)_n, pInputMatrix, (int)_lda, pInputVector, _incx, pOutput, 1);
     }
 
+    template <typename ValueType>
+    bool MatrixVectorMultiplyNode<ValueType>::CanCompileBatch(model::IRMapCompiler& compiler)
+    {
+        return CanCompileBatchAsMatrixMultiply(compiler) || CompilableNode::CanCompileBatch(compiler);
+    }
+
+    template <typename ValueType>
+    void MatrixVectorMultiplyNode<ValueType>::CompileBatch(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function, int batchSize)
+    {
+        if (!CanCompileBatchAsMatrixMultiply(compiler))
+        {
+            CompilableNode::CompileBatch(compiler, function, batchSize);
+            return;
+        }
+
+        // The vectors of the samples are the rows of X, so the products are the columns of C = A * X'. The matrix stays the
+        // left operand, which may be stored in half precision.
+        const int m = static_cast<int>(_m);
+        llvm::Value* pInputMatrix = EnsureWeightsEmitted(compiler, function, inputMatrix);
+        llvm::Value* pInputVectors = compiler.EnsureBatchPortEmitted(inputVector, function);
+        llvm::Value* pOutputs = compiler.EnsureBatchPortEmitted(output, function);
+        auto pProducts = compiler.EnsureNodeBufferEmitted(*this, "batchProducts", emitters::GetVariableType<ValueType>(), _m * batchSize);
+        function.CallGEMM<ValueType>(false, true, m, batchSize, (int)_n, pInputMatrix, (int)_lda, pInputVectors, compiler.GetBatchPortStride(inputVector), pProducts, batchSize);
+
+        auto outputStride = function.Literal(compiler.GetBatchPortStride(output));
+        function.For(batchSize, [m, batchSize, pProducts, pOutputs, outputStride](emitters::IRFunctionEmitter& function, llvm::Value* sample) {
+            auto pOutput = function.PointerOffset(pOutputs, function.Operator(emitters::TypedOperator::multiply, sample, outputStride));
+            function.For(m, [batchSize, sample, pProducts, pOutput](emitters::IRFunctionEmitter& function, llvm::Value* i) {
+                auto productIndex = function.Operator(emitters::TypedOperator::add, function.Operator(emitters::TypedOperator::multiply, i, function.Literal(batchSize)), sample);
+                function.SetValueAt(pOutput, i, function.ValueAt(pProducts, productIndex));
+            });
+        });
+    }
+
+    template <typename ValueType>
+    bool MatrixVectorMultiplyNode<ValueType>::CanCompileBatchAsMatrixMultiply(const model::IRMapCompiler& compiler) const
+    {
+        return _incx == 1 && inputMatrix.GetPortElements().IsFullPortOutput() && compiler.IsBatchInvariant(inputMatrix) && inputVector.GetPortElements().NumRanges() == 1 && !compiler.IsBatchInvariant(inputVector);
+    }
+
     template <typename ValueType>
     void MatrixVectorMultiplyNode<ValueType>::WriteToArchive(utilities::Archiver& archiver) const
     {
@@ -7,9 +7,14 @@
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
 #include "NeuralNetworkPredictorNode.h"
+#include "BroadcastFunctionNode.h"
+#include "CompiledActivationFunctions.h"
 #include "ConstantNode.h"
 #include "ReorderDataNode.h"
 
+// model
+#include "MapCompiler.h"
+
 // data
 #include "DenseDataVector.h"
 
@@ -17,6 +22,7 @@
 #include "Exception.h"
 
 // stl
+#include <algorithm>
 #include <cassert>
 #include <string>
 #include <vector>
@@ -32,6 +38,96 @@ namespace nodes
         {
             return shape[0] * shape[1] * shape[2];
         }
+
+        // The per-channel linear function y = scale * x + bias computed by a run of batch normalization, scaling, and bias layers
+        template <typename ValueType>
+        struct ChannelLinearFunction
+        {
+            std::vector<ValueType> scale;
+            std::vector<ValueType> bias;
+        };
+
+        // If `layer` computes a per-channel linear function, composes it onto the end of `function` and returns true
+        template <typename ValueType>
+        bool TryComposeLinearLayer(const predictors::neural::Layer<ValueType>& layer, ChannelLinearFunction<ValueType>& function)
+        {
+            std::vector<ValueType> scale;
+            std::vector<ValueType> bias;
+            if (auto batchNormalizationLayer = dynamic_cast<const predictors::neural::BatchNormalizationLayer<ValueType>*>(&layer))
+            {
+                scale = batchNormalizationLayer->GetScale().ToArray();
+                bias = batchNormalizationLayer->GetBias().ToArray();
+            }
+            else if (auto scalingLayer = dynamic_cast<const predictors::neural::ScalingLayer<ValueType>*>(&layer))
+            {
+                scale = scalingLayer->GetScale().ToArray();
+            }
+            else if (auto biasLayer = dynamic_cast<const predictors::neural::BiasLayer<ValueType>*>(&layer))
+            {
+                bias = biasLayer->GetBias().ToArray();
+            }
+            else
+            {
+                return false;
+            }
+
+            const auto numChannels = function.scale.size();
+            if ((!scale.empty() && scale.size() != numChannels) || (!bias.empty() && bias.size() != numChannels))
+            {
+                return false;
+            }
+
+            // f2(f1(x)) = s2 * (s1 * x + b1) + b2 = (s1 * s2) * x + (b1 * s2 + b2)
+            for (size_t index = 0; index < numChannels; ++index)
+            {
+                const ValueType s2 = scale.empty() ? 1 : scale[index];
+                const ValueType b2 = bias.empty() ? 0 : bias[index];
+                function.scale[index] *= s2;
+                function.bias[index] = function.bias[index] * s2 + b2;
+            }
+            return true;
+        }
+
+        // If `layer` is an activation layer of the given type, adds a node computing activation(x + bias) and returns true
+        template <typename ValueType, template <typename> class ActivationFunctionType>
+        bool TryAddBiasActivationNode(model::ModelTransformer& transformer, const predictors::neural::Layer<ValueType>& layer, const model::PortElements<ValueType>& input, const model::PortMemoryLayout& inputLayout, const model::PortMemoryLayout& outputLayout, const std::vector<ValueType>& bias, model::PortElements<ValueType>& output)
+        {
+            auto activationLayer = dynamic_cast<const predictors::neural::ActivationLayer<ValueType, ActivationFunctionType>*>(&layer);
+            if (activationLayer == nullptr)
+            {
+                return false;
+            }
+
+            const size_t channelDimension = 2;
+            auto activation = GetNodeActivationFunction(activationLayer->GetActivationFunction());
+            using FunctionType = BroadcastBiasActivationFunction<ValueType, decltype(activation)>;
+            auto biasValuesNode = transformer.AddNode<ConstantNode<ValueType>>(bias);
+            auto computeNode = transformer.AddNode<BroadcastBinaryFunctionNode<ValueType, FunctionType>>(input, inputLayout, biasValuesNode->output, channelDimension, outputLayout, FunctionType{ activation });
+            output = computeNode->output;
+            return true;
+        }
+
+        template <typename ValueType>
+        bool IsFusableActivationLayer(const predictors::neural::Layer<ValueType>& layer)
+        {
+            using namespace predictors::neural;
+            return dynamic_cast<const ActivationLayer<ValueType, ReLUActivation>*>(&layer) != nullptr ||
+                   dynamic_cast<const ActivationLayer<ValueType, LeakyReLUActivation>*>(&layer) != nullptr ||
+                   dynamic_cast<const ActivationLayer<ValueType, SigmoidActivation>*>(&layer) != nullptr;
+        }
+
+        // Returns true if the activation is nondecreasing, so that it commutes with taking the maximum of its inputs
+        template <typename ValueType>
+        bool IsNondecreasingActivationLayer(const predictors::neural::Layer<ValueType>& layer)
+        {
+            using namespace predictors::neural;
+            if (auto leakyReLULayer = dynamic_cast<const ActivationLayer<ValueType, LeakyReLUActivation>*>(&layer))
+            {
+                return leakyReLULayer->GetActivationFunction().GetLeakyFactor() >= 0;
+            }
+            return dynamic_cast<const ActivationLayer<ValueType, ReLUActivation>*>(&layer) != nullptr ||
+                   dynamic_cast<const ActivationLayer<ValueType, SigmoidActivation>*>(&layer) != nullptr;
+        }
     }
 
     template <typename ValueType>
@@ -125,24 +221,171 @@ namespace nodes
         size_t prevOutputSize = GetShapeSize(inputLayer.GetOutputShape()); // With padding
         UNUSED(prevOutputSize);
         auto layerInputs = model::PortElements<ValueType>(newInputElements);
-        NeuralNetworkLayerNodeBase<ValueType>* lastNode = nullptr;
 
-        for (const auto& layer : _predictor.GetLayers())
+        // When compiling with linear function fusion, fold runs of layers into single layer nodes with a fused epilogue
+        auto compiler = transformer.GetContext().GetCompiler();
+        const bool fuseLayers = compiler != nullptr && compiler->GetMapCompilerParameters().fuseLinearFunctionNodes;
+
+        const auto& layers = _predictor.GetLayers();
+        for (size_t layerIndex = 0; layerIndex < layers.size(); ++layerIndex)
         {
+            const auto& layer = layers[layerIndex];
             auto numInputs = GetShapeSize(layer->GetInputShape());
             DEBUG_USED(numInputs);
             assert(prevOutputSize == numInputs);
-            auto layerNode = AddLayerNode(transformer, *layer, layerInputs, options, state);
 
-            prevOutputSize = GetShapeSize(layer->GetOutputShape());
-            layerInputs = model::PortElements<ValueType>{ *layerNode->GetOutputPort(0) };
-            lastNode = layerNode;
+            model::PortElements<ValueType> layerOutputs;
+            auto numFusedLayers = fuseLayers ? TryAddFusedLayerNodes(transformer, layerIndex, layerInputs, layerOutputs) : 0;
+            if (numFusedLayers > 0)
+            {
+                layerIndex += numFusedLayers - 1;
+            }
+            else
+            {
+                auto layerNode = AddLayerNode(transformer, *layer, layerInputs, options, state);
+                layerOutputs = model::PortElements<ValueType>{ *layerNode->GetOutputPort(0) };
+            }
+
+            prevOutputSize = GetShapeSize(layers[layerIndex]->GetOutputShape());
+            layerInputs = layerOutputs;
         }
 
-        transformer.MapNodeOutput(_output, *lastNode->GetOutputPort(0));
+        transformer.MapNodeOutput(_output, layerInputs);
         return true;
     }
 
+    template <typename ValueType>
+    size_t NeuralNetworkPredictorNode<ValueType>::TryAddFusedLayerNodes(model::ModelTransformer& transformer, size_t layerIndex, const model::PortElements<ValueType>& layerInputs, model::PortElements<ValueType>& layerOutputs) const
+    {
+        const auto& layers = _predictor.GetLayers();
+        const auto& firstLayer = *layers[layerIndex];
+        auto convolutionalLayer = dynamic_cast<const predictors::neural::ConvolutionalLayer<ValueType>*>(&firstLayer);
+        auto fullyConnectedLayer = dynamic_cast<const predictors::neural::FullyConnectedLayer<ValueType>*>(&firstLayer);
+        if (convolutionalLayer == nullptr && fullyConnectedLayer == nullptr)
+        {
+            return 0;
+        }
+
+        // Compose the elementwise linear layers that follow, then look for an activation to use as the epilogue
+        const auto activeShape = firstLayer.GetOutputShapeMinusPadding();
+        const auto numChannels = activeShape.NumChannels();
+        ChannelLinearFunction<ValueType> linearFunction{ std::vector<ValueType>(numChannels, 1), std::vector<ValueType>(numChannels, 0) };
+        auto lastIndex = layerIndex;
+        while (lastIndex + 1 < layers.size() && layers[lastIndex + 1]->GetOutputShapeMinusPadding() == activeShape && TryComposeLinearLayer(*layers[lastIndex + 1], linearFunction))
+        {
+            ++lastIndex;
+        }
+
+        const bool hasActivation = lastIndex + 1 < layers.size() && layers[lastIndex + 1]->GetOutputShapeMinusPadding() == activeShape && IsFusableActivationLayer(*layers[lastIndex + 1]);
+        if (hasActivation)
+        {
+            ++lastIndex;
+        }
+
+        if (lastIndex == layerIndex)
+        {
+            return 0; // nothing to fuse
+        }
+
+        // The folded layer keeps the first layer's output padding, and the epilogue writes the last layer's output layout
+        const auto& lastLayerParameters = layers[lastIndex]->GetLayerParameters();
+        const int lastLayerPadding = static_cast<int>(lastLayerParameters.outputPaddingParameters.paddingSize);
+        model::PortMemoryLayout fusedOutputLayout({ static_cast<int>(activeShape.NumRows()), static_cast<int>(activeShape.NumColumns()), static_cast<int>(numChannels) }, { lastLayerPadding, lastLayerPadding, 0 });
+        const auto& fusedLayerParameters = firstLayer.GetLayerParameters();
+
+        // A max pooling layer that follows can be computed before the epilogue, because adding a per-channel bias and applying a
+        // nondecreasing activation both commute with taking the maximum. Then the epilogue only runs over the pooled output. This is
+        // only exact if the pooling never looks at padding values, since those aren't transformed by the epilogue.
+        using MaxPoolingLayer = predictors::neural::PoolingLayer<ValueType, predictors::neural::MaxPoolingFunction>;
+        const MaxPoolingLayer* poolingLayer = nullptr;
+        if (lastIndex + 1 < layers.size() && (!hasActivation || IsNondecreasingActivationLayer(*layers[lastIndex])))
+        {
+            poolingLayer = dynamic_cast<const MaxPoolingLayer*>(&(*layers[lastIndex + 1]));
+            if (poolingLayer != nullptr && (poolingLayer->UsesPadding() || poolingLayer->GetLayerParameters().inputPaddingParameters.paddingSize != fusedLayerParameters.outputPaddingParameters.paddingSize))
+            {
+                poolingLayer = nullptr;
+            }
+        }
+
+        // Fold the scale into the weights
+        const auto& scale = linearFunction.scale;
+        NeuralNetworkLayerNodeBase<ValueType>* layerNode = nullptr;
+        if (convolutionalLayer != nullptr)
+        {
+            // Each filter is `receptiveField` consecutive rows of the weights tensor
+            const auto& convolutionalParameters = convolutionalLayer->GetConvolutionalParameters();
+            typename Layer::TensorType weights = convolutionalLayer->GetWeights();
+            for (size_t rowIndex = 0; rowIndex < weights.NumRows(); ++rowIndex)
+            {
+                const auto filterScale = scale[rowIndex / convolutionalParameters.receptiveField];
+                for (size_t columnIndex = 0; columnIndex < weights.NumColumns(); ++columnIndex)
+                {
+                    for (size_t channelIndex = 0; channelIndex < weights.NumChannels(); ++channelIndex)
+                    {
+                        weights(rowIndex, columnIndex, channelIndex) *= filterScale;
+                    }
+                }
+            }
+
+            predictors::neural::ConvolutionalLayer<ValueType> fusedLayer(fusedLayerParameters, convolutionalParameters, weights);
+            layerNode = transformer.AddNode<ConvolutionalLayerNode<ValueType>>(layerInputs, fusedLayer);
+        }
+        else
+        {
+            // Each row of the weights matrix computes one output, and the outputs are in channel-major order
+            typename Layer::MatrixType weights = fullyConnectedLayer->GetWeights();
+            for (size_t rowIndex = 0; rowIndex < weights.NumRows(); ++rowIndex)
+            {
+                const auto outputScale = scale[rowIndex % numChannels];
+                for (size_t columnIndex = 0; columnIndex < weights.NumColumns(); ++columnIndex)
+                {
+                    weights(rowIndex, columnIndex) *= outputScale;
+                }
+            }
+
+            auto weightsReference = weights.GetConstReference();
+            predictors::neural::FullyConnectedLayer<ValueType> fusedLayer(fusedLayerParameters, weightsReference);
+            layerNode = transformer.AddNode<FullyConnectedLayerNode<ValueType>>(layerInputs, fusedLayer);
+        }
+        layerOutputs = model::PortElements<ValueType>{ *layerNode->GetOutputPort(0) };
+
+        // Pool the folded layer's output directly, instead of materializing the activated tensor
+        const auto activationIndex = lastIndex;
+        auto outputLayout = layerNode->GetOutputMemoryLayout();
+        if (poolingLayer != nullptr)
+        {
+            auto poolingNode = transformer.AddNode<PoolingLayerNode<ValueType, predictors::neural::MaxPoolingFunction>>(layerOutputs, *poolingLayer);
+            layerOutputs = model::PortElements<ValueType>{ poolingNode->output };
+            outputLayout = poolingNode->GetOutputMemoryLayout();
+            fusedOutputLayout = outputLayout;
+            ++lastIndex;
+        }
+
+        // Add the remaining bias and the activation in a single pass over the layer's output
+        const auto& bias = linearFunction.bias;
+        const bool hasBias = std::any_of(bias.begin(), bias.end(), [](ValueType value) { return value != 0; });
+        if (hasActivation)
+        {
+            using namespace predictors::neural;
+            const auto& activationLayer = *layers[activationIndex];
+            bool added = TryAddBiasActivationNode<ValueType, ReLUActivation>(transformer, activationLayer, layerOutputs, outputLayout, fusedOutputLayout, bias, layerOutputs) ||
+                         TryAddBiasActivationNode<ValueType, LeakyReLUActivation>(transformer, activationLayer, layerOutputs, outputLayout, fusedOutputLayout, bias, layerOutputs) ||
+                         TryAddBiasActivationNode<ValueType, SigmoidActivation>(transformer, activationLayer, layerOutputs, outputLayout, fusedOutputLayout, bias, layerOutputs);
+            DEBUG_USED(added);
+            assert(added);
+        }
+        else if (hasBias || !model::PortMemoryLayoutsEqual(outputLayout, fusedOutputLayout))
+        {
+            const size_t channelDimension = 2;
+            auto scaleValuesNode = transformer.AddNode<ConstantNode<ValueType>>(); // nothing
+            auto biasValuesNode = transformer.AddNode<ConstantNode<ValueType>>(bias);
+            auto computeNode = transformer.AddNode<BroadcastLinearFunctionNode<ValueType>>(layerOutputs, outputLayout, scaleValuesNode->output, biasValuesNode->output, channelDimension, fusedOutputLayout);
+            layerOutputs = model::PortElements<ValueType>{ computeNode->output };
+        }
+
+        return lastIndex - layerIndex + 1;
+    }
+
     template <typename ValueType>
     void NeuralNetworkPredictorNode<ValueType>::Compute() const
     {
@@ -9,16 +9,30 @@
 #include "PoolingLayerNode.h"
 #include "ConstantNode.h"
 
+// emitters
+#include "IRVectorUtilities.h"
+
 // predictors
 #include "MaxPoolingFunction.h"
 #include "MeanPoolingFunction.h"
 
+// stl
+#include <algorithm>
+#include <limits>
+#include <vector>
+
 namespace ell
 {
 namespace nodes
 {
     namespace
     {
+        // computes ceil(a/b)
+        int CeilDiv(int a, int b)
+        {
+            return (a - 1) / b + 1;
+        }
+
         struct Interval
         {
             int begin;
@@ -282,6 +296,70 @@ namespace nodes
         return value;
     }
 
+    template <typename ValueType, template <typename> class PoolingFunctionType>
+    llvm::Value* PoolingLayerNode<ValueType, PoolingFunctionType>::GetPoolingWindowVectorValue(emitters::IRFunctionEmitter& function,
+                                                                                               int windowRowBegin,
+                                                                                               int windowRowEnd,
+                                                                                               int windowColumnBegin,
+                                                                                               int windowColumnEnd,
+                                                                                               llvm::Value* inputRow,
+                                                                                               llvm::Value* inputColumn,
+                                                                                               llvm::Value* inputChannel,
+                                                                                               llvm::Value* inputBuffer,
+                                                                                               const model::Shape& inputIncrement,
+                                                                                               llvm::VectorType* vectorType)
+    {
+        const auto plus = emitters::TypedOperator::add;
+        const auto times = emitters::TypedOperator::multiply;
+        const bool isMaxPooling = std::is_same<PoolingFunctionType<ValueType>, predictors::neural::MaxPoolingFunction<ValueType>>::value;
+
+        // Number of cells in this pooling window
+        int numCells = (windowRowEnd - windowRowBegin) * (windowColumnEnd - windowColumnBegin);
+
+        // Window size and stride
+        auto poolingParameters = this->GetLayer().GetPoolingParameters();
+        int windowSize = poolingParameters.poolingSize;
+
+        // The window is unrolled, so the accumulated value is kept in a register instead of a variable. This mirrors
+        // the scalar MaxPoolingFunction and MeanPoolingFunction, so the results are identical.
+        llvm::Value* accumValue = nullptr;
+        if (isMaxPooling)
+        {
+            bool hasFullWindow = (numCells == windowSize * windowSize);
+            auto paddingValue = ell::predictors::neural::GetPaddingValue<ValueType>(this->GetLayer().GetLayerParameters().inputPaddingParameters.paddingScheme);
+            accumValue = emitters::FillVector<ValueType>(function, vectorType, hasFullWindow ? std::numeric_limits<ValueType>::lowest() : std::max(std::numeric_limits<ValueType>::lowest(), paddingValue));
+        }
+        else
+        {
+            accumValue = emitters::FillVector<ValueType>(function, vectorType, 0);
+        }
+
+        for (int poolingRow = windowRowBegin; poolingRow < windowRowEnd; ++poolingRow)
+        {
+            for (int poolingColumn = windowColumnBegin; poolingColumn < windowColumnEnd; ++poolingColumn)
+            {
+                auto poolingInputRow = function.Operator(plus, inputRow, function.Literal<int>(poolingRow));
+                auto poolingInputColumn = function.Operator(plus, inputColumn, function.Literal<int>(poolingColumn));
+                auto inputIndex = function.Operator(plus, function.Operator(plus, function.Operator(times, poolingInputRow, function.Literal<int>(inputIncrement[0])), function.Operator(times, poolingInputColumn, function.Literal<int>(inputIncrement[1]))), inputChannel);
+                auto value = emitters::LoadVector<ValueType>(function, function.PointerOffset(inputBuffer, inputIndex), vectorType);
+                if (isMaxPooling)
+                {
+                    accumValue = function.Select(function.Comparison(emitters::TypedComparison::greaterThanFloat, value, accumValue), value, accumValue);
+                }
+                else
+                {
+                    accumValue = function.Operator(emitters::TypedOperator::addFloat, accumValue, value);
+                }
+            }
+        }
+
+        if (!isMaxPooling)
+        {
+            accumValue = function.Operator(emitters::TypedOperator::divideFloat, accumValue, emitters::FillVector<ValueType>(function, vectorType, static_cast<ValueType>(numCells)));
+        }
+        return accumValue;
+    }
+
     /*
 
     # Splitting windowed operations into regions
@@ -408,14 +486,12 @@ namespace nodes
     */
 
     template <typename ValueType, template <typename> class PoolingFunctionType>
-    void PoolingLayerNode<ValueType, PoolingFunctionType>::Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function)
+    void PoolingLayerNode<ValueType, PoolingFunctionType>::EmitOutputRows(emitters::IRFunctionEmitter& function, llvm::Value* pInput, llvm::Value* pOutput, llvm::Value* beginRow, llvm::Value* endRow, int vectorSize)
     {
         // convenience operator names
         const auto plus = emitters::TypedOperator::add;
         const auto times = emitters::TypedOperator::multiply;
-
-        llvm::Value* pInput = compiler.EnsurePortEmitted(input);
-        llvm::Value* pOutput = compiler.EnsurePortEmitted(output);
+        const auto lessThan = emitters::TypedComparison::lessThan;
 
         // Input / output memory layouts
         const auto& inputLayout = this->GetInputMemoryLayout();
@@ -433,17 +509,7 @@ namespace nodes
         // Calculate input dimension parameters
         int inputRows = inputSize[0];
         int inputColumns = inputSize[1];
-        int inputDepth = inputSize[2];
-
-        int outputRows = outputSize[0];
-        int outputColumns = outputSize[1];
         int outputDepth = outputSize[2];
-        UNUSED(outputRows, outputColumns);
-
-        if (inputDepth != outputDepth)
-        {
-            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "Input and output of pooling layer must have same depth");
-        }
 
         // Window size and stride
         auto poolingParameters = this->GetLayer().GetPoolingParameters();
@@ -464,6 +530,10 @@ namespace nodes
 
         const bool usesPadding = GetLayer().UsesPadding();
 
+        // Channels are contiguous, so the first `numVectorChannels` channels of each output pixel are computed `vectorSize` at a time
+        const int numVectorChannels = vectorSize > 1 ? (outputDepth / vectorSize) * vectorSize : 0;
+        auto vectorType = vectorSize > 1 ? function.GetEmitter().VectorType(emitters::GetVariableType<ValueType>(), vectorSize) : nullptr;
+
         // Pointers to beginning of 'active' area of input and output
         const auto inputBufferOffset = (inputIncrement[0] * inputOffset[0]) + (inputIncrement[1] * inputOffset[1]) + (inputIncrement[2] * inputOffset[2]);
         const auto outputBufferOffset = (outputIncrement[0] * outputOffset[0]) + (outputIncrement[1] * outputOffset[1]) + (outputIncrement[2] * outputOffset[2]);
@@ -490,8 +560,14 @@ namespace nodes
 
                 if (maxOutputRow > minOutputRow && maxOutputCol > minOutputCol)
                 {
+                    // Restrict the region's rows to the ones we were asked to compute
+                    auto minOutputRowValue = function.Literal<int>(minOutputRow);
+                    auto maxOutputRowValue = function.Literal<int>(maxOutputRow);
+                    auto regionBeginRow = function.Select(function.Comparison(lessThan, beginRow, minOutputRowValue), minOutputRowValue, beginRow);
+                    auto regionEndRow = function.Select(function.Comparison(lessThan, endRow, maxOutputRowValue), endRow, maxOutputRowValue);
+
                     auto outputRowLoop = function.ForLoop();
-                    outputRowLoop.Begin(minOutputRow, maxOutputRow, 1);
+                    outputRowLoop.Begin(regionBeginRow, regionEndRow, function.Literal<int>(1));
                     {
                         auto outputRow = outputRowLoop.LoadIterationVariable();
                         auto inputRow = function.Operator(times, outputRow, function.Literal<int>(stride));
@@ -509,18 +585,35 @@ namespace nodes
                             {
                                 inputColumn = function.Operator(plus, inputColumn, function.Literal<int>(-negWindowExtent));
                             }
+                            auto outputPixelIndex = function.Operator(plus, function.Operator(times, outputRow, function.Literal<int>(outputIncrement[0])), function.Operator(times, outputColumn, function.Literal<int>(outputIncrement[1])));
 
-                            auto channelLoop = function.ForLoop();
-                            channelLoop.Begin(outputDepth);
+                            if (numVectorChannels > 0)
                             {
-                                auto channel = channelLoop.LoadIterationVariable();
-                                // Get the pooled value
-                                auto pooledValue = GetPoolingWindowValue(function, rowRegionBounds.windowBounds.begin, rowRegionBounds.windowBounds.end, columnRegionBounds.windowBounds.begin, columnRegionBounds.windowBounds.end, inputRow, inputColumn, channel, inputBuffer, inputIncrement, poolingFunction);
-                                // and store it in the output
-                                auto outputIndex = function.Operator(plus, function.Operator(plus, function.Operator(times, outputRow, function.Literal<int>(outputIncrement[0])), function.Operator(times, outputColumn, function.Literal<int>(outputIncrement[1]))), channel);
-                                function.SetValueAt(outputBuffer, outputIndex, pooledValue);
+                                auto vectorChannelLoop = function.ForLoop();
+                                vectorChannelLoop.Begin(0, numVectorChannels, vectorSize);
+                                {
+                                    auto channel = vectorChannelLoop.LoadIterationVariable();
+                                    auto pooledValue = GetPoolingWindowVectorValue(function, rowRegionBounds.windowBounds.begin, rowRegionBounds.windowBounds.end, columnRegionBounds.windowBounds.begin, columnRegionBounds.windowBounds.end, inputRow, inputColumn, channel, inputBuffer, inputIncrement, vectorType);
+                                    auto outputIndex = function.Operator(plus, outputPixelIndex, channel);
+                                    emitters::StoreVector<ValueType>(function, function.PointerOffset(outputBuffer, outputIndex), pooledValue);
+                                }
+                                vectorChannelLoop.End();
+                            }
+
+                            if (numVectorChannels < outputDepth)
+                            {
+                                auto channelLoop = function.ForLoop();
+                                channelLoop.Begin(numVectorChannels, outputDepth, 1);
+                                {
+                                    auto channel = channelLoop.LoadIterationVariable();
+                                    // Get the pooled value
+                                    auto pooledValue = GetPoolingWindowValue(function, rowRegionBounds.windowBounds.begin, rowRegionBounds.windowBounds.end, columnRegionBounds.windowBounds.begin, columnRegionBounds.windowBounds.end, inputRow, inputColumn, channel, inputBuffer, inputIncrement, poolingFunction);
+                                    // and store it in the output
+                                    auto outputIndex = function.Operator(plus, outputPixelIndex, channel);
+                                    function.SetValueAt(outputBuffer, outputIndex, pooledValue);
+                                }
+                                channelLoop.End();
                             }
-                            channelLoop.End();
                         }
                         outputColumnLoop.End();
                     }
@@ -528,6 +621,78 @@ namespace nodes
                 }
             }
         }
+    }
+
+    template <typename ValueType, template <typename> class PoolingFunctionType>
+    emitters::IRFunctionEmitter PoolingLayerNode<ValueType, PoolingFunctionType>::GetTaskFunction(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function, int vectorSize)
+    {
+        // Get port variables
+        llvm::Value* pInputTemp = compiler.EnsurePortEmitted(input);
+        llvm::Value* pOutputTemp = compiler.EnsurePortEmitted(output);
+
+        // Get LLVM types
+        auto& module = function.GetModule();
+        auto& context = module.GetLLVMContext();
+        auto voidType = llvm::Type::getVoidTy(context);
+
+        auto argTypes = emitters::GetLLVMTypes({ pInputTemp, pOutputTemp, function.Literal<int32_t>(0), function.Literal<int32_t>(0) });
+        emitters::IRFunctionEmitter taskFunction = function.GetModule().BeginFunction(utilities::to_string(this->GetId()) + "_task", voidType, argTypes);
+        {
+            auto arguments = taskFunction.Arguments().begin();
+            auto pInput = &(*arguments++);
+            auto pOutput = &(*arguments++);
+            auto beginRow = &(*arguments++);
+            auto endRow = &(*arguments++);
+
+            EmitOutputRows(taskFunction, pInput, pOutput, beginRow, endRow, vectorSize);
+            taskFunction.Return();
+        }
+        function.GetModule().EndFunction();
+
+        return taskFunction;
+    }
+
+    template <typename ValueType, template <typename> class PoolingFunctionType>
+    void PoolingLayerNode<ValueType, PoolingFunctionType>::Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function)
+    {
+        llvm::Value* pInput = compiler.EnsurePortEmitted(input);
+        llvm::Value* pOutput = compiler.EnsurePortEmitted(output);
+
+        const auto& compilerSettings = compiler.GetCompilerParameters();
+
+        const auto& inputSize = this->GetInputMemoryLayout().GetActiveSize();
+        const auto& outputSize = this->GetOutputMemoryLayout().GetActiveSize();
+        const int outputRows = outputSize[0];
+        const int outputDepth = outputSize[2];
+        if (inputSize[2] != outputDepth)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "Input and output of pooling layer must have same depth");
+        }
+
+        // Vectorize across channels only if there's at least one full vector of them
+        const int vectorSize = (compilerSettings.allowVectorInstructions && compilerSettings.vectorWidth > 1 && outputDepth >= compilerSettings.vectorWidth) ? compilerSettings.vectorWidth : 1;
+
+        // Split the output rows into contiguous bands, one per task
+        const int numDesiredTasks = compilerSettings.maxThreads;
+        const int taskSize = CeilDiv(outputRows, numDesiredTasks);
+        const int numTasks = CeilDiv(outputRows, taskSize);
+        if (compilerSettings.parallelize && numTasks > 1)
+        {
+            auto taskFunction = GetTaskFunction(compiler, function, vectorSize);
+            std::vector<std::vector<llvm::Value*>> taskArgs;
+            for (int taskIndex = 0; taskIndex < numTasks; ++taskIndex)
+            {
+                auto begin = taskIndex * taskSize;
+                auto end = std::min((taskIndex + 1) * taskSize, outputRows);
+                taskArgs.push_back({ pInput, pOutput, function.Literal<int32_t>(begin), function.Literal<int32_t>(end) });
+            }
+            auto tasks = function.StartTasks(taskFunction, taskArgs);
+            tasks.WaitAll(function);
+        }
+        else
+        {
+            EmitOutputRows(function, pInput, pOutput, function.Literal<int>(0), function.Literal<int>(outputRows), vectorSize);
+        }
     } // end function
 
     // Explicit specialization
@@ -0,0 +1,318 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     QuantizedMatrixMultiplyNode.cpp (nodes)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "QuantizedMatrixMultiplyNode.h"
+
+// stl
+#include <algorithm>
+#include <cmath>
+
+namespace ell
+{
+namespace nodes
+{
+    namespace
+    {
+        const int c_maxQuantizedValue = 127;
+    }
+
+    //
+    // Functions
+    //
+    template <typename ValueType>
+    int8_t QuantizeValue(ValueType value, double scale)
+    {
+        auto scaled = std::round(static_cast<double>(value) / scale);
+        return static_cast<int8_t>(std::max(-static_cast<double>(c_maxQuantizedValue), std::min(static_cast<double>(c_maxQuantizedValue), scaled)));
+    }
+
+    template <typename ValueType>
+    std::vector<int8_t> QuantizeMatrixRows(const std::vector<ValueType>& matrix, size_t rows, size_t columns, std::vector<double>& rowScales)
+    {
+        if (matrix.size() != rows * columns)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::sizeMismatch, "Matrix size doesn't match its dimensions");
+        }
+
+        std::vector<int8_t> result(rows * columns);
+        rowScales.resize(rows);
+        for (size_t i = 0; i < rows; ++i)
+        {
+            auto rowBegin = matrix.begin() + i * columns;
+            double maxMagnitude = 0;
+            std::for_each(rowBegin, rowBegin + columns, [&maxMagnitude](ValueType value) { maxMagnitude = std::max(maxMagnitude, std::abs(static_cast<double>(value))); });
+
+            // An all-zero row quantizes to zeros with any scale
+            rowScales[i] = maxMagnitude > 0 ? maxMagnitude / c_maxQuantizedValue : 1.0;
+            for (size_t j = 0; j < columns; ++j)
+            {
+                result[i * columns + j] = QuantizeValue(rowBegin[j], rowScales[i]);
+            }
+        }
+        return result;
+    }
+
+    template <typename ValueType>
+    const model::OutputPort<ValueType>& AddQuantizedMatrixMultiply(model::ModelTransformer& transformer, const std::vector<ValueType>& weights, size_t m, size_t k, const model::PortElements<ValueType>& input, size_t n, double inputScale)
+    {
+        std::vector<double> weightScales;
+        auto quantizedWeights = QuantizeMatrixRows(weights, m, k, weightScales);
+
+        // Entry (i, j) of the integer product is the true product divided by the scales of weights row i and of the input
+        std::vector<ValueType> outputScales(m);
+        std::transform(weightScales.begin(), weightScales.end(), outputScales.begin(), [inputScale](double scale) { return static_cast<ValueType>(scale * inputScale); });
+
+        auto multiplyNode = transformer.AddNode<QuantizedMatrixMultiplyNode<ValueType>>(input, m, n, k, quantizedWeights, inputScale);
+        auto dequantizeNode = transformer.AddNode<DequantizeNode<ValueType>>(multiplyNode->output, outputScales);
+        return dequantizeNode->output;
+    }
+
+    //
+    // QuantizedMatrixMultiplyNode
+    //
+    template <typename ValueType>
+    QuantizedMatrixMultiplyNode<ValueType>::QuantizedMatrixMultiplyNode()
+        : CompilableNode({ &_input }, { &_output }), _input(this, {}, defaultInputPortName), _output(this, defaultOutputPortName, 0), _m(0), _n(0), _k(0), _inputScale(1.0)
+    {
+    }
+
+    template <typename ValueType>
+    QuantizedMatrixMultiplyNode<ValueType>::QuantizedMatrixMultiplyNode(const model::PortElements<ValueType>& input, size_t m, size_t n, size_t k, const std::vector<int8_t>& weights, double inputScale)
+        : CompilableNode({ &_input }, { &_output }), _input(this, input, defaultInputPortName), _output(this, defaultOutputPortName, m * n), _m(m), _n(n), _k(k), _weights(weights), _inputScale(inputScale)
+    {
+        if (input.Size() != k * n)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "Input matrix size incorrect");
+        }
+
+        if (weights.size() != m * k)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "Weights matrix size incorrect");
+        }
+
+        if (inputScale <= 0)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "Input scale must be positive");
+        }
+    }
+
+    template <typename ValueType>
+    void QuantizedMatrixMultiplyNode<ValueType>::Compute() const
+    {
+        auto inputValues = input.GetValue();
+        std::vector<int> outputValues(_m * _n);
+        for (size_t j = 0; j < _n; ++j)
+        {
+            std::vector<int> quantizedColumn(_k);
+            for (size_t p = 0; p < _k; ++p)
+            {
+                quantizedColumn[p] = QuantizeValue(inputValues[p * _n + j], _inputScale);
+            }
+
+            for (size_t i = 0; i < _m; ++i)
+            {
+                int sum = 0;
+                for (size_t p = 0; p < _k; ++p)
+                {
+                    sum += static_cast<int>(_weights[i * _k + p]) * quantizedColumn[p];
+                }
+                outputValues[i * _n + j] = sum;
+            }
+        }
+        _output.SetOutput(outputValues);
+    }
+
+    template <typename ValueType>
+    void QuantizedMatrixMultiplyNode<ValueType>::Copy(model::ModelTransformer& transformer) const
+    {
+        auto newPortElements = transformer.TransformPortElements(_input.GetPortElements());
+        auto newNode = transformer.AddNode<QuantizedMatrixMultiplyNode<ValueType>>(newPortElements, _m, _n, _k, _weights, _inputScale);
+        transformer.MapNodeOutput(output, newNode->output);
+    }
+
+    template <typename ValueType>
+    void QuantizedMatrixMultiplyNode<ValueType>::Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function)
+    {
+        using namespace std::string_literals;
+        const auto plus = emitters::TypedOperator::add;
+        const auto times = emitters::TypedOperator::multiply;
+        const auto plusFloat = emitters::TypedOperator::addFloat;
+        const auto minusFloat = emitters::TypedOperator::subtractFloat;
+        const auto timesFloat = emitters::TypedOperator::multiplyFloat;
+
+        llvm::Value* pInput = compiler.EnsurePortEmitted(input);
+        llvm::Value* pOutput = compiler.EnsurePortEmitted(output);
+
+        // The weights are stored as bytes; the matrix multiply treats them as signed
+        auto& module = function.GetModule();
+        auto pWeights = module.ConstantArray("quantizedWeights_"s + GetInternalStateIdentifier(), std::vector<uint8_t>(_weights.begin(), _weights.end()));
+        auto pQuantizedInput = compiler.EnsureNodeBufferEmitted(*this, "quantizedInput", emitters::VariableType::Byte, _k * _n);
+
+        // Quantize the input, transposing it so that the k values that make up each column of the output are contiguous
+        auto byteType = function.GetEmitter().Type(emitters::VariableType::Byte);
+        auto inverseScale = function.Literal(static_cast<ValueType>(1.0 / _inputScale));
+        auto maxValue = function.Literal(static_cast<ValueType>(c_maxQuantizedValue));
+        auto minValue = function.Literal(static_cast<ValueType>(-c_maxQuantizedValue));
+        auto zero = function.Literal(static_cast<ValueType>(0));
+        auto half = function.Literal(static_cast<ValueType>(0.5));
+        auto pLoop = function.ForLoop();
+        pLoop.Begin(static_cast<int>(_k));
+        {
+            auto p = pLoop.LoadIterationVariable();
+            auto jLoop = function.ForLoop();
+            jLoop.Begin(static_cast<int>(_n));
+            {
+                auto j = jLoop.LoadIterationVariable();
+                auto value = function.Operator(timesFloat, function.ValueAt(pInput, function.Operator(plus, function.Operator(times, p, function.Literal(static_cast<int>(_n))), j)), inverseScale);
+                value = function.Select(function.Comparison(emitters::TypedComparison::lessThanFloat, value, minValue), minValue, value);
+                value = function.Select(function.Comparison(emitters::TypedComparison::greaterThanFloat, value, maxValue), maxValue, value);
+
+                // Round half away from zero (the conversion to an integer truncates)
+                auto isNegative = function.Comparison(emitters::TypedComparison::lessThanFloat, value, zero);
+                auto rounded = function.Select(isNegative, function.Operator(minusFloat, value, half), function.Operator(plusFloat, value, half));
+                auto quantizedIndex = function.Operator(plus, function.Operator(times, j, function.Literal(static_cast<int>(_k))), p);
+                function.SetValueAt(pQuantizedInput, quantizedIndex, function.GetEmitter().GetIRBuilder().CreateFPToSI(rounded, byteType));
+            }
+            jLoop.End();
+        }
+        pLoop.End();
+
+        function.CallInt8GEMM((int)_m, (int)_n, (int)_k, function.PointerOffset(pWeights, 0), (int)_k, function.PointerOffset(pQuantizedInput, 0), (int)_k, pOutput, (int)_n);
+    }
+
+    template <typename ValueType>
+    void QuantizedMatrixMultiplyNode<ValueType>::WriteToArchive(utilities::Archiver& archiver) const
+    {
+        Node::WriteToArchive(archiver);
+        archiver[defaultInputPortName] << _input;
+        archiver[defaultOutputPortName] << _output;
+        archiver["m"] << _m;
+        archiver["n"] << _n;
+        archiver["k"] << _k;
+        archiver["weights"] << std::vector<int>(_weights.begin(), _weights.end());
+        archiver["inputScale"] << _inputScale;
+    }
+
+    template <typename ValueType>
+    void QuantizedMatrixMultiplyNode<ValueType>::ReadFromArchive(utilities::Unarchiver& archiver)
+    {
+        Node::ReadFromArchive(archiver);
+        archiver[defaultInputPortName] >> _input;
+        archiver[defaultOutputPortName] >> _output;
+        archiver["m"] >> _m;
+        archiver["n"] >> _n;
+        archiver["k"] >> _k;
+        std::vector<int> weights;
+        archiver["weights"] >> weights;
+        _weights.assign(weights.begin(), weights.end());
+        archiver["inputScale"] >> _inputScale;
+    }
+
+    //
+    // DequantizeNode
+    //
+    template <typename ValueType>
+    DequantizeNode<ValueType>::DequantizeNode()
+        : CompilableNode({ &_input }, { &_output }), _input(this, {}, defaultInputPortName), _output(this, defaultOutputPortName, 0)
+    {
+    }
+
+    template <typename ValueType>
+    DequantizeNode<ValueType>::DequantizeNode(const model::PortElements<int>& input, const std::vector<ValueType>& rowScales)
+        : CompilableNode({ &_input }, { &_output }), _input(this, input, defaultInputPortName), _output(this, defaultOutputPortName, input.Size()), _rowScales(rowScales)
+    {
+        if (rowScales.empty() || input.Size() % rowScales.size() != 0)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "Input size must be a multiple of the number of row scales");
+        }
+    }
+
+    template <typename ValueType>
+    void DequantizeNode<ValueType>::Compute() const
+    {
+        auto inputValues = input.GetValue();
+        const auto columns = inputValues.size() / _rowScales.size();
+        std::vector<ValueType> outputValues(inputValues.size());
+        for (size_t index = 0; index < inputValues.size(); ++index)
+        {
+            outputValues[index] = static_cast<ValueType>(inputValues[index]) * _rowScales[index / columns];
+        }
+        _output.SetOutput(outputValues);
+    }
+
+    template <typename ValueType>
+    void DequantizeNode<ValueType>::Copy(model::ModelTransformer& transformer) const
+    {
+        auto newPortElements = transformer.TransformPortElements(_input.GetPortElements());
+        auto newNode = transformer.AddNode<DequantizeNode<ValueType>>(newPortElements, _rowScales);
+        transformer.MapNodeOutput(output, newNode->output);
+    }
+
+    template <typename ValueType>
+    void DequantizeNode<ValueType>::Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function)
+    {
+        using namespace std::string_literals;
+        const auto plus = emitters::TypedOperator::add;
+        const auto times = emitters::TypedOperator::multiply;
+        const auto timesFloat = emitters::TypedOperator::multiplyFloat;
+
+        llvm::Value* pInput = compiler.EnsurePortEmitted(input);
+        llvm::Value* pOutput = compiler.EnsurePortEmitted(output);
+        auto pScales = function.GetModule().ConstantArray("dequantizeScales_"s + GetInternalStateIdentifier(), _rowScales);
+
+        const auto columns = static_cast<int>(input.Size() / _rowScales.size());
+        auto rowLoop = function.ForLoop();
+        rowLoop.Begin(static_cast<int>(_rowScales.size()));
+        {
+            auto row = rowLoop.LoadIterationVariable();
+            auto scale = function.ValueAt(pScales, row);
+            auto rowOffset = function.Operator(times, row, function.Literal(columns));
+            auto columnLoop = function.ForLoop();
+            columnLoop.Begin(columns);
+            {
+                auto index = function.Operator(plus, rowOffset, columnLoop.LoadIterationVariable());
+                auto value = function.CastValue<int, ValueType>(function.ValueAt(pInput, index));
+                function.SetValueAt(pOutput, index, function.Operator(timesFloat, value, scale));
+            }
+            columnLoop.End();
+        }
+        rowLoop.End();
+    }
+
+    template <typename ValueType>
+    void DequantizeNode<ValueType>::WriteToArchive(utilities::Archiver& archiver) const
+    {
+        Node::WriteToArchive(archiver);
+        archiver[defaultInputPortName] << _input;
+        archiver[defaultOutputPortName] << _output;
+        archiver["rowScales"] << _rowScales;
+    }
+
+    template <typename ValueType>
+    void DequantizeNode<ValueType>::ReadFromArchive(utilities::Unarchiver& archiver)
+    {
+        Node::ReadFromArchive(archiver);
+        archiver[defaultInputPortName] >> _input;
+        archiver[defaultOutputPortName] >> _output;
+        archiver["rowScales"] >> _rowScales;
+    }
+
+    // Explicitly instantiate versions
+    template int8_t QuantizeValue<float>(float value, double scale);
+    template int8_t QuantizeValue<double>(double value, double scale);
+    template std::vector<int8_t> QuantizeMatrixRows<float>(const std::vector<float>& matrix, size_t rows, size_t columns, std::vector<double>& rowScales);
+    template std::vector<int8_t> QuantizeMatrixRows<double>(const std::vector<double>& matrix, size_t rows, size_t columns, std::vector<double>& rowScales);
+    template const model::OutputPort<float>& AddQuantizedMatrixMultiply<float>(model::ModelTransformer& transformer, const std::vector<float>& weights, size_t m, size_t k, const model::PortElements<float>& input, size_t n, double inputScale);
+    template const model::OutputPort<double>& AddQuantizedMatrixMultiply<double>(model::ModelTransformer& transformer, const std::vector<double>& weights, size_t m, size_t k, const model::PortElements<double>& input, size_t n, double inputScale);
+
+    template class QuantizedMatrixMultiplyNode<float>;
+    template class QuantizedMatrixMultiplyNode<double>;
+    template class DequantizeNode<float>;
+    template class DequantizeNode<double>;
+}
+}
@@ -13,6 +13,9 @@
 #include "ConstantNode.h"
 #include "MatrixVectorMultiplyNode.h"
 
+// emitters
+#include "IRMathFunctions.h"
+
 // utilities
 #include "Exception.h"
 
@@ -114,7 +117,6 @@ namespace nodes
     {
         const auto plusFloat = emitters::TypedOperator::addFloat;
         const auto divideFloat = emitters::TypedOperator::divideFloat;
-        auto expFunc = function.GetModule().GetRuntime().GetExpFunction<ValueType>();
 
         llvm::AllocaInst* sum = function.Variable(emitters::GetVariableType<ValueType>(), 1);
         function.SetValueAt(sum, 0, function.Literal<ValueType>(0.0));
@@ -125,7 +127,7 @@ namespace nodes
             auto i = forLoop.LoadIterationVariable();
             llvm::Value* inputValue = function.ValueAt(data, i);
 
-            auto expInput = function.Call(expFunc, { inputValue });
+            auto expInput = emitters::EmitExp(function, inputValue);
             auto addToSum = function.Operator(plusFloat, function.ValueAt(sum, 0), expInput);
             function.SetValueAt(sum, 0, addToSum);
             function.SetValueAt(data, i, expInput);
@@ -154,7 +156,7 @@ namespace nodes
 
         // Get LLVM references for all node inputs
         llvm::Value* input = compiler.EnsurePortEmitted(this->input);
-        llvm::Value* hiddenWeights = compiler.EnsurePortEmitted(this->hiddenWeights);
+        llvm::Value* hiddenWeights = EnsureWeightsEmitted(compiler, function, this->hiddenWeights);
         llvm::Value* hiddenBias = compiler.EnsurePortEmitted(this->hiddenBias);
 
         // Get LLVM reference for node output
@@ -10,6 +10,12 @@
 #include "BroadcastFunctionNode.h"
 #include "ConstantNode.h"
 
+// emitters
+#include "IRMathFunctions.h"
+
+// stl
+#include <algorithm>
+
 namespace ell
 {
 namespace nodes
@@ -65,7 +71,6 @@ namespace nodes
             {
                 auto valueType = emitters::GetVariableType<ValueType>();
                 _accumValueVar = function.Variable(valueType, "eulerSumAccumValue");
-                _expFunc = function.GetModule().GetRuntime().GetExpFunction<ValueType>();
                 Reset(function);
             }
 
@@ -79,7 +84,7 @@ namespace nodes
                 const auto plusFloat = emitters::TypedOperator::addFloat;
                 const auto minusFloat = emitters::TypedOperator::subtractFloat;
                 auto valueMinusMax = function.Operator(minusFloat, x, _maxValue);
-                auto eulerVal = function.Call(_expFunc, { valueMinusMax });
+                auto eulerVal = emitters::EmitExp(function, valueMinusMax);
                 function.OperationAndUpdate(_accumValueVar, plusFloat, eulerVal);
                 return eulerVal;
             }
@@ -90,7 +95,6 @@ namespace nodes
             }
 
         private:
-            llvm::Function* _expFunc;
             llvm::Value* _maxValue;
             llvm::Value* _accumValueVar;
         };
@@ -145,9 +149,15 @@ namespace nodes
         EmitComputeDimensionLoop(compiler, function, 0, this->GetInputMemoryLayout(), this->GetOutputMemoryLayout(), pInput, pOutput, prevInputDimensionOffset, prevOutputDimensionOffset, computeEuler);
         auto eulerSum = computeEuler.GetEulerSum(function);
 
-        // normalize output
-        NormalizeOutputFunction<ValueType> normalizeOutput(function, eulerSum);
-        EmitComputeDimensionLoop(compiler, function, 0, this->GetOutputMemoryLayout(), pOutput, prevOutputDimensionOffset, normalizeOutput);
+        // normalize output (the max and sum are reductions, but this pass is elementwise, so it can be split into tasks)
+        const auto& outputLayout = this->GetOutputMemoryLayout();
+        const auto& outputSize = outputLayout.GetActiveSize();
+        emitters::ParallelForOptions options;
+        options.iterationSize = static_cast<int>(outputLayout.NumEntries() / std::max(outputSize[0], 1));
+        function.ParallelFor(outputSize[0], options, { pOutput, eulerSum }, [this, &compiler, &outputLayout, prevOutputDimensionOffset](emitters::IRFunctionEmitter& function, llvm::Value* begin, llvm::Value* end, const std::vector<llvm::Value*>& capturedValues) {
+            NormalizeOutputFunction<ValueType> normalizeOutput(function, capturedValues[1]);
+            EmitComputeDimensionLoop(compiler, function, 0, begin, end, outputLayout, capturedValues[0], prevOutputDimensionOffset, normalizeOutput);
+        });
     }
 
     template <typename ValueType>
@@ -229,6 +239,8 @@ namespace nodes
     template <typename FunctionType>
     void SoftmaxLayerNode<ValueType>::EmitComputeDimensionLoop(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function,
                                                                size_t dimension,
+                                                               llvm::Value* begin,
+                                                               llvm::Value* end,
                                                                const model::PortMemoryLayout& inputLayout,
                                                                llvm::Value* pInput,
                                                                llvm::Value* prevInputDimensionOffset,
@@ -246,7 +258,7 @@ namespace nodes
         auto&& inputSize = inputLayout.GetActiveSize();
 
         auto loop = function.ForLoop();
-        loop.Begin(inputSize[dimension]);
+        loop.Begin(begin, end, function.Literal<int>(1));
         {
             auto loopIndex = loop.LoadIterationVariable();
 
@@ -271,7 +283,9 @@ namespace nodes
             if (dimension < numDimensions - 1)
             {
                 // Recursive call to emit nested loop
-                EmitComputeDimensionLoop(compiler, function, dimension + 1, inputLayout, pInput, thisInputDimensionOffset, f);
+                auto nextBegin = function.Literal<int>(0);
+                auto nextEnd = function.Literal<int>(inputSize[dimension + 1]);
+                EmitComputeDimensionLoop(compiler, function, dimension + 1, nextBegin, nextEnd, inputLayout, pInput, thisInputDimensionOffset, f);
             }
             else
             {
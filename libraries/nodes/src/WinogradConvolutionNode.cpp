@@ -0,0 +1,355 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     WinogradConvolutionNode.cpp (nodes)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "WinogradConvolutionNode.h"
+
+// utilities
+#include "Exception.h"
+
+// stl
+#include <algorithm>
+#include <vector>
+
+namespace ell
+{
+namespace nodes
+{
+    namespace
+    {
+        const auto plus = emitters::TypedOperator::add;
+        const auto times = emitters::TypedOperator::multiply;
+
+        const auto plusFloat = emitters::TypedOperator::addFloat;
+        const auto minusFloat = emitters::TypedOperator::subtractFloat;
+
+        // Each tile of the transformed input and output is 4x4, and produces a 2x2 tile of the output
+        const int tileSize = 4;
+        const int outputTileSize = 2;
+
+        int GetNumTiles(int outputSize)
+        {
+            return (outputSize + outputTileSize - 1) / outputTileSize;
+        }
+
+        //
+        // Functions to emit portions of IR
+        //
+
+        // Emits B^T d B for a 4x4 tile d (row-major)
+        std::vector<llvm::Value*> EmitInputTileTransform(emitters::IRFunctionEmitter& function, const std::vector<llvm::Value*>& d)
+        {
+            std::vector<llvm::Value*> t(tileSize * tileSize);
+            for (int column = 0; column < tileSize; ++column)
+            {
+                t[0 * tileSize + column] = function.Operator(minusFloat, d[0 * tileSize + column], d[2 * tileSize + column]);
+                t[1 * tileSize + column] = function.Operator(plusFloat, d[1 * tileSize + column], d[2 * tileSize + column]);
+                t[2 * tileSize + column] = function.Operator(minusFloat, d[2 * tileSize + column], d[1 * tileSize + column]);
+                t[3 * tileSize + column] = function.Operator(minusFloat, d[1 * tileSize + column], d[3 * tileSize + column]);
+            }
+
+            std::vector<llvm::Value*> v(tileSize * tileSize);
+            for (int row = 0; row < tileSize; ++row)
+            {
+                const auto r = row * tileSize;
+                v[r + 0] = function.Operator(minusFloat, t[r + 0], t[r + 2]);
+                v[r + 1] = function.Operator(plusFloat, t[r + 1], t[r + 2]);
+                v[r + 2] = function.Operator(minusFloat, t[r + 2], t[r + 1]);
+                v[r + 3] = function.Operator(minusFloat, t[r + 1], t[r + 3]);
+            }
+            return v;
+        }
+
+        // Emits A^T m A for a 4x4 tile m (row-major), returning the 2x2 output tile (row-major)
+        std::vector<llvm::Value*> EmitOutputTileTransform(emitters::IRFunctionEmitter& function, const std::vector<llvm::Value*>& m)
+        {
+            std::vector<llvm::Value*> s(outputTileSize * tileSize);
+            for (int column = 0; column < tileSize; ++column)
+            {
+                auto m0 = m[0 * tileSize + column];
+                auto m1 = m[1 * tileSize + column];
+                auto m2 = m[2 * tileSize + column];
+                auto m3 = m[3 * tileSize + column];
+                s[0 * tileSize + column] = function.Operator(plusFloat, function.Operator(plusFloat, m0, m1), m2);
+                s[1 * tileSize + column] = function.Operator(minusFloat, function.Operator(minusFloat, m1, m2), m3);
+            }
+
+            std::vector<llvm::Value*> y(outputTileSize * outputTileSize);
+            for (int row = 0; row < outputTileSize; ++row)
+            {
+                const auto r = row * tileSize;
+                y[row * outputTileSize + 0] = function.Operator(plusFloat, function.Operator(plusFloat, s[r + 0], s[r + 1]), s[r + 2]);
+                y[row * outputTileSize + 1] = function.Operator(minusFloat, function.Operator(minusFloat, s[r + 1], s[r + 2]), s[r + 3]);
+            }
+            return y;
+        }
+    } // end anonymous namespace
+
+    //
+    // WinogradConvolutionNode
+    //
+
+    template <typename ValueType>
+    WinogradConvolutionNode<ValueType>::WinogradConvolutionNode()
+        : CompilableNode({ &_input }, { &_output }), _input(this, {}, defaultInputPortName), _filterWeights(this, {}, filterWeightsPortName), _output(this, defaultOutputPortName, 0)
+    {
+    }
+
+    template <typename ValueType>
+    WinogradConvolutionNode<ValueType>::WinogradConvolutionNode(const model::PortElements<ValueType>& input, const model::PortMemoryLayout& inputMemoryLayout, const model::PortElements<ValueType>& filterWeights, const model::PortMemoryLayout& outputMemoryLayout, const predictors::neural::ConvolutionalParameters& convolutionalParameters)
+        : CompilableNode({ &_input, &_filterWeights }, { &_output }), _input(this, input, defaultInputPortName), _filterWeights(this, filterWeights, filterWeightsPortName), _output(this, defaultOutputPortName, outputMemoryLayout.GetMemorySize()), _inputMemoryLayout(inputMemoryLayout), _outputMemoryLayout(outputMemoryLayout), _convolutionalParameters(convolutionalParameters)
+    {
+        if (convolutionalParameters.receptiveField != 3 || convolutionalParameters.stride != 1)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "Winograd convolution requires 3x3 filters and a stride of 1");
+        }
+    }
+
+    template <typename ValueType>
+    void WinogradConvolutionNode<ValueType>::Copy(model::ModelTransformer& transformer) const
+    {
+        auto newInput = transformer.TransformPortElements(_input.GetPortElements());
+        auto newFilterWeights = transformer.TransformPortElements(_filterWeights.GetPortElements());
+        auto newNode = transformer.AddNode<WinogradConvolutionNode<ValueType>>(newInput, _inputMemoryLayout, newFilterWeights, _outputMemoryLayout, _convolutionalParameters);
+        transformer.MapNodeOutput(this->output, newNode->output);
+    }
+
+    template <typename ValueType>
+    void WinogradConvolutionNode<ValueType>::Compute() const
+    {
+        using Layer = predictors::neural::Layer<ValueType>;
+
+        auto&& inputLayout = this->GetInputMemoryLayout();
+        auto&& outputLayout = this->GetOutputMemoryLayout();
+        const size_t outputHeight = outputLayout.GetActiveSize(0);
+        const size_t outputWidth = outputLayout.GetActiveSize(1);
+        const size_t numFilters = outputLayout.GetActiveSize(2);
+
+        // The input port holds the padded input, which the convolution reads starting at (0, 0)
+        auto inputData = _input.GetValue();
+        typename Layer::ConstTensorReferenceType inputTensor(inputData.data(), math::TensorShape{ static_cast<size_t>(inputLayout.GetStride(0)), static_cast<size_t>(inputLayout.GetStride(1)), static_cast<size_t>(inputLayout.GetStride(2)) });
+        auto activeInput = inputTensor.GetSubTensor(0, 0, 0, inputTensor.NumRows(), inputTensor.NumColumns(), inputLayout.GetActiveSize(2));
+
+        typename Layer::TensorType result(outputHeight, outputWidth, numFilters);
+        predictors::neural::WinogradConvolve<ValueType>(activeInput, _filterWeights.GetValue(), result);
+
+        std::vector<ValueType> output(outputLayout.GetMemorySize());
+        for (size_t row = 0; row < outputHeight; ++row)
+        {
+            for (size_t column = 0; column < outputWidth; ++column)
+            {
+                for (size_t filter = 0; filter < numFilters; ++filter)
+                {
+                    output[outputLayout.GetEntryOffset({ static_cast<int>(row), static_cast<int>(column), static_cast<int>(filter) })] = result(row, column, filter);
+                }
+            }
+        }
+        _output.SetOutput(output);
+    }
+
+    template <typename ValueType>
+    bool WinogradConvolutionNode<ValueType>::CanReuseOutputMemory(const model::OutputPortBase& port) const
+    {
+        // The padding region of the output is only set when the memory is initialized
+        return _outputMemoryLayout.NumEntries() == _outputMemoryLayout.GetMemorySize();
+    }
+
+    template <typename ValueType>
+    void WinogradConvolutionNode<ValueType>::Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function)
+    {
+        // input is a (h+2p) x (w+2p) x d array, read starting at (0, 0)
+        llvm::Value* pInput = compiler.EnsurePortEmitted(this->input);
+
+        // transformed filters are 16 f x d matrices, one for each element of the 4x4 tile
+        llvm::Value* pFilters = compiler.EnsurePortEmitted(this->filterWeights);
+
+        // output is a h x w x f array, possibly with padding
+        llvm::Value* pOutput = compiler.EnsurePortEmitted(this->output, static_cast<ValueType>(0));
+
+        // Model parameters
+        auto&& inputLayout = this->GetInputMemoryLayout();
+        auto&& outputLayout = this->GetOutputMemoryLayout();
+        const int inputRows = inputLayout.GetStride(0);
+        const int inputColumns = inputLayout.GetStride(1);
+        const int inputChannelStride = inputLayout.GetStride(2);
+        const int numChannels = inputLayout.GetActiveSize(2);
+
+        const int outputHeight = outputLayout.GetActiveSize(0);
+        const int outputWidth = outputLayout.GetActiveSize(1);
+        const int numFilters = outputLayout.GetActiveSize(2);
+        const int outputColumnStride = outputLayout.GetStride(1);
+        const int outputChannelStride = outputLayout.GetStride(2);
+        const int outputRowOffset = outputLayout.GetOffset(0);
+        const int outputColumnOffset = outputLayout.GetOffset(1);
+        const int outputChannelOffset = outputLayout.GetOffset(2);
+
+        const int numTileRows = GetNumTiles(outputHeight);
+        const int numTileColumns = GetNumTiles(outputWidth);
+        const int numTiles = numTileRows * numTileColumns;
+
+        // When the output size is odd, the last tiles read past the edge of the input, so copy it into a
+        // zero-extended buffer first
+        const int tiledInputRows = numTileRows * outputTileSize + (tileSize - outputTileSize);
+        const int tiledInputColumns = numTileColumns * outputTileSize + (tileSize - outputTileSize);
+        llvm::Value* pTiledInput = pInput;
+        int tiledInputColumnStride = inputColumns;
+        int tiledInputChannelStride = inputChannelStride;
+        if (tiledInputRows > inputRows || tiledInputColumns > inputColumns)
+        {
+            pTiledInput = compiler.EnsureNodeBufferEmitted(*this, "tiledInput", emitters::GetVariableType<ValueType>(), tiledInputRows * tiledInputColumns * numChannels);
+            tiledInputColumnStride = tiledInputColumns;
+            tiledInputChannelStride = numChannels;
+
+            // The edge of the buffer is never written, so it stays zero (each node has a buffer of its own)
+            const int copyRows = std::min(inputRows, tiledInputRows);
+            const int copyColumns = std::min(inputColumns, tiledInputColumns);
+            auto rowLoop = function.ForLoop();
+            rowLoop.Begin(copyRows);
+            {
+                auto row = rowLoop.LoadIterationVariable();
+                auto columnLoop = function.ForLoop();
+                columnLoop.Begin(copyColumns);
+                {
+                    auto column = columnLoop.LoadIterationVariable();
+                    auto inputOffset = function.Operator(times, function.Operator(plus, function.Operator(times, row, function.Literal<int>(inputColumns)), column), function.Literal<int>(inputChannelStride));
+                    auto extendedOffset = function.Operator(times, function.Operator(plus, function.Operator(times, row, function.Literal<int>(tiledInputColumns)), column), function.Literal<int>(numChannels));
+                    function.MemoryCopy<ValueType>(pInput, inputOffset, pTiledInput, extendedOffset, function.Literal<int>(numChannels));
+                }
+                columnLoop.End();
+            }
+            rowLoop.End();
+        }
+
+        // Scratch memory for the transformed input (16 d x t matrices) and transformed output (16 f x t matrices)
+        auto pTransformedInput = compiler.EnsureNodeBufferEmitted(*this, "transformedInput", emitters::GetVariableType<ValueType>(), tileSize * tileSize * numChannels * numTiles);
+        auto pTransformedOutput = compiler.EnsureNodeBufferEmitted(*this, "transformedOutput", emitters::GetVariableType<ValueType>(), tileSize * tileSize * numFilters * numTiles);
+
+        // Transform the input tiles: V = B^T d B
+        const int tiledInputRowStride = tiledInputColumnStride * tiledInputChannelStride;
+        auto inputTileRowLoop = function.ForLoop();
+        inputTileRowLoop.Begin(numTileRows);
+        {
+            auto tileRow = inputTileRowLoop.LoadIterationVariable();
+            auto inputTileColumnLoop = function.ForLoop();
+            inputTileColumnLoop.Begin(numTileColumns);
+            {
+                auto tileColumn = inputTileColumnLoop.LoadIterationVariable();
+                auto tileIndex = function.Operator(plus, function.Operator(times, tileRow, function.Literal<int>(numTileColumns)), tileColumn);
+                auto tileRowOffset = function.Operator(times, tileRow, function.Literal<int>(outputTileSize * tiledInputRowStride));
+                auto tileColumnOffset = function.Operator(times, tileColumn, function.Literal<int>(outputTileSize * tiledInputChannelStride));
+                auto tileOffset = function.Operator(plus, tileRowOffset, tileColumnOffset);
+
+                auto channelLoop = function.ForLoop();
+                channelLoop.Begin(numChannels);
+                {
+                    auto channel = channelLoop.LoadIterationVariable();
+                    auto pTile = function.PointerOffset(pTiledInput, function.Operator(plus, tileOffset, channel));
+                    std::vector<llvm::Value*> d(tileSize * tileSize);
+                    for (int row = 0; row < tileSize; ++row)
+                    {
+                        for (int column = 0; column < tileSize; ++column)
+                        {
+                            d[row * tileSize + column] = function.ValueAt(pTile, function.Literal<int>(row * tiledInputRowStride + column * tiledInputChannelStride));
+                        }
+                    }
+
+                    auto v = EmitInputTileTransform(function, d);
+                    auto pTransformedTile = function.PointerOffset(pTransformedInput, function.Operator(plus, function.Operator(times, channel, function.Literal<int>(numTiles)), tileIndex));
+                    for (int element = 0; element < tileSize * tileSize; ++element)
+                    {
+                        function.SetValueAt(pTransformedTile, function.Literal<int>(element * numChannels * numTiles), v[element]);
+                    }
+                }
+                channelLoop.End();
+            }
+            inputTileColumnLoop.End();
+        }
+        inputTileRowLoop.End();
+
+        // Multiply by the transformed filters: M = U V, one GEMM for each element of the tile
+        for (int element = 0; element < tileSize * tileSize; ++element)
+        {
+            auto U = function.PointerOffset(pFilters, element * numFilters * numChannels);
+            auto V = function.PointerOffset(pTransformedInput, element * numChannels * numTiles);
+            auto M = function.PointerOffset(pTransformedOutput, element * numFilters * numTiles);
+            function.CallGEMM<ValueType>(false, false, numFilters, numTiles, numChannels, U, numChannels, V, numTiles, M, numTiles);
+        }
+
+        // Transform the output tiles: Y = A^T M A
+        auto outputTileRowLoop = function.ForLoop();
+        outputTileRowLoop.Begin(numTileRows);
+        {
+            auto tileRow = outputTileRowLoop.LoadIterationVariable();
+            auto outputTileColumnLoop = function.ForLoop();
+            outputTileColumnLoop.Begin(numTileColumns);
+            {
+                auto tileColumn = outputTileColumnLoop.LoadIterationVariable();
+                auto tileIndex = function.Operator(plus, function.Operator(times, tileRow, function.Literal<int>(numTileColumns)), tileColumn);
+                auto outputRow = function.Operator(times, tileRow, function.Literal<int>(outputTileSize));
+                auto outputColumn = function.Operator(times, tileColumn, function.Literal<int>(outputTileSize));
+
+                auto filterLoop = function.ForLoop();
+                filterLoop.Begin(numFilters);
+                {
+                    auto filter = filterLoop.LoadIterationVariable();
+                    auto pTransformedTile = function.PointerOffset(pTransformedOutput, function.Operator(plus, function.Operator(times, filter, function.Literal<int>(numTiles)), tileIndex));
+                    std::vector<llvm::Value*> m(tileSize * tileSize);
+                    for (int element = 0; element < tileSize * tileSize; ++element)
+                    {
+                        m[element] = function.ValueAt(pTransformedTile, function.Literal<int>(element * numFilters * numTiles));
+                    }
+
+                    auto y = EmitOutputTileTransform(function, m);
+                    auto filterOffset = function.Operator(plus, filter, function.Literal<int>(outputChannelOffset));
+                    for (int row = 0; row < outputTileSize; ++row)
+                    {
+                        auto currentRow = function.Operator(plus, outputRow, function.Literal<int>(row));
+                        for (int column = 0; column < outputTileSize; ++column)
+                        {
+                            auto currentColumn = function.Operator(plus, outputColumn, function.Literal<int>(column));
+                            auto paddedRow = function.Operator(plus, currentRow, function.Literal<int>(outputRowOffset));
+                            auto paddedColumn = function.Operator(plus, currentColumn, function.Literal<int>(outputColumnOffset));
+                            auto pixelOffset = function.Operator(plus, function.Operator(times, paddedRow, function.Literal<int>(outputColumnStride)), paddedColumn);
+                            auto outputIndex = function.Operator(plus, function.Operator(times, pixelOffset, function.Literal<int>(outputChannelStride)), filterOffset);
+
+                            // The last row and column of tiles only partially overlap the output when its size is odd
+                            const bool checkRow = row > 0 && outputHeight % outputTileSize != 0;
+                            const bool checkColumn = column > 0 && outputWidth % outputTileSize != 0;
+                            if (checkRow || checkColumn)
+                            {
+                                auto inBounds = checkRow ? function.Comparison(emitters::TypedComparison::lessThan, currentRow, function.Literal<int>(outputHeight)) : nullptr;
+                                if (checkColumn)
+                                {
+                                    auto columnInBounds = function.Comparison(emitters::TypedComparison::lessThan, currentColumn, function.Literal<int>(outputWidth));
+                                    inBounds = inBounds == nullptr ? columnInBounds : function.LogicalAnd(inBounds, columnInBounds);
+                                }
+                                auto ifEmitter = function.If();
+                                ifEmitter.If(inBounds);
+                                {
+                                    function.SetValueAt(pOutput, outputIndex, y[row * outputTileSize + column]);
+                                }
+                                ifEmitter.End();
+                            }
+                            else
+                            {
+                                function.SetValueAt(pOutput, outputIndex, y[row * outputTileSize + column]);
+                            }
+                        }
+                    }
+                }
+                filterLoop.End();
+            }
+            outputTileColumnLoop.End();
+        }
+        outputTileRowLoop.End();
+    }
+
+    // Explicit specializations
+    template class WinogradConvolutionNode<float>;
+    template class WinogradConvolutionNode<double>;
+} // nodes
+} // ell
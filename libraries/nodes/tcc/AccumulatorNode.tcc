@@ -48,9 +48,8 @@ namespace nodes
         static_assert(!std::is_same<ValueType, bool>(), "Cannot instantiate boolean accumulator nodes");
         assert(GetPortVariableType(input) == GetPortVariableType(output));
 
-        // Allocate a global variable to accumulate the input
-        emitters::Variable* pAccumulatorVar = function.GetModule().Variables().AddVariable<emitters::InitializedVectorVariable<ValueType>>(emitters::VariableScope::global, output.Size());
-        llvm::Value* accumulator = function.GetModule().EnsureEmitted(*pAccumulatorVar);
+        // Allocate a buffer to accumulate the input
+        llvm::Value* accumulator = compiler.EnsureNodeBufferEmitted(*this, "accumulator", emitters::GetVariableType<ValueType>(), output.Size());
 
         if (model::IsPureVector(input) && !compiler.GetCompilerParameters().unrollLoops)
         {
@@ -229,9 +229,16 @@ namespace nodes
         llvm::Value* pInput2 = compiler.EnsurePortEmitted(input2);
         llvm::Value* pResult = compiler.EnsurePortEmitted(output);
 
-        auto count = input1.Size();
-        function.VectorOperator(emitters::GetOperator<ValueType>(GetOperation()), count, pInput1, pInput2, [&pResult, &function](llvm::Value* i, llvm::Value* pValue) {
-            function.SetValueAt(pResult, i, pValue);
+        auto count = static_cast<int>(input1.Size());
+        auto operation = emitters::GetOperator<ValueType>(GetOperation());
+        function.ParallelFor(count, {}, { pInput1, pInput2, pResult }, [operation](emitters::IRFunctionEmitter& function, llvm::Value* begin, llvm::Value* end, const std::vector<llvm::Value*>& capturedValues) {
+            auto pInput1 = capturedValues[0];
+            auto pInput2 = capturedValues[1];
+            auto pResult = capturedValues[2];
+            function.For(begin, end, [pInput1, pInput2, pResult, operation](emitters::IRFunctionEmitter& function, llvm::Value* i) {
+                llvm::Value* pOpResult = function.Operator(operation, function.ValueAt(pInput1, i), function.ValueAt(pInput2, i));
+                function.SetValueAt(pResult, i, pOpResult);
+            });
         });
     }
 
@@ -189,61 +189,6 @@ namespace nodes
         }
     }
 
-    // wrapper around EmitComputeDimensionLoop for use by parallel tasks
-    template <typename ValueType, typename FunctionType>
-    emitters::IRFunctionEmitter BroadcastFunctionNode<ValueType, FunctionType>::GetTaskFunction(model::IRMapCompiler& compiler,
-                                                                                                emitters::IRFunctionEmitter& function,
-                                                                                                const emitters::LLVMTypeList& portTypes) const
-    {
-        auto& module = function.GetModule();
-        auto& emitter = module.GetIREmitter();
-        auto& context = module.GetLLVMContext();
-        auto int32Type = emitter.Type(emitters::VariableType::Int32);
-        auto voidType = llvm::Type::getVoidTy(context);
-
-        // ASSUME dimension == 0 --- we're only parallelizing on the outermost loop
-        int dimension = 0;
-        llvm::Value* prevInputDimensionOffset = nullptr;
-        llvm::Value* prevOutputDimensionOffset = nullptr;
-
-        emitters::LLVMTypeList argTypes = portTypes;
-        // int numValuePorts = 2 + NumSecondaryInputs(); // primary input, secondary inputs, output
-        // argTypes.insert(argTypes.end(), numValuePorts, valuePtrType);
-        argTypes.insert(argTypes.end(), 2, int32Type); // begin, end
-
-        auto taskFunction = function.GetModule().BeginFunction(utilities::to_string(GetId()) + "_task", voidType, argTypes);
-        {
-            // get stuff from arguments
-            auto arguments = taskFunction.Arguments().begin();
-            auto primaryInput = &(*arguments++);
-            std::vector<llvm::Value*> secondaryInputs;
-            std::vector<llvm::Value*> secondaryValues;
-            for (int index = 0; index < NumSecondaryInputs(); ++index)
-            {
-                auto secondaryInput = &(*arguments++);
-                // if we really have an input, push it, else push a nullptr (note: we know this at compile-time)
-                if (IsSecondaryInputPresent(index))
-                {
-                    secondaryInputs.push_back(secondaryInput);
-                }
-                else
-                {
-                    secondaryInputs.push_back(nullptr);
-                }
-                secondaryValues.push_back(nullptr);
-            }
-            auto output = &(*arguments++);
-            auto begin = &(*arguments++);
-            auto end = &(*arguments++);
-
-            EmitComputeDimensionLoop(compiler, taskFunction, dimension, begin, end, primaryInput, secondaryInputs, output, prevInputDimensionOffset, prevOutputDimensionOffset, secondaryValues);
-            taskFunction.Return();
-        }
-        function.GetModule().EndFunction();
-
-        return taskFunction;
-    }
-
     // Note: secondaryValues is passed by non-const reference to avoid copies. It doesn't function as an output parameter.
     template <typename ValueType, typename FunctionType>
     void BroadcastFunctionNode<ValueType, FunctionType>::EmitComputeDimensionLoop(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function,
@@ -364,10 +309,22 @@ namespace nodes
     }
 
     template <typename ValueType, typename FunctionType>
-    void BroadcastFunctionNode<ValueType, FunctionType>::Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function)
+    bool BroadcastFunctionNode<ValueType, FunctionType>::CanReuseOutputMemory(const model::OutputPortBase& port) const
     {
-        const auto& compilerSettings = compiler.GetCompilerParameters();
+        // The padding region of the output isn't written by the compiled code, so it must keep its initial value
+        return _outputLayout.NumEntries() == _outputLayout.GetMemorySize();
+    }
 
+    template <typename ValueType, typename FunctionType>
+    const model::InputPortBase* BroadcastFunctionNode<ValueType, FunctionType>::GetInPlaceInputPort(const model::OutputPortBase& port) const
+    {
+        // Each output entry depends only on the primary input entry at the same location
+        return model::PortMemoryLayoutsEqual(_inputLayout, _outputLayout) ? &GetPrimaryInput() : nullptr;
+    }
+
+    template <typename ValueType, typename FunctionType>
+    void BroadcastFunctionNode<ValueType, FunctionType>::Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function)
+    {
         auto& module = function.GetModule();
         auto& emitter = module.GetIREmitter();
         auto valueType = emitter.Type(emitters::GetVariableType<ValueType>());
@@ -400,61 +357,15 @@ namespace nodes
         llvm::Value* prevInputDimensionOffset = nullptr;
         llvm::Value* prevOutputDimensionOffset = nullptr;
 
-        bool allSecondaryInputsValid = true;
-        for (int index = 0; index < NumSecondaryInputs(); ++index)
-        {
-            if (!IsSecondaryInputPresent(index))
-            {
-                allSecondaryInputsValid = false;
-            }
-        }
-
-        const int minimumTaskSize = 4000;
-        if (compilerSettings.parallelize && allSecondaryInputsValid && primaryInputSize > 2 * minimumTaskSize)
-        {
-            // computes ceil(a/b)
-            auto CeilDiv = [](int a, int b) {
-                return (a - 1) / b + 1;
-            };
-
-            // TODO: fix up logic for deciding how many tasks to use.
-            //   want to specify minimum amount of work per task, and create fewer tasks
-            //   if we don't have enough work.
-            auto numOuterIterations = inputSize[0];
-            const int numDesiredTasks = compilerSettings.maxThreads;
-            int taskSize = std::max(CeilDiv(primaryInputSize, numDesiredTasks), minimumTaskSize);
-            const int numTasks = std::min(CeilDiv(primaryInputSize, taskSize), compilerSettings.maxThreads);
-            taskSize = CeilDiv(numOuterIterations, numTasks);
-
-            // Ugly type-getting code to get around the type of the emitted port variables being different depending
-            // on whether the node is inlined (or something).
-            emitters::LLVMTypeList taskFunctionArgTypes{ pPrimaryInput->getType() };
-            for (auto& secondaryInput : secondaryInputs)
-            {
-                taskFunctionArgTypes.push_back(secondaryInput->getType());
-            }
-            taskFunctionArgTypes.push_back(pOutput->getType());
-
-            auto taskFunction = this->GetTaskFunction(compiler, function, taskFunctionArgTypes);
-            std::vector<std::vector<llvm::Value*>> taskArgs;
-            for (int taskIndex = 0; taskIndex < numTasks; ++taskIndex)
-            {
-                auto begin = function.Literal<int>(taskIndex * taskSize);
-                auto end = function.Literal<int>(std::min((taskIndex + 1) * taskSize, numOuterIterations));
-
-                std::vector<llvm::Value*> args{ pPrimaryInput };
-                args.insert(args.end(), secondaryInputs.begin(), secondaryInputs.end());
-                args.insert(args.end(), { pOutput, begin, end });
-            }
-            auto tasks = function.StartTasks(taskFunction, taskArgs);
-            tasks.WaitAll(function);
-        }
-        else
-        {
-            auto begin = function.Literal<int>(0);
-            auto end = function.Literal<int>(inputSize[0]);
-            EmitComputeDimensionLoop(compiler, function, 0, begin, end, pPrimaryInput, secondaryInputs, pOutput, prevInputDimensionOffset, prevOutputDimensionOffset, secondaryValues);
-        }
+        // Split the outermost loop into tasks
+        std::vector<llvm::Value*> capturedValues{ pPrimaryInput, pOutput };
+        capturedValues.insert(capturedValues.end(), secondaryInputs.begin(), secondaryInputs.end());
+        emitters::ParallelForOptions options;
+        options.iterationSize = static_cast<int>(primaryInputSize / std::max(inputSize[0], 1));
+        function.ParallelFor(inputSize[0], options, capturedValues, [this, &compiler, prevInputDimensionOffset, prevOutputDimensionOffset, secondaryValues](emitters::IRFunctionEmitter& function, llvm::Value* begin, llvm::Value* end, const std::vector<llvm::Value*>& capturedValues) mutable {
+            std::vector<llvm::Value*> taskSecondaryInputs(capturedValues.begin() + 2, capturedValues.end());
+            EmitComputeDimensionLoop(compiler, function, 0, begin, end, capturedValues[0], taskSecondaryInputs, capturedValues[1], prevInputDimensionOffset, prevOutputDimensionOffset, secondaryValues);
+        });
     }
 
     template <typename ValueType, typename FunctionType>
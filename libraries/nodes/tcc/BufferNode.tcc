@@ -30,7 +30,7 @@ namespace nodes
         auto offset = _samples.size() - inputSize;
 
         // Copy samples forward to make room for new samples
-        std::copy_n(_samples.begin() + offset, inputSize, _samples.begin());
+        std::copy(_samples.begin() + inputSize, _samples.end(), _samples.begin());
 
         // Copy input samples to tail
         for (size_t index = 0; index < inputSize; ++index)
@@ -48,27 +48,89 @@ namespace nodes
         transformer.MapNodeOutput(output, newNode->output);
     }
 
+    template <typename ValueType>
+    bool BufferNode<ValueType>::IsWindowReadInPlace() const
+    {
+        const auto& dependents = GetDependentNodes();
+        if (dependents.empty())
+        {
+            return false;
+        }
+
+        for (auto node : dependents)
+        {
+            auto reader = dynamic_cast<const BufferWindowReader*>(node);
+            if (reader == nullptr)
+            {
+                return false;
+            }
+
+            const auto& elements = reader->GetWindowInput().GetInputElements();
+            if (!elements.IsFullPortOutput() || elements.GetRanges()[0].ReferencedPort() != &output)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    template <typename ValueType>
+    llvm::Value* BufferNode<ValueType>::GetRingBuffer(model::IRMapCompiler& compiler) const
+    {
+        // Two copies of the window, back to back
+        return compiler.EnsureNodeBufferEmitted(*this, "ringBuffer", emitters::GetVariableType<ValueType>(), 2 * _windowSize);
+    }
+
+    template <typename ValueType>
+    llvm::Value* BufferNode<ValueType>::GetRingBufferHead(model::IRMapCompiler& compiler) const
+    {
+        return compiler.EnsureNodeBufferEmitted(*this, "ringBufferHead", emitters::VariableType::Int32, 1);
+    }
+
+    template <typename ValueType>
+    llvm::Value* BufferNode<ValueType>::EmitWindowPointer(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function) const
+    {
+        auto head = function.Load(GetRingBufferHead(compiler));
+        return function.PointerOffset(GetRingBuffer(compiler), head);
+    }
+
     template <typename ValueType>
     void BufferNode<ValueType>::Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function)
     {
-        int inputSize = input.Size();
-        size_t windowSize = this->GetWindowSize();
-        auto offset = windowSize - inputSize;
+        const int inputSize = input.Size();
+        const int windowSize = this->GetWindowSize();
+        if (inputSize > windowSize)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "BufferNode input must not be larger than its window");
+        }
 
         llvm::Value* pInput = compiler.EnsurePortEmitted(input);
-        auto bufferVar = function.GetModule().Variables().AddVectorVariable<ValueType>(emitters::VariableScope::global, windowSize);
-        function.GetModule().AllocateVariable(*bufferVar);
-        llvm::Value* buffer = function.GetModule().EnsureEmitted(*bufferVar);
+        auto buffer = GetRingBuffer(compiler);
+        auto headVar = GetRingBufferHead(compiler);
+        auto head = function.Load(headVar);
 
-        // Copy samples forward to make room for new samples
-        function.MemoryMove<ValueType>(buffer, offset, 0, inputSize);
+        // Overwrite the oldest samples (starting at the head) with the new ones, in both copies of the window
+        function.For(inputSize, [pInput, buffer, head, windowSize](emitters::IRFunctionEmitter& function, llvm::Value* index) {
+            auto position = function.Operator(emitters::TypedOperator::add, head, index);
+            auto wrapped = function.Operator(emitters::TypedOperator::subtract, position, function.Literal<int>(windowSize));
+            position = function.Select(function.Comparison(emitters::TypedComparison::lessThan, position, function.Literal<int>(windowSize)), position, wrapped);
+            auto value = function.ValueAt(pInput, index);
+            function.SetValueAt(buffer, position, value);
+            function.SetValueAt(buffer, function.Operator(emitters::TypedOperator::add, position, function.Literal<int>(windowSize)), value);
+        });
 
-        // Copy input samples to tail
-        function.MemoryCopy<ValueType>(pInput, 0, buffer, offset, inputSize);
+        // Advance the head past the new samples, so the window (which starts at the head) ends with them
+        auto newHead = function.Operator(emitters::TypedOperator::add, head, function.Literal<int>(inputSize));
+        auto wrappedHead = function.Operator(emitters::TypedOperator::subtract, newHead, function.Literal<int>(windowSize));
+        newHead = function.Select(function.Comparison(emitters::TypedComparison::lessThan, newHead, function.Literal<int>(windowSize)), newHead, wrappedHead);
+        function.Store(headVar, newHead);
 
-        // Copy to output
-        llvm::Value* pOutput = compiler.EnsurePortEmitted(output);
-        function.MemoryCopy<ValueType>(buffer, 0, pOutput, 0, windowSize);
+        // If some reader can't read the window in place, copy it to the output
+        if (!IsWindowReadInPlace())
+        {
+            llvm::Value* pOutput = compiler.EnsurePortEmitted(output);
+            function.MemoryCopy<ValueType>(function.PointerOffset(buffer, newHead), pOutput, windowSize);
+        }
     }
 
     template <typename ValueType>
@@ -86,9 +148,33 @@ namespace nodes
         archiver[defaultInputPortName] >> _input;
         archiver["windowSize"] >> _windowSize;
 
-        _samples.resize(_windowSize);
         _samples.clear();
+        _samples.resize(_windowSize);
         _output.SetSize(_windowSize);
     }
+
+    template <typename ValueType>
+    bool IsBufferWindowReadInPlace(const model::InputPort<ValueType>& input)
+    {
+        const auto& elements = input.GetInputElements();
+        if (!elements.IsFullPortOutput())
+        {
+            return false;
+        }
+
+        auto bufferNode = dynamic_cast<const BufferNode<ValueType>*>(elements.GetRanges()[0].ReferencedPort()->GetNode());
+        return bufferNode != nullptr && bufferNode->IsWindowReadInPlace();
+    }
+
+    template <typename ValueType>
+    llvm::Value* EnsureBufferWindowEmitted(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function, const model::InputPort<ValueType>& input)
+    {
+        if (IsBufferWindowReadInPlace(input))
+        {
+            auto bufferNode = static_cast<const BufferNode<ValueType>*>(input.GetInputElements().GetRanges()[0].ReferencedPort()->GetNode());
+            return bufferNode->EmitWindowPointer(compiler, function);
+        }
+        return compiler.EnsurePortEmitted(input);
+    }
 }
 }
@@ -71,5 +71,24 @@ namespace nodes
         archiver["values"] >> _values;
         _output.SetSize(_values.size());
     }
+
+    template <typename ValueType>
+    llvm::Value* EnsureWeightsEmitted(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function, const model::InputPort<ValueType>& weights)
+    {
+        auto& module = function.GetModule();
+        auto weightsElements = weights.GetPortElements();
+        if (std::is_same<ValueType, float>::value && module.GetCompilerParameters().useHalfPrecisionWeights && weightsElements.IsFullPortOutput())
+        {
+            auto weightsNode = dynamic_cast<const ConstantNode<ValueType>*>(weightsElements.GetRanges()[0].ReferencedPort()->GetNode());
+            if (weightsNode != nullptr)
+            {
+                // The float values are never emitted, unless something else uses them
+                const auto& values = weightsNode->GetValues();
+                auto halfWeights = module.ConstantArray("halfWeights_" + model::IdString(*weightsNode), emitters::FloatToHalf(std::vector<float>(values.begin(), values.end())));
+                return function.PointerOffset(halfWeights, 0);
+            }
+        }
+        return compiler.EnsurePortEmitted(weights);
+    }
 }
 }
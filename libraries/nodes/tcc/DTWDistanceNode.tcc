@@ -153,18 +153,17 @@ namespace nodes
         assert(inputType == GetPortVariableType(output));
         VerifyIsScalar(output);
 
-        llvm::Value* pInput = compiler.EnsurePortEmitted(input);
+        llvm::Value* pInput = EnsureBufferWindowEmitted(compiler, function, input);
         llvm::Value* pResult = compiler.EnsurePortEmitted(output);
 
         // The prototype (constant)
         emitters::Variable* pVarPrototype = function.GetModule().Variables().AddVariable<emitters::LiteralVectorVariable<ValueType>>(GetPrototypeData());
 
-        // Global variables for the dynamic programming memory
-        emitters::Variable* pVarD = function.GetModule().Variables().AddVariable<emitters::InitializedVectorVariable<ValueType>>(emitters::VariableScope::global, _prototypeLength + 1);
+        // Buffer for the dynamic programming memory
+        llvm::Value* pD = compiler.EnsureNodeBufferEmitted(*this, "d", emitters::GetVariableType<ValueType>(), _prototypeLength + 1);
 
         // get global state vars
         llvm::Value* pPrototypeVector = function.GetModule().EnsureEmitted(*pVarPrototype);
-        llvm::Value* pD = function.GetModule().EnsureEmitted(*pVarD);
 
         // incorrect usage of function.Variable --- should use IRModuleEmitter::EmitX(variable)
         llvm::Value* dist = function.Variable(inputType, "dist");
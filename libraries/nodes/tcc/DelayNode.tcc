@@ -54,18 +54,26 @@ namespace nodes
         size_t bufferSize = sampleSize * windowSize;
 
         //
-        // Delay nodes are always long lived - either globals or heap. Currently, we use globals
+        // Delay nodes are always long lived, so the delay line is a node buffer (a global, or part of the workspace)
         // Each sample chunk is of size == sampleSize. The number of chunks we hold onto == windowSize
-        // We need two buffers - one for the entire lot, one for the "last" chunk forwarded to the next operator
         //
-        emitters::Variable* delayLineVar = function.GetModule().Variables().AddVariable<emitters::InitializedVectorVariable<ValueType>>(emitters::VariableScope::global, bufferSize);
-        llvm::Value* delayLine = function.GetModule().EnsureEmitted(*delayLineVar);
+        llvm::Value* delayLine = compiler.EnsureNodeBufferEmitted(*this, "delayLine", emitters::GetVariableType<ValueType>(), bufferSize);
 
         //
-        // We implement a delay as a Shift Register
+        // We implement a delay as a circular buffer of chunks. The head is the slot of the oldest chunk: it's forwarded
+        // to the next operator, and then replaced with the new chunk. Only one chunk is copied in and one out per step.
         //
+        auto headVar = compiler.EnsureNodeBufferEmitted(*this, "delayHead", emitters::VariableType::Int32, 1);
+        auto head = function.Load(headVar);
+        auto slot = function.PointerOffset(delayLine, function.Operator(emitters::TypedOperator::multiply, head, function.Literal<int>(static_cast<int>(sampleSize))));
+
         llvm::Value* inputBuffer = compiler.EnsurePortEmitted(input);
-        function.ShiftAndUpdate<ValueType>(delayLine, bufferSize, sampleSize, inputBuffer, result);
+        function.MemoryCopy<ValueType>(slot, result, sampleSize);
+        function.MemoryCopy<ValueType>(inputBuffer, slot, sampleSize);
+
+        auto newHead = function.Operator(emitters::TypedOperator::add, head, function.Literal<int>(1));
+        newHead = function.Select(function.Comparison(emitters::TypedComparison::lessThan, newHead, function.Literal<int>(static_cast<int>(windowSize))), newHead, function.Literal<int>(0));
+        function.Store(headVar, newHead);
     }
 
     template <typename ValueType>
@@ -14,23 +14,36 @@
 #include "SingleElementThresholdNode.h"
 #include "SumNode.h"
 
+// utilities
+#include "Exception.h"
+
 // stl
 #include <memory>
+#include <type_traits>
 #include <vector>
 
 namespace ell
 {
 namespace nodes
 {
+    namespace detail
+    {
+        template <typename ForestType>
+        void CompileForest(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function, const ForestType& forest, const std::string& stateId, const model::InputPort<double>& input, const model::OutputPort<double>& output, const model::OutputPort<double>& treeOutputs, const model::OutputPort<bool>& edgeIndicatorVector)
+        {
+            throw utilities::LogicException(utilities::LogicExceptionErrors::notImplemented, "Only forests with single-element threshold splits and constant edge predictors can be compiled");
+        }
+    }
+
     template <typename SplitRuleType, typename EdgePredictorType>
     ForestPredictorNode<SplitRuleType, EdgePredictorType>::ForestPredictorNode(const model::PortElements<double>& input, const predictors::ForestPredictor<SplitRuleType, EdgePredictorType>& forest)
-        : Node({ &_input }, { &_output, &_treeOutputs, &_edgeIndicatorVector }), _input(this, input, defaultInputPortName), _output(this, defaultOutputPortName, 1), _treeOutputs(this, treeOutputsPortName, forest.NumTrees()), _edgeIndicatorVector(this, edgeIndicatorVectorPortName, forest.NumEdges()), _forest(forest)
+        : CompilableNode({ &_input }, { &_output, &_treeOutputs, &_edgeIndicatorVector }), _input(this, input, defaultInputPortName), _output(this, defaultOutputPortName, 1), _treeOutputs(this, treeOutputsPortName, forest.NumTrees()), _edgeIndicatorVector(this, edgeIndicatorVectorPortName, forest.NumEdges()), _forest(forest)
     {
     }
 
     template <typename SplitRuleType, typename EdgePredictorType>
     ForestPredictorNode<SplitRuleType, EdgePredictorType>::ForestPredictorNode()
-        : Node({ &_input }, { &_output, &_treeOutputs, &_edgeIndicatorVector }), _input(this, {}, defaultInputPortName), _output(this, defaultOutputPortName, 1), _treeOutputs(this, treeOutputsPortName, 0), _edgeIndicatorVector(this, edgeIndicatorVectorPortName, 0)
+        : CompilableNode({ &_input }, { &_output, &_treeOutputs, &_edgeIndicatorVector }), _input(this, {}, defaultInputPortName), _output(this, defaultOutputPortName, 1), _treeOutputs(this, treeOutputsPortName, 0), _edgeIndicatorVector(this, edgeIndicatorVectorPortName, 0)
     {
     }
 
@@ -165,6 +178,22 @@ namespace nodes
         return true;
     }
 
+    template <typename SplitRuleType, typename EdgePredictorType>
+    bool ForestPredictorNode<SplitRuleType, EdgePredictorType>::IsCompilable(const model::MapCompiler* compiler) const
+    {
+        if (!std::is_same<ForestPredictor, predictors::SimpleForestPredictor>::value || compiler == nullptr)
+        {
+            return false;
+        }
+        return compiler->GetMapCompilerParameters().forestEvaluation != model::ForestEvaluation::refine;
+    }
+
+    template <typename SplitRuleType, typename EdgePredictorType>
+    void ForestPredictorNode<SplitRuleType, EdgePredictorType>::Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function)
+    {
+        detail::CompileForest(compiler, function, _forest, GetInternalStateIdentifier(), input, output, treeOutputs, edgeIndicatorVector);
+    }
+
     template <typename SplitRuleType, typename EdgePredictorType>
     void ForestPredictorNode<SplitRuleType, EdgePredictorType>::Compute() const
     {
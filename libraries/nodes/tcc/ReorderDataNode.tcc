@@ -135,6 +135,13 @@ namespace nodes
         _output.SetOutput(output);
     }
 
+    template <typename ValueType>
+    bool ReorderDataNode<ValueType>::CanReuseOutputMemory(const model::OutputPortBase& port) const
+    {
+        // The padding region of the output is only set when the memory is initialized
+        return _outputMemoryLayout.NumEntries() == _outputMemoryLayout.GetMemorySize();
+    }
+
     template <typename ValueType>
     void ReorderDataNode<ValueType>::Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function)
     {
@@ -145,31 +152,37 @@ namespace nodes
         int outputSize = _outputMemoryLayout.GetMemorySize();
         UNUSED(outputSize);
 
-        auto xLoop = function.ForLoop();
-        xLoop.Begin(_outputMemoryLayout.GetActiveSize(0));
-        {
-            llvm::Value* x = xLoop.LoadIterationVariable();
-
-            auto yLoop = function.ForLoop();
-            yLoop.Begin(_outputMemoryLayout.GetActiveSize(1));
+        emitters::ParallelForOptions options;
+        options.iterationSize = _outputMemoryLayout.GetActiveSize(1) * _outputMemoryLayout.GetActiveSize(2);
+        function.ParallelFor(_outputMemoryLayout.GetActiveSize(0), options, { pInput, pOutput }, [this](emitters::IRFunctionEmitter& function, llvm::Value* begin, llvm::Value* end, const std::vector<llvm::Value*>& capturedValues) {
+            auto pInput = capturedValues[0];
+            auto pOutput = capturedValues[1];
+            auto xLoop = function.ForLoop();
+            xLoop.Begin(begin, end, function.Literal<int>(1));
             {
-                llvm::Value* y = yLoop.LoadIterationVariable();
+                llvm::Value* x = xLoop.LoadIterationVariable();
 
-                auto zLoop = function.ForLoop();
-                zLoop.Begin(_outputMemoryLayout.GetActiveSize(2));
+                auto yLoop = function.ForLoop();
+                yLoop.Begin(_outputMemoryLayout.GetActiveSize(1));
                 {
-                    llvm::Value* z = zLoop.LoadIterationVariable();
-                    auto inputLocation = ReorderOutputToInputLocation({ x, y, z });
-                    auto inputIndex = _inputMemoryLayout.EmitGetEntryOffset(function, inputLocation);
-                    auto outputIndex = _outputMemoryLayout.EmitGetEntryOffset(function, { x, y, z });
-                    llvm::Value* value = function.ValueAt(pInput, inputIndex);
-                    function.SetValueAt(pOutput, outputIndex, value);
+                    llvm::Value* y = yLoop.LoadIterationVariable();
+
+                    auto zLoop = function.ForLoop();
+                    zLoop.Begin(_outputMemoryLayout.GetActiveSize(2));
+                    {
+                        llvm::Value* z = zLoop.LoadIterationVariable();
+                        auto inputLocation = ReorderOutputToInputLocation({ x, y, z });
+                        auto inputIndex = _inputMemoryLayout.EmitGetEntryOffset(function, inputLocation);
+                        auto outputIndex = _outputMemoryLayout.EmitGetEntryOffset(function, { x, y, z });
+                        llvm::Value* value = function.ValueAt(pInput, inputIndex);
+                        function.SetValueAt(pOutput, outputIndex, value);
+                    }
+                    zLoop.End();
                 }
-                zLoop.End();
+                yLoop.End();
             }
-            yLoop.End();
-        }
-        xLoop.End();
+            xLoop.End();
+        });
     }
 
     template <typename ValueType>
@@ -55,6 +55,12 @@ namespace nodes
     template <typename ValueType>
     void SourceNode<ValueType>::Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function)
     {
+        if (compiler.GetMapCompilerParameters().reentrant)
+        {
+            // The source callback is shared by every caller, so its buffered sample can't be per-caller state
+            throw emitters::EmitterException(emitters::EmitterError::notSupported, "A map with a SourceNode can't be compiled as reentrant");
+        }
+
         llvm::Value* pInput = compiler.EnsurePortEmitted(input);
         compiler.EnsurePortEmitted(output);
 
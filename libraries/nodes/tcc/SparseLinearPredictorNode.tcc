@@ -0,0 +1,137 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     SparseLinearPredictorNode.tcc (nodes)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// emitters
+#include "EmitterTypes.h"
+#include "IRLocalValue.h"
+
+// utilities
+#include "Exception.h"
+
+// stl
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace ell
+{
+namespace nodes
+{
+    template <typename ElementType>
+    SparseLinearPredictorNode<ElementType>::SparseLinearPredictorNode()
+        : CompilableNode({ &_input }, { &_output }), _input(this, {}, defaultInputPortName), _output(this, defaultOutputPortName, 1)
+    {
+    }
+
+    template <typename ElementType>
+    SparseLinearPredictorNode<ElementType>::SparseLinearPredictorNode(const model::PortElements<ElementType>& input, const LinearPredictorType& predictor)
+        : CompilableNode({ &_input }, { &_output }), _input(this, input, defaultInputPortName), _output(this, defaultOutputPortName, 1), _predictor(predictor)
+    {
+        CheckInputSize();
+        CheckPredictorSize();
+    }
+
+    template <typename ElementType>
+    void SparseLinearPredictorNode<ElementType>::CheckInputSize() const
+    {
+        if (_input.Size() % 2 != 0)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::sizeMismatch, "SparseLinearPredictorNode input must hold (index, value) pairs");
+        }
+    }
+
+    template <typename ElementType>
+    void SparseLinearPredictorNode<ElementType>::CheckPredictorSize() const
+    {
+        // Every integer up to 2^digits is exactly representable, so all the weights' indices are exact
+        if (_predictor.Size() > (size_t(1) << std::numeric_limits<ElementType>::digits))
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "SparseLinearPredictorNode element type can't represent all the predictor's indices exactly");
+        }
+
+        // The compiled node converts indices to 32-bit ints, so larger indices would wrap
+        if (_predictor.Size() > static_cast<size_t>(std::numeric_limits<int32_t>::max()))
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "SparseLinearPredictorNode predictor has more weights than a 32-bit index can address");
+        }
+    }
+
+    template <typename ElementType>
+    void SparseLinearPredictorNode<ElementType>::Compute() const
+    {
+        const auto& weights = _predictor.GetWeights();
+        const auto numWeights = static_cast<ElementType>(_predictor.Size());
+        auto result = _predictor.GetBias();
+        for (size_t pairIndex = 0; pairIndex < GetMaxNonZeros(); ++pairIndex)
+        {
+            auto index = _input[2 * pairIndex];
+            if (index >= 0 && index < numWeights)
+            {
+                result += weights[static_cast<size_t>(index)] * _input[2 * pairIndex + 1];
+            }
+        }
+        _output.SetOutput({ result });
+    }
+
+    template <typename ElementType>
+    void SparseLinearPredictorNode<ElementType>::Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function)
+    {
+        llvm::Value* pInput = compiler.EnsurePortEmitted(input);
+        llvm::Value* pOutput = compiler.EnsurePortEmitted(output);
+
+        auto sum = function.Variable(emitters::GetVariableType<ElementType>(), "sum");
+        function.Store(sum, function.Literal(_predictor.GetBias()));
+        if (_predictor.Size() > 0)
+        {
+            // Out-of-range indices read weight 0 and add 0, so the loop has no branches; CheckPredictorSize
+            // keeps in-range indices below INT32_MAX, so the 32-bit CastFloatToInt doesn't wrap
+            auto& module = function.GetModule();
+            auto weights = module.ConstantArray("sparseWeights_" + GetInternalStateIdentifier(), _predictor.GetWeights().ToArray());
+            auto numWeights = static_cast<ElementType>(_predictor.Size());
+            function.For(GetMaxNonZeros(), [pInput, weights, numWeights, sum](emitters::IRFunctionEmitter& function, llvm::Value* i) {
+                auto zero = function.LocalScalar<ElementType>(0);
+                auto pairIndex = function.LocalScalar(i) * function.LocalScalar(2);
+                auto indexValue = function.LocalScalar(function.ValueAt(pInput, pairIndex));
+                auto value = function.LocalScalar(function.ValueAt(pInput, pairIndex + function.LocalScalar(1)));
+                auto isValid = (indexValue >= zero) && (indexValue < function.LocalScalar(numWeights));
+                auto index = function.CastFloatToInt(function.Select(isValid, indexValue, zero));
+                auto weight = function.LocalScalar(function.ValueAt(weights, index));
+                auto term = function.LocalScalar(function.Select(isValid, weight * value, zero));
+                function.Store(sum, function.LocalScalar(function.Load(sum)) + term);
+            });
+        }
+        function.SetValueAt(pOutput, function.Literal<int>(0), function.Load(sum));
+    }
+
+    template <typename ElementType>
+    void SparseLinearPredictorNode<ElementType>::Copy(model::ModelTransformer& transformer) const
+    {
+        auto newPortElements = transformer.TransformPortElements(_input.GetPortElements());
+        auto newNode = transformer.AddNode<SparseLinearPredictorNode<ElementType>>(newPortElements, _predictor);
+        transformer.MapNodeOutput(output, newNode->output);
+    }
+
+    template <typename ElementType>
+    void SparseLinearPredictorNode<ElementType>::WriteToArchive(utilities::Archiver& archiver) const
+    {
+        Node::WriteToArchive(archiver);
+        archiver[defaultInputPortName] << _input;
+        archiver["predictor"] << _predictor;
+    }
+
+    template <typename ElementType>
+    void SparseLinearPredictorNode<ElementType>::ReadFromArchive(utilities::Unarchiver& archiver)
+    {
+        Node::ReadFromArchive(archiver);
+        archiver[defaultInputPortName] >> _input;
+        archiver["predictor"] >> _predictor;
+        CheckInputSize();
+        CheckPredictorSize();
+    }
+}
+}
@@ -191,10 +191,6 @@ namespace nodes
         {
             case emitters::UnaryOperationType::sqrt:
                 return function.GetModule().GetRuntime().GetSqrtFunction<ValueType>();
-            case emitters::UnaryOperationType::exp:
-                return function.GetModule().GetRuntime().GetExpFunction<ValueType>();
-            case emitters::UnaryOperationType::log:
-                return function.GetModule().GetRuntime().GetLogFunction<ValueType>();
             case emitters::UnaryOperationType::logicalNot:
             {
                 auto& module = function.GetModule();
@@ -215,14 +211,29 @@ namespace nodes
                 module.EndFunction();
                 return f.GetFunction();
             }
-            case emitters::UnaryOperationType::tanh:
-                return function.GetModule().GetRuntime().GetTanhFunction<ValueType>();
             case emitters::UnaryOperationType::none:
             default:
                 throw emitters::EmitterException(emitters::EmitterError::unaryOperationNotSupported);
         }
     }
 
+    template <typename ValueType>
+    llvm::Value* UnaryOperationNode<ValueType>::EmitOperation(emitters::IRFunctionEmitter& function, llvm::Value* x) const
+    {
+        // exp, log and tanh are emitted inline (rather than as runtime library calls), so the loop can be vectorized
+        switch (this->GetOperation())
+        {
+            case emitters::UnaryOperationType::exp:
+                return emitters::EmitExp(function, x);
+            case emitters::UnaryOperationType::log:
+                return emitters::EmitLog(function, x);
+            case emitters::UnaryOperationType::tanh:
+                return emitters::EmitTanh(function, x);
+            default:
+                return function.Call(GetOperator(function), { x });
+        }
+    }
+
     template <typename ValueType>
     void UnaryOperationNode<ValueType>::Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function)
     {
@@ -239,20 +250,19 @@ namespace nodes
     template <typename ValueType>
     void UnaryOperationNode<ValueType>::CompileLoop(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function)
     {
-        // Loop version broken
-        auto count = input.Size();
+        auto count = static_cast<int>(input.Size());
         llvm::Value* pInput = compiler.EnsurePortEmitted(input);
         llvm::Value* pResult = compiler.EnsurePortEmitted(output);
 
-        auto forLoop = function.ForLoop();
-        forLoop.Begin(count);
-        {
-            auto i = forLoop.LoadIterationVariable();
-            llvm::Value* inputValue = function.ValueAt(pInput, i);
-            llvm::Value* pOpResult = function.Call(GetOperator(function), { inputValue });
-            function.SetValueAt(pResult, i, pOpResult);
-        }
-        forLoop.End();
+        function.ParallelFor(count, {}, { pInput, pResult }, [this](emitters::IRFunctionEmitter& function, llvm::Value* begin, llvm::Value* end, const std::vector<llvm::Value*>& capturedValues) {
+            auto pInput = capturedValues[0];
+            auto pResult = capturedValues[1];
+            function.For(begin, end, [this, pInput, pResult](emitters::IRFunctionEmitter& function, llvm::Value* i) {
+                llvm::Value* inputValue = function.ValueAt(pInput, i);
+                llvm::Value* pOpResult = EmitOperation(function, inputValue);
+                function.SetValueAt(pResult, i, pOpResult);
+            });
+        });
     }
 
     template <typename ValueType>
@@ -263,7 +273,7 @@ namespace nodes
         for (size_t i = 0; i < input.Size(); ++i)
         {
             llvm::Value* inputValue = compiler.LoadPortElementVariable(input.GetInputElement(i));
-            llvm::Value* pOpResult = function.Call(GetOperator(function), { inputValue });
+            llvm::Value* pOpResult = EmitOperation(function, inputValue);
             function.SetValueAt(pResult, function.Literal((int)i), pOpResult);
         }
     }
@@ -1125,6 +1125,45 @@ static void TestMelFilterBankNode()
     }
 }
 
+template <typename ValueType>
+static void TestFFTMelFilterBankNode()
+{
+    const size_t numFilters = 13;
+    const size_t windowSize = 512;
+    const double sampleRate = 16000;
+    const ValueType epsilon = static_cast<ValueType>(1e-4 * windowSize);
+
+    std::vector<ValueType> signal(windowSize);
+    FillRandomVector(signal);
+    std::vector<std::vector<ValueType>> data = {signal};
+
+    // Skip the first filters, so the filters' bins don't start at zero
+    model::Model model;
+    auto inputNode = model.AddNode<model::InputNode<ValueType>>(windowSize);
+    auto fftNode = model.AddNode<nodes::FFTNode<ValueType>>(inputNode->output);
+    auto filters = dsp::MelFilterBank(windowSize, sampleRate, numFilters, 2, numFilters);
+    auto outputNode = model.AddNode<nodes::MelFilterBankNode<ValueType>>(fftNode->output, filters);
+    testing::ProcessTest("Testing FFTNode spectrum read in place", fftNode->IsSpectrumReadInPlace());
+
+    auto map = model::Map(model, { { "input", inputNode } }, { { "output", outputNode->output } });
+    model::MapCompilerParameters settings;
+    model::IRMapCompiler compiler(settings);
+    auto compiledMap = compiler.Compile(map);
+
+    for (size_t index = 0; index < data.size(); ++index)
+    {
+        auto input = data[index];
+
+        map.SetInputValue(0, input);
+        auto computedResult = map.ComputeOutput<ValueType>(0);
+
+        compiledMap.SetInputValue(0, input);
+        auto compiledResult = compiledMap.ComputeOutput<ValueType>(0);
+
+        testing::ProcessTest("Testing FFTNode -> MelFilterBankNode compile", testing::IsEqual(compiledResult, computedResult, epsilon));
+    }
+}
+
 template <typename ValueType>
 static void TestBufferNode()
 {
@@ -1215,6 +1254,8 @@ void NodesTests()
 
     TestMelFilterBankNode<float>();
     TestMelFilterBankNode<double>();
+    TestFFTMelFilterBankNode<float>();
+    TestFFTMelFilterBankNode<double>();
 
     TestBufferNode<float>();
 }
@@ -12,6 +12,9 @@
 // math
 #include "Matrix.h"
 
+// stl
+#include <vector>
+
 namespace ell
 {
 namespace predictors
@@ -24,7 +27,9 @@ namespace neural
         /// <summary> Normal method of doing convolution via reshaping input into columns and performing a gemm operation. </summary>
         columnwise = 0,
         /// <summary> A different method of doing convolution which avoids reshaping the input, and uses gemm on smaller matrices with diagonal sums to create output. </summary>
-        diagonal = 1
+        diagonal = 1,
+        /// <summary> Winograd F(2x2,3x3) convolution, which computes each 2x2 output tile with 16 multiplies per channel instead of 36. Only for 3x3 filters with a stride of 1. </summary>
+        winograd = 2
     };
 
     /// <summary> Specifies the hyper parameters of the convolutional layer. </summary>
@@ -43,6 +48,46 @@ namespace neural
         size_t numFiltersAtATime;
     };
 
+    /// <summary> The number of elements in a transformed Winograd F(2x2,3x3) tile (4x4). </summary>
+    constexpr size_t winogradTileSize = 16;
+
+    /// <summary> Transforms 3x3 convolution filters for Winograd F(2x2,3x3) convolution (U = G g G^T). </summary>
+    ///
+    /// <param name="weights"> The filter weights, in the layout used by `ConvolutionalLayer`: (numFilters * 3) x 3 x numChannels. </param>
+    /// <returns>
+    /// The transformed filters, as 16 consecutive row-major (numFilters x numChannels) matrices, one for each element of
+    /// the transformed 4x4 tile.
+    /// </returns>
+    template <typename ElementType>
+    std::vector<ElementType> GetWinogradConvolutionFilters(typename Layer<ElementType>::ConstTensorReferenceType weights);
+
+    /// <summary> Computes a 3x3, stride-1 convolution with Winograd F(2x2,3x3). </summary>
+    ///
+    /// <param name="input"> The input, including any padding. Output (i, j) is computed from input rows i..i+2 and columns j..j+2. </param>
+    /// <param name="transformedFilters"> The filters, transformed by `GetWinogradConvolutionFilters`. </param>
+    /// <param name="output"> The output (without padding). </param>
+    template <typename ElementType>
+    void WinogradConvolve(typename Layer<ElementType>::ConstTensorReferenceType input, const std::vector<ElementType>& transformedFilters, typename Layer<ElementType>::TensorReferenceType output);
+
+    /// <summary> Computes a grouped convolution directly, without reshaping the input into columns. </summary>
+    ///
+    /// <param name="input"> The input, including any padding. Output (i, j) is computed from the receptive field starting at input (i * stride, j * stride). </param>
+    /// <param name="weights">
+    /// The filter weights: (numFilters * receptiveField) x receptiveField x channelsPerGroup. Filter f only reads the
+    /// input channels of group f / (numFilters / numGroups).
+    /// </param>
+    /// <param name="stride"> The stride. </param>
+    /// <param name="output"> The output (without padding). </param>
+    template <typename ElementType>
+    void GroupedConvolve(typename Layer<ElementType>::ConstTensorReferenceType input, typename Layer<ElementType>::ConstTensorReferenceType weights, size_t stride, typename Layer<ElementType>::TensorReferenceType output);
+
+    /// <summary> Reorders grouped convolution filters so that the filters are the fastest-moving dimension. </summary>
+    ///
+    /// <param name="weights"> The filter weights, in the layout used by `ConvolutionalLayer`: (numFilters * receptiveField) x receptiveField x channelsPerGroup. </param>
+    /// <returns> The weights, indexed by [((filterRow * receptiveField + filterColumn) * channelsPerGroup + channel) * numFilters + filter]. </returns>
+    template <typename ElementType>
+    std::vector<ElementType> GetGroupedConvolutionFilters(typename Layer<ElementType>::ConstTensorReferenceType weights);
+
     /// <summary> A layer in a neural network that implements a fully connected layer, meaning all nodes in this layer are connected to all
     /// outputs of the previous layer (which are the inputs of this layer). </summary>
     template <typename ElementType>
@@ -62,7 +107,11 @@ namespace neural
         ///
         /// <param name="layerParameters"> The parameters common to every layer. </param>
         /// <param name="convolutionalParameters"> The hyperparameters for this convolutional layer. </param>
-        /// <param name="weights"> The set of weights to apply. </param>
+        /// <param name="weights">
+        /// The set of weights to apply: (numFilters * receptiveField) x receptiveField x channelsPerGroup. If the weights have
+        /// fewer channels than the input, the input channels and filters are split into (inputChannels / channelsPerGroup)
+        /// groups, and each filter only sees the input channels in its group.
+        /// </param>
         ConvolutionalLayer(const LayerParameters& layerParameters, const ConvolutionalParameters& convolutionalParameters, TensorType weights);
 
         /// <summary> Instantiates a blank instance. Used for unarchiving purposes only. </summary>
@@ -91,6 +140,11 @@ namespace neural
         /// <returns> The weights, packed into a Matrix. </returns>
         const MatrixType& GetWeightsMatrix() const { return _weightsMatrix; }
 
+        /// <summary> Gets the number of groups the input channels and filters are split into. </summary>
+        ///
+        /// <returns> The number of groups: 1 for an ordinary convolution, and the number of input channels for a depthwise convolution. </returns>
+        size_t NumGroups() const;
+
         /// <summary> Gets the name of this type (for serialization). </summary>
         ///
         /// <returns> The name of this type. </returns>
@@ -121,6 +175,7 @@ namespace neural
         MatrixType _shapedInput;
         MatrixType _weightsMatrix;
         MatrixType _outputMatrix;
+        std::vector<ElementType> _winogradFilters;
     };
 
 }
@@ -6,6 +6,7 @@
 //
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
+#include <algorithm>
 #include <iostream>
 
 namespace ell
@@ -20,21 +21,31 @@ namespace neural
         Layer<ElementType>(layerParameters),
         _convolutionalParameters(convolutionalParameters),
         _weights(std::move(weights)),
-        _shapedInput { _convolutionalParameters.receptiveField * _convolutionalParameters.receptiveField * _layerParameters.input.NumChannels(), NumOutputRowsMinusPadding() * NumOutputColumnsMinusPadding() },
-        _weightsMatrix(_layerParameters.outputShape.NumChannels(), _convolutionalParameters.receptiveField * _convolutionalParameters.receptiveField * _layerParameters.input.NumChannels()),
-        _outputMatrix{ NumOutputChannels(), NumOutputRowsMinusPadding() * NumOutputColumnsMinusPadding() }
+        _shapedInput(0, 0),
+        _weightsMatrix(0, 0),
+        _outputMatrix(0, 0)
     {
         if(_weights.GetDataPointer() == nullptr)
         {
             throw utilities::InputException(utilities::InputExceptionErrors::nullReference, "weights tensor has null data field");
         }
 
-        if (_weights.Size() != (_output.NumChannels() * _layerParameters.input.NumChannels() * convolutionalParameters.receptiveField * convolutionalParameters.receptiveField))
+        if (_weights.Size() != (_output.NumChannels() * _weights.NumChannels() * convolutionalParameters.receptiveField * convolutionalParameters.receptiveField))
         {
             throw utilities::InputException(utilities::InputExceptionErrors::sizeMismatch, "weights dimensions for a convolutional layer should be the size of the receptive field volume * number of filters");
         }
 
-        if (_convolutionalParameters.method == ConvolutionMethod::diagonal)
+        if (_layerParameters.input.NumChannels() % _weights.NumChannels() != 0 || _output.NumChannels() % NumGroups() != 0)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::sizeMismatch, "the number of input channels and filters of a grouped convolutional layer must be multiples of the number of groups");
+        }
+
+        if (NumGroups() > 1)
+        {
+            // Grouped convolutions are always computed directly
+            _convolutionalParameters.method = ConvolutionMethod::columnwise;
+        }
+        else if (_convolutionalParameters.method == ConvolutionMethod::diagonal)
         {
             // Verify that we meet the criteria for doing Diagonal method. If not,
             // choose the normal method.
@@ -43,8 +54,23 @@ namespace neural
                 _convolutionalParameters.method = ConvolutionMethod::columnwise;
             }
         }
+        else if (_convolutionalParameters.method == ConvolutionMethod::winograd)
+        {
+            // Winograd F(2x2,3x3) only applies to 3x3 filters with a stride of 1
+            if (_convolutionalParameters.receptiveField != 3 || _convolutionalParameters.stride != 1)
+            {
+                _convolutionalParameters.method = ConvolutionMethod::columnwise;
+            }
+        }
 
         ComputeWeightsMatrix();
+        InitializeIOMatrices();
+    }
+
+    template <typename ElementType>
+    size_t ConvolutionalLayer<ElementType>::NumGroups() const
+    {
+        return _weights.NumChannels() == 0 ? 1 : _layerParameters.input.NumChannels() / _weights.NumChannels();
     }
 
     template <typename ElementType>
@@ -53,7 +79,11 @@ namespace neural
         auto output = GetOutputMinusPadding();
         auto& input = _layerParameters.input;
 
-        if (_convolutionalParameters.method == ConvolutionMethod::columnwise)
+        if (NumGroups() > 1)
+        {
+            GroupedConvolve<ElementType>(input, _weights, _convolutionalParameters.stride, output);
+        }
+        else if (_convolutionalParameters.method == ConvolutionMethod::columnwise)
         {
             // Re-shape input.
             ReceptiveFieldToColumns(input, _shapedInput);
@@ -75,6 +105,10 @@ namespace neural
                 }
             }
         }
+        else if (_convolutionalParameters.method == ConvolutionMethod::winograd)
+        {
+            WinogradConvolve<ElementType>(input, _winogradFilters, output);
+        }
         else
         {
             // Use the Diagonal method
@@ -187,6 +221,13 @@ namespace neural
     template <typename ElementType>
     void ConvolutionalLayer<ElementType>::ComputeWeightsMatrix()
     {
+        if (NumGroups() > 1)
+        {
+            // Grouped convolutions use the weights tensor directly
+            _weightsMatrix = { 0, 0 };
+            return;
+        }
+
         _weightsMatrix = {_layerParameters.outputShape.NumChannels(), _convolutionalParameters.receptiveField * _convolutionalParameters.receptiveField * _layerParameters.input.NumChannels()};
         if (_convolutionalParameters.method == ConvolutionMethod::columnwise)
         {
@@ -206,11 +247,218 @@ namespace neural
                 }
             }
         }
+        else if (_convolutionalParameters.method == ConvolutionMethod::winograd)
+        {
+            _winogradFilters = GetWinogradConvolutionFilters<ElementType>(_weights);
+        }
+    }
+
+    //
+    // Grouped convolution
+    //
+    template <typename ElementType>
+    void GroupedConvolve(typename Layer<ElementType>::ConstTensorReferenceType input, typename Layer<ElementType>::ConstTensorReferenceType weights, size_t stride, typename Layer<ElementType>::TensorReferenceType output)
+    {
+        const size_t receptiveField = weights.NumColumns();
+        const size_t numFilters = output.NumChannels();
+        const size_t channelsPerGroup = weights.NumChannels();
+        const size_t numGroups = input.NumChannels() / channelsPerGroup;
+        const size_t filtersPerGroup = numFilters / numGroups;
+        if (weights.NumRows() != numFilters * receptiveField || numGroups * channelsPerGroup != input.NumChannels() || filtersPerGroup * numGroups != numFilters)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::sizeMismatch, "Grouped convolution weights don't match the input and output sizes");
+        }
+
+        for (size_t row = 0; row < output.NumRows(); ++row)
+        {
+            for (size_t column = 0; column < output.NumColumns(); ++column)
+            {
+                for (size_t filter = 0; filter < numFilters; ++filter)
+                {
+                    const size_t firstChannel = (filter / filtersPerGroup) * channelsPerGroup;
+                    ElementType sum = 0;
+                    for (size_t filterRow = 0; filterRow < receptiveField; ++filterRow)
+                    {
+                        for (size_t filterColumn = 0; filterColumn < receptiveField; ++filterColumn)
+                        {
+                            for (size_t channel = 0; channel < channelsPerGroup; ++channel)
+                            {
+                                sum += input(row * stride + filterRow, column * stride + filterColumn, firstChannel + channel) * weights(filter * receptiveField + filterRow, filterColumn, channel);
+                            }
+                        }
+                    }
+                    output(row, column, filter) = sum;
+                }
+            }
+        }
+    }
+
+    template <typename ElementType>
+    std::vector<ElementType> GetGroupedConvolutionFilters(typename Layer<ElementType>::ConstTensorReferenceType weights)
+    {
+        const size_t receptiveField = weights.NumColumns();
+        const size_t numFilters = weights.NumRows() / receptiveField;
+        const size_t channelsPerGroup = weights.NumChannels();
+        std::vector<ElementType> result(weights.Size());
+        for (size_t filter = 0; filter < numFilters; ++filter)
+        {
+            for (size_t filterRow = 0; filterRow < receptiveField; ++filterRow)
+            {
+                for (size_t filterColumn = 0; filterColumn < receptiveField; ++filterColumn)
+                {
+                    for (size_t channel = 0; channel < channelsPerGroup; ++channel)
+                    {
+                        result[((filterRow * receptiveField + filterColumn) * channelsPerGroup + channel) * numFilters + filter] = weights(filter * receptiveField + filterRow, filterColumn, channel);
+                    }
+                }
+            }
+        }
+        return result;
+    }
+
+    //
+    // Winograd F(2x2,3x3) convolution
+    //
+    // With d a 4x4 input tile and g a 3x3 filter, the 2x2 output tile is Y = A^T [(G g G^T) .* (B^T d B)] A, where
+    //
+    //        | 1    0    0  |          | 1  0 -1  0 |
+    //    G = | 1/2  1/2  1/2|    B^T = | 0  1  1  0 |    A^T = | 1  1  1  0 |
+    //        | 1/2 -1/2  1/2|          | 0 -1  1  0 |          | 0  1 -1 -1 |
+    //        | 0    0    1  |          | 0  1  0 -1 |
+    //
+    template <typename ElementType>
+    std::vector<ElementType> GetWinogradConvolutionFilters(typename Layer<ElementType>::ConstTensorReferenceType weights)
+    {
+        const size_t numChannels = weights.NumChannels();
+        const size_t numFilters = weights.NumRows() / 3;
+        const ElementType half = static_cast<ElementType>(0.5);
+        std::vector<ElementType> result(winogradTileSize * numFilters * numChannels);
+        for (size_t filter = 0; filter < numFilters; ++filter)
+        {
+            for (size_t channel = 0; channel < numChannels; ++channel)
+            {
+                // G g
+                ElementType gg[4][3];
+                for (size_t column = 0; column < 3; ++column)
+                {
+                    const auto g0 = weights(filter * 3 + 0, column, channel);
+                    const auto g1 = weights(filter * 3 + 1, column, channel);
+                    const auto g2 = weights(filter * 3 + 2, column, channel);
+                    gg[0][column] = g0;
+                    gg[1][column] = half * (g0 + g1 + g2);
+                    gg[2][column] = half * (g0 - g1 + g2);
+                    gg[3][column] = g2;
+                }
+
+                // (G g) G^T
+                for (size_t row = 0; row < 4; ++row)
+                {
+                    const ElementType u[4] = { gg[row][0], half * (gg[row][0] + gg[row][1] + gg[row][2]), half * (gg[row][0] - gg[row][1] + gg[row][2]), gg[row][2] };
+                    for (size_t column = 0; column < 4; ++column)
+                    {
+                        result[((row * 4 + column) * numFilters + filter) * numChannels + channel] = u[column];
+                    }
+                }
+            }
+        }
+        return result;
+    }
+
+    template <typename ElementType>
+    void WinogradConvolve(typename Layer<ElementType>::ConstTensorReferenceType input, const std::vector<ElementType>& transformedFilters, typename Layer<ElementType>::TensorReferenceType output)
+    {
+        const size_t numChannels = input.NumChannels();
+        const size_t numFilters = output.NumChannels();
+        const size_t outputRows = output.NumRows();
+        const size_t outputColumns = output.NumColumns();
+        if (transformedFilters.size() != winogradTileSize * numFilters * numChannels)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::sizeMismatch, "Transformed filters don't match the input and output sizes");
+        }
+
+        std::vector<ElementType> transformedOutput(winogradTileSize * numFilters);
+        for (size_t tileRow = 0; tileRow < outputRows; tileRow += 2)
+        {
+            for (size_t tileColumn = 0; tileColumn < outputColumns; tileColumn += 2)
+            {
+                std::fill(transformedOutput.begin(), transformedOutput.end(), static_cast<ElementType>(0));
+                for (size_t channel = 0; channel < numChannels; ++channel)
+                {
+                    // Load the 4x4 input tile (zero past the edge of the input, when the output size is odd)
+                    ElementType d[4][4];
+                    for (size_t row = 0; row < 4; ++row)
+                    {
+                        for (size_t column = 0; column < 4; ++column)
+                        {
+                            const auto inputRow = tileRow + row;
+                            const auto inputColumn = tileColumn + column;
+                            d[row][column] = (inputRow < input.NumRows() && inputColumn < input.NumColumns()) ? input(inputRow, inputColumn, channel) : static_cast<ElementType>(0);
+                        }
+                    }
+
+                    // B^T d
+                    ElementType t[4][4];
+                    for (size_t column = 0; column < 4; ++column)
+                    {
+                        t[0][column] = d[0][column] - d[2][column];
+                        t[1][column] = d[1][column] + d[2][column];
+                        t[2][column] = d[2][column] - d[1][column];
+                        t[3][column] = d[1][column] - d[3][column];
+                    }
+
+                    // (B^T d) B, multiplied by the transformed filters
+                    for (size_t row = 0; row < 4; ++row)
+                    {
+                        const ElementType v[4] = { t[row][0] - t[row][2], t[row][1] + t[row][2], t[row][2] - t[row][1], t[row][1] - t[row][3] };
+                        for (size_t column = 0; column < 4; ++column)
+                        {
+                            const auto element = row * 4 + column;
+                            for (size_t filter = 0; filter < numFilters; ++filter)
+                            {
+                                transformedOutput[element * numFilters + filter] += transformedFilters[(element * numFilters + filter) * numChannels + channel] * v[column];
+                            }
+                        }
+                    }
+                }
+
+                // Y = A^T M A
+                for (size_t filter = 0; filter < numFilters; ++filter)
+                {
+                    ElementType s[2][4];
+                    for (size_t column = 0; column < 4; ++column)
+                    {
+                        const auto m0 = transformedOutput[(0 * 4 + column) * numFilters + filter];
+                        const auto m1 = transformedOutput[(1 * 4 + column) * numFilters + filter];
+                        const auto m2 = transformedOutput[(2 * 4 + column) * numFilters + filter];
+                        const auto m3 = transformedOutput[(3 * 4 + column) * numFilters + filter];
+                        s[0][column] = m0 + m1 + m2;
+                        s[1][column] = m1 - m2 - m3;
+                    }
+
+                    for (size_t row = 0; row < 2 && tileRow + row < outputRows; ++row)
+                    {
+                        const ElementType y[2] = { s[row][0] + s[row][1] + s[row][2], s[row][1] - s[row][2] - s[row][3] };
+                        for (size_t column = 0; column < 2 && tileColumn + column < outputColumns; ++column)
+                        {
+                            output(tileRow + row, tileColumn + column, filter) = y[column];
+                        }
+                    }
+                }
+            }
+        }
     }
 
     template <typename ElementType>
     void ConvolutionalLayer<ElementType>::InitializeIOMatrices()
     {
+        if (NumGroups() > 1)
+        {
+            // Grouped convolutions don't reshape the input
+            _shapedInput = { 0, 0 };
+            _outputMatrix = { 0, 0 };
+            return;
+        }
+
         _shapedInput = { _convolutionalParameters.receptiveField * _convolutionalParameters.receptiveField * _layerParameters.input.NumChannels(), NumOutputRowsMinusPadding() * NumOutputColumnsMinusPadding() };
         _outputMatrix =  { NumOutputChannels(), NumOutputRowsMinusPadding() * NumOutputColumnsMinusPadding() };
     }
@@ -38,6 +38,12 @@ void PoolingLayerTest();
 template <typename ElementType>
 void ConvolutionalLayerTest();
 
+template <typename ElementType>
+void ConvolutionalLayerWinogradTest(size_t numRows, size_t numColumns, size_t numChannels, size_t numFilters, size_t paddingSize);
+
+template <typename ElementType>
+void GroupedConvolutionalLayerTest(size_t numChannels, size_t numFilters, size_t numGroups, size_t stride);
+
 template <typename ElementType>
 void BinaryConvolutionalLayerGemmTest();
 
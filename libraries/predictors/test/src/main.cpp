@@ -36,6 +36,12 @@ int main()
     FullyConnectedLayerTest<float>();
     PoolingLayerTest<float>();
     ConvolutionalLayerTest<float>();
+    ConvolutionalLayerWinogradTest<float>(8, 8, 3, 4, 1);
+    ConvolutionalLayerWinogradTest<float>(7, 9, 5, 3, 1);
+    ConvolutionalLayerWinogradTest<float>(6, 5, 2, 6, 0);
+    GroupedConvolutionalLayerTest<float>(8, 8, 8, 1); // depthwise
+    GroupedConvolutionalLayerTest<float>(4, 8, 4, 2); // depthwise, with a channel multiplier of 2
+    GroupedConvolutionalLayerTest<float>(6, 4, 2, 1);
     BinaryConvolutionalLayerBitwiseTest<float>();
     BinaryConvolutionalLayerGemmTest<float>();
     SoftmaxLayerTest<float>();
@@ -54,6 +60,8 @@ int main()
     FullyConnectedLayerTest<double>();
     PoolingLayerTest<double>();
     ConvolutionalLayerTest<double>();
+    ConvolutionalLayerWinogradTest<double>(7, 9, 5, 3, 1);
+    GroupedConvolutionalLayerTest<double>(8, 8, 8, 1);
     BinaryConvolutionalLayerBitwiseTest<double>();
     BinaryConvolutionalLayerGemmTest<double>();
     SoftmaxLayerTest<double>();
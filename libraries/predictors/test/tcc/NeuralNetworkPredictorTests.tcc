@@ -24,6 +24,13 @@
 
 // utilities
 #include "JsonArchiver.h"
+#include "RandomEngines.h"
+
+// stl
+#include <cmath>
+#include <random>
+#include <string>
+#include <type_traits>
 
 using namespace ell;
 
@@ -403,6 +410,165 @@ void ConvolutionalLayerTest()
     auto output2 = convolutionalLayer2.GetOutput();
 
     testing::ProcessTest("Testing ConvolutionalLayer (columnwise), values", Equals(output2(0, 0, 0), 10) && Equals(output2(0, 0, 1), 15) && Equals(output2(0, 1, 0), 18) && Equals(output2(0, 1, 1), 18));
+
+    // Verify ConvolutionalLayer with Winograd method
+    convolutionalParams.method = ConvolutionMethod::winograd;
+    ConvolutionalLayer<ElementType> convolutionalLayer3(parameters, convolutionalParams, weights);
+    convolutionalLayer3.Compute();
+    auto output3 = convolutionalLayer3.GetOutput();
+
+    testing::ProcessTest("Testing ConvolutionalLayer (winograd), values", Equals(output3(0, 0, 0), 10) && Equals(output3(0, 0, 1), 15) && Equals(output3(0, 1, 0), 18) && Equals(output3(0, 1, 1), 18));
+}
+
+template <typename ElementType>
+void ConvolutionalLayerWinogradTest(size_t numRows, size_t numColumns, size_t numChannels, size_t numFilters, size_t paddingSize)
+{
+    using namespace ell::predictors;
+    using namespace ell::predictors::neural;
+    using LayerParameters = typename Layer<ElementType>::LayerParameters;
+    using TensorType = typename Layer<ElementType>::TensorType;
+    using Shape = typename Layer<ElementType>::Shape;
+
+    auto engine = utilities::GetRandomEngine("123");
+    std::uniform_real_distribution<double> distribution(-1, 1);
+    auto fillRandom = [&](TensorType& tensor) {
+        for (size_t i = 0; i < tensor.NumRows(); ++i)
+        {
+            for (size_t j = 0; j < tensor.NumColumns(); ++j)
+            {
+                for (size_t k = 0; k < tensor.NumChannels(); ++k)
+                {
+                    tensor(i, j, k) = static_cast<ElementType>(distribution(engine));
+                }
+            }
+        }
+    };
+
+    // Input includes padding; the padding itself is zero
+    TensorType input(numRows + 2 * paddingSize, numColumns + 2 * paddingSize, numChannels);
+    input.Fill(0);
+    auto activeInput = input.GetSubTensor(paddingSize, paddingSize, 0, numRows, numColumns, numChannels);
+    for (size_t i = 0; i < numRows; ++i)
+    {
+        for (size_t j = 0; j < numColumns; ++j)
+        {
+            for (size_t k = 0; k < numChannels; ++k)
+            {
+                activeInput(i, j, k) = static_cast<ElementType>(distribution(engine));
+            }
+        }
+    }
+
+    const size_t outputRows = numRows + 2 * paddingSize - 2;
+    const size_t outputColumns = numColumns + 2 * paddingSize - 2;
+    Shape outputShape = { outputRows, outputColumns, numFilters };
+    LayerParameters parameters{ input, ZeroPadding(paddingSize), outputShape, NoPadding() };
+    TensorType weights(3 * numFilters, 3, numChannels);
+    fillRandom(weights);
+
+    ConvolutionalParameters columnwiseParams{ 3, 1, ConvolutionMethod::columnwise, 2 };
+    ConvolutionalLayer<ElementType> columnwiseLayer(parameters, columnwiseParams, weights);
+    columnwiseLayer.Compute();
+    auto expected = columnwiseLayer.GetOutput();
+
+    ConvolutionalParameters winogradParams{ 3, 1, ConvolutionMethod::winograd, 2 };
+    ConvolutionalLayer<ElementType> winogradLayer(parameters, winogradParams, weights);
+    winogradLayer.Compute();
+    auto output = winogradLayer.GetOutput();
+
+    // The Winograd transforms reassociate the sums, so the results only agree to within rounding error
+    const double tolerance = std::is_same<ElementType, float>::value ? 1e-4 : 1e-10;
+    bool ok = true;
+    for (size_t i = 0; i < outputRows; ++i)
+    {
+        for (size_t j = 0; j < outputColumns; ++j)
+        {
+            for (size_t k = 0; k < numFilters; ++k)
+            {
+                ok = ok && std::abs(output(i, j, k) - expected(i, j, k)) <= tolerance * (1 + std::abs(expected(i, j, k)));
+            }
+        }
+    }
+    testing::ProcessTest("Testing ConvolutionalLayer (winograd) against columnwise, " + std::to_string(numRows) + "x" + std::to_string(numColumns) + "x" + std::to_string(numChannels) + " input, " + std::to_string(numFilters) + " filters, padding " + std::to_string(paddingSize), ok);
+}
+
+template <typename ElementType>
+void GroupedConvolutionalLayerTest(size_t numChannels, size_t numFilters, size_t numGroups, size_t stride)
+{
+    using namespace ell::predictors;
+    using namespace ell::predictors::neural;
+    using LayerParameters = typename Layer<ElementType>::LayerParameters;
+    using TensorType = typename Layer<ElementType>::TensorType;
+    using Shape = typename Layer<ElementType>::Shape;
+
+    const size_t numRows = 7;
+    const size_t numColumns = 6;
+    const size_t paddingSize = 1;
+    const size_t receptiveField = 3;
+    const size_t channelsPerGroup = numChannels / numGroups;
+    const size_t filtersPerGroup = numFilters / numGroups;
+
+    auto engine = utilities::GetRandomEngine("123");
+    std::uniform_real_distribution<double> distribution(-1, 1);
+
+    TensorType input(numRows + 2 * paddingSize, numColumns + 2 * paddingSize, numChannels);
+    input.Fill(0);
+    auto activeInput = input.GetSubTensor(paddingSize, paddingSize, 0, numRows, numColumns, numChannels);
+    for (size_t i = 0; i < numRows; ++i)
+    {
+        for (size_t j = 0; j < numColumns; ++j)
+        {
+            for (size_t k = 0; k < numChannels; ++k)
+            {
+                activeInput(i, j, k) = static_cast<ElementType>(distribution(engine));
+            }
+        }
+    }
+
+    // The equivalent ordinary convolution has zero weights for the channels outside each filter's group
+    TensorType groupedWeights(receptiveField * numFilters, receptiveField, channelsPerGroup);
+    TensorType fullWeights(receptiveField * numFilters, receptiveField, numChannels);
+    fullWeights.Fill(0);
+    for (size_t i = 0; i < groupedWeights.NumRows(); ++i)
+    {
+        const size_t firstChannel = (i / receptiveField / filtersPerGroup) * channelsPerGroup;
+        for (size_t j = 0; j < receptiveField; ++j)
+        {
+            for (size_t k = 0; k < channelsPerGroup; ++k)
+            {
+                groupedWeights(i, j, k) = static_cast<ElementType>(distribution(engine));
+                fullWeights(i, j, firstChannel + k) = groupedWeights(i, j, k);
+            }
+        }
+    }
+
+    const size_t outputRows = (numRows + 2 * paddingSize - receptiveField) / stride + 1;
+    const size_t outputColumns = (numColumns + 2 * paddingSize - receptiveField) / stride + 1;
+    Shape outputShape = { outputRows, outputColumns, numFilters };
+    LayerParameters parameters{ input, ZeroPadding(paddingSize), outputShape, NoPadding() };
+    ConvolutionalParameters convolutionalParams{ receptiveField, stride, ConvolutionMethod::columnwise, 2 };
+
+    ConvolutionalLayer<ElementType> fullLayer(parameters, convolutionalParams, fullWeights);
+    fullLayer.Compute();
+    auto expected = fullLayer.GetOutput();
+
+    ConvolutionalLayer<ElementType> groupedLayer(parameters, convolutionalParams, groupedWeights);
+    groupedLayer.Compute();
+    auto output = groupedLayer.GetOutput();
+
+    const double tolerance = std::is_same<ElementType, float>::value ? 1e-5 : 1e-12;
+    bool ok = groupedLayer.NumGroups() == numGroups;
+    for (size_t i = 0; i < outputRows; ++i)
+    {
+        for (size_t j = 0; j < outputColumns; ++j)
+        {
+            for (size_t k = 0; k < numFilters; ++k)
+            {
+                ok = ok && std::abs(output(i, j, k) - expected(i, j, k)) <= tolerance * (1 + std::abs(expected(i, j, k)));
+            }
+        }
+    }
+    testing::ProcessTest("Testing ConvolutionalLayer (grouped) against zero-padded weights, " + std::to_string(numChannels) + " channels, " + std::to_string(numFilters) + " filters, " + std::to_string(numGroups) + " groups, stride " + std::to_string(stride), ok);
 }
 
 template <typename ElementType>
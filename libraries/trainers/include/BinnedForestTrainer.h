@@ -0,0 +1,137 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     BinnedForestTrainer.h (trainers)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "ForestTrainer.h"
+#include "LogitBooster.h"
+
+// predictors
+#include "ConstantPredictor.h"
+#include "SingleElementThresholdPredictor.h"
+
+// stl
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace ell
+{
+namespace trainers
+{
+    /// <summary> Parameters for the binned forest trainer. </summary>
+    struct BinnedForestTrainerParameters : public virtual ForestTrainerParameters
+    {
+        size_t maxBinsPerFeature = 256;
+    };
+
+    /// <summary> A trainer for binary decision forests with threshold split rules and constant outputs that quantizes
+    /// each feature into at most 256 bins when the dataset is set, and finds splits by accumulating a histogram of the
+    /// weak weights and labels in each bin. The histogram of one child of a split is computed by subtracting the other
+    /// child's histogram from the parent's, so only the smaller child's examples are scanned. Features are binned,
+    /// histogrammed and scanned in parallel, and sibling nodes are searched concurrently. </summary>
+    ///
+    /// <typeparam name="LossFunctionType"> Loss function type. </typeparam>
+    /// <typeparam name="BoosterType"> Booster type. </typeparam>
+    template <typename LossFunctionType, typename BoosterType>
+    class BinnedForestTrainer : public ForestTrainer<predictors::SingleElementThresholdPredictor, predictors::ConstantPredictor, BoosterType>
+    {
+    public:
+        /// <summary> Constructs an instance of BinnedForestTrainer. </summary>
+        ///
+        /// <param name="lossFunction"> The loss function. </param>
+        /// <param name="booster"> The booster. </param>
+        /// <param name="parameters"> Training Parameters. </param>
+        BinnedForestTrainer(const LossFunctionType& lossFunction, const BoosterType& booster, const BinnedForestTrainerParameters& parameters);
+
+        using SplitRuleType = predictors::SingleElementThresholdPredictor;
+        using EdgePredictorType = predictors::ConstantPredictor;
+        using typename ForestTrainer<SplitRuleType, EdgePredictorType, BoosterType>::SplitCandidate;
+        using typename ForestTrainer<SplitRuleType, EdgePredictorType, BoosterType>::SplittableNodeId;
+        using typename ForestTrainer<SplitRuleType, EdgePredictorType, BoosterType>::NodeStats;
+        using typename ForestTrainer<SplitRuleType, EdgePredictorType, BoosterType>::NodeRanges;
+        using typename ForestTrainer<SplitRuleType, EdgePredictorType, BoosterType>::Range;
+        using typename ForestTrainer<SplitRuleType, EdgePredictorType, BoosterType>::Sums;
+        using typename ForestTrainer<SplitRuleType, EdgePredictorType, BoosterType>::TrainerExampleType;
+
+        /// <summary> Sets the trainer's dataset, and quantizes its features. </summary>
+        ///
+        /// <param name="anyDataset"> A dataset. </param>
+        void SetDataset(const data::AnyDataset& anyDataset) override;
+
+    protected:
+        using ForestTrainer<SplitRuleType, EdgePredictorType, BoosterType>::_dataset;
+        using ForestTrainer<SplitRuleType, EdgePredictorType, BoosterType>::ParallelFor;
+        using ForestTrainer<SplitRuleType, EdgePredictorType, BoosterType>::_parameters;
+        SplitCandidate GetBestSplitRuleAtNode(SplittableNodeId nodeId, Range range, Sums sums) override;
+        std::vector<EdgePredictorType> GetEdgePredictors(const NodeStats& nodeStats) override;
+        void SortNodeDataset(Range range, const SplitRuleType& splitRule) override;
+
+    private:
+        // the total weak weight and label, and the number of examples, in one bin of one feature
+        struct Bin
+        {
+            Sums sums;
+            size_t size = 0;
+        };
+
+        // the best split of a node on a single feature
+        struct FeatureSplit
+        {
+            double gain = 0;
+            size_t binIndex = 0;
+            size_t size0 = 0;
+            Sums sums0;
+        };
+
+        // the bins of all features, feature after feature
+        using Histogram = std::vector<Bin>;
+        using RangeKey = std::pair<size_t, size_t>;
+
+        void BinFeatures();
+        void BinFeature(size_t featureIndex);
+        Histogram BuildHistogram(Range range) const;
+        Histogram GetHistogram(Range range);
+        void StoreHistogram(Range range, Histogram histogram);
+        FeatureSplit GetBestSplitOfFeature(const Histogram& histogram, Range range, const Sums& sums, size_t featureIndex) const;
+        double CalculateGain(const Sums& sums, const Sums& sums0, const Sums& sums1) const;
+
+        // member variables
+        LossFunctionType _lossFunction;
+        size_t _maxBinsPerFeature;
+
+        // the bin of each feature of each example, column-major (indexed by the example's original row)
+        std::vector<uint8_t> _bins;
+
+        // the thresholds between consecutive bins of each feature, and where each feature's bins start in a histogram
+        std::vector<std::vector<double>> _binThresholds;
+        std::vector<size_t> _firstBin;
+
+        // the original row of the example at each position of the dataset, which the splits permute
+        std::vector<size_t> _rowIndices;
+
+        // the histograms of the nodes that may be split, keyed by their ranges (sibling nodes are searched concurrently)
+        std::map<RangeKey, Histogram> _histograms;
+        std::mutex _histogramsMutex;
+    };
+
+    /// <summary> Makes a binned forest trainer. </summary>
+    ///
+    /// <typeparam name="LossFunctionType"> Type of loss function to use. </typeparam>
+    /// <param name="lossFunction"> The loss function. </param>
+    /// <param name="parameters"> The trainer parameters. </param>
+    ///
+    /// <returns> A unique_ptr to a binned forest trainer. </returns>
+    template <typename LossFunctionType, typename BoosterType>
+    std::unique_ptr<ITrainer<predictors::SimpleForestPredictor>> MakeBinnedForestTrainer(const LossFunctionType& lossFunction, const BoosterType& booster, const BinnedForestTrainerParameters& parameters);
+}
+}
+
+#include "../tcc/BinnedForestTrainer.tcc"
@@ -19,8 +19,10 @@
 
 // utilities
 #include "OutputStreamImpostor.h"
+#include "ThreadPool.h"
 
 // stl
+#include <functional>
 #include <iostream>
 #include <memory>
 #include <queue>
@@ -36,6 +38,7 @@ namespace trainers
         double minSplitGain = 0.0;
         size_t maxSplitsPerRound = 0;
         size_t numRounds = 0;
+        size_t numThreads = 1; // 0 means the number of hardware threads; the trained forest doesn't depend on it
     };
 
     /// <summary> Nontemplated base class for forest trainers, provides some reusable internal classes. </summary>
@@ -49,6 +52,7 @@ namespace trainers
             double sumWeightedLabels = 0;
 
             void Increment(const data::WeightLabel& weightLabel);
+            Sums operator+(const Sums& other) const;
             Sums operator-(const Sums& other) const;
             double GetMeanLabel() const;
             void Print(std::ostream& os) const;
@@ -181,7 +185,14 @@ namespace trainers
         void UpdateCurrentOutputs(Range range, const EdgePredictorType& edgePredictor);
 
         // after performing a split, we rearrange the data set to ensure that each node's examples occupy contiguous rows in the dataset
-        void SortNodeDataset(Range range, const SplitRuleType& splitRule);
+        virtual void SortNodeDataset(Range range, const SplitRuleType& splitRule);
+
+        // calls body(index) for each index in [0, count) on the trainer's threads, unless there is too little work (in examples visited) to share;
+        // callers write per-index results and reduce them in index order, so the result doesn't depend on the number of threads
+        void ParallelFor(size_t count, size_t work, const std::function<void(size_t)>& body) const;
+
+        // returns true if GetBestSplitRuleAtNode may be called concurrently for nodes with disjoint ranges
+        virtual bool CanSearchNodesConcurrently() const { return true; }
 
         //
         // implementation specific functions that must be implemented by a derived class
@@ -206,6 +217,9 @@ namespace trainers
 
         // the data set
         data::Dataset<TrainerExampleType> _dataset;
+
+        // the threads that search for splits
+        std::unique_ptr<utilities::ThreadPool> _threadPool;
     };
 }
 }
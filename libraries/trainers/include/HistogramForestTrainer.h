@@ -18,6 +18,7 @@
 // stl
 #include <random>
 #include <tuple>
+#include <vector>
 
 namespace ell
 {
@@ -53,14 +54,19 @@ namespace trainers
         using typename ForestTrainer<SplitRuleType, EdgePredictorType, BoosterType>::SplitCandidate;
         using typename ForestTrainer<SplitRuleType, EdgePredictorType, BoosterType>::SplittableNodeId;
         using typename ForestTrainer<SplitRuleType, EdgePredictorType, BoosterType>::NodeStats;
+        using typename ForestTrainer<SplitRuleType, EdgePredictorType, BoosterType>::NodeRanges;
         using typename ForestTrainer<SplitRuleType, EdgePredictorType, BoosterType>::Range;
         using typename ForestTrainer<SplitRuleType, EdgePredictorType, BoosterType>::Sums;
 
     protected:
         using ForestTrainer<SplitRuleType, EdgePredictorType, BoosterType>::_dataset;
+        using ForestTrainer<SplitRuleType, EdgePredictorType, BoosterType>::ParallelFor;
         SplitCandidate GetBestSplitRuleAtNode(SplittableNodeId nodeId, Range range, Sums sums) override;
         std::vector<EdgePredictorType> GetEdgePredictors(const NodeStats& nodeStats) override;
 
+        // the threshold finder draws from the trainer's random engine, so nodes must be searched one at a time, in order
+        bool CanSearchNodesConcurrently() const override { return false; }
+
     private:
         struct EvaluateSplitRuleResult
         {
@@ -20,8 +20,13 @@
 // math
 #include "Vector.h"
 
+// utilities
+#include "ThreadPool.h"
+
 // stl
+#include <memory>
 #include <random>
+#include <vector>
 
 namespace ell
 {
@@ -35,6 +40,8 @@ namespace trainers
         size_t maxEpochs;
         bool permute;
         std::string randomSeedString;
+        size_t numThreads = 1; // 0 means the number of hardware threads
+        size_t syncInterval = 1000; // the number of examples each thread visits between synchronizations
     };
 
     /// <summary> Information about the result of an SDCA training session. </summary>
@@ -45,7 +52,13 @@ namespace trainers
         size_t numEpochsPerformed = 0;
     };
 
-    /// <summary> Implements the stochastic dual coordinate ascent linear trainer. </summary>
+    /// <summary>
+    /// Implements the stochastic dual coordinate ascent linear trainer. If parameters.numThreads isn't 1, each epoch is
+    /// divided into rounds in which every thread performs SDCA steps on its own block of examples against a private copy
+    /// of the primal state, with steps made conservative enough that the threads' changes can simply be added together
+    /// when they synchronize at the end of the round (as in CoCoA+). The result depends on the number of threads but
+    /// not on thread timing.
+    /// </summary>
     ///
     /// <typeparam name="LossFunctionType"> Loss function type. </typeparam>
     /// <typeparam name="RegularizerType"> Regularizer type. </typeparam>
@@ -93,10 +106,20 @@ namespace trainers
             double dualVariable = 0;
         };
 
+        // a thread's private copy of the primal state, used between synchronizations
+        struct ThreadState
+        {
+            math::ColumnVector<double> v;
+            double d = 0;
+            predictors::LinearPredictor<double> predictor;
+        };
+
         using DataVectorType = typename predictors::LinearPredictor<double>::DataVectorType;
         using TrainerExampleType = data::Example<DataVectorType, TrainerMetadata>;
 
         void Step(TrainerExampleType& x);
+        void ParallelEpoch();
+        void ParallelStep(TrainerExampleType& x, ThreadState& state, double numThreads);
         void ComputeObjectives();
         void ResizeTo(const data::AutoDataVector& x);
 
@@ -114,6 +137,9 @@ namespace trainers
         math::ColumnVector<double> _v;
         double _d = 0;
         math::RowVector<double> _a;
+
+        std::unique_ptr<utilities::ThreadPool> _threadPool;
+        std::vector<ThreadState> _threadStates;
     };
 
     //
@@ -17,7 +17,11 @@
 #include "Dataset.h"
 #include "Example.h"
 
+// utilities
+#include "ThreadPool.h"
+
 // stl
+#include <atomic>
 #include <cstddef>
 #include <memory>
 #include <random>
@@ -32,6 +36,7 @@ namespace trainers
     {
         double regularization;
         std::string randomSeedString;
+        size_t numThreads = 1; // only used by SparseDataSGDTrainer; 0 means the number of hardware threads
     };
 
     /// <summary>
@@ -63,6 +68,9 @@ namespace trainers
         virtual void DoNextStep(const data::AutoDataVector& x, double y, double weight) = 0;
         virtual const PredictorType& GetAveragedPredictor() const = 0;
 
+        // performs the steps on the examples of the permuted dataset, starting at firstIndex; by default, calls DoNextStep on each one
+        virtual void DoNextSteps(size_t firstIndex);
+
         data::AutoSupervisedDataset _dataset;
         std::default_random_engine _random;
         bool _firstIteration = true;
@@ -116,7 +124,11 @@ namespace trainers
     // SparseDataSGDTrainer - Sparse Data Stochastic Gradient Descent
     //
 
-    /// <summary> Implements the steps of Sparse Data Stochastic Gradient Descent. </summary>
+    /// <summary>
+    /// Implements the steps of Sparse Data Stochastic Gradient Descent. If parameters.numThreads isn't 1, the steps of
+    /// each epoch are performed concurrently, Hogwild-style: the threads read and update the shared weights without
+    /// locks, each touching only the nonzeros of its examples, so the result depends on thread timing.
+    /// </summary>
     ///
     /// <typeparam name="LossFunctionType"> Loss function type. </typeparam>
     template <typename LossFunctionType>
@@ -144,6 +156,7 @@ namespace trainers
     protected:
         void DoFirstStep(const data::AutoDataVector& x, double y, double weight) override;
         void DoNextStep(const data::AutoDataVector& x, double y, double weight) override;
+        void DoNextSteps(size_t firstIndex) override;
 
     private:
         LossFunctionType _lossFunction;
@@ -161,7 +174,11 @@ namespace trainers
         mutable PredictorType _lastPredictor;
         mutable PredictorType _averagedPredictor;
 
+        std::unique_ptr<utilities::ThreadPool> _threadPool;
+
         void ResizeTo(const data::AutoDataVector& x);
+        void DoNextStepsInParallel(size_t firstIndex);
+        static void AtomicAdd(std::atomic<double>& target, double value);
     };
 
     //
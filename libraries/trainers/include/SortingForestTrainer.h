@@ -15,6 +15,9 @@
 #include "ConstantPredictor.h"
 #include "SingleElementThresholdPredictor.h"
 
+// stl
+#include <vector>
+
 namespace ell
 {
 namespace trainers
@@ -25,7 +28,7 @@ namespace trainers
     };
 
     /// <summary> A trainer for binary decision forests with threshold split rules and constant outputs
-    /// that operates by sorting the data set by each feature. </summary>
+    /// that operates by sorting the examples of each node by each feature. The features are sorted in parallel. </summary>
     ///
     /// <typeparam name="LossFunctionType"> Loss function type. </typeparam>
     /// <typeparam name="BoosterType"> Booster type. </typeparam>
@@ -45,6 +48,7 @@ namespace trainers
         using typename ForestTrainer<SplitRuleType, EdgePredictorType, BoosterType>::SplitCandidate;
         using typename ForestTrainer<SplitRuleType, EdgePredictorType, BoosterType>::SplittableNodeId;
         using typename ForestTrainer<SplitRuleType, EdgePredictorType, BoosterType>::NodeStats;
+        using typename ForestTrainer<SplitRuleType, EdgePredictorType, BoosterType>::NodeRanges;
         using typename ForestTrainer<SplitRuleType, EdgePredictorType, BoosterType>::Range;
         using typename ForestTrainer<SplitRuleType, EdgePredictorType, BoosterType>::Sums;
         using typename ForestTrainer<SplitRuleType, EdgePredictorType, BoosterType>::TrainerMetadata;
@@ -54,11 +58,21 @@ namespace trainers
 
     protected:
         using ForestTrainer<SplitRuleType, EdgePredictorType, BoosterType>::_dataset;
+        using ForestTrainer<SplitRuleType, EdgePredictorType, BoosterType>::ParallelFor;
         SplitCandidate GetBestSplitRuleAtNode(SplittableNodeId nodeId, Range range, Sums sums) override;
         std::vector<EdgePredictorType> GetEdgePredictors(const NodeStats& nodeStats) override;
 
     private:
-        void SortNodeDataset(Range range, size_t featureIndex);
+        // the best split of a node on a single feature
+        struct FeatureSplit
+        {
+            double gain = 0;
+            double threshold = 0;
+            size_t size0 = 0;
+            Sums sums0;
+        };
+
+        FeatureSplit GetBestSplitOfFeature(Range range, const Sums& sums, size_t inputIndex) const;
         double CalculateGain(const Sums& sums, const Sums& sums0, const Sums& sums1) const;
 
         // member variables
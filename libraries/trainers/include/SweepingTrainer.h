@@ -17,6 +17,9 @@
 // evaluators
 #include "Evaluator.h"
 
+// utilities
+#include "ThreadPool.h"
+
 //stl
 #include <memory>
 #include <random>
@@ -28,7 +31,10 @@ namespace ell
 {
 namespace trainers
 {
-    /// <summary> A class that runs multiple internal trainers and chooses the best performing predictor. </summary>
+    /// <summary>
+    /// A class that runs multiple internal trainers and chooses the best performing predictor. The internal trainers
+    /// have independent state, so each one is set up and updated as a separate task on a thread pool.
+    /// </summary>
     ///
     /// <typeparam name="PredictorType"> The type of predictor returned by this trainer. </typeparam>
     template <typename PredictorType>
@@ -41,7 +47,8 @@ namespace trainers
         /// <summary> Constructs an instance of SweepingTrainer. </summary>
         ///
         /// <param name="evaluatingTrainers"> A vector of evaluating trainers. </param>
-        SweepingTrainer(std::vector<EvaluatingTrainerType>&& evaluatingTrainers);
+        /// <param name="numThreads"> The number of threads that run the trainers (0 means the number of hardware threads). </param>
+        SweepingTrainer(std::vector<EvaluatingTrainerType>&& evaluatingTrainers, size_t numThreads = 1);
 
         /// <summary> Sets the trainer's dataset. </summary>
         ///
@@ -57,18 +64,19 @@ namespace trainers
         const PredictorType& GetPredictor() const override;
 
     private:
-        data::Dataset<ExampleType> _dataset;
         std::vector<EvaluatingTrainerType> _evaluatingTrainers;
+        std::unique_ptr<utilities::ThreadPool> _threadPool;
     };
 
     /// <summary> Makes an incremental trainer that runs multiple internal trainers and chooses the best performing predictor. </summary>
     ///
     /// <typeparam name="PredictorType"> Type of the predictor returned by this trainer. </typeparam>
     /// <param name="evaluatingTrainers"> A vector of evaluating trainers. </param>
+    /// <param name="numThreads"> The number of threads that run the trainers (0 means the number of hardware threads). </param>
     ///
     /// <returns> A unique_ptr to a sweeping trainer. </returns>
     template <typename PredictorType>
-    std::unique_ptr<ITrainer<PredictorType>> MakeSweepingTrainer(std::vector<EvaluatingTrainer<PredictorType>>&& evaluatingTrainers);
+    std::unique_ptr<ITrainer<PredictorType>> MakeSweepingTrainer(std::vector<EvaluatingTrainer<PredictorType>>&& evaluatingTrainers, size_t numThreads = 1);
 }
 }
 
@@ -23,13 +23,11 @@ namespace trainers
         // permute the data
         _dataset.RandomPermute(_random);
 
-        // get example iterator
-        auto exampleIterator = _dataset.GetExampleReferenceIterator();
-
         // first iteration handled separately
-        if (_firstIteration && exampleIterator.IsValid())
+        size_t firstIndex = 0;
+        if (_firstIteration && _dataset.NumExamples() > 0)
         {
-            const auto& example = exampleIterator.Get();
+            const auto& example = _dataset[0];
 
             const auto& x = example.GetDataVector();
             double y = example.GetMetadata().label;
@@ -37,22 +35,24 @@ namespace trainers
 
             DoFirstStep(x, y, weight);
 
-            exampleIterator.Next();
+            firstIndex = 1;
             _firstIteration = false;
         }
 
-        while (exampleIterator.IsValid())
+        DoNextSteps(firstIndex);
+    }
+
+    void SGDTrainerBase::DoNextSteps(size_t firstIndex)
+    {
+        for (size_t index = firstIndex; index < _dataset.NumExamples(); ++index)
         {
-            // get the Next example
-            const auto& example = exampleIterator.Get();
+            const auto& example = _dataset[index];
 
             const auto& x = example.GetDataVector();
             double y = example.GetMetadata().label;
             double weight = example.GetMetadata().weight;
 
             DoNextStep(x, y, weight);
-
-            exampleIterator.Next();
         }
     }
 
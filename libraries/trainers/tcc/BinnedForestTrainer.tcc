@@ -0,0 +1,332 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     BinnedForestTrainer.tcc (trainers)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// utilities
+#include "Exception.h"
+
+// stl
+#include <algorithm>
+#include <numeric>
+
+namespace ell
+{
+namespace trainers
+{
+    template <typename LossFunctionType, typename BoosterType>
+    BinnedForestTrainer<LossFunctionType, BoosterType>::BinnedForestTrainer(const LossFunctionType& lossFunction, const BoosterType& booster, const BinnedForestTrainerParameters& parameters)
+        : ForestTrainer<SplitRuleType, EdgePredictorType, BoosterType>(booster, parameters), _lossFunction(lossFunction), _maxBinsPerFeature(parameters.maxBinsPerFeature)
+    {
+        if (_maxBinsPerFeature < 2 || _maxBinsPerFeature > 256)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "maxBinsPerFeature must be between 2 and 256");
+        }
+    }
+
+    template <typename LossFunctionType, typename BoosterType>
+    void BinnedForestTrainer<LossFunctionType, BoosterType>::SetDataset(const data::AnyDataset& anyDataset)
+    {
+        ForestTrainer<SplitRuleType, EdgePredictorType, BoosterType>::SetDataset(anyDataset);
+        BinFeatures();
+    }
+
+    template <typename LossFunctionType, typename BoosterType>
+    void BinnedForestTrainer<LossFunctionType, BoosterType>::BinFeatures()
+    {
+        auto numExamples = _dataset.NumExamples();
+        auto numFeatures = _dataset.NumFeatures();
+
+        _bins.assign(numFeatures * numExamples, 0);
+        _binThresholds.assign(numFeatures, {});
+        _rowIndices.resize(numExamples);
+        std::iota(_rowIndices.begin(), _rowIndices.end(), 0);
+        _histograms.clear();
+
+        ParallelFor(numFeatures, numFeatures * numExamples, [this](size_t featureIndex) { BinFeature(featureIndex); });
+
+        _firstBin.assign(1, 0);
+        for (const auto& thresholds : _binThresholds)
+        {
+            _firstBin.push_back(_firstBin.back() + thresholds.size() + 1);
+        }
+    }
+
+    template <typename LossFunctionType, typename BoosterType>
+    void BinnedForestTrainer<LossFunctionType, BoosterType>::BinFeature(size_t featureIndex)
+    {
+        auto numExamples = _dataset.NumExamples();
+        std::vector<double> values(numExamples);
+        for (size_t rowIndex = 0; rowIndex < numExamples; ++rowIndex)
+        {
+            values[rowIndex] = _dataset[rowIndex].GetDataVector()[featureIndex];
+        }
+        auto sortedValues = values;
+        std::sort(sortedValues.begin(), sortedValues.end());
+
+        size_t numDistinctValues = numExamples > 0 ? 1 : 0;
+        for (size_t index = 1; index < numExamples; ++index)
+        {
+            if (sortedValues[index] != sortedValues[index - 1])
+            {
+                ++numDistinctValues;
+            }
+        }
+
+        // each distinct value gets its own bin if there are few enough of them, otherwise the bins hold roughly equal numbers of examples
+        auto& thresholds = _binThresholds[featureIndex];
+        for (size_t index = 0; index + 1 < numExamples; ++index)
+        {
+            double currentValue = sortedValues[index];
+            double nextValue = sortedValues[index + 1];
+            if (currentValue == nextValue)
+            {
+                continue;
+            }
+
+            bool reachedQuantile = (index + 1) * _maxBinsPerFeature >= (thresholds.size() + 1) * numExamples;
+            if (numDistinctValues <= _maxBinsPerFeature || (reachedQuantile && thresholds.size() + 1 < _maxBinsPerFeature))
+            {
+                // the midpoint can round up to nextValue, in which case currentValue separates the two values
+                double threshold = 0.5 * (currentValue + nextValue);
+                thresholds.push_back(threshold < nextValue ? threshold : currentValue);
+            }
+        }
+
+        // the bin of a value is the number of thresholds below it, so a value is in a bin at or below b exactly when it is at most thresholds[b]
+        auto featureBins = _bins.begin() + featureIndex * numExamples;
+        for (size_t rowIndex = 0; rowIndex < numExamples; ++rowIndex)
+        {
+            featureBins[rowIndex] = static_cast<uint8_t>(std::lower_bound(thresholds.begin(), thresholds.end(), values[rowIndex]) - thresholds.begin());
+        }
+    }
+
+    template <typename LossFunctionType, typename BoosterType>
+    auto BinnedForestTrainer<LossFunctionType, BoosterType>::BuildHistogram(Range range) const -> Histogram
+    {
+        // gather the weak weights and labels of the node once, so the per-feature loops only read the bins
+        std::vector<data::WeightLabel> weakWeightLabels(range.size);
+        std::vector<size_t> rowIndices(range.size);
+        for (size_t index = 0; index < range.size; ++index)
+        {
+            weakWeightLabels[index] = _dataset[range.firstIndex + index].GetMetadata().weak;
+            rowIndices[index] = _rowIndices[range.firstIndex + index];
+        }
+
+        // each feature fills its own part of the histogram
+        Histogram histogram(_firstBin.back());
+        auto numExamples = _dataset.NumExamples();
+        auto numFeatures = _binThresholds.size();
+        ParallelFor(numFeatures, numFeatures * range.size, [&](size_t featureIndex) {
+            auto featureBins = _bins.data() + featureIndex * numExamples;
+            auto featureHistogram = histogram.data() + _firstBin[featureIndex];
+            for (size_t index = 0; index < range.size; ++index)
+            {
+                auto& bin = featureHistogram[featureBins[rowIndices[index]]];
+                bin.sums.Increment(weakWeightLabels[index]);
+                ++bin.size;
+            }
+        });
+        return histogram;
+    }
+
+    template <typename LossFunctionType, typename BoosterType>
+    auto BinnedForestTrainer<LossFunctionType, BoosterType>::GetHistogram(Range range) -> Histogram
+    {
+        {
+            std::lock_guard<std::mutex> lock(_histogramsMutex);
+            auto iter = _histograms.find({ range.firstIndex, range.size });
+            if (iter != _histograms.end())
+            {
+                auto histogram = std::move(iter->second);
+                _histograms.erase(iter);
+                return histogram;
+            }
+        }
+        return BuildHistogram(range);
+    }
+
+    template <typename LossFunctionType, typename BoosterType>
+    void BinnedForestTrainer<LossFunctionType, BoosterType>::StoreHistogram(Range range, Histogram histogram)
+    {
+        std::lock_guard<std::mutex> lock(_histogramsMutex);
+        _histograms[{ range.firstIndex, range.size }] = std::move(histogram);
+    }
+
+    template <typename LossFunctionType, typename BoosterType>
+    auto BinnedForestTrainer<LossFunctionType, BoosterType>::GetBestSplitRuleAtNode(SplittableNodeId nodeId, Range range, Sums sums) -> SplitCandidate
+    {
+        // a new boosting round starts at the root, and the histograms of the previous round are stale
+        if (range.firstIndex == 0 && range.size == _dataset.NumExamples())
+        {
+            std::lock_guard<std::mutex> lock(_histogramsMutex);
+            _histograms.clear();
+        }
+
+        auto histogram = GetHistogram(range);
+
+        // find the best split of each feature in parallel, then pick the best one in feature order
+        auto numFeatures = _binThresholds.size();
+        std::vector<FeatureSplit> featureSplits(numFeatures);
+        ParallelFor(numFeatures, _firstBin.back(), [&](size_t featureIndex) { featureSplits[featureIndex] = GetBestSplitOfFeature(histogram, range, sums, featureIndex); });
+
+        SplitCandidate bestSplitCandidate(nodeId, range, sums);
+        for (size_t featureIndex = 0; featureIndex < numFeatures; ++featureIndex)
+        {
+            const auto& featureSplit = featureSplits[featureIndex];
+            if (featureSplit.gain > bestSplitCandidate.gain)
+            {
+                bestSplitCandidate.gain = featureSplit.gain;
+                bestSplitCandidate.splitRule = SplitRuleType{ featureIndex, _binThresholds[featureIndex][featureSplit.binIndex] };
+                bestSplitCandidate.ranges = NodeRanges(range);
+                bestSplitCandidate.ranges.SplitChildRange(0, featureSplit.size0);
+                bestSplitCandidate.stats.SetChildSums({ featureSplit.sums0, sums - featureSplit.sums0 });
+            }
+        }
+
+        // keep the histogram if the node may be split, so its children can be found by subtraction
+        if (bestSplitCandidate.gain > _parameters.minSplitGain)
+        {
+            StoreHistogram(range, std::move(histogram));
+        }
+        return bestSplitCandidate;
+    }
+
+    template <typename LossFunctionType, typename BoosterType>
+    auto BinnedForestTrainer<LossFunctionType, BoosterType>::GetBestSplitOfFeature(const Histogram& histogram, Range range, const Sums& sums, size_t featureIndex) const -> FeatureSplit
+    {
+        const auto& thresholds = _binThresholds[featureIndex];
+        auto featureHistogram = histogram.data() + _firstBin[featureIndex];
+
+        FeatureSplit bestFeatureSplit;
+        Sums sums0;
+        size_t size0 = 0;
+
+        // consider the threshold after each nonempty bin
+        for (size_t binIndex = 0; binIndex < thresholds.size(); ++binIndex)
+        {
+            const auto& bin = featureHistogram[binIndex];
+            if (bin.size == 0)
+            {
+                continue;
+            }
+
+            sums0 = sums0 + bin.sums;
+            size0 += bin.size;
+            if (size0 == range.size)
+            {
+                break;
+            }
+
+            // compute sums1 and gain
+            auto sums1 = sums - sums0;
+            double gain = CalculateGain(sums, sums0, sums1);
+
+            // find gain maximizer
+            if (gain > bestFeatureSplit.gain)
+            {
+                bestFeatureSplit.gain = gain;
+                bestFeatureSplit.binIndex = binIndex;
+                bestFeatureSplit.size0 = size0;
+                bestFeatureSplit.sums0 = sums0;
+            }
+        }
+        return bestFeatureSplit;
+    }
+
+    template <typename LossFunctionType, typename BoosterType>
+    auto BinnedForestTrainer<LossFunctionType, BoosterType>::GetEdgePredictors(const NodeStats& nodeStats) -> std::vector<EdgePredictorType>
+    {
+        double output = nodeStats.GetTotalSums().GetMeanLabel();
+        double output0 = nodeStats.GetChildSums(0).GetMeanLabel() - output;
+        double output1 = nodeStats.GetChildSums(1).GetMeanLabel() - output;
+        return std::vector<EdgePredictorType>{ output0, output1 };
+    }
+
+    template <typename LossFunctionType, typename BoosterType>
+    void BinnedForestTrainer<LossFunctionType, BoosterType>::SortNodeDataset(Range range, const SplitRuleType& splitRule)
+    {
+        auto parentHistogram = GetHistogram(range);
+
+        // the examples at or below the threshold are exactly those whose bin is at or below the threshold's bin
+        auto featureIndex = splitRule.GetElementIndex();
+        const auto& thresholds = _binThresholds[featureIndex];
+        auto splitBin = std::lower_bound(thresholds.begin(), thresholds.end(), splitRule.GetThreshold()) - thresholds.begin();
+        auto featureBins = _bins.data() + featureIndex * _dataset.NumExamples();
+
+        std::vector<bool> isChild1(range.size);
+        for (size_t index = 0; index < range.size; ++index)
+        {
+            isChild1[index] = featureBins[_rowIndices[range.firstIndex + index]] > splitBin;
+        }
+
+        // partition the examples and their rows, keeping the bins of each row with it
+        std::vector<TrainerExampleType> examples;
+        std::vector<size_t> rowIndices;
+        examples.reserve(range.size);
+        rowIndices.reserve(range.size);
+        for (bool child : { false, true })
+        {
+            for (size_t index = 0; index < range.size; ++index)
+            {
+                if (isChild1[index] == child)
+                {
+                    examples.push_back(std::move(_dataset[range.firstIndex + index]));
+                    rowIndices.push_back(_rowIndices[range.firstIndex + index]);
+                }
+            }
+        }
+
+        size_t size0 = std::count(isChild1.begin(), isChild1.end(), false);
+        for (size_t index = 0; index < range.size; ++index)
+        {
+            _dataset[range.firstIndex + index] = std::move(examples[index]);
+            _rowIndices[range.firstIndex + index] = rowIndices[index];
+        }
+
+        if (size0 == 0 || size0 == range.size)
+        {
+            return;
+        }
+
+        // scan the smaller child, and subtract its histogram from the parent's to get the larger child's
+        Range range0{ range.firstIndex, size0 };
+        Range range1{ range.firstIndex + size0, range.size - size0 };
+        const auto& smallerRange = size0 <= range.size - size0 ? range0 : range1;
+        const auto& largerRange = size0 <= range.size - size0 ? range1 : range0;
+
+        auto smallerHistogram = BuildHistogram(smallerRange);
+        auto& largerHistogram = parentHistogram;
+        for (size_t binIndex = 0; binIndex < largerHistogram.size(); ++binIndex)
+        {
+            largerHistogram[binIndex].sums = largerHistogram[binIndex].sums - smallerHistogram[binIndex].sums;
+            largerHistogram[binIndex].size -= smallerHistogram[binIndex].size;
+        }
+
+        StoreHistogram(smallerRange, std::move(smallerHistogram));
+        StoreHistogram(largerRange, std::move(largerHistogram));
+    }
+
+    template <typename LossFunctionType, typename BoosterType>
+    double BinnedForestTrainer<LossFunctionType, BoosterType>::CalculateGain(const Sums& sums, const Sums& sums0, const Sums& sums1) const
+    {
+        if (sums0.sumWeights == 0 || sums1.sumWeights == 0)
+        {
+            return 0;
+        }
+
+        return sums0.sumWeights * _lossFunction.BregmanGenerator(sums0.sumWeightedLabels / sums0.sumWeights) +
+               sums1.sumWeights * _lossFunction.BregmanGenerator(sums1.sumWeightedLabels / sums1.sumWeights) -
+               sums.sumWeights * _lossFunction.BregmanGenerator(sums.sumWeightedLabels / sums.sumWeights);
+    }
+
+    template <typename LossFunctionType, typename BoosterType>
+    std::unique_ptr<ITrainer<predictors::SimpleForestPredictor>> MakeBinnedForestTrainer(const LossFunctionType& lossFunction, const BoosterType& booster, const BinnedForestTrainerParameters& parameters)
+    {
+        return std::make_unique<BinnedForestTrainer<LossFunctionType, BoosterType>>(lossFunction, booster, parameters);
+    }
+}
+}
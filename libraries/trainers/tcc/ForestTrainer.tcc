@@ -15,7 +15,7 @@ namespace trainers
 {
     template <typename SplitRuleType, typename EdgePredictorType, typename BoosterType>
     ForestTrainer<SplitRuleType, EdgePredictorType, BoosterType>::ForestTrainer(const BoosterType& booster, const ForestTrainerParameters& parameters)
-        : _booster(booster), _parameters(parameters), _forest()
+        : _booster(booster), _parameters(parameters), _forest(), _threadPool(std::make_unique<utilities::ThreadPool>(parameters.numThreads))
     {
     }
 
@@ -164,13 +164,34 @@ namespace trainers
                 break;
             }
 
-            // queue new split candidates
+            // find the split candidates of the children, which have disjoint ranges, concurrently
+            std::vector<SplitCandidate> childSplitCandidates;
             for (size_t i = 0; i < splitCandidate.splitRule.NumOutputs(); ++i)
             {
-                auto splitCandidate = GetBestSplitRuleAtNode(_forest.GetChildId(interiorNodeIndex, i), ranges.GetChildRange(i), stats.GetChildSums(i));
-                if (splitCandidate.gain > _parameters.minSplitGain)
+                childSplitCandidates.emplace_back(_forest.GetChildId(interiorNodeIndex, i), ranges.GetChildRange(i), stats.GetChildSums(i));
+            }
+
+            auto findChildSplit = [&](size_t i) {
+                childSplitCandidates[i] = GetBestSplitRuleAtNode(childSplitCandidates[i].nodeId, ranges.GetChildRange(i), stats.GetChildSums(i));
+            };
+            if (CanSearchNodesConcurrently())
+            {
+                ParallelFor(childSplitCandidates.size(), ranges.GetTotalRange().size * _dataset.NumFeatures(), findChildSplit);
+            }
+            else
+            {
+                for (size_t i = 0; i < childSplitCandidates.size(); ++i)
+                {
+                    findChildSplit(i);
+                }
+            }
+
+            // queue new split candidates
+            for (auto& childSplitCandidate : childSplitCandidates)
+            {
+                if (childSplitCandidate.gain > _parameters.minSplitGain)
                 {
-                    _queue.push(std::move(splitCandidate));
+                    _queue.push(std::move(childSplitCandidate));
                 }
             }
         }
@@ -193,6 +214,24 @@ namespace trainers
         }
     }
 
+    template <typename SplitRuleType, typename EdgePredictorType, typename BoosterType>
+    void ForestTrainer<SplitRuleType, EdgePredictorType, BoosterType>::ParallelFor(size_t count, size_t work, const std::function<void(size_t)>& body) const
+    {
+        // below this many examples visited, the cost of waking the threads outweighs the work
+        const size_t minParallelWork = 1 << 14;
+        if (work < minParallelWork)
+        {
+            for (size_t index = 0; index < count; ++index)
+            {
+                body(index);
+            }
+        }
+        else
+        {
+            _threadPool->ParallelFor(count, body);
+        }
+    }
+
     //
     // debugging code
     //
@@ -26,12 +26,17 @@ namespace trainers
 
         auto splitRuleCandidates = CallThresholdFinder(range);
 
-        for (const auto& splitRuleCandidate : splitRuleCandidates)
+        // evaluate the candidates in parallel, then pick the best one in candidate order
+        std::vector<std::tuple<Sums, size_t>> evaluations(splitRuleCandidates.size());
+        ParallelFor(splitRuleCandidates.size(), range.size * splitRuleCandidates.size(), [&](size_t index) { evaluations[index] = EvaluateSplitRule(splitRuleCandidates[index], range); });
+
+        for (size_t index = 0; index < splitRuleCandidates.size(); ++index)
         {
+            const auto& splitRuleCandidate = splitRuleCandidates[index];
             Sums sums0;
             size_t size0;
 
-            std::tie(sums0, size0) = EvaluateSplitRule(splitRuleCandidate, range);
+            std::tie(sums0, size0) = evaluations[index];
 
             Sums sums1 = sums - sums0;
             double gain = CalculateGain(sums, sums0, sums1);
@@ -41,6 +46,7 @@ namespace trainers
             {
                 bestSplitCandidate.gain = gain;
                 bestSplitCandidate.splitRule = splitRuleCandidate;
+                bestSplitCandidate.ranges = NodeRanges(range);
                 bestSplitCandidate.ranges.SplitChildRange(0, size0);
                 bestSplitCandidate.stats.SetChildSums({ sums0, sums1 });
             }
@@ -11,15 +11,19 @@
 // utilities
 #include "RandomEngines.h"
 
+// stl
+#include <algorithm>
+
 namespace ell
 {
 namespace trainers
 {
     template<typename LossFunctionType, typename RegularizerType>
     SDCATrainer<LossFunctionType, RegularizerType>::SDCATrainer(const LossFunctionType& lossFunction, const RegularizerType& regularizer, const SDCATrainerParameters& parameters)
-    : _lossFunction(lossFunction), _regularizer(regularizer), _parameters(parameters)
+    : _lossFunction(lossFunction), _regularizer(regularizer), _parameters(parameters), _threadPool(std::make_unique<utilities::ThreadPool>(parameters.numThreads))
     {
         _random = utilities::GetRandomEngine(parameters.randomSeedString);
+        _threadStates.resize(_threadPool->NumThreads());
     }
 
     template<typename LossFunctionType, typename RegularizerType>
@@ -54,9 +58,16 @@ namespace trainers
         }
 
         // Iterate
-        for (size_t i = 0; i < _dataset.NumExamples(); ++i)
+        if (_threadPool->NumThreads() > 1)
         {
-            Step(_dataset[i]);
+            ParallelEpoch();
+        }
+        else
+        {
+            for (size_t i = 0; i < _dataset.NumExamples(); ++i)
+            {
+                Step(_dataset[i]);
+            }
         }
 
         // Finish
@@ -95,6 +106,80 @@ namespace trainers
         }
     }
 
+    template <typename LossFunctionType, typename RegularizerType>
+    void SDCATrainer<LossFunctionType, RegularizerType>::ParallelEpoch()
+    {
+        auto numExamples = _dataset.NumExamples();
+        auto numFeatures = _dataset.NumFeatures();
+        if (numFeatures > _predictor.Size())
+        {
+            _predictor.Resize(numFeatures);
+            _v.Resize(numFeatures);
+        }
+
+        auto numThreads = _threadStates.size();
+        auto syncInterval = std::max(_parameters.syncInterval, static_cast<size_t>(1));
+        for (size_t roundBegin = 0; roundBegin < numExamples; roundBegin += numThreads * syncInterval)
+        {
+            // each thread visits its own block of examples, starting from the synchronized state
+            _threadPool->ParallelFor(numThreads, [&](size_t threadIndex) {
+                auto& state = _threadStates[threadIndex];
+                state.v = _v;
+                state.d = _d;
+                state.predictor = _predictor;
+
+                auto begin = std::min(numExamples, roundBegin + threadIndex * syncInterval);
+                auto end = std::min(numExamples, begin + syncInterval);
+                for (auto i = begin; i < end; ++i)
+                {
+                    ParallelStep(_dataset[i], state, static_cast<double>(numThreads));
+                }
+            });
+
+            // synchronize: each thread moved its copy of v by numThreads times its share of the change
+            math::ColumnVector<double> v = _v;
+            double d = _d;
+            for (const auto& state : _threadStates)
+            {
+                v += (1.0 / numThreads) * state.v;
+                v += (-1.0 / numThreads) * _v;
+                d += (state.d - _d) / numThreads;
+            }
+            _v = std::move(v);
+            _d = d;
+            _regularizer.ConjugateGradient(_v, _d, _predictor.GetWeights(), _predictor.GetBias());
+        }
+    }
+
+    template <typename LossFunctionType, typename RegularizerType>
+    void SDCATrainer<LossFunctionType, RegularizerType>::ParallelStep(TrainerExampleType& example, ThreadState& state, double numThreads)
+    {
+        const auto& dataVector = example.GetDataVector();
+
+        auto weightLabel = example.GetMetadata().weightLabel;
+        auto norm2Squared = example.GetMetadata().norm2Squared + 1; // add one because of bias term
+
+        // the other threads' concurrent steps are accounted for by scaling up the curvature of this thread's subproblem
+        auto lipschitz = numThreads * norm2Squared * _inverseScaledRegularization;
+        auto dual = example.GetMetadata().dualVariable;
+
+        if (lipschitz > 0)
+        {
+            auto prediction = state.predictor.Predict(dataVector);
+
+            auto newDual = _lossFunction.ConjugateProx(1.0 / lipschitz, dual + prediction / lipschitz, weightLabel.label);
+            auto dualDiff = newDual - dual;
+
+            if (dualDiff != 0)
+            {
+                state.v.Transpose() += (-dualDiff * numThreads * _inverseScaledRegularization) * dataVector;
+                state.d += (-dualDiff * numThreads * _inverseScaledRegularization);
+                _regularizer.ConjugateGradient(state.v, state.d, state.predictor.GetWeights(), state.predictor.GetBias());
+                example.GetMetadata().dualVariable = newDual;
+            }
+        }
+    }
+
     template<typename LossFunctionType, typename RegularizerType>
     void SDCATrainer<LossFunctionType, RegularizerType>::ComputeObjectives()
     {
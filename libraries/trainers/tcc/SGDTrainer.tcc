@@ -7,8 +7,11 @@
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
 // stl
+#include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <cmath>
+#include <vector>
 
 // data
 #include "DataVector.h"
@@ -95,7 +98,7 @@ namespace trainers
 
     template<typename LossFunctionType>
     SparseDataSGDTrainer<LossFunctionType>::SparseDataSGDTrainer(const LossFunctionType& lossFunction, const SGDTrainerParameters& parameters)
-        : SGDTrainerBase(parameters.randomSeedString), _lossFunction(lossFunction), _parameters(parameters)
+        : SGDTrainerBase(parameters.randomSeedString), _lossFunction(lossFunction), _parameters(parameters), _threadPool(std::make_unique<utilities::ThreadPool>(parameters.numThreads))
     {
     }
 
@@ -133,6 +136,127 @@ namespace trainers
         _h += 1.0 / _t;
     }
 
+    template <typename LossFunctionType>
+    void SparseDataSGDTrainer<LossFunctionType>::DoNextSteps(size_t firstIndex)
+    {
+        if (_threadPool->NumThreads() == 1)
+        {
+            SGDTrainerBase::DoNextSteps(firstIndex);
+        }
+        else
+        {
+            DoNextStepsInParallel(firstIndex);
+        }
+    }
+
+    template <typename LossFunctionType>
+    void SparseDataSGDTrainer<LossFunctionType>::DoNextStepsInParallel(size_t firstIndex)
+    {
+        auto numExamples = _dataset.NumExamples();
+        if (firstIndex >= numExamples)
+        {
+            return;
+        }
+
+        auto numFeatures = _dataset.NumFeatures();
+        if (numFeatures > _v.Size())
+        {
+            _v.Resize(numFeatures);
+            _u.Resize(numFeatures);
+        }
+
+        // the weights shared by the threads
+        std::vector<std::atomic<double>> v(_v.Size());
+        std::vector<std::atomic<double>> u(_u.Size());
+        for (size_t j = 0; j < _v.Size(); ++j)
+        {
+            v[j] = _v[j];
+            u[j] = _u[j];
+        }
+        std::atomic<double> a(_a);
+
+        // step number _t + i + 1 is performed on example firstIndex + i, and harmonic[i] is the harmonic number of
+        // the steps before it, which is what the serial step calls _h
+        auto numSteps = numExamples - firstIndex;
+        std::vector<double> harmonic(numSteps + 1);
+        harmonic[0] = _h;
+        for (size_t i = 1; i <= numSteps; ++i)
+        {
+            harmonic[i] = harmonic[i - 1] + 1.0 / (_t + i);
+        }
+
+        // the steps are split into consecutive blocks, so that concurrent threads work on nearby steps. Each block
+        // keeps the sums that _a and _c are computed from after the epoch: the sum of g and the sum of g * harmonic[i]
+        const size_t blockSize = 256;
+        auto numBlocks = (numSteps + blockSize - 1) / blockSize;
+        std::vector<double> gradientSums(numBlocks, 0);
+        std::vector<double> harmonicGradientSums(numBlocks, 0);
+
+        const double lambda = _parameters.regularization;
+        _threadPool->ParallelFor(numBlocks, [&](size_t blockIndex) {
+            auto end = std::min(numSteps, (blockIndex + 1) * blockSize);
+            for (auto i = blockIndex * blockSize; i < end; ++i)
+            {
+                const auto& example = _dataset[firstIndex + i];
+                const auto& x = example.GetDataVector();
+                double y = example.GetMetadata().label;
+                double weight = example.GetMetadata().weight;
+
+                // apply the predictor
+                double d = 0;
+                x.template ForEachElement<data::IterationPolicy::skipZeros>([&v, &d](data::IndexValue indexValue) {
+                    d += indexValue.value * v[indexValue.index].load(std::memory_order_relaxed);
+                });
+                double t = _t + i + 1;
+                double p = -(d + a.load(std::memory_order_relaxed)) / (lambda * (t - 1.0));
+
+                // get the derivative
+                double g = weight * _lossFunction.GetDerivative(p, y);
+
+                // update
+                if (g != 0)
+                {
+                    double h = harmonic[i];
+                    x.template ForEachElement<data::IterationPolicy::skipZeros>([&v, &u, g, h](data::IndexValue indexValue) {
+                        AtomicAdd(v[indexValue.index], g * indexValue.value);
+                        AtomicAdd(u[indexValue.index], h * g * indexValue.value);
+                    });
+                    AtomicAdd(a, g);
+                }
+                gradientSums[blockIndex] += g;
+                harmonicGradientSums[blockIndex] += g * harmonic[i];
+            }
+        });
+
+        for (size_t j = 0; j < _v.Size(); ++j)
+        {
+            _v[j] = v[j];
+            _u[j] = u[j];
+        }
+
+        // _c is the sum of _a / t over the steps, and each step's g appears in _a from its own step onwards
+        double gradientSum = 0;
+        double harmonicGradientSum = 0;
+        for (size_t blockIndex = 0; blockIndex < numBlocks; ++blockIndex)
+        {
+            gradientSum += gradientSums[blockIndex];
+            harmonicGradientSum += harmonicGradientSums[blockIndex];
+        }
+        _c += _a * (harmonic[numSteps] - _h) + harmonic[numSteps] * gradientSum - harmonicGradientSum;
+        _a += gradientSum;
+        _h = harmonic[numSteps];
+        _t += numSteps;
+    }
+
+    template <typename LossFunctionType>
+    void SparseDataSGDTrainer<LossFunctionType>::AtomicAdd(std::atomic<double>& target, double value)
+    {
+        auto current = target.load(std::memory_order_relaxed);
+        while (!target.compare_exchange_weak(current, current + value, std::memory_order_relaxed))
+        {
+        }
+    }
+
     template<typename LossFunctionType>
     auto SparseDataSGDTrainer<LossFunctionType>::GetLastPredictor() const -> const PredictorType&
     {
@@ -6,6 +6,10 @@
 //
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
+// stl
+#include <algorithm>
+#include <utility>
+
 namespace ell
 {
 namespace trainers
@@ -23,45 +27,71 @@ namespace trainers
 
         SplitCandidate bestSplitCandidate(nodeId, range, sums);
 
+        // find the best split of each feature in parallel, then pick the best one in feature order
+        std::vector<FeatureSplit> featureSplits(numFeatures);
+        ParallelFor(numFeatures, range.size * numFeatures, [&](size_t inputIndex) { featureSplits[inputIndex] = GetBestSplitOfFeature(range, sums, inputIndex); });
+
         for (size_t inputIndex = 0; inputIndex < numFeatures; ++inputIndex)
         {
-            // sort the relevant rows of data set in ascending order by inputIndex
-            SortNodeDataset(range, inputIndex);
+            const auto& featureSplit = featureSplits[inputIndex];
+            if (featureSplit.gain > bestSplitCandidate.gain)
+            {
+                bestSplitCandidate.gain = featureSplit.gain;
+                bestSplitCandidate.splitRule = SplitRuleType{ inputIndex, featureSplit.threshold };
+                bestSplitCandidate.ranges = NodeRanges(range);
+                bestSplitCandidate.ranges.SplitChildRange(0, featureSplit.size0);
+                bestSplitCandidate.stats.SetChildSums({ featureSplit.sums0, sums - featureSplit.sums0 });
+            }
+        }
+        return bestSplitCandidate;
+    }
+
+    template <typename LossFunctionType, typename BoosterType>
+    auto SortingForestTrainer<LossFunctionType, BoosterType>::GetBestSplitOfFeature(Range range, const Sums& sums, size_t inputIndex) const -> FeatureSplit
+    {
+        // sort the feature values of the node's examples, with their weak weights and labels, in ascending order
+        std::vector<std::pair<double, data::WeightLabel>> values;
+        values.reserve(range.size);
+        for (size_t rowIndex = range.firstIndex; rowIndex < range.firstIndex + range.size; ++rowIndex)
+        {
+            const auto& example = _dataset[rowIndex];
+            values.emplace_back(example.GetDataVector()[inputIndex], example.GetMetadata().weak);
+        }
+        std::stable_sort(values.begin(), values.end(), [](const std::pair<double, data::WeightLabel>& a, const std::pair<double, data::WeightLabel>& b) { return a.first < b.first; });
+
+        FeatureSplit bestFeatureSplit;
+        Sums sums0;
+
+        // consider all thresholds
+        for (size_t index = 0; index + 1 < values.size(); ++index)
+        {
+            // get friendly names
+            double currentFeatureValue = values[index].first;
+            double nextFeatureValue = values[index + 1].first;
+
+            // increment sums
+            sums0.Increment(values[index].second);
+
+            // only split between rows with different feature values
+            if (currentFeatureValue == nextFeatureValue)
+            {
+                continue;
+            }
 
-            Sums sums0;
+            // compute sums1 and gain
+            auto sums1 = sums - sums0;
+            double gain = CalculateGain(sums, sums0, sums1);
 
-            // consider all thresholds
-            double nextFeatureValue = _dataset[range.firstIndex].GetDataVector()[inputIndex];
-            for (size_t rowIndex = range.firstIndex; rowIndex < range.firstIndex + range.size - 1; ++rowIndex)
+            // find gain maximizer
+            if (gain > bestFeatureSplit.gain)
             {
-                // get friendly names
-                double currentFeatureValue = nextFeatureValue;
-                nextFeatureValue = _dataset[rowIndex + 1].GetDataVector()[inputIndex];
-
-                // increment sums
-                sums0.Increment(_dataset[rowIndex].GetMetadata().weak);
-
-                // only split between rows with different feature values
-                if (currentFeatureValue == nextFeatureValue)
-                {
-                    continue;
-                }
-
-                // compute sums1 and gain
-                auto sums1 = sums - sums0;
-                double gain = CalculateGain(sums, sums0, sums1);
-
-                // find gain maximizer
-                if (gain > bestSplitCandidate.gain)
-                {
-                    bestSplitCandidate.gain = gain;
-                    bestSplitCandidate.splitRule = SplitRuleType{ inputIndex, 0.5 * (currentFeatureValue + nextFeatureValue) };
-                    bestSplitCandidate.ranges.SplitChildRange(0, rowIndex - range.firstIndex + 1);
-                    bestSplitCandidate.stats.SetChildSums({ sums0, sums1 });
-                }
+                bestFeatureSplit.gain = gain;
+                bestFeatureSplit.threshold = 0.5 * (currentFeatureValue + nextFeatureValue);
+                bestFeatureSplit.size0 = index + 1;
+                bestFeatureSplit.sums0 = sums0;
             }
         }
-        return bestSplitCandidate;
+        return bestFeatureSplit;
     }
 
     template <typename LossFunctionType, typename BoosterType>
@@ -73,14 +103,6 @@ namespace trainers
         return std::vector<EdgePredictorType>{ output0, output1 };
     }
 
-    template <typename LossFunctionType, typename BoosterType>
-    void SortingForestTrainer<LossFunctionType, BoosterType>::SortNodeDataset(Range range, size_t inputIndex)
-    {
-        _dataset.Sort([inputIndex](const data::Example<DataVectorType, TrainerMetadata>& example) { return example.GetDataVector()[inputIndex]; },
-                      range.firstIndex,
-                      range.size);
-    }
-
     template <typename LossFunctionType, typename BoosterType>
     double SortingForestTrainer<LossFunctionType, BoosterType>::CalculateGain(const Sums& sums, const Sums& sums0, const Sums& sums1) const
     {
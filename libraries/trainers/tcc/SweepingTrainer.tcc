@@ -11,8 +11,8 @@ namespace ell
 namespace trainers
 {
     template <typename PredictorType>
-    SweepingTrainer<PredictorType>::SweepingTrainer(std::vector<EvaluatingTrainerType>&& evaluatingTrainers)
-        : _evaluatingTrainers(std::move(evaluatingTrainers))
+    SweepingTrainer<PredictorType>::SweepingTrainer(std::vector<EvaluatingTrainerType>&& evaluatingTrainers, size_t numThreads)
+        : _evaluatingTrainers(std::move(evaluatingTrainers)), _threadPool(std::make_unique<utilities::ThreadPool>(numThreads))
     {
         assert(_evaluatingTrainers.size() > 0);
     }
@@ -20,16 +20,13 @@ namespace trainers
     template <typename PredictorType>
     void SweepingTrainer<PredictorType>::SetDataset(const data::AnyDataset& anyDataset)
     {
-        _dataset = data::Dataset<ExampleType>(anyDataset);
+        _threadPool->ParallelFor(_evaluatingTrainers.size(), [this, &anyDataset](size_t i) { _evaluatingTrainers[i].SetDataset(anyDataset); });
     }
 
     template <typename PredictorType>
     void SweepingTrainer<PredictorType>::Update()
     {
-        for (size_t i = 0; i < _evaluatingTrainers.size(); ++i)
-        {
-            _evaluatingTrainers[i].Update();
-        }
+        _threadPool->ParallelFor(_evaluatingTrainers.size(), [this](size_t i) { _evaluatingTrainers[i].Update(); });
     }
 
     template <typename PredictorType>
@@ -51,9 +48,9 @@ namespace trainers
     }
 
     template <typename PredictorType>
-    std::unique_ptr<ITrainer<PredictorType>> MakeSweepingTrainer(std::vector<EvaluatingTrainer<PredictorType>>&& evaluatingTrainers)
+    std::unique_ptr<ITrainer<PredictorType>> MakeSweepingTrainer(std::vector<EvaluatingTrainer<PredictorType>>&& evaluatingTrainers, size_t numThreads)
     {
-        return std::make_unique<SweepingTrainer<PredictorType>>(std::move(evaluatingTrainers));
+        return std::make_unique<SweepingTrainer<PredictorType>>(std::move(evaluatingTrainers), numThreads);
     }
 }
 }
@@ -13,14 +13,34 @@
 #include "Dataset.h"
 
 // trainers
+#include "BinnedForestTrainer.h"
+#include "EvaluatingTrainer.h"
+#include "HistogramForestTrainer.h"
+#include "L2Regularizer.h"
 #include "LogLoss.h"
+#include "LogitBooster.h"
 #include "MeanCalculator.h"
 #include "SDCATrainer.h"
+#include "SGDTrainer.h"
+#include "SortingForestTrainer.h"
 #include "SquaredLoss.h"
+#include "SweepingTrainer.h"
+#include "ThresholdFinder.h"
+
+// evaluators
+#include "BinaryErrorAggregator.h"
+#include "Evaluator.h"
 
 // utilities
 #include "testing.h"
 
+// stl
+#include <cmath>
+#include <functional>
+#include <memory>
+#include <random>
+#include <vector>
+
 using namespace ell;
 
 /// Runs all tests
@@ -120,6 +140,111 @@ void TestSGDTrainer()
     return;
 }
 
+// Makes a sparse classification dataset whose labels are a noisy function of a few features
+data::AutoSupervisedDataset MakeSparseLinearDataset(size_t numExamples, size_t numFeatures)
+{
+    std::default_random_engine engine(123);
+    std::uniform_int_distribution<size_t> featureDistribution(0, numFeatures - 1);
+    std::uniform_real_distribution<double> valueDistribution(0, 1);
+
+    data::AutoSupervisedDataset dataset;
+    for (size_t exampleIndex = 0; exampleIndex < numExamples; ++exampleIndex)
+    {
+        std::vector<double> values(numFeatures);
+        for (size_t i = 0; i < 5; ++i)
+        {
+            values[featureDistribution(engine)] = valueDistribution(engine);
+        }
+        double score = values[0] + values[1] - values[2] - values[3] + 0.1 * (valueDistribution(engine) - 0.5);
+        dataset.AddExample({ data::AutoDataVector(values), { 1.0, score > 0 ? 1.0 : -1.0 } });
+    }
+    return dataset;
+}
+
+double GetRegularizedLogLoss(const predictors::LinearPredictor<double>& predictor, const data::AutoSupervisedDataset& dataset, double regularization)
+{
+    functions::LogLoss lossFunction;
+    double loss = 0;
+    for (size_t i = 0; i < dataset.NumExamples(); ++i)
+    {
+        const auto& example = dataset[i];
+        loss += lossFunction(predictor.Predict(example.GetDataVector()), example.GetMetadata().label) / dataset.NumExamples();
+    }
+    return loss + regularization * functions::L2Regularizer()(predictor.GetWeights(), predictor.GetBias());
+}
+
+void TestParallelSDCATrainer()
+{
+    auto dataset = MakeSparseLinearDataset(2000, 100);
+    const double regularization = 1.0e-3;
+
+    std::vector<trainers::SDCAPredictorInfo> infos;
+    for (size_t numThreads : { 1, 4 })
+    {
+        trainers::SDCATrainerParameters parameters{ regularization, 1.0e-8, 50, true, "XYZ", numThreads, 50 };
+        trainers::SDCATrainer<functions::LogLoss, functions::L2Regularizer> trainer(functions::LogLoss(), functions::L2Regularizer(), parameters);
+        trainer.SetDataset(dataset.GetAnyDataset());
+        for (size_t epoch = 0; epoch < 50; ++epoch)
+        {
+            trainer.Update();
+        }
+        infos.push_back(trainer.GetPredictorInfo());
+    }
+
+    auto dualityGap = infos[1].primalObjective - infos[1].dualObjective;
+    testing::ProcessTest("TestParallelSDCATrainer duality gap", dualityGap >= 0 && dualityGap < 1.0e-4);
+    testing::ProcessTest("TestParallelSDCATrainer matches sequential trainer", std::abs(infos[1].primalObjective - infos[0].primalObjective) < 1.0e-4);
+}
+
+void TestParallelSparseDataSGDTrainer()
+{
+    auto dataset = MakeSparseLinearDataset(2000, 100);
+    const double regularization = 1.0e-3;
+
+    std::vector<double> objectives;
+    for (size_t numThreads : { 1, 4 })
+    {
+        auto trainer = trainers::MakeSparseDataSGDTrainer(functions::LogLoss(), { regularization, "XYZ", numThreads });
+        trainer->SetDataset(dataset.GetAnyDataset());
+        for (size_t epoch = 0; epoch < 20; ++epoch)
+        {
+            trainer->Update();
+        }
+        objectives.push_back(GetRegularizedLogLoss(trainer->GetPredictor(), dataset, regularization));
+    }
+
+    // the sequential objective is close to optimal; Hogwild updates may lose a little, but not much
+    testing::ProcessTest("TestParallelSparseDataSGDTrainer matches sequential trainer", std::abs(objectives[1] - objectives[0]) < 0.01 * objectives[0]);
+}
+
+void TestSweepingTrainer()
+{
+    auto dataset = MakeSparseLinearDataset(500, 20);
+
+    std::vector<predictors::LinearPredictor<double>> predictors;
+    for (size_t numThreads : { 1, 3 })
+    {
+        std::vector<trainers::EvaluatingTrainer<predictors::LinearPredictor<double>>> evaluatingTrainers;
+        for (double regularization : { 1.0e-1, 1.0e-2, 1.0e-3 })
+        {
+            auto trainer = trainers::MakeSparseDataSGDTrainer(functions::LogLoss(), { regularization, "XYZ" });
+            auto evaluator = evaluators::MakeEvaluator<predictors::LinearPredictor<double>>(dataset.GetAnyDataset(), { 1, false }, evaluators::BinaryErrorAggregator());
+            evaluatingTrainers.push_back(trainers::MakeEvaluatingTrainer(std::move(trainer), evaluator));
+        }
+
+        auto sweepingTrainer = trainers::MakeSweepingTrainer(std::move(evaluatingTrainers), numThreads);
+        sweepingTrainer->SetDataset(dataset.GetAnyDataset());
+        for (size_t epoch = 0; epoch < 3; ++epoch)
+        {
+            sweepingTrainer->Update();
+        }
+        predictors.push_back(sweepingTrainer->GetPredictor());
+    }
+
+    testing::ProcessTest("TestSweepingTrainer trains the internal trainers", predictors[0].Size() == dataset.NumFeatures());
+    testing::ProcessTest("TestSweepingTrainer with threads", predictors[0].GetWeights() == predictors[1].GetWeights() && predictors[0].GetBias() == predictors[1].GetBias());
+}
+
 void TestMeanCalculator()
 {
     data::AutoSupervisedDataset dataset;
@@ -134,9 +259,143 @@ void TestMeanCalculator()
     testing::ProcessTest("TestMeanCalculator", mean == r);
 }
 
+void TestBinnedForestTrainer()
+{
+    // a dataset with fewer distinct values per feature than bins, so the binned trainer should grow the same forest as the sorting trainer
+    data::AutoSupervisedDataset dataset;
+    for (size_t i = 0; i < 60; ++i)
+    {
+        double x0 = static_cast<double>(i % 10) + 1.0;
+        double x1 = static_cast<double>((i * 7) % 13) + 1.0;
+        double x2 = 0.5 * static_cast<double>((i * 3) % 11) + 1.0;
+        double label = (x0 > 5.0 && x1 + x2 > 6.0) ? 1.0 : -1.0;
+        dataset.AddExample({ { x0, x1, x2 }, { 1.0, label } });
+    }
+
+    trainers::SortingForestTrainerParameters sortingParameters;
+    trainers::BinnedForestTrainerParameters binnedParameters;
+    for (trainers::ForestTrainerParameters* parameters : { static_cast<trainers::ForestTrainerParameters*>(&sortingParameters), static_cast<trainers::ForestTrainerParameters*>(&binnedParameters) })
+    {
+        parameters->minSplitGain = 0.0;
+        parameters->maxSplitsPerRound = 6;
+        parameters->numRounds = 3;
+    }
+
+    auto sortingTrainer = trainers::MakeSortingForestTrainer(functions::SquaredLoss(), trainers::LogitBooster(), sortingParameters);
+    auto binnedTrainer = trainers::MakeBinnedForestTrainer(functions::SquaredLoss(), trainers::LogitBooster(), binnedParameters);
+    sortingTrainer->SetDataset(dataset.GetAnyDataset());
+    binnedTrainer->SetDataset(dataset.GetAnyDataset());
+    sortingTrainer->Update();
+    binnedTrainer->Update();
+
+    const auto& sortingForest = sortingTrainer->GetPredictor();
+    const auto& binnedForest = binnedTrainer->GetPredictor();
+    bool samePredictions = binnedForest.NumInteriorNodes() == sortingForest.NumInteriorNodes();
+    for (size_t i = 0; i < dataset.NumExamples(); ++i)
+    {
+        auto dataVector = dataset[i].GetDataVector().CopyAs<data::FloatDataVector>();
+        samePredictions = samePredictions && std::abs(binnedForest.Predict(dataVector) - sortingForest.Predict(dataVector)) < 1.0e-8;
+    }
+    testing::ProcessTest("TestBinnedForestTrainer, same forest as sorting trainer", samePredictions);
+
+    // with fewer bins than distinct values, the binned trainer still fits the training data
+    binnedParameters.maxBinsPerFeature = 4;
+    auto coarseTrainer = trainers::MakeBinnedForestTrainer(functions::SquaredLoss(), trainers::LogitBooster(), binnedParameters);
+    coarseTrainer->SetDataset(dataset.GetAnyDataset());
+    coarseTrainer->Update();
+
+    size_t numErrors = 0;
+    for (size_t i = 0; i < dataset.NumExamples(); ++i)
+    {
+        auto dataVector = dataset[i].GetDataVector().CopyAs<data::FloatDataVector>();
+        if (coarseTrainer->GetPredictor().Predict(dataVector) * dataset[i].GetMetadata().label <= 0)
+        {
+            ++numErrors;
+        }
+    }
+    printf("TestBinnedForestTrainer training errors with 4 bins: %zu of %zu\n", numErrors, dataset.NumExamples());
+    testing::ProcessTest("TestBinnedForestTrainer, coarse bins fit the training data", numErrors < dataset.NumExamples() / 5);
+}
+
+void TestForestTrainerThreads()
+{
+    // a dataset large enough that the trainers split their work across threads
+    std::default_random_engine engine(123);
+    std::uniform_real_distribution<double> distribution(-1.0, 1.0);
+    data::AutoSupervisedDataset dataset;
+    for (size_t i = 0; i < 3000; ++i)
+    {
+        std::vector<double> values(8);
+        for (auto& value : values)
+        {
+            value = distribution(engine);
+        }
+        double label = values[0] * values[1] + 0.5 * values[2] > 0 ? 1.0 : -1.0;
+        dataset.AddExample({ data::AutoDataVector(values), { 1.0, label } });
+    }
+
+    using TrainerFactory = std::function<std::unique_ptr<trainers::ITrainer<predictors::SimpleForestPredictor>>(size_t numThreads)>;
+    auto testTrainer = [&dataset](const std::string& name, const TrainerFactory& makeTrainer) {
+        std::vector<double> serialPredictions;
+        for (size_t numThreads : { 1, 4 })
+        {
+            auto trainer = makeTrainer(numThreads);
+            trainer->SetDataset(dataset.GetAnyDataset());
+            trainer->Update();
+
+            std::vector<double> predictions;
+            for (size_t i = 0; i < dataset.NumExamples(); ++i)
+            {
+                predictions.push_back(trainer->GetPredictor().Predict(dataset[i].GetDataVector().CopyAs<data::FloatDataVector>()));
+            }
+
+            if (numThreads == 1)
+            {
+                serialPredictions = predictions;
+            }
+            else
+            {
+                testing::ProcessTest("TestForestTrainerThreads, " + name + " forest doesn't depend on the number of threads", predictions == serialPredictions);
+            }
+        }
+    };
+
+    testTrainer("sorting", [](size_t numThreads) {
+        trainers::SortingForestTrainerParameters parameters;
+        parameters.maxSplitsPerRound = 20;
+        parameters.numRounds = 2;
+        parameters.numThreads = numThreads;
+        return trainers::MakeSortingForestTrainer(functions::SquaredLoss(), trainers::LogitBooster(), parameters);
+    });
+
+    testTrainer("histogram", [](size_t numThreads) {
+        trainers::HistogramForestTrainerParameters parameters;
+        parameters.maxSplitsPerRound = 20;
+        parameters.numRounds = 2;
+        parameters.numThreads = numThreads;
+        parameters.randomSeed = "123";
+        parameters.thresholdFinderSampleSize = 100;
+        parameters.candidatesPerInput = 8;
+        return trainers::MakeHistogramForestTrainer(functions::SquaredLoss(), trainers::LogitBooster(), trainers::ExhaustiveThresholdFinder(), parameters);
+    });
+
+    testTrainer("binned", [](size_t numThreads) {
+        trainers::BinnedForestTrainerParameters parameters;
+        parameters.maxSplitsPerRound = 20;
+        parameters.numRounds = 2;
+        parameters.numThreads = numThreads;
+        return trainers::MakeBinnedForestTrainer(functions::SquaredLoss(), trainers::LogitBooster(), parameters);
+    });
+}
+
 int main()
 {
     TestSDCATrainer();
     TestSGDTrainer();
+    TestParallelSDCATrainer();
+    TestParallelSparseDataSGDTrainer();
+    TestSweepingTrainer();
     TestMeanCalculator();
+    TestBinnedForestTrainer();
+    TestForestTrainerThreads();
 }
@@ -0,0 +1,60 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     MemoryMappedFile.h (utilities)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+// stl
+#include <cstddef>
+#include <string>
+
+namespace ell
+{
+namespace utilities
+{
+    /// <summary>
+    /// A read-only view of the contents of a file, mapped into memory. The pages are loaded on demand and are
+    /// shared with other processes that map the same file.
+    /// </summary>
+    class MemoryMappedFile
+    {
+    public:
+        /// <summary> Maps a file into memory. </summary>
+        ///
+        /// <param name="filepath"> The path of the file. </param>
+        MemoryMappedFile(const std::string& filepath);
+
+        MemoryMappedFile(MemoryMappedFile&& other);
+        MemoryMappedFile(const MemoryMappedFile&) = delete;
+        MemoryMappedFile& operator=(MemoryMappedFile&& other);
+        MemoryMappedFile& operator=(const MemoryMappedFile&) = delete;
+
+        /// <summary> Unmaps the file. </summary>
+        ~MemoryMappedFile();
+
+        /// <summary> Gets a pointer to the contents of the file. </summary>
+        ///
+        /// <returns> A pointer to the first byte of the file, or nullptr if the file is empty. </returns>
+        const char* GetData() const { return _data; }
+
+        /// <summary> Gets the size of the file. </summary>
+        ///
+        /// <returns> The size of the file, in bytes. </returns>
+        size_t Size() const { return _size; }
+
+    private:
+        void Unmap();
+
+        const char* _data = nullptr;
+        size_t _size = 0;
+#ifdef WIN32
+        void* _fileHandle = nullptr;
+        void* _mappingHandle = nullptr;
+#endif
+    };
+}
+}
@@ -0,0 +1,89 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     ThreadPool.h (utilities)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+// stl
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ell
+{
+namespace utilities
+{
+    /// <summary>
+    /// A fixed set of worker threads that run the iterations of parallel loops. Idle workers take iterations from the
+    /// most recently started loop, so a loop started from inside another loop's iteration is finished before its
+    /// parent takes more threads. The thread that starts a loop also runs its iterations, so loops may be nested
+    /// without deadlock, and a pool with one thread runs everything on the calling thread.
+    /// </summary>
+    class ThreadPool
+    {
+    public:
+        /// <summary> Constructor </summary>
+        ///
+        /// <param name="numThreads"> The number of threads that run loop iterations, including the thread that starts
+        /// the loop. 0 means the number of hardware threads. </param>
+        ThreadPool(size_t numThreads);
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        /// <summary> Destructor. Waits for the workers to finish their current iterations. </summary>
+        ~ThreadPool();
+
+        /// <summary> Gets the number of threads that run loop iterations, including the calling thread. </summary>
+        ///
+        /// <returns> The number of threads. </returns>
+        size_t NumThreads() const { return _workers.size() + 1; }
+
+        /// <summary>
+        /// Calls `body(index)` for each index in [0, count), in parallel, and returns when all the calls have
+        /// returned. The order of the calls is unspecified, so callers that reduce results should write them into
+        /// per-index slots and combine them in index order afterwards. If any call throws, the first exception is
+        /// rethrown here.
+        /// </summary>
+        ///
+        /// <param name="count"> The number of iterations. </param>
+        /// <param name="body"> The loop body. </param>
+        void ParallelFor(size_t count, const std::function<void(size_t)>& body);
+
+    private:
+        struct Loop
+        {
+            Loop(size_t count, const std::function<void(size_t)>& body);
+            bool RunIteration();
+
+            const size_t count;
+            const std::function<void(size_t)>& body;
+            std::atomic<size_t> nextIndex;
+            std::atomic<size_t> numFinished;
+            std::mutex mutex;
+            std::condition_variable finished;
+            std::exception_ptr exception;
+        };
+
+        void WorkerLoop();
+        std::shared_ptr<Loop> GetLoop();
+        void RemoveLoop(const std::shared_ptr<Loop>& loop);
+
+        std::vector<std::thread> _workers;
+        std::vector<std::shared_ptr<Loop>> _loops;
+        std::mutex _mutex;
+        std::condition_variable _loopAdded;
+        bool _stop = false;
+    };
+}
+}
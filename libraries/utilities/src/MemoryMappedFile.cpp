@@ -0,0 +1,146 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     MemoryMappedFile.cpp (utilities)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "MemoryMappedFile.h"
+#include "Exception.h"
+
+// stl
+#include <utility>
+
+#ifdef WIN32
+#include <codecvt>
+#include <locale>
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace ell
+{
+namespace utilities
+{
+    MemoryMappedFile::MemoryMappedFile(const std::string& filepath)
+    {
+#ifdef WIN32
+        std::wstring_convert<std::codecvt_utf8<wchar_t>, wchar_t> converter;
+        std::wstring wide_path = converter.from_bytes(filepath);
+        HANDLE fileHandle = CreateFileW(wide_path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (fileHandle == INVALID_HANDLE_VALUE)
+        {
+            throw InputException(InputExceptionErrors::invalidArgument, "error opening file " + filepath);
+        }
+        _fileHandle = fileHandle;
+
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(fileHandle, &size))
+        {
+            Unmap();
+            throw InputException(InputExceptionErrors::invalidArgument, "error getting the size of file " + filepath);
+        }
+        _size = static_cast<size_t>(size.QuadPart);
+
+        // an empty file can't be mapped
+        if (_size > 0)
+        {
+            _mappingHandle = CreateFileMappingW(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            if (_mappingHandle != nullptr)
+            {
+                _data = static_cast<const char*>(MapViewOfFile(_mappingHandle, FILE_MAP_READ, 0, 0, 0));
+            }
+            if (_data == nullptr)
+            {
+                Unmap();
+                throw InputException(InputExceptionErrors::invalidArgument, "error mapping file " + filepath);
+            }
+        }
+#else
+        int fileDescriptor = open(filepath.c_str(), O_RDONLY);
+        if (fileDescriptor == -1)
+        {
+            throw InputException(InputExceptionErrors::invalidArgument, "error opening file " + filepath);
+        }
+
+        struct stat buf;
+        if (fstat(fileDescriptor, &buf) == -1)
+        {
+            close(fileDescriptor);
+            throw InputException(InputExceptionErrors::invalidArgument, "error getting the size of file " + filepath);
+        }
+        _size = static_cast<size_t>(buf.st_size);
+
+        // an empty file can't be mapped; the mapping stays valid after the file is closed
+        if (_size > 0)
+        {
+            void* data = mmap(nullptr, _size, PROT_READ, MAP_SHARED, fileDescriptor, 0);
+            if (data == MAP_FAILED)
+            {
+                close(fileDescriptor);
+                throw InputException(InputExceptionErrors::invalidArgument, "error mapping file " + filepath);
+            }
+            _data = static_cast<const char*>(data);
+        }
+        close(fileDescriptor);
+#endif
+    }
+
+    MemoryMappedFile::MemoryMappedFile(MemoryMappedFile&& other)
+    {
+        *this = std::move(other);
+    }
+
+    MemoryMappedFile& MemoryMappedFile::operator=(MemoryMappedFile&& other)
+    {
+        if (this != &other)
+        {
+            Unmap();
+            std::swap(_data, other._data);
+            std::swap(_size, other._size);
+#ifdef WIN32
+            std::swap(_fileHandle, other._fileHandle);
+            std::swap(_mappingHandle, other._mappingHandle);
+#endif
+        }
+        return *this;
+    }
+
+    MemoryMappedFile::~MemoryMappedFile()
+    {
+        Unmap();
+    }
+
+    void MemoryMappedFile::Unmap()
+    {
+#ifdef WIN32
+        if (_data != nullptr)
+        {
+            UnmapViewOfFile(_data);
+        }
+        if (_mappingHandle != nullptr)
+        {
+            CloseHandle(_mappingHandle);
+        }
+        if (_fileHandle != nullptr)
+        {
+            CloseHandle(_fileHandle);
+        }
+        _fileHandle = nullptr;
+        _mappingHandle = nullptr;
+#else
+        if (_data != nullptr)
+        {
+            munmap(const_cast<char*>(_data), _size);
+        }
+#endif
+        _data = nullptr;
+        _size = 0;
+    }
+}
+}
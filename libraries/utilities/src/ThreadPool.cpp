@@ -0,0 +1,158 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     ThreadPool.cpp (utilities)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "ThreadPool.h"
+
+// stl
+#include <algorithm>
+
+namespace ell
+{
+namespace utilities
+{
+    //
+    // Loop
+    //
+    ThreadPool::Loop::Loop(size_t count, const std::function<void(size_t)>& body)
+        : count(count), body(body), nextIndex(0), numFinished(0)
+    {
+    }
+
+    bool ThreadPool::Loop::RunIteration()
+    {
+        auto index = nextIndex++;
+        if (index >= count)
+        {
+            return false;
+        }
+
+        try
+        {
+            body(index);
+        }
+        catch (...)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!exception)
+            {
+                exception = std::current_exception();
+            }
+        }
+
+        if (++numFinished == count)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            finished.notify_all();
+        }
+        return true;
+    }
+
+    //
+    // ThreadPool
+    //
+    ThreadPool::ThreadPool(size_t numThreads)
+    {
+        if (numThreads == 0)
+        {
+            numThreads = std::max(std::thread::hardware_concurrency(), 1u);
+        }
+
+        for (size_t index = 1; index < numThreads; ++index)
+        {
+            _workers.emplace_back([this]() { WorkerLoop(); });
+        }
+    }
+
+    ThreadPool::~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _stop = true;
+        }
+        _loopAdded.notify_all();
+
+        for (auto& worker : _workers)
+        {
+            worker.join();
+        }
+    }
+
+    void ThreadPool::ParallelFor(size_t count, const std::function<void(size_t)>& body)
+    {
+        if (_workers.empty() || count <= 1)
+        {
+            for (size_t index = 0; index < count; ++index)
+            {
+                body(index);
+            }
+            return;
+        }
+
+        auto loop = std::make_shared<Loop>(count, body);
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _loops.push_back(loop);
+        }
+        _loopAdded.notify_all();
+
+        while (loop->RunIteration())
+        {
+        }
+        RemoveLoop(loop);
+
+        // the remaining iterations are running on workers
+        {
+            std::unique_lock<std::mutex> lock(loop->mutex);
+            loop->finished.wait(lock, [&loop]() { return loop->numFinished == loop->count; });
+        }
+
+        if (loop->exception)
+        {
+            std::rethrow_exception(loop->exception);
+        }
+    }
+
+    void ThreadPool::WorkerLoop()
+    {
+        while (true)
+        {
+            auto loop = GetLoop();
+            if (!loop)
+            {
+                return;
+            }
+
+            while (loop->RunIteration())
+            {
+            }
+            RemoveLoop(loop);
+        }
+    }
+
+    std::shared_ptr<ThreadPool::Loop> ThreadPool::GetLoop()
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _loopAdded.wait(lock, [this]() { return _stop || !_loops.empty(); });
+        if (_stop)
+        {
+            return nullptr;
+        }
+        return _loops.back();
+    }
+
+    void ThreadPool::RemoveLoop(const std::shared_ptr<Loop>& loop)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto iter = std::find(_loops.begin(), _loops.end(), loop);
+        if (iter != _loops.end())
+        {
+            _loops.erase(iter);
+        }
+    }
+}
+}
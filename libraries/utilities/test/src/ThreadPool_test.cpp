@@ -0,0 +1,87 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     ThreadPool_test.cpp (utilities)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "ThreadPool_test.h"
+
+// utilities
+#include "Exception.h"
+#include "ThreadPool.h"
+
+// testing
+#include "testing.h"
+
+// stl
+#include <atomic>
+#include <vector>
+
+namespace ell
+{
+using namespace utilities;
+
+void TestThreadPoolParallelFor()
+{
+    for (size_t numThreads : { 1, 2, 4 })
+    {
+        ThreadPool pool(numThreads);
+        std::vector<int> counts(1000, 0);
+        pool.ParallelFor(counts.size(), [&counts](size_t index) { ++counts[index]; });
+
+        bool eachOnce = true;
+        for (auto count : counts)
+        {
+            eachOnce = eachOnce && count == 1;
+        }
+        testing::ProcessTest("ThreadPool::ParallelFor runs each iteration once", eachOnce);
+    }
+}
+
+void TestThreadPoolNestedParallelFor()
+{
+    ThreadPool pool(4);
+    const size_t outerCount = 8;
+    const size_t innerCount = 100;
+    std::vector<size_t> sums(outerCount, 0);
+    pool.ParallelFor(outerCount, [&pool, &sums, innerCount](size_t outerIndex) {
+        std::vector<size_t> values(innerCount);
+        pool.ParallelFor(innerCount, [&values, outerIndex](size_t innerIndex) { values[innerIndex] = outerIndex * innerIndex; });
+        for (auto value : values)
+        {
+            sums[outerIndex] += value;
+        }
+    });
+
+    bool correctSums = true;
+    for (size_t outerIndex = 0; outerIndex < outerCount; ++outerIndex)
+    {
+        correctSums = correctSums && sums[outerIndex] == outerIndex * innerCount * (innerCount - 1) / 2;
+    }
+    testing::ProcessTest("ThreadPool::ParallelFor nested", correctSums);
+}
+
+void TestThreadPoolException()
+{
+    ThreadPool pool(4);
+    std::atomic<size_t> numCalls(0);
+    bool threw = false;
+    try
+    {
+        pool.ParallelFor(100, [&numCalls](size_t index) {
+            ++numCalls;
+            if (index == 17)
+            {
+                throw InputException(InputExceptionErrors::invalidArgument);
+            }
+        });
+    }
+    catch (const InputException&)
+    {
+        threw = true;
+    }
+    testing::ProcessTest("ThreadPool::ParallelFor rethrows exceptions", threw && numCalls == 100);
+}
+}
@@ -16,6 +16,7 @@
 #include "TypeName_test.h"
 #include "Variant_test.h"
 #include "Files_test.h"
+#include "ThreadPool_test.h"
 #include "Files.h"
 
 // testing
@@ -100,6 +101,11 @@ int main(int argc, char* argv[])
 
         // PropertyBag tests
         TestPropertyBag();
+
+        // ThreadPool tests
+        TestThreadPoolParallelFor();
+        TestThreadPoolNestedParallelFor();
+        TestThreadPoolException();
     }
     catch (const utilities::Exception& exception)
     {
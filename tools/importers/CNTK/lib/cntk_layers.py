@@ -412,9 +412,11 @@ class ConvolutionLayer(BaseLayer):
         pad = self.attributes['autoPadding'][0] or (
             self.attributes['autoPadding'][1] and self.attributes['autoPadding'][2])
         bias = (self.bias_parameter is not None)
+        # Grouped (e.g. depthwise) convolutions have weights for only the input channels in each group
+        groups = self.input_shape[0] // weightsShape[1]
 
         layer = Convolution((weightsShape[2], weightsShape[3]), weightsShape[0],
-                            pad=pad, activation=activation, bias=bias)(feature)
+                            pad=pad, activation=activation, bias=bias, groups=groups)(feature)
 
         layer.parameters[0].value = self.weights_parameter.value
         if bias:
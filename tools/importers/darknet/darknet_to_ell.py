@@ -299,13 +299,18 @@ def process_convolutional_layer(layer, bin_data, convolution_order):
     variance_vals = np.array(variance_vals, dtype=np.float)
     # now we can load the convolutional weights
     weight_vals = []
-    num_weights = int(layer['size'])*int(layer['size'])*int(layer['c'])*int(layer['filters'])
+    # Grouped (e.g. depthwise) convolutions have weights for only the input channels in each group
+    groups = int(layer.get('groups', 1))
+    channels_per_group = int(layer['c']) // groups
+    if groups > 1 and 'xnor' in layer:
+        raise Exception("Binary convolutional layers with groups are not supported")
+    num_weights = int(layer['size'])*int(layer['size'])*channels_per_group*int(layer['filters'])
     for i in range(num_weights):
         weight_vals.append(struct.unpack('f', bin_data.read(4)))
     weight_vals = np.array(weight_vals, dtype=np.float)
 
     layerParameters = create_layer_parameters(layer['inputShape'], layer['inputPadding'], layer['inputPaddingScheme'], layer['outputShapeMinusPadding'], 0, ell.neural.PaddingScheme.zeros)
-    convolutionWeightsTensor = get_weights_tensor((int(layer['filters']), layer['c'], int(layer["size"]), int(layer["size"])), weight_vals)
+    convolutionWeightsTensor = get_weights_tensor((int(layer['filters']), channels_per_group, int(layer["size"]), int(layer["size"])), weight_vals)
 
     # Create the appropriate convolutional layer
     if 'xnor' not in layer:
@@ -55,5 +55,11 @@ namespace ell
             "seed",
             "The random seed string",
             "ABCDEFG");
+
+        parser.AddOption(numThreads,
+            "numThreads",
+            "nt",
+            "The number of threads used by the SparseDataSGD and SDCA algorithms (0 means the number of hardware threads)",
+            1);
     }
 }
@@ -0,0 +1,33 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     SweepingSGDTrainerArguments.h (sweepingSGDTrainer)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+// utilities
+#include "CommandLineParser.h"
+
+// stl
+#include <cstddef>
+
+namespace ell
+{
+/// <summary> Arguments for the sweeping SGD trainer. </summary>
+struct SweepingSGDTrainerArguments
+{
+    size_t numThreads;
+};
+
+/// <summary> Parsed version of SweepingSGDTrainerArguments. </summary>
+struct ParsedSweepingSGDTrainerArguments : public SweepingSGDTrainerArguments, public utilities::ParsedArgSet
+{
+    /// <summary> Adds the arguments to the command line parser. </summary>
+    ///
+    /// <param name="parser"> [in,out] The command line parser. </param>
+    void AddArgs(utilities::CommandLineParser& parser) override;
+};
+}
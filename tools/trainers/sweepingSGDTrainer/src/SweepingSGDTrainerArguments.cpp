@@ -0,0 +1,21 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     SweepingSGDTrainerArguments.cpp (sweepingSGDTrainer)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "SweepingSGDTrainerArguments.h"
+
+namespace ell
+{
+    void ParsedSweepingSGDTrainerArguments::AddArgs(utilities::CommandLineParser& parser)
+    {
+        parser.AddOption(numThreads,
+            "numThreads",
+            "nt",
+            "The number of threads that train the swept predictors concurrently (0 means the number of hardware threads)",
+            1);
+    }
+}
@@ -0,0 +1,34 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     BinaryDatasetConverterArguments.h (binaryDatasetConverter)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+// utilities
+#include "CommandLineParser.h"
+
+// stl
+#include <string>
+
+namespace ell
+{
+/// <summary> Command line arguments for the binaryDatasetConverter executable. </summary>
+struct BinaryDatasetConverterArguments
+{
+    /// <summary> The binary dataset file to write. If empty, the name of the input file with a ".bin" extension is used. </summary>
+    std::string outputDataFilename;
+};
+
+/// <summary> Parsed command line arguments for the binaryDatasetConverter executable. </summary>
+struct ParsedBinaryDatasetConverterArguments : public BinaryDatasetConverterArguments, public utilities::ParsedArgSet
+{
+    /// <summary> Adds the arguments to the command line parser. </summary>
+    ///
+    /// <param name="parser"> [in,out] The parser. </param>
+    void AddArgs(utilities::CommandLineParser& parser) override;
+};
+}
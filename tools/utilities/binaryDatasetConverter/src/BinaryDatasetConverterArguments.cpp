@@ -0,0 +1,22 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     BinaryDatasetConverterArguments.cpp (binaryDatasetConverter)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "BinaryDatasetConverterArguments.h"
+
+namespace ell
+{
+void ParsedBinaryDatasetConverterArguments::AddArgs(utilities::CommandLineParser& parser)
+{
+    parser.AddOption(
+        outputDataFilename,
+        "outputDataFilename",
+        "odf",
+        "Path to the output binary dataset file. Defaults to the input file's name with a '.bin' extension.",
+        "");
+}
+}
@@ -0,0 +1,95 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     main.cpp (binaryDatasetConverter)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "BinaryDatasetConverterArguments.h"
+
+// utilities
+#include "CommandLineParser.h"
+#include "Exception.h"
+#include "Files.h"
+
+// common
+#include "DataLoadArguments.h"
+#include "DataLoaders.h"
+
+// data
+#include "MappedDataset.h"
+
+// stl
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+using namespace ell;
+
+int main(int argc, char* argv[])
+{
+    try
+    {
+        // create a command line parser
+        utilities::CommandLineParser commandLineParser(argc, argv);
+
+        // add arguments to the command line parser
+        common::ParsedDataLoadArguments dataLoadArguments;
+        ParsedBinaryDatasetConverterArguments converterArguments;
+
+        commandLineParser.AddOptionSet(dataLoadArguments);
+        commandLineParser.AddOptionSet(converterArguments);
+
+        // parse command line
+        commandLineParser.Parse();
+
+        // if no input specified, print help and exit
+        if (dataLoadArguments.inputDataFilename.empty())
+        {
+            std::cout << commandLineParser.GetHelpString() << std::endl;
+            return 0;
+        }
+
+        auto outputFilename = converterArguments.outputDataFilename;
+        if (outputFilename.empty())
+        {
+            outputFilename = utilities::RemoveFileExtension(dataLoadArguments.inputDataFilename) + ".bin";
+        }
+
+        // stream the text examples into the binary file, one at a time
+        auto inputStream = utilities::OpenIfstream(dataLoadArguments.inputDataFilename);
+        std::ofstream outputStream(outputFilename, std::ios::binary);
+        if (!outputStream)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "error opening file " + outputFilename);
+        }
+        data::WriteMappedDataset(common::GetAutoSupervisedExampleIterator(inputStream), outputStream);
+        outputStream.close();
+
+        data::MappedDataset dataset(outputFilename);
+        std::cout << "Wrote " << dataset.NumExamples() << " examples with " << dataset.NumFeatures() << " features to " << outputFilename << std::endl;
+    }
+    catch (const utilities::CommandLineParserPrintHelpException& exception)
+    {
+        std::cout << exception.GetHelpText() << std::endl;
+        return 0;
+    }
+    catch (const utilities::CommandLineParserErrorException& exception)
+    {
+        std::cerr << "Command line parse error:" << std::endl;
+        for (const auto& error : exception.GetParseErrors())
+        {
+            std::cerr << error.GetMessage() << std::endl;
+        }
+        return 1;
+    }
+    catch (const utilities::Exception& exception)
+    {
+        std::cerr << "exception: " << exception.GetMessage() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
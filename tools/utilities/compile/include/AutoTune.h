@@ -0,0 +1,34 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     AutoTune.h (compile)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+// model
+#include "Map.h"
+#include "MapCompiler.h"
+
+// stl
+#include <ostream>
+
+namespace ell
+{
+/// <summary>
+/// Finds the fastest code generation settings for each convolutional and fully-connected layer in a map. Each layer is
+/// compiled on its own with candidate settings (convolution method, vector width, thread count and, when BLAS isn't
+/// used, the tile sizes of the native matrix multiply), JIT-compiled and timed on the host. The best settings found are
+/// stored in the map's metadata, where the map compiler picks them up, and they persist when the map is saved.
+/// </summary>
+///
+/// <param name="map"> The map to tune. </param>
+/// <param name="parameters"> The parameters the map will be compiled with. </param>
+/// <param name="logStream"> The stream to report progress to. </param>
+/// <param name="verbose"> If `true`, report the time of every candidate. </param>
+///
+/// <returns> The number of layers whose settings were tuned. </returns>
+size_t AutoTuneMap(model::Map& map, const model::MapCompilerParameters& parameters, std::ostream& logStream, bool verbose);
+}
@@ -41,6 +41,7 @@ struct CompileArguments
 
     // model-generation options
     int maxRefinementIterations = 0;
+    bool autotune = false;
 };
 
 /// <summary> Parsed command line arguments for the compile executable. </summary>
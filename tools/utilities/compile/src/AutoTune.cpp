@@ -0,0 +1,342 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     AutoTune.cpp (compile)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "AutoTune.h"
+
+// model
+#include "IRCompiledMap.h"
+#include "IRMapCompiler.h"
+#include "InputNode.h"
+#include "Model.h"
+#include "NodeCompilerSettings.h"
+
+// nodes
+#include "BinaryConvolutionalLayerNode.h"
+#include "ConvolutionalLayerNode.h"
+#include "FullyConnectedLayerNode.h"
+
+// utilities
+#include "Exception.h"
+#include "MillisecondTimer.h"
+
+// stl
+#include <algorithm>
+#include <limits>
+#include <random>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace ell
+{
+namespace
+{
+    const int c_maxRefinementIterations = 10;
+    const int c_minTimingIterations = 3;
+    const int c_minTimingMilliseconds = 100;
+
+    // The dimensions of the search. Each one is searched in turn, keeping the best value found for the ones before it.
+    struct TuningOptions
+    {
+        std::vector<std::string> convolutionMethods;
+        std::vector<int> vectorWidths;
+        std::vector<int> threadCounts;
+        std::vector<emitters::GemmTileSizes> gemmTileSizes;
+    };
+
+    std::string ToString(const model::NodeCompilerSettings& settings)
+    {
+        std::string result;
+        if (!settings.convolutionMethod.empty())
+        {
+            result += "method = " + settings.convolutionMethod + ", ";
+        }
+        result += "vector width = " + std::to_string(settings.vectorWidth) + ", threads = " + std::to_string(settings.maxThreads);
+        const auto& tiles = settings.gemmTileSizes;
+        if (tiles.m > 0)
+        {
+            result += ", GEMM tiles = " + std::to_string(tiles.m) + "x" + std::to_string(tiles.n) + "x" + std::to_string(tiles.k) + " (kernel " + std::to_string(tiles.kernelRows) + "x" + std::to_string(tiles.kernelColumnVectors) + ")";
+        }
+        return result;
+    }
+
+    model::MapCompilerParameters GetTuningParameters(const model::MapCompilerParameters& parameters)
+    {
+        // Candidates are timed by running them, so they're always compiled for the host
+        auto result = parameters;
+        result.moduleName = "ELL_autotune";
+        result.mapFunctionName = "predict";
+        result.profile = false;
+        result.emitPredictBatch = false;
+        result.compilerSettings.targetDevice.deviceName = "host";
+        return result;
+    }
+
+    std::vector<int> GetThreadCounts()
+    {
+        const int hardwareThreads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+        std::vector<int> result;
+        for (int threads = 1; threads < hardwareThreads; threads *= 2)
+        {
+            result.push_back(threads);
+        }
+        result.push_back(hardwareThreads);
+        return result;
+    }
+
+    std::vector<emitters::GemmTileSizes> GetGemmTileSizeCandidates()
+    {
+        // { m, n, k, kernelRows, kernelColumnVectors }
+        return {
+            { 32, 64, 64, 4, 2 },
+            { 64, 128, 128, 4, 2 },
+            { 64, 256, 256, 4, 2 },
+            { 128, 128, 256, 8, 2 },
+            { 64, 128, 128, 8, 1 }
+        };
+    }
+
+    template <typename ValueType>
+    std::vector<ValueType> GetRandomInput(size_t size)
+    {
+        std::default_random_engine engine(123);
+        std::uniform_real_distribution<double> distribution(-1, 1);
+        std::vector<ValueType> result(size);
+        for (auto& value : result)
+        {
+            value = static_cast<ValueType>(distribution(engine));
+        }
+        return result;
+    }
+
+    // Returns the average time of one call to the compiled map, in milliseconds
+    template <typename ValueType>
+    double TimeMap(const model::Map& map, const model::MapCompilerParameters& parameters)
+    {
+        model::IRMapCompiler compiler(parameters);
+        auto compiledMap = compiler.Compile(map);
+
+        auto input = GetRandomInput<ValueType>(compiledMap.GetInput(0)->Size());
+        std::vector<ValueType> output(compiledMap.GetOutput(0).Size());
+        compiledMap.Compute(input.data(), output.data()); // finishes jitting, and warms up the caches
+
+        int iterations = 0;
+        utilities::MillisecondTimer timer;
+        while (iterations < c_minTimingIterations || timer.Elapsed() < c_minTimingMilliseconds)
+        {
+            compiledMap.Compute(input.data(), output.data());
+            ++iterations;
+        }
+        return static_cast<double>(timer.Elapsed()) / iterations;
+    }
+
+    // Makes a map that holds a copy of just the given layer node
+    template <typename ValueType, typename LayerNodeType>
+    model::Map MakeLayerMap(const LayerNodeType& node)
+    {
+        model::Model model;
+        auto inputNode = model.AddNode<model::InputNode<ValueType>>(node.input.Size());
+        auto layerNode = model.AddNode<LayerNodeType>(inputNode->output, node.GetLayer());
+        return model::Map(model, { { "input", inputNode } }, { { "output", layerNode->output } });
+    }
+
+    template <typename ValueType, typename LayerNodeType>
+    model::NodeCompilerSettings TuneLayerNode(const LayerNodeType& node, const model::NodeCompilerSettings& initialSettings, const TuningOptions& options, const model::MapCompilerParameters& parameters, std::ostream& logStream, bool verbose)
+    {
+        auto map = MakeLayerMap<ValueType>(node);
+        auto layerNode = map.GetModel().template GetNodesByType<LayerNodeType>().front();
+        const auto key = model::GetNodeCompilerSettingsKey(*layerNode);
+
+        auto timeSettings = [&](const model::NodeCompilerSettings& settings) {
+            model::SetNodeCompilerSettings(map, key, settings);
+            double time = std::numeric_limits<double>::infinity();
+            try
+            {
+                time = TimeMap<ValueType>(map, parameters);
+            }
+            catch (const utilities::Exception& exception)
+            {
+                // Not every combination of settings can be compiled for every layer
+                if (verbose)
+                {
+                    logStream << "    " << ToString(settings) << ": failed (" << exception.GetMessage() << ")" << std::endl;
+                }
+                return time;
+            }
+            if (verbose)
+            {
+                logStream << "    " << ToString(settings) << ": " << time << " ms" << std::endl;
+            }
+            return time;
+        };
+
+        auto bestSettings = initialSettings;
+        auto bestTime = timeSettings(bestSettings);
+        auto tryCandidate = [&](const model::NodeCompilerSettings& candidate) {
+            auto time = timeSettings(candidate);
+            if (time < bestTime)
+            {
+                bestTime = time;
+                bestSettings = candidate;
+            }
+        };
+
+        for (const auto& method : options.convolutionMethods)
+        {
+            auto candidate = bestSettings;
+            candidate.convolutionMethod = method;
+            if (method != initialSettings.convolutionMethod)
+            {
+                tryCandidate(candidate);
+            }
+        }
+        for (auto vectorWidth : options.vectorWidths)
+        {
+            auto candidate = bestSettings;
+            candidate.vectorWidth = vectorWidth;
+            if (vectorWidth != initialSettings.vectorWidth)
+            {
+                tryCandidate(candidate);
+            }
+        }
+        for (auto threads : options.threadCounts)
+        {
+            auto candidate = bestSettings;
+            candidate.maxThreads = threads;
+            if (threads != initialSettings.maxThreads)
+            {
+                tryCandidate(candidate);
+            }
+        }
+        for (const auto& tiles : options.gemmTileSizes)
+        {
+            auto candidate = bestSettings;
+            candidate.gemmTileSizes = tiles;
+            tryCandidate(candidate);
+        }
+
+        logStream << "  " << key << ": " << ToString(bestSettings) << " (" << bestTime << " ms)" << std::endl;
+        return bestSettings;
+    }
+
+    model::NodeCompilerSettings GetInitialSettings(const model::MapCompilerParameters& parameters)
+    {
+        const auto& compilerSettings = parameters.compilerSettings;
+        model::NodeCompilerSettings settings;
+        settings.vectorWidth = compilerSettings.allowVectorInstructions ? compilerSettings.vectorWidth : 1;
+        settings.maxThreads = compilerSettings.parallelize ? compilerSettings.maxThreads : 1;
+        return settings;
+    }
+
+    TuningOptions GetBaseTuningOptions()
+    {
+        TuningOptions options;
+        options.vectorWidths = { 1, 4, 8 };
+        return options;
+    }
+
+    template <typename ValueType>
+    bool TryTuneNode(const model::Node& node, const model::MapCompilerParameters& parameters, model::NodeCompilerSettings& settings, std::ostream& logStream, bool verbose)
+    {
+        if (auto convolutionalNode = dynamic_cast<const nodes::ConvolutionalLayerNode<ValueType>*>(&node))
+        {
+            const auto& convolutionalParameters = convolutionalNode->GetLayer().GetConvolutionalParameters();
+            auto initialSettings = GetInitialSettings(parameters);
+            switch (convolutionalParameters.method)
+            {
+                case predictors::neural::ConvolutionMethod::diagonal:
+                    initialSettings.convolutionMethod = "diagonal";
+                    break;
+                case predictors::neural::ConvolutionMethod::winograd:
+                    initialSettings.convolutionMethod = "winograd";
+                    break;
+                default:
+                    initialSettings.convolutionMethod = "columnwise";
+            }
+
+            auto options = GetBaseTuningOptions();
+            options.convolutionMethods = { "columnwise" };
+            if (convolutionalParameters.stride == 1 && convolutionalParameters.receptiveField % 2 == 1)
+            {
+                options.convolutionMethods.push_back("diagonal");
+            }
+            if (convolutionalParameters.stride == 1 && convolutionalParameters.receptiveField == 3)
+            {
+                options.convolutionMethods.push_back("winograd");
+            }
+            if (!parameters.compilerSettings.useBlas)
+            {
+                options.gemmTileSizes = GetGemmTileSizeCandidates();
+            }
+            settings = TuneLayerNode<ValueType>(*convolutionalNode, initialSettings, options, parameters, logStream, verbose);
+            return true;
+        }
+
+        if (auto binaryConvolutionalNode = dynamic_cast<const nodes::BinaryConvolutionalLayerNode<ValueType>*>(&node))
+        {
+            auto options = GetBaseTuningOptions();
+            options.threadCounts = GetThreadCounts();
+            settings = TuneLayerNode<ValueType>(*binaryConvolutionalNode, GetInitialSettings(parameters), options, parameters, logStream, verbose);
+            return true;
+        }
+
+        if (auto fullyConnectedNode = dynamic_cast<const nodes::FullyConnectedLayerNode<ValueType>*>(&node))
+        {
+            settings = TuneLayerNode<ValueType>(*fullyConnectedNode, GetInitialSettings(parameters), GetBaseTuningOptions(), parameters, logStream, verbose);
+            return true;
+        }
+
+        return false;
+    }
+}
+
+size_t AutoTuneMap(model::Map& map, const model::MapCompilerParameters& parameters, std::ostream& logStream, bool verbose)
+{
+    const auto tuningParameters = GetTuningParameters(parameters);
+    if (parameters.compilerSettings.targetDevice.deviceName != "host")
+    {
+        logStream << "Warning: autotuning times candidates on the host, not on the target device" << std::endl;
+    }
+
+    // The layer nodes may only appear partway through refinement (e.g., inside a neural network predictor), so
+    // look for them at each level of refinement
+    std::set<std::string> tunedKeys;
+    model::Map stage = map;
+    model::TransformContext context;
+    for (int iteration = 0; iteration < c_maxRefinementIterations; ++iteration)
+    {
+        std::vector<const model::Node*> stageNodes;
+        stage.GetModel().Visit([&stageNodes](const model::Node& node) { stageNodes.push_back(&node); });
+        for (auto node : stageNodes)
+        {
+            const auto key = model::GetNodeCompilerSettingsKey(*node);
+            if (tunedKeys.find(key) != tunedKeys.end())
+            {
+                continue;
+            }
+
+            model::NodeCompilerSettings settings;
+            if (TryTuneNode<float>(*node, tuningParameters, settings, logStream, verbose) || TryTuneNode<double>(*node, tuningParameters, settings, logStream, verbose))
+            {
+                model::SetNodeCompilerSettings(map, key, settings);
+                tunedKeys.insert(key);
+            }
+        }
+
+        const auto numNodes = stage.GetModel().Size();
+        stage.Refine(context, 1);
+        if (stage.GetModel().Size() == numNodes)
+        {
+            break;
+        }
+    }
+
+    return tunedKeys.size();
+}
+}
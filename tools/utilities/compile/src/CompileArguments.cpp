@@ -92,6 +92,12 @@ void ParsedCompileArguments::AddArgs(utilities::CommandLineParser& parser)
         "mri",
         "The maximal number of refinement iterations (only valid if outputType is 'refinedMap')",
         10);
+    parser.AddOption(
+        autotune,
+        "autotune",
+        "",
+        "Time variants of each convolutional and fully-connected layer on this machine, and compile with the fastest (the choices are saved in <outputFilenameBase>_tuned.map and reused when that map is compiled)",
+        false);
     parser.AddOption(
         verbose,
         "verbose",
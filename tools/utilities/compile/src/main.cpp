@@ -6,6 +6,7 @@
 //
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
+#include "AutoTune.h"
 #include "CompileArguments.h"
 
 // utilities
@@ -103,6 +104,15 @@ void ProduceMapOutput(ParsedCompileArguments& compileArguments, common::ParsedMa
     }
 
     model::MapCompilerParameters settings = mapCompilerArguments.GetMapCompilerParameters(baseFilename);
+    if (compileArguments.autotune)
+    {
+        TimingOutputCollector timer(timingOutput, "Time to autotune map", compileArguments.verbose);
+        auto numTunedLayers = AutoTuneMap(map, settings, std::cout, compileArguments.verbose);
+        timer.Stop();
+        std::cout << "Tuned " << numTunedLayers << " layers" << std::endl;
+        common::SaveMap(map, baseFilename + "_tuned.map");
+    }
+
     if (compileArguments.outputRefinedMap)
     {
         model::TransformContext context;
@@ -117,6 +127,17 @@ void ProduceMapOutput(ParsedCompileArguments& compileArguments, common::ParsedMa
     auto compiledMap = compiler.Compile(map);
     timer.Stop();
 
+    auto memoryPlanner = compiler.GetMemoryPlanner();
+    if (compileArguments.verbose && memoryPlanner != nullptr)
+    {
+        timingOutput << "Planned memory for " << memoryPlanner->NumPlannedPorts() << " intermediate values (" << memoryPlanner->NumInPlacePorts() << " computed in place): "
+                     << memoryPlanner->GetPlannedMemorySize() << " bytes (" << memoryPlanner->GetUnplannedMemorySize() << " bytes without planning)" << std::endl;
+        if (settings.reentrant)
+        {
+            timingOutput << "Workspace size for reentrant predict: " << memoryPlanner->GetPlannedMemorySize() << " bytes" << std::endl;
+        }
+    }
+
     if (compileArguments.outputCompiledMap)
     {
         TimingOutputCollector timer(timingOutput, "Time to save compiled map", compileArguments.verbose);
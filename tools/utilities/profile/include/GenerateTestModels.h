@@ -11,12 +11,28 @@
 // model
 #include "Map.h"
 
+// stl
+#include <string>
+#include <vector>
+
 namespace ell
 {
+    // The size of a matrix multiply: (m x k) * (k x n)
+    struct MatrixMultiplyShape
+    {
+        size_t m;
+        size_t n;
+        size_t k;
+        std::string description;
+    };
+
     model::Map GenerateTreeModel(size_t numSplits);
 
     // Neural nets
     model::Map GenerateBinaryConvolutionModel(size_t imageRows, size_t imageColumns, size_t numChannels, size_t numFilters);
     model::Map GenerateBinaryConvolutionPlusDenseModel(size_t imageRows, size_t imageColumns, size_t numChannels, size_t numFilters, size_t numOutputs);
     model::Map GenerateBinaryDarknetLikeModel(bool lastLayerReal=false);
+
+    // The matrix multiplies done by the (unrolled) convolutional and dense layers of the models above
+    std::vector<MatrixMultiplyShape> GetTestModelMatrixMultiplyShapes();
 }
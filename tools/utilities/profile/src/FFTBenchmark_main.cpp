@@ -0,0 +1,183 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     FFTBenchmark_main.cpp (profile)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// math
+#include "MathConstants.h"
+
+// model
+#include "IRCompiledMap.h"
+#include "IRMapCompiler.h"
+#include "InputNode.h"
+#include "Map.h"
+#include "Model.h"
+
+// nodes
+#include "FFTNode.h"
+
+// utilities
+#include "Exception.h"
+#include "MillisecondTimer.h"
+
+// stl
+#include <algorithm>
+#include <complex>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace ell;
+
+namespace
+{
+// The FFT the emitter generated before the real-input packing: the real signal is converted to a complex one of the
+// same length, and transformed with a radix-2 FFT that deinterleaves into half-size scratch space
+void PreviousFFT(std::complex<float>* data, size_t length, std::complex<float>* scratch, const std::vector<std::vector<std::complex<float>>>& twiddleTables)
+{
+    const auto halfN = length / 2;
+    for (size_t index = 0; index < halfN; ++index)
+    {
+        scratch[index] = data[2 * index + 1];
+        data[index] = data[2 * index];
+    }
+    std::copy(scratch, scratch + halfN, data + halfN);
+
+    auto evens = data;
+    auto odds = data + halfN;
+    if (halfN > 1)
+    {
+        PreviousFFT(evens, halfN, scratch, twiddleTables);
+        PreviousFFT(odds, halfN, scratch, twiddleTables);
+    }
+
+    const auto& twiddles = twiddleTables[halfN];
+    for (size_t k = 0; k < halfN; ++k)
+    {
+        auto e = evens[k];
+        auto wo = twiddles[k] * odds[k];
+        evens[k] = e + wo;
+        odds[k] = e - wo;
+    }
+}
+
+class PreviousFFTNode
+{
+public:
+    PreviousFFTNode(size_t length)
+        : _length(length), _complexBuffer(length), _scratch(length / 2), _twiddleTables(length)
+    {
+        const auto pi = math::Constants<float>::pi;
+        for (size_t halfN = 1; halfN < length; halfN *= 2)
+        {
+            for (size_t k = 0; k < halfN; ++k)
+            {
+                _twiddleTables[halfN].push_back(std::exp(std::complex<float>(0, pi * k / halfN)));
+            }
+        }
+    }
+
+    void Compute(const float* input, float* output)
+    {
+        for (size_t index = 0; index < _length; ++index)
+        {
+            _complexBuffer[index] = input[index];
+        }
+        PreviousFFT(_complexBuffer.data(), _length, _scratch.data(), _twiddleTables);
+        for (size_t index = 0; index < _length / 2; ++index)
+        {
+            output[index] = std::abs(_complexBuffer[index]);
+        }
+    }
+
+private:
+    size_t _length;
+    std::vector<std::complex<float>> _complexBuffer;
+    std::vector<std::complex<float>> _scratch;
+    std::vector<std::vector<std::complex<float>>> _twiddleTables;
+};
+
+std::vector<float> GetRandomValues(size_t size)
+{
+    std::default_random_engine engine(123);
+    std::uniform_real_distribution<float> distribution(-1, 1);
+    std::vector<float> result(size);
+    for (auto& value : result)
+    {
+        value = distribution(engine);
+    }
+    return result;
+}
+
+// Returns the average time of a call to `function`, in microseconds
+template <typename FunctionType>
+double TimeFunction(FunctionType&& function)
+{
+    function(); // warm up the caches
+
+    const int minIterations = 100;
+    const int minMilliseconds = 200;
+    int iterations = 0;
+    utilities::MillisecondTimer timer;
+    while (iterations < minIterations || timer.Elapsed() < minMilliseconds)
+    {
+        function();
+        ++iterations;
+    }
+    return 1000.0 * timer.Elapsed() / iterations;
+}
+
+void PrintResult(const std::string& name, double microseconds)
+{
+    std::cout << "  " << std::setw(10) << std::left << name << std::right << std::setw(10) << std::fixed << std::setprecision(2) << microseconds << " us" << std::endl;
+}
+
+void RunBenchmarks()
+{
+    for (size_t length : { 256, 512, 1024 })
+    {
+        model::Model model;
+        auto inputNode = model.AddNode<model::InputNode<float>>(length);
+        auto fftNode = model.AddNode<nodes::FFTNode<float>>(inputNode->output);
+        auto map = model::Map(model, { { "input", inputNode } }, { { "output", fftNode->output } });
+
+        model::MapCompilerParameters settings;
+        settings.compilerSettings.targetDevice.deviceName = "host";
+        model::IRMapCompiler compiler(settings);
+        auto compiledMap = compiler.Compile(map);
+
+        auto input = GetRandomValues(length);
+        std::vector<float> output(length / 2);
+        PreviousFFTNode previous(length);
+
+        std::cout << "FFT (length = " << length << ")" << std::endl;
+        PrintResult("previous", TimeFunction([&]() { previous.Compute(input.data(), output.data()); }));
+        PrintResult("compiled", TimeFunction([&]() { compiledMap.Compute(input.data(), output.data()); }));
+    }
+}
+}
+
+int main(int argc, char* argv[])
+{
+    try
+    {
+        RunBenchmarks();
+    }
+    catch (utilities::Exception& e)
+    {
+        std::cout << "Exception: " << e.GetMessage() << std::endl;
+        return 1;
+    }
+    catch (std::exception& e)
+    {
+        std::cout << "Exception: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,155 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     ForestBenchmark_main.cpp (profile)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// model
+#include "IRCompiledMap.h"
+#include "IRMapCompiler.h"
+#include "InputNode.h"
+#include "Map.h"
+#include "Model.h"
+
+// nodes
+#include "ForestPredictorNode.h"
+
+// predictors
+#include "ForestPredictor.h"
+
+// utilities
+#include "Exception.h"
+#include "MillisecondTimer.h"
+
+// stl
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace ell;
+
+namespace
+{
+// Makes a forest of complete trees with random splits
+predictors::SimpleForestPredictor MakeRandomForest(size_t numTrees, size_t depth, size_t numFeatures, std::default_random_engine& engine)
+{
+    using SplitAction = predictors::SimpleForestPredictor::SplitAction;
+    using SplitRule = predictors::SingleElementThresholdPredictor;
+    using EdgePredictorVector = std::vector<predictors::ConstantPredictor>;
+
+    std::uniform_int_distribution<size_t> featureDistribution(0, numFeatures - 1);
+    std::uniform_real_distribution<double> valueDistribution(-1, 1);
+    auto randomSplit = [&](const predictors::SimpleForestPredictor::SplittableNodeId& id) {
+        return SplitAction{ id, SplitRule{ featureDistribution(engine), valueDistribution(engine) }, EdgePredictorVector{ valueDistribution(engine), valueDistribution(engine) } };
+    };
+
+    predictors::SimpleForestPredictor forest;
+    for (size_t treeIndex = 0; treeIndex < numTrees; ++treeIndex)
+    {
+        std::vector<size_t> level = { forest.Split(randomSplit(forest.GetNewRootId())) };
+        for (size_t levelIndex = 1; levelIndex < depth; ++levelIndex)
+        {
+            std::vector<size_t> nextLevel;
+            for (auto parent : level)
+            {
+                for (size_t child = 0; child < 2; ++child)
+                {
+                    nextLevel.push_back(forest.Split(randomSplit(forest.GetChildId(parent, child))));
+                }
+            }
+            level = nextLevel;
+        }
+    }
+    return forest;
+}
+
+std::vector<std::vector<double>> GetRandomInputs(size_t numInputs, size_t size, std::default_random_engine& engine)
+{
+    std::uniform_real_distribution<double> distribution(-1, 1);
+    std::vector<std::vector<double>> result(numInputs, std::vector<double>(size));
+    for (auto& input : result)
+    {
+        for (auto& value : input)
+        {
+            value = distribution(engine);
+        }
+    }
+    return result;
+}
+
+// Returns the average time of a call to the compiled map, in microseconds
+double TimeMap(const model::IRCompiledMap& compiledMap, const std::vector<std::vector<double>>& inputs)
+{
+    double output = 0;
+    compiledMap.Compute(inputs[0].data(), &output); // finishes jitting, and warms up the caches
+
+    const int minIterations = 100;
+    const int minMilliseconds = 200;
+    int iterations = 0;
+    utilities::MillisecondTimer timer;
+    while (iterations < minIterations || timer.Elapsed() < minMilliseconds)
+    {
+        compiledMap.Compute(inputs[iterations % inputs.size()].data(), &output);
+        ++iterations;
+    }
+    return 1000.0 * timer.Elapsed() / iterations;
+}
+
+void PrintResult(const std::string& name, double microseconds)
+{
+    std::cout << "  " << std::setw(12) << std::left << name << std::right << std::setw(12) << std::fixed << std::setprecision(2) << microseconds << " us" << std::endl;
+}
+
+void RunBenchmarks()
+{
+    const size_t numTrees = 500;
+    const size_t numFeatures = 100;
+    std::default_random_engine engine(123);
+    auto inputs = GetRandomInputs(64, numFeatures, engine);
+
+    for (size_t depth : { 3, 5, 6, 8 })
+    {
+        auto forest = MakeRandomForest(numTrees, depth, numFeatures, engine);
+        model::Model model;
+        auto inputNode = model.AddNode<model::InputNode<double>>(numFeatures);
+        auto forestNode = model.AddNode<nodes::SimpleForestPredictorNode>(inputNode->output, forest);
+        auto map = model::Map(model, { { "input", inputNode } }, { { "output", forestNode->output } });
+
+        std::cout << "Forest (" << numTrees << " trees, depth " << depth << ")" << std::endl;
+        const std::vector<std::pair<std::string, model::ForestEvaluation>> evaluations = { { "refine", model::ForestEvaluation::refine }, { "branching", model::ForestEvaluation::branching }, { "quickScorer", model::ForestEvaluation::quickScorer } };
+        for (const auto& evaluation : evaluations)
+        {
+            model::MapCompilerParameters settings;
+            settings.compilerSettings.targetDevice.deviceName = "host";
+            settings.forestEvaluation = evaluation.second;
+            model::IRMapCompiler compiler(settings);
+            auto compiledMap = compiler.Compile(map);
+            PrintResult(evaluation.first, TimeMap(compiledMap, inputs));
+        }
+    }
+}
+}
+
+int main(int argc, char* argv[])
+{
+    try
+    {
+        RunBenchmarks();
+    }
+    catch (utilities::Exception& e)
+    {
+        std::cout << "Exception: " << e.GetMessage() << std::endl;
+        return 1;
+    }
+    catch (std::exception& e)
+    {
+        std::cout << "Exception: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,148 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     ForestTrainerBenchmark_main.cpp (profile)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// data
+#include "Dataset.h"
+
+// functions
+#include "SquaredLoss.h"
+
+// trainers
+#include "BinnedForestTrainer.h"
+#include "LogitBooster.h"
+#include "SortingForestTrainer.h"
+
+// utilities
+#include "Exception.h"
+#include "MillisecondTimer.h"
+
+// stl
+#include <algorithm>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace ell;
+
+namespace
+{
+const size_t c_numExamples = 50000;
+const size_t c_numFeatures = 32;
+
+using ForestTrainer = trainers::ITrainer<predictors::SimpleForestPredictor>;
+using TrainerFactory = std::function<std::unique_ptr<ForestTrainer>(size_t numThreads)>;
+
+// Makes a dataset whose labels depend on a few interactions between features, plus noise
+data::AutoSupervisedDataset MakeDataset(std::default_random_engine& engine)
+{
+    std::uniform_real_distribution<double> distribution(-1, 1);
+    data::AutoSupervisedDataset dataset;
+    for (size_t exampleIndex = 0; exampleIndex < c_numExamples; ++exampleIndex)
+    {
+        std::vector<double> values(c_numFeatures);
+        for (auto& value : values)
+        {
+            value = distribution(engine);
+        }
+        double score = values[0] * values[1] + values[2] - 0.5 * values[3] * values[4] + 0.25 * distribution(engine);
+        dataset.AddExample({ data::AutoDataVector(values), { 1.0, score > 0 ? 1.0 : -1.0 } });
+    }
+    return dataset;
+}
+
+std::vector<double> GetPredictions(const predictors::SimpleForestPredictor& forest, const data::AutoSupervisedDataset& dataset)
+{
+    std::vector<double> predictions;
+    for (size_t exampleIndex = 0; exampleIndex < dataset.NumExamples(); ++exampleIndex)
+    {
+        predictions.push_back(forest.Predict(dataset[exampleIndex].GetDataVector().CopyAs<predictors::SimpleForestPredictor::DataVectorType>()));
+    }
+    return predictions;
+}
+
+void RunBenchmark(const std::string& name, const TrainerFactory& makeTrainer, const data::AutoSupervisedDataset& dataset, size_t maxThreads)
+{
+    std::cout << name << std::endl;
+    double serialTime = 0;
+    std::vector<double> serialPredictions;
+    for (size_t numThreads = 1; numThreads <= maxThreads; numThreads *= 2)
+    {
+        auto trainer = makeTrainer(numThreads);
+        utilities::MillisecondTimer timer;
+        trainer->SetDataset(dataset.GetAnyDataset());
+        trainer->Update();
+        double time = static_cast<double>(timer.Elapsed());
+
+        auto predictions = GetPredictions(trainer->GetPredictor(), dataset);
+        if (numThreads == 1)
+        {
+            serialTime = time;
+            serialPredictions = predictions;
+        }
+        std::cout << "  " << std::setw(2) << numThreads << " threads" << std::setw(10) << std::fixed << std::setprecision(0) << time << " ms" << std::setw(8) << std::setprecision(2) << serialTime / std::max(time, 1.0) << "x";
+        std::cout << (predictions == serialPredictions ? "" : "  (forest differs from 1 thread)") << std::endl;
+    }
+}
+
+template <typename ParametersType>
+void SetParameters(ParametersType& parameters, size_t numThreads)
+{
+    parameters.maxSplitsPerRound = 32;
+    parameters.numRounds = 10;
+    parameters.numThreads = numThreads;
+}
+
+void RunBenchmarks(size_t maxThreads)
+{
+    std::default_random_engine engine(123);
+    auto dataset = MakeDataset(engine);
+    std::cout << "Training forests on " << c_numExamples << " examples with " << c_numFeatures << " features" << std::endl;
+
+    RunBenchmark("BinnedForestTrainer", [](size_t numThreads) {
+        trainers::BinnedForestTrainerParameters parameters;
+        SetParameters(parameters, numThreads);
+        return trainers::MakeBinnedForestTrainer(functions::SquaredLoss(), trainers::LogitBooster(), parameters);
+    },
+                 dataset,
+                 maxThreads);
+
+    RunBenchmark("SortingForestTrainer", [](size_t numThreads) {
+        trainers::SortingForestTrainerParameters parameters;
+        SetParameters(parameters, numThreads);
+        return trainers::MakeSortingForestTrainer(functions::SquaredLoss(), trainers::LogitBooster(), parameters);
+    },
+                 dataset,
+                 maxThreads);
+}
+}
+
+int main(int argc, char* argv[])
+{
+    try
+    {
+        int maxThreads = argc > 1 ? std::stoi(argv[1]) : static_cast<int>(std::thread::hardware_concurrency());
+        RunBenchmarks(static_cast<size_t>(std::max(maxThreads, 1)));
+    }
+    catch (utilities::Exception& e)
+    {
+        std::cout << "Exception: " << e.GetMessage() << std::endl;
+        return 1;
+    }
+    catch (std::exception& e)
+    {
+        std::cout << "Exception: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,172 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     GEMMBenchmark_main.cpp (profile)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "GenerateTestModels.h"
+
+// emitters
+#include "IRExecutionEngine.h"
+#include "IRModuleEmitter.h"
+
+// math
+#include "BlasWrapper.h"
+
+// utilities
+#include "Exception.h"
+#include "MillisecondTimer.h"
+
+// stl
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace ell;
+
+namespace
+{
+using GEMMFunction = int (*)(int, int, int, int, int, int, float, const float*, int, const float*, int, float, float*, int);
+using GEMVFunction = int (*)(int, int, int, int, float, const float*, int, const float*, int, float, float*, int);
+
+const int CblasRowMajor = 101;
+const int CblasNoTrans = 111;
+
+// The loops the emitter generated for non-BLAS targets before the native GEMM and GEMV were blocked
+void NaiveGEMM(int m, int n, int k, const float* A, int lda, const float* B, int ldb, float* C, int ldc)
+{
+    std::fill(C, C + m * ldc, 0.0f);
+    for (int i = 0; i < m; ++i)
+    {
+        for (int p = 0; p < k; ++p)
+        {
+            for (int j = 0; j < n; ++j)
+            {
+                C[i * ldc + j] += A[i * lda + p] * B[p * ldb + j];
+            }
+        }
+    }
+}
+
+void NaiveGEMV(int m, int n, const float* A, int lda, const float* x, float* y)
+{
+    for (int i = 0; i < m; ++i)
+    {
+        float sum = 0;
+        for (int j = 0; j < n; ++j)
+        {
+            sum += A[i * lda + j] * x[j];
+        }
+        y[i] = sum;
+    }
+}
+
+std::vector<float> GetRandomValues(size_t size)
+{
+    std::default_random_engine engine(123);
+    std::uniform_real_distribution<float> distribution(-1, 1);
+    std::vector<float> result(size);
+    for (auto& value : result)
+    {
+        value = distribution(engine);
+    }
+    return result;
+}
+
+// Returns the average time of a call to `function`, in milliseconds
+template <typename FunctionType>
+double TimeFunction(FunctionType&& function)
+{
+    function(); // warm up the caches
+
+    const int minIterations = 5;
+    const int minMilliseconds = 200;
+    int iterations = 0;
+    utilities::MillisecondTimer timer;
+    while (iterations < minIterations || timer.Elapsed() < minMilliseconds)
+    {
+        function();
+        ++iterations;
+    }
+    return static_cast<double>(timer.Elapsed()) / iterations;
+}
+
+double GetGFlops(const MatrixMultiplyShape& shape, double milliseconds)
+{
+    return milliseconds <= 0 ? 0.0 : (2.0 * shape.m * shape.n * shape.k) / (milliseconds * 1.0e6);
+}
+
+void PrintResult(const std::string& name, const MatrixMultiplyShape& shape, double milliseconds)
+{
+    std::cout << "  " << std::setw(10) << std::left << name << std::right << std::setw(10) << std::fixed << std::setprecision(3) << milliseconds << " ms"
+              << std::setw(10) << std::setprecision(2) << GetGFlops(shape, milliseconds) << " GFlop/s" << std::endl;
+}
+
+void RunBenchmarks()
+{
+    emitters::CompilerParameters compilerParameters;
+    compilerParameters.targetDevice.deviceName = "host";
+    compilerParameters.allowVectorInstructions = true;
+    compilerParameters.vectorWidth = 8;
+    emitters::IRModuleEmitter module("GEMMBenchmark", compilerParameters);
+    auto gemmName = std::string(module.GetRuntime().GetGEMMFunction<float>(false)->getName());
+    auto gemvName = std::string(module.GetRuntime().GetGEMVFunction<float>(false)->getName());
+
+    emitters::IRExecutionEngine executionEngine(std::move(module));
+    auto nativeGEMM = reinterpret_cast<GEMMFunction>(executionEngine.ResolveFunctionAddress(gemmName));
+    auto nativeGEMV = reinterpret_cast<GEMVFunction>(executionEngine.ResolveFunctionAddress(gemvName));
+
+    for (const auto& shape : GetTestModelMatrixMultiplyShapes())
+    {
+        const int m = static_cast<int>(shape.m);
+        const int n = static_cast<int>(shape.n);
+        const int k = static_cast<int>(shape.k);
+        auto A = GetRandomValues(shape.m * shape.k);
+        auto B = GetRandomValues(shape.k * shape.n);
+        std::vector<float> C(shape.m * shape.n);
+
+        std::cout << shape.description << " (m = " << m << ", n = " << n << ", k = " << k << ")" << std::endl;
+        if (n == 1)
+        {
+            PrintResult("previous", shape, TimeFunction([&]() { NaiveGEMV(m, k, A.data(), k, B.data(), C.data()); }));
+            PrintResult("native", shape, TimeFunction([&]() { nativeGEMV(CblasRowMajor, CblasNoTrans, m, k, 1.0f, A.data(), k, B.data(), 1, 0.0f, C.data(), 1); }));
+#if USE_BLAS
+            PrintResult("OpenBLAS", shape, TimeFunction([&]() { math::Blas::Gemv(math::MatrixLayout::rowMajor, math::MatrixTranspose::noTranspose, m, k, 1.0f, A.data(), k, B.data(), 1, 0.0f, C.data(), 1); }));
+#endif
+        }
+        else
+        {
+            PrintResult("previous", shape, TimeFunction([&]() { NaiveGEMM(m, n, k, A.data(), k, B.data(), n, C.data(), n); }));
+            PrintResult("native", shape, TimeFunction([&]() { nativeGEMM(CblasRowMajor, CblasNoTrans, CblasNoTrans, m, n, k, 1.0f, A.data(), k, B.data(), n, 0.0f, C.data(), n); }));
+#if USE_BLAS
+            PrintResult("OpenBLAS", shape, TimeFunction([&]() { math::Blas::Gemm(math::MatrixLayout::rowMajor, math::MatrixTranspose::noTranspose, math::MatrixTranspose::noTranspose, m, n, k, 1.0f, A.data(), k, B.data(), n, 0.0f, C.data(), n); }));
+#endif
+        }
+    }
+}
+}
+
+int main(int argc, char* argv[])
+{
+    try
+    {
+        RunBenchmarks();
+    }
+    catch (utilities::Exception& e)
+    {
+        std::cout << "Exception: " << e.GetMessage() << std::endl;
+        return 1;
+    }
+    catch (std::exception& e)
+    {
+        std::cout << "Exception: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -534,4 +534,23 @@ model::Map GenerateBinaryDarknetLikeModel(bool lastLayerReal)
     auto map = model::Map(model, { { "input", inputNode } }, { { "output", predictorNode->output } });
     return map;
 }
+
+std::vector<MatrixMultiplyShape> GetTestModelMatrixMultiplyShapes()
+{
+    // A convolutional layer unrolled into a matrix multiply is (numFilters x (field * field * inputChannels)) * ((field * field * inputChannels) x (outputRows * outputColumns)),
+    // and a dense layer is a matrix-vector product (n == 1)
+    return {
+        { 16, 160 * 160, 3 * 3 * 3, "darknet conv [162,162,3]->[160,160,16]" },
+        { 64, 80 * 80, 3 * 3 * 16, "darknet conv [82,82,16]->[80,80,64]" },
+        { 64, 40 * 40, 3 * 3 * 64, "darknet conv [42,42,64]->[40,40,64]" },
+        { 128, 20 * 20, 3 * 3 * 64, "darknet conv [22,22,64]->[20,20,128]" },
+        { 256, 10 * 10, 3 * 3 * 128, "darknet conv [12,12,128]->[10,10,256]" },
+        { 512, 5 * 5, 3 * 3 * 256, "darknet conv [7,7,256]->[5,5,512]" },
+        { 1024, 3 * 3, 3 * 3 * 512, "darknet conv [5,5,512]->[3,3,1024]" },
+        { 1000, 2 * 2, 1024, "darknet conv [2,2,1024]->[2,2,1000]" },
+        { 8, 160 * 160, 3 * 3 * 3, "conv [160,160,3]->[160,160,8]" },
+        { 10, 1, 160 * 160 * 8, "dense [160,160,8]->[1,1,10]" },
+        { 1000, 1, 1024, "dense [1,1,1024]->[1,1,1000]" }
+    };
+}
 }
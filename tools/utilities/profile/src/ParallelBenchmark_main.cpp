@@ -0,0 +1,159 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     ParallelBenchmark_main.cpp (profile)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// model
+#include "IRCompiledMap.h"
+#include "IRMapCompiler.h"
+#include "InputNode.h"
+#include "Map.h"
+#include "Model.h"
+#include "PortMemoryLayout.h"
+
+// nodes
+#include "BinaryOperationNode.h"
+#include "BroadcastFunctionNode.h"
+#include "ConstantNode.h"
+#include "ReorderDataNode.h"
+#include "UnaryOperationNode.h"
+
+// utilities
+#include "Exception.h"
+#include "MillisecondTimer.h"
+
+// stl
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace ell;
+
+namespace
+{
+// The size of the input tensor: large enough that the nodes are memory-bound
+const int c_rows = 256;
+const int c_columns = 256;
+const int c_channels = 32;
+const int c_size = c_rows * c_columns * c_channels;
+
+using ModelBuilder = std::function<const model::OutputPort<float>&(model::Model& model, const model::OutputPort<float>& input)>;
+
+// Returns the average time of a call to the compiled map, in milliseconds
+double TimeMap(const model::IRCompiledMap& compiledMap, const std::vector<float>& input)
+{
+    std::vector<float> output(compiledMap.GetOutput(0).Size());
+    compiledMap.Compute(input.data(), output.data()); // finishes jitting, and warms up the caches
+
+    const int minIterations = 10;
+    const int minMilliseconds = 500;
+    int iterations = 0;
+    utilities::MillisecondTimer timer;
+    while (iterations < minIterations || timer.Elapsed() < minMilliseconds)
+    {
+        compiledMap.Compute(input.data(), output.data());
+        ++iterations;
+    }
+    return static_cast<double>(timer.Elapsed()) / iterations;
+}
+
+void RunBenchmark(const std::string& name, const ModelBuilder& builder, const std::vector<float>& input, int maxThreads)
+{
+    model::Model model;
+    auto inputNode = model.AddNode<model::InputNode<float>>(c_size);
+    const auto& output = builder(model, inputNode->output);
+    auto map = model::Map(model, { { "input", inputNode } }, { { "output", output } });
+
+    std::cout << name << std::endl;
+    double serialTime = 0;
+    for (int numThreads = 1; numThreads <= maxThreads; ++numThreads)
+    {
+        model::MapCompilerParameters settings;
+        settings.compilerSettings.targetDevice.deviceName = "host";
+        settings.compilerSettings.parallelize = numThreads > 1;
+        settings.compilerSettings.maxThreads = numThreads;
+        model::IRMapCompiler compiler(settings);
+        auto compiledMap = compiler.Compile(map);
+        auto time = TimeMap(compiledMap, input);
+        if (numThreads == 1)
+        {
+            serialTime = time;
+        }
+        std::cout << "  " << std::setw(2) << numThreads << " threads" << std::setw(12) << std::fixed << std::setprecision(3) << time << " ms" << std::setw(8) << std::setprecision(2) << serialTime / time << "x" << std::endl;
+    }
+}
+
+void RunBenchmarks(int maxThreads)
+{
+    std::default_random_engine engine(123);
+    std::uniform_real_distribution<float> distribution(-1, 1);
+    std::vector<float> input(c_size);
+    for (auto& value : input)
+    {
+        value = distribution(engine);
+    }
+
+    const model::PortMemoryLayout layout({ c_rows, c_columns, c_channels });
+    std::vector<float> channelValues(c_channels);
+    for (auto& value : channelValues)
+    {
+        value = distribution(engine);
+    }
+
+    RunBenchmark("BinaryOperationNode (add)", [&input](model::Model& model, const model::OutputPort<float>& inputPort) -> const model::OutputPort<float>& {
+        auto constantNode = model.AddNode<nodes::ConstantNode<float>>(input);
+        return model.AddNode<nodes::BinaryOperationNode<float>>(inputPort, constantNode->output, emitters::BinaryOperationType::add)->output;
+    },
+                 input,
+                 maxThreads);
+
+    RunBenchmark("UnaryOperationNode (exp)", [](model::Model& model, const model::OutputPort<float>& inputPort) -> const model::OutputPort<float>& {
+        return model.AddNode<nodes::UnaryOperationNode<float>>(inputPort, emitters::UnaryOperationType::exp)->output;
+    },
+                 input,
+                 maxThreads);
+
+    RunBenchmark("BroadcastLinearFunctionNode", [&layout, &channelValues](model::Model& model, const model::OutputPort<float>& inputPort) -> const model::OutputPort<float>& {
+        auto scaleNode = model.AddNode<nodes::ConstantNode<float>>(channelValues);
+        auto biasNode = model.AddNode<nodes::ConstantNode<float>>(channelValues);
+        return model.AddNode<nodes::BroadcastLinearFunctionNode<float>>(inputPort, layout, scaleNode->output, biasNode->output, 2, layout)->output;
+    },
+                 input,
+                 maxThreads);
+
+    RunBenchmark("ReorderDataNode (channel-major)", [&layout](model::Model& model, const model::OutputPort<float>& inputPort) -> const model::OutputPort<float>& {
+        const model::PortMemoryLayout outputLayout({ c_channels, c_rows, c_columns });
+        return model.AddNode<nodes::ReorderDataNode<float>>(inputPort, layout, outputLayout, std::vector<int>{ 2, 0, 1 })->output;
+    },
+                 input,
+                 maxThreads);
+}
+}
+
+int main(int argc, char* argv[])
+{
+    try
+    {
+        int maxThreads = argc > 1 ? std::stoi(argv[1]) : static_cast<int>(std::thread::hardware_concurrency());
+        RunBenchmarks(std::max(maxThreads, 1));
+    }
+    catch (utilities::Exception& e)
+    {
+        std::cout << "Exception: " << e.GetMessage() << std::endl;
+        return 1;
+    }
+    catch (std::exception& e)
+    {
+        std::cout << "Exception: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,50 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     QuantizeArguments.h (quantize)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+// utilities
+#include "CommandLineParser.h"
+
+// stl
+#include <string>
+
+namespace ell
+{
+/// <summary> Command line arguments for the quantize executable. </summary>
+struct QuantizeArguments
+{
+    /// <summary> The file to write the quantized map to. If empty, the name of the input map with a "_quantized" suffix is used. </summary>
+    std::string outputMapFilename;
+
+    /// <summary> The maximum number of examples used to calibrate the quantization, or 0 to use all of them. </summary>
+    size_t maxCalibrationExamples = 0;
+
+    /// <summary> Compare the accuracy and speed of the quantized map with the original one. </summary>
+    bool report = true;
+
+    /// <summary> Print the calibrated range of each layer. </summary>
+    bool verbose = false;
+};
+
+/// <summary> Parsed command line arguments for the quantize executable. </summary>
+struct ParsedQuantizeArguments : public QuantizeArguments, public utilities::ParsedArgSet
+{
+    /// <summary> Adds the arguments to the command line parser. </summary>
+    ///
+    /// <param name="parser"> [in,out] The parser. </param>
+    void AddArgs(utilities::CommandLineParser& parser) override;
+
+    /// <summary> Check the parsed arguments. </summary>
+    ///
+    /// <param name="parser"> The parser. </param>
+    ///
+    /// <returns> An utilities::CommandLineParseResult. </returns>
+    utilities::CommandLineParseResult PostProcess(const utilities::CommandLineParser& parser) override;
+};
+}
@@ -0,0 +1,78 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     QuantizeMap.h (quantize)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+// data
+#include "Dataset.h"
+
+// model
+#include "Map.h"
+#include "MapCompiler.h"
+
+// stl
+#include <ostream>
+
+namespace ell
+{
+/// <summary> A comparison of a quantized map with the floating-point map it was made from. </summary>
+struct QuantizationReport
+{
+    /// <summary> The number of examples the maps were compared on. </summary>
+    size_t numExamples = 0;
+
+    /// <summary> The largest absolute difference between corresponding outputs of the two maps. </summary>
+    double maxAbsoluteError = 0;
+
+    /// <summary> The mean absolute difference between corresponding outputs of the two maps. </summary>
+    double meanAbsoluteError = 0;
+
+    /// <summary> The fraction of examples for which the largest output of the two maps is at the same index. </summary>
+    double topOneAgreement = 0;
+
+    /// <summary> The average time of one call to the compiled floating-point map, in milliseconds. </summary>
+    double floatMilliseconds = 0;
+
+    /// <summary> The average time of one call to the compiled quantized map, in milliseconds. </summary>
+    double quantizedMilliseconds = 0;
+};
+
+/// <summary>
+/// Makes a copy of a map whose convolutional and fully-connected layers use 8-bit integer arithmetic. The map is
+/// refined until the layer nodes appear, and run on the calibration data to find the range of each layer's input. The
+/// resulting scale is stored in the compiler settings of each layer node, where it makes the layer refine into
+/// quantized matrix multiplies when the map is compiled. Grouped convolutions are left in floating point.
+/// </summary>
+///
+/// <param name="map"> The map to quantize. </param>
+/// <param name="calibrationData"> The examples to calibrate the quantization with. </param>
+/// <param name="maxExamples"> The maximum number of examples to use, or 0 to use all of them. </param>
+/// <param name="logStream"> The stream to report progress to. </param>
+/// <param name="verbose"> If `true`, report the calibrated range of every layer. </param>
+/// <param name="numQuantizedLayers"> [out] The number of layers that were quantized. </param>
+///
+/// <returns> The quantized map. </returns>
+model::Map QuantizeMap(const model::Map& map, const data::AutoSupervisedDataset& calibrationData, size_t maxExamples, std::ostream& logStream, bool verbose, size_t& numQuantizedLayers);
+
+/// <summary> Compiles a floating-point map and its quantized copy, and compares their outputs and speed. </summary>
+///
+/// <param name="floatMap"> The floating-point map. </param>
+/// <param name="quantizedMap"> The quantized map. </param>
+/// <param name="data"> The examples to compare the maps on. </param>
+/// <param name="maxExamples"> The maximum number of examples to use, or 0 to use all of them. </param>
+/// <param name="parameters"> The parameters to compile the maps with. </param>
+///
+/// <returns> The comparison. </returns>
+QuantizationReport CompareQuantizedMap(const model::Map& floatMap, const model::Map& quantizedMap, const data::AutoSupervisedDataset& data, size_t maxExamples, const model::MapCompilerParameters& parameters);
+
+/// <summary> Prints a quantization report. </summary>
+///
+/// <param name="report"> The report. </param>
+/// <param name="stream"> The stream to print to. </param>
+void PrintQuantizationReport(const QuantizationReport& report, std::ostream& stream);
+}
@@ -0,0 +1,49 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     QuantizeArguments.cpp (quantize)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "QuantizeArguments.h"
+
+namespace ell
+{
+void ParsedQuantizeArguments::AddArgs(utilities::CommandLineParser& parser)
+{
+    parser.AddOption(
+        outputMapFilename,
+        "outputMapFilename",
+        "omf",
+        "Path to the output (quantized) map file. Defaults to the input map's name with a '_quantized' suffix.",
+        "");
+
+    parser.AddOption(
+        maxCalibrationExamples,
+        "maxCalibrationExamples",
+        "mce",
+        "The maximum number of examples to calibrate the quantization with (0 to use the whole dataset).",
+        0);
+
+    parser.AddOption(
+        report,
+        "report",
+        "r",
+        "Compare the accuracy and speed of the compiled quantized map with the compiled original map.",
+        true);
+
+    parser.AddOption(
+        verbose,
+        "verbose",
+        "v",
+        "Print the calibrated input range of each layer.",
+        false);
+}
+
+utilities::CommandLineParseResult ParsedQuantizeArguments::PostProcess(const utilities::CommandLineParser& parser)
+{
+    std::vector<std::string> errors;
+    return errors;
+}
+}
@@ -0,0 +1,259 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     QuantizeMap.cpp (quantize)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "QuantizeMap.h"
+
+// data
+#include "DataVector.h"
+
+// model
+#include "IRCompiledMap.h"
+#include "IRMapCompiler.h"
+#include "ModelTransformer.h"
+#include "NodeCompilerSettings.h"
+
+// nodes
+#include "ConvolutionalLayerNode.h"
+#include "FullyConnectedLayerNode.h"
+
+// utilities
+#include "Exception.h"
+#include "MillisecondTimer.h"
+
+// stl
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <map>
+#include <vector>
+
+namespace ell
+{
+namespace
+{
+    const int c_maxRefinementIterations = 10;
+    const int c_maxQuantizedValue = 127;
+    const int c_minTimingIterations = 3;
+    const int c_minTimingMilliseconds = 100;
+
+    size_t GetNumExamples(const data::AutoSupervisedDataset& data, size_t maxExamples)
+    {
+        return maxExamples == 0 ? data.NumExamples() : std::min(maxExamples, data.NumExamples());
+    }
+
+    template <typename ValueType>
+    bool IsQuantizableLayerNode(const model::Node& node)
+    {
+        if (dynamic_cast<const nodes::FullyConnectedLayerNode<ValueType>*>(&node) != nullptr)
+        {
+            return true;
+        }
+
+        // Grouped convolutions don't use a matrix multiply
+        auto convolutionalNode = dynamic_cast<const nodes::ConvolutionalLayerNode<ValueType>*>(&node);
+        return convolutionalNode != nullptr && convolutionalNode->GetLayer().NumGroups() == 1;
+    }
+
+    bool IsQuantizableLayerNode(const model::Node& node)
+    {
+        return IsQuantizableLayerNode<float>(node) || IsQuantizableLayerNode<double>(node);
+    }
+
+    template <typename ValueType>
+    bool TryGetInputMagnitude(const model::Node& node, double& magnitude)
+    {
+        auto layerNode = dynamic_cast<const nodes::NeuralNetworkLayerNodeBase<ValueType>*>(&node);
+        if (layerNode == nullptr)
+        {
+            return false;
+        }
+
+        magnitude = 0;
+        for (auto value : layerNode->input.GetValue())
+        {
+            magnitude = std::max(magnitude, std::abs(static_cast<double>(value)));
+        }
+        return true;
+    }
+
+    double GetInputMagnitude(const model::Node& node)
+    {
+        double magnitude = 0;
+        if (!TryGetInputMagnitude<float>(node, magnitude) && !TryGetInputMagnitude<double>(node, magnitude))
+        {
+            throw utilities::LogicException(utilities::LogicExceptionErrors::illegalState, "Expected a neural network layer node");
+        }
+        return magnitude;
+    }
+
+    std::vector<double> ComputeOutput(const model::Map& map, const data::AutoDataVector& input)
+    {
+        return map.Compute<data::DoubleDataVector>(input).ToArray(map.GetOutputSize());
+    }
+
+    size_t ArgMax(const std::vector<double>& values)
+    {
+        return std::distance(values.begin(), std::max_element(values.begin(), values.end()));
+    }
+
+    // Returns the average time of one call to the compiled map, in milliseconds
+    template <typename ValueType>
+    double TimeMap(const model::IRCompiledMap& compiledMap, const data::AutoSupervisedDataset& data, size_t numExamples)
+    {
+        std::vector<std::vector<ValueType>> inputs;
+        for (size_t index = 0; index < numExamples; ++index)
+        {
+            auto values = data.GetExample(index).GetDataVector().ToArray(compiledMap.GetInputSize());
+            inputs.emplace_back(values.begin(), values.end());
+        }
+        std::vector<ValueType> output(compiledMap.GetOutputSize());
+        compiledMap.Compute(inputs[0].data(), output.data()); // finishes jitting, and warms up the caches
+
+        size_t iterations = 0;
+        utilities::MillisecondTimer timer;
+        while (iterations < c_minTimingIterations || timer.Elapsed() < c_minTimingMilliseconds)
+        {
+            compiledMap.Compute(inputs[iterations % inputs.size()].data(), output.data());
+            ++iterations;
+        }
+        return static_cast<double>(timer.Elapsed()) / iterations;
+    }
+
+    double TimeMap(const model::IRCompiledMap& compiledMap, const data::AutoSupervisedDataset& data, size_t numExamples)
+    {
+        const auto inputType = compiledMap.GetInputType();
+        if (inputType != compiledMap.GetOutputType())
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::typeMismatch, "Can only time maps whose input and output have the same type");
+        }
+
+        switch (inputType)
+        {
+            case model::Port::PortType::smallReal:
+                return TimeMap<float>(compiledMap, data, numExamples);
+            case model::Port::PortType::real:
+                return TimeMap<double>(compiledMap, data, numExamples);
+            default:
+                throw utilities::InputException(utilities::InputExceptionErrors::typeMismatch, "Can only time maps with floating-point inputs");
+        }
+    }
+}
+
+model::Map QuantizeMap(const model::Map& map, const data::AutoSupervisedDataset& calibrationData, size_t maxExamples, std::ostream& logStream, bool verbose, size_t& numQuantizedLayers)
+{
+    // Refine the map until the layer nodes appear (e.g., from inside a neural network predictor), but no further
+    model::Map result = map;
+    model::TransformContext context{ [](const model::Node& node) { return IsQuantizableLayerNode(node) ? model::NodeAction::compile : model::NodeAction::abstain; } };
+    result.Refine(context, c_maxRefinementIterations);
+
+    std::vector<model::Node::NodeId> layerNodeIds;
+    result.GetModel().Visit([&layerNodeIds](const model::Node& node) {
+        if (IsQuantizableLayerNode(node))
+        {
+            layerNodeIds.push_back(node.GetId());
+        }
+    });
+
+    // Calibrate: find the largest input magnitude each layer sees
+    const auto numExamples = GetNumExamples(calibrationData, maxExamples);
+    if (numExamples == 0)
+    {
+        throw utilities::InputException(utilities::InputExceptionErrors::badData, "No calibration examples");
+    }
+
+    std::map<model::Node::NodeId, double> inputMagnitudes;
+    for (size_t index = 0; index < numExamples; ++index)
+    {
+        result.Compute<data::DoubleDataVector>(calibrationData.GetExample(index).GetDataVector());
+        for (const auto& id : layerNodeIds)
+        {
+            auto& magnitude = inputMagnitudes[id];
+            magnitude = std::max(magnitude, GetInputMagnitude(*result.GetModel().GetNode(id)));
+        }
+    }
+
+    // Store the scales in the layer nodes' compiler settings. Layers whose input was always zero stay in floating point.
+    numQuantizedLayers = 0;
+    for (const auto& id : layerNodeIds)
+    {
+        auto node = result.GetModel().GetNode(id);
+        const auto magnitude = inputMagnitudes[id];
+        if (verbose)
+        {
+            logStream << "  " << model::GetNodeCompilerSettingsKey(*node) << ": input range +/- " << magnitude << std::endl;
+        }
+        if (magnitude > 0)
+        {
+            auto settings = model::GetNodeCompilerSettings(*node);
+            settings.inputQuantizationScale = magnitude / c_maxQuantizedValue;
+            model::SetNodeCompilerSettings(*node, settings);
+            ++numQuantizedLayers;
+        }
+    }
+    return result;
+}
+
+QuantizationReport CompareQuantizedMap(const model::Map& floatMap, const model::Map& quantizedMap, const data::AutoSupervisedDataset& data, size_t maxExamples, const model::MapCompilerParameters& parameters)
+{
+    // Both maps are timed by running them, so they're compiled for the host
+    auto compilerParameters = parameters;
+    compilerParameters.profile = false;
+    compilerParameters.emitPredictBatch = false;
+    compilerParameters.compilerSettings.targetDevice.deviceName = "host";
+
+    model::IRMapCompiler floatCompiler(compilerParameters);
+    auto compiledFloatMap = floatCompiler.Compile(floatMap);
+    model::IRMapCompiler quantizedCompiler(compilerParameters);
+    auto compiledQuantizedMap = quantizedCompiler.Compile(quantizedMap);
+
+    QuantizationReport report;
+    report.numExamples = GetNumExamples(data, maxExamples);
+    if (report.numExamples == 0)
+    {
+        throw utilities::InputException(utilities::InputExceptionErrors::badData, "No examples to compare the maps on");
+    }
+
+    double totalError = 0;
+    size_t numOutputs = 0;
+    size_t numAgreements = 0;
+    for (size_t index = 0; index < report.numExamples; ++index)
+    {
+        const auto& input = data.GetExample(index).GetDataVector();
+        auto floatOutput = ComputeOutput(compiledFloatMap, input);
+        auto quantizedOutput = ComputeOutput(compiledQuantizedMap, input);
+        for (size_t outputIndex = 0; outputIndex < floatOutput.size(); ++outputIndex)
+        {
+            auto error = std::abs(floatOutput[outputIndex] - quantizedOutput[outputIndex]);
+            report.maxAbsoluteError = std::max(report.maxAbsoluteError, error);
+            totalError += error;
+        }
+        numOutputs += floatOutput.size();
+        numAgreements += ArgMax(floatOutput) == ArgMax(quantizedOutput) ? 1 : 0;
+    }
+    report.meanAbsoluteError = totalError / std::max(numOutputs, static_cast<size_t>(1));
+    report.topOneAgreement = static_cast<double>(numAgreements) / report.numExamples;
+
+    report.floatMilliseconds = TimeMap(compiledFloatMap, data, report.numExamples);
+    report.quantizedMilliseconds = TimeMap(compiledQuantizedMap, data, report.numExamples);
+    return report;
+}
+
+void PrintQuantizationReport(const QuantizationReport& report, std::ostream& stream)
+{
+    stream << "Quantized map compared with the original map on " << report.numExamples << " examples:" << std::endl;
+    stream << "  Max absolute error:   " << report.maxAbsoluteError << std::endl;
+    stream << "  Mean absolute error:  " << report.meanAbsoluteError << std::endl;
+    stream << "  Top-1 agreement:      " << (100.0 * report.topOneAgreement) << "%" << std::endl;
+    stream << "  Time (original):      " << report.floatMilliseconds << " ms" << std::endl;
+    stream << "  Time (quantized):     " << report.quantizedMilliseconds << " ms" << std::endl;
+    if (report.quantizedMilliseconds > 0)
+    {
+        stream << "  Speedup:              " << (report.floatMilliseconds / report.quantizedMilliseconds) << "x" << std::endl;
+    }
+}
+}
@@ -0,0 +1,111 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     main.cpp (quantize)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "QuantizeArguments.h"
+#include "QuantizeMap.h"
+
+// utilities
+#include "CommandLineParser.h"
+#include "Exception.h"
+#include "Files.h"
+
+// common
+#include "DataLoadArguments.h"
+#include "DataLoaders.h"
+#include "LoadModel.h"
+#include "MapCompilerArguments.h"
+#include "MapLoadArguments.h"
+
+// model
+#include "Map.h"
+
+// stl
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+using namespace ell;
+
+int main(int argc, char* argv[])
+{
+    try
+    {
+        // create a command line parser
+        utilities::CommandLineParser commandLineParser(argc, argv);
+
+        // add arguments to the command line parser
+        common::ParsedMapLoadArguments mapLoadArguments;
+        common::ParsedDataLoadArguments dataLoadArguments;
+        common::ParsedMapCompilerArguments mapCompilerArguments;
+        ParsedQuantizeArguments quantizeArguments;
+
+        commandLineParser.AddDocumentationString("Input file options");
+        commandLineParser.AddOptionSet(mapLoadArguments);
+
+        commandLineParser.AddDocumentationString("Calibration data options");
+        commandLineParser.AddOptionSet(dataLoadArguments);
+
+        commandLineParser.AddDocumentationString("");
+        commandLineParser.AddOptionSet(quantizeArguments);
+
+        commandLineParser.AddDocumentationString("Code generation options (for the report)");
+        commandLineParser.AddOptionSet(mapCompilerArguments);
+
+        // parse command line
+        commandLineParser.Parse();
+
+        // if no input specified, print help and exit
+        if (!mapLoadArguments.HasInputFilename())
+        {
+            std::cout << commandLineParser.GetHelpString() << std::endl;
+            return 0;
+        }
+
+        auto map = common::LoadMap(mapLoadArguments);
+        auto dataset = common::GetDataset(dataLoadArguments.inputDataFilename);
+
+        size_t numQuantizedLayers = 0;
+        auto quantizedMap = QuantizeMap(map, dataset, quantizeArguments.maxCalibrationExamples, std::cout, quantizeArguments.verbose, numQuantizedLayers);
+        std::cout << "Quantized " << numQuantizedLayers << " layers" << std::endl;
+
+        auto outputFilename = quantizeArguments.outputMapFilename;
+        if (outputFilename.empty())
+        {
+            outputFilename = utilities::RemoveFileExtension(mapLoadArguments.GetInputFilename()) + "_quantized.map";
+        }
+        common::SaveMap(quantizedMap, outputFilename);
+
+        if (quantizeArguments.report)
+        {
+            auto parameters = mapCompilerArguments.GetMapCompilerParameters("ELL_quantize");
+            auto report = CompareQuantizedMap(map, quantizedMap, dataset, quantizeArguments.maxCalibrationExamples, parameters);
+            PrintQuantizationReport(report, std::cout);
+        }
+    }
+    catch (const utilities::CommandLineParserPrintHelpException& exception)
+    {
+        std::cout << exception.GetHelpText() << std::endl;
+        return 0;
+    }
+    catch (const utilities::CommandLineParserErrorException& exception)
+    {
+        std::cerr << "Command line parse error:" << std::endl;
+        for (const auto& error : exception.GetParseErrors())
+        {
+            std::cerr << error.GetMessage() << std::endl;
+        }
+        return 1;
+    }
+    catch (const utilities::Exception& exception)
+    {
+        std::cerr << "exception: " << exception.GetMessage() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}